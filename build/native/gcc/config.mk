@@ -0,0 +1,31 @@
+FD_IS_GNU:=1
+FD_COMPILER_MAJOR_VERSION:=12
+CC_MAJOR_VERSION:=12
+FD_COMPILER_VERSION:=12.2.0
+FD_HAS_SHANI:=1
+FD_HAS_INT128:=1
+FD_HAS_ALLOCA:=1
+FD_HAS_THREADS:=1
+FD_HAS_X86:=1
+FD_HAS_SSE:=1
+FD_HAS_AVX:=1
+FD_HAS_GFNI:=1
+FD_IS_X86_64:=1
+FD_HAS_AESNI:=1
+FD_HAS_AVX512:=1
+FD_HAS_DOUBLE:=1
+
+CPPFLAGS_NATIVE:=
+CPPFLAGS_NATIVE+=-march=native -mtune=native
+CPPFLAGS_NATIVE+=-DFD_HAS_DOUBLE=1
+CPPFLAGS_NATIVE+=-DFD_HAS_SHANI=1
+CPPFLAGS_NATIVE+=-DFD_HAS_INT128=1
+CPPFLAGS_NATIVE+=-DFD_HAS_ALLOCA=1
+CPPFLAGS_NATIVE+=-DFD_HAS_THREADS=1
+CPPFLAGS_NATIVE+=-DFD_HAS_X86=1
+CPPFLAGS_NATIVE+=-DFD_HAS_SSE=1
+CPPFLAGS_NATIVE+=-DFD_HAS_AVX=1
+CPPFLAGS_NATIVE+=-DFD_HAS_GFNI=1
+CPPFLAGS_NATIVE+=-DFD_IS_X86_64=1
+CPPFLAGS_NATIVE+=-DFD_HAS_AESNI=1
+CPPFLAGS_NATIVE+=-DFD_HAS_AVX512=1
@@ -16,6 +16,7 @@ $(call add-objs,commands/tower,fd_firedancer_dev)
 $(call add-objs,commands/ipecho_server,fd_firedancer_dev)
 $(call add-objs,commands/gossip_dump,fd_firedancer_dev)
 $(call add-objs,commands/reasm,fd_firedancer_dev)
+$(call add-objs,commands/pack_sim,fd_firedancer_dev)
 $(call add-objs,commands/forktest/forktest commands/forktest/fd_forktest_tile,fd_firedancer_dev)
 
 ifdef FD_HAS_SSE
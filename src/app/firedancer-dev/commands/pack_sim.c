@@ -0,0 +1,407 @@
+/* The pack-sim command replays captured transactions through fd_pack
+   offline (see fd_pack_sim.h) and reports what blocks pack would have
+   built from them.  It reads pcap and pcapng captures of either
+
+   - a link carrying resolved transactions (fd_txn_m_t, by default the
+     resolv_pack link), as written by `firedancer-dev dump`, or
+
+   - raw TPU/UDP traffic (Ethernet, raw IPv4).  Transactions are parsed
+     but not signature verified.  Transactions that use address lookup
+     tables cannot be resolved offline and are skipped.  The blockhash
+     of every such transaction is assumed to be recent.
+
+   The command does not need a running validator or a config file. */
+
+#include "../../shared/fd_config.h"
+#include "../../shared/fd_action.h"
+#include "../../../disco/metrics/fd_metrics.h"
+#include "../../../disco/pack/fd_pack_sim.h"
+#include "../../../util/net/fd_eth.h"
+#include "../../../util/net/fd_ip4.h"
+#include "../../../util/net/fd_udp.h"
+#include "../../../util/net/fd_pcap.h"
+#include "../../../util/net/fd_pcapng.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PCAP_MAGIC_US   (0xa1b2c3d4U)
+#define PCAP_MAGIC_NS   (0xa1b23c4dU)
+#define PCAPNG_MAGIC    (0x0a0d0d0aU)
+
+#define PKT_MAX         (2048UL)
+
+struct pack_sim_ctx {
+  fd_pack_sim_t *   sim;
+  fd_pack_sim_cfg_t cfg;
+  uint              link_hash; /* upper 24 bits of the dump link hash */
+  int               first_seen;
+  int               quiet;
+
+  long              ts0;       /* timestamp of the first transaction */
+
+  ulong             pkt_cnt;
+  ulong             skip_link_cnt;
+  ulong             skip_parse_cnt;
+  ulong             skip_alt_cnt;
+
+  union {
+    fd_txn_m_t      txnm[1];
+    uchar           buf[ FD_TPU_RESOLVED_MTU ];
+  } __attribute__((aligned(alignof(fd_txn_m_t))));
+};
+
+typedef struct pack_sim_ctx pack_sim_ctx_t;
+
+void
+pack_sim_cmd_args( int *    pargc,
+                   char *** pargv,
+                   args_t * args ) {
+  fd_pack_sim_cfg_t cfg[1];
+  fd_pack_sim_cfg_default( cfg );
+
+  char const * pcap_path = fd_env_strip_cmdline_cstr( pargc, pargv, "--pcap", NULL, NULL          );
+  char const * link      = fd_env_strip_cmdline_cstr( pargc, pargv, "--link", NULL, "resolv_pack" );
+  if( FD_UNLIKELY( !pcap_path ) ) FD_LOG_ERR(( "missing required `--pcap` argument" ));
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->pack_sim.pcap_path ), pcap_path, sizeof(args->pack_sim.pcap_path)-1UL ) );
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->pack_sim.link_name ), link,      sizeof(args->pack_sim.link_name)-1UL ) );
+
+  args->pack_sim.first_seen             = fd_env_strip_cmdline_contains( pargc, pargv, "--first-seen" );
+  args->pack_sim.quiet                  = fd_env_strip_cmdline_contains( pargc, pargv, "--quiet"      );
+  args->pack_sim.pacing                 = fd_env_strip_cmdline_contains( pargc, pargv, "--pacing"     );
+  args->pack_sim.pack_depth             = fd_env_strip_cmdline_ulong( pargc, pargv, "--pack-depth",             NULL, cfg->pack_depth             );
+  args->pack_sim.execle_cnt             = fd_env_strip_cmdline_ulong( pargc, pargv, "--execle-cnt",             NULL, cfg->execle_cnt             );
+  args->pack_sim.max_txn_per_microblock = fd_env_strip_cmdline_ulong( pargc, pargv, "--max-txn-per-microblock", NULL, cfg->max_txn_per_microblock );
+  args->pack_sim.max_cost_per_block     = fd_env_strip_cmdline_ulong( pargc, pargv, "--max-cost-per-block",     NULL, cfg->max_cost_per_block     );
+  args->pack_sim.slot_ns                = fd_env_strip_cmdline_long ( pargc, pargv, "--slot-ns",                NULL, cfg->slot_ns                );
+  args->pack_sim.leader_slot_cnt        = fd_env_strip_cmdline_ulong( pargc, pargv, "--leader-slots",           NULL, cfg->leader_slot_cnt        );
+  args->pack_sim.rotation_slot_cnt      = fd_env_strip_cmdline_ulong( pargc, pargv, "--rotation-slots",         NULL, cfg->rotation_slot_cnt      );
+  args->pack_sim.poll_ns                = fd_env_strip_cmdline_long ( pargc, pargv, "--poll-ns",                NULL, cfg->poll_ns                );
+  args->pack_sim.exec_ns_per_txn        = fd_env_strip_cmdline_ulong( pargc, pargv, "--exec-ns-per-txn",        NULL, cfg->exec_ns_per_txn        );
+  args->pack_sim.exec_ns_per_cu         = fd_env_strip_cmdline_float( pargc, pargv, "--exec-ns-per-cu",         NULL, (float)cfg->exec_ns_per_cu  );
+  args->pack_sim.cu_consumed_pct        = fd_env_strip_cmdline_ulong( pargc, pargv, "--cu-consumed-pct",        NULL, cfg->cu_consumed_pct        );
+  args->pack_sim.seed                   = fd_env_strip_cmdline_uint ( pargc, pargv, "--seed",                   NULL, cfg->seed                   );
+}
+
+static void
+print_block( fd_pack_sim_block_t const * block,
+             void *                      _ctx ) {
+  pack_sim_ctx_t const * ctx = (pack_sim_ctx_t const *)_ctx;
+  if( ctx->quiet ) return;
+  printf( "slot %6lu: txns %6lu votes %6lu bundles %4lu microblocks %6lu cus %9lu (%5.1f%%) fees %12lu+%12lu stalls %6lu (%8.3f ms) pending %6lu\n",
+          block->slot, block->txn_cnt, block->vote_cnt, block->bundle_cnt, block->microblock_cnt,
+          block->cus, 100.0*(double)block->cus/(double)fd_ulong_max( block->max_cus, 1UL ),
+          block->signature_fees, block->priority_fees,
+          block->stall_cnt, (double)block->stall_ns/1e6, block->pending_cnt );
+}
+
+/* handle_txnm inserts a transaction captured from a dumped link.
+   Record layout is fd_frag_meta_t, frag payload, link hash. */
+
+static void
+handle_txnm( pack_sim_ctx_t * ctx,
+             uchar const *    rec,
+             ulong            rec_sz,
+             long             ts ) {
+  if( FD_UNLIKELY( rec_sz<sizeof(fd_frag_meta_t)+sizeof(fd_txn_m_t)+sizeof(uint) ) ) { ctx->skip_parse_cnt++; return; }
+
+  uint link_hash = FD_LOAD( uint, rec+rec_sz-sizeof(uint) );
+  if( FD_UNLIKELY( (link_hash>>8)!=ctx->link_hash ) ) { ctx->skip_link_cnt++; return; }
+
+  fd_frag_meta_t const * meta   = (fd_frag_meta_t const *)rec;
+  ulong                  frag_sz = rec_sz - sizeof(fd_frag_meta_t) - sizeof(uint);
+  if( FD_UNLIKELY( frag_sz>sizeof(ctx->buf) ) ) { ctx->skip_parse_cnt++; return; }
+  fd_memcpy( ctx->buf, rec+sizeof(fd_frag_meta_t), frag_sz );
+
+  fd_txn_m_t const * txnm = ctx->txnm;
+  if( FD_UNLIKELY( !txnm->txn_t_sz || fd_txn_m_realized_footprint( txnm, 1, 1 )>frag_sz ) ) { ctx->skip_parse_cnt++; return; }
+
+  if( ctx->first_seen ) ts = txnm->first_seen_nanos;
+  if( FD_UNLIKELY( ctx->ts0==LONG_MIN ) ) ctx->ts0 = ts;
+  fd_pack_sim_insert( ctx->sim, ts, txnm, meta->sig );
+}
+
+/* handle_udp inserts a transaction captured from the TPU/UDP port. */
+
+static void
+handle_udp( pack_sim_ctx_t * ctx,
+            uchar const *    ip4,
+            ulong            ip4_sz,
+            long             ts ) {
+  if( FD_UNLIKELY( ip4_sz<sizeof(fd_ip4_hdr_t)+sizeof(fd_udp_hdr_t) ) ) { ctx->skip_parse_cnt++; return; }
+  fd_ip4_hdr_t const * ip4_hdr = (fd_ip4_hdr_t const *)ip4;
+  ulong ip4_hdr_sz = FD_IP4_GET_LEN( *ip4_hdr );
+  if( FD_UNLIKELY( (FD_IP4_GET_VERSION( *ip4_hdr )!=4) |
+                   (ip4_hdr->protocol!=FD_IP4_HDR_PROTOCOL_UDP) |
+                   (ip4_hdr_sz<sizeof(fd_ip4_hdr_t)) |
+                   (ip4_sz<ip4_hdr_sz+sizeof(fd_udp_hdr_t)) ) ) { ctx->skip_parse_cnt++; return; }
+  uchar const * payload    = ip4 + ip4_hdr_sz + sizeof(fd_udp_hdr_t);
+  ulong         payload_sz = ip4_sz - ip4_hdr_sz - sizeof(fd_udp_hdr_t);
+  if( FD_UNLIKELY( !payload_sz || payload_sz>FD_TPU_MTU ) ) { ctx->skip_parse_cnt++; return; }
+
+  fd_txn_m_t * txnm = ctx->txnm;
+  fd_memset( txnm, 0, sizeof(fd_txn_m_t) );
+  txnm->payload_sz       = (ushort)payload_sz;
+  txnm->source_ipv4      = FD_LOAD( uint, ip4_hdr->saddr_c );
+  txnm->source_tpu       = FD_TXN_M_TPU_SOURCE_UDP;
+  txnm->first_seen_nanos = ts;
+  fd_memcpy( fd_txn_m_payload( txnm ), payload, payload_sz );
+
+  ulong txn_t_sz = fd_txn_parse( fd_txn_m_payload( txnm ), payload_sz, fd_txn_m_txn_t( txnm ), NULL );
+  if( FD_UNLIKELY( !txn_t_sz ) ) { ctx->skip_parse_cnt++; return; }
+  txnm->txn_t_sz = (ushort)txn_t_sz;
+  if( FD_UNLIKELY( fd_txn_m_txn_t( txnm )->addr_table_lookup_cnt ) ) { ctx->skip_alt_cnt++; return; }
+
+  if( FD_UNLIKELY( ctx->ts0==LONG_MIN ) ) ctx->ts0 = ts;
+  ulong slot = (ulong)( fd_long_max( ts-ctx->ts0, 0L )/ctx->cfg.slot_ns );
+  fd_pack_sim_insert( ctx->sim, ts, txnm, slot );
+}
+
+static void
+handle_ip4( pack_sim_ctx_t * ctx,
+            uchar const *    pkt,
+            ulong            pkt_sz,
+            int              eth,
+            long             ts ) {
+  if( eth ) {
+    if( FD_UNLIKELY( pkt_sz<sizeof(fd_eth_hdr_t) ) ) { ctx->skip_parse_cnt++; return; }
+    fd_eth_hdr_t const * eth_hdr = (fd_eth_hdr_t const *)pkt;
+    if( FD_UNLIKELY( eth_hdr->net_type!=fd_ushort_bswap( FD_ETH_HDR_TYPE_IP ) ) ) { ctx->skip_parse_cnt++; return; }
+    pkt    += sizeof(fd_eth_hdr_t);
+    pkt_sz -= sizeof(fd_eth_hdr_t);
+  }
+  handle_udp( ctx, pkt, pkt_sz, ts );
+}
+
+static void
+replay_pcap( pack_sim_ctx_t * ctx,
+             FILE *           file,
+             uint             link_type ) {
+  if( FD_UNLIKELY( (link_type!=FD_PCAP_LINK_LAYER_USER0) & (link_type!=FD_PCAP_LINK_LAYER_ETHERNET) ) ) {
+    FD_LOG_ERR(( "unsupported pcap link type %u (expected Ethernet or a `dump` capture)", link_type ));
+  }
+  fd_pcap_iter_t * iter = fd_pcap_iter_new( file );
+  if( FD_UNLIKELY( !iter ) ) FD_LOG_ERR(( "fd_pcap_iter_new failed" ));
+
+  static uchar pkt[ PKT_MAX+FD_TPU_RESOLVED_MTU ];
+  for(;;) {
+    long  ts;
+    ulong pkt_sz = fd_pcap_iter_next( iter, pkt, sizeof(pkt), &ts );
+    if( !pkt_sz ) break;
+    ctx->pkt_cnt++;
+    if( link_type==FD_PCAP_LINK_LAYER_USER0 ) handle_txnm( ctx, pkt, pkt_sz, ts );
+    else                                      handle_ip4 ( ctx, pkt, pkt_sz, 1, ts );
+  }
+  fd_pcap_iter_delete( iter );
+}
+
+static void
+replay_pcapng( pack_sim_ctx_t * ctx,
+               FILE *           file ) {
+  void * iter_mem = aligned_alloc( fd_pcapng_iter_align(), fd_pcapng_iter_footprint() );
+  FD_TEST( iter_mem );
+  fd_pcapng_iter_t * iter = fd_pcapng_iter_new( iter_mem, file );
+  if( FD_UNLIKELY( !iter ) ) FD_LOG_ERR(( "fd_pcapng_iter_new failed" ));
+
+  for(;;) {
+    fd_pcapng_frame_t const * frame = fd_pcapng_iter_next( iter );
+    if( !frame ) break;
+    if( FD_UNLIKELY( !fd_pcapng_is_pkt( frame ) || !frame->idb ) ) continue;
+    ctx->pkt_cnt++;
+    switch( frame->idb->link_type ) {
+    case FD_PCAPNG_LINKTYPE_USER0:
+      handle_txnm( ctx, frame->data, frame->data_sz, frame->ts );
+      break;
+    case FD_PCAPNG_LINKTYPE_ETHERNET:
+      handle_ip4( ctx, frame->data, frame->data_sz, 1, frame->ts );
+      break;
+    case FD_PCAPNG_LINKTYPE_RAW:
+    case FD_PCAPNG_LINKTYPE_IPV4:
+      handle_ip4( ctx, frame->data, frame->data_sz, 0, frame->ts );
+      break;
+    default:
+      ctx->skip_parse_cnt++;
+      break;
+    }
+  }
+  if( FD_UNLIKELY( fd_pcapng_iter_err( iter )>0 ) ) FD_LOG_WARNING(( "pcapng read failed, results are partial" ));
+  free( fd_pcapng_iter_delete( iter ) );
+}
+
+static ulong
+hist_cnt( fd_histf_t const * hist ) {
+  ulong cnt = 0UL;
+  for( ulong b=0UL; b<FD_HISTF_BUCKET_CNT; b++ ) cnt += fd_histf_cnt( hist, b );
+  return cnt;
+}
+
+/* print_pct prints a histogram percentile, or >max if it landed in the
+   overflow bucket. */
+
+static void
+print_pct( fd_histf_t const * hist,
+           uchar              pct,
+           double             scale ) {
+  ulong v = fd_histf_percentile( hist, pct, ULONG_MAX );
+  if( FD_UNLIKELY( v==ULONG_MAX ) ) printf( "  p%-3u %12s", (uint)pct, ">max" );
+  else                              printf( "  p%-3u %12.3f", (uint)pct, (double)v*scale );
+}
+
+static void
+print_hist( char const *       name,
+            fd_histf_t const * hist,
+            double             scale,
+            char const *       unit ) {
+  printf( "  %-20s n %10lu", name, hist_cnt( hist ) );
+  print_pct( hist,  50, scale );
+  print_pct( hist,  90, scale );
+  print_pct( hist,  99, scale );
+  print_pct( hist, 100, scale );
+  printf( " %s\n", unit );
+}
+
+static void
+print_summary( pack_sim_ctx_t const * ctx ) {
+  fd_pack_sim_stats_t const * stats = fd_pack_sim_stats( ctx->sim );
+
+  printf( "\n" );
+  printf( "input\n" );
+  printf( "  packets              %lu\n", ctx->pkt_cnt );
+  printf( "  transactions         %lu\n", stats->txn_rx_cnt );
+  printf( "  skipped (link)       %lu\n", ctx->skip_link_cnt );
+  printf( "  skipped (parse)      %lu\n", ctx->skip_parse_cnt );
+  printf( "  skipped (alt)        %lu\n", ctx->skip_alt_cnt );
+  printf( "  insert failed        %lu\n", stats->txn_insert_fail_cnt );
+  printf( "  expired              %lu\n", stats->txn_expired_cnt );
+  printf( "  partial bundles      %lu\n", stats->bundle_partial_cnt );
+  printf( "blocks                 %lu\n", stats->block_cnt );
+  printf( "  transactions         %lu (%lu votes)\n", stats->txn_cnt, stats->vote_cnt );
+  printf( "  bundles              %lu\n", stats->bundle_cnt );
+  printf( "  microblocks          %lu\n", stats->microblock_cnt );
+  printf( "  cus                  %lu of %lu (%.2f%% fill)\n",
+          stats->cus, stats->max_cus, 100.0*(double)stats->cus/(double)fd_ulong_max( stats->max_cus, 1UL ) );
+  printf( "  signature fees       %lu lamports\n", stats->signature_fees );
+  printf( "  priority fees        %lu lamports\n", stats->priority_fees );
+  printf( "  fees per block       %.0f lamports\n",
+          (double)(stats->signature_fees+stats->priority_fees)/(double)fd_ulong_max( stats->block_cnt, 1UL ) );
+  printf( "  conflict stalls      %lu (%.3f ms execle idle)\n", stats->stall_cnt, (double)stats->stall_ns/1e6 );
+  printf( "latency\n" );
+  print_hist( "scheduling",       stats->sched_latency,      1e-3, "us" );
+  print_hist( "microblock",       stats->microblock_latency, 1e-3, "us" );
+  print_hist( "schedule call",    stats->schedule_ticks,     1.0,  "ticks" );
+  printf( "schedule results\n" );
+  static char const * names[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_CNT ] = {
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_TAKEN_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_CU_LIMIT_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_FAST_PATH_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_BYTE_LIMIT_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_ALLOC_LIMIT_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_WRITE_COST_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_SLOW_PATH_NAME,
+    FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_DEFER_SKIP_NAME,
+  };
+  for( ulong i=0UL; i<FD_METRICS_ENUM_PACK_TXN_SCHEDULE_CNT; i++ ) {
+    printf( "  %-20s %lu\n", names[ i ], stats->sched_results[ i ] );
+  }
+}
+
+void
+pack_sim_cmd_fn( args_t *   args,
+                 config_t * config ) {
+  (void)config;
+
+  static uchar metrics_scratch[ FD_METRICS_FOOTPRINT( 0 ) ] __attribute__((aligned(FD_METRICS_ALIGN)));
+  fd_metrics_register( (ulong *)fd_metrics_new( metrics_scratch, 0UL ) );
+
+  static pack_sim_ctx_t ctx[1];
+  ctx->cfg = (fd_pack_sim_cfg_t){
+    .pack_depth             = args->pack_sim.pack_depth,
+    .execle_cnt             = args->pack_sim.execle_cnt,
+    .max_txn_per_microblock = args->pack_sim.max_txn_per_microblock,
+    .max_cost_per_block     = args->pack_sim.max_cost_per_block,
+    .slot_ns                = args->pack_sim.slot_ns,
+    .leader_slot_cnt        = args->pack_sim.leader_slot_cnt,
+    .rotation_slot_cnt      = args->pack_sim.rotation_slot_cnt,
+    .poll_ns                = args->pack_sim.poll_ns,
+    .pacing                 = args->pack_sim.pacing,
+    .exec_ns_per_txn        = args->pack_sim.exec_ns_per_txn,
+    .exec_ns_per_cu         = (double)args->pack_sim.exec_ns_per_cu,
+    .cu_consumed_pct        = args->pack_sim.cu_consumed_pct,
+    .seed                   = args->pack_sim.seed,
+  };
+  ctx->link_hash  = (uint)( fd_hash( 17UL, args->pack_sim.link_name, strlen( args->pack_sim.link_name ) ) & 0xFFFFFFUL );
+  ctx->first_seen = args->pack_sim.first_seen;
+  ctx->quiet      = args->pack_sim.quiet;
+  ctx->ts0        = LONG_MIN;
+
+  ulong footprint = fd_pack_sim_footprint( &ctx->cfg );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "invalid --pack-depth %lu", ctx->cfg.pack_depth ));
+  void * mem = aligned_alloc( fd_pack_sim_align(), footprint );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "aligned_alloc(%lu) failed", footprint ));
+  ctx->sim = fd_pack_sim_join( fd_pack_sim_new( mem, &ctx->cfg, print_block, ctx ) );
+  if( FD_UNLIKELY( !ctx->sim ) ) FD_LOG_ERR(( "invalid simulation parameters" ));
+
+  FILE * file = fopen( args->pack_sim.pcap_path, "rb" );
+  if( FD_UNLIKELY( !file ) ) FD_LOG_ERR(( "fopen(%s) failed (%i-%s)", args->pack_sim.pcap_path, errno, fd_io_strerror( errno ) ));
+
+  uint hdr[ 6 ];
+  if( FD_UNLIKELY( 1UL!=fread( hdr, sizeof(hdr), 1UL, file ) ) ) FD_LOG_ERR(( "failed to read header of %s", args->pack_sim.pcap_path ));
+  if( FD_UNLIKELY( 0!=fseek( file, 0L, SEEK_SET ) ) ) FD_LOG_ERR(( "fseek failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  switch( hdr[ 0 ] ) {
+  case PCAP_MAGIC_US:
+  case PCAP_MAGIC_NS:
+    replay_pcap( ctx, file, hdr[ 5 ] );
+    break;
+  case PCAPNG_MAGIC:
+    replay_pcapng( ctx, file );
+    break;
+  default:
+    FD_LOG_ERR(( "%s is not a (little endian) pcap or pcapng file", args->pack_sim.pcap_path ));
+  }
+  fclose( file );
+
+  fd_pack_sim_fini( ctx->sim );
+  print_summary( ctx );
+
+  free( fd_pack_sim_delete( fd_pack_sim_leave( ctx->sim ) ) );
+}
+
+static void
+pack_sim_args_help( fd_action_help_t * help ) {
+  fd_action_help_arg( help, "--pcap",                   "<path>", "Capture to replay (pcap or pcapng)" );
+  fd_action_help_arg( help, "--link",                   "<name>", "Link to replay from `dump` captures (default resolv_pack)" );
+  fd_action_help_arg( help, "--first-seen",             NULL,     "Use the first seen time of transactions instead of the\n"
+                                                                  "capture timestamps as arrival times" );
+  fd_action_help_arg( help, "--quiet",                  NULL,     "Only print the summary, not every block" );
+  fd_action_help_arg( help, "--pacing",                 NULL,     "Pace CU consumption over the slot (balanced strategy)" );
+  fd_action_help_arg( help, "--pack-depth",             "<n>",    "Max pending transactions" );
+  fd_action_help_arg( help, "--execle-cnt",             "<n>",    "Number of simulated execle tiles" );
+  fd_action_help_arg( help, "--max-txn-per-microblock", "<n>",    "Max transactions per microblock" );
+  fd_action_help_arg( help, "--max-cost-per-block",     "<cus>",  "Block CU limit" );
+  fd_action_help_arg( help, "--slot-ns",                "<ns>",   "Slot duration" );
+  fd_action_help_arg( help, "--leader-slots",           "<n>",    "Consecutive leader slots per rotation" );
+  fd_action_help_arg( help, "--rotation-slots",         "<n>",    "Slots per rotation" );
+  fd_action_help_arg( help, "--poll-ns",                "<ns>",   "Schedule retry interval while work is pending" );
+  fd_action_help_arg( help, "--exec-ns-per-txn",        "<ns>",   "Simulated execution time per transaction" );
+  fd_action_help_arg( help, "--exec-ns-per-cu",         "<ns>",   "Simulated execution time per consumed CU" );
+  fd_action_help_arg( help, "--cu-consumed-pct",        "<pct>",  "Percent of requested execution CUs consumed" );
+  fd_action_help_arg( help, "--seed",                   "<n>",    "Seed for fd_pack" );
+}
+
+action_t fd_action_pack_sim = {
+  .name        = "pack-sim",
+  .args        = pack_sim_cmd_args,
+  .fn          = pack_sim_cmd_fn,
+  .perm        = NULL,
+  .description = "Replay captured transactions through pack offline",
+  .detail      = "Feeds the transactions of a pcap or pcapng capture through fd_pack with\n"
+                 "simulated execle tiles and leader slots in virtual time, and reports the\n"
+                 "fees, CU fill, scheduling latency and conflict stalls of the resulting\n"
+                 "blocks.  Captures are either `dump --link resolv_pack` output or raw\n"
+                 "TPU/UDP traffic.  Given the same input and options, the results are\n"
+                 "deterministic.",
+  .usage       = "pack-sim --pcap <path> [options]",
+  .args_help   = pack_sim_args_help,
+};
@@ -94,7 +94,7 @@ snapshot_load_topo( config_t * config ) {
       1UL<<35UL,
       config->firedancer.accounts.cache_size_gib*(1UL<<30UL),
       config->tiles.bundle.enabled,
-      2UL,
+      2UL+(config->firedancer.layout.snapin_tile_count-1UL),
       0UL );
   FD_TEST( fd_pod_insertf_ulong( topo->props, accdb_obj->id, "accdb" ) );
 
@@ -122,15 +122,17 @@ snapshot_load_topo( config_t * config ) {
   fd_topo_tile_t * snapld_tile = fd_topob_tile( topo, "snapld", "snapld", "metric_in", ULONG_MAX, 0, 0, 0 );
   snapld_tile->allow_shutdown = 1;
 
-  /* "snapdc": Zstandard decompress tile */
+  /* "snapdc": Zstandard decompress tiles */
+  ulong snapdc_tile_cnt = config->firedancer.layout.snapdc_tile_count;
   fd_topob_wksp( topo, "snapdc" );
-  fd_topo_tile_t * snapdc_tile = fd_topob_tile( topo, "snapdc", "snapdc", "metric_in", ULONG_MAX, 0, 0, 0 );
-  snapdc_tile->allow_shutdown = 1;
+  FOR(snapdc_tile_cnt) fd_topob_tile( topo, "snapdc", "snapdc", "metric_in", ULONG_MAX, 0, 0, 0 )->allow_shutdown = 1;
 
-  /* "snapin": Snapshot parser tile */
+  /* "snapin": Snapshot parser tile, and account inserter tiles */
+  ulong snapin_tile_cnt = config->firedancer.layout.snapin_tile_count;
   fd_topob_wksp( topo, "snapin" );
   fd_topo_tile_t * snapin_tile = fd_topob_tile( topo, "snapin", "snapin", "metric_in", ULONG_MAX, 0, 0, 0 );
   snapin_tile->allow_shutdown = 1;
+  FOR(snapin_tile_cnt-1UL) fd_topob_tile( topo, "snapin", "snapin", "metric_in", ULONG_MAX, 0, 0, 0 )->allow_shutdown = 1;
 
   fd_topob_wksp( topo, "snapwr" );
   fd_topo_tile_t * snapwr_tile = fd_topob_tile( topo, "snapwr", "snapwr", "metric_in", ULONG_MAX, 0, 0, 0 );
@@ -143,6 +145,9 @@ snapshot_load_topo( config_t * config ) {
   fd_topob_wksp( topo, "snapct_ld"    );
   fd_topob_wksp( topo, "snapld_dc"    );
   fd_topob_wksp( topo, "snapdc_in"    );
+  if( snapdc_tile_cnt>1UL ) fd_topob_wksp( topo, "snapdc_dc" );
+  if( snapin_tile_cnt>1UL ) fd_topob_wksp( topo, "snapin_ix" );
+  if( snapin_tile_cnt>1UL ) fd_topob_wksp( topo, "snapin_rp" );
 
   fd_topob_wksp( topo, "snapin_manif" );
   fd_topob_wksp( topo, "snapct_repr"  );
@@ -153,6 +158,9 @@ snapshot_load_topo( config_t * config ) {
   fd_topob_link( topo, "snapct_ld",    "snapct_ld",    128UL,   sizeof(fd_ssctrl_init_t),       1UL );
   fd_topob_link( topo, "snapld_dc",    "snapld_dc",    16384UL, FD_SNAPSHOT_DATA_MTU,           1UL );
   fd_topob_link( topo, "snapdc_in",    "snapdc_in",    16384UL, FD_SNAPSHOT_DATA_MTU,           1UL );
+  FOR(snapdc_tile_cnt-1UL) fd_topob_link( topo, "snapdc_dc", "snapdc_dc", 4096UL, FD_SNAPSHOT_DATA_MTU, 1UL );
+  FOR(snapin_tile_cnt-1UL) fd_topob_link( topo, "snapin_ix", "snapin_ix", 512UL,  sizeof(fd_ssctrl_ix_batch_t),  1UL );
+  FOR(snapin_tile_cnt-1UL) fd_topob_link( topo, "snapin_rp", "snapin_rp", 16UL,   sizeof(fd_ssctrl_ix_report_t), 1UL );
   fd_topob_link( topo, "snapin_manif", "snapin_manif", 4UL,     sizeof(fd_snapshot_manifest_t), 1UL )->permit_no_consumers = 1;
   fd_topob_link( topo, "snapct_repr",  "snapct_repr",  128UL,   0UL,                            1UL )->permit_no_consumers = 1;
 
@@ -166,9 +174,19 @@ snapshot_load_topo( config_t * config ) {
   fd_topob_tile_out( topo, "snapct",  0UL,              "snapct_repr",  0UL                                       );
   fd_topob_tile_in ( topo, "snapld",  0UL, "metric_in", "snapct_ld",    0UL, FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   fd_topob_tile_out( topo, "snapld",  0UL,              "snapld_dc",    0UL                                       );
-  fd_topob_tile_in ( topo, "snapdc",  0UL, "metric_in", "snapld_dc",    0UL, FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(snapdc_tile_cnt) fd_topob_tile_in( topo, "snapdc", i, "metric_in", "snapld_dc", 0UL, FD_TOPOB_RELIABLE, FD_TOPOB_POLLED );
   fd_topob_tile_out( topo, "snapdc",  0UL,              "snapdc_in",    0UL                                       );
+  FOR(snapdc_tile_cnt-1UL) {
+    fd_topob_tile_out( topo, "snapdc", i+1UL,            "snapdc_dc",    i                                         );
+    fd_topob_tile_in ( topo, "snapdc", 0UL, "metric_in", "snapdc_dc",    i,   FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  }
   fd_topob_tile_in ( topo, "snapin",  0UL, "metric_in", "snapdc_in",    0UL, FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(snapin_tile_cnt-1UL) {
+    fd_topob_tile_out( topo, "snapin", 0UL,              "snapin_ix",    i                                         );
+    fd_topob_tile_in ( topo, "snapin", i+1UL, "metric_in", "snapin_ix",  i,   FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+    fd_topob_tile_out( topo, "snapin", i+1UL,            "snapin_rp",    i                                         );
+    fd_topob_tile_in ( topo, "snapin", 0UL, "metric_in", "snapin_rp",    i,   FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  }
   fd_topob_tile_out( topo, "snapin",  0UL,              "snapin_manif", 0UL                                       );
   fd_topob_tile_out( topo, "snapin",  0UL,              "snapin_ct",    0UL                                       );
   fd_topob_tile_in ( topo, "snapwr",  0UL, "metric_in", "snapdc_in",    0UL, FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
@@ -178,6 +196,7 @@ snapshot_load_topo( config_t * config ) {
   fd_topob_tile_uses( topo, snapin_tile, accdb_obj,      FD_SHMEM_JOIN_MODE_READ_WRITE );
   fd_topob_tile_uses( topo, snapin_tile, banks_obj,      FD_SHMEM_JOIN_MODE_READ_WRITE );
   fd_topob_tile_uses( topo, accdb_tile,  accdb_obj,      FD_SHMEM_JOIN_MODE_READ_WRITE );
+  FOR(snapin_tile_cnt-1UL) fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "snapin", i+1UL ) ], accdb_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   snapin_tile->snapin.accdb_obj_id    = accdb_obj->id;
   snapin_tile->snapin.txncache_obj_id = txncache_obj->id;
   snapin_tile->snapin.banks_obj_id    = banks_obj->id;
@@ -217,6 +236,9 @@ snapshot_load_args( int *    pargc,
       "  --no-watch           Do not print periodic progress updates\n"
       "  --db-rec-max <num>   Database max record/account count (e.g. 10e6 -> 10M accounts)\n"
       "  --accounts-hist      After loading, analyze account size distribution\n"
+      "  --snapdc-tiles <num> Number of snapshot decompressor tiles\n"
+      "  --snapin-tiles <num> Number of snapshot parser and inserter tiles\n"
+      "  --verify-lthash      Verify the accounts lthash after loading\n"
       "\n",
       stderr );
     exit( 0 );
@@ -228,12 +250,18 @@ snapshot_load_args( int *    pargc,
   int          no_incremental= fd_env_strip_cmdline_contains( pargc, pargv, "--no-incremental"             )!=0;
   int          no_watch      = fd_env_strip_cmdline_contains( pargc, pargv, "--no-watch"                   )!=0;
   int          accounts_hist = fd_env_strip_cmdline_contains( pargc, pargv, "--accounts-hist"              )!=0;
+  int          verify_lthash = fd_env_strip_cmdline_contains( pargc, pargv, "--verify-lthash"              )!=0;
+  ulong        snapdc_tiles  = fd_env_strip_cmdline_ulong   ( pargc, pargv, "--snapdc-tiles", NULL, 0UL    );
+  ulong        snapin_tiles  = fd_env_strip_cmdline_ulong   ( pargc, pargv, "--snapin-tiles", NULL, 0UL    );
 
   fd_cstr_ncpy( args->snapshot_load.snapshot_dir, snapshot_dir, sizeof(args->snapshot_load.snapshot_dir) );
   args->snapshot_load.accounts_hist  = accounts_hist;
   args->snapshot_load.offline        = offline;
   args->snapshot_load.no_incremental = no_incremental;
   args->snapshot_load.no_watch       = no_watch;
+  args->snapshot_load.verify_lthash  = verify_lthash;
+  args->snapshot_load.snapdc_tile_cnt = snapdc_tiles;
+  args->snapshot_load.snapin_tile_cnt = snapin_tiles;
 }
 
 /* ACCOUNTS_HIST_N (32) is chosen to make the histogram lightweight.
@@ -416,6 +444,18 @@ fixup_config( config_t *     config,
     config->firedancer.snapshots.incremental_snapshots = 0;
   }
 
+  if( args->snapshot_load.snapdc_tile_cnt ) {
+    config->firedancer.layout.snapdc_tile_count = (uint)args->snapshot_load.snapdc_tile_cnt;
+  }
+
+  if( args->snapshot_load.snapin_tile_cnt ) {
+    config->firedancer.layout.snapin_tile_count = (uint)args->snapshot_load.snapin_tile_cnt;
+  }
+
+  if( args->snapshot_load.verify_lthash ) {
+    config->firedancer.snapshots.verify_accounts_lthash = 1;
+  }
+
   if( FD_UNLIKELY( config->firedancer.snapshots.sources.gossip.allow_any || config->firedancer.snapshots.sources.gossip.allow_list_cnt ) ) {
     FD_LOG_WARNING(( "snapshot-load command is incompatible with gossip snapshot sources; disabling gossip snapshot sources" ));
     config->firedancer.snapshots.sources.gossip.allow_any      = 0;
@@ -460,6 +500,7 @@ snapshot_load_cmd_fn( args_t *   args,
   fd_topo_tile_t * snapld_tile = &topo->tiles[ fd_topo_find_tile( topo, "snapld", 0UL ) ];
   fd_topo_tile_t * snapdc_tile = &topo->tiles[ fd_topo_find_tile( topo, "snapdc", 0UL ) ];
   fd_topo_tile_t * snapin_tile = &topo->tiles[ fd_topo_find_tile( topo, "snapin", 0UL ) ];
+  ulong            snapin_cnt  = fd_topo_tile_name_cnt( topo, "snapin" );
   fd_topo_tile_t * snapwr_tile = &topo->tiles[ fd_topo_find_tile( topo, "snapwr", 0UL ) ];
 
   double tick_per_ns = fd_tempo_tick_per_ns( NULL );
@@ -547,7 +588,13 @@ snapshot_load_cmd_fn( args_t *   args,
     double done_comp = dc_out ? (double)dc_in*( (double)consumed/(double)dc_out ) : 0.0;
     double progress  = size_bytes ? clamp_pct( 100.0*done_comp/(double)size_bytes ) : 0.0;
 
-    ulong acc_cnt      = snapin_metrics[ MIDX( GAUGE, SNAPIN, ACCOUNT_LOADED    ) ];
+    /* Inserter snapin tiles count the accounts they have not yet
+       reported to snapin 0 */
+    ulong acc_cnt = 0UL;
+    for( ulong i=0UL; i<snapin_cnt; i++ ) {
+      ulong volatile const * m = fd_metrics_tile( topo->tiles[ fd_topo_find_tile( topo, "snapin", i ) ].metrics );
+      acc_cnt += m[ MIDX( GAUGE, SNAPIN, ACCOUNT_LOADED ) ];
+    }
 
     if( watch ) {
       double busy[ 4 ] = {
@@ -589,6 +636,14 @@ snapshot_load_cmd_fn( args_t *   args,
     next+=1000L*1000L*1000L;
   }
 
+  /* End to end restore throughput, for comparing tile counts */
+  double elapsed_s = (double)( fd_log_wallclock()-start )/1e9;
+  ulong  loaded    = snapin_metrics[ MIDX( GAUGE, SNAPIN, ACCOUNT_LOADED ) ];
+  printf( "%sloaded%s %lu accounts in %.3f s, %.2f M/s %s(snapdc %lu, snapin %lu)%s\n",
+          c_bold, c_norm, loaded, elapsed_s, (double)loaded/elapsed_s/1e6,
+          c_dim, fd_topo_tile_name_cnt( topo, "snapdc" ), snapin_cnt, c_norm );
+  fflush( stdout );
+
   if( args->snapshot_load.accounts_hist ) {
     accounts_hist_t hist[1];
     accounts_hist_reset( hist );
@@ -609,6 +664,8 @@ snapshot_load_args_help( fd_action_help_t * help ) {
   fd_action_help_arg( help, "--db-rec-max",     "<num>",   "Database max record/account count (e.g. 10e6 -> 10M accounts)" );
   fd_action_help_arg( help, "--fsck",           NULL,      "After loading, run database integrity checks" );
   fd_action_help_arg( help, "--accounts-hist",  NULL,      "After loading, analyze account size distribution" );
+  fd_action_help_arg( help, "--snapdc-tiles",   "<num>",   "Number of snapshot decompressor tiles" );
+  fd_action_help_arg( help, "--snapin-tiles",   "<num>",   "Number of snapshot parser and inserter tiles" );
 }
 
 action_t fd_action_snapshot_load = {
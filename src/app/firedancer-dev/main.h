@@ -201,6 +201,7 @@ extern action_t fd_action_bench;
 extern action_t fd_action_bundle_client;
 extern action_t fd_action_dev;
 extern action_t fd_action_dump;
+extern action_t fd_action_pack_sim;
 extern action_t fd_action_flame;
 extern action_t fd_action_help;
 extern action_t fd_action_metrics;
@@ -248,6 +249,7 @@ action_t * ACTIONS[] = {
   &fd_action_bundle_client,
   &fd_action_dev,
   &fd_action_dump,
+  &fd_action_pack_sim,
   &fd_action_flame,
   &fd_action_load,
   &fd_action_pktgen,
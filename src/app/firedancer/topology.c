@@ -226,6 +226,8 @@ fd_topo_initialize( config_t * config ) {
   ulong verify_tile_cnt = config->layout.verify_tile_count;
   ulong resolv_tile_cnt = config->firedancer.layout.resolv_tile_count;
   ulong execle_tile_cnt = config->firedancer.layout.execle_tile_count;
+  ulong snapdc_tile_cnt = config->firedancer.layout.snapdc_tile_count;
+  ulong snapin_tile_cnt = config->firedancer.layout.snapin_tile_count;
   ulong snapzp_tile_cnt = config->firedancer.layout.enable_snapshot_production
                           ? config->firedancer.layout.snapzp_tile_count : 0UL;
   ulong snapsv_tile_cnt = ( config->firedancer.snapshots.server.enabled &&
@@ -377,6 +379,9 @@ fd_topo_initialize( config_t * config ) {
     fd_topob_wksp( topo, "snapct_ld"   );
     fd_topob_wksp( topo, "snapld_dc"   );
     fd_topob_wksp( topo, "snapdc_in"   );
+    if( snapdc_tile_cnt>1UL ) fd_topob_wksp( topo, "snapdc_dc" );
+    if( snapin_tile_cnt>1UL ) fd_topob_wksp( topo, "snapin_ix" );
+    if( snapin_tile_cnt>1UL ) fd_topob_wksp( topo, "snapin_rp" );
     fd_topob_wksp( topo, "snapin_ct"   );
     fd_topob_wksp( topo, "snapwr_ct"   );
 
@@ -418,6 +423,9 @@ fd_topo_initialize( config_t * config ) {
     /**/               fd_topob_link( topo, "snapct_ld",     "snapct_ld",     128UL,                                    sizeof(fd_ssctrl_init_t),      1UL );
     /**/               fd_topob_link( topo, "snapld_dc",     "snapld_dc",     16384UL,                                  FD_SNAPSHOT_DATA_MTU,          1UL );
     /**/               fd_topob_link( topo, "snapdc_in",     "snapdc_in",     16384UL,                                  FD_SNAPSHOT_DATA_MTU,          1UL );
+    FOR(snapdc_tile_cnt-1UL) fd_topob_link( topo, "snapdc_dc",   "snapdc_dc",     4096UL,                                   FD_SNAPSHOT_DATA_MTU,          1UL );
+    FOR(snapin_tile_cnt-1UL) fd_topob_link( topo, "snapin_ix",   "snapin_ix",     512UL,                                    sizeof(fd_ssctrl_ix_batch_t),  1UL );
+    FOR(snapin_tile_cnt-1UL) fd_topob_link( topo, "snapin_rp",   "snapin_rp",     16UL,                                     sizeof(fd_ssctrl_ix_report_t), 1UL );
 
     /**/               fd_topob_link( topo, "snapin_manif",  "snapin_manif",  4UL,                                      sizeof(fd_snapshot_manifest_t),1UL ); /* only 3 frags ever traverse: FULL, INCREMENTAL, DONE */
     /**/               fd_topob_link( topo, "snapct_repr",   "snapct_repr",   128UL,                                    0UL,                           1UL )->permit_no_consumers = 1; /* TODO: wire in repair later */
@@ -537,8 +545,8 @@ fd_topo_initialize( config_t * config ) {
   if( FD_LIKELY( snapshots_enabled ) ) {
     /**/               fd_topob_tile( topo, "snapct", "snapct", "metric_in", tile_to_cpu[ topo->tile_cnt ],    0,        0,                 0 )->allow_shutdown = 1;
     /**/               fd_topob_tile( topo, "snapld", "snapld", "metric_in", tile_to_cpu[ topo->tile_cnt ],    0,        0,                 0 )->allow_shutdown = 1;
-    /**/               fd_topob_tile( topo, "snapdc", "snapdc", "metric_in", tile_to_cpu[ topo->tile_cnt ],    0,        0,                 0 )->allow_shutdown = 1;
-    /**/               fd_topob_tile( topo, "snapin", "snapin", "metric_in", tile_to_cpu[ topo->tile_cnt ],    0,        0,                 0 )->allow_shutdown = 1;
+    FOR(snapdc_tile_cnt) fd_topob_tile( topo, "snapdc", "snapdc", "metric_in", tile_to_cpu[ topo->tile_cnt ],  0,        0,                 0 )->allow_shutdown = 1;
+    FOR(snapin_tile_cnt) fd_topob_tile( topo, "snapin", "snapin", "metric_in", tile_to_cpu[ topo->tile_cnt ],  0,        0,                 0 )->allow_shutdown = 1;
     /**/               fd_topob_tile( topo, "snapwr", "snapwr", "metric_in", tile_to_cpu[ topo->tile_cnt ],    0,        0,                 0 )->allow_shutdown = 1;
   }
   if( snapmk_enabled ) {
@@ -656,10 +664,22 @@ fd_topo_initialize( config_t * config ) {
     /**/              fd_topob_tile_in (    topo, "snapld",  0UL,          "metric_in", "snapct_ld",     0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
     /**/              fd_topob_tile_out(    topo, "snapld",  0UL,                       "snapld_dc",     0UL                                                );
 
-    /**/              fd_topob_tile_in (    topo, "snapdc",  0UL,          "metric_in", "snapld_dc",     0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+    FOR(snapdc_tile_cnt) fd_topob_tile_in ( topo, "snapdc",  i,            "metric_in", "snapld_dc",     0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
     /**/              fd_topob_tile_out(    topo, "snapdc",  0UL,                       "snapdc_in",     0UL                                                );
+    FOR(snapdc_tile_cnt-1UL) {
+      /* Helper snapdc tiles hand their frames to snapdc 0 */
+      /**/            fd_topob_tile_out(    topo, "snapdc",  i+1UL,                     "snapdc_dc",     i                                                  );
+      /**/            fd_topob_tile_in (    topo, "snapdc",  0UL,          "metric_in", "snapdc_dc",     i,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+    }
 
                       fd_topob_tile_in (    topo, "snapin",  0UL,          "metric_in", "snapdc_in",     0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+    FOR(snapin_tile_cnt-1UL) {
+      /* Inserter snapin tiles index the accounts found by snapin 0 */
+      /**/            fd_topob_tile_out(    topo, "snapin",  0UL,                       "snapin_ix",     i                                                  );
+      /**/            fd_topob_tile_in (    topo, "snapin",  i+1UL,        "metric_in", "snapin_ix",     i,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+      /**/            fd_topob_tile_out(    topo, "snapin",  i+1UL,                     "snapin_rp",     i                                                  );
+      /**/            fd_topob_tile_in (    topo, "snapin",  0UL,          "metric_in", "snapin_rp",     i,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+    }
                       fd_topob_tile_in (    topo, "snapwr",  0UL,          "metric_in", "snapdc_in",     0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
     if( FD_LIKELY( config->tiles.gui.enabled ) ) {
       /**/            fd_topob_tile_out(    topo, "snapin", 0UL,                        "snapin_gui",    0UL                                                );
@@ -1145,8 +1165,8 @@ fd_topo_initialize( config_t * config ) {
   FD_TEST( fd_pod_insertf_ulong( topo->props, txncache_obj->id, "txncache" ) );
 
   /* +1 for either snapin (snapshots enabled) or genesi (bootstrap), which
-     are mutually exclusive accdb writers. */
-  ulong accdb_joiners = 3UL+execle_tile_cnt+execrp_tile_cnt+resolv_tile_cnt+1UL;
+     are mutually exclusive accdb writers, plus any snapin inserters. */
+  ulong accdb_joiners = 3UL+execle_tile_cnt+execrp_tile_cnt+resolv_tile_cnt+1UL+(snapin_tile_cnt-1UL);
   ulong partition_sz = config->development.accdb.partition_size_gib*(1UL<<30UL);
   fd_topo_obj_t * accdb_obj = setup_topo_accdb( topo, "accdb_data",
       config->firedancer.accounts.max_accounts,
@@ -1167,7 +1187,7 @@ fd_topo_initialize( config_t * config ) {
     fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "genesi", 0UL ) ], accdb_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   }
   if( FD_LIKELY( snapshots_enabled ) ) {
-    fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "snapin", 0UL ) ], accdb_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+    FOR(snapin_tile_cnt) fd_topob_tile_uses( topo, &topo->tiles[ fd_topo_find_tile( topo, "snapin", i ) ], accdb_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   }
   fd_topo_obj_t * backup_obj = NULL;
   if( snapmk_enabled ) {
@@ -1432,6 +1452,7 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     tile->snapin.txncache_obj_id = fd_pod_query_ulong( config->topo.props, "txncache", ULONG_MAX );
     tile->snapin.banks_obj_id = fd_pod_query_ulong( config->topo.props, "banks", ULONG_MAX );
     tile->snapin.alpenglow = config->firedancer.development.alpenglow;
+    tile->snapin.verify_lthash = config->firedancer.snapshots.verify_accounts_lthash;
 
   } else if( FD_UNLIKELY( !strcmp( tile->name, "snapwr" ) ) ) {
     tile->snapwr.partition_sz = config->development.accdb.partition_size_gib*(1UL<<30UL);
@@ -1478,6 +1499,8 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     tile->replay.alpenglow = config->firedancer.development.alpenglow;
 
     tile->replay.sched_depth = config->tiles.replay.max_transaction_lookahead_buffer_size;
+    tile->replay.prefetch_lookahead_depth = fd_ulong_min( config->tiles.replay.prefetch_lookahead_depth, config->tiles.replay.max_transaction_lookahead_buffer_size );
+    tile->replay.cost_aware_dispatch = config->tiles.replay.cost_aware_dispatch;
     if( FD_LIKELY( !strcmp( config->firedancer.consensus.wait_for_supermajority_with_bank_hash, "" ) ) ) {
       memset( tile->replay.wait_for_supermajority_with_bank_hash.uc, 0, sizeof(fd_pubkey_t) );
     } else if( FD_UNLIKELY( !fd_base58_decode_32( config->firedancer.consensus.wait_for_supermajority_with_bank_hash, tile->replay.wait_for_supermajority_with_bank_hash.uc ) ) ) {
@@ -1529,6 +1552,9 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     tile->execrp.dump_txn_as_fixture = config->capture.dump_txn_as_fixture;
     tile->execrp.dump_syscall_to_pb = config->capture.dump_syscall_to_pb;
     tile->execrp.report_transaction_diffs = config->development.event.report_transaction_diffs;
+    tile->execrp.jit_slot_cnt = config->firedancer.runtime.program_cache.jit_slot_count;
+    tile->execrp.jit_slot_sz  = config->firedancer.runtime.program_cache.jit_slot_size_mib<<20;
+    tile->execrp.accdb_io_uring_depth = config->firedancer.accounts.io_uring_depth;
 
   } else if( FD_UNLIKELY( !strcmp( tile->name, "votor" ) ) ) {
     tile->votor.quic_server_listen_port = config->firedancer.development.votor.quic_server_listen_port;
@@ -1643,6 +1669,9 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     tile->execle.accdb_obj_id       = fd_pod_query_ulong( config->topo.props, "accdb",     ULONG_MAX ); FD_TEST( tile->execle.accdb_obj_id    !=ULONG_MAX );
     tile->execle.max_live_slots     = config->firedancer.runtime.max_live_slots;
     tile->execle.report_transaction_diffs = config->development.event.report_transaction_diffs;
+    tile->execle.jit_slot_cnt       = config->firedancer.runtime.program_cache.jit_slot_count;
+    tile->execle.jit_slot_sz        = config->firedancer.runtime.program_cache.jit_slot_size_mib<<20;
+    tile->execle.accdb_io_uring_depth = config->firedancer.accounts.io_uring_depth;
 
   } else if( FD_UNLIKELY( !strcmp( tile->name, "poh" ) ) ) {
     fd_cstr_ncpy( tile->poh.identity_key_path, config->paths.identity_key, sizeof(tile->poh.identity_key_path) );
@@ -1712,6 +1741,12 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
     parse_listen_addr( config->tiles.rpc.rpc_listen_address, "tiles.rpc.rpc_listen_address", &tile->rpc.listen_addr );
     tile->rpc.listen_port = config->tiles.rpc.rpc_listen_port;
     tile->rpc.delay_startup = config->tiles.rpc.delay_startup;
+    tile->rpc.account_index_max = config->tiles.rpc.account_index_max;
+    tile->rpc.transaction_status_max = config->tiles.rpc.transaction_status_max;
+    fd_cstr_ncpy( tile->rpc.txnstatus_path, config->paths.txnstatus, sizeof(tile->rpc.txnstatus_path) );
+    tile->rpc.block_archive_max = config->tiles.rpc.block_archive_max;
+    tile->rpc.block_cache_sz    = config->tiles.rpc.block_cache_size_mb<<20;
+    fd_cstr_ncpy( tile->rpc.blocks_path, config->paths.blocks, sizeof(tile->rpc.blocks_path) );
     tile->rpc.max_http_connections      = config->tiles.rpc.max_http_connections;
     tile->rpc.max_websocket_connections = config->tiles.rpc.max_websocket_connections;
     tile->rpc.max_http_request_length   = config->tiles.rpc.max_http_request_length;
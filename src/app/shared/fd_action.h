@@ -110,6 +110,27 @@ union fdctl_args {
     uint freq;
   } flame;
 
+  struct {
+    char   pcap_path[ PATH_MAX ];
+    char   link_name[ 128UL ];
+    int    first_seen;
+    int    quiet;
+
+    ulong  pack_depth;
+    ulong  execle_cnt;
+    ulong  max_txn_per_microblock;
+    ulong  max_cost_per_block;
+    long   slot_ns;
+    ulong  leader_slot_cnt;
+    ulong  rotation_slot_cnt;
+    long   poll_ns;
+    int    pacing;
+    ulong  exec_ns_per_txn;
+    float  exec_ns_per_cu;
+    ulong  cu_consumed_pct;
+    uint   seed;
+  } pack_sim;
+
   struct {
     char const * pos_arg;
     int          help;
@@ -178,11 +199,14 @@ union fdctl_args {
     int offline;
     int no_incremental;
     int no_watch;
+    int verify_lthash;
 
     char snapshot_dir[ PATH_MAX ];
 
     ulong db_rec_max;
     ulong cache_sz;
+    ulong snapdc_tile_cnt;
+    ulong snapin_tile_cnt;
   } snapshot_load;
 
   struct {
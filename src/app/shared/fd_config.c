@@ -123,6 +123,20 @@ fd_config_fillf( fd_config_t * config ) {
     FD_TEST( fd_cstr_printf_check( config->paths.shredb, sizeof(config->paths.shredb), NULL, "%s/shreds.db", config->paths.base ) );
   }
 
+  if( FD_UNLIKELY( strcmp( config->paths.txnstatus, "" ) ) ) {
+    replace( config->paths.txnstatus, "{user}", config->user );
+    replace( config->paths.txnstatus, "{name}", config->name );
+  } else {
+    FD_TEST( fd_cstr_printf_check( config->paths.txnstatus, sizeof(config->paths.txnstatus), NULL, "%s/txnstatus.db", config->paths.base ) );
+  }
+
+  if( FD_UNLIKELY( strcmp( config->paths.blocks, "" ) ) ) {
+    replace( config->paths.blocks, "{user}", config->user );
+    replace( config->paths.blocks, "{name}", config->name );
+  } else {
+    FD_TEST( fd_cstr_printf_check( config->paths.blocks, sizeof(config->paths.blocks), NULL, "%s/blocks.db", config->paths.base ) );
+  }
+
   if( FD_UNLIKELY( strcmp( config->paths.guidb, "" ) ) ) {
     replace( config->paths.guidb, "{user}", config->user );
     replace( config->paths.guidb, "{name}", config->name );
@@ -461,6 +475,8 @@ fd_config_validatef( fd_configf_t const * config ) {
   CFG_HAS_NON_ZERO( layout.sign_tile_count );
   CFG_HAS_NON_ZERO( layout.resolv_tile_count );
   CFG_HAS_NON_ZERO( layout.execle_tile_count );
+  CFG_HAS_NON_ZERO( layout.snapdc_tile_count );
+  CFG_HAS_NON_ZERO( layout.snapin_tile_count );
   CFG_HAS_NON_ZERO( layout.snapzp_tile_count );
   CFG_HAS_NON_ZERO( layout.snapsv_tile_count );
   CFG_HAS_NON_ZERO( layout.snapsv_io_worker_count );
@@ -505,6 +521,10 @@ fd_config_validatef( fd_configf_t const * config ) {
 
   CFG_HAS_NON_ZERO( accounts.max_accounts   );
   CFG_HAS_NON_ZERO( accounts.cache_size_gib );
+  if( config->accounts.io_uring_depth ) {
+    if( !fd_ulong_is_pow2( config->accounts.io_uring_depth ) ) { FD_LOG_ERR(( "`%s` must be a power of two", "accounts.io_uring_depth" )); }
+    if( config->accounts.io_uring_depth > 4096 ) { FD_LOG_ERR(( "`%s` must be <= 4096", "accounts.io_uring_depth" )); }
+  }
 
   CFG_HAS_NON_ZERO( development.genesis.max_file_size_mib );
   if( FD_UNLIKELY( config->development.genesis.max_file_size_mib>FD_GENESIS_MAX_FILE_SIZE_MIB ) ) {
@@ -515,6 +535,14 @@ fd_config_validatef( fd_configf_t const * config ) {
   CFG_HAS_NON_ZERO( runtime.program_cache.heap_size_mib );
   if( config->runtime.program_cache.mean_cache_entry_size < 4096 ) { FD_LOG_ERR(( "`%s` must be >= 4096", "runtime.program_cache.mean_cache_entry_size" )); }
   if( config->runtime.program_cache.heap_size_mib < 32 ) { FD_LOG_ERR(( "`%s` must be >= 32", "runtime.program_cache.heap_size_mib" )); }
+  if( config->runtime.program_cache.jit_slot_count > 16 ) { FD_LOG_ERR(( "`%s` must be <= 16", "runtime.program_cache.jit_slot_count" )); }
+  if( config->runtime.program_cache.jit_slot_count ) {
+    CFG_HAS_NON_ZERO( runtime.program_cache.jit_slot_size_mib );
+    if( config->runtime.program_cache.jit_slot_size_mib > 4096 ) { FD_LOG_ERR(( "`%s` must be <= 4096", "runtime.program_cache.jit_slot_size_mib" )); }
+#if !FD_HAS_X86
+    FD_LOG_ERR(( "`runtime.program_cache.jit_slot_count` must be 0 (JIT not supported on this target)" ));
+#endif
+  }
 }
 
 static void
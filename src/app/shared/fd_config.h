@@ -101,6 +101,7 @@ struct fd_configf {
   struct {
     ulong max_accounts;
     ulong cache_size_gib;
+    ulong io_uring_depth;
   } accounts;
 
   struct {
@@ -111,6 +112,8 @@ struct fd_configf {
     uint resolv_tile_count;
     uint execle_tile_count;
     uint execrp_tile_count;
+    uint snapdc_tile_count;
+    uint snapin_tile_count;
     uint snapzp_tile_count;
     uint snapsv_tile_count;
     uint snapsv_io_worker_count;
@@ -123,6 +126,8 @@ struct fd_configf {
     struct {
       ulong heap_size_mib;
       ulong mean_cache_entry_size;
+      ulong jit_slot_count;
+      ulong jit_slot_size_mib;
     } program_cache;
   } runtime;
 
@@ -153,6 +158,7 @@ struct fd_configf {
 
     int  incremental_snapshots;
     int  genesis_download;
+    int  verify_accounts_lthash;
     uint max_full_snapshots_to_keep;
     uint max_incremental_snapshots_to_keep;
     uint max_retry_abort;
@@ -242,6 +248,8 @@ struct fd_config_net {
   struct {
     uint receive_buffer_size;
     uint send_buffer_size;
+    int  udp_gso;
+    int  udp_gro;
   } socket;
 };
 typedef struct fd_config_net fd_config_net_t;
@@ -286,6 +294,8 @@ struct fd_config {
     char genesis[ PATH_MAX ];
     char accounts[ PATH_MAX ];
     char shredb[ PATH_MAX ];
+    char txnstatus[ PATH_MAX ];
+    char blocks[ PATH_MAX ];
     char guidb[ PATH_MAX ];
   } paths;
 
@@ -516,6 +526,10 @@ struct fd_config {
       ulong  max_http_request_length;
       ulong  send_buffer_size_mb;
       int    delay_startup;
+      ulong  account_index_max;
+      ulong  transaction_status_max;
+      ulong  block_archive_max;
+      ulong  block_cache_size_mb;
     } rpc;
 
     struct {
@@ -531,6 +545,8 @@ struct fd_config {
 
     struct {
       ulong max_transaction_lookahead_buffer_size;
+      ulong prefetch_lookahead_depth;
+      int   cost_aware_dispatch;
       ulong enable_features_cnt;
       char  enable_features[ 16 ][ FD_BASE58_ENCODED_32_SZ ];
     } replay;
@@ -91,18 +91,23 @@ fd_config_extract_podf( uchar *        pod,
   CFG_POP      ( uint,   layout.resolv_tile_count                            );
   CFG_POP      ( uint,   layout.execle_tile_count                            );
   CFG_POP      ( uint,   layout.gossvf_tile_count                            );
+  CFG_POP      ( uint,   layout.snapdc_tile_count                            );
+  CFG_POP      ( uint,   layout.snapin_tile_count                            );
   CFG_POP      ( uint,   layout.snapzp_tile_count                            );
   CFG_POP      ( uint,   layout.snapsv_tile_count                            );
   CFG_POP      ( uint,   layout.snapsv_io_worker_count                       );
 
   CFG_POP      ( ulong,  accounts.max_accounts                               );
   CFG_POP      ( ulong,  accounts.cache_size_gib                             );
+  CFG_POP      ( ulong,  accounts.io_uring_depth                             );
 
   CFG_POP      ( ulong,  runtime.max_live_slots                              );
   CFG_POP      ( ulong,  runtime.max_fork_width                              );
 
   CFG_POP      ( ulong,  runtime.program_cache.heap_size_mib                 );
   CFG_POP      ( ulong,  runtime.program_cache.mean_cache_entry_size         );
+  CFG_POP      ( ulong,  runtime.program_cache.jit_slot_count                );
+  CFG_POP      ( ulong,  runtime.program_cache.jit_slot_size_mib             );
 
   CFG_POP      ( cstr,   consensus.wait_for_supermajority_with_bank_hash     );
 
@@ -114,6 +119,7 @@ fd_config_extract_podf( uchar *        pod,
   CFG_POP_ARRAY( cstr,   snapshots.sources.servers                           );
   CFG_POP      ( bool,   snapshots.incremental_snapshots                     );
   CFG_POP      ( bool,   snapshots.genesis_download                          );
+  CFG_POP      ( bool,   snapshots.verify_accounts_lthash                    );
   CFG_POP      ( uint,   snapshots.max_full_snapshots_to_keep                );
   CFG_POP      ( uint,   snapshots.max_incremental_snapshots_to_keep         );
   CFG_POP      ( uint,   snapshots.max_retry_abort                           );
@@ -174,6 +180,8 @@ fd_config_extract_pod( uchar *       pod,
     CFG_POP    ( cstr,   paths.genesis                                    );
     CFG_POP    ( cstr,   paths.accounts                                   );
     CFG_POP    ( cstr,   paths.shredb                                 );
+    CFG_POP    ( cstr,   paths.txnstatus                              );
+    CFG_POP    ( cstr,   paths.blocks                                 );
     CFG_POP    ( cstr,   paths.guidb                                  );
   } else {
     CFG_POP1   ( cstr,   scratch_directory,           paths.base          );
@@ -215,6 +223,8 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( boolau, net.xdp.native_bond                              );
   CFG_POP      ( uint,   net.socket.receive_buffer_size                   );
   CFG_POP      ( uint,   net.socket.send_buffer_size                      );
+  CFG_POP      ( bool,   net.socket.udp_gso                               );
+  CFG_POP      ( bool,   net.socket.udp_gro                               );
 
   CFG_POP      ( ulong,  tiles.netlink.max_routes                         );
   CFG_POP      ( ulong,  tiles.netlink.max_peer_routes                    );
@@ -254,6 +264,8 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP_ARRAY( cstr,   tiles.pack.account_blocklist                     );
 
   CFG_POP      ( ulong,  tiles.replay.max_transaction_lookahead_buffer_size );
+  CFG_POP      ( ulong,  tiles.replay.prefetch_lookahead_depth              );
+  CFG_POP      ( bool,   tiles.replay.cost_aware_dispatch                   );
   CFG_POP_ARRAY( cstr,   tiles.replay.enable_features                       );
 
   CFG_POP      ( bool,   tiles.pohh.lagged_consecutive_leader_start       );
@@ -285,6 +297,10 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( ulong,  tiles.rpc.max_http_request_length                );
   CFG_POP      ( ulong,  tiles.rpc.send_buffer_size_mb                    );
   CFG_POP      ( bool,   tiles.rpc.delay_startup                          );
+  CFG_POP      ( ulong,  tiles.rpc.account_index_max                      );
+  CFG_POP      ( ulong,  tiles.rpc.transaction_status_max                 );
+  CFG_POP      ( ulong,  tiles.rpc.block_archive_max                      );
+  CFG_POP      ( ulong,  tiles.rpc.block_cache_size_mb                    );
 
   CFG_POP      ( ushort, tiles.repair.repair_client_listen_port           );
   CFG_POP      ( ulong,  tiles.repair.slot_max                            );
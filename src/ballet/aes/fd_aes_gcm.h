@@ -80,6 +80,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_ref
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_ref
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_ref
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_ref
 
 #elif FD_AES_GCM_IMPL == 1
 
@@ -87,6 +88,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_aesni
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_aesni
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_aesni
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_aesni
 
 #elif FD_AES_GCM_IMPL == 2
 
@@ -94,6 +96,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_avx2
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_avx2
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_avx2
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_aesni
 
 #elif FD_AES_GCM_IMPL == 3
 
@@ -101,6 +104,7 @@ typedef struct fd_aes_gcm_avx10_state fd_aes_gcm_avx10_t;
   #define fd_aes_128_gcm_init fd_aes_128_gcm_init_avx10_512
   #define fd_aes_gcm_encrypt  fd_aes_gcm_encrypt_avx10_512
   #define fd_aes_gcm_decrypt  fd_aes_gcm_decrypt_avx10_512
+  #define fd_aes_gcm_set_iv   fd_aes_gcm_set_iv_avx10
 
 #endif
 
@@ -125,6 +129,16 @@ fd_aes_128_gcm_init( fd_aes_gcm_t * aes_gcm,
                      uchar const    key[ 16 ],
                      uchar const    iv [ 12 ] );
 
+/* fd_aes_gcm_set_iv replaces the initialization vector of an
+   fd_aes_gcm_t previously initialized with fd_aes_128_gcm_init,
+   keeping its expanded key and GHASH key powers.  Much cheaper than
+   fd_aes_128_gcm_init when processing several messages under the same
+   key (e.g. consecutive QUIC packets of a connection). */
+
+void
+fd_aes_gcm_set_iv( fd_aes_gcm_t * aes_gcm,
+                   uchar const    iv[ 12 ] );
+
 /* fd_aes_gcm_aead_{encrypt,decrypt} implements the AES-GCM AEAD cipher
    c points to the ciphertext buffer.  p points to the plaintext buffer.
    sz is the length of the p and c buffers.  p,c,sz do not have align-
@@ -3,6 +3,7 @@ $(call add-objs,fd_bmtree,fd_ballet)
 
 $(call make-unit-test,test_bmtree,test_bmtree,fd_ballet fd_util)
 $(call run-unit-test,test_bmtree)
+$(call make-unit-test,bench_bmtree,bench_bmtree,fd_ballet fd_util)
 ifdef FD_HAS_HOSTED
 $(call make-fuzz-test,fuzz_bmtree,fuzz_bmtree,fd_ballet fd_util)
 endif
@@ -0,0 +1,76 @@
+#include "fd_bmtree.h"
+#include "../sha256/fd_sha256.h"
+#include "../../util/fd_util.h"
+
+/* bench_bmtree: build shred-style Merkle trees (20 byte nodes, long
+   prefix) the size of 32, 64 and 134 shred FEC sets and report the
+   time to derive the root and inclusion proofs with the one node at a
+   time append path and the layer at a time batch path.  Leaf hashing
+   is not included as both paths take precomputed leaves. */
+
+#define LEAF_MAX  (256UL)
+#define LAYER_MAX (9UL)
+
+static fd_bmtree_node_t leaf[ LEAF_MAX ];
+static uchar tree_mem[ FD_BMTREE_COMMIT_FOOTPRINT( LAYER_MAX ) ] __attribute__((aligned(FD_BMTREE_COMMIT_ALIGN)));
+
+static void
+bench( ulong leaf_cnt,
+       ulong iter_cnt ) {
+  for( ulong i=0UL; i<leaf_cnt; i++ ) fd_bmtree_hash_leaf( leaf+i, &i, sizeof(ulong), FD_BMTREE_LONG_PREFIX_SZ );
+
+  uchar root[ 32 ];
+  fd_memcpy( root, fd_bmtree_commit_fini( fd_bmtree_commit_append(
+      fd_bmtree_commit_init( tree_mem, 20UL, FD_BMTREE_LONG_PREFIX_SZ, LAYER_MAX ), leaf, leaf_cnt ) ), 32UL );
+  FD_TEST( fd_memeq( root, fd_bmtree_commit_batch(
+      fd_bmtree_commit_init( tree_mem, 20UL, FD_BMTREE_LONG_PREFIX_SZ, LAYER_MAX ), leaf, leaf_cnt ), 20UL ) );
+
+  long dt_append = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    fd_bmtree_commit_t * tree = fd_bmtree_commit_init( tree_mem, 20UL, FD_BMTREE_LONG_PREFIX_SZ, LAYER_MAX );
+    uchar * r = fd_bmtree_commit_fini( fd_bmtree_commit_append( tree, leaf, leaf_cnt ) );
+    FD_COMPILER_FORGET( r );
+  }
+  dt_append += fd_log_wallclock();
+
+  long dt_batch = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    fd_bmtree_commit_t * tree = fd_bmtree_commit_init( tree_mem, 20UL, FD_BMTREE_LONG_PREFIX_SZ, LAYER_MAX );
+    uchar * r = fd_bmtree_commit_batch( tree, leaf, leaf_cnt );
+    FD_COMPILER_FORGET( r );
+  }
+  dt_batch += fd_log_wallclock();
+
+  double ns_append = (double)dt_append/(double)iter_cnt;
+  double ns_batch  = (double)dt_batch /(double)iter_cnt;
+  FD_LOG_NOTICE(( "%3lu leaves: append %8.1f ns/tree (%6.3f M leaf/s), batch %8.1f ns/tree (%6.3f M leaf/s), %.2fx",
+                  leaf_cnt,
+                  ns_append, 1e3*(double)leaf_cnt/ns_append,
+                  ns_batch,  1e3*(double)leaf_cnt/ns_batch,
+                  ns_append/ns_batch ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter",     NULL, 100000UL );
+  ulong leaf_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--leaf-cnt", NULL, 0UL      );
+
+  FD_TEST( iter_cnt );
+  FD_TEST( leaf_cnt<=LEAF_MAX );
+  FD_LOG_NOTICE(( "bmtree bench (iter=%lu sha256 batch=%lu)", iter_cnt, (ulong)FD_SHA256_BATCH_MAX ));
+
+  if( leaf_cnt ) {
+    bench( leaf_cnt, iter_cnt );
+  } else {
+    bench(  32UL, iter_cnt );
+    bench(  64UL, iter_cnt );
+    bench( 134UL, iter_cnt );
+  }
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -318,6 +318,76 @@ fd_bmtree_commit_fini( fd_bmtree_commit_t * state ) {
   return root->hash;
 }
 
+/* fd_bmtree_private_node_idx returns the index in inclusion_proofs of
+   the idx^th node (counting from the left) of the given layer. */
+
+FD_FN_CONST static inline ulong
+fd_bmtree_private_node_idx( ulong layer,
+                            ulong idx ) {
+  return (idx<<(layer+1UL)) + (1UL<<layer) - 1UL;
+}
+
+/* fd_bmtree_commit_batch stages up to BATCH_MSG_MAX branch preimages
+   (prefix|left|right, at most 26+32+32 bytes each) at a time and hashes
+   them in one SHA-256 batch.  The preimages have to stay put until the
+   batch is finished, so they can't be built in a single scratch node
+   like merge does. */
+
+#define FD_BMTREE_PRIVATE_BATCH_MSG_MAX (64UL)
+#define FD_BMTREE_PRIVATE_BATCH_MSG_SZ  (96UL)
+
+uchar *
+fd_bmtree_commit_batch( fd_bmtree_commit_t *                 state,
+                        fd_bmtree_node_t const * FD_RESTRICT new_leaf,
+                        ulong                                new_leaf_cnt ) {
+  ulong depth = fd_bmtree_depth( new_leaf_cnt );
+
+  /* Every layer is read back out of inclusion_proofs to build the one
+     above it, so all (1<<depth)-1 slots of the tree need to be there. */
+  if( FD_UNLIKELY( depth>63UL || ((1UL<<depth)-1UL)>state->inclusion_proof_sz ) ) {
+    return fd_bmtree_commit_fini( fd_bmtree_commit_append( state, new_leaf, new_leaf_cnt ) );
+  }
+
+  ulong              hash_sz   = state->hash_sz;
+  ulong              prefix_sz = state->prefix_sz;
+  fd_bmtree_node_t * node      = state->inclusion_proofs;
+
+  for( ulong i=0UL; i<new_leaf_cnt; i++ ) node[ fd_bmtree_private_node_idx( 0UL, i ) ] = new_leaf[ i ];
+
+  uchar msg[ FD_BMTREE_PRIVATE_BATCH_MSG_MAX ][ FD_BMTREE_PRIVATE_BATCH_MSG_SZ ] __attribute__((aligned(32)));
+  uchar batch_mem[ FD_SHA256_BATCH_FOOTPRINT ] __attribute__((aligned(FD_SHA256_BATCH_ALIGN)));
+
+  ulong layer_cnt = new_leaf_cnt;
+  for( ulong layer=0UL; layer_cnt>1UL; layer++ ) {
+    ulong parent_cnt = (layer_cnt+1UL)>>1;
+
+    for( ulong j0=0UL; j0<parent_cnt; j0+=FD_BMTREE_PRIVATE_BATCH_MSG_MAX ) {
+      ulong j1 = fd_ulong_min( j0+FD_BMTREE_PRIVATE_BATCH_MSG_MAX, parent_cnt );
+
+      fd_sha256_batch_t * batch = fd_sha256_batch_init( batch_mem );
+      for( ulong j=j0; j<j1; j++ ) {
+        /* A parent with only one child duplicates the link to it. */
+        fd_bmtree_node_t const * l = node + fd_bmtree_private_node_idx( layer, 2UL*j );
+        fd_bmtree_node_t const * r = node + fd_bmtree_private_node_idx( layer, fd_ulong_min( 2UL*j+1UL, layer_cnt-1UL ) );
+
+        uchar * m = msg[ j-j0 ];
+        fd_memcpy( m,                   fd_bmtree_node_prefix, prefix_sz );
+        fd_memcpy( m+prefix_sz,         l->hash,               hash_sz   );
+        fd_memcpy( m+prefix_sz+hash_sz, r->hash,               hash_sz   );
+        fd_sha256_batch_add( batch, m, prefix_sz+2UL*hash_sz, node[ fd_bmtree_private_node_idx( layer+1UL, j ) ].hash );
+      }
+      fd_sha256_batch_fini( batch );
+    }
+
+    layer_cnt = parent_cnt;
+  }
+
+  fd_bmtree_node_t * root = state->node_buf + (depth-1UL);
+  *root = node[ fd_bmtree_private_node_idx( depth-1UL, 0UL ) ];
+  state->leaf_cnt = new_leaf_cnt;
+  return root->hash;
+}
+
 int
 fd_bmtree_get_proof( fd_bmtree_commit_t * state,
                      uchar *              dest,
@@ -131,7 +131,40 @@ test_inclusion( ulong leaf_cnt ) {
 
 }
 
+/* test_batch checks fd_bmtree_commit_batch produces the same root and
+   inclusion proofs as append/fini. */
 
+static void
+test_batch( ulong leaf_cnt,
+            ulong hash_sz,
+            ulong prefix_sz ) {
+  static fd_bmtree_node_t leaf[ 256UL ];
+  static uchar            inc_proof2[ 63*32 ];
+  FD_TEST( leaf_cnt<=256UL );
+
+  for( ulong i=0UL; i<leaf_cnt; i++ ) fd_bmtree_hash_leaf( leaf+i, &i, sizeof(ulong), prefix_sz );
+
+  ulong footprint = fd_bmtree_commit_footprint( 9UL );
+  fd_bmtree_commit_t * tree  = fd_bmtree_commit_init( memory, hash_sz, prefix_sz, 9UL );
+  uchar * _memory = (uchar*)fd_ulong_align_up( (ulong)(memory+footprint), FD_BMTREE_COMMIT_ALIGN );
+  fd_bmtree_commit_t * btree = fd_bmtree_commit_init( _memory, hash_sz, prefix_sz, 9UL );
+
+  uchar * root  = fd_bmtree_commit_fini( fd_bmtree_commit_append( tree, leaf, leaf_cnt ) );
+  uchar * root2 = fd_bmtree_commit_batch( btree, leaf, leaf_cnt );
+  FD_TEST( fd_memeq( root, root2, 32UL ) );
+  FD_TEST( fd_bmtree_commit_leaf_cnt( btree )==leaf_cnt );
+
+  for( ulong i=0UL; i<leaf_cnt; i++ ) {
+    int depth = fd_bmtree_get_proof( tree, inc_proof, i );
+    FD_TEST( depth==fd_bmtree_get_proof( btree, inc_proof2, i ) );
+    FD_TEST( fd_memeq( inc_proof, inc_proof2, (ulong)depth*hash_sz ) );
+  }
+
+  /* Too few inclusion proof layers falls back to append */
+  fd_bmtree_commit_t _small[1];
+  fd_bmtree_commit_t * small = fd_bmtree_commit_init( _small, hash_sz, prefix_sz, 0UL );
+  FD_TEST( fd_memeq( root, fd_bmtree_commit_batch( small, leaf, leaf_cnt ), 32UL ) );
+}
 
 int
 main( int     argc,
@@ -152,6 +185,11 @@ main( int     argc,
 
   for( ulong leaf_cnt=1UL; leaf_cnt<=256UL; leaf_cnt++ ) test_inclusion( leaf_cnt );
 
+  for( ulong leaf_cnt=1UL; leaf_cnt<=256UL; leaf_cnt++ ) {
+    test_batch( leaf_cnt, 20UL, FD_BMTREE_LONG_PREFIX_SZ  );
+    test_batch( leaf_cnt, 32UL, FD_BMTREE_SHORT_PREFIX_SZ );
+  }
+
   for( ulong leaf_cnt=2UL; leaf_cnt<10000000UL; leaf_cnt++ ) {
     ulong depth = 1UL;
     ulong nodes = 1UL;
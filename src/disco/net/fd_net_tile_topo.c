@@ -80,6 +80,8 @@ setup_sock_tile( fd_topo_t *             topo,
   if( FD_UNLIKELY( net_cfg->socket.send_buffer_size   >INT_MAX ) ) FD_LOG_ERR(( "invalid [net.socket.send_buffer_size]" ));
   tile->sock.so_rcvbuf = (int)net_cfg->socket.receive_buffer_size;
   tile->sock.so_sndbuf = (int)net_cfg->socket.send_buffer_size   ;
+  tile->sock.udp_gso   = net_cfg->socket.udp_gso;
+  tile->sock.udp_gro   = net_cfg->socket.udp_gro;
 }
 
 void
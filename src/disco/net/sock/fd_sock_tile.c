@@ -11,6 +11,7 @@
 #include <fcntl.h> /* fcntl */
 #include <unistd.h> /* dup3, close */
 #include <netinet/in.h> /* sockaddr_in */
+#include <netinet/udp.h> /* UDP_SEGMENT, UDP_GRO */
 #include <sys/socket.h> /* socket */
 #include "../../metrics/fd_metrics.h"
 
@@ -21,6 +22,10 @@
    FIXME keep in sync with fd_net_tile_topo.c */
 #define STEM_BURST (64UL)
 
+/* after_credit polls for RX once TX has been idle for more than
+   TX_IDLE_RX_POLL_CNT iterations */
+#define TX_IDLE_RX_POLL_CNT (512U)
+
 /* Place RX socket file descriptors in contiguous integer range. */
 #define RX_SOCK_FD_MIN (128)
 
@@ -28,6 +33,17 @@
    Must be aligned by alignof(struct cmsghdr) */
 #define FD_SOCK_CMSG_MAX (64UL)
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+/* TX entries carry IP_PKTINFO and UDP_SEGMENT, RX entries IP_PKTINFO
+   and UDP_GRO */
+FD_STATIC_ASSERT( CMSG_SPACE( sizeof(struct in_pktinfo) )+CMSG_SPACE( sizeof(int) )<=FD_SOCK_CMSG_MAX, cmsg );
+
 static ulong
 populate_allowed_seccomp( fd_topo_t const *      topo,
                           fd_topo_tile_t const * tile,
@@ -78,25 +94,39 @@ scratch_align( void ) {
 }
 
 FD_FN_PURE static inline ulong
-scratch_footprint( fd_topo_tile_t const * tile FD_PARAM_UNUSED ) {
+scratch_footprint( fd_topo_tile_t const * tile ) {
   ulong l = FD_LAYOUT_INIT;
   l = FD_LAYOUT_APPEND( l, alignof(fd_sock_tile_t),     sizeof(fd_sock_tile_t)                );
   l = FD_LAYOUT_APPEND( l, alignof(struct iovec),       STEM_BURST*sizeof(struct iovec)       );
   l = FD_LAYOUT_APPEND( l, alignof(struct cmsghdr),     STEM_BURST*FD_SOCK_CMSG_MAX           );
   l = FD_LAYOUT_APPEND( l, alignof(struct sockaddr_in), STEM_BURST*sizeof(struct sockaddr_in) );
   l = FD_LAYOUT_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_sock_tx_meta_t),  STEM_BURST*sizeof(fd_sock_tx_meta_t)  );
   l = FD_LAYOUT_APPEND( l, FD_CHUNK_ALIGN,              tx_scratch_footprint()                );
+  if( tile->sock.udp_gro ) {
+    l = FD_LAYOUT_APPEND( l, alignof(struct iovec),       FD_SOCK_GRO_BATCH*sizeof(struct iovec)       );
+    l = FD_LAYOUT_APPEND( l, alignof(struct cmsghdr),     FD_SOCK_GRO_BATCH*FD_SOCK_CMSG_MAX           );
+    l = FD_LAYOUT_APPEND( l, alignof(struct sockaddr_in), FD_SOCK_GRO_BATCH*sizeof(struct sockaddr_in) );
+    l = FD_LAYOUT_APPEND( l, alignof(struct mmsghdr),     FD_SOCK_GRO_BATCH*sizeof(struct mmsghdr)     );
+    l = FD_LAYOUT_APPEND( l, FD_CHUNK_ALIGN,              FD_SOCK_GRO_BATCH*FD_SOCK_GRO_BUF_SZ         );
+  }
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
 /* create_udp_socket creates and configures a new UDP socket for the
-   sock tile at the given file descriptor ID. */
+   sock tile at the given file descriptor ID.  If *gso is set, the
+   socket is also used for sending: SO_SNDBUF is set to so_sndbuf and
+   UDP_SEGMENT support is probed.  If *gro is set, UDP_GRO is enabled.
+   Either flag is cleared if the kernel does not support it. */
 
 static void
 create_udp_socket( int    sock_fd,
                    uint   bind_addr,
                    ushort udp_port,
-                   int    so_rcvbuf ) {
+                   int    so_rcvbuf,
+                   int    so_sndbuf,
+                   int *  gso,
+                   int *  gro ) {
 
   if( fcntl( sock_fd, F_GETFD, 0 )!=-1 ) {
     FD_LOG_ERR(( "file descriptor %d already exists", sock_fd ));
@@ -123,6 +153,25 @@ create_udp_socket( int    sock_fd,
     FD_LOG_ERR(( "setsockopt(SOL_SOCKET,SO_RCVBUF,%i) failed (%i-%s)", so_rcvbuf, errno, fd_io_strerror( errno ) ));
   }
 
+  if( *gso ) {
+    if( FD_UNLIKELY( 0!=setsockopt( orig_fd, SOL_SOCKET, SO_SNDBUF, &so_sndbuf, sizeof(int) ) ) ) {
+      FD_LOG_ERR(( "setsockopt(SOL_SOCKET,SO_SNDBUF,%i) failed (%i-%s)", so_sndbuf, errno, fd_io_strerror( errno ) ));
+    }
+    int gso_sz = 0;
+    if( FD_UNLIKELY( 0!=setsockopt( orig_fd, SOL_UDP, UDP_SEGMENT, &gso_sz, sizeof(int) ) ) ) {
+      FD_LOG_WARNING(( "setsockopt(SOL_UDP,UDP_SEGMENT,0) failed (%i-%s), disabling UDP GSO", errno, fd_io_strerror( errno ) ));
+      *gso = 0;
+    }
+  }
+
+  if( *gro ) {
+    int udp_gro = 1;
+    if( FD_UNLIKELY( 0!=setsockopt( orig_fd, SOL_UDP, UDP_GRO, &udp_gro, sizeof(int) ) ) ) {
+      FD_LOG_WARNING(( "setsockopt(SOL_UDP,UDP_GRO,1) failed (%i-%s), disabling UDP GRO", errno, fd_io_strerror( errno ) ));
+      *gro = 0;
+    }
+  }
+
   struct sockaddr_in saddr = {
     .sin_family      = AF_INET,
     .sin_addr.s_addr = bind_addr,
@@ -157,6 +206,7 @@ privileged_init( fd_topo_t const *      topo,
   void *               batch_cmsg = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct cmsghdr),     STEM_BURST*FD_SOCK_CMSG_MAX           );
   struct sockaddr_in * batch_sa   = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct sockaddr_in), STEM_BURST*sizeof(struct sockaddr_in) );
   struct mmsghdr *     batch_msg  = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
+  fd_sock_tx_meta_t *  batch_meta = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_sock_tx_meta_t),  STEM_BURST*sizeof(fd_sock_tx_meta_t)  );
   uchar *              tx_scratch = FD_SCRATCH_ALLOC_APPEND( l, FD_CHUNK_ALIGN,              tx_scratch_footprint()                );
   FD_DCHECK_CRIT( scratch==ctx, "invalid layout" );
 
@@ -165,16 +215,28 @@ privileged_init( fd_topo_t const *      topo,
   fd_memset( batch_sa,  0, STEM_BURST*sizeof(struct sockaddr_in) );
   fd_memset( batch_msg, 0, STEM_BURST*sizeof(struct mmsghdr)     );
 
-  ctx->batch_cnt   = 0UL;
-  ctx->batch_iov   = batch_iov;
-  ctx->batch_cmsg  = batch_cmsg;
-  ctx->batch_sa    = batch_sa;
-  ctx->batch_msg   = batch_msg;
-  ctx->tx_scratch0 = tx_scratch;
-  ctx->tx_scratch1 = tx_scratch + tx_scratch_footprint();
-  ctx->tx_ptr      = tx_scratch;
+  ctx->batch_cnt     = 0UL;
+  ctx->batch_msg_cnt = 0UL;
+  ctx->batch_iov     = batch_iov;
+  ctx->batch_cmsg    = batch_cmsg;
+  ctx->batch_sa      = batch_sa;
+  ctx->batch_msg     = batch_msg;
+  ctx->batch_meta    = batch_meta;
+  ctx->tx_scratch0   = tx_scratch;
+  ctx->tx_scratch1   = tx_scratch + tx_scratch_footprint();
+  ctx->tx_ptr        = tx_scratch;
   ctx->repair_shred_sock_idx = UINT_MAX;
 
+  if( tile->sock.udp_gro ) {
+    ctx->gro_iov  = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct iovec),       FD_SOCK_GRO_BATCH*sizeof(struct iovec)       );
+    ctx->gro_cmsg = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct cmsghdr),     FD_SOCK_GRO_BATCH*FD_SOCK_CMSG_MAX           );
+    ctx->gro_sa   = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct sockaddr_in), FD_SOCK_GRO_BATCH*sizeof(struct sockaddr_in) );
+    ctx->gro_msg  = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct mmsghdr),     FD_SOCK_GRO_BATCH*sizeof(struct mmsghdr)     );
+    ctx->gro_buf  = FD_SCRATCH_ALLOC_APPEND( l, FD_CHUNK_ALIGN,              FD_SOCK_GRO_BATCH*FD_SOCK_GRO_BUF_SZ         );
+  }
+
+  int gso = tile->sock.udp_gso;
+
   /* Create receive sockets.  Incrementally assign them to file
      descriptors starting at sock_fd_min. */
 
@@ -238,7 +300,9 @@ privileged_init( fd_topo_t const *      topo,
       ctx->repair_shred_sock_idx = sock_idx;
 
     int sock_fd = sock_fd_min + (int)sock_idx;
-    create_udp_socket( sock_fd, tile->sock.net.bind_address, port, tile->sock.so_rcvbuf );
+    int gro     = tile->sock.udp_gro;
+    create_udp_socket( sock_fd, tile->sock.net.bind_address, port, tile->sock.so_rcvbuf, tile->sock.so_sndbuf, &gso, &gro );
+    ctx->rx_gro[ sock_idx ]        = (uchar)gro;
     ctx->pollfd[ sock_idx ].fd     = sock_fd;
     ctx->pollfd[ sock_idx ].events = POLLIN;
     ctx->sock_cnt++;
@@ -261,6 +325,7 @@ privileged_init( fd_topo_t const *      topo,
   }
 
   ctx->tx_sock      = tx_sock;
+  ctx->tx_gso       = gso;
   ctx->bind_address = tile->sock.net.bind_address;
 }
 
@@ -310,6 +375,95 @@ unprivileged_init( fd_topo_t const *      topo,
 /* FIXME Pace RX polling and interleave it with TX jobs to reduce TX
          tail latency */
 
+/* rx_cmsg_parse extracts the destination address (IP_PKTINFO) and, on
+   UDP_GRO sockets, the segment size of a coalesced datagram from the
+   ancillary data of a received message.  *gso_sz is left unchanged if
+   the datagram was not coalesced. */
+
+static inline uint
+rx_cmsg_parse( struct msghdr * hdr,
+               uint *          gso_sz ) {
+  long daddr = -1;
+  struct cmsghdr * cmsg = CMSG_FIRSTHDR( hdr );
+  while( FD_LIKELY( cmsg ) ) {
+    if( FD_LIKELY( (cmsg->cmsg_level==IPPROTO_IP) &
+                   (cmsg->cmsg_type ==IP_PKTINFO) ) ) {
+      struct in_pktinfo const * pi = (struct in_pktinfo const *)CMSG_DATA( cmsg );
+      daddr = pi->ipi_addr.s_addr;
+    } else if( (cmsg->cmsg_level==SOL_UDP) &
+               (cmsg->cmsg_type ==UDP_GRO) ) {
+      *gso_sz = (uint)FD_LOAD( int, CMSG_DATA( cmsg ) );
+    }
+    cmsg = CMSG_NXTHDR( hdr, cmsg );
+  }
+  if( FD_UNLIKELY( daddr<0L ) ) {
+    /* unreachable because IP_PKTINFO was set */
+    FD_LOG_ERR(( "Missing IP_PKTINFO on incoming packet" ));
+  }
+  return (uint)(ulong)daddr;
+}
+
+/* rx_publish completes the frame of a received packet and publishes
+   it.  The UDP payload must already be at offset hdr_sz of a chunk of
+   the RX link of sock_idx. */
+
+static inline void
+rx_publish( fd_sock_tile_t *           ctx,
+            fd_stem_context_t *        stem,
+            uint                       sock_idx,
+            ushort                     proto,
+            struct sockaddr_in const * sa,
+            uint                       daddr,
+            uchar *                    payload,
+            ulong                      payload_sz,
+            ulong                      tspub ) {
+  ulong  hdr_sz   = sizeof(fd_eth_hdr_t) + sizeof(fd_ip4_hdr_t) + sizeof(fd_udp_hdr_t);
+  uchar  rx_link  = ctx->link_rx_map[ sock_idx ];
+  ushort dport    = ctx->rx_sock_port[ sock_idx ];
+  ulong  frame_sz = payload_sz + hdr_sz;
+  ctx->metrics.rx_bytes_total += frame_sz;
+
+  fd_eth_hdr_t * eth_hdr    = (fd_eth_hdr_t *)( payload-42UL );
+  fd_ip4_hdr_t * ip_hdr     = (fd_ip4_hdr_t *)( payload-28UL );
+  fd_udp_hdr_t * udp_hdr    = (fd_udp_hdr_t *)( payload- 8UL );
+  memset( eth_hdr->dst, 0, 6 );
+  memset( eth_hdr->src, 0, 6 );
+  eth_hdr->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
+  *ip_hdr = (fd_ip4_hdr_t) {
+    .verihl      = FD_IP4_VERIHL( 4, 5 ),
+    .net_tot_len = fd_ushort_bswap( (ushort)( payload_sz+28UL ) ),
+    .ttl         = 1,
+    .protocol    = FD_IP4_HDR_PROTOCOL_UDP,
+  };
+  memcpy( ip_hdr->saddr_c, &sa->sin_addr.s_addr, 4 );
+  memcpy( ip_hdr->daddr_c, &daddr,               4 );
+  *udp_hdr = (fd_udp_hdr_t) {
+    .net_sport = sa->sin_port,
+    .net_dport = (ushort)fd_ushort_bswap( (ushort)dport ),
+    .net_len   = (ushort)fd_ushort_bswap( (ushort)( payload_sz+8UL ) ),
+    .check     = 0
+  };
+
+  ctx->metrics.rx_pkt_cnt++;
+  ulong chunk = fd_laddr_to_chunk( ctx->link_rx[ rx_link ].base, eth_hdr );
+  ulong sig   = fd_disco_netmux_sig( sa->sin_addr.s_addr, fd_ushort_bswap( sa->sin_port ), sa->sin_addr.s_addr, proto, hdr_sz );
+
+  /* When a message arrives on the repair intake port, it is sent
+     to the shred tile, unless it is a ping message (identified by
+     the frame size), then it is sent to the repair tile.
+     The repair tile does not own any sockets, so we look up the
+     net_repair link directly.*/
+  if( FD_UNLIKELY( sock_idx==ctx->repair_shred_sock_idx && frame_sz==REPAIR_PING_SZ ) ) {
+    fd_sock_link_rx_t * repair_link = ctx->link_rx + ctx->repair_rx;
+    uchar * repair_buf = fd_chunk_to_laddr( repair_link->base, repair_link->chunk );
+    memcpy( repair_buf, eth_hdr, frame_sz );
+    fd_stem_publish( stem, ctx->repair_rx, sig, repair_link->chunk, frame_sz, 0UL, 0UL, tspub );
+    repair_link->chunk = fd_dcache_compact_next( repair_link->chunk, FD_NET_MTU, repair_link->chunk0, repair_link->wmark );
+  } else {
+    fd_stem_publish( stem, rx_link, sig, chunk, frame_sz, 0UL, 0UL, tspub );
+  }
+}
+
 /* poll_rx_socket does one recvmmsg batch receive on the given socket
    index.  Returns the number of packets returned by recvmmsg. */
 
@@ -322,7 +476,6 @@ poll_rx_socket( fd_sock_tile_t *    ctx,
   ulong  hdr_sz      = sizeof(fd_eth_hdr_t) + sizeof(fd_ip4_hdr_t) + sizeof(fd_udp_hdr_t);
   ulong  payload_max = FD_NET_MTU-hdr_sz;
   uchar  rx_link     = ctx->link_rx_map[ sock_idx ];
-  ushort dport       = ctx->rx_sock_port[ sock_idx ];
 
   fd_sock_link_rx_t * link = ctx->link_rx + rx_link;
   void * const base       = link->base;
@@ -364,83 +517,133 @@ poll_rx_socket( fd_sock_tile_t *    ctx,
      the chunk indexes for the next poll_rx_socket call.
      Guaranteed to be set since msg_cnt>0. */
   ulong last_chunk;
+  ulong tspub = fd_frag_meta_ts_comp( ts );
 
   for( ulong j=0; j<(ulong)msg_cnt; j++ ) {
     uchar * payload         = ctx->batch_iov[ j ].iov_base;
     ulong   payload_sz      = ctx->batch_msg[ j ].msg_len;
     struct sockaddr_in * sa = ctx->batch_msg[ j ].msg_hdr.msg_name;
-    ulong frame_sz          = payload_sz + hdr_sz;
-    ctx->metrics.rx_bytes_total += frame_sz;
     if( FD_UNLIKELY( sa->sin_family!=AF_INET ) ) {
       /* unreachable */
       FD_LOG_ERR(( "Received packet with unexpected sin_family %i", sa->sin_family ));
     }
 
-    long daddr = -1;
-    struct cmsghdr * cmsg = CMSG_FIRSTHDR( &ctx->batch_msg[ j ].msg_hdr );
-    if( FD_LIKELY( cmsg ) ) {
-      do {
-        if( FD_LIKELY( (cmsg->cmsg_level==IPPROTO_IP) &
-                       (cmsg->cmsg_type ==IP_PKTINFO) ) ) {
-          struct in_pktinfo const * pi = (struct in_pktinfo const *)CMSG_DATA( cmsg );
-          daddr = pi->ipi_addr.s_addr;
-        }
-        cmsg = CMSG_NXTHDR( &ctx->batch_msg[ j ].msg_hdr, cmsg );
-      } while( FD_UNLIKELY( cmsg ) ); /* optimize for 1 cmsg */
+    uint gso_sz = 0U;
+    uint daddr  = rx_cmsg_parse( &ctx->batch_msg[ j ].msg_hdr, &gso_sz );
+
+    rx_publish( ctx, stem, sock_idx, proto, sa, daddr, payload, payload_sz, tspub );
+
+    last_chunk = fd_laddr_to_chunk( base, payload-hdr_sz );
+  }
+
+  /* Rewind the chunk index to the first free index. */
+  link->chunk = fd_dcache_compact_next( last_chunk, FD_NET_MTU, chunk0, wmark );
+  return (ulong)msg_cnt;
+}
+
+/* poll_rx_socket_gro does one recvmmsg batch receive on a UDP_GRO
+   socket.  Coalesced datagrams cannot be received in place into MTU
+   sized dcache chunks, so they land in the GRO buffers and are split
+   into frags by drain_rx_gro. */
+
+static void
+poll_rx_socket_gro( fd_sock_tile_t * ctx,
+                    uint             sock_idx,
+                    int              sock_fd ) {
+  uchar * cmsg_next = ctx->gro_cmsg;
+  for( ulong j=0UL; j<FD_SOCK_GRO_BATCH; j++ ) {
+    ctx->gro_iov[ j ].iov_base = ctx->gro_buf + j*FD_SOCK_GRO_BUF_SZ;
+    ctx->gro_iov[ j ].iov_len  = FD_SOCK_GRO_BUF_SZ;
+    ctx->gro_msg[ j ].msg_hdr  = (struct msghdr) {
+      .msg_iov        = ctx->gro_iov+j,
+      .msg_iovlen     = 1,
+      .msg_name       = ctx->gro_sa+j,
+      .msg_namelen    = sizeof(struct sockaddr_in),
+      .msg_control    = cmsg_next,
+      .msg_controllen = FD_SOCK_CMSG_MAX,
+    };
+    cmsg_next += FD_SOCK_CMSG_MAX;
+  }
+
+  int msg_cnt = recvmmsg( sock_fd, ctx->gro_msg, FD_SOCK_GRO_BATCH, MSG_DONTWAIT, NULL );
+  if( FD_UNLIKELY( msg_cnt<0 ) ) {
+    if( FD_LIKELY( errno==EAGAIN ) ) return;
+    /* unreachable if socket is in a valid state */
+    FD_LOG_ERR(( "recvmmsg failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+  ctx->metrics.sys_recvmmsg_cnt++;
+
+  ctx->gro_pend.sock_idx = sock_idx;
+  ctx->gro_pend.msg_idx  = 0U;
+  ctx->gro_pend.msg_cnt  = (uint)msg_cnt;
+  ctx->gro_pend.off      = 0U;
+  ctx->gro_pend.ts       = fd_tickcount();
+}
+
+/* drain_rx_gro splits pending GRO datagrams back into one frag per
+   packet and publishes them, at most STEM_BURST per call.  Returns the
+   number of frags published. */
+
+static ulong
+drain_rx_gro( fd_sock_tile_t *    ctx,
+              fd_stem_context_t * stem ) {
+  ulong hdr_sz      = sizeof(fd_eth_hdr_t) + sizeof(fd_ip4_hdr_t) + sizeof(fd_udp_hdr_t);
+  ulong payload_max = FD_NET_MTU-hdr_sz;
+
+  uint                sock_idx = ctx->gro_pend.sock_idx;
+  ushort              proto    = ctx->proto_id[ sock_idx ];
+  fd_sock_link_rx_t * link     = ctx->link_rx + ctx->link_rx_map[ sock_idx ];
+  ulong               tspub    = fd_frag_meta_ts_comp( ctx->gro_pend.ts );
+
+  ulong pkt_cnt = 0UL;
+  while( ctx->gro_pend.msg_idx<ctx->gro_pend.msg_cnt && pkt_cnt<STEM_BURST ) {
+    struct mmsghdr *     msg      = ctx->gro_msg + ctx->gro_pend.msg_idx;
+    struct sockaddr_in * sa       = msg->msg_hdr.msg_name;
+    uchar const *        dgram    = msg->msg_hdr.msg_iov->iov_base;
+    ulong                dgram_sz = msg->msg_len;
+    if( FD_UNLIKELY( sa->sin_family!=AF_INET ) ) {
+      /* unreachable */
+      FD_LOG_ERR(( "Received packet with unexpected sin_family %i", sa->sin_family ));
     }
-    if( FD_UNLIKELY( daddr<0L ) ) {
-      /* unreachable because IP_PKTINFO was set */
-      FD_LOG_ERR(( "Missing IP_PKTINFO on incoming packet" ));
+
+    uint gso_sz = (uint)dgram_sz;
+    uint daddr  = rx_cmsg_parse( &msg->msg_hdr, &gso_sz );
+    if( !gso_sz ) gso_sz = (uint)dgram_sz;
+    if( ctx->gro_pend.off==0U && dgram_sz>gso_sz ) {
+      ctx->metrics.rx_gro_dgram_cnt++;
+      ctx->metrics.rx_gro_pkt_cnt += (dgram_sz+gso_sz-1UL)/gso_sz;
     }
 
-    fd_eth_hdr_t * eth_hdr    = (fd_eth_hdr_t *)( payload-42UL );
-    fd_ip4_hdr_t * ip_hdr     = (fd_ip4_hdr_t *)( payload-28UL );
-    fd_udp_hdr_t * udp_hdr    = (fd_udp_hdr_t *)( payload- 8UL );
-    memset( eth_hdr->dst, 0, 6 );
-    memset( eth_hdr->src, 0, 6 );
-    eth_hdr->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
-    *ip_hdr = (fd_ip4_hdr_t) {
-      .verihl      = FD_IP4_VERIHL( 4, 5 ),
-      .net_tot_len = fd_ushort_bswap( (ushort)( payload_sz+28UL ) ),
-      .ttl         = 1,
-      .protocol    = FD_IP4_HDR_PROTOCOL_UDP,
-    };
-    uint daddr_ = (uint)(ulong)daddr;
-    memcpy( ip_hdr->saddr_c, &sa->sin_addr.s_addr, 4 );
-    memcpy( ip_hdr->daddr_c, &daddr_,              4 );
-    *udp_hdr = (fd_udp_hdr_t) {
-      .net_sport = sa->sin_port,
-      .net_dport = (ushort)fd_ushort_bswap( (ushort)dport ),
-      .net_len   = (ushort)fd_ushort_bswap( (ushort)( payload_sz+8UL ) ),
-      .check     = 0
-    };
+    /* A zero size datagram still yields one (empty) frag.  Segments
+       that do not fit a frag are dropped rather than truncated. */
+    ulong off = ctx->gro_pend.off;
+    do {
+      ulong seg_sz = fd_ulong_min( gso_sz, dgram_sz-off );
+      if( FD_UNLIKELY( seg_sz>payload_max ) ) {
+        ctx->metrics.rx_gro_oversz_cnt++;
+      } else {
+        uchar * payload = (uchar *)fd_chunk_to_laddr( link->base, link->chunk ) + hdr_sz;
+        fd_memcpy( payload, dgram+off, seg_sz );
+        rx_publish( ctx, stem, sock_idx, proto, sa, daddr, payload, seg_sz, tspub );
+        link->chunk = fd_dcache_compact_next( link->chunk, FD_NET_MTU, link->chunk0, link->wmark );
+        pkt_cnt++;
+      }
+      off += seg_sz;
+    } while( off<dgram_sz && pkt_cnt<STEM_BURST );
 
-    ctx->metrics.rx_pkt_cnt++;
-    ulong chunk = fd_laddr_to_chunk( base, eth_hdr );
-    ulong sig   = fd_disco_netmux_sig( sa->sin_addr.s_addr, fd_ushort_bswap( sa->sin_port ), sa->sin_addr.s_addr, proto, hdr_sz );
-    ulong tspub = fd_frag_meta_ts_comp( ts );
-
-    /* When a message arrives on the repair intake port, it is sent
-       to the shred tile, unless it is a ping message (identified by
-       the frame size), then it is sent to the repair tile.
-       The repair tile does not own any sockets, so we look up the
-       net_repair link directly.*/
-    if( FD_UNLIKELY( sock_idx==ctx->repair_shred_sock_idx && frame_sz==REPAIR_PING_SZ ) ) {
-      fd_sock_link_rx_t * repair_link = ctx->link_rx + ctx->repair_rx;
-      uchar * repair_buf = fd_chunk_to_laddr( repair_link->base, repair_link->chunk );
-      memcpy( repair_buf, eth_hdr, frame_sz );
-      fd_stem_publish( stem, ctx->repair_rx, sig, repair_link->chunk, frame_sz, 0UL, 0UL, tspub );
-      repair_link->chunk = fd_dcache_compact_next( repair_link->chunk, FD_NET_MTU, repair_link->chunk0, repair_link->wmark );
+    if( off>=dgram_sz ) {
+      ctx->gro_pend.msg_idx++;
+      ctx->gro_pend.off = 0U;
     } else {
-      fd_stem_publish( stem, rx_link, sig, chunk, frame_sz, 0UL, 0UL, tspub );
+      ctx->gro_pend.off = (uint)off;
     }
-
-    last_chunk = chunk;
   }
+  return pkt_cnt;
+}
 
-  /* Rewind the chunk index to the first free index. */
-  link->chunk = fd_dcache_compact_next( last_chunk, FD_NET_MTU, chunk0, wmark );
-  return (ulong)msg_cnt;
+static inline int
+rx_gro_pending( fd_sock_tile_t const * ctx ) {
+  return ctx->gro_pend.msg_idx<ctx->gro_pend.msg_cnt;
 }
 
 static ulong
@@ -451,37 +654,80 @@ poll_rx( fd_sock_tile_t *    ctx,
     FD_LOG_ERR(( "Batch is not clean" ));
   }
   ctx->tx_idle_cnt = 0; /* restart TX polling */
-  if( FD_UNLIKELY( fd_syscall_poll( ctx->pollfd, ctx->sock_cnt, 0 )<0 ) ) {
-    FD_LOG_ERR(( "fd_syscall_poll failed (%i-%s)", errno, fd_io_strerror( errno ) ));
-  }
-  for( uint j=0UL; j<ctx->sock_cnt; j++ ) {
-    if( ctx->pollfd[ j ].revents & (POLLIN|POLLERR) ) {
-      pkt_cnt += poll_rx_socket(
-        ctx,
-        stem,
-        j,
-        ctx->pollfd[ j ].fd,
-        ctx->proto_id[ j ]
-      );
+  if( FD_UNLIKELY( rx_gro_pending( ctx ) ) ) {
+    pkt_cnt = drain_rx_gro( ctx, stem );
+  } else {
+    if( FD_UNLIKELY( fd_syscall_poll( ctx->pollfd, ctx->sock_cnt, 0 )<0 ) ) {
+      FD_LOG_ERR(( "fd_syscall_poll failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    }
+    for( uint j=0UL; j<ctx->sock_cnt; j++ ) {
+      if( ctx->pollfd[ j ].revents & (POLLIN|POLLERR) ) {
+        if( ctx->rx_gro[ j ] ) {
+          /* Left for the next poll if the GRO buffers are in use */
+          if( FD_LIKELY( !rx_gro_pending( ctx ) ) ) {
+            poll_rx_socket_gro( ctx, j, ctx->pollfd[ j ].fd );
+            pkt_cnt += drain_rx_gro( ctx, stem );
+          }
+        } else {
+          pkt_cnt += poll_rx_socket(
+            ctx,
+            stem,
+            j,
+            ctx->pollfd[ j ].fd,
+            ctx->proto_id[ j ]
+          );
+        }
+      }
+      ctx->pollfd[ j ].revents = 0;
     }
-    ctx->pollfd[ j ].revents = 0;
   }
+  /* Keep draining on the next credit instead of waiting for TX to go
+     idle again */
+  if( FD_UNLIKELY( rx_gro_pending( ctx ) ) ) ctx->tx_idle_cnt = TX_IDLE_RX_POLL_CNT;
   return pkt_cnt;
 }
 
 /* TX PATH (tango->socket) ********************************************/
 
+/* tx_sent accounts for successfully sent entries [msg0,msg1). */
+
+static inline void
+tx_sent( fd_sock_tile_t * ctx,
+         ulong            msg0,
+         ulong            msg1 ) {
+  for( ulong j=msg0; j<msg1; j++ ) {
+    ulong seg_cnt = ctx->batch_meta[ j ].seg_cnt;
+    ctx->metrics.tx_pkt_cnt += seg_cnt;
+    if( seg_cnt>1UL ) {
+      ctx->metrics.tx_gso_dgram_cnt++;
+      ctx->metrics.tx_gso_pkt_cnt += seg_cnt;
+    }
+  }
+}
+
+/* tx_send_run sends the entries [msg0,msg1) of the TX batch, which all
+   target the same socket. */
+
 static void
-flush_tx_batch( fd_sock_tile_t * ctx ) {
-  ulong batch_cnt = ctx->batch_cnt;
-  for( int j = 0; j < (int)batch_cnt; /* incremented in loop */ ) {
-    int remain   = (int)batch_cnt - j;
-    int send_cnt = sendmmsg( ctx->tx_sock, ctx->batch_msg + j, (uint)remain, MSG_DONTWAIT );
+tx_send_run( fd_sock_tile_t * ctx,
+             int              fd,
+             ulong            msg0,
+             ulong            msg1 ) {
+  for( ulong j=msg0; j<msg1; /* incremented in loop */ ) {
+    int remain   = (int)( msg1-j );
+    int send_cnt = sendmmsg( fd, ctx->batch_msg + j, (uint)remain, MSG_DONTWAIT );
     if( send_cnt>=0 ) {
       ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCKET_ERROR_V_NO_ERROR_IDX ]++;
     }
+
+    /* add the successful count */
+    ulong sent_cnt = (ulong)fd_int_max( send_cnt, 0 );
+    tx_sent( ctx, j, j+sent_cnt );
+    j += sent_cnt;
+
     if( FD_UNLIKELY( send_cnt < remain ) ) {
-      ctx->metrics.tx_drop_cnt++;
+      ulong seg_cnt = ctx->batch_meta[ j ].seg_cnt;
+      ctx->metrics.tx_drop_cnt += seg_cnt;
       if( FD_UNLIKELY( send_cnt < 0 ) ) {
         switch( errno ) {
         case EAGAIN:
@@ -502,30 +748,80 @@ flush_tx_batch( fd_sock_tile_t * ctx ) {
           break;
         default:
           ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCKET_ERROR_V_OTHER_IDX ]++;
+          /* The egress device cannot segment (e.g. no checksum
+             offload).  Stop coalescing, single packets still go
+             through the UDP sockets. */
+          if( FD_UNLIKELY( seg_cnt>1UL && ( errno==EIO || errno==EINVAL ) && ctx->tx_gso ) ) {
+            FD_LOG_WARNING(( "sendmmsg with UDP_SEGMENT failed (%i-%s), disabling UDP GSO", errno, fd_io_strerror( errno ) ));
+            ctx->tx_gso = 0;
+            break;
+          }
           /* log with NOTICE, since flushing has a significant negative performance impact */
           FD_LOG_NOTICE(( "sendmmsg failed (%i-%s)", errno, fd_io_strerror( errno ) ));
         }
-
-        /* first message failed, so skip failing message and continue */
-        j++;
-      } else {
-        /* send_cnt succeeded, so skip those and also the failing message */
-        j += send_cnt + 1;
-
-        /* add the successful count */
-        ctx->metrics.tx_pkt_cnt += (ulong)send_cnt;
       }
 
-      continue;
+      /* skip the failing message and continue */
+      j++;
     }
+  }
+}
 
-    /* send_cnt == batch_cnt, so we sent everything */
-    ctx->metrics.tx_pkt_cnt += (ulong)send_cnt;
-    break;
+static void
+flush_tx_batch( fd_sock_tile_t * ctx ) {
+  ulong msg_cnt = ctx->batch_msg_cnt;
+  for( ulong j=0UL; j<msg_cnt; /* incremented in loop */ ) {
+    int   fd = ctx->batch_meta[ j ].fd;
+    ulong k  = j+1UL;
+    while( k<msg_cnt && ctx->batch_meta[ k ].fd==fd ) k++;
+    tx_send_run( ctx, fd, j, k );
+    j = k;
   }
 
-  ctx->tx_ptr = ctx->tx_scratch0;
-  ctx->batch_cnt = 0;
+  ctx->tx_ptr        = ctx->tx_scratch0;
+  ctx->batch_cnt     = 0;
+  ctx->batch_msg_cnt = 0;
+}
+
+/* tx_gso_sock returns the file descriptor of the bound UDP socket with
+   the given source port (host byte order), or -1 if there is none. */
+
+static inline int
+tx_gso_sock( fd_sock_tile_t const * ctx,
+             ushort                 sport ) {
+  for( uint j=0U; j<ctx->sock_cnt; j++ ) {
+    if( ctx->rx_sock_port[ j ]==sport ) return ctx->pollfd[ j ].fd;
+  }
+  return -1;
+}
+
+/* tx_gso_can_merge returns 1 if a packet can be appended as another
+   segment to the last entry of the TX batch.  UDP_SEGMENT requires all
+   segments but the last to have the same size, so an entry is closed
+   by the first packet that is shorter than the first one. */
+
+static inline int
+tx_gso_can_merge( fd_sock_tile_t const * ctx,
+                  int                    fd,
+                  uint                   daddr,
+                  ushort                 net_dport,
+                  uint                   saddr,
+                  ulong                  payload_sz ) {
+  if( !ctx->batch_msg_cnt ) return 0;
+  ulong                      prev = ctx->batch_msg_cnt-1UL;
+  fd_sock_tx_meta_t const *  meta = ctx->batch_meta + prev;
+  struct sockaddr_in const * sa   = ctx->batch_sa   + prev;
+  struct cmsghdr const *     cmsg = (void const *)( (ulong)ctx->batch_cmsg + prev*FD_SOCK_CMSG_MAX );
+  struct in_pktinfo const *  pi   = (struct in_pktinfo const *)CMSG_DATA( cmsg );
+  return ( meta->fd==fd                                  ) &
+         ( meta->seg_cnt<FD_SOCK_GSO_SEG_MAX             ) &
+         ( payload_sz>0UL                                ) &
+         ( payload_sz<=meta->gso_sz                      ) &
+         ( meta->last_sz==meta->gso_sz                   ) &
+         ( meta->tot_sz+payload_sz<=FD_SOCK_GSO_SZ_MAX   ) &
+         ( sa->sin_addr.s_addr==daddr                    ) &
+         ( sa->sin_port==net_dport                       ) &
+         ( pi->ipi_spec_dst.s_addr==saddr                );
 }
 
 /* before_frag is called when a new frag has been detected.  The sock
@@ -560,6 +856,7 @@ during_frag( fd_sock_tile_t * ctx,
   }
 
   ctx->parsed.invalid = 0;
+  ctx->parsed.merge   = 0;
 
   ulong const hdr_min = sizeof(fd_eth_hdr_t)+sizeof(fd_ip4_hdr_t)+sizeof(fd_udp_hdr_t);
   if( FD_UNLIKELY( sz<hdr_min ) ) {
@@ -594,20 +891,44 @@ during_frag( fd_sock_tile_t * ctx,
   ulong msg_sz = sizeof(fd_udp_hdr_t) + payload_sz;
 
   ulong batch_idx = ctx->batch_cnt;
+  ulong msg_idx   = ctx->batch_msg_cnt;
   FD_DCHECK_CRIT( batch_idx<STEM_BURST, "flow control error" );
-  struct mmsghdr *     msg  = ctx->batch_msg + batch_idx;
-  struct sockaddr_in * sa   = ctx->batch_sa  + batch_idx;
-  struct iovec   *     iov  = ctx->batch_iov + batch_idx;
-  struct cmsghdr *     cmsg = (void *)( (ulong)ctx->batch_cmsg + batch_idx*FD_SOCK_CMSG_MAX );
-  uchar *              buf  = ctx->tx_ptr;
-
-  *iov = (struct iovec) {
-    .iov_base = buf,
-    .iov_len  = msg_sz,
-  };
+  struct iovec * iov = ctx->batch_iov + batch_idx;
+  uchar *        buf = ctx->tx_ptr;
+
+  memcpy( buf, udp_hdr, sizeof(fd_udp_hdr_t) );
+  fd_memcpy( buf+sizeof(fd_udp_hdr_t), payload, payload_sz );
+  ctx->metrics.tx_bytes_total += sz;
+  ctx->parsed.payload_sz = (uint)payload_sz;
+
+  uint daddr = FD_LOAD( uint, ip_hdr->daddr_c );
+  uint saddr = fd_uint_if( !!ip_hdr->saddr, ip_hdr->saddr, ctx->bind_address );
+  int  fd    = ctx->tx_gso ? tx_gso_sock( ctx, fd_ushort_bswap( udp_hdr->net_sport ) ) : -1;
+  if( fd<0 ) {
+    /* Raw socket, sends the caller's UDP header */
+    fd   = ctx->tx_sock;
+    *iov = (struct iovec) {
+      .iov_base = buf,
+      .iov_len  = msg_sz,
+    };
+  } else {
+    /* Bound UDP socket, the kernel writes the UDP header */
+    *iov = (struct iovec) {
+      .iov_base = buf+sizeof(fd_udp_hdr_t),
+      .iov_len  = payload_sz,
+    };
+    ctx->parsed.merge = tx_gso_can_merge( ctx, fd, daddr, udp_hdr->net_dport, saddr, payload_sz );
+    if( ctx->parsed.merge ) return;
+  }
+
+  struct mmsghdr *     msg  = ctx->batch_msg  + msg_idx;
+  struct sockaddr_in * sa   = ctx->batch_sa   + msg_idx;
+  fd_sock_tx_meta_t *  meta = ctx->batch_meta + msg_idx;
+  struct cmsghdr *     cmsg = (void *)( (ulong)ctx->batch_cmsg + msg_idx*FD_SOCK_CMSG_MAX );
+
   sa->sin_family      = AF_INET;
-  sa->sin_addr.s_addr = FD_LOAD( uint, ip_hdr->daddr_c );
-  sa->sin_port        = 0; /* ignored */
+  sa->sin_addr.s_addr = daddr;
+  sa->sin_port        = udp_hdr->net_dport; /* ignored by the raw socket */
 
   cmsg->cmsg_level = IPPROTO_IP;
   cmsg->cmsg_type  = IP_PKTINFO;
@@ -615,7 +936,7 @@ during_frag( fd_sock_tile_t * ctx,
   struct in_pktinfo * pi = (struct in_pktinfo *)CMSG_DATA( cmsg );
   pi->ipi_ifindex         = 0;
   pi->ipi_addr.s_addr     = 0;
-  pi->ipi_spec_dst.s_addr = fd_uint_if( !!ip_hdr->saddr, ip_hdr->saddr, ctx->bind_address );
+  pi->ipi_spec_dst.s_addr = saddr;
 
   *msg = (struct mmsghdr) {
     .msg_hdr = {
@@ -628,9 +949,13 @@ during_frag( fd_sock_tile_t * ctx,
     }
   };
 
-  memcpy( buf, udp_hdr, sizeof(fd_udp_hdr_t) );
-  fd_memcpy( buf+sizeof(fd_udp_hdr_t), payload, payload_sz );
-  ctx->metrics.tx_bytes_total += sz;
+  *meta = (fd_sock_tx_meta_t) {
+    .fd      = fd,
+    .seg_cnt = 1,
+    .gso_sz  = (ushort)payload_sz,
+    .last_sz = (ushort)payload_sz,
+    .tot_sz  = (uint)payload_sz
+  };
 }
 
 /* after_frag is called when a frag was copied into a sendmmsg buffer. */
@@ -660,6 +985,28 @@ after_frag( fd_sock_tile_t *    ctx,
     }
   }
 
+  if( ctx->parsed.merge ) {
+    /* Append the packet as another segment of the last entry */
+    ulong               prev    = ctx->batch_msg_cnt-1UL;
+    struct msghdr *     hdr     = &ctx->batch_msg[ prev ].msg_hdr;
+    fd_sock_tx_meta_t * meta    = ctx->batch_meta + prev;
+    ushort              payload = (ushort)ctx->parsed.payload_sz;
+    hdr->msg_iovlen++;
+    meta->seg_cnt++;
+    meta->last_sz  = payload;
+    meta->tot_sz  += payload;
+    if( meta->seg_cnt==2 ) {
+      struct cmsghdr * seg = (void *)( (ulong)hdr->msg_control + CMSG_SPACE( sizeof(struct in_pktinfo) ) );
+      seg->cmsg_level = SOL_UDP;
+      seg->cmsg_type  = UDP_SEGMENT;
+      seg->cmsg_len   = CMSG_LEN( sizeof(ushort) );
+      FD_STORE( ushort, CMSG_DATA( seg ), meta->gso_sz );
+      hdr->msg_controllen = CMSG_SPACE( sizeof(struct in_pktinfo) ) + CMSG_SPACE( sizeof(ushort) );
+    }
+  } else {
+    ctx->batch_msg_cnt++;
+  }
+
   ctx->tx_idle_cnt = 0;
   ctx->batch_cnt++;
   /* Technically leaves a gap.  sz is always larger than the payload
@@ -681,7 +1028,7 @@ after_credit( fd_sock_tile_t *    ctx,
               fd_stem_context_t * stem,
               int *               poll_in FD_PARAM_UNUSED,
               int *               charge_busy ) {
-  if( ctx->tx_idle_cnt > 512 ) {
+  if( ctx->tx_idle_cnt > TX_IDLE_RX_POLL_CNT ) {
     if( ctx->batch_cnt ) {
       flush_tx_batch( ctx );
     }
@@ -700,6 +1047,11 @@ metrics_write( fd_sock_tile_t * ctx ) {
   FD_MCNT_SET( SOCK, PKT_TX_FAILED,          ctx->metrics.tx_drop_cnt          );
   FD_MCNT_SET( SOCK, PKT_TX_BYTES,            ctx->metrics.tx_bytes_total       );
   FD_MCNT_SET( SOCK, PKT_RX_BYTES,            ctx->metrics.rx_bytes_total       );
+  FD_MCNT_SET( SOCK, DGRAM_RX_GRO,            ctx->metrics.rx_gro_dgram_cnt     );
+  FD_MCNT_SET( SOCK, PKT_RX_GRO,              ctx->metrics.rx_gro_pkt_cnt       );
+  FD_MCNT_SET( SOCK, PKT_RX_GRO_OVERSIZE,     ctx->metrics.rx_gro_oversz_cnt    );
+  FD_MCNT_SET( SOCK, DGRAM_TX_GSO,            ctx->metrics.tx_gso_dgram_cnt     );
+  FD_MCNT_SET( SOCK, PKT_TX_GSO,              ctx->metrics.tx_gso_pkt_cnt       );
 }
 
 static ulong
@@ -23,6 +23,21 @@
 
 #define MAX_NET_OUTS (7UL)
 
+/* FD_SOCK_GSO_SEG_MAX is the max number of packets coalesced into one
+   UDP_SEGMENT sendmmsg entry (UDP_MAX_SEGMENTS of older kernels).
+   FD_SOCK_GSO_SZ_MAX is the max UDP payload of such an entry. */
+
+#define FD_SOCK_GSO_SEG_MAX (64UL)
+#define FD_SOCK_GSO_SZ_MAX  (65507UL)
+
+/* FD_SOCK_GRO_BATCH is the recvmmsg batch depth of UDP_GRO sockets.
+   Each entry may carry up to 64 KiB of coalesced packets, which are
+   copied out one frag at a time, so a much smaller batch than
+   STEM_BURST already covers many packets. */
+
+#define FD_SOCK_GRO_BATCH  (16UL)
+#define FD_SOCK_GRO_BUF_SZ (65536UL)
+
 /* Local metrics.  Periodically copied to the metric_in shm region. */
 
 struct fd_sock_tile_metrics {
@@ -33,6 +48,11 @@ struct fd_sock_tile_metrics {
   ulong tx_drop_cnt;
   ulong rx_bytes_total;
   ulong tx_bytes_total;
+  ulong rx_gro_dgram_cnt;  /* received datagrams that coalesced >1 packet */
+  ulong rx_gro_pkt_cnt;    /* packets split out of such datagrams */
+  ulong rx_gro_oversz_cnt; /* split out packets dropped for exceeding the MTU */
+  ulong tx_gso_dgram_cnt;  /* sent datagrams that coalesced >1 packet */
+  ulong tx_gso_pkt_cnt;    /* packets sent inside such datagrams */
 };
 
 typedef struct fd_sock_tile_metrics fd_sock_tile_metrics_t;
@@ -56,24 +76,65 @@ struct fd_sock_link_rx {
 
 typedef struct fd_sock_link_rx fd_sock_link_rx_t;
 
+/* fd_sock_tx_meta_t describes one sendmmsg entry of the TX batch.  An
+   entry sent through a bound UDP socket may carry several packets of
+   the same flow, segmented by the kernel (UDP_SEGMENT). */
+
+struct fd_sock_tx_meta {
+  int    fd;      /* socket to send the entry on */
+  ushort seg_cnt; /* number of packets (iovecs) */
+  ushort gso_sz;  /* payload size of the first packet */
+  ushort last_sz; /* payload size of the last packet */
+  uint   tot_sz;  /* total UDP payload size */
+};
+
+typedef struct fd_sock_tx_meta fd_sock_tx_meta_t;
+
 struct fd_sock_tile {
   /* RX SOCK_DGRAM sockets */
   struct pollfd pollfd[ FD_SOCK_TILE_MAX_SOCKETS ];
   uint          sock_cnt;
   uchar         proto_id[ FD_SOCK_TILE_MAX_SOCKETS ];
+  uchar         rx_gro  [ FD_SOCK_TILE_MAX_SOCKETS ]; /* UDP_GRO enabled */
 
   /* TX SOCK_RAW socket */
   int  tx_sock;
   uint tx_idle_cnt;
   uint bind_address;
 
+  /* If set, packets whose source port belongs to one of the RX sockets
+     are sent through that UDP socket instead of tx_sock, and
+     consecutive packets of the same flow are coalesced into a single
+     UDP_SEGMENT (GSO) sendmmsg entry. */
+  int tx_gso;
+
   /* RX/TX batches
-     FIXME transpose arrays for better cache locality? */
-  ulong                batch_cnt; /* <=STEM_BURST */
+     FIXME transpose arrays for better cache locality?
+     batch_iov is indexed by packet, all other TX arrays by sendmmsg
+     entry.  The iovecs of an entry are contiguous. */
+  ulong                batch_cnt;     /* packets, <=STEM_BURST */
+  ulong                batch_msg_cnt; /* sendmmsg entries, <=batch_cnt */
   struct iovec *       batch_iov;
   void *               batch_cmsg;
   struct sockaddr_in * batch_sa;
   struct mmsghdr *     batch_msg;
+  fd_sock_tx_meta_t *  batch_meta;
+
+  /* UDP_GRO RX batch.  A batch received on one socket may hold more
+     packets than fit in one burst, so it is drained across several
+     poll_rx calls.  No socket is read while packets are pending. */
+  struct iovec *       gro_iov;
+  void *               gro_cmsg;
+  struct sockaddr_in * gro_sa;
+  struct mmsghdr *     gro_msg;
+  uchar *              gro_buf;
+  struct {
+    uint sock_idx;
+    uint msg_idx;  /* next entry to drain */
+    uint msg_cnt;  /* entries received, msg_idx==msg_cnt if idle */
+    uint off;      /* byte offset of the next packet in msg_idx */
+    long ts;
+  } gro_pend;
 
   /* RX links */
   ushort            rx_sock_port[ FD_SOCK_TILE_MAX_SOCKETS ];
@@ -96,6 +157,8 @@ struct fd_sock_tile {
     int  invalid; /* set if the frag failed validation in during_frag */
     uint ip_version;
     uint ip_protocol;
+    int  merge;   /* set if the frag extends the last sendmmsg entry */
+    uint payload_sz;
   } parsed;
 
   fd_sock_tile_metrics_t metrics;
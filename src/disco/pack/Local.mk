@@ -1,8 +1,9 @@
 ifdef FD_HAS_HOSTED
 ifdef FD_HAS_DOUBLE
-$(call add-hdrs,fd_pack.h fd_est_tbl.h fd_compute_budget_program.h fd_microblock.h fd_pack_rebate_sum.h)
+$(call add-hdrs,fd_pack.h fd_est_tbl.h fd_compute_budget_program.h fd_microblock.h fd_pack_rebate_sum.h fd_pack_sim.h)
 $(call add-objs,fd_pack,fd_ballet)
 $(call add-objs,fd_pack_tile,fd_disco)
+$(call add-objs,fd_pack_sim,fd_disco)
 $(call add-objs,fd_pack_rebate_sum,fd_ballet)
 $(call make-unit-test,test_compute_budget_program,test_compute_budget_program,fd_ballet fd_util)
 $(call make-unit-test,test_est_tbl,test_est_tbl,fd_ballet fd_util)
@@ -21,6 +22,8 @@ $(call make-fuzz-test,fuzz_compute_budget_program_parse,fuzz_compute_budget_prog
 $(call make-fuzz-test,fuzz_chkdup,fuzz_chkdup,fd_ballet fd_util)
 $(call make-unit-test,test_pack,test_pack,fd_disco fd_ballet fd_util)
 $(call run-unit-test,test_pack)
+$(call make-unit-test,test_pack_sim,test_pack_sim,fd_disco fd_ballet fd_util)
+$(call run-unit-test,test_pack_sim)
 endif
 ifdef FD_HAS_AVX
 # Disabled in CI as it's just a benchmarking program and takes too long
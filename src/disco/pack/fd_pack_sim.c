@@ -0,0 +1,519 @@
+#include "fd_pack_sim.h"
+#include "fd_pack_cost.h"
+#include "fd_pack_pacing.h"
+
+/* These mirror the pack tile (see fd_pack_tile.c). */
+
+#define SIM_CUS_PER_MICROBLOCK         (1600000UL)
+#define SIM_VOTE_FRACTION              (1.0f)
+#define SIM_TRANSACTION_LIFETIME_SLOTS (160UL)
+
+struct fd_pack_sim_execle {
+  long         done_at;   /* LONG_MAX if idle */
+  ulong        txn_cnt;
+  ulong        block_idx; /* block the microblock was scheduled in */
+  fd_txn_e_t * txn;       /* microblock being executed */
+};
+
+typedef struct fd_pack_sim_execle fd_pack_sim_execle_t;
+
+struct __attribute__((aligned(FD_PACK_SIM_ALIGN))) fd_pack_sim_private {
+  fd_pack_sim_cfg_t      cfg;
+  fd_pack_sim_block_fn_t block_fn;
+  void *                 block_ctx;
+
+  fd_pack_t *            pack;
+  fd_rng_t               rng[1];
+  fd_pack_pacing_t       pacer[1];
+  fd_pack_rebate_sum_t   rebater[1];
+  union {
+    fd_pack_rebate_t     rebate[1];
+    uchar                footprint[ FD_PACK_REBATE_MAX_SZ ];
+  } rebate[1];
+
+  long  t0;        /* start of slot 0, LONG_MIN before the first event */
+  long  now;
+  long  next_poll; /* LONG_MAX if no schedule retry is pending */
+  ulong slot_idx;
+  int   leader;
+  ulong block_idx;
+
+  ulong highest_observed_slot;
+
+  ulong                bundle_id;
+  ulong                bundle_txn_cnt;
+  ulong                bundle_txn_rx;
+  ulong                bundle_min_blockhash_slot;
+  fd_txn_e_t * const * bundle;
+  fd_txn_e_t *         bundle_txn[ FD_PACK_MAX_TXN_PER_BUNDLE ];
+
+  ulong block_sched0[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_CNT ];
+
+  fd_pack_sim_block_t  block[1];
+  fd_pack_sim_stats_t  stats[1];
+  fd_pack_sim_execle_t execle[ FD_PACK_MAX_EXECLE_TILES ];
+};
+
+static ulong
+sim_microblock_max( fd_pack_sim_cfg_t const * cfg ) {
+  return fd_ulong_max( cfg->max_txn_per_microblock, FD_PACK_MAX_TXN_PER_BUNDLE );
+}
+
+static void
+sim_limits( fd_pack_sim_cfg_t const * cfg,
+            fd_pack_limits_t *        limits ) {
+  /* The write lock limit scales with the block limit as in SIMD 0306. */
+  *limits = (fd_pack_limits_t){
+    .max_cost_per_block           = cfg->max_cost_per_block,
+    .max_vote_cost_per_block      = FD_PACK_MAX_VOTE_COST_PER_BLOCK_LOWER_BOUND,
+    .max_write_cost_per_acct      = cfg->max_cost_per_block*4UL/10UL,
+    .max_data_bytes_per_block     = FD_PACK_MAX_DATA_PER_BLOCK,
+    .max_txn_per_microblock       = cfg->max_txn_per_microblock,
+    .max_microblocks_per_block    = (ulong)UINT_MAX,
+    .max_allocated_data_per_block = FD_PACK_MAX_ALLOCATED_DATA_PER_BLOCK,
+  };
+}
+
+fd_pack_sim_cfg_t *
+fd_pack_sim_cfg_default( fd_pack_sim_cfg_t * cfg ) {
+  *cfg = (fd_pack_sim_cfg_t){
+    .pack_depth             = 65524UL,
+    .execle_cnt             = 6UL,
+    .max_txn_per_microblock = 1UL,
+    .max_cost_per_block     = FD_PACK_MAX_COST_PER_BLOCK_LOWER_BOUND,
+    .slot_ns                = 400000000L,
+    .leader_slot_cnt        = 4UL,
+    .rotation_slot_cnt      = 16UL,
+    .poll_ns                = 20000L,
+    .pacing                 = 0,
+    .exec_ns_per_txn        = 20000UL,
+    .exec_ns_per_cu         = 0.05,
+    .cu_consumed_pct        = 50UL,
+    .seed                   = 0U,
+  };
+  return cfg;
+}
+
+FD_FN_CONST ulong
+fd_pack_sim_align( void ) {
+  return FD_PACK_SIM_ALIGN;
+}
+
+FD_FN_PURE ulong
+fd_pack_sim_footprint( fd_pack_sim_cfg_t const * cfg ) {
+  fd_pack_limits_t limits[1];
+  sim_limits( cfg, limits );
+  ulong pack_footprint = fd_pack_footprint( cfg->pack_depth, 1UL, cfg->execle_cnt, limits );
+  if( FD_UNLIKELY( !pack_footprint ) ) return 0UL;
+
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, FD_PACK_SIM_ALIGN,    sizeof(fd_pack_sim_t) );
+  l = FD_LAYOUT_APPEND( l, fd_pack_align(),      pack_footprint );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_txn_e_t),  cfg->execle_cnt*sim_microblock_max( cfg )*sizeof(fd_txn_e_t) );
+  return FD_LAYOUT_FINI( l, FD_PACK_SIM_ALIGN );
+}
+
+void *
+fd_pack_sim_new( void *                    mem,
+                 fd_pack_sim_cfg_t const * cfg,
+                 fd_pack_sim_block_fn_t    block_fn,
+                 void *                    block_ctx ) {
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, FD_PACK_SIM_ALIGN ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (cfg->execle_cnt<1UL) | (cfg->execle_cnt>FD_PACK_MAX_EXECLE_TILES) ) ) {
+    FD_LOG_WARNING(( "execle_cnt %lu not in [1,%lu]", cfg->execle_cnt, FD_PACK_MAX_EXECLE_TILES ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (cfg->max_txn_per_microblock<1UL) | (cfg->max_txn_per_microblock>MAX_TXN_PER_MICROBLOCK) ) ) {
+    FD_LOG_WARNING(( "max_txn_per_microblock %lu not in [1,%lu]", cfg->max_txn_per_microblock, MAX_TXN_PER_MICROBLOCK ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (cfg->slot_ns<=0L) | (cfg->slot_ns>=(long)UINT_MAX) | (cfg->poll_ns<=0L) ) ) {
+    FD_LOG_WARNING(( "invalid slot_ns %ld or poll_ns %ld", cfg->slot_ns, cfg->poll_ns ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (cfg->leader_slot_cnt<1UL) | (cfg->leader_slot_cnt>cfg->rotation_slot_cnt) ) ) {
+    FD_LOG_WARNING(( "leader_slot_cnt %lu not in [1,rotation_slot_cnt=%lu]", cfg->leader_slot_cnt, cfg->rotation_slot_cnt ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (cfg->cu_consumed_pct>100UL) | !(cfg->exec_ns_per_cu>=0.0) ) ) {
+    FD_LOG_WARNING(( "invalid cu_consumed_pct %lu or exec_ns_per_cu %f", cfg->cu_consumed_pct, cfg->exec_ns_per_cu ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (cfg->max_cost_per_block<1UL) | (cfg->max_cost_per_block>FD_PACK_MAX_COST_PER_BLOCK_UPPER_BOUND) ) ) {
+    FD_LOG_WARNING(( "max_cost_per_block %lu not in [1,%lu]", cfg->max_cost_per_block, FD_PACK_MAX_COST_PER_BLOCK_UPPER_BOUND ));
+    return NULL;
+  }
+  ulong footprint = fd_pack_sim_footprint( cfg );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "invalid pack_depth %lu", cfg->pack_depth ));
+    return NULL;
+  }
+
+  fd_pack_limits_t limits[1];
+  sim_limits( cfg, limits );
+
+  FD_SCRATCH_ALLOC_INIT( l, mem );
+  fd_pack_sim_t * sim      = FD_SCRATCH_ALLOC_APPEND( l, FD_PACK_SIM_ALIGN,   sizeof(fd_pack_sim_t) );
+  void *          pack_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_pack_align(),     fd_pack_footprint( cfg->pack_depth, 1UL, cfg->execle_cnt, limits ) );
+  fd_txn_e_t *    txn_mem  = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_txn_e_t), cfg->execle_cnt*sim_microblock_max( cfg )*sizeof(fd_txn_e_t) );
+  FD_SCRATCH_ALLOC_FINI( l, FD_PACK_SIM_ALIGN );
+
+  fd_memset( sim, 0, sizeof(fd_pack_sim_t) );
+  sim->cfg       = *cfg;
+  sim->block_fn  = block_fn;
+  sim->block_ctx = block_ctx;
+
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( sim->rng, cfg->seed, 0UL ) );
+  sim->pack = fd_pack_join( fd_pack_new( pack_mem, cfg->pack_depth, 1UL, cfg->execle_cnt, limits, NULL, 0UL, rng ) );
+  if( FD_UNLIKELY( !sim->pack ) ) return NULL;
+
+  fd_pack_rebate_sum_join( fd_pack_rebate_sum_new( sim->rebater, fd_rng_ulong( rng ) ) );
+
+  sim->t0        = LONG_MIN;
+  sim->next_poll = LONG_MAX;
+
+  for( ulong i=0UL; i<cfg->execle_cnt; i++ ) {
+    sim->execle[ i ].done_at = LONG_MAX;
+    sim->execle[ i ].txn     = txn_mem + i*sim_microblock_max( cfg );
+  }
+
+  fd_histf_new( sim->stats->sched_latency,      FD_PACK_SIM_LATENCY_MIN, FD_PACK_SIM_LATENCY_MAX );
+  fd_histf_new( sim->stats->microblock_latency, FD_PACK_SIM_LATENCY_MIN, FD_PACK_SIM_LATENCY_MAX );
+  fd_histf_new( sim->stats->schedule_ticks,     100UL,                   1000000UL               );
+
+  return sim;
+}
+
+fd_pack_sim_t *
+fd_pack_sim_join( void * mem ) {
+  return (fd_pack_sim_t *)mem;
+}
+
+void *
+fd_pack_sim_leave( fd_pack_sim_t * sim ) {
+  return (void *)sim;
+}
+
+void *
+fd_pack_sim_delete( void * mem ) {
+  fd_pack_sim_t * sim = (fd_pack_sim_t *)mem;
+  fd_pack_delete( fd_pack_leave( sim->pack ) );
+  fd_rng_delete( fd_rng_leave( sim->rng ) );
+  return mem;
+}
+
+FD_FN_PURE fd_pack_sim_stats_t const *
+fd_pack_sim_stats( fd_pack_sim_t const * sim ) {
+  return sim->stats;
+}
+
+/* Leader schedule ****************************************************/
+
+static inline int
+sim_is_leader( fd_pack_sim_cfg_t const * cfg,
+               ulong                     slot_idx ) {
+  return (slot_idx % cfg->rotation_slot_cnt) >= (cfg->rotation_slot_cnt - cfg->leader_slot_cnt);
+}
+
+static inline long
+sim_slot_end( fd_pack_sim_t const * sim ) {
+  return sim->t0 + (long)(sim->slot_idx+1UL)*sim->cfg.slot_ns;
+}
+
+static void
+sim_slot_start( fd_pack_sim_t * sim ) {
+  sim->leader = sim_is_leader( &sim->cfg, sim->slot_idx );
+  if( !sim->leader ) return;
+
+  fd_pack_pacing_init( sim->pacer, sim->now, sim->now+sim->cfg.slot_ns, 1.0f, sim->cfg.max_cost_per_block );
+  /* The tip payment program is assumed to be cranked already. */
+  fd_pack_set_initializer_bundles_ready( sim->pack );
+  fd_pack_rebate_sum_clear( sim->rebater );
+  fd_pack_get_sched_metrics( sim->pack, sim->block_sched0 );
+  fd_memset( sim->block, 0, sizeof(fd_pack_sim_block_t) );
+  sim->block->slot    = sim->slot_idx;
+  sim->block->max_cus = sim->cfg.max_cost_per_block;
+}
+
+static void
+sim_slot_end_block( fd_pack_sim_t * sim ) {
+  if( !sim->leader ) return;
+
+  fd_pack_sim_block_t * block = sim->block;
+  block->cus         = fd_pack_current_block_cost( sim->pack );
+  block->pending_cnt = fd_pack_avail_txn_cnt( sim->pack );
+  fd_pack_end_block( sim->pack );
+  sim->block_idx++;
+  sim->leader    = 0;
+  sim->next_poll = LONG_MAX;
+
+  fd_pack_sim_stats_t * stats = sim->stats;
+  stats->block_cnt++;
+  stats->txn_cnt        += block->txn_cnt;
+  stats->vote_cnt       += block->vote_cnt;
+  stats->bundle_cnt     += block->bundle_cnt;
+  stats->microblock_cnt += block->microblock_cnt;
+  stats->cus            += block->cus;
+  stats->max_cus        += block->max_cus;
+  stats->signature_fees += block->signature_fees;
+  stats->priority_fees  += block->priority_fees;
+  stats->stall_cnt      += block->stall_cnt;
+  stats->stall_ns       += block->stall_ns;
+
+  if( sim->block_fn ) sim->block_fn( block, sim->block_ctx );
+}
+
+/* Execles ************************************************************/
+
+/* sim_complete finishes the microblock of execle i.  Microblocks that
+   complete within the block they were scheduled in get their unused
+   CUs rebated, as an execle tile would. */
+
+static void
+sim_complete( fd_pack_sim_t * sim,
+              ulong           i ) {
+  fd_pack_sim_execle_t * execle = sim->execle+i;
+  fd_pack_microblock_complete( sim->pack, i );
+  execle->done_at = LONG_MAX;
+
+  if( FD_UNLIKELY( !sim->leader || execle->block_idx!=sim->block_idx ) ) return;
+
+  for( ulong j=0UL; j<execle->txn_cnt; j++ ) {
+    fd_txn_e_t * txne = execle->txn+j;
+    fd_txn_p_t * txnp = txne->txnp;
+    fd_acct_addr_t const * writable_alt = txne->alt_accts;
+    fd_pack_rebate_sum_add_txn( sim->rebater, txnp, &writable_alt, 1UL );
+  }
+  while( fd_pack_rebate_sum_report( sim->rebater, sim->rebate->rebate ) ) fd_pack_rebate_cus( sim->pack, sim->rebate->rebate );
+}
+
+/* sim_execute starts the microblock just scheduled to execle i and
+   accounts for it in the current block. */
+
+static void
+sim_execute( fd_pack_sim_t * sim,
+             ulong           i,
+             ulong           txn_cnt ) {
+  fd_pack_sim_execle_t * execle = sim->execle+i;
+  fd_pack_sim_block_t *  block  = sim->block;
+  fd_pack_sim_stats_t *  stats  = sim->stats;
+
+  int   is_bundle   = !!(execle->txn[ 0 ].txnp->flags & FD_TXN_P_FLAGS_BUNDLE);
+  ulong consumed    = 0UL;
+  ulong max_latency = 0UL;
+  for( ulong j=0UL; j<txn_cnt; j++ ) {
+    fd_txn_p_t * txnp = execle->txn[ j ].txnp;
+
+    ulong latency = (ulong)fd_long_max( 0L, sim->now - txnp->scheduler_arrival_time_nanos );
+    fd_histf_sample( stats->sched_latency, latency );
+    max_latency = fd_ulong_max( max_latency, latency );
+
+    uint  flags         = 0U;
+    ulong priority_fee  = 0UL;
+    ulong precompile_sig_cnt = 0UL;
+    fd_pack_compute_cost( TXN( txnp ), txnp->payload, &flags, NULL, &priority_fee, &precompile_sig_cnt, NULL, NULL );
+    block->priority_fees  += priority_fee;
+    block->signature_fees += FD_PACK_FEE_PER_SIGNATURE*(TXN( txnp )->signature_cnt + precompile_sig_cnt);
+    block->vote_cnt       += !!(txnp->flags & FD_TXN_P_FLAGS_IS_SIMPLE_VOTE);
+
+    /* Transactions succeed using cu_consumed_pct of the execution CUs
+       they requested. */
+    uint requested = txnp->pack_cu.requested_exec_plus_acct_data_cus;
+    uint used      = (uint)( ((ulong)requested * sim->cfg.cu_consumed_pct)/100UL );
+    uint non_exec  = txnp->pack_cu.non_execution_cus;
+    txnp->execle_cu.rebated_cus         = requested - used;
+    txnp->execle_cu.actual_consumed_cus = non_exec + used;
+    txnp->flags |= FD_TXN_P_FLAGS_SANITIZE_SUCCESS | FD_TXN_P_FLAGS_EXECUTE_SUCCESS;
+    consumed += non_exec + used;
+  }
+  fd_histf_sample( stats->microblock_latency, max_latency );
+
+  block->txn_cnt        += txn_cnt;
+  block->bundle_cnt     += (ulong)is_bundle;
+  block->microblock_cnt += fd_ulong_if( is_bundle, txn_cnt, 1UL );
+
+  long duration = (long)( txn_cnt*sim->cfg.exec_ns_per_txn ) + (long)( (double)consumed*sim->cfg.exec_ns_per_cu );
+  execle->txn_cnt   = txn_cnt;
+  execle->block_idx = sim->block_idx;
+  execle->done_at   = sim->now + fd_long_max( duration, 1L );
+}
+
+/* sim_schedule offers a microblock to idle execles, lowest index first,
+   until one attempt comes back empty.  An empty attempt while
+   transactions are pending arms a retry poll_ns later. */
+
+static void
+sim_schedule( fd_pack_sim_t * sim ) {
+  sim->next_poll = LONG_MAX;
+  if( !sim->leader ) return;
+
+  fd_pack_sim_cfg_t const * cfg = &sim->cfg;
+  ulong pacing_cnt = cfg->pacing ? fd_pack_pacing_enabled_bank_cnt( sim->pacer, sim->now ) : ULONG_MAX;
+
+  for( ulong i=0UL; i<cfg->execle_cnt; i++ ) {
+    if( sim->execle[ i ].done_at!=LONG_MAX ) continue;
+    if( !fd_pack_avail_txn_cnt( sim->pack ) ) return;
+
+    int flags = FD_PACK_SCHEDULE_VOTE | FD_PACK_SCHEDULE_BUNDLE | FD_PACK_SCHEDULE_TXN;
+    if( cfg->pacing ) {
+      flags = FD_PACK_SCHEDULE_VOTE | fd_int_if( i==0UL,        FD_PACK_SCHEDULE_BUNDLE, 0 )
+                                    | fd_int_if( i<pacing_cnt,  FD_PACK_SCHEDULE_TXN,    0 );
+    }
+
+    ulong sched0[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_CNT ];
+    fd_pack_get_sched_metrics( sim->pack, sched0 );
+
+    long  ticks   = -fd_tickcount();
+    ulong txn_cnt = fd_pack_schedule_next_microblock( sim->pack, SIM_CUS_PER_MICROBLOCK, SIM_VOTE_FRACTION, i, flags, sim->execle[ i ].txn );
+    ticks        += fd_tickcount();
+
+    if( !txn_cnt ) {
+      /* A stall is an idle execle while transactions are pending that
+         could only not be scheduled because of account conflicts. */
+      ulong sched1[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_CNT ];
+      fd_pack_get_sched_metrics( sim->pack, sched1 );
+      ulong conflict_cnt = (sched1[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_FAST_PATH_IDX ] - sched0[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_FAST_PATH_IDX ]) +
+                           (sched1[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_SLOW_PATH_IDX ] - sched0[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_SLOW_PATH_IDX ]);
+      if( (flags & FD_PACK_SCHEDULE_TXN) && conflict_cnt ) {
+        sim->block->stall_cnt++;
+        sim->block->stall_ns += cfg->poll_ns;
+      }
+      sim->next_poll = sim->now + cfg->poll_ns;
+      return;
+    }
+
+    fd_histf_sample( sim->stats->schedule_ticks, (ulong)ticks );
+    sim_execute( sim, i, txn_cnt );
+    fd_pack_pacing_update_consumed_cus( sim->pacer, fd_pack_current_block_cost( sim->pack ), sim->now );
+  }
+}
+
+/* Event loop *********************************************************/
+
+void
+fd_pack_sim_advance( fd_pack_sim_t * sim,
+                     long            now ) {
+  if( FD_UNLIKELY( sim->t0==LONG_MIN ) ) {
+    sim->t0  = now;
+    sim->now = now;
+    sim_slot_start( sim );
+  }
+
+  for(;;) {
+    long slot_end = sim_slot_end( sim );
+    long done     = LONG_MAX;
+    for( ulong i=0UL; i<sim->cfg.execle_cnt; i++ ) done = fd_long_min( done, sim->execle[ i ].done_at );
+
+    long next = fd_long_min( fd_long_min( slot_end, done ), sim->next_poll );
+    if( next>now ) break;
+    sim->now = fd_long_max( sim->now, next );
+
+    if( done<=sim->now ) {
+      for( ulong i=0UL; i<sim->cfg.execle_cnt; i++ ) {
+        if( sim->execle[ i ].done_at<=sim->now ) sim_complete( sim, i );
+      }
+    }
+    if( slot_end<=sim->now ) {
+      sim_slot_end_block( sim );
+      sim->slot_idx++;
+      sim_slot_start( sim );
+    }
+    sim_schedule( sim );
+  }
+
+  sim->now = fd_long_max( sim->now, now );
+}
+
+void
+fd_pack_sim_insert( fd_pack_sim_t *    sim,
+                    long               now,
+                    fd_txn_m_t const * txnm,
+                    ulong              blockhash_slot ) {
+  fd_pack_sim_advance( sim, now );
+
+  fd_pack_sim_stats_t * stats = sim->stats;
+  stats->txn_rx_cnt++;
+
+  if( FD_UNLIKELY( !sim->leader && blockhash_slot>sim->highest_observed_slot ) ) {
+    sim->highest_observed_slot = blockhash_slot;
+    ulong expire_before = fd_ulong_max( blockhash_slot, SIM_TRANSACTION_LIFETIME_SLOTS )-SIM_TRANSACTION_LIFETIME_SLOTS;
+    stats->txn_expired_cnt += fd_pack_expire_before( sim->pack, expire_before );
+  }
+
+  fd_txn_t const * txn = fd_txn_m_txn_t_const( txnm );
+
+  fd_txn_e_t * spot;
+  ulong bundle_id = txnm->block_engine.bundle_id;
+  if( FD_UNLIKELY( bundle_id ) ) {
+    if( FD_LIKELY( bundle_id!=sim->bundle_id ) ) {
+      if( FD_UNLIKELY( sim->bundle ) ) {
+        stats->bundle_partial_cnt += sim->bundle_txn_rx;
+        fd_pack_insert_bundle_cancel( sim->pack, sim->bundle, sim->bundle_txn_cnt );
+        sim->bundle = NULL;
+      }
+      sim->bundle_id                 = bundle_id;
+      sim->bundle_txn_cnt            = txnm->block_engine.bundle_txn_cnt;
+      sim->bundle_txn_rx             = 0UL;
+      sim->bundle_min_blockhash_slot = ULONG_MAX;
+      if( FD_UNLIKELY( !sim->bundle_txn_cnt || sim->bundle_txn_cnt>FD_PACK_MAX_TXN_PER_BUNDLE ) ) {
+        stats->bundle_partial_cnt++;
+        sim->bundle_id = 0UL;
+        return;
+      }
+      sim->bundle = fd_pack_insert_bundle_init( sim->pack, sim->bundle_txn, sim->bundle_txn_cnt );
+    }
+    spot = sim->bundle[ sim->bundle_txn_rx ];
+    sim->bundle_min_blockhash_slot = fd_ulong_min( sim->bundle_min_blockhash_slot, blockhash_slot );
+  } else {
+    spot = fd_pack_insert_txn_init( sim->pack );
+  }
+
+  fd_memcpy( spot->txnp->payload, fd_txn_m_payload_const( txnm ), txnm->payload_sz                      );
+  fd_memcpy( TXN( spot->txnp ),   txn,                            txnm->txn_t_sz                         );
+  fd_memcpy( spot->alt_accts,     fd_txn_m_alut( (fd_txn_m_t *)txnm ), txn->addr_table_adtl_cnt*sizeof(fd_acct_addr_t) );
+  spot->txnp->payload_sz                   = txnm->payload_sz;
+  spot->txnp->scheduler_arrival_time_nanos = sim->now;
+  spot->txnp->first_seen_nanos             = txnm->first_seen_nanos;
+  spot->txnp->source_ipv4                  = txnm->source_ipv4;
+  spot->txnp->source_tpu                   = txnm->source_tpu;
+
+  ulong deleted = 0UL;
+  if( FD_UNLIKELY( bundle_id ) ) {
+    if( FD_LIKELY( ++sim->bundle_txn_rx<sim->bundle_txn_cnt ) ) return;
+    int result = fd_pack_insert_bundle_fini( sim->pack, sim->bundle, sim->bundle_txn_cnt, sim->bundle_min_blockhash_slot, 0, NULL, &deleted );
+    if( FD_UNLIKELY( result<0 ) ) stats->txn_insert_fail_cnt += sim->bundle_txn_cnt;
+    sim->bundle    = NULL;
+    sim->bundle_id = 0UL;
+  } else {
+    int result = fd_pack_insert_txn_fini( sim->pack, spot, blockhash_slot, &deleted );
+    if( FD_UNLIKELY( result<0 ) ) stats->txn_insert_fail_cnt++;
+  }
+
+  sim_schedule( sim );
+}
+
+void
+fd_pack_sim_fini( fd_pack_sim_t * sim ) {
+  if( FD_UNLIKELY( sim->t0==LONG_MIN ) ) return;
+
+  if( FD_UNLIKELY( sim->bundle ) ) {
+    sim->stats->bundle_partial_cnt += sim->bundle_txn_rx;
+    fd_pack_insert_bundle_cancel( sim->pack, sim->bundle, sim->bundle_txn_cnt );
+    sim->bundle = NULL;
+  }
+
+  /* Run to the end of the last leader slot of this rotation, or of the
+     next one if the current slot is past it already. */
+  ulong rotation = sim->cfg.rotation_slot_cnt;
+  ulong end_slot = (sim->slot_idx/rotation + 1UL)*rotation;
+  fd_pack_sim_advance( sim, sim->t0 + (long)end_slot*sim->cfg.slot_ns );
+
+  fd_pack_get_sched_metrics( sim->pack, sim->stats->sched_results );
+}
@@ -0,0 +1,202 @@
+#ifndef HEADER_fd_src_disco_pack_fd_pack_sim_h
+#define HEADER_fd_src_disco_pack_fd_pack_sim_h
+
+/* fd_pack_sim replays a stream of verified and resolved transactions
+   through an fd_pack object offline, with simulated execle tiles and a
+   simulated leader schedule.  Everything runs in virtual time driven by
+   the arrival timestamps of the input transactions, so given the same
+   input, configuration and seed, a simulation produces exactly the same
+   blocks.  This makes it possible to A/B scheduler changes (penalty
+   treaps, pacing, cost estimates, ...) against captured traffic instead
+   of against a live cluster.
+
+   The simulation mirrors the control flow of the pack tile:
+
+   - Transactions are inserted as they arrive.  While not leader,
+     transactions older than the blockhash lifetime are expired, using
+     the highest blockhash slot observed as the current slot.
+
+   - While leader, an idle execle is offered a microblock every time
+     something changes (a transaction arrives, an execle completes, a
+     slot starts) and every poll_ns while work is pending.  With pacing
+     enabled, normal transactions are only offered to the first
+     fd_pack_pacing_enabled_bank_cnt execles, as in the balanced
+     strategy.
+
+   - A microblock keeps its execle busy for exec_ns_per_txn per
+     transaction plus exec_ns_per_cu per consumed CU.  Transactions are
+     assumed to succeed and consume cu_consumed_pct percent of the
+     execution CUs they requested.  The rest is rebated to pack when
+     the microblock completes.
+
+   - Bundles are scheduled as if the tip payment program did not need
+     cranking.
+
+   - Leader slots are slot_ns long.  A microblock still executing when
+     its slot ends completes without a rebate.  The write lock limit is
+     4/10 of max_cost_per_block, as in SIMD 0306.
+
+   fd_pack registers metrics, so the caller must have a metrics region
+   registered (fd_metrics_register) on the calling thread. */
+
+#include "fd_pack.h"
+#include "../fd_txn_m.h"
+#include "../../util/hist/fd_histf.h"
+
+#define FD_PACK_SIM_ALIGN (128UL)
+
+/* FD_PACK_SIM_LATENCY_{MIN,MAX} are the bounds in ns of the scheduling
+   latency histograms. */
+
+#define FD_PACK_SIM_LATENCY_MIN (       1000UL)
+#define FD_PACK_SIM_LATENCY_MAX (10000000000UL)
+
+struct fd_pack_sim_cfg {
+  ulong  pack_depth;         /* max pending transactions, in [4,USHORT_MAX-11) */
+  ulong  execle_cnt;         /* in [1,FD_PACK_MAX_EXECLE_TILES] */
+  ulong  max_txn_per_microblock;
+  ulong  max_cost_per_block;
+
+  long   slot_ns;            /* slot duration */
+  ulong  leader_slot_cnt;    /* consecutive leader slots per rotation */
+  ulong  rotation_slot_cnt;  /* slots per rotation, leader for the last leader_slot_cnt of them */
+  long   poll_ns;            /* schedule retry interval while work is pending */
+
+  int    pacing;             /* use the balanced strategy */
+  ulong  exec_ns_per_txn;
+  double exec_ns_per_cu;
+  ulong  cu_consumed_pct;    /* in [0,100] */
+
+  uint   seed;
+};
+
+typedef struct fd_pack_sim_cfg fd_pack_sim_cfg_t;
+
+/* fd_pack_sim_block_t summarizes one simulated leader block. */
+
+struct fd_pack_sim_block {
+  ulong slot;              /* simulated slot index */
+  ulong txn_cnt;           /* transactions scheduled, including votes */
+  ulong vote_cnt;
+  ulong bundle_cnt;
+  ulong microblock_cnt;    /* non-empty microblocks */
+  ulong cus;               /* net CUs scheduled after rebates */
+  ulong max_cus;
+  ulong signature_fees;    /* lamports */
+  ulong priority_fees;     /* lamports */
+  ulong stall_cnt;         /* schedule attempts that failed on account conflicts only */
+  long  stall_ns;          /* stall_cnt*poll_ns, approximate execle time lost to conflicts */
+  ulong pending_cnt;       /* transactions pending at the end of the block */
+};
+
+typedef struct fd_pack_sim_block fd_pack_sim_block_t;
+
+/* fd_pack_sim_stats_t accumulates over the whole simulation. */
+
+struct fd_pack_sim_stats {
+  ulong txn_rx_cnt;
+  ulong txn_insert_fail_cnt;  /* rejected by fd_pack_insert_txn_fini */
+  ulong txn_expired_cnt;
+  ulong bundle_partial_cnt;   /* transactions of incomplete bundles */
+
+  ulong block_cnt;
+  ulong txn_cnt;
+  ulong vote_cnt;
+  ulong bundle_cnt;
+  ulong microblock_cnt;
+  ulong cus;
+  ulong max_cus;
+  ulong signature_fees;
+  ulong priority_fees;
+  ulong stall_cnt;
+  long  stall_ns;
+
+  /* sched_latency samples the virtual time between the arrival of a
+     transaction and its scheduling, in ns.  microblock_latency samples
+     the same for the oldest transaction of each microblock.
+     schedule_ticks samples the wallclock cost of each non-empty call to
+     fd_pack_schedule_next_microblock, in ticks.  Unlike everything
+     else, schedule_ticks is not deterministic. */
+  fd_histf_t sched_latency     [1];
+  fd_histf_t microblock_latency[1];
+  fd_histf_t schedule_ticks    [1];
+
+  /* sched_results are the fd_pack FD_METRICS_ENUM_PACK_TXN_SCHEDULE_*
+     counters. */
+  ulong sched_results[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_CNT ];
+};
+
+typedef struct fd_pack_sim_stats fd_pack_sim_stats_t;
+
+/* fd_pack_sim_block_fn_t is called at the end of every simulated leader
+   block. */
+
+typedef void (* fd_pack_sim_block_fn_t)( fd_pack_sim_block_t const * block,
+                                         void *                      ctx );
+
+struct fd_pack_sim_private;
+typedef struct fd_pack_sim_private fd_pack_sim_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_pack_sim_cfg_default populates cfg with the parameters of a
+   mainnet-like pack tile: 6 execles, 400ms slots, 4 leader slots every
+   16 slots, small microblocks and the lower block CU limit. */
+
+fd_pack_sim_cfg_t *
+fd_pack_sim_cfg_default( fd_pack_sim_cfg_t * cfg );
+
+FD_FN_CONST ulong
+fd_pack_sim_align( void );
+
+FD_FN_PURE ulong
+fd_pack_sim_footprint( fd_pack_sim_cfg_t const * cfg );
+
+/* fd_pack_sim_new formats a memory region for use as a pack simulation.
+   cfg is copied.  block_fn is optional.  Returns NULL and logs on
+   invalid configuration. */
+
+void *
+fd_pack_sim_new( void *                    mem,
+                 fd_pack_sim_cfg_t const * cfg,
+                 fd_pack_sim_block_fn_t    block_fn,
+                 void *                    block_ctx );
+
+fd_pack_sim_t * fd_pack_sim_join  ( void *          mem );
+void *          fd_pack_sim_leave ( fd_pack_sim_t * sim );
+void *          fd_pack_sim_delete( void *          mem );
+
+/* fd_pack_sim_insert advances the simulation to time now (ns, arbitrary
+   epoch, must not go backwards; earlier values are clamped) and then
+   inserts a transaction the way the pack tile would insert an
+   fd_txn_m_t received from a resolv tile.  txnm must have its txn_t and
+   resolved address lookup table accounts attached.  blockhash_slot is
+   the slot of the transaction's recent blockhash (the frag sig on the
+   resolv_pack link).  Bundle transactions are collected until their
+   bundle is complete. */
+
+void
+fd_pack_sim_insert( fd_pack_sim_t *    sim,
+                    long               now,
+                    fd_txn_m_t const * txnm,
+                    ulong              blockhash_slot );
+
+/* fd_pack_sim_advance runs the simulation until time now. */
+
+void
+fd_pack_sim_advance( fd_pack_sim_t * sim,
+                     long            now );
+
+/* fd_pack_sim_fini runs the simulation until the end of the current
+   rotation's leader slots, so the transactions still pending at the end
+   of the input get a chance to be scheduled. */
+
+void
+fd_pack_sim_fini( fd_pack_sim_t * sim );
+
+FD_FN_PURE fd_pack_sim_stats_t const *
+fd_pack_sim_stats( fd_pack_sim_t const * sim );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_pack_fd_pack_sim_h */
@@ -0,0 +1,206 @@
+#include "fd_pack_sim.h"
+#include "fd_pack_cost.h"
+#include "../../ballet/txn/fd_txn_build.h"
+#include "../../flamenco/runtime/fd_system_ids_pp.h"
+#include "../metrics/fd_metrics.h"
+
+#define SIM_SCRATCH_SZ (256UL*1024UL*1024UL)
+uchar sim_scratch[ SIM_SCRATCH_SZ ] __attribute__((aligned(FD_PACK_SIM_ALIGN)));
+
+uchar metrics_scratch[ FD_METRICS_FOOTPRINT( 0 ) ] __attribute__((aligned(FD_METRICS_ALIGN)));
+
+#define TXN_CNT (4096UL)
+
+static uchar const compute_budget_prog_id[ 32 ] = { COMPUTE_BUDGET_PROG_ID };
+
+static uchar txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+
+static union {
+  fd_txn_m_t txnm[1];
+  uchar      buf[ FD_TPU_RESOLVED_MTU ];
+} txn_buf[ TXN_CNT ] __attribute__((aligned(alignof(fd_txn_m_t))));
+
+static void
+addr_set( fd_acct_addr_t * addr,
+          ulong            tag,
+          ulong            idx ) {
+  fd_memset( addr, 0, sizeof(fd_acct_addr_t) );
+  FD_STORE( ulong, addr->b,               tag );
+  FD_STORE( ulong, addr->b+sizeof(ulong), idx );
+}
+
+/* make_txns builds TXN_CNT transactions, each with its own fee payer,
+   writing one of acct_cnt accounts and requesting 10k CUs. */
+
+static void
+make_txns( ulong acct_cnt ) {
+  fd_txn_builder_t builder[1];
+  for( ulong i=0UL; i<TXN_CNT; i++ ) {
+    FD_TEST( fd_txn_builder_new( builder, i ) );
+    fd_acct_addr_t payer;     addr_set( &payer,     1UL, i          );
+    fd_acct_addr_t program;   addr_set( &program,   2UL, 0UL        );
+    fd_acct_addr_t acct;      addr_set( &acct,      3UL, i%acct_cnt );
+    fd_acct_addr_t blockhash; addr_set( &blockhash, 4UL, 0UL        );
+    uchar data[ 4 ] = { 0 };
+    uchar cu_limit[ 5 ] = { 2 }; FD_STORE( uint,  cu_limit+1, 10000U );
+    uchar cu_price[ 9 ] = { 3 }; FD_STORE( ulong, cu_price+1, 1000UL*(i%8UL) );
+    FD_TEST( fd_txn_builder_fee_payer_set( builder, &payer ) );
+    fd_txn_builder_blockhash_set( builder, &blockhash );
+    FD_TEST( fd_txn_builder_instr_open( builder, compute_budget_prog_id, cu_limit, sizeof(cu_limit) ) );
+    fd_txn_builder_instr_close( builder );
+    FD_TEST( fd_txn_builder_instr_open( builder, compute_budget_prog_id, cu_price, sizeof(cu_price) ) );
+    fd_txn_builder_instr_close( builder );
+    FD_TEST( fd_txn_builder_instr_open( builder, &program, data, sizeof(data) ) );
+    FD_TEST( fd_txn_builder_instr_account_push( builder, &acct, FD_TXN_ACCT_CAT_WRITABLE ) );
+    fd_txn_builder_instr_close( builder );
+
+    fd_txn_m_t * txnm = txn_buf[ i ].txnm;
+    fd_memset( txnm, 0, sizeof(fd_txn_m_t) );
+    ushort txn_t_sz   = 0;
+    uint   payload_sz = fd_txn_build( builder, fd_txn_m_payload( txnm ), (fd_txn_t *)txn_mem, &txn_t_sz );
+    FD_TEST( payload_sz );
+    txnm->payload_sz = (ushort)payload_sz;
+    txnm->txn_t_sz   = txn_t_sz;
+    fd_memcpy( fd_txn_m_txn_t( txnm ), txn_mem, txn_t_sz );
+
+    /* Signatures must be unique */
+    FD_STORE( ulong, fd_txn_m_payload( txnm )+fd_txn_m_txn_t( txnm )->signature_off, i+1UL );
+    fd_txn_builder_delete( builder );
+  }
+}
+
+struct block_log {
+  ulong cnt;
+  ulong hash;
+};
+typedef struct block_log block_log_t;
+
+static void
+log_block( fd_pack_sim_block_t const * block,
+           void *                      ctx ) {
+  block_log_t * log = (block_log_t *)ctx;
+  log->cnt++;
+  log->hash = fd_hash( log->hash, block, sizeof(fd_pack_sim_block_t) );
+}
+
+static fd_pack_sim_stats_t
+run_sim( fd_pack_sim_cfg_t const * cfg,
+         long                      interval_ns,
+         block_log_t *             log ) {
+  FD_TEST( fd_pack_sim_footprint( cfg )<=SIM_SCRATCH_SZ );
+  fd_pack_sim_t * sim = fd_pack_sim_join( fd_pack_sim_new( sim_scratch, cfg, log_block, log ) );
+  FD_TEST( sim );
+
+  long now = 1000000000L;
+  for( ulong i=0UL; i<TXN_CNT; i++ ) {
+    fd_pack_sim_insert( sim, now, txn_buf[ i ].txnm, 0UL );
+    now += interval_ns;
+  }
+  fd_pack_sim_fini( sim );
+
+  fd_pack_sim_stats_t stats = *fd_pack_sim_stats( sim );
+  FD_TEST( fd_pack_sim_delete( fd_pack_sim_leave( sim ) )==sim_scratch );
+  return stats;
+}
+
+static void
+test_cfg( void ) {
+  fd_pack_sim_cfg_t cfg[1];
+  FD_TEST( fd_pack_sim_cfg_default( cfg )==cfg );
+  FD_TEST( fd_pack_sim_footprint( cfg ) );
+  FD_TEST( fd_ulong_is_aligned( fd_pack_sim_footprint( cfg ), fd_pack_sim_align() ) );
+
+  FD_TEST( !fd_pack_sim_new( NULL,          cfg, NULL, NULL ) );
+  FD_TEST( !fd_pack_sim_new( sim_scratch+1, cfg, NULL, NULL ) );
+
+  fd_pack_sim_cfg_t bad[1];
+  *bad = *cfg; bad->execle_cnt      = 0UL;                         FD_TEST( !fd_pack_sim_new( sim_scratch, bad, NULL, NULL ) );
+  *bad = *cfg; bad->execle_cnt      = FD_PACK_MAX_EXECLE_TILES+1UL; FD_TEST( !fd_pack_sim_new( sim_scratch, bad, NULL, NULL ) );
+  *bad = *cfg; bad->leader_slot_cnt = cfg->rotation_slot_cnt+1UL;  FD_TEST( !fd_pack_sim_new( sim_scratch, bad, NULL, NULL ) );
+  *bad = *cfg; bad->cu_consumed_pct = 101UL;                       FD_TEST( !fd_pack_sim_new( sim_scratch, bad, NULL, NULL ) );
+  *bad = *cfg; bad->poll_ns         = 0L;                          FD_TEST( !fd_pack_sim_new( sim_scratch, bad, NULL, NULL ) );
+}
+
+static void
+test_sim( void ) {
+  fd_pack_sim_cfg_t cfg[1];
+  fd_pack_sim_cfg_default( cfg );
+  cfg->pack_depth         = 8192UL;
+  cfg->max_cost_per_block = FD_PACK_MAX_COST_PER_BLOCK_UPPER_BOUND;
+  cfg->leader_slot_cnt    = 1UL;
+  cfg->rotation_slot_cnt  = 1UL;
+
+  /* Independent transactions arriving slower than they execute are all
+     scheduled without any stalls. */
+
+  make_txns( TXN_CNT );
+  block_log_t log0[1] = {{ 0 }};
+  fd_pack_sim_stats_t s0 = run_sim( cfg, 100000L, log0 );
+  FD_TEST( s0.txn_rx_cnt==TXN_CNT );
+  FD_TEST( s0.txn_cnt   ==TXN_CNT );
+  FD_TEST( !s0.txn_insert_fail_cnt );
+  FD_TEST( !s0.stall_cnt );
+  FD_TEST( s0.block_cnt==log0->cnt );
+  FD_TEST( s0.signature_fees==TXN_CNT*FD_PACK_FEE_PER_SIGNATURE );
+  FD_TEST( s0.priority_fees>0UL );
+  FD_TEST( s0.sched_results[ FD_METRICS_ENUM_PACK_TXN_SCHEDULE_V_TAKEN_IDX ]==TXN_CNT );
+  FD_TEST( s0.cus>0UL && s0.cus<s0.max_cus );
+  FD_LOG_NOTICE(( "independent: %lu blocks, %lu cus, sched latency p50 %lu ns",
+                  s0.block_cnt, s0.cus, fd_histf_percentile( s0.sched_latency, 50, ULONG_MAX ) ));
+
+  /* Rebates: consuming all requested CUs fills the block more. */
+
+  cfg->cu_consumed_pct = 100UL;
+  block_log_t log1[1] = {{ 0 }};
+  fd_pack_sim_stats_t s1 = run_sim( cfg, 100000L, log1 );
+  FD_TEST( s1.txn_cnt==TXN_CNT );
+  FD_TEST( s1.cus>s0.cus );
+  cfg->cu_consumed_pct = 50UL;
+
+  /* The simulation is deterministic. */
+
+  block_log_t log2[1] = {{ 0 }};
+  fd_pack_sim_stats_t s2 = run_sim( cfg, 100000L, log2 );
+  FD_TEST( log2->cnt ==log0->cnt  );
+  FD_TEST( log2->hash==log0->hash );
+  FD_TEST( !memcmp( s2.sched_latency, s0.sched_latency, sizeof(fd_histf_t) ) );
+
+  /* Transactions that all write one of two accounts arriving in a burst
+     serialize on two execles, and the others stall. */
+
+  make_txns( 2UL );
+  block_log_t log3[1] = {{ 0 }};
+  fd_pack_sim_stats_t s3 = run_sim( cfg, 10L, log3 );
+  FD_TEST( s3.txn_cnt==TXN_CNT );
+  FD_TEST( s3.stall_cnt>0UL );
+  FD_TEST( s3.stall_ns>0L   );
+  FD_TEST( fd_histf_percentile( s3.sched_latency, 50, ULONG_MAX )>fd_histf_percentile( s0.sched_latency, 50, ULONG_MAX ) );
+  FD_LOG_NOTICE(( "conflicting: %lu blocks, %lu stalls, sched latency p50 %lu ns",
+                  s3.block_cnt, s3.stall_cnt, fd_histf_percentile( s3.sched_latency, 50, ULONG_MAX ) ));
+
+  /* Outside of leader slots nothing is scheduled and the pending
+     transactions wait for the next leader slot. */
+
+  cfg->leader_slot_cnt   = 1UL;
+  cfg->rotation_slot_cnt = 4UL;
+  make_txns( TXN_CNT );
+  block_log_t log4[1] = {{ 0 }};
+  fd_pack_sim_stats_t s4 = run_sim( cfg, 1000L, log4 );
+  FD_TEST( s4.block_cnt==1UL );
+  FD_TEST( s4.txn_cnt  ==TXN_CNT );
+  FD_TEST( fd_histf_percentile( s4.sched_latency, 50, ULONG_MAX )>=(ulong)cfg->slot_ns );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_metrics_register( (ulong *)fd_metrics_new( metrics_scratch, 0UL ) );
+
+  test_cfg();
+  test_sim();
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
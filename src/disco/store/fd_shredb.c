@@ -3,7 +3,88 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
+#include <sys/stat.h>
+
+/* The index file starts with two checkpoint header slots, followed by
+   the ring key array at FD_SHREDB_IDX_KEYS_OFF, indexed by ring
+   position. */
+
+#define FD_SHREDB_IDX_MAGIC     (0xf17eda2c35b1d800UL) /* firedancer shredb idx ver 0 */
+#define FD_SHREDB_IDX_KEYS_OFF  (4096UL)
+#define FD_SHREDB_IDX_HDR_SZ    (64UL)
+#define FD_SHREDB_HASH_SEED     (0x5b7ed8a4c2e1f093UL)
+
+struct fd_shredb_ckpt {
+  ulong magic;
+  ulong max_shreds;
+  ulong seq;         /* sequence number of the next insert */
+  ulong write_head;
+  ulong file_shreds;
+  ulong hash;        /* checksum of the fields above */
+};
+typedef struct fd_shredb_ckpt fd_shredb_ckpt_t;
+
+static inline ulong
+fd_shredb_ckpt_hash( fd_shredb_ckpt_t const * ckpt ) {
+  return fd_hash( FD_SHREDB_HASH_SEED, ckpt, offsetof( fd_shredb_ckpt_t, hash ) );
+}
+
+/* fd_shredb_entry_hash returns the checksum of an entry.  Assumes
+   entry->shred_sz was checked to be at most FD_SHRED_MAX_SZ. */
+
+static inline ulong
+fd_shredb_entry_hash( fd_shredb_entry_t const * entry ) {
+  ulong h = fd_hash( FD_SHREDB_HASH_SEED, entry, offsetof( fd_shredb_entry_t, hash ) );
+  return fd_hash( h, &entry->shred_sz, sizeof(ushort) + entry->shred_sz );
+}
+
+static inline int
+fd_shredb_entry_valid( fd_shredb_entry_t const * entry,
+                       ulong                     key ) {
+  return entry->key==key && entry->shred_sz<=FD_SHRED_MAX_SZ && entry->hash==fd_shredb_entry_hash( entry );
+}
+
+static inline int
+fd_shredb_occupied( fd_shredb_t const * store,
+                    ulong               ring_idx ) {
+  return !!( store->evict_occupied[ ring_idx/64UL ] & (1UL<<(ring_idx%64UL)) );
+}
+
+/* fd_shredb_pread and fd_shredb_pwrite transfer sz bytes at off,
+   retrying short transfers.  Return 0 on success and an errno on
+   failure (EIO for reads past the end of the file). */
+
+static int
+fd_shredb_pread( int    fd,
+                 void * buf,
+                 ulong  sz,
+                 ulong  off ) {
+  while( sz ) {
+    long res = pread( fd, buf, sz, (off_t)off );
+    if( FD_UNLIKELY( res<=0L ) ) return res ? errno : EIO;
+    buf  = (uchar *)buf + res;
+    sz  -= (ulong)res;
+    off += (ulong)res;
+  }
+  return 0;
+}
+
+static int
+fd_shredb_pwrite( int          fd,
+                  void const * buf,
+                  ulong        sz,
+                  ulong        off ) {
+  while( sz ) {
+    long res = pwrite( fd, buf, sz, (off_t)off );
+    if( FD_UNLIKELY( res<0L ) ) return errno;
+    buf  = (uchar const *)buf + res;
+    sz  -= (ulong)res;
+    off += (ulong)res;
+  }
+  return 0;
+}
 
 static inline ulong
 fd_shredb_max_shreds_for_gib( ulong max_size_gib ) {
@@ -42,11 +123,174 @@ fd_shredb_footprint( ulong max_size_gib ) {
   return FD_LAYOUT_FINI( l, fd_shredb_align() );
 }
 
+static void
+fd_shredb_slot_evict( fd_shredb_t * store,
+                      ulong         slot,
+                      uint          evicted_shred_idx );
+
+/* fd_shredb_index adds the shred with the given key, stored at ring
+   position ring_idx, to the per-shred and per-slot maps. */
+
+static void
+fd_shredb_index( fd_shredb_t * store,
+                 ulong         key,
+                 ulong         ring_idx ) {
+  ulong slot      = fd_shredb_key_slot( key );
+  uint  shred_idx = fd_shredb_key_shred_idx( key );
+
+  store->evict_keys    [ ring_idx ] = key;
+  store->evict_occupied[ ring_idx/64UL ] |= (1UL<<(ring_idx%64UL));
+
+  fd_shredb_shred_entry_t * map_entry = fd_shredb_shred_map_insert( store->shred_map, key );
+  FD_TEST( map_entry );
+  map_entry->ring_idx = ring_idx;
+
+  fd_shredb_slot_entry_t * se = fd_shredb_slot_map_query( store->slot_map, slot, NULL );
+  if( FD_LIKELY( se ) ) {
+    se->cnt++;
+    se->highest_shred_idx = fd_uint_max( se->highest_shred_idx, shred_idx );
+  } else {
+    se = fd_shredb_slot_map_insert( store->slot_map, slot );
+    FD_TEST( se );
+    se->highest_shred_idx = shred_idx;
+    se->cnt               = 1UL;
+  }
+
+  store->cnt++;
+}
+
+/* fd_shredb_recover re-adopts the contents of the ring file from the
+   newest checkpoint in the index file, replaying entries written after
+   it.  store must have its files open, its maps joined and empty, and
+   its evict_occupied bitset cleared.  Returns 1 on success, and 0 if
+   there is nothing usable to recover, in which case the store is left
+   untouched apart from evict_keys. */
+
+static int
+fd_shredb_recover( fd_shredb_t * store,
+                   char const *  file_path ) {
+  ulong max_shreds = store->max_shreds;
+
+  FD_STATIC_ASSERT( sizeof(fd_shredb_ckpt_t)<=FD_SHREDB_IDX_HDR_SZ, layout );
+  fd_shredb_ckpt_t ckpt[ 2 ];
+  for( ulong i=0UL; i<2UL; i++ ) {
+    if( FD_UNLIKELY( fd_shredb_pread( store->idx_fd, &ckpt[ i ], sizeof(fd_shredb_ckpt_t), i*FD_SHREDB_IDX_HDR_SZ ) ) ) {
+      FD_LOG_INFO(( "no shredb index found at %s.idx, starting empty", file_path ));
+      return 0;
+    }
+  }
+
+  ulong best = ULONG_MAX;
+  for( ulong i=0UL; i<2UL; i++ ) {
+    fd_shredb_ckpt_t const * c = &ckpt[ i ];
+    int valid = c->magic==FD_SHREDB_IDX_MAGIC       &&
+                c->hash==fd_shredb_ckpt_hash( c )    &&
+                c->max_shreds==max_shreds            &&
+                c->seq>=1UL                          &&
+                c->write_head<max_shreds             &&
+                c->file_shreds<=max_shreds           &&
+                fd_ulong_min( c->seq-1UL, max_shreds )<=c->file_shreds;
+    if( valid && ( best==ULONG_MAX || c->seq>ckpt[ best ].seq ) ) best = i;
+  }
+  if( FD_UNLIKELY( best==ULONG_MAX ) ) {
+    FD_LOG_WARNING(( "no valid checkpoint in shredb index %s.idx, starting empty", file_path ));
+    return 0;
+  }
+  fd_shredb_ckpt_t const * c = &ckpt[ best ];
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( store->fd, &st ) ) ) {
+    FD_LOG_WARNING(( "fstat(%s) failed (%i-%s)", file_path, errno, fd_io_strerror( errno ) ));
+    return 0;
+  }
+  ulong ring_shreds = fd_ulong_min( (ulong)st.st_size / sizeof(fd_shredb_entry_t), max_shreds );
+  if( FD_UNLIKELY( ring_shreds<c->file_shreds ) ) {
+    FD_LOG_WARNING(( "shredb file %s is shorter than its checkpoint, starting empty", file_path ));
+    return 0;
+  }
+
+  /* Ring positions are filled in order from zero, so the occupied
+     positions as of the checkpoint are [0,min(seq-1,max_shreds)). */
+
+  ulong occ_cnt = fd_ulong_min( c->seq-1UL, max_shreds );
+  int err = fd_shredb_pread( store->idx_fd, store->evict_keys, occ_cnt*sizeof(ulong), FD_SHREDB_IDX_KEYS_OFF );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "failed to read shredb index %s.idx (%i-%s), starting empty", file_path, err, fd_io_strerror( err ) ));
+    return 0;
+  }
+  for( ulong i=0UL; i<occ_cnt; i++ ) store->evict_occupied[ i/64UL ] |= (1UL<<(i%64UL));
+
+  store->file_shreds = ring_shreds;
+
+  /* Replay entries written after the checkpoint.  The ring is written
+     sequentially, so these start at the checkpointed write head and
+     carry consecutive sequence numbers.  The first entry that does not
+     is where the write head was when the store was last used. */
+
+  fd_shredb_entry_t rd_entry[1];
+  ulong pos        = c->write_head;
+  ulong seq        = c->seq;
+  ulong replay_cnt = 0UL;
+  for( ; replay_cnt<max_shreds; replay_cnt++ ) {
+    if( FD_UNLIKELY( pos>=store->file_shreds ) ) break;
+    err = fd_shredb_pread( store->fd, rd_entry, sizeof(fd_shredb_entry_t), pos*sizeof(fd_shredb_entry_t) );
+    if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "error reading from shredb: (%d-%s)", err, fd_io_strerror( err ) ));
+    if( rd_entry->seq!=seq || !fd_shredb_entry_valid( rd_entry, rd_entry->key ) ) break;
+
+    store->evict_keys    [ pos ] = rd_entry->key;
+    store->evict_occupied[ pos/64UL ] |= (1UL<<(pos%64UL));
+    pos = (pos+1UL) % max_shreds;
+    seq++;
+  }
+
+  /* The entry at the write head may have been torn by the write in
+     progress when the process died. */
+
+  if( fd_shredb_occupied( store, pos ) ) {
+    err = fd_shredb_pread( store->fd, rd_entry, sizeof(fd_shredb_entry_t), pos*sizeof(fd_shredb_entry_t) );
+    if( FD_UNLIKELY( err || !fd_shredb_entry_valid( rd_entry, store->evict_keys[ pos ] ) ) ) {
+      store->evict_occupied[ pos/64UL ] &= ~(1UL<<(pos%64UL));
+    }
+  }
+
+  store->write_head = pos;
+  store->seq        = seq;
+
+  /* Rebuild the maps, oldest entry first.  Each key is in the ring at
+     most once, but if it is not, keep the newest copy. */
+
+  for( ulong n=0UL; n<max_shreds; n++ ) {
+    ulong ring_idx = (pos+n) % max_shreds;
+    if( !fd_shredb_occupied( store, ring_idx ) ) continue;
+    ulong key = store->evict_keys[ ring_idx ];
+
+    fd_shredb_shred_entry_t * old = fd_shredb_shred_map_query( store->shred_map, key, NULL );
+    if( FD_UNLIKELY( old ) ) {
+      store->evict_occupied[ old->ring_idx/64UL ] &= ~(1UL<<(old->ring_idx%64UL));
+      fd_shredb_shred_map_remove( store->shred_map, old );
+      fd_shredb_slot_evict( store, fd_shredb_key_slot( key ), fd_shredb_key_shred_idx( key ) );
+      store->cnt--;
+    }
+    fd_shredb_index( store, key, ring_idx );
+  }
+
+  /* Persist the replayed keys right away. */
+
+  store->ckpt_seq  = c->seq;
+  store->ckpt_head = c->write_head;
+  store->ckpt_slot = best^1UL;
+  fd_shredb_checkpoint( store );
+
+  FD_LOG_NOTICE(( "recovered %lu shreds from shredb %s (%lu replayed)", store->cnt, file_path, replay_cnt ));
+  return 1;
+}
+
 void *
 fd_shredb_new( void       * shmem,
                ulong        max_size_gib,
                char const * file_path,
-               ulong        seed ) {
+               ulong        seed,
+               int          recover ) {
   if( FD_UNLIKELY( !shmem ) ) {
     FD_LOG_WARNING(( "NULL shmem" ));
     return NULL;
@@ -82,23 +326,29 @@ fd_shredb_new( void       * shmem,
   void * evict_k_mem   = FD_SCRATCH_ALLOC_APPEND( l, alignof(ulong),              max_shreds   * sizeof(ulong)                  );
   void * evict_o_mem   = FD_SCRATCH_ALLOC_APPEND( l, alignof(ulong),              bitset_words * sizeof(ulong)                  );
 
+  char idx_path[ PATH_MAX ];
+  if( FD_UNLIKELY( !fd_cstr_printf_check( idx_path, sizeof(idx_path), NULL, "%s.idx", file_path ) ) ) {
+    FD_LOG_WARNING(( "file_path too long (%s)", file_path ));
+    return NULL;
+  }
+
   fd_shredb_t * store = (fd_shredb_t *)shmem;
-  store->shred_map      = fd_shredb_shred_map_new( shred_map_mem, lg_shred_cnt, seed );
-  store->slot_map       = fd_shredb_slot_map_new ( slot_map_mem,  lg_slot_cnt,  seed );
+  store->shred_map      = fd_shredb_shred_map_join( fd_shredb_shred_map_new( shred_map_mem, lg_shred_cnt, seed ) );
+  store->slot_map       = fd_shredb_slot_map_join ( fd_shredb_slot_map_new ( slot_map_mem,  lg_slot_cnt,  seed ) );
   store->evict_keys     = (ulong *)evict_k_mem;
   store->evict_occupied = (ulong *)evict_o_mem;
   fd_memset( store->evict_occupied, 0, bitset_words * sizeof(ulong) );
 
-  int fd = open( file_path, O_RDWR | O_CREAT | O_TRUNC, (mode_t)0600 );
+  int flags = O_RDWR | O_CREAT | fd_int_if( recover, 0, O_TRUNC );
+  int fd = open( file_path, flags, (mode_t)0600 );
   if( FD_UNLIKELY( fd<0 ) ) {
     FD_LOG_WARNING(( "open(%s) failed (%i-%s)", file_path, errno, fd_io_strerror( errno ) ));
     return NULL;
   }
 
-  ulong initial_shreds = 128UL;
-  ulong initial_sz     = initial_shreds * sizeof(fd_shredb_entry_t);
-  if( FD_UNLIKELY( fallocate( fd, 0, 0, (off_t)initial_sz ) ) ) {
-    FD_LOG_WARNING(( "fallocate failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  int idx_fd = open( idx_path, flags, (mode_t)0600 );
+  if( FD_UNLIKELY( idx_fd<0 ) ) {
+    FD_LOG_WARNING(( "open(%s) failed (%i-%s)", idx_path, errno, fd_io_strerror( errno ) ));
     close( fd );
     return NULL;
   }
@@ -107,7 +357,29 @@ fd_shredb_new( void       * shmem,
   store->write_head  = 0UL;
   store->cnt         = 0UL;
   store->fd          = fd;
-  store->file_shreds = initial_shreds;
+  store->idx_fd      = idx_fd;
+  store->seq         = 1UL;
+  store->ckpt_seq    = 1UL;
+  store->ckpt_head   = 0UL;
+  store->ckpt_slot   = 0UL;
+
+  if( !recover || !fd_shredb_recover( store, file_path ) ) {
+    ulong initial_shreds = 128UL;
+    ulong initial_sz     = initial_shreds * sizeof(fd_shredb_entry_t);
+    uchar zero_hdr[ 2UL*FD_SHREDB_IDX_HDR_SZ ] = {0};
+    if( FD_UNLIKELY( ftruncate( fd, 0 ) ||
+                     fallocate( fd, 0, 0, (off_t)initial_sz ) ||
+                     fd_shredb_pwrite( idx_fd, zero_hdr, sizeof(zero_hdr), 0UL ) ) ) {
+      FD_LOG_WARNING(( "failed to initialize shredb files (%i-%s)", errno, fd_io_strerror( errno ) ));
+      close( idx_fd );
+      close( fd );
+      return NULL;
+    }
+    store->file_shreds = initial_shreds;
+  }
+
+  store->shred_map = fd_shredb_shred_map_leave( store->shred_map );
+  store->slot_map  = fd_shredb_slot_map_leave ( store->slot_map  );
 
   FD_TEST( FD_SCRATCH_ALLOC_FINI( l, fd_shredb_align() )==(ulong)shmem + footprint );
 
@@ -156,6 +428,7 @@ fd_shredb_delete( void * shstore ) {
   }
 
   fd_shredb_t * store = (fd_shredb_t *)shstore;
+  close( store->idx_fd );
   close( store->fd );
 
   return shstore;
@@ -227,33 +500,62 @@ fd_shredb_insert( fd_shredb_t      * store,
   }
 
   fd_shredb_entry_t wr_entry[1];
+  wr_entry->seq      = store->seq;
+  wr_entry->key      = key;
   wr_entry->shred_sz = (ushort)shred_sz;
   fd_memcpy( wr_entry->shred, shred, shred_sz );
+  wr_entry->hash     = fd_shredb_entry_hash( wr_entry );
 
   off_t off = (off_t)(store->write_head * sizeof(fd_shredb_entry_t));
   long res = pwrite( store->fd, wr_entry, sizeof(fd_shredb_entry_t), off );
   if( FD_UNLIKELY( res!=(long)sizeof(fd_shredb_entry_t) ) ) FD_LOG_ERR(( "error writing to shredb: (%d-%s)", errno, fd_io_strerror( errno ) ));
 
-  store->evict_keys    [ store->write_head ] = key;
-  store->evict_occupied[ wh_word ] |= (1UL << wh_bit);
+  fd_shredb_index( store, key, store->write_head );
 
-  fd_shredb_shred_entry_t * map_entry = fd_shredb_shred_map_insert( store->shred_map, key );
-  FD_TEST( map_entry );
-  map_entry->ring_idx = store->write_head;
+  store->seq++;
+  store->write_head = (store->write_head + 1UL) % store->max_shreds;
 
-  fd_shredb_slot_entry_t * se = fd_shredb_slot_map_query( store->slot_map, slot, NULL );
-  if( FD_LIKELY( se ) ) {
-    se->cnt++;
-    se->highest_shred_idx = fd_uint_max( se->highest_shred_idx, shred_idx );
+  if( FD_UNLIKELY( store->seq-store->ckpt_seq>=FD_SHREDB_CKPT_INTERVAL ) ) fd_shredb_checkpoint( store );
+}
+
+void
+fd_shredb_checkpoint( fd_shredb_t * store ) {
+  ulong max_shreds = store->max_shreds;
+  ulong write_cnt  = store->seq - store->ckpt_seq;
+  if( FD_UNLIKELY( !write_cnt ) ) return;
+
+  /* Flush the keys of ring positions written since the last checkpoint,
+     which is a contiguous (possibly wrapping) range from the
+     checkpointed write head.  These must be written before the header
+     that makes them reachable. */
+
+  int err = 0;
+  if( FD_UNLIKELY( write_cnt>=max_shreds ) ) {
+    err = fd_shredb_pwrite( store->idx_fd, store->evict_keys, max_shreds*sizeof(ulong), FD_SHREDB_IDX_KEYS_OFF );
   } else {
-    se = fd_shredb_slot_map_insert( store->slot_map, slot );
-    FD_TEST( se );
-    se->highest_shred_idx = shred_idx;
-    se->cnt               = 1UL;
+    ulong start = store->ckpt_head;
+    ulong cnt0  = fd_ulong_min( write_cnt, max_shreds-start );
+    err = fd_shredb_pwrite( store->idx_fd, store->evict_keys+start, cnt0*sizeof(ulong), FD_SHREDB_IDX_KEYS_OFF+start*sizeof(ulong) );
+    if( FD_LIKELY( !err && write_cnt>cnt0 ) ) {
+      err = fd_shredb_pwrite( store->idx_fd, store->evict_keys, (write_cnt-cnt0)*sizeof(ulong), FD_SHREDB_IDX_KEYS_OFF );
+    }
   }
-
-  store->cnt++;
-  store->write_head = (store->write_head + 1UL) % store->max_shreds;
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "error writing to shredb index: (%d-%s)", err, fd_io_strerror( err ) ));
+
+  fd_shredb_ckpt_t ckpt = {
+    .magic       = FD_SHREDB_IDX_MAGIC,
+    .max_shreds  = max_shreds,
+    .seq         = store->seq,
+    .write_head  = store->write_head,
+    .file_shreds = store->file_shreds,
+  };
+  ckpt.hash = fd_shredb_ckpt_hash( &ckpt );
+  err = fd_shredb_pwrite( store->idx_fd, &ckpt, sizeof(fd_shredb_ckpt_t), store->ckpt_slot*FD_SHREDB_IDX_HDR_SZ );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "error writing to shredb index: (%d-%s)", err, fd_io_strerror( err ) ));
+
+  store->ckpt_seq   = store->seq;
+  store->ckpt_head  = store->write_head;
+  store->ckpt_slot ^= 1UL;
 }
 
 int
@@ -272,6 +574,7 @@ fd_shredb_query( fd_shredb_t * store,
   off_t off = (off_t)(map_entry->ring_idx * sizeof(fd_shredb_entry_t));
   long res = pread( store->fd, rd_entry, sizeof(fd_shredb_entry_t), off );
   if( FD_UNLIKELY( res!=(long)sizeof(fd_shredb_entry_t) ) ) FD_LOG_ERR(( "error reading from shredb: (%d-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( !fd_shredb_entry_valid( rd_entry, key ) ) ) return -1; /* Damaged entry. */
 
   fd_memcpy( out, rd_entry->shred, rd_entry->shred_sz );
   return rd_entry->shred_sz;
@@ -295,6 +598,7 @@ int fd_shredb_query_highest( fd_shredb_t * store,
   off_t off = (off_t)(map_entry->ring_idx * sizeof(fd_shredb_entry_t));
   long res = pread( store->fd, rd_entry, sizeof(fd_shredb_entry_t), off );
   if( FD_UNLIKELY( res!=(long)sizeof(fd_shredb_entry_t) ) ) FD_LOG_ERR(( "error reading from shredb: (%d-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( !fd_shredb_entry_valid( rd_entry, key ) ) ) return -1; /* Damaged entry. */
 
   fd_memcpy( out, rd_entry->shred, rd_entry->shred_sz );
   return rd_entry->shred_sz;
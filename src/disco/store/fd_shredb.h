@@ -17,7 +17,24 @@
    of shred entries. FIFO evicition by advancing the write head allows us
    to retain only the newest entries.
 
-   NOTE: For now, this design does not have any WAL or crash recovery.
+   The store survives restarts.  Every ring entry records its key and
+   an insert sequence number and is checksummed, so the ring file is
+   itself a replayable append log.  Every FD_SHREDB_CKPT_INTERVAL
+   inserts, the keys of the ring positions written since the last
+   checkpoint are flushed to an index file next to the ring file
+   (file_path with a ".idx" suffix), followed by a small checkpoint
+   header (write head and sequence number), alternating between two
+   header slots so a torn header write leaves the previous one intact.
+
+   On restart, the newest valid header is loaded along with the ring
+   keys, entries written after the checkpoint are replayed from the
+   ring until the first one with an unexpected sequence number or a bad
+   checksum (e.g. the write in progress when the process died), and
+   both maps are rebuilt from the keys.  This reads the index file plus
+   at most one checkpoint interval of ring entries, so a full store is
+   re-adopted in seconds.  The files are never fsync'd, so recovery
+   covers the process dying, not the host losing power; queries check
+   the entry checksum before returning anything though.
 
    NOTE: In the current design, the rserve tile subscribes to the
    shred_out link for getting the shreds, but we may have the shred tile
@@ -76,8 +93,17 @@ typedef struct fd_shredb_slot_entry fd_shredb_slot_entry_t;
 #define MAP_KEY_EQUAL_IS_SLOW 0
 #include "../../util/tmpl/fd_map_dynamic.c"
 
+/* FD_SHREDB_CKPT_INTERVAL is the number of inserts between index
+   checkpoints, which bounds the number of ring entries replayed on
+   recovery. */
+
+#define FD_SHREDB_CKPT_INTERVAL (4096UL)
+
 /* On-disk ring buffer entry. */
 struct __attribute__((aligned(64))) fd_shredb_entry {
+  ulong  seq;                     /* insert sequence number, 0 if never written */
+  ulong  key;                     /* (slot,shred_idx) of the shred */
+  ulong  hash;                    /* checksum of the other fields */
   ushort shred_sz;                /* actual shred byte count */
   uchar  shred[FD_SHRED_MAX_SZ];
 };
@@ -90,6 +116,12 @@ struct fd_shredb {
   int    fd;                          /* file descriptor for the backing file */
   ulong  file_shreds;                 /* current file capacity in shred entries */
 
+  int    idx_fd;                      /* file descriptor for the index file */
+  ulong  seq;                         /* sequence number of the next insert */
+  ulong  ckpt_seq;                    /* seq as of the last checkpoint */
+  ulong  ckpt_head;                   /* write_head as of the last checkpoint */
+  ulong  ckpt_slot;                   /* index file header slot for the next checkpoint */
+
   ulong * evict_keys;                 /* ring_idx -> (slot,shred_idx) */
   ulong * evict_occupied;             /* bit ring_idx is set if entry holds data */
 
@@ -108,11 +140,20 @@ fd_shredb_align( void ) {
 FD_FN_CONST ulong
 fd_shredb_footprint( ulong max_size_gib );
 
+/* fd_shredb_new formats a memory region for use as a shredb backed by
+   the file at file_path and its index file.  If recover is zero, both
+   files are truncated and the store starts empty.  Otherwise, the
+   contents of a store previously written to file_path are re-adopted
+   (see above).  If there is nothing usable to recover, for example the
+   files do not exist or were written with a different max_size_gib,
+   the store starts empty. */
+
 void *
 fd_shredb_new( void       * shmem,
                ulong        max_size_gib,
                char const * file_path,
-               ulong        seed );
+               ulong        seed,
+               int          recover );
 
 fd_shredb_t *
 fd_shredb_join( void * shstore );
@@ -129,6 +170,15 @@ void
 fd_shredb_insert( fd_shredb_t      * store,
                   fd_shred_t const * shred );
 
+/* fd_shredb_checkpoint flushes the keys of all ring entries written
+   since the last checkpoint to the index file, and then records the
+   current write head, so a later recovery only needs to replay entries
+   inserted after this point.  Called automatically by insert every
+   FD_SHREDB_CKPT_INTERVAL shreds. */
+
+void
+fd_shredb_checkpoint( fd_shredb_t * store );
+
 /* Given a (slot, shred_index), returns the corresponding entry.
    If no entry was found, returns -1, otherwise returns the amount
    of bytes written to out. */
@@ -1,10 +1,16 @@
+#define _GNU_SOURCE
 #include "../../util/fd_util.h"
 #include "fd_shredb.h"
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
-#define TEST_FILE "/tmp/test_shredb.bin"
+#define TEST_FILE     "/tmp/test_shredb.bin"
+#define TEST_IDX_FILE "/tmp/test_shredb.bin.idx"
 #define TEST_SEED 42UL
 
 static fd_shred_t *
@@ -34,14 +40,14 @@ fill_payload( uchar * payload,
 }
 
 static fd_shredb_t *
-setup_store( void ** out_mem, ulong max_size_gib ) {
+open_store( void ** out_mem, ulong max_size_gib, int recover ) {
   ulong footprint = fd_shredb_footprint( max_size_gib );
   FD_TEST( footprint );
   void * mem = aligned_alloc( fd_shredb_align(), footprint );
   FD_TEST( mem );
   fd_memset( mem, 0, footprint );
 
-  void * shmem = fd_shredb_new( mem, max_size_gib, TEST_FILE, TEST_SEED );
+  void * shmem = fd_shredb_new( mem, max_size_gib, TEST_FILE, TEST_SEED, recover );
   FD_TEST( shmem );
 
   fd_shredb_t * store = fd_shredb_join( shmem );
@@ -51,12 +57,23 @@ setup_store( void ** out_mem, ulong max_size_gib ) {
   return store;
 }
 
+static fd_shredb_t *
+setup_store( void ** out_mem, ulong max_size_gib ) {
+  return open_store( out_mem, max_size_gib, 0 );
+}
+
 static void
-teardown_store( fd_shredb_t * store, void * mem ) {
+close_store( fd_shredb_t * store, void * mem ) {
   fd_shredb_leave( store );
   fd_shredb_delete( mem );
   free( mem );
+}
+
+static void
+teardown_store( fd_shredb_t * store, void * mem ) {
+  close_store( store, mem );
   unlink( TEST_FILE );
+  unlink( TEST_IDX_FILE );
 }
 
 static void
@@ -252,6 +269,142 @@ test_many_wraps( void ) {
   teardown_store( store, mem );
 }
 
+/* The recovery tests insert shred i as (slot i/32, idx i%32) with a
+   payload size that varies with i. */
+
+static ulong
+recover_payload_sz( ulong i ) {
+  return 1UL + (i*7UL)%128UL;
+}
+
+static void
+recover_insert( fd_shredb_t * store,
+                ulong         i ) {
+  uchar payload[ 128 ];
+  ulong payload_sz = recover_payload_sz( i );
+  fill_payload( payload, payload_sz, i/32UL, (uint)(i%32UL) );
+  insert_shred( store, i/32UL, (uint)(i%32UL), payload, payload_sz );
+}
+
+static void
+recover_check( fd_shredb_t * store,
+               ulong         cnt ) {
+  uchar payload[ 128 ];
+  uchar out[ FD_SHRED_MAX_SZ ];
+
+  FD_TEST( store->cnt==cnt );
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong payload_sz = recover_payload_sz( i );
+    fill_payload( payload, payload_sz, i/32UL, (uint)(i%32UL) );
+    int ret = fd_shredb_query( store, i/32UL, (uint)(i%32UL), out );
+    FD_TEST( ret==(int)(payload_sz + FD_SHRED_DATA_HEADER_SZ) );
+    FD_TEST( !memcmp( out + FD_SHRED_DATA_HEADER_SZ, payload, payload_sz ) );
+  }
+  FD_TEST( fd_shredb_query( store, cnt/32UL, (uint)(cnt%32UL), out )==-1 );
+
+  /* The highest shred of the last slot is the last one inserted. */
+  ulong last = cnt-1UL;
+  FD_TEST( fd_shredb_query_highest( store, last/32UL, 0U, out )==(int)(recover_payload_sz( last ) + FD_SHRED_DATA_HEADER_SZ) );
+  FD_TEST( ((fd_shred_t const *)out)->idx==(uint)(last%32UL) );
+}
+
+static void
+test_recover_clean( void ) {
+  FD_LOG_NOTICE(( "TEST recover after clean close" ));
+
+  void * mem;
+  fd_shredb_t * store = setup_store( &mem, 1UL );
+
+  /* Not a multiple of the checkpoint interval, so some entries are
+     only reachable through the replay. */
+  ulong cnt = 3UL*FD_SHREDB_CKPT_INTERVAL + 1000UL;
+  for( ulong i=0UL; i<cnt; i++ ) recover_insert( store, i );
+  close_store( store, mem );
+
+  store = open_store( &mem, 1UL, 1 );
+  FD_TEST( store->write_head==cnt );
+  recover_check( store, cnt );
+
+  /* Recovered store keeps working, and recovers again. */
+  for( ulong i=cnt; i<cnt+500UL; i++ ) recover_insert( store, i );
+  fd_shredb_checkpoint( store );
+  close_store( store, mem );
+
+  store = open_store( &mem, 1UL, 1 );
+  recover_check( store, cnt+500UL );
+  close_store( store, mem );
+
+  /* A mismatched store size or a missing index starts empty. */
+  store = open_store( &mem, 2UL, 1 );
+  FD_TEST( store->cnt==0UL );
+  close_store( store, mem );
+  unlink( TEST_IDX_FILE );
+  store = open_store( &mem, 1UL, 1 );
+  FD_TEST( store->cnt==0UL );
+  teardown_store( store, mem );
+}
+
+static void
+test_recover_crash( void ) {
+  FD_LOG_NOTICE(( "TEST recover after crash" ));
+
+  unlink( TEST_FILE );
+  unlink( TEST_IDX_FILE );
+
+  /* The child inserts shreds until it is killed, publishing the number
+     of completed inserts in shared memory.  The kill lands at an
+     arbitrary point, typically in the middle of an insert or a
+     checkpoint. */
+
+  ulong volatile * done = mmap( NULL, 4096UL, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0 );
+  FD_TEST( done!=MAP_FAILED );
+  *done = 0UL;
+
+  pid_t pid = fork();
+  FD_TEST( pid>=0 );
+  if( !pid ) {
+    void * mem;
+    fd_shredb_t * store = setup_store( &mem, 1UL );
+    for( ulong i=0UL; ; i++ ) {
+      recover_insert( store, i );
+      FD_COMPILER_MFENCE();
+      *done = i+1UL;
+    }
+  }
+
+  ulong target = 5UL*FD_SHREDB_CKPT_INTERVAL + (fd_ulong_hash( (ulong)fd_log_wallclock() ) % FD_SHREDB_CKPT_INTERVAL);
+  while( *done<target ) FD_SPIN_PAUSE();
+  FD_TEST( !kill( pid, SIGKILL ) );
+  int wstatus;
+  FD_TEST( waitpid( pid, &wstatus, 0 )==pid );
+  FD_TEST( WIFSIGNALED( wstatus ) );
+  ulong cnt = *done;
+  FD_LOG_NOTICE(( "killed writer after %lu inserts", cnt ));
+
+  /* The child may or may not have finished the insert after the last
+     one it published.  Tear it, so the result is deterministic.  The
+     garbage covers the seq/key/hash header, as the checksum does not
+     cover the shred bytes past shred_sz. */
+  int fd = open( TEST_FILE, O_RDWR );
+  FD_TEST( fd>=0 );
+  uchar garbage[ 512 ];
+  memset( garbage, 0x5a, sizeof(garbage) );
+  FD_TEST( pwrite( fd, garbage, sizeof(garbage), (off_t)(cnt*sizeof(fd_shredb_entry_t)) )==(long)sizeof(garbage) );
+  close( fd );
+
+  void * mem;
+  fd_shredb_t * store = open_store( &mem, 1UL, 1 );
+  FD_TEST( store->write_head==cnt );
+  recover_check( store, cnt );
+
+  /* The torn entry is overwritten by the next insert. */
+  recover_insert( store, cnt );
+  recover_check( store, cnt+1UL );
+
+  teardown_store( store, mem );
+  FD_TEST( !munmap( (void *)done, 4096UL ) );
+}
+
 static void
 bench_insert( void ) {
   void * mem;
@@ -365,6 +518,8 @@ main( int argc, char ** argv ) {
   test_multiple_shreds_same_slot();
   test_multiple_slots();
   test_many_wraps();
+  test_recover_clean();
+  test_recover_crash();
 
   bench_insert();
   bench_query_hit();
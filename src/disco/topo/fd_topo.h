@@ -208,6 +208,8 @@ struct fd_topo_tile {
       /* sock specific options */
       int so_sndbuf;
       int so_rcvbuf;
+      int udp_gso;
+      int udp_gro;
     } sock;
 
     struct {
@@ -423,6 +425,15 @@ struct fd_topo_tile {
       char identity_key_path[ PATH_MAX ];
       int  delay_startup;
 
+      ulong account_index_max;
+
+      ulong transaction_status_max;
+      char  txnstatus_path[ PATH_MAX ];
+
+      ulong block_archive_max;
+      ulong block_cache_sz;
+      char  blocks_path[ PATH_MAX ];
+
       int    snapshot_server_enabled;
       char   snapshot_server_host[ 256 ];
       ushort snapshot_server_port;
@@ -455,6 +466,8 @@ struct fd_topo_tile {
 
       ulong heap_size_gib;
       ulong sched_depth;
+      ulong prefetch_lookahead_depth;
+      int   cost_aware_dispatch;
       ulong max_live_slots;
       ulong full_snapshot_interval_slots;
       ulong incremental_snapshot_interval_slots;
@@ -502,6 +515,9 @@ struct fd_topo_tile {
       int   dump_txn_as_fixture;
       int   dump_syscall_to_pb;
       int   report_transaction_diffs;
+      ulong jit_slot_cnt;
+      ulong jit_slot_sz;
+      ulong accdb_io_uring_depth;
     } execrp;
 
     struct {
@@ -654,6 +670,7 @@ struct fd_topo_tile {
       ulong txncache_obj_id;
       ulong banks_obj_id;
       int   alpenglow;
+      int   verify_lthash;
     } snapin;
 
     struct {
@@ -676,6 +693,9 @@ struct fd_topo_tile {
       ulong progcache_obj_id;
       ulong accdb_obj_id;
       int   report_transaction_diffs;
+      ulong jit_slot_cnt;
+      ulong jit_slot_sz;
+      ulong accdb_io_uring_depth;
     } execle;
 
     struct {
@@ -7,7 +7,6 @@
 
 struct fd_txncache_writer_blockcache {
   fd_txncache_blockcache_shmem_t * shmem;
-  uint *           heads;
   ushort *         pages;
   descends_set_t * descends;
 };
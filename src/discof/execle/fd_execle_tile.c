@@ -61,6 +61,9 @@ struct fd_execle_tile {
   fd_accdb_t * accdb;
 
   fd_progcache_t  progcache[1];
+  void *          jit_mem;      /* local JIT slots, writable view (NULL if JIT disabled) */
+  void const *    jit_exec_mem; /* executable view of the same slots */
+  fd_io_uring_t   ioring[1]; /* accdb cold reads (ioring_fd==-1 if disabled) */
 
   fd_runtime_t runtime[1];
 
@@ -112,6 +115,7 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND( l, fd_txncache_align(),         fd_txncache_footprint( tile->execle.max_live_slots ) );
   l = FD_LAYOUT_APPEND( l, fd_accdb_align(),            fd_accdb_footprint( tile->execle.max_live_slots ) );
   l = FD_LAYOUT_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN,  FD_PROGCACHE_SCRATCH_FOOTPRINT );
+  l = FD_LAYOUT_APPEND( l, fd_accdb_io_uring_align(),   fd_accdb_io_uring_footprint( tile->execle.accdb_io_uring_depth ) );
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
@@ -151,6 +155,12 @@ metrics_write( fd_execle_tile_t * ctx ) {
   FD_MCNT_SET( EXECLE, PROGCACHE_EVICTION_BYTES,         pm->evict_tot_sz   );
   FD_MCNT_SET( EXECLE, PROGCACHE_DURATION_SECONDS,       pm->cum_pull_ticks );
   FD_MCNT_SET( EXECLE, PROGCACHE_LOAD_DURATION_SECONDS,  pm->cum_load_ticks );
+  FD_MCNT_SET( EXECLE, PROGCACHE_JIT_FILL,               pm->jit_fill_cnt    );
+  FD_MCNT_SET( EXECLE, PROGCACHE_JIT_FILL_BYTES,         pm->jit_fill_tot_sz );
+  FD_MCNT_SET( EXECLE, PROGCACHE_JIT_FAIL,               pm->jit_fail_cnt    );
+  FD_MCNT_SET( EXECLE, PROGCACHE_JIT_HIT,                pm->jit_hit_cnt     );
+  FD_MCNT_SET( EXECLE, PROGCACHE_JIT_MISS,               pm->jit_miss_cnt    );
+  FD_MCNT_SET( EXECLE, PROGCACHE_JIT_MISS_BYTES,         pm->jit_miss_tot_sz );
 
   FD_ACCDB_METRICS_WRITE( EXECLE, fd_accdb_metrics( ctx->accdb ) );
 }
@@ -754,8 +764,24 @@ privileged_init( fd_topo_t const *      topo,
   void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
 
   FD_SCRATCH_ALLOC_INIT( l, scratch );
-  fd_execle_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_execle_tile_t), sizeof(fd_execle_tile_t) );
+  fd_execle_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_execle_tile_t),  sizeof(fd_execle_tile_t) );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, FD_BLAKE3_ALIGN,            FD_BLAKE3_FOOTPRINT );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, FD_BMTREE_COMMIT_ALIGN,     FD_BMTREE_COMMIT_FOOTPRINT(0) );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, fd_txncache_align(),        fd_txncache_footprint( tile->execle.max_live_slots ) );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_align(),           fd_accdb_footprint( tile->execle.max_live_slots ) );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN, FD_PROGCACHE_SCRATCH_FOOTPRINT );
   FD_TEST( fd_rng_secure( &ctx->rebate_seed, sizeof(ctx->rebate_seed) ) );
+
+  /* The accdb io_uring is created (and restricted to reads of the
+     accounts file) before the tile is sandboxed */
+
+  void * ring_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_io_uring_align(), fd_accdb_io_uring_footprint( tile->execle.accdb_io_uring_depth ) );
+  fd_accdb_io_uring_setup( ctx->ioring, ring_mem, tile->execle.accdb_io_uring_depth, FD_ACCDB_FD_RW );
+
+  /* JIT slots need executable memory, which can no longer be mapped
+     once the tile is sandboxed */
+
+  fd_progcache_jit_map( tile->execle.jit_slot_cnt, tile->execle.jit_slot_sz, &ctx->jit_mem, &ctx->jit_exec_mem );
 }
 
 static void
@@ -770,6 +796,7 @@ unprivileged_init( fd_topo_t const *      topo,
   void * _txncache       = FD_SCRATCH_ALLOC_APPEND( l, fd_txncache_align(),        fd_txncache_footprint( tile->execle.max_live_slots ) );
   void * _accdb          = FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_align(),           fd_accdb_footprint( tile->execle.max_live_slots ) );
   void * pc_scratch      = FD_SCRATCH_ALLOC_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN, FD_PROGCACHE_SCRATCH_FOOTPRINT );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_io_uring_align(),  fd_accdb_io_uring_footprint( tile->execle.accdb_io_uring_depth ) );
 
 #define NONNULL( x ) (__extension__({                                        \
       __typeof__((x)) __x = (x);                                             \
@@ -786,6 +813,9 @@ unprivileged_init( fd_topo_t const *      topo,
   FD_TEST( fd_progcache_join( ctx->progcache,
       fd_topo_obj_laddr( topo, tile->execle.progcache_obj_id ),
       pc_scratch, FD_PROGCACHE_SCRATCH_FOOTPRINT ) );
+  if( ctx->jit_mem ) {
+    FD_TEST( fd_progcache_jit_attach( ctx->progcache, ctx->jit_mem, ctx->jit_exec_mem, tile->execle.jit_slot_cnt, tile->execle.jit_slot_sz ) );
+  }
 
   void * _txncache_shmem = fd_topo_obj_laddr( topo, tile->execle.txncache_obj_id );
   fd_txncache_shmem_t * txncache_shmem = fd_txncache_shmem_join( _txncache_shmem );
@@ -798,6 +828,9 @@ unprivileged_init( fd_topo_t const *      topo,
   FD_TEST( accdb_shmem );
   ctx->accdb = fd_accdb_join( fd_accdb_new( _accdb, accdb_shmem, FD_ACCDB_FD_RW, 0UL, NULL ) );
   FD_TEST( ctx->accdb );
+  if( ctx->ioring->ioring_fd>=0 ) {
+    FD_TEST( fd_accdb_attach_io_uring( ctx->accdb, ctx->ioring ) );
+  }
 
   for( ulong i=0UL; i<FD_PACK_MAX_TXN_PER_BUNDLE; i++ ) {
     ctx->txn_in[ i ].bundle.prev_txn_cnt = i;
@@ -852,10 +885,9 @@ populate_allowed_seccomp( fd_topo_t const *      topo,
                           fd_topo_tile_t const * tile,
                           ulong                  out_cnt,
                           struct sock_filter *   out ) {
-  (void)topo;
-  (void)tile;
+  fd_execle_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
 
-  populate_sock_filter_policy_fd_execle_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), FD_ACCDB_FD_RW );
+  populate_sock_filter_policy_fd_execle_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), FD_ACCDB_FD_RW, (uint)ctx->ioring->ioring_fd );
   return sock_filter_policy_fd_execle_tile_instr_cnt;
 }
 
@@ -864,16 +896,17 @@ populate_allowed_fds( fd_topo_t const *      topo,
                       fd_topo_tile_t const * tile,
                       ulong                  out_fds_cnt,
                       int *                  out_fds ) {
-  (void)topo;
-  (void)tile;
+  fd_execle_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
 
-  if( FD_UNLIKELY( out_fds_cnt<3UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+  if( FD_UNLIKELY( out_fds_cnt<4UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
 
   ulong out_cnt = 0UL;
   out_fds[ out_cnt++ ] = 2; /* stderr */
   if( FD_LIKELY( -1!=fd_log_private_logfile_fd() ) )
     out_fds[ out_cnt++ ] = fd_log_private_logfile_fd(); /* logfile */
   out_fds[ out_cnt++ ] = FD_ACCDB_FD_RW; /* accounts db */
+  if( ctx->ioring->ioring_fd>=0 )
+    out_fds[ out_cnt++ ] = ctx->ioring->ioring_fd; /* accdb io_uring */
 
   return out_cnt;
 }
@@ -61,6 +61,9 @@ struct fd_execrp_tile {
   fd_accdb_t *    accdb;
   fd_txncache_t * txncache;
   fd_progcache_t  progcache[1];
+  void *          jit_mem;      /* local JIT slots, writable view (NULL if JIT disabled) */
+  void const *    jit_exec_mem; /* executable view of the same slots */
+  fd_io_uring_t   ioring[1]; /* accdb cold reads (ioring_fd==-1 if disabled) */
 
   ulong txn_idx;
   ulong slot;
@@ -111,6 +114,8 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND(   l, fd_accdb_align(),             fd_accdb_footprint( tile->execrp.max_live_slots )    );
   l = FD_LAYOUT_APPEND(   l, FD_PROGCACHE_SCRATCH_ALIGN,   FD_PROGCACHE_SCRATCH_FOOTPRINT                       );
 
+  l = FD_LAYOUT_APPEND(   l, fd_accdb_io_uring_align(),    fd_accdb_io_uring_footprint( tile->execrp.accdb_io_uring_depth ) );
+
   if( FD_UNLIKELY( strlen( tile->execrp.solcap_capture ) ) ) {
     l = FD_LAYOUT_APPEND( l, fd_capture_ctx_align(),       fd_capture_ctx_footprint()                           );
   }
@@ -148,6 +153,12 @@ metrics_write( fd_execrp_tile_t * ctx ) {
   FD_MCNT_SET( EXECRP, PROGCACHE_EVICTION_BYTES,         pm->evict_tot_sz   );
   FD_MCNT_SET( EXECRP, PROGCACHE_DURATION_SECONDS,       pm->cum_pull_ticks );
   FD_MCNT_SET( EXECRP, PROGCACHE_LOAD_DURATION_SECONDS,  pm->cum_load_ticks );
+  FD_MCNT_SET( EXECRP, PROGCACHE_JIT_FILL,               pm->jit_fill_cnt    );
+  FD_MCNT_SET( EXECRP, PROGCACHE_JIT_FILL_BYTES,         pm->jit_fill_tot_sz );
+  FD_MCNT_SET( EXECRP, PROGCACHE_JIT_FAIL,               pm->jit_fail_cnt    );
+  FD_MCNT_SET( EXECRP, PROGCACHE_JIT_HIT,                pm->jit_hit_cnt     );
+  FD_MCNT_SET( EXECRP, PROGCACHE_JIT_MISS,               pm->jit_miss_cnt    );
+  FD_MCNT_SET( EXECRP, PROGCACHE_JIT_MISS_BYTES,         pm->jit_miss_tot_sz );
 
   FD_MCNT_SET( EXECRP, TXN_REGIME_DURATION_NANOS_SETUP,  ctx->metrics.txn_load_cum_ticks+ctx->metrics.txn_check_cum_ticks );
   FD_MCNT_SET( EXECRP, TXN_REGIME_DURATION_NANOS_EXEC,   ctx->metrics.txn_exec_cum_ticks    );
@@ -178,6 +189,9 @@ publish_txn_finalized_msg( fd_execrp_tile_t *  ctx,
   msg->txn_exec->is_committable  = ctx->txn_out.err.is_committable;
   msg->txn_exec->is_fees_only    = ctx->txn_out.err.is_fees_only;
   msg->txn_exec->txn_err         = ctx->txn_out.err.txn_err;
+  msg->txn_exec->exec_err        = ctx->txn_out.err.exec_err;
+  msg->txn_exec->exec_err_idx    = ctx->txn_out.err.exec_err_idx;
+  msg->txn_exec->custom_err      = ctx->txn_out.err.custom_err;
   msg->txn_exec->slot            = ctx->slot;
   msg->txn_exec->bank_seq        = ctx->bank->bank_seq;
   msg->txn_exec->start_shred_idx = ctx->txn_in.txn->start_shred_idx;
@@ -338,6 +352,29 @@ returnable_frag( fd_execrp_tile_t *  ctx,
 
 extern FD_TL int fd_wksp_oom_silent;
 
+static void
+privileged_init( fd_topo_t const *      topo,
+                 fd_topo_tile_t const * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_execrp_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_execrp_tile_t),    sizeof(fd_execrp_tile_t)                             );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, fd_txncache_align(),          fd_txncache_footprint( tile->execrp.max_live_slots ) );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_align(),             fd_accdb_footprint( tile->execrp.max_live_slots )    );
+  /*                */(void)FD_SCRATCH_ALLOC_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN,   FD_PROGCACHE_SCRATCH_FOOTPRINT                       );
+
+  /* The accdb io_uring is created (and restricted to reads of the
+     accounts file) before the tile is sandboxed */
+
+  void * ring_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_io_uring_align(), fd_accdb_io_uring_footprint( tile->execrp.accdb_io_uring_depth ) );
+  fd_accdb_io_uring_setup( ctx->ioring, ring_mem, tile->execrp.accdb_io_uring_depth, FD_ACCDB_FD_RW );
+
+  /* JIT slots need executable memory, which can no longer be mapped
+     once the tile is sandboxed */
+
+  fd_progcache_jit_map( tile->execrp.jit_slot_cnt, tile->execrp.jit_slot_sz, &ctx->jit_mem, &ctx->jit_exec_mem );
+}
+
 static void
 unprivileged_init( fd_topo_t const *      topo,
                    fd_topo_tile_t const * tile ) {
@@ -349,6 +386,8 @@ unprivileged_init( fd_topo_t const *      topo,
   void * _accdb             = FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_align(),             fd_accdb_footprint( tile->execrp.max_live_slots )    );
   uchar * pc_scratch        = FD_SCRATCH_ALLOC_APPEND( l, FD_PROGCACHE_SCRATCH_ALIGN,   FD_PROGCACHE_SCRATCH_FOOTPRINT                       );
 
+  /*                    */(void)FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_io_uring_align(),    fd_accdb_io_uring_footprint( tile->execrp.accdb_io_uring_depth ) );
+
   void * _capture_ctx = NULL;
   if( FD_UNLIKELY( strlen( tile->execrp.solcap_capture ) ) ) {
     _capture_ctx            = FD_SCRATCH_ALLOC_APPEND( l, fd_capture_ctx_align(),       fd_capture_ctx_footprint()                           );
@@ -381,6 +420,9 @@ unprivileged_init( fd_topo_t const *      topo,
   FD_TEST( ctx->banks );
 
   FD_TEST( fd_progcache_join( ctx->progcache, fd_topo_obj_laddr( topo, tile->execrp.progcache_obj_id ), pc_scratch, FD_PROGCACHE_SCRATCH_FOOTPRINT ) );
+  if( ctx->jit_mem ) {
+    FD_TEST( fd_progcache_jit_attach( ctx->progcache, ctx->jit_mem, ctx->jit_exec_mem, tile->execrp.jit_slot_cnt, tile->execrp.jit_slot_sz ) );
+  }
 
   void * _txncache_shmem = fd_topo_obj_laddr( topo, tile->execrp.txncache_obj_id );
   fd_txncache_shmem_t * txncache_shmem = fd_txncache_shmem_join( _txncache_shmem );
@@ -393,6 +435,9 @@ unprivileged_init( fd_topo_t const *      topo,
   FD_TEST( accdb_shmem );
   ctx->accdb = fd_accdb_join( fd_accdb_new( _accdb, accdb_shmem, FD_ACCDB_FD_RW, 0UL, NULL ) );
   FD_TEST( ctx->accdb );
+  if( ctx->ioring->ioring_fd>=0 ) {
+    FD_TEST( fd_accdb_attach_io_uring( ctx->accdb, ctx->ioring ) );
+  }
 
 
   /* First find and setup the in-link from replay to exec. */
@@ -516,21 +561,24 @@ unprivileged_init( fd_topo_t const *      topo,
 }
 
 static ulong
-populate_allowed_seccomp( fd_topo_t const *      topo FD_PARAM_UNUSED,
-                          fd_topo_tile_t const * tile FD_PARAM_UNUSED,
+populate_allowed_seccomp( fd_topo_t const *      topo,
+                          fd_topo_tile_t const * tile,
                           ulong                  out_cnt,
                           struct sock_filter *   out ) {
-  populate_sock_filter_policy_fd_execrp_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)FD_ACCDB_FD_RW );
+  fd_execrp_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+  populate_sock_filter_policy_fd_execrp_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)FD_ACCDB_FD_RW, (uint)ctx->ioring->ioring_fd );
   return sock_filter_policy_fd_execrp_tile_instr_cnt;
 }
 
 static ulong
-populate_allowed_fds( fd_topo_t const *      topo FD_PARAM_UNUSED,
-                      fd_topo_tile_t const * tile FD_PARAM_UNUSED,
+populate_allowed_fds( fd_topo_t const *      topo,
+                      fd_topo_tile_t const * tile,
                       ulong                  out_fds_cnt,
                       int *                  out_fds ) {
 
-  if( FD_UNLIKELY( out_fds_cnt<3UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+  if( FD_UNLIKELY( out_fds_cnt<4UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+
+  fd_execrp_tile_t const * ctx = fd_topo_obj_laddr( topo, tile->tile_obj_id );
 
   ulong out_cnt = 0UL;
   out_fds[ out_cnt++ ] = 2; /* stderr */
@@ -538,6 +586,9 @@ populate_allowed_fds( fd_topo_t const *      topo FD_PARAM_UNUSED,
     out_fds[ out_cnt++ ] = fd_log_private_logfile_fd(); /* logfile */
   }
   out_fds[ out_cnt++ ] = FD_ACCDB_FD_RW; /* accounts db */
+  if( ctx->ioring->ioring_fd>=0 ) {
+    out_fds[ out_cnt++ ] = ctx->ioring->ioring_fd; /* accdb io_uring */
+  }
 
   return out_cnt;
 }
@@ -574,6 +625,7 @@ fd_topo_run_tile_t fd_tile_execrp = {
   .populate_allowed_fds     = populate_allowed_fds,
   .scratch_align            = scratch_align,
   .scratch_footprint        = scratch_footprint,
+  .privileged_init          = privileged_init,
   .unprivileged_init        = unprivileged_init,
   .run                      = stem_run,
 };
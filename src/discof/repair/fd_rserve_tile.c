@@ -516,7 +516,7 @@ privileged_init( fd_topo_t      const * topo,
   FD_TEST( fd_rng_secure( &ctx->seed, sizeof(ulong) ) );
 
   FD_LOG_INFO(( "creating shredb (size_limit=%luGiB)", size_limit ));
-  ctx->shredb = fd_shredb_join( fd_shredb_new( ctx->shredb, size_limit, tile->rserve.shredb_path, ctx->seed ) );
+  ctx->shredb = fd_shredb_join( fd_shredb_new( ctx->shredb, size_limit, tile->rserve.shredb_path, ctx->seed, 1 ) );
   if( FD_UNLIKELY( !ctx->shredb ) ) FD_LOG_ERR(( "failed to initialize shredb" ));
 
   uchar const * identity_public_key = fd_keyload_load( tile->rserve.identity_key_path, /* pubkey only: */ 1 );
@@ -542,6 +542,7 @@ unprivileged_init( fd_topo_t      const * topo,
   FD_TEST( ctx->keyswitch );
 
   fd_memset( ctx->metrics, 0, sizeof(ctx->metrics) );
+  ctx->metrics->shreds_current = ctx->shredb->cnt; /* Recovered from a previous run */
   FD_MGAUGE_SET( RSERVE, SHREDS_MAX, ctx->shredb->max_shreds );
 
   ctx->halt_signing = 0;
@@ -606,7 +607,7 @@ populate_allowed_seccomp( fd_topo_t const *      topo FD_PARAM_UNUSED,
   void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   ctx_t * ctx     = FD_SCRATCH_ALLOC_APPEND( l, alignof(ctx_t), sizeof(ctx_t) );
-  populate_sock_filter_policy_fd_rserve_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)ctx->shredb->fd );
+  populate_sock_filter_policy_fd_rserve_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)ctx->shredb->fd, (uint)ctx->shredb->idx_fd );
   return sock_filter_policy_fd_rserve_tile_instr_cnt;
 }
 
@@ -619,13 +620,14 @@ populate_allowed_fds( fd_topo_t const *      topo FD_PARAM_UNUSED,
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   ctx_t * ctx     = FD_SCRATCH_ALLOC_APPEND( l, alignof(ctx_t), sizeof(ctx_t) );
 
-  if( FD_UNLIKELY( out_fds_cnt<3UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+  if( FD_UNLIKELY( out_fds_cnt<4UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
 
   ulong out_cnt = 0UL;
   out_fds[ out_cnt++ ] = 2; /* stderr */
   if( FD_LIKELY( -1!=fd_log_private_logfile_fd() ) )
     out_fds[ out_cnt++ ] = fd_log_private_logfile_fd(); /* logfile */
   out_fds[ out_cnt++ ] = ctx->shredb->fd;
+  out_fds[ out_cnt++ ] = ctx->shredb->idx_fd;
   return out_cnt;
 }
 
@@ -31,11 +31,11 @@
 #define FD_SECCOMP_ARG_LO(x) ((uint)(((ulong)(uint)(int)(x)      ) & 0xffffffffUL))
 #define FD_SECCOMP_ARG_HI(x) ((uint)(((ulong)(x) >> 32) & 0xffffffffUL))
 
-static const uint sock_filter_policy_fd_rserve_tile_instr_cnt = 32;
+static const uint sock_filter_policy_fd_rserve_tile_instr_cnt = 34;
 
-static void populate_sock_filter_policy_fd_rserve_tile( ulong out_cnt, struct sock_filter out[ static 32 ], uint logfile_fd, uint shredb_fd ) {
-  FD_TEST( out_cnt >= 32 );
-  struct sock_filter filter[32] = {
+static void populate_sock_filter_policy_fd_rserve_tile( ulong out_cnt, struct sock_filter out[ static 34 ], uint logfile_fd, uint shredb_fd, uint shredb_idx_fd ) {
+  FD_TEST( out_cnt >= 34 );
+  struct sock_filter filter[34] = {
     /* validate architecture */
     BPF_STMT( BPF_LD | BPF_W | BPF_ABS, ( offsetof( struct seccomp_data, arch ) )),
     BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ARCH_NR, 0, /* RET_KILL_PROCESS */ 6 ),
@@ -50,7 +50,7 @@ static void populate_sock_filter_policy_fd_rserve_tile( ulong out_cnt, struct so
     /* check pwrite64 */
     BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, SYS_pwrite64, /* check_pwrite64 */ 17, 0 ),
     /* check fsync */
-    BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, SYS_fsync, /* check_fsync */ 20, 0 ),
+    BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, SYS_fsync, /* check_fsync */ 22, 0 ),
 //  RET_KILL_PROCESS:
     /* default deny */
     BPF_STMT( BPF_RET | BPF_K, SECCOMP_RET_KILL_PROCESS ),
@@ -88,7 +88,11 @@ static void populate_sock_filter_policy_fd_rserve_tile( ulong out_cnt, struct so
 //  check_pwrite64:
     /* arg 0 low 32 bits */
     BPF_STMT( BPF_LD | BPF_W | BPF_ABS, FD_SECCOMP_ARG_LO_OFFSET(0)),
-    BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ((uint)(shredb_fd)), /* pwrite64_ALLOW */ 1, /* pwrite64_KILL */ 0 ),
+    BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ((uint)(shredb_fd)), /* pwrite64_ALLOW */ 3, /* or_2 */ 0 ),
+//  or_2:
+    /* arg 0 low 32 bits */
+    BPF_STMT( BPF_LD | BPF_W | BPF_ABS, FD_SECCOMP_ARG_LO_OFFSET(0)),
+    BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ((uint)(shredb_idx_fd)), /* pwrite64_ALLOW */ 1, /* pwrite64_KILL */ 0 ),
 //  pwrite64_KILL:
     BPF_STMT( BPF_RET | BPF_K, SECCOMP_RET_KILL_PROCESS ),
 //  pwrite64_ALLOW:
@@ -85,6 +85,13 @@ struct fd_execrp_txn_exec_done_msg {
   int is_fees_only;
   int txn_err;
 
+  /* Failed instruction, valid if txn_err is
+     FD_RUNTIME_TXN_ERR_INSTRUCTION_ERROR.  custom_err is valid if
+     exec_err is FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR. */
+  int  exec_err;
+  uint exec_err_idx;
+  uint custom_err;
+
   /* used by monitoring tools */
   ulong  slot;
   ulong  bank_seq;
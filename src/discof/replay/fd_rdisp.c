@@ -143,6 +143,22 @@ struct fd_rdisp_txn {
      execution is not very important. */
   float   score;
 
+  /* level and crit_acct back FD_RDISP_PRIO_CRITICAL_PATH.  level is the
+     length of the longest chain of unfinished predecessors at the time
+     the transaction was staged, so along any account-conflict DAG,
+     level strictly increases.  crit_acct is the index in acct_pool of
+     the writable account with the highest reference EMA, which is the
+     DAG most likely to have a long tail behind this transaction.  Only
+     meaningful when STAGED. */
+  uint    level;
+  uint    crit_acct;
+
+  /* cost backs FD_RDISP_PRIO_COST.  It is the caller's execution cost
+     estimate for this transaction relative to the running mean of
+     recent estimates, so 1.0 is a typical transaction.  Set for STAGED
+     and UNSTAGED transactions. */
+  float   cost;
+
   /* edge_cnt_etc:
      0xFFFF0000 (16 bits) for linear block number,
      0x0000C000 (2 bits) for concurrency lane,
@@ -472,6 +488,8 @@ struct fd_rdisp {
   fd_rdisp_blockinfo_t * block_pool;
 
   int free_lanes; /* a bitmask */
+  int prio;       /* bitwise or of FD_RDISP_PRIO_* */
+  float cost_ema; /* running mean of non-zero cost estimates passed to add_txn */
   per_lane_info_t lanes[4];
 
   acct_map_t   * acct_map;
@@ -544,6 +562,8 @@ fd_rdisp_new( void * mem,
   disp->block_depth       = block_depth;
   disp->global_insert_cnt = 0UL;
   disp->unstaged_lblk_num = 0UL;
+  disp->prio              = FD_RDISP_PRIO_DEFAULT;
+  disp->cost_ema          = 0.0f;
 
   fd_rdisp_txn_t * temp_pool_join = pool_join( pool_new( _pool, depth+1UL ) );
   for( ulong i=0UL; i<depth+1UL; i++ ) temp_pool_join[ i ].in_degree = IN_DEGREE_FREE;
@@ -624,6 +644,14 @@ fd_rdisp_join( void * mem ) {
   return disp;
 }
 
+int
+fd_rdisp_set_prio( fd_rdisp_t * disp,
+                   int          prio ) {
+  int old = disp->prio;
+  disp->prio = prio;
+  return old;
+}
+
 static inline void
 free_lane( fd_rdisp_t * disp,
            ulong        staging_lane ) {
@@ -780,7 +808,12 @@ add_edges( fd_rdisp_t           * disp,
            uint                   staging_lane,
            int                    writable,
            int                    update_score );
-/* updates in_degree, edge_cnt_etc */
+/* updates in_degree, edge_cnt_etc, level, crit_acct */
+
+static inline float
+ready_score( fd_rdisp_t     const * disp,
+             fd_rdisp_txn_t const * rtxn,
+             uint                   lane );
 
 int
 fd_rdisp_promote_block( fd_rdisp_t *          disp,
@@ -817,6 +850,8 @@ fd_rdisp_promote_block( fd_rdisp_t *          disp,
     FD_TEST( ele->in_degree==IN_DEGREE_UNSTAGED );
 
     ele->in_degree    = 0U;
+    ele->level        = 0U;
+    ele->crit_acct    = 0U;
     ele->edge_cnt_etc = (uint)(-1); /* set w_cnt_1 to -1 */
 
     add_edges( disp, ele, uns->keys,                   uns->writable_cnt, (uint)staging_lane, 1, 0 );
@@ -827,7 +862,7 @@ fd_rdisp_promote_block( fd_rdisp_t *          disp,
     ele->edge_cnt_etc |= linear_block_number<<16;
 
     if( FD_UNLIKELY( ele->in_degree==0U ) ) {
-      pending_prq_ele_t temp[1] = {{ .score = ele->score, .linear_block_number = linear_block_number, .txn_idx = (uint)(ele-disp->pool)}};
+      pending_prq_ele_t temp[1] = {{ .score = ready_score( disp, ele, (uint)staging_lane ), .linear_block_number = linear_block_number, .txn_idx = (uint)(ele-disp->pool)}};
       pending_prq_insert( lane->pending, temp );
     }
   }
@@ -1020,6 +1055,9 @@ add_edges( fd_rdisp_t           * disp,
       float score_change = 1.0f - update_ema( ai, disp->global_insert_cnt );
       ele->score *= fd_float_if( writable, score_change, 1.0f );
     }
+    if( writable && ( !ele->crit_acct || ai->ema_refs>disp->acct_pool[ ele->crit_acct ].ema_refs ) ) {
+      ele->crit_acct = (uint)idx;
+    }
 
     /* Step 2: add edge. There are 4 cases depending on whether this is
        a writer or not and whether the previous reference was a writer
@@ -1044,6 +1082,21 @@ add_edges( fd_rdisp_t           * disp,
 
     int flags = ai->flags;
 
+    /* level is one more than that of the parents in this DAG.  The
+       parents are the previous writer, or if the last references were
+       reads, all of those readers. */
+    uint level = ele->level;
+    if( FD_LIKELY( ref_to_pa ) ) {
+      uint pa_level = FOLLOW_EDGE_TXN( disp->pool, ref_to_pa )->level;
+      if( writable | !!(flags & ACCT_INFO_FLAG_LAST_REF_WAS_WRITE( lane )) ) {
+        level = fd_uint_max( level, pa_level+1U );
+      } else if( flags & ACCT_INFO_FLAG_ANY_WRITERS( lane ) ) {
+        /* r-r: the sibling shares our parent writer, so its level is a
+           (slight over-)estimate of the writer's level plus one */
+        level = fd_uint_max( level, pa_level );
+      }
+    }
+
     if( writable ) { /* also should be known at compile time */
       if( flags & ACCT_INFO_FLAG_LAST_REF_WAS_WRITE( lane ) ) { /* unclear prob */
         /* Case 1: w-w. The parent is the special last pointer.  Point
@@ -1056,13 +1109,16 @@ add_edges( fd_rdisp_t           * disp,
            pointers to me. */
         *me = *pa;
         *pa = ref_to_me;
-        edge_t * pb = FOLLOW_EDGE( disp->pool, pa[1], _ignore );
+        edge_t   ref_to_pb = pa[1];
+        edge_t * pb        = FOLLOW_EDGE( disp->pool, ref_to_pb, _ignore );
         /* Intentionally skip the first in_degree increment, because it
            will be done later */
         while( pb!=pa ) {
           *pb = ref_to_me;
           ele->in_degree++;
-          pb = FOLLOW_EDGE( disp->pool, pb[1], _ignore );
+          level     = fd_uint_max( level, FOLLOW_EDGE_TXN( disp->pool, ref_to_pb )->level+1U );
+          ref_to_pb = pb[1];
+          pb        = FOLLOW_EDGE( disp->pool, ref_to_pb, _ignore );
         }
         flags |= ACCT_INFO_FLAG_LAST_REF_WAS_WRITE( lane ) | ACCT_INFO_FLAG_ANY_WRITERS( lane );
       }
@@ -1095,6 +1151,7 @@ add_edges( fd_rdisp_t           * disp,
     ele->in_degree += (uint)((ai->last_reference[ lane ]!=0U) & !!(flags & ACCT_INFO_FLAG_ANY_WRITERS( lane )));
     ai->last_reference[ lane ] = ref_to_me;
     ai->flags                  = (uchar)flags;
+    ele->level                 = level;
     edge_idx += fd_uint_if( writable, 1U, 3U );
     acct_idx++;
   }
@@ -1103,6 +1160,69 @@ add_edges( fd_rdisp_t           * disp,
 }
 
 
+/* ready_score returns the key with which the staged transaction rtxn
+   enters the pending queue of lane when it becomes READY.
+
+   With FD_RDISP_PRIO_CRITICAL_PATH, the fractional part of the score is
+   divided by one plus the estimated number of transactions remaining on
+   the longest chain behind rtxn.  The estimate follows only crit_acct:
+   every later reference to an account rtxn writes is a descendant of
+   rtxn, so the difference in level between the last reference and
+   rtxn is a lower bound on the longest remaining path.  This costs two
+   loads per READY transaction, but the estimate is frozen once the
+   transaction is in the queue.  In particular, a transaction that is
+   READY as soon as it is added has nothing behind it yet and gets the
+   default score.
+
+   With FD_RDISP_PRIO_COST, the fractional part is further divided by
+   the relative cost of rtxn, so that among otherwise equally urgent
+   transactions, the long running ones start first and the short ones
+   fill in around them at the end of the block.  Cheaper than average
+   transactions can't be boosted past the end of the fractional part,
+   so they saturate at FD_RDISP_MAX_SCORE. */
+static inline float
+ready_score( fd_rdisp_t     const * disp,
+             fd_rdisp_txn_t const * rtxn,
+             uint                   lane ) {
+  float score = rtxn->score;
+  if( FD_LIKELY( disp->prio==FD_RDISP_PRIO_DEFAULT ) ) return score;
+
+  float weight = 1.0f;
+  if( disp->prio & FD_RDISP_PRIO_CRITICAL_PATH ) {
+    edge_t last = disp->acct_pool[ rtxn->crit_acct ].last_reference[ lane ];
+    if( FD_LIKELY( last ) ) {
+      uint last_level = FOLLOW_EDGE_TXN( disp->pool, last )->level;
+      uint remaining  = fd_uint_if( last_level>rtxn->level, last_level-rtxn->level, 0U );
+      weight = (float)(1U+remaining);
+    }
+  }
+  if( disp->prio & FD_RDISP_PRIO_COST ) weight *= rtxn->cost;
+
+  float serial = floorf( score );
+  float frac   = (score-serial)/weight;
+  return serial + fd_float_if( frac<FD_RDISP_MAX_SCORE, frac, FD_RDISP_MAX_SCORE );
+}
+
+/* FD_RDISP_COST_{MIN,MAX} bound the relative cost of a transaction so
+   that a single wildly mispredicted estimate can't dominate ordering,
+   and FD_RDISP_COST_EMA_SHIFT sets the decay of the running mean the
+   estimates are normalized against (1/64 per insert). */
+#define FD_RDISP_COST_MIN       (1.0f/16.0f)
+#define FD_RDISP_COST_MAX       (16.0f)
+#define FD_RDISP_COST_EMA_SHIFT (6)
+
+static inline float
+relative_cost( fd_rdisp_t * disp,
+               uint         cost ) {
+  if( FD_UNLIKELY( !cost ) ) return 1.0f;
+  float c = (float)cost;
+  if( FD_UNLIKELY( disp->cost_ema==0.0f ) ) disp->cost_ema = c;
+  else                                       disp->cost_ema += (c-disp->cost_ema)*(1.0f/(float)(1<<FD_RDISP_COST_EMA_SHIFT));
+  float r = c/disp->cost_ema;
+  r = fd_float_if( r>FD_RDISP_COST_MIN, r, FD_RDISP_COST_MIN );
+  return fd_float_if( r<FD_RDISP_COST_MAX, r, FD_RDISP_COST_MAX );
+}
+
 /* should be called with all writable accounts first */
 static void
 add_unstaged_edges( fd_rdisp_t * disp,
@@ -1135,7 +1255,8 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
                   fd_txn_t const       * txn,
                   uchar const          * payload,
                   fd_acct_addr_t const * alts,
-                  int                    serializing ) {
+                  int                    serializing,
+                  uint                   cost ) {
 
   fd_rdisp_blockinfo_t * block   = block_map_ele_query( disp->blockmap, &insert_block, NULL, disp->block_pool );
   if( FD_UNLIKELY( !block || !block->insert_ready ) ) return 0UL;
@@ -1146,6 +1267,7 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
   if( FD_UNLIKELY( rtxn->in_degree!=IN_DEGREE_FREE ) ) FD_LOG_CRIT(( "pool[%lu].in_degree==%u but free", idx, rtxn->in_degree ));
 
   fd_acct_addr_t const * imm_addrs = fd_txn_get_acct_addrs( txn, payload );
+  rtxn->cost = relative_cost( disp, cost );
 
   if( FD_UNLIKELY( !block->staged ) ) {
     rtxn->in_degree = IN_DEGREE_UNSTAGED;
@@ -1177,6 +1299,8 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
 
     rtxn->in_degree    = 0U;
     rtxn->score        = 1.0f;
+    rtxn->level        = 0U;
+    rtxn->crit_acct    = 0U;
     /* There's not a good way to initialize w_cnt_1 to -1, which is what
        it should be at this point, but this is close.  We must be sure
        to add at least one writer (which we are assured of because we
@@ -1210,7 +1334,7 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
   disp->global_insert_cnt++;
 
   if( FD_LIKELY( (block->staged) & (rtxn->in_degree==0U) ) ) {
-    pending_prq_ele_t temp[1] = {{ .score = rtxn->score, .linear_block_number = block->linear_block_number, .txn_idx = (uint)idx }};
+    pending_prq_ele_t temp[1] = {{ .score = ready_score( disp, rtxn, block->staging_lane ), .linear_block_number = block->linear_block_number, .txn_idx = (uint)idx }};
     pending_prq_insert( disp->lanes[ block->staging_lane ].pending, temp );
   }
 
@@ -1336,7 +1460,7 @@ fd_rdisp_complete_txn( fd_rdisp_t * disp,
                which case, we subtract 2^16. */
             uint low_16_bits = child_txn->edge_cnt_etc>>16;
             uint linear_block_num = ((tail_linear_block_num & ~0xFFFFU) | low_16_bits) - (uint)((low_16_bits>(tail_linear_block_num&0xFFFFU))<<16);
-            pending_prq_ele_t temp[1] = {{ .score               = child_txn->score,
+            pending_prq_ele_t temp[1] = {{ .score               = ready_score( disp, child_txn, (uint)lane ),
                                            .linear_block_number = linear_block_num,
                                            .txn_idx             = (uint)(child_txn-disp->pool) }};
             pending_prq_insert( disp->lanes[ lane ].pending, temp );
@@ -147,6 +147,14 @@
    from the next integer. */
 #define FD_RDISP_MAX_SCORE 0.996f
 
+/* FD_RDISP_PRIO_* select how fd_rdisp_get_next_ready chooses among
+   multiple READY transactions in a staged block.  See
+   fd_rdisp_set_prio.  The non-default policies are bit flags and may be
+   combined. */
+#define FD_RDISP_PRIO_DEFAULT       0
+#define FD_RDISP_PRIO_CRITICAL_PATH 1
+#define FD_RDISP_PRIO_COST          2
+
 struct fd_rdisp;
 typedef struct fd_rdisp fd_rdisp_t;
 
@@ -186,6 +194,34 @@ fd_rdisp_new( void * mem,
 fd_rdisp_t *
 fd_rdisp_join( void * mem );
 
+/* fd_rdisp_set_prio sets the policy used to order READY transactions
+   in staged blocks.  prio is FD_RDISP_PRIO_DEFAULT or a bitwise or of
+   the other FD_RDISP_PRIO_* flags.  Returns the
+   previous policy.  A freshly created dispatcher uses
+   FD_RDISP_PRIO_DEFAULT.
+
+   FD_RDISP_PRIO_DEFAULT prefers transactions that write to accounts
+   that have recently been referenced often, i.e. those most likely to
+   be blocking something.
+
+   FD_RDISP_PRIO_CRITICAL_PATH additionally weighs each transaction by
+   an estimate of the length of the longest chain of transactions in
+   the dispatcher that depend on it, so that e.g. the head of a long
+   chain of transactions writing the same hot account is not starved
+   behind independent work.  The estimate is taken when a transaction
+   becomes READY and costs O(1) per transaction.
+
+   FD_RDISP_PRIO_COST additionally weighs each transaction by the cost
+   estimate passed to fd_rdisp_add_txn, so that long running
+   transactions are dispatched early and short ones fill in the tail of
+   the block, keeping exec tiles evenly loaded.
+
+   Changing the policy does not affect transactions that are already
+   READY. */
+int
+fd_rdisp_set_prio( fd_rdisp_t * disp,
+                   int          prio );
+
 /* fd_rdisp_suggest_staging_lane recommends a staging lane to use for a
    potential new block that has a parent block with block tag
    parent_block.  duplicate is non-zero if this is not the first block
@@ -346,6 +382,12 @@ fd_rdisp_rekey_block( fd_rdisp_t *           disp,
    executed the transaction to populate that part of the address lookup
    table yet.  This is the primary use for alts==NULL.
 
+   cost is the caller's estimate of how long the transaction will take
+   to execute, in arbitrary but consistent units, or 0 if unknown.  It
+   is only used to order READY transactions when the dispatcher uses
+   FD_RDISP_PRIO_COST, and only its size relative to recently added
+   transactions matters.
+
    Returns 0 and does not add the transaction on failure.  Fails if
    there were no free transaction indices, if the block with tag
    insert_block did not exist, or if it was not schedule-ready.
@@ -359,7 +401,8 @@ fd_rdisp_add_txn( fd_rdisp_t          *  disp,
                   fd_txn_t const       * txn,
                   uchar const          * payload,
                   fd_acct_addr_t const * alts,
-                  int                    serializing );
+                  int                    serializing,
+                  uint                   cost );
 
 /* fd_rdisp_get_next_ready returns the transaction index of a READY
    transaction that was inserted with block tag schedule_block if one
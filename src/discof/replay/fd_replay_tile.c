@@ -177,6 +177,9 @@ metrics_write( fd_replay_tile_t * ctx ) {
   FD_MGAUGE_SET( REPLAY, REASSEMBLY_LATEST_SLOT,      ctx->metrics.reasm_latest_slot );
   FD_MGAUGE_SET( REPLAY, REASSEMBLY_LATEST_FEC_INDEX, ctx->metrics.reasm_latest_fec_idx );
 
+  FD_MCNT_SET  ( REPLAY, EPOCH_BOUNDARY_PROCESSED,      ctx->metrics.epoch_boundary_cnt );
+  FD_MGAUGE_SET( REPLAY, EPOCH_BOUNDARY_DURATION_NANOS, ctx->metrics.epoch_boundary_dur );
+
   fd_sched_metrics_write( ctx->sched );
 
   FD_MCNT_SET( REPLAY, FEC_SCHED_FULL,          ctx->metrics.sched_full );
@@ -184,6 +187,7 @@ metrics_write( fd_replay_tile_t * ctx ) {
   FD_MCNT_SET( REPLAY, FEC_LEADER_BID_WAIT,     ctx->metrics.leader_bid_wait );
   FD_MCNT_SET( REPLAY, FEC_BANK_FULL,           ctx->metrics.banks_full );
   FD_MCNT_SET( REPLAY, STORAGE_ROOT_BEHIND, ctx->metrics.storage_root_behind );
+  FD_MCNT_ENUM_COPY( REPLAY, PREFETCH_ACCOUNT, ctx->metrics.prefetch_acct );
 
   fd_progcache_admin_metrics_t const * pcm = &fd_progcache_admin_metrics_g;
   FD_MCNT_SET( REPLAY, PROGCACHE_ROOTED, pcm->root_cnt );
@@ -254,6 +258,24 @@ timing_slot_release( fd_replay_tile_t * ctx,
   }
 }
 
+/* block_execute_prepare updates the runtime state of a new bank before
+   its transactions are executed, processing the epoch boundary if bank
+   is the first block of an epoch.  The boundary (stake activation,
+   rewards calculation, leader schedule) is by far the longest stall on
+   the replay path, so its duration is reported as a metric. */
+
+static void
+block_execute_prepare( fd_replay_tile_t * ctx,
+                       fd_bank_t *        bank ) {
+  long start = fd_log_wallclock();
+  int  is_epoch_boundary = 0;
+  fd_runtime_block_execute_prepare( ctx->banks, bank, ctx->accdb, ctx->runtime_stack, ctx->capture_ctx, &is_epoch_boundary );
+  if( FD_UNLIKELY( is_epoch_boundary ) ) {
+    ctx->metrics.epoch_boundary_cnt++;
+    ctx->metrics.epoch_boundary_dur = (ulong)fd_long_max( fd_log_wallclock()-start, 0L );
+  }
+}
+
 static void
 replay_block_start( fd_replay_tile_t * ctx,
                     ulong              bank_idx,
@@ -300,8 +322,7 @@ replay_block_start( fd_replay_tile_t * ctx,
 
   /* Update required runtime state and handle potential boundary. */
 
-  int is_epoch_boundary = 0;
-  fd_runtime_block_execute_prepare( ctx->banks, bank, ctx->accdb, ctx->runtime_stack, ctx->capture_ctx, &is_epoch_boundary );
+  block_execute_prepare( ctx, bank );
 
   ulong max_tick_height;
   if( FD_UNLIKELY( FD_RUNTIME_EXECUTE_SUCCESS!=fd_runtime_compute_max_tick_height( parent_bank->f.ticks_per_slot, slot, &max_tick_height ) ) ) {
@@ -512,6 +533,11 @@ publish_txn_executed( fd_replay_tile_t *  ctx,
   fd_replay_txn_executed_t * txn_executed = fd_type_pun( fd_chunk_to_laddr( ctx->replay_out->mem, ctx->replay_out->chunk ) );
   *txn_executed->txn = *fd_sched_get_txn( ctx->sched, txn_idx );
   txn_executed->txn_err = txn_info->txn_err;
+  txn_executed->exec_err = txn_info->exec_err;
+  txn_executed->exec_err_idx = txn_info->exec_err_idx;
+  txn_executed->custom_err = txn_info->custom_err;
+  txn_executed->slot = fd_banks_bank_query( ctx->banks, bank_idx )->f.slot;
+  txn_executed->index_in_slot = txn_info->index_in_slot;
   txn_executed->is_committable = !!(txn_info->flags&FD_SCHED_TXN_IS_COMMITTABLE);
   txn_executed->is_fees_only = !!(txn_info->flags&FD_SCHED_TXN_IS_FEES_ONLY);
   txn_executed->tick_parsed = txn_info->tick_parsed;
@@ -618,8 +644,7 @@ prepare_leader_bank( fd_replay_tile_t * ctx,
   ctx->leader_bank->accdb_fork_id        = fd_accdb_attach_child    ( ctx->accdb,     parent_bank->accdb_fork_id     );
   ctx->leader_bank->parent_accdb_fork_id = parent_bank->accdb_fork_id;
 
-  int is_epoch_boundary = 0;
-  fd_runtime_block_execute_prepare( ctx->banks, ctx->leader_bank, ctx->accdb, ctx->runtime_stack, ctx->capture_ctx, &is_epoch_boundary );
+  block_execute_prepare( ctx, ctx->leader_bank );
 
   ulong max_tick_height;
   if( FD_UNLIKELY( FD_RUNTIME_EXECUTE_SUCCESS!=fd_runtime_compute_max_tick_height( parent_bank->f.ticks_per_slot, slot, &max_tick_height ) ) ) {
@@ -1556,6 +1581,38 @@ try_replay( fd_replay_tile_t *  ctx,
   return charge_busy;
 }
 
+/* try_prefetch warms the accounts database for the next transaction
+   the scheduler expects to dispatch soon.  Only the statically listed
+   accounts are prefetched, which includes the program ids invoked by
+   the transaction.  Accounts loaded through address lookup tables are
+   left for the exec tile.  Blocks that have not started yet read
+   through their parent's fork, which is what they will be cloned from. */
+
+static int
+try_prefetch( fd_replay_tile_t * ctx ) {
+  ulong bank_idx;
+  ulong txn_idx = fd_sched_prefetch_next( ctx->sched, &bank_idx );
+  if( FD_LIKELY( txn_idx==ULONG_MAX ) ) return 0;
+
+  fd_bank_t * bank = fd_banks_bank_query( ctx->banks, bank_idx );
+  if( FD_UNLIKELY( !bank ) ) return 1;
+  if( bank->state==FD_BANK_STATE_INIT ) bank = fd_banks_get_parent( ctx->banks, bank );
+  if( FD_UNLIKELY( !bank || ( bank->state!=FD_BANK_STATE_REPLAYABLE && bank->state!=FD_BANK_STATE_FROZEN ) ) ) return 1;
+
+  fd_txn_p_t *           txn_p    = fd_sched_get_txn( ctx->sched, txn_idx );
+  fd_txn_t const *       txn      = TXN( txn_p );
+  fd_acct_addr_t const * accts    = fd_txn_get_acct_addrs( txn, txn_p->payload );
+  ulong                  acct_cnt = fd_txn_account_cnt( txn, FD_TXN_ACCT_CAT_IMM );
+  for( ulong i=0UL; i<acct_cnt; i++ ) {
+    switch( fd_accdb_prefetch( ctx->accdb, bank->accdb_fork_id, accts[ i ].b ) ) {
+      case FD_ACCDB_PREFETCH_ISSUED:  ctx->metrics.prefetch_acct[ FD_METRICS_ENUM_PREFETCH_ACCOUNT_RESULT_V_ISSUED_IDX   ]++; break;
+      case FD_ACCDB_PREFETCH_CACHED:  ctx->metrics.prefetch_acct[ FD_METRICS_ENUM_PREFETCH_ACCOUNT_RESULT_V_RESIDENT_IDX ]++; break;
+      default:                        ctx->metrics.prefetch_acct[ FD_METRICS_ENUM_PREFETCH_ACCOUNT_RESULT_V_MISSING_IDX  ]++; break;
+    }
+  }
+  return 1;
+}
+
 static int
 can_process_fec( fd_replay_tile_t * ctx,
                  int *              evict_banks_out ) {
@@ -2173,6 +2230,8 @@ after_credit( fd_replay_tile_t *  ctx,
      4. Replay.  If there is work to do for replay, do it.  This is
         more important than ingesting more FEC sets.
      5. If replay has nothing to do, ingest more FEC sets.
+     6. If there are no FEC sets either, prefetch accounts for
+        transactions that will be dispatched soon.
      WARNING: The ordering here is VERY load bearing and it should not
      be changed without extreme caution. */
 
@@ -2230,6 +2289,11 @@ after_credit( fd_replay_tile_t *  ctx,
     return;
   }
 
+  if( FD_UNLIKELY( try_prefetch( ctx ) ) ) {
+    *charge_busy = 1;
+    return;
+  }
+
   ctx->execrp_idle_cnt++;
 }
 
@@ -2282,7 +2346,10 @@ process_exec_task_done( fd_replay_tile_t *          ctx,
       fd_sched_txn_info_t * txn_info = fd_sched_get_txn_info( ctx->sched, txn_idx );
       txn_info->flags |= FD_SCHED_TXN_EXEC_DONE;
       if( FD_LIKELY( !(txn_info->flags&FD_SCHED_TXN_SIGVERIFY_DONE)||!txn_info->txn_err ) ) { /* Set execution status if sigverify hasn't happened yet or if sigverify was a success. */
-        txn_info->txn_err = msg->txn_exec->txn_err;
+        txn_info->txn_err      = msg->txn_exec->txn_err;
+        txn_info->exec_err     = msg->txn_exec->exec_err;
+        txn_info->exec_err_idx = msg->txn_exec->exec_err_idx;
+        txn_info->custom_err   = msg->txn_exec->custom_err;
         txn_info->flags  |= fd_ulong_if( msg->txn_exec->is_committable, FD_SCHED_TXN_IS_COMMITTABLE, 0UL );
         txn_info->flags  |= fd_ulong_if( msg->txn_exec->is_fees_only,   FD_SCHED_TXN_IS_FEES_ONLY,   0UL );
       }
@@ -3169,6 +3236,8 @@ unprivileged_init( fd_topo_t const *      topo,
 
   ctx->sched = fd_sched_join( fd_sched_new( sched_mem, ctx->rng, tile->replay.sched_depth, tile->replay.max_live_slots, fd_topo_tile_name_cnt( topo, "execrp" ) ) );
   FD_TEST( ctx->sched );
+  fd_sched_set_prefetch_depth( ctx->sched, tile->replay.prefetch_lookahead_depth );
+  fd_sched_set_cost_aware( ctx->sched, tile->replay.cost_aware_dispatch );
 
   ctx->in_cnt          = tile->in_cnt;
   ctx->execrp_idle_cnt = 0UL;
@@ -185,6 +185,11 @@ struct fd_replay_txn_executed {
   int is_committable;
   int is_fees_only;
   int txn_err;
+  int  exec_err;     /* Failed instruction, see fd_execrp_txn_exec_done_msg_t */
+  uint exec_err_idx;
+  uint custom_err;
+  ulong slot;
+  ulong index_in_slot;
   long  tick_parsed;
   long  tick_sigverify_disp;
   long  tick_sigverify_done;
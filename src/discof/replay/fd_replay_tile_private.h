@@ -451,11 +451,16 @@ struct fd_replay_tile {
     ulong reasm_latest_slot;
     ulong reasm_latest_fec_idx;
 
+    ulong epoch_boundary_cnt;
+    ulong epoch_boundary_dur; /* ns, most recent epoch boundary */
+
     ulong sched_full;
     ulong reasm_empty;
     ulong leader_bid_wait;
     ulong banks_full;
     ulong storage_root_behind;
+
+    ulong prefetch_acct[ FD_METRICS_ENUM_PREFETCH_ACCOUNT_RESULT_CNT ];
   } metrics;
 
   uchar __attribute__((aligned(FD_MULTI_EPOCH_LEADERS_ALIGN))) mleaders_mem[ FD_MULTI_EPOCH_LEADERS_FOOTPRINT ];
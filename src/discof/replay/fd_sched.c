@@ -23,6 +23,14 @@
 #define FD_SCHED_MAX_MBLK_PER_SLOT             (MAX_SKIPPED_TICKS)
 #define FD_SCHED_MAX_POH_HASHES_PER_TASK       (4096UL) /* This seems to be the sweet spot. */
 
+/* Execution cost estimates are kept per program in a direct mapped
+   table of FD_SCHED_COST_BIN_CNT bins, in the spirit of fd_est_tbl.
+   Collisions simply share a bin.  Each bin is an EMA of observed exec
+   ticks with weight 2^-FD_SCHED_COST_EMA_SHIFT on the newest sample. */
+#define FD_SCHED_COST_BIN_CNT              (4096UL)
+#define FD_SCHED_COST_EMA_SHIFT            (3)
+FD_STATIC_ASSERT( !(FD_SCHED_COST_BIN_CNT & (FD_SCHED_COST_BIN_CNT-1UL)), cost bin cnt must be a power of 2 );
+
 /* 64 ticks per slot, and a single gigantic microblock containing min
    size transactions. */
 FD_STATIC_ASSERT( FD_MAX_TXN_PER_SLOT_SHRED==((FD_SHRED_DATA_PAYLOAD_MAX_PER_SLOT-65UL*sizeof(fd_microblock_hdr_t))/FD_TXN_MIN_SERIALIZED_SZ), max_txn_per_slot_shred );
@@ -91,6 +99,8 @@ struct fd_sched_block {
   uint                poh_hashing_done_cnt;
   uint                poh_hash_cmp_done_cnt; /* poh_hashing_done_cnt==poh_hash_cmp_done_cnt+len(mixin_in_progress) */
   uint                txn_done_cnt; /* A transaction is considered done when all types of tasks associated with it are done. */
+  uint                txn_prefetch_cnt; /* Prefetch cursor into txn_idx; transactions before it have been handed out for
+                                           prefetch or were dispatched before prefetch reached them. */
   uint                shred_cnt;
   uint                mblk_cnt;          /* Total number of microblocks, including ticks and non ticks.
                                             mblk_cnt==len(unhashed)+len(hashing_in_progress)+hashing_in_flight_cnt+len(mixin_in_progress)+hash_cmp_done_cnt */
@@ -247,6 +257,9 @@ struct fd_sched_metrics {
   ulong bytes_ingested_unparsed_cnt;
   ulong bytes_dropped_cnt;
   ulong fec_cnt;
+  ulong txn_prefetched_cnt;
+  ulong txn_prefetch_hit_cnt;
+  ulong txn_prefetch_late_cnt;
 };
 typedef struct fd_sched_metrics fd_sched_metrics_t;
 
@@ -266,6 +279,9 @@ struct fd_sched {
   ulong                 exec_cnt;      /* Immutable. */
   int                   bypass_poh_verify; /* Test/fuzz: skip the PoH end_hash compare in maybe_mixin. */
   int                   bypass_alut_resolution; /* Test/fuzz: skip ALUT resolution (no accdb). */
+  ulong                 prefetch_depth; /* Per lane lookahead of fd_sched_prefetch_next, 0 if disabled. */
+  int                   cost_aware;     /* Pass per-program exec cost estimates to the dispatcher. */
+  uint                  cost_est[ FD_SCHED_COST_BIN_CNT ]; /* Exec ticks EMA per program bin, 0 if never observed. */
   long                  txn_in_flight_last_tick;
   long                  next_ready_last_tick;
   ulong                 next_ready_last_bank_idx;
@@ -607,6 +623,36 @@ handle_bad_block( fd_sched_t * sched, fd_sched_block_t * block, int dead_reason
 }
 
 
+/* cost_bin returns the cost estimate bin of a transaction.  Execution
+   time is dominated by the program doing the actual work, so the bin is
+   keyed on the first invoked program other than the compute budget
+   program, whose instructions only carry limits and priority fees. */
+static inline ulong
+cost_bin( fd_txn_t const * txn,
+          uchar const *    payload ) {
+  fd_acct_addr_t const * imms = fd_txn_get_acct_addrs( txn, payload );
+  fd_acct_addr_t const * prog = NULL;
+  for( ulong i=0UL; i<txn->instr_cnt; i++ ) {
+    prog = imms + txn->instr[ i ].program_id;
+    if( FD_LIKELY( memcmp( prog, fd_solana_compute_budget_program_id.uc, sizeof(fd_acct_addr_t) ) ) ) break;
+  }
+  if( FD_UNLIKELY( !prog ) ) return 0UL;
+  return fd_hash( 0UL, prog, sizeof(fd_acct_addr_t) ) & (FD_SCHED_COST_BIN_CNT-1UL);
+}
+
+/* cost_update folds the observed execution time, in ticks, of
+   transaction txn_idx into the estimate for its bin. */
+static inline void
+cost_update( fd_sched_t * sched,
+             ulong        txn_idx,
+             long         ticks ) {
+  fd_txn_p_t * txn_p = sched->txn_pool + txn_idx;
+  uint * est    = sched->cost_est + cost_bin( TXN(txn_p), txn_p->payload );
+  uint   sample = (uint)fd_long_min( fd_long_max( ticks, 1L ), (long)UINT_MAX );
+  if( FD_UNLIKELY( !*est ) ) *est = sample;
+  else                       *est = (uint)((long)*est + (((long)sample-(long)*est)>>FD_SCHED_COST_EMA_SHIFT));
+}
+
 /* Public functions. */
 
 ulong
@@ -713,6 +759,9 @@ fd_sched_new( void *     mem,
   sched->exec_cnt               = exec_cnt;
   sched->bypass_poh_verify      = 0;
   sched->bypass_alut_resolution = 0;
+  sched->prefetch_depth         = 0UL;
+  sched->cost_aware             = 0;
+  fd_memset( sched->cost_est, 0, sizeof(sched->cost_est) );
   sched->root_idx               = ULONG_MAX;
   sched->active_bank_idx        = ULONG_MAX;
   sched->last_active_bank_idx   = ULONG_MAX;
@@ -1229,6 +1278,11 @@ fd_sched_task_next_ready( fd_sched_t * sched, fd_sched_task_t * out ) {
     sched->txn_in_flight_last_tick = now;
 
     sched->txn_info_pool[ out->txn_exec->txn_idx ].tick_exec_disp = now;
+    if( sched->prefetch_depth ) {
+      int prefetched = !!(sched->txn_info_pool[ out->txn_exec->txn_idx ].flags & FD_SCHED_TXN_PREFETCHED);
+      sched->metrics->txn_prefetch_hit_cnt  += (ulong) prefetched;
+      sched->metrics->txn_prefetch_late_cnt += (ulong)!prefetched;
+    }
 
     sched->txn_exec_ready_bitset[ 0 ] = fd_ulong_clear_bit( exec_ready_bitset0, (int)exec_tile_idx0);
     sched->tile_to_bank_idx[ exec_tile_idx0 ] = bank_idx;
@@ -1435,6 +1489,7 @@ fd_sched_task_done( fd_sched_t * sched, ulong task_type, ulong txn_idx, ulong ex
       sched->txn_in_flight_last_tick = now;
 
       sched->txn_info_pool[ txn_idx ].tick_exec_done = now;
+      if( sched->cost_aware ) cost_update( sched, txn_idx, now-sched->txn_info_pool[ txn_idx ].tick_exec_disp );
 
       block->txn_exec_done_cnt++;
       block->txn_exec_in_flight_cnt--;
@@ -1795,6 +1850,110 @@ fd_sched_set_bypass_alut_resolution( fd_sched_t * sched, int bypass_alut_resolut
   sched->bypass_alut_resolution = !!bypass_alut_resolution;
 }
 
+void
+fd_sched_set_prefetch_depth( fd_sched_t * sched, ulong depth ) {
+  FD_TEST( sched->canary==FD_SCHED_MAGIC );
+  sched->prefetch_depth = depth;
+}
+
+void
+fd_sched_set_cost_aware( fd_sched_t * sched, int cost_aware ) {
+  FD_TEST( sched->canary==FD_SCHED_MAGIC );
+  sched->cost_aware = !!cost_aware;
+  int prio = fd_rdisp_set_prio( sched->rdisp, FD_RDISP_PRIO_DEFAULT );
+  fd_rdisp_set_prio( sched->rdisp, fd_int_if( sched->cost_aware, prio|FD_RDISP_PRIO_COST, prio&~FD_RDISP_PRIO_COST ) );
+}
+
+/* prefetch_block_next advances the prefetch cursor of block past
+   transactions that were already dispatched and returns the next one,
+   or ULONG_MAX if the block has no more parsed transactions or the
+   remaining lookahead budget (*budget) is used up by transactions
+   handed out but not yet dispatched.  Dispatch order only loosely
+   follows parse order, so the budget is an approximation. */
+
+static ulong
+prefetch_block_next( fd_sched_t *       sched,
+                     fd_sched_block_t * block,
+                     ulong *            budget ) {
+  ulong dispatched  = (ulong)block->txn_exec_in_flight_cnt+(ulong)block->txn_exec_done_cnt;
+  ulong outstanding = fd_ulong_if( block->txn_prefetch_cnt>dispatched, block->txn_prefetch_cnt-dispatched, 0UL );
+  if( FD_UNLIKELY( outstanding>=*budget ) ) {
+    *budget = 0UL;
+    return ULONG_MAX;
+  }
+  *budget -= outstanding;
+
+  while( block->txn_prefetch_cnt<block->txn_parsed_cnt ) {
+    ulong txn_idx = block->txn_idx[ block->txn_prefetch_cnt++ ];
+    fd_sched_txn_info_t * txn_info = sched->txn_info_pool+txn_idx;
+    if( FD_UNLIKELY( txn_info->tick_exec_disp!=LONG_MAX ) ) continue; /* Too late */
+    txn_info->flags |= FD_SCHED_TXN_PREFETCHED;
+    sched->metrics->txn_prefetched_cnt++;
+    return txn_idx;
+  }
+  return ULONG_MAX;
+}
+
+/* prefetch_lane_next walks the linear chain of blocks staged in lane
+   starting at block.  A child is only visited once the parent is fully
+   parsed and handed out, as its transactions come strictly later in
+   replay order. */
+
+static ulong
+prefetch_lane_next( fd_sched_t *       sched,
+                    fd_sched_block_t * block,
+                    ulong *            out_bank_idx ) {
+  ulong budget = sched->prefetch_depth;
+  ulong lane   = block->staging_lane;
+  while( block && budget ) {
+    if( FD_UNLIKELY( block->dying ) ) break;
+    ulong txn_idx = prefetch_block_next( sched, block, &budget );
+    if( txn_idx!=ULONG_MAX ) {
+      *out_bank_idx = block_to_idx( sched, block );
+      return txn_idx;
+    }
+    if( !block->fec_eos ) break;
+
+    fd_sched_block_t * next = NULL;
+    ulong child_idx = block->child_idx;
+    while( child_idx!=ULONG_MAX ) {
+      fd_sched_block_t * child = block_pool_ele( sched, child_idx );
+      if( child->staged && child->staging_lane==lane ) {
+        next = child;
+        break;
+      }
+      child_idx = child->sibling_idx;
+    }
+    block = next;
+  }
+  return ULONG_MAX;
+}
+
+ulong
+fd_sched_prefetch_next( fd_sched_t * sched, ulong * out_bank_idx ) {
+  FD_TEST( sched->canary==FD_SCHED_MAGIC );
+  if( FD_UNLIKELY( !sched->prefetch_depth ) ) return ULONG_MAX;
+
+  /* The active block is the one exec tiles are waiting on, so its lane
+     goes first. */
+  int active_lane = -1;
+  if( FD_LIKELY( sched->active_bank_idx!=ULONG_MAX ) ) {
+    fd_sched_block_t * active = block_pool_ele( sched, sched->active_bank_idx );
+    if( FD_LIKELY( active->staged ) ) {
+      active_lane = (int)active->staging_lane;
+      ulong txn_idx = prefetch_lane_next( sched, block_pool_ele( sched, sched->staged_head_bank_idx[ active_lane ] ), out_bank_idx );
+      if( txn_idx!=ULONG_MAX ) return txn_idx;
+    }
+  }
+
+  for( int l=0; l<(int)FD_SCHED_MAX_STAGING_LANES; l++ ) {
+    if( l==active_lane || !fd_ulong_extract_bit( sched->staged_bitset, l ) ) continue;
+    ulong txn_idx = prefetch_lane_next( sched, block_pool_ele( sched, sched->staged_head_bank_idx[ l ] ), out_bank_idx );
+    if( txn_idx!=ULONG_MAX ) return txn_idx;
+  }
+  return ULONG_MAX;
+}
+
 fd_txn_p_t *
 fd_sched_get_txn( fd_sched_t * sched, ulong txn_idx ) {
   FD_TEST( sched->canary==FD_SCHED_MAGIC );
@@ -1891,6 +2050,11 @@ fd_sched_metrics_write( fd_sched_t * sched ) {
   FD_MCNT_SET( REPLAY, SCHED_BYTES_INGESTED_PADDING, sched->metrics->bytes_ingested_unparsed_cnt );
   FD_MCNT_SET( REPLAY, SCHED_BYTES_DROPPED, sched->metrics->bytes_dropped_cnt );
   FD_MCNT_SET( REPLAY, SCHED_FEC_INGESTED, sched->metrics->fec_cnt );
+  FD_MCNT_SET( REPLAY, SCHED_TXN_PREFETCHED, sched->metrics->txn_prefetched_cnt );
+  ulong sched_prefetch[ FD_METRICS_ENUM_SCHED_PREFETCH_RESULT_CNT ];
+  sched_prefetch[ FD_METRICS_ENUM_SCHED_PREFETCH_RESULT_V_HIT_IDX  ] = sched->metrics->txn_prefetch_hit_cnt;
+  sched_prefetch[ FD_METRICS_ENUM_SCHED_PREFETCH_RESULT_V_LATE_IDX ] = sched->metrics->txn_prefetch_late_cnt;
+  FD_MCNT_ENUM_COPY( REPLAY, SCHED_PREFETCH, sched_prefetch );
 }
 
 char *
@@ -1916,6 +2080,7 @@ add_block( fd_sched_t * sched,
   sched->block_pool_popcnt++;
 
   block->txn_parsed_cnt              = 0U;
+  block->txn_prefetch_cnt            = 0U;
   block->txn_exec_in_flight_cnt      = 0U;
   block->txn_exec_done_cnt           = 0U;
   block->txn_sigverify_in_flight_cnt = 0U;
@@ -2475,7 +2640,8 @@ fd_sched_parse_txn( fd_sched_t * sched, fd_sched_block_t * block, fd_sched_alut_
   block_poison_add( sched, block, txn, imms, poison_alts, poison_alt_cnt );
 
   ulong bank_idx = (ulong)(block-sched->block_pool);
-  ulong txn_idx  = fd_rdisp_add_txn( sched->rdisp, bank_idx, txn, payload, alts, serializing );
+  uint  cost     = sched->cost_aware ? sched->cost_est[ cost_bin( txn, payload ) ] : 0U;
+  ulong txn_idx  = fd_rdisp_add_txn( sched->rdisp, bank_idx, txn, payload, alts, serializing, cost );
   FD_TEST( txn_idx && txn_idx<sched->depth );
   sched->metrics->txn_parsed_cnt++;
   sched->metrics->alut_serializing_cnt += (uint)serializing;
@@ -2495,6 +2661,9 @@ fd_sched_parse_txn( fd_sched_t * sched, fd_sched_block_t * block, fd_sched_alut_
   sched->txn_info_pool[ txn_idx ].flags = 0UL;
   sched->txn_info_pool[ txn_idx ].received_ns = block->fec_completed_ns;
   sched->txn_info_pool[ txn_idx ].txn_err = 0;
+  sched->txn_info_pool[ txn_idx ].exec_err = 0;
+  sched->txn_info_pool[ txn_idx ].exec_err_idx = 0U;
+  sched->txn_info_pool[ txn_idx ].custom_err = 0U;
   sched->txn_info_pool[ txn_idx ].tick_parsed = fd_tickcount();
   sched->txn_info_pool[ txn_idx ].tick_sigverify_disp = LONG_MAX;
   sched->txn_info_pool[ txn_idx ].tick_sigverify_done = LONG_MAX;
@@ -88,11 +88,15 @@ typedef struct fd_sched_fec fd_sched_fec_t;
 #define FD_SCHED_TXN_SIGVERIFY_DONE (0x0002UL)
 #define FD_SCHED_TXN_IS_COMMITTABLE (0x0004UL)
 #define FD_SCHED_TXN_IS_FEES_ONLY   (0x0008UL)
+#define FD_SCHED_TXN_PREFETCHED     (0x0010UL) /* Handed out by fd_sched_prefetch_next before dispatch. */
 #define FD_SCHED_TXN_REPLAY_DONE    (FD_SCHED_TXN_EXEC_DONE|FD_SCHED_TXN_SIGVERIFY_DONE)
 
 struct fd_sched_txn_info {
    ulong flags;
    int   txn_err;
+   int   exec_err;      /* Failed instruction, see fd_execrp_txn_exec_done_msg_t */
+   uint  exec_err_idx;
+   uint  custom_err;
    long  received_ns;
    long  tick_parsed;
    long  tick_sigverify_disp;
@@ -456,6 +460,38 @@ fd_sched_set_bypass_poh_verify( fd_sched_t * sched, int bypass_poh_verify );
 void
 fd_sched_set_bypass_alut_resolution( fd_sched_t * sched, int bypass_alut_resolution );
 
+/* fd_sched_set_prefetch_depth configures speculative prefetch.  depth
+   is the maximum number of transactions per staging lane that may be
+   handed out by fd_sched_prefetch_next ahead of being dispatched for
+   execution.  0 (the default) disables prefetch. */
+void
+fd_sched_set_prefetch_depth( fd_sched_t * sched, ulong depth );
+
+/* fd_sched_set_cost_aware enables or disables cost aware dispatch.
+   When enabled, the scheduler keeps a rolling estimate of execution
+   time per program, learned from completed transaction execution tasks,
+   and has the dispatcher start transactions expected to run long ahead
+   of cheap ones, so that exec tiles finish a block at about the same
+   time instead of one tile running a long transaction while the others
+   sit idle.  Disabled by default.  See FD_RDISP_PRIO_COST. */
+void
+fd_sched_set_cost_aware( fd_sched_t * sched, int cost_aware );
+
+/* fd_sched_prefetch_next returns the index of the next transaction
+   whose accounts the caller should warm ahead of execution, or
+   ULONG_MAX if there is none within the lookahead depth.  On success,
+   *out_bank_idx is set to the block the transaction belongs to.
+
+   Transactions are walked in parse order, starting with the actively
+   replayed block, then through the blocks staged in each lane.  Each
+   transaction is returned at most once, and never after it has been
+   dispatched.  When a transaction is later dispatched for execution,
+   it is counted as a prefetch hit if it was returned by this function
+   first, and as late otherwise.  The transaction may be queried with
+   get_txn() until the next FEC ingestion, same as task_done(). */
+ulong
+fd_sched_prefetch_next( fd_sched_t * sched, ulong * out_bank_idx );
+
 fd_txn_p_t *
 fd_sched_get_txn( fd_sched_t * sched, ulong txn_idx );
 
@@ -68,7 +68,7 @@ add_txn( fd_rdisp_t *         rdisp,
 
   fd_acct_addr_t const * _alt = serializing && fd_rng_uint_roll( rng, 2U )==0U ? NULL : alt;
 
-  return fd_rdisp_add_txn( rdisp, tag, txn, payload, _alt, serializing );
+  return fd_rdisp_add_txn( rdisp, tag, txn, payload, _alt, serializing, 0U );
 }
 
 static void ushort_to_acct( fd_acct_addr_t * a, ushort v ) { for( ulong k=0UL; k<16UL; k++ ) FD_STORE( ushort, a->b+2UL*k, v ); }
@@ -78,7 +78,8 @@ add_txn2( fd_rdisp_t *         rdisp,
           fd_rng_t   *         rng,
           FD_RDISP_BLOCK_TAG_T tag,
           ushort const *       accts,
-          ulong                acct_cnt ) {
+          ulong                acct_cnt,
+          uint                 cost ) {
   ushort categorized[3][2][128]; /* (signer, nonsigner, alt) x (writeble, readonly) x accts */
   ulong  cat_cnts[3][2] = { 0 };
   ulong  imm_cnt = 0UL;
@@ -115,7 +116,7 @@ add_txn2( fd_rdisp_t *         rdisp,
   acct = alt;
   for( ulong i=4UL; i<6UL; i++ ) for( ulong j=0UL; j<cat_cnts[2][i&1]; j++ ) ushort_to_acct( acct++, categorized[2][i&1][j] );
 
-  return fd_rdisp_add_txn( rdisp, tag, txn, payload, alt, 0 );
+  return fd_rdisp_add_txn( rdisp, tag, txn, payload, alt, 0, cost );
 }
 
 static inline ulong
@@ -137,15 +138,20 @@ typedef struct {
 #define PRQ_T    event_t
 #include "../../util/tmpl/fd_prq.c"
 
-static void                               /* unused in non-hosted */
+/* test_mainnet replays the block in filename (see
+   rdisp_format_block_for_test.py) with exec_cnt simulated exec tiles
+   and returns the estimated total time in ticks, or 0 if skipped. */
+
+static long                               /* unused in non-hosted */
 test_mainnet( char const * filename       FD_PARAM_UNUSED,
               ulong        exec_cnt       FD_PARAM_UNUSED,
               ulong        ticks_per_cu   FD_PARAM_UNUSED,
               ulong        staging_lane   FD_PARAM_UNUSED,
-              int          check_results  FD_PARAM_UNUSED ) {
+              int          check_results  FD_PARAM_UNUSED,
+              int          prio           FD_PARAM_UNUSED ) {
   if( (!FD_HAS_HOSTED) || FD_UNLIKELY( !filename ) ) {
     FD_LOG_NOTICE(( "skipping mainnet test.  No --block-file supplied" ));
-    return;
+    return 0L;
   }
 
 #if FD_HAS_HOSTED
@@ -180,6 +186,7 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
   FD_TEST( fd_rdisp_footprint( MAX_TXN_PER_BLOCK, 1UL )<TEST_FOOTPRINT );
   fd_rdisp_t * disp = fd_rdisp_join( fd_rdisp_new( footprint, MAX_TXN_PER_BLOCK, 1UL, SEED ) );
   FD_TEST( disp );
+  fd_rdisp_set_prio( disp, prio );
 
   long insert_duration = -fd_tickcount();
   FD_TEST( 0==fd_rdisp_add_block( disp, tag( 0UL ), staging_lane ) );
@@ -194,7 +201,8 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
     fd_acct_addr_t const * alt = (fd_acct_addr_t const *)(payload + payload_sz);
     FD_TEST( parse_ptr->acct_cnt<256U );
 
-    ulong txn_idx = fd_rdisp_add_txn( disp, tag( 0UL ), (fd_txn_t const *)_txn, payload, alt, 0 );
+    uint  cost    = fd_uint_if( !!(prio & FD_RDISP_PRIO_COST), parse_ptr->cus_consumed, 0U ); /* perfect estimates */
+    ulong txn_idx = fd_rdisp_add_txn( disp, tag( 0UL ), (fd_txn_t const *)_txn, payload, alt, 0, cost );
     FD_TEST( txn_idx>0UL );
 
     cus_consumed[ txn_idx ] = parse_ptr->cus_consumed;
@@ -253,6 +261,7 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
   }
   sched_duration += fd_tickcount();
 
+  FD_LOG_NOTICE(( "replaying with prio %i", prio ));
 # if FD_HAS_DOUBLE
   double ticks_per_ns = fd_tempo_tick_per_ns( NULL );
   FD_LOG_NOTICE(( "inserting %lu transactions took %f ms", txn_cnt, (double)insert_duration/ticks_per_ns * 1e-6 ));
@@ -264,12 +273,178 @@ test_mainnet( char const * filename       FD_PARAM_UNUSED,
         sched_duration, sched_duration+advanced_ticks, exec_cnt, ticks_per_cu ));
 # endif
 
+  fd_rdisp_delete( fd_rdisp_leave( disp ) );
   munmap( ptr, file_sz );
   close( fdesc );
 
+  return sched_duration+advanced_ticks;
+#else
+  return 0L;
 #endif
 }
 
+/* crit_path_makespan runs the block with tag blk in disp to completion
+   on exec_cnt simulated exec tiles, where every transaction takes one
+   unit of time, and returns the number of units taken.  txn_cnt is the
+   number of transactions in the block not yet completed. */
+
+static ulong
+crit_path_makespan( fd_rdisp_t * disp,
+                    ulong        blk,
+                    ulong        txn_cnt,
+                    ulong        exec_cnt ) {
+  ulong running[ 8 ];
+  FD_TEST( exec_cnt<=8UL );
+  ulong t = 0UL;
+  while( txn_cnt ) {
+    ulong run_cnt = 0UL;
+    while( run_cnt<exec_cnt && 0UL!=(running[ run_cnt ]=fd_rdisp_get_next_ready( disp, tag( blk ) )) ) run_cnt++;
+    FD_TEST( run_cnt );
+    for( ulong i=0UL; i<run_cnt; i++ ) fd_rdisp_complete_txn( disp, running[ i ], 1 );
+    txn_cnt -= run_cnt;
+    t++;
+  }
+  return t;
+}
+
+/* test_crit_path builds a block in which a long chain of transactions
+   writing account A is queued behind transaction P, together with
+   independent transactions writing accounts that were hot in a prior
+   block (so their default score is better than the chain's).  With the
+   default priority, the chain head is only dispatched after the
+   independent work; with FD_RDISP_PRIO_CRITICAL_PATH, it goes first.
+   Returns the makespan in units. */
+
+static ulong
+test_crit_path( fd_rng_t * rng,
+                int        prio ) {
+# define CHAIN_LEN (20UL)
+# define HOT_CNT   (16UL)
+  FD_TEST( fd_rdisp_footprint( 256UL, 4UL )<=TEST_FOOTPRINT );
+  fd_rdisp_t * disp = fd_rdisp_join( fd_rdisp_new( footprint, 256UL, 4UL, SEED ) );   FD_TEST( disp );
+  FD_TEST( FD_RDISP_PRIO_DEFAULT==fd_rdisp_set_prio( disp, prio ) );
+
+  /* Warm up the reference EMA of accounts 0x100..0x10F */
+  FD_TEST( 0==fd_rdisp_add_block( disp, tag( 0UL ), 0UL ) );
+  for( ulong j=0UL; j<30UL; j++ ) {
+    for( ulong i=0UL; i<HOT_CNT; i++ ) {
+      ushort acct = (ushort)(0x8000U | (0x100U+i));
+      FD_TEST( add_txn2( disp, rng, tag( 0UL ), &acct, 1UL, 0U ) );
+    }
+    crit_path_makespan( disp, 0UL, HOT_CNT, 4UL );
+  }
+  FD_TEST( 0==fd_rdisp_remove_block( disp, tag( 0UL ) ) );
+
+  FD_TEST( 0==fd_rdisp_add_block( disp, tag( 1UL ), 0UL ) );
+  ushort a = (ushort)(0x8000U | 0x200U);
+  ulong  p = add_txn2( disp, rng, tag( 1UL ), &a, 1UL, 0U );
+  FD_TEST( p==fd_rdisp_get_next_ready( disp, tag( 1UL ) ) );
+  ulong chain[ CHAIN_LEN ];
+  for( ulong i=0UL; i<CHAIN_LEN; i++ ) FD_TEST( (chain[ i ]=add_txn2( disp, rng, tag( 1UL ), &a, 1UL, 0U )) );
+  for( ulong i=0UL; i<HOT_CNT; i++ ) {
+    ushort acct = (ushort)(0x8000U | (0x100U+i));
+    FD_TEST( add_txn2( disp, rng, tag( 1UL ), &acct, 1UL, 0U ) );
+  }
+  fd_rdisp_complete_txn( disp, p, 1 );
+
+  fd_rdisp_verify( disp, verify_scratch );
+  ulong next = fd_rdisp_get_next_ready( disp, tag( 1UL ) );
+  if( prio==FD_RDISP_PRIO_CRITICAL_PATH ) FD_TEST( next==chain[ 0 ] );
+  else                                    FD_TEST( next!=chain[ 0 ] );
+  fd_rdisp_complete_txn( disp, next, 1 );
+
+  ulong makespan = 1UL+crit_path_makespan( disp, 1UL, CHAIN_LEN+HOT_CNT-1UL, 2UL );
+  FD_TEST( 0==fd_rdisp_remove_block( disp, tag( 1UL ) ) );
+  fd_rdisp_delete( fd_rdisp_leave( disp ) );
+  return makespan;
+# undef HOT_CNT
+# undef CHAIN_LEN
+}
+
+/* cost_makespan is like crit_path_makespan, but transaction txn_idx
+   takes dur[ txn_idx ] units of time. */
+
+static ulong
+cost_makespan( fd_rdisp_t  * disp,
+               ulong         blk,
+               ulong         txn_cnt,
+               ulong         exec_cnt,
+               uint const *  dur ) {
+  ulong running[ 8 ]; ulong end[ 8 ];
+  FD_TEST( exec_cnt<=8UL );
+  for( ulong i=0UL; i<exec_cnt; i++ ) { running[ i ] = 0UL; end[ i ] = 0UL; }
+  ulong t = 0UL;
+  while( txn_cnt ) {
+    for( ulong i=0UL; i<exec_cnt; i++ ) {
+      if( running[ i ] ) continue;
+      running[ i ] = fd_rdisp_get_next_ready( disp, tag( blk ) );
+      end    [ i ] = t+dur[ running[ i ] ];
+    }
+    ulong t_next = ULONG_MAX;
+    for( ulong i=0UL; i<exec_cnt; i++ ) if( running[ i ] ) t_next = fd_ulong_min( t_next, end[ i ] );
+    FD_TEST( t_next!=ULONG_MAX );
+    t = t_next;
+    for( ulong i=0UL; i<exec_cnt; i++ ) {
+      if( !running[ i ] || end[ i ]!=t ) continue;
+      fd_rdisp_complete_txn( disp, running[ i ], 1 );
+      running[ i ] = 0UL;
+      txn_cnt--;
+    }
+  }
+  return t;
+}
+
+/* test_cost builds a block of independent transactions: SHORT_CNT
+   short ones writing accounts that were hot in a prior block, followed
+   by LONG_CNT that take LONG_DUR times as long.  With the default
+   priority, the short ones go first and the long ones end up
+   serialized at the tail of the block.  With FD_RDISP_PRIO_COST and
+   accurate cost estimates, the long ones start first and the short ones
+   fill in around them.  Returns the makespan on 2 exec tiles. */
+
+static ulong
+test_cost( fd_rng_t * rng,
+           int        prio ) {
+# define SHORT_CNT (6UL)
+# define LONG_CNT  (3UL)
+# define LONG_DUR  (4U)
+  FD_TEST( fd_rdisp_footprint( 256UL, 4UL )<=TEST_FOOTPRINT );
+  fd_rdisp_t * disp = fd_rdisp_join( fd_rdisp_new( footprint, 256UL, 4UL, SEED ) );   FD_TEST( disp );
+  FD_TEST( FD_RDISP_PRIO_DEFAULT==fd_rdisp_set_prio( disp, prio ) );
+
+  FD_TEST( 0==fd_rdisp_add_block( disp, tag( 0UL ), 0UL ) );
+  for( ulong j=0UL; j<30UL; j++ ) {
+    for( ulong i=0UL; i<SHORT_CNT; i++ ) {
+      ushort acct = (ushort)(0x8000U | (0x100U+i));
+      FD_TEST( add_txn2( disp, rng, tag( 0UL ), &acct, 1UL, 1U ) );
+    }
+    crit_path_makespan( disp, 0UL, SHORT_CNT, 4UL );
+  }
+  FD_TEST( 0==fd_rdisp_remove_block( disp, tag( 0UL ) ) );
+
+  uint dur[ 257 ] = { 0 };
+  FD_TEST( 0==fd_rdisp_add_block( disp, tag( 1UL ), 0UL ) );
+  for( ulong i=0UL; i<SHORT_CNT; i++ ) {
+    ushort acct = (ushort)(0x8000U | (0x100U+i));
+    ulong  idx  = add_txn2( disp, rng, tag( 1UL ), &acct, 1UL, 1U );
+    FD_TEST( idx ); dur[ idx ] = 1U;
+  }
+  for( ulong i=0UL; i<LONG_CNT; i++ ) {
+    ushort acct = (ushort)(0x8000U | (0x200U+i));
+    ulong  idx  = add_txn2( disp, rng, tag( 1UL ), &acct, 1UL, LONG_DUR );
+    FD_TEST( idx ); dur[ idx ] = LONG_DUR;
+  }
+
+  fd_rdisp_verify( disp, verify_scratch );
+  ulong makespan = cost_makespan( disp, 1UL, SHORT_CNT+LONG_CNT, 2UL, dur );
+  FD_TEST( 0==fd_rdisp_remove_block( disp, tag( 1UL ) ) );
+  fd_rdisp_delete( fd_rdisp_leave( disp ) );
+  return makespan;
+# undef LONG_DUR
+# undef LONG_CNT
+# undef SHORT_CNT
+}
+
 #define SORT_NAME sn_sort
 #define SORT_KEY_T ulong
 #define SORT_BEFORE(a,b) (a)<(b)
@@ -397,7 +572,7 @@ random_test( fd_rng_t * rng,
         insert_cnt = fd_ulong_min( insert_cnt, 64UL-d[l].inserted_cnt );
         for( ulong i=0UL; i<insert_cnt; i++ ) {
           ulong txn = d[l].inserted_cnt + i;
-          d[l].txn_id[txn] = (uchar)add_txn2( disp, rng, tag( l ), d[l].acct[txn], d[l].acct_cnt[txn] );
+          d[l].txn_id[txn] = (uchar)add_txn2( disp, rng, tag( l ), d[l].acct[txn], d[l].acct_cnt[txn], 0U );
           d[l].internal_id[ d[l].txn_id[ txn ] ] = (uchar)txn;
           if( log_details ) FD_LOG_NOTICE(( "Lane %lu internal id %lu has txnid %hhu", l, txn, d[l].txn_id[txn] ));
         }
@@ -453,9 +628,29 @@ main( int     argc,
   ulong        rand_iters = fd_env_strip_cmdline_ulong ( &argc, &argv, "--random-iterations", NULL, 200UL );
   FD_LOG_NOTICE(( "Using --random-iterations %lu", rand_iters ));
 
-  FD_TEST( fd_rdisp_footprint( 65536UL, 2048UL )==474898560UL );
+  FD_TEST( fd_rdisp_footprint( 65536UL, 2048UL )==475684992UL );
+
+  long default_ticks = test_mainnet( block_file, exec_tiles, 20UL, 0UL, 1, FD_RDISP_PRIO_DEFAULT       );
+  long crit_ticks    = test_mainnet( block_file, exec_tiles, 20UL, 0UL, 1, FD_RDISP_PRIO_CRITICAL_PATH );
+  long cost_ticks    = test_mainnet( block_file, exec_tiles, 20UL, 0UL, 1, FD_RDISP_PRIO_CRITICAL_PATH|FD_RDISP_PRIO_COST );
+# if FD_HAS_DOUBLE
+  if( block_file ) FD_LOG_NOTICE(( "critical path priority: estimated total time %li ticks vs %li ticks (%+.2f%%)",
+                                   crit_ticks, default_ticks, 100.0*(double)(crit_ticks-default_ticks)/(double)fd_long_max( default_ticks, 1L ) ));
+  if( block_file ) FD_LOG_NOTICE(( "critical path and cost priority: estimated total time %li ticks vs %li ticks (%+.2f%%)",
+                                   cost_ticks, default_ticks, 100.0*(double)(cost_ticks-default_ticks)/(double)fd_long_max( default_ticks, 1L ) ));
+# else
+  (void)default_ticks; (void)crit_ticks; (void)cost_ticks;
+# endif
+
+  ulong default_span = test_crit_path( rng, FD_RDISP_PRIO_DEFAULT       );
+  ulong crit_span    = test_crit_path( rng, FD_RDISP_PRIO_CRITICAL_PATH );
+  FD_LOG_NOTICE(( "hot chain makespan: %lu units with default priority, %lu with critical path priority", default_span, crit_span ));
+  FD_TEST( crit_span<default_span );
 
-  test_mainnet( block_file, exec_tiles, 20UL, 0UL, 1 );
+  ulong default_cost_span = test_cost( rng, FD_RDISP_PRIO_DEFAULT );
+  ulong cost_span         = test_cost( rng, FD_RDISP_PRIO_COST    );
+  FD_LOG_NOTICE(( "mixed cost makespan: %lu units with default priority, %lu with cost priority", default_cost_span, cost_span ));
+  FD_TEST( cost_span<default_cost_span );
 
   ulong depth       = 100UL;
   ulong block_depth = 10UL;
@@ -708,7 +903,7 @@ main( int     argc,
         acct_idx += (ushort)(fd_rng_ushort_roll( rng, 5 ) + 1); /* no duplicate accounts possible */
         accts[j] = (ushort)((ulong)acct_idx | (((i|j)&1UL)<<15));
       }
-      add_txn2( disp, rng, tag( block_tag ), accts, 63UL ); /* fee payer added */
+      add_txn2( disp, rng, tag( block_tag ), accts, 63UL, 0U ); /* fee payer added */
     }
     fd_rdisp_verify( disp, verify_scratch );
 
@@ -743,7 +938,7 @@ main( int     argc,
      we get unlucky and they are all immediate. */
   for( ulong iter=0UL; iter<USHORT_MAX/37UL; iter++ ) {
     for( ulong j=0UL; j<37UL; j++ ) accts[j] = (ushort)(37UL*iter + j);
-    ulong txn_idx = add_txn2( disp, rng, tag( 0UL ), accts, 37UL );
+    ulong txn_idx = add_txn2( disp, rng, tag( 0UL ), accts, 37UL, 0U );
     FD_TEST( txn_idx==fd_rdisp_get_next_ready( disp, tag( 0UL ) ) );
     txn_idxs[txn_cnt++] = txn_idx;
     if( FD_UNLIKELY( txn_cnt==100UL ) ) while( txn_cnt ) fd_rdisp_complete_txn( disp, txn_idxs[--txn_cnt], 1 );
@@ -12,7 +12,7 @@
 
 static void
 test_sched_footprint( void ) {
-  FD_TEST( fd_sched_footprint( 512UL, 4UL )==14043648UL );
+  FD_TEST( fd_sched_footprint( 512UL, 4UL )==14070272UL );
 }
 
 static void
@@ -272,6 +272,120 @@ run_lane_policy_case( void ) {
   free( mem );
 }
 
+/* encode_txn writes a minimal legacy transaction with a single
+   signer/writable account derived from seed and no instructions. */
+static ulong
+encode_txn( uchar * out,
+            ulong   seed ) {
+  ulong off = 0UL;
+  out[ off++ ] = 1;                              /* signature count */
+  fd_memset( out+off, (int)(seed&0xffUL), 64UL ); off += 64UL;
+  out[ off++ ] = 1; out[ off++ ] = 0; out[ off++ ] = 0; /* header */
+  out[ off++ ] = 1;                              /* account count */
+  fd_memset( out+off, 0, 32UL ); FD_STORE( ulong, out+off, seed ); off += 32UL;
+  fd_memset( out+off, 0x11, 32UL ); off += 32UL; /* recent blockhash */
+  out[ off++ ] = 0;                              /* instruction count */
+  return off;
+}
+
+static void
+run_prefetch_case( void ) {
+  ulong depth         = fd_ulong_max( FD_SCHED_MIN_DEPTH, 512UL );
+  ulong block_cnt_max = 4UL;
+  ulong footprint     = fd_sched_footprint( depth, block_cnt_max );
+  void * mem          = aligned_alloc( fd_sched_align(), footprint );
+  FD_TEST( mem );
+
+  fd_rng_t rng[1]; fd_rng_join( fd_rng_new( rng, 0U, 0UL ) );
+  fd_sched_t * sched = fd_sched_join( fd_sched_new( mem, rng, depth, block_cnt_max, TEST_EXEC_CNT ) );
+  FD_TEST( sched );
+  fd_sched_set_bypass_poh_verify( sched, 1 );
+  fd_sched_set_bypass_alut_resolution( sched, 1 );
+
+  ulong bank_idx = 0UL;
+  FD_TEST( fd_sched_prefetch_next( sched, &bank_idx )==ULONG_MAX );
+  fd_sched_set_prefetch_depth( sched, 2UL );
+  FD_TEST( fd_sched_prefetch_next( sched, &bank_idx )==ULONG_MAX );
+
+  fd_sched_block_add_done( sched, 1UL, ULONG_MAX, TEST_ROOT_SLOT );
+
+  /* One microblock with 8 non-conflicting transactions. */
+  #define TXN_CNT (8UL)
+  uchar encoded[ 2048 ] = {0};
+  ulong sz = 0UL;
+  FD_STORE( ulong, encoded, 1UL ); sz += sizeof(ulong);
+  fd_microblock_hdr_t hdr = { .hash_cnt = 1UL, .txn_cnt = TXN_CNT };
+  fd_memcpy( encoded+sz, &hdr, sizeof(fd_microblock_hdr_t) ); sz += sizeof(fd_microblock_hdr_t);
+  for( ulong i=0UL; i<TXN_CNT; i++ ) sz += encode_txn( encoded+sz, i+1UL );
+  FD_TEST( sz<=sizeof(encoded) );
+
+  fd_store_fec_t store_fec[ 1 ] __attribute__((aligned(alignof(fd_store_fec_t))));
+  fd_memset( store_fec, 0, sizeof(fd_store_fec_t) );
+  store_fec->data_sz       = sz;
+  store_fec->shred_offs[0] = (uint)sz;
+
+  fd_sched_fec_t fec[ 1 ] = {{
+    .bank_idx          = 2UL,
+    .parent_bank_idx   = 1UL,
+    .slot              = TEST_ROOT_SLOT + 1UL,
+    .parent_slot       = TEST_ROOT_SLOT,
+    .fec               = store_fec,
+    .data              = encoded,
+    .shred_cnt         = 1U,
+    .is_last_in_batch  = 1U,
+    .is_last_in_block  = 0U,
+    .is_first_in_block = 1U
+  }};
+  FD_TEST( fd_sched_fec_can_ingest( sched, fec ) );
+  FD_TEST( fd_sched_fec_ingest( sched, fec ) );
+  fd_hash_t start_poh[ 1 ];
+  hash_from_seed( start_poh, 0x2f6c0d9b31e4a857UL );
+  fd_sched_set_poh_params( sched, 2UL, TEST_ROOT_TICK_HEIGHT, TEST_ROOT_TICK_HEIGHT + 1UL, 1UL, start_poh );
+
+  fd_sched_task_t task[ 1 ];
+  while( fd_sched_pruned_block_next( sched )!=ULONG_MAX ) {}
+  FD_TEST( 1UL==fd_sched_task_next_ready( sched, task ) );
+  FD_TEST( task->task_type==FD_SCHED_TT_BLOCK_START );
+  FD_TEST( 0==fd_sched_task_done( sched, FD_SCHED_TT_BLOCK_START, ULONG_MAX, ULONG_MAX, NULL ) );
+
+  /* Lookahead caps the number of outstanding prefetches. */
+  ulong pf0 = fd_sched_prefetch_next( sched, &bank_idx );
+  FD_TEST( pf0!=ULONG_MAX && bank_idx==2UL );
+  ulong pf1 = fd_sched_prefetch_next( sched, &bank_idx );
+  FD_TEST( pf1!=ULONG_MAX && pf1!=pf0 );
+  FD_TEST( fd_sched_prefetch_next( sched, &bank_idx )==ULONG_MAX );
+  FD_TEST( fd_sched_get_txn_info( sched, pf0 )->flags & FD_SCHED_TXN_PREFETCHED );
+
+  /* Dispatch one transaction per exec tile.  Only two of them can have
+     been prefetched, the others arrived late. */
+  ulong dispatched[ TEST_EXEC_CNT ];
+  ulong hit_cnt = 0UL;
+  for( ulong i=0UL; i<TEST_EXEC_CNT; i++ ) {
+    FD_TEST( 1UL==fd_sched_task_next_ready( sched, task ) );
+    FD_TEST( task->task_type==FD_SCHED_TT_TXN_EXEC );
+    dispatched[ i ] = task->txn_exec->txn_idx;
+    hit_cnt += !!(fd_sched_get_txn_info( sched, dispatched[ i ] )->flags & FD_SCHED_TXN_PREFETCHED);
+  }
+  FD_TEST( hit_cnt<=2UL );
+
+  /* The prefetcher skips past dispatched transactions and never hands
+     out the same transaction twice. */
+  ulong handed_out = 2UL;
+  ulong txn_idx;
+  while( (txn_idx=fd_sched_prefetch_next( sched, &bank_idx ))!=ULONG_MAX ) {
+    FD_TEST( txn_idx!=pf0 && txn_idx!=pf1 );
+    for( ulong i=0UL; i<TEST_EXEC_CNT; i++ ) FD_TEST( txn_idx!=dispatched[ i ] );
+    FD_TEST( fd_sched_get_txn_info( sched, txn_idx )->tick_exec_disp==LONG_MAX );
+    handed_out++;
+  }
+  FD_TEST( handed_out<=TXN_CNT-TEST_EXEC_CNT+hit_cnt );
+  FD_TEST( handed_out>2UL );
+  #undef TXN_CNT
+
+  fd_sched_delete( fd_sched_leave( sched ) );
+  free( mem );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -280,6 +394,7 @@ main( int     argc,
   test_sched_footprint();
   run_lane_policy_case();
   run_bad_tick_cases();
+  run_prefetch_case();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
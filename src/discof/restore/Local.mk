@@ -19,6 +19,7 @@ $(call add-objs,utils/fd_ssload,fd_discof)
 $(call add-objs,utils/fd_ssping,fd_discof)
 $(call add-objs,utils/fd_http_resolver,fd_discof)
 $(call add-objs,utils/fd_slot_delta_parser,fd_discof)
+$(call add-objs,utils/fd_sszstd,fd_discof)
 $(call make-unit-test,test_ssmanifest_parser,utils/test_ssmanifest_parser,fd_discof fd_flamenco fd_ballet fd_util)
 $(call make-unit-test,test_slot_delta_parser,utils/test_slot_delta_parser,fd_discof fd_flamenco fd_ballet fd_util)
 $(call make-unit-test,test_sspeer_selector,utils/test_sspeer_selector,fd_discof fd_flamenco fd_ballet fd_util)
@@ -31,6 +32,10 @@ $(call run-unit-test,test_sspeer_selector)
 $(call run-unit-test,test_ssarchive)
 $(call run-unit-test,test_ssparse)
 $(call run-unit-test,test_ssload)
+ifdef FD_HAS_ZSTD
+$(call make-unit-test,test_sszstd,utils/test_sszstd,fd_discof fd_util)
+$(call run-unit-test,test_sszstd)
+endif # FD_HAS_ZSTD
 
 $(call make-fuzz-test,fuzz_snapshot_parser,utils/fuzz_snapshot_parser,fd_discof fd_flamenco fd_ballet fd_util)
 $(call make-fuzz-test,fuzz_ssmanifest_parser,utils/fuzz_ssmanifest_parser,fd_discof fd_flamenco fd_ballet fd_util)
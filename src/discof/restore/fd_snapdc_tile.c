@@ -1,4 +1,5 @@
 #include "utils/fd_ssctrl.h"
+#include "utils/fd_sszstd.h"
 
 #include "../../disco/topo/fd_topo.h"
 #include "../../disco/metrics/fd_metrics.h"
@@ -12,10 +13,30 @@
 
 #define ZSTD_WINDOW_SZ (1UL<<25UL) /* 32MiB */
 
+#define FD_SNAPDC_TILE_MAX (16UL)
+
 /* The snapdc tile is a state machine that decompresses the full and
    optionally incremental snapshot byte stream that it receives from the
    snapld tile.  In the event that the snapshot is already uncompressed,
-   this tile simply copies the stream to the next tile in the pipeline. */
+   this tile simply copies the stream to the next tile in the pipeline.
+
+   Decompression can be spread over several snapdc tiles when the
+   stream is made of several zstd frames, as the snapshots produced by
+   snapmk are.  All snapdc tiles consume the full compressed stream.
+   Frame i is decompressed by tile i%tile_cnt, and every other tile
+   skips over it with a frame scanner that only reads frame and block
+   headers.  Helper tiles (kind_id>0) publish the output of their frames
+   on their own snapdc_dc link, followed by a FRAME_END frag.  Tile 0
+   decompresses its own frames directly onto snapdc_in, and copies the
+   output of helper frames onto snapdc_in in frame order, so snapin
+   sees the same stream as with a single tile.  A stream with one frame
+   is decompressed by tile 0 alone.
+
+   Only tile 0 takes part in the control message protocol with snapct.
+   Helpers track the state machine silently, and signal a failure by
+   publishing an ERROR frag in place of their next frame.  Helper frags
+   are tagged with the number of INIT messages seen (gen) so that tile 0
+   can drop output left over from an abandoned attempt. */
 
 struct fd_snapdc_tile {
   uint full    : 1;
@@ -23,6 +44,14 @@ struct fd_snapdc_tile {
   uint dirty   : 1;  /* in the middle of a frame? */
   int state;
 
+  ulong tile_idx;   /* kind_id of this snapdc tile */
+  ulong tile_cnt;   /* number of snapdc tiles */
+  ulong gen;        /* INIT messages seen, tags helper output */
+  ulong in_frame;   /* index of the frame the input is in */
+  ulong out_frame;  /* tile 0 only, index of the next frame to emit */
+
+  fd_sszstd_scan_t scan[1];
+
   ZSTD_DCtx * zstd;
 
   struct {
@@ -33,6 +62,16 @@ struct fd_snapdc_tile {
     ulong       frag_pos;
   } in;
 
+  /* Tile 0 only, the snapdc_dc links of the helpers, indexed by in_idx
+     (in 0 is snapld_dc). */
+  struct {
+    fd_wksp_t * mem;
+    ulong       chunk0;
+    ulong       wmark;
+    ulong       mtu;
+    ulong       helper;  /* kind_id of the producing helper */
+  } dc[ FD_SNAPDC_TILE_MAX ];
+
   struct {
     fd_wksp_t * mem;
     ulong       chunk0;
@@ -85,12 +124,21 @@ metrics_write( fd_snapdc_tile_t * ctx ) {
   FD_MGAUGE_SET( SNAPDC, STATE,                                   (ulong)(ctx->state) );
 }
 
+static inline ulong
+frame_owner( fd_snapdc_tile_t const * ctx,
+             ulong                    frame ) {
+  return frame%ctx->tile_cnt;
+}
+
+/* For helpers the ERROR frag goes to tile 0, which forwards it once it
+   reaches the helper's next frame. */
+
 static void
 transition_malformed( fd_snapdc_tile_t *  ctx,
                       fd_stem_context_t * stem ) {
   if( FD_UNLIKELY( ctx->state==FD_SNAPSHOT_STATE_ERROR ) ) return;
   ctx->state = FD_SNAPSHOT_STATE_ERROR;
-  fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_CTRL_ERROR, 0UL, 0UL, 0UL, 0UL, 0UL );
+  fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_CTRL_ERROR, 0UL, 0UL, 0UL, ctx->gen, 0UL );
 }
 
 static inline void
@@ -107,6 +155,13 @@ handle_control_frag( fd_snapdc_tile_t *  ctx,
     if( FD_UNLIKELY( ZSTD_isError( error ) ) ) FD_LOG_ERR(( "ZSTD_DCtx_reset failed (%lu-%s)", error, ZSTD_getErrorName( error ) ));
   }
 
+  /* Counted regardless of state so all snapdc tiles agree */
+  if( sig==FD_SNAPSHOT_MSG_CTRL_INIT_FULL || sig==FD_SNAPSHOT_MSG_CTRL_INIT_INCR ) ctx->gen++;
+
+  /* Helpers follow the state machine but only tile 0 publishes control
+     messages. */
+  int merge = !ctx->tile_idx;
+
   if( ctx->state==FD_SNAPSHOT_STATE_ERROR && sig!=FD_SNAPSHOT_MSG_CTRL_FAIL ) {
     /* Control messages move along the snapshot load pipeline.  Since
        error conditions can be triggered by any tile in the pipeline,
@@ -118,6 +173,7 @@ handle_control_frag( fd_snapdc_tile_t *  ctx,
   if( FD_UNLIKELY( sig==FD_SNAPSHOT_MSG_META ) ) {
     /* Forward META to snapin so it can update the advertised
        slot/hash for redirect-based downloads. */
+    if( FD_UNLIKELY( !merge ) ) return;
     FD_TEST( sz<=ctx->out.mtu );
     void * dst = fd_chunk_to_laddr( ctx->out.mem, ctx->out.chunk );
     fd_memcpy( dst, fd_chunk_to_laddr_const( ctx->in.mem, chunk ), sz );
@@ -139,6 +195,9 @@ handle_control_frag( fd_snapdc_tile_t *  ctx,
       ctx->is_zstd = !!msg->zstd;
       ctx->dirty = 0;
       ctx->in.frag_pos = 0UL;
+      ctx->in_frame  = 0UL;
+      ctx->out_frame = 0UL;
+      fd_sszstd_scan_init( ctx->scan );
       if( ctx->full ) {
         ctx->metrics.full.compressed_bytes_read      = 0UL;
         ctx->metrics.full.decompressed_bytes_written = 0UL;
@@ -146,10 +205,12 @@ handle_control_frag( fd_snapdc_tile_t *  ctx,
         ctx->metrics.incremental.compressed_bytes_read      = 0UL;
         ctx->metrics.incremental.decompressed_bytes_written = 0UL;
       }
-      fd_ssctrl_init_t * msg_out = fd_chunk_to_laddr( ctx->out.mem, ctx->out.chunk );
-      fd_memcpy( msg_out, msg, sz );
-      fd_stem_publish( stem, 0UL, sig, ctx->out.chunk, sz, 0UL, 0UL, 0UL );
-      ctx->out.chunk = fd_dcache_compact_next( ctx->out.chunk, ctx->out.mtu, ctx->out.chunk0, ctx->out.wmark );
+      if( FD_LIKELY( merge ) ) {
+        fd_ssctrl_init_t * msg_out = fd_chunk_to_laddr( ctx->out.mem, ctx->out.chunk );
+        fd_memcpy( msg_out, msg, sz );
+        fd_stem_publish( stem, 0UL, sig, ctx->out.chunk, sz, 0UL, 0UL, 0UL );
+        ctx->out.chunk = fd_dcache_compact_next( ctx->out.chunk, ctx->out.mtu, ctx->out.chunk0, ctx->out.wmark );
+      }
       forward_msg = 0; // we forward the control message in the `fd_ssctrl_init_t` message
       break;
     }
@@ -157,7 +218,7 @@ handle_control_frag( fd_snapdc_tile_t *  ctx,
     case FD_SNAPSHOT_MSG_CTRL_FINI: {
       FD_TEST( ctx->state==FD_SNAPSHOT_STATE_PROCESSING );
       ctx->state = FD_SNAPSHOT_STATE_FINISHING;
-      if( FD_UNLIKELY( ctx->is_zstd && ctx->dirty ) ) {
+      if( FD_UNLIKELY( merge && ctx->is_zstd && ( ctx->dirty || !fd_sszstd_scan_idle( ctx->scan ) ) ) ) {
         FD_LOG_WARNING(( "encountered end-of-file in the middle of a compressed frame for %s snapshot",
                          ctx->full ? "full" : "incremental" ));
         transition_malformed( ctx, stem );
@@ -201,7 +262,7 @@ handle_control_frag( fd_snapdc_tile_t *  ctx,
   }
 
   /* Forward the control message down the pipeline */
-  if( FD_LIKELY( forward_msg ) ) {
+  if( FD_LIKELY( merge && forward_msg ) ) {
     fd_stem_publish( stem, 0UL, sig, 0UL, 0UL, 0UL, 0UL, 0UL );
   }
 }
@@ -227,6 +288,7 @@ handle_data_frag( fd_snapdc_tile_t *  ctx,
   uchar * out = fd_chunk_to_laddr( ctx->out.mem, ctx->out.chunk );
 
   if( FD_UNLIKELY( !ctx->is_zstd ) ) {
+    if( FD_UNLIKELY( ctx->tile_idx ) ) return 0;
     FD_TEST( ctx->in.frag_pos<sz );
     ulong cpy = fd_ulong_min( sz-ctx->in.frag_pos, ctx->out.mtu );
     fd_memcpy( out, in, cpy );
@@ -248,6 +310,33 @@ handle_data_frag( fd_snapdc_tile_t *  ctx,
     return 0;
   }
 
+  if( FD_UNLIKELY( frame_owner( ctx, ctx->in_frame )!=ctx->tile_idx ) ) {
+    /* Another snapdc tile decompresses this frame, skip over it */
+    int   frame_end;
+    ulong consumed = fd_sszstd_scan( ctx->scan, in, sz-ctx->in.frag_pos, &frame_end );
+    if( FD_UNLIKELY( consumed==ULONG_MAX ) ) {
+      FD_LOG_WARNING(( "malformed zstd frame in %s snapshot", ctx->full ? "full" : "incremental" ));
+      transition_malformed( ctx, stem );
+      return 0;
+    }
+    ctx->in_frame    += (ulong)frame_end;
+    ctx->in.frag_pos += consumed;
+    FD_TEST( ctx->in.frag_pos<=sz );
+
+    if( FD_LIKELY( !ctx->tile_idx ) ) {
+      if( FD_LIKELY( ctx->full ) ) ctx->metrics.full.compressed_bytes_read        += consumed;
+      else                         ctx->metrics.incremental.compressed_bytes_read += consumed;
+    }
+
+    if( FD_LIKELY( ctx->in.frag_pos<sz ) ) return 1;
+    ctx->in.frag_pos = 0UL;
+    return 0;
+  }
+
+  /* Tile 0 publishes its own frames directly, so first wait for the
+     output of all earlier frames from the helpers. */
+  if( FD_UNLIKELY( !ctx->tile_idx && ctx->out_frame<ctx->in_frame ) ) return 1;
+
   ulong in_consumed = 0UL, out_produced = 0UL;
   ulong frame_res = ZSTD_decompressStream_simpleArgs(
       ctx->zstd,
@@ -261,13 +350,12 @@ handle_data_frag( fd_snapdc_tile_t *  ctx,
     FD_LOG_WARNING(( "error while decompressing %s snapshot (%u-%s)",
                      ctx->full ? "full" : "incremental",
                      ZSTD_getErrorCode( frame_res ), ZSTD_getErrorName( frame_res ) ));
-    ctx->state = FD_SNAPSHOT_STATE_ERROR;
-    fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_CTRL_ERROR, 0UL, 0UL, 0UL, 0UL, 0UL );
+    transition_malformed( ctx, stem );
     return 0;
   }
 
   if( FD_LIKELY( out_produced ) ) {
-    fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_DATA, ctx->out.chunk, out_produced, 0UL, 0UL, 0UL );
+    fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_DATA, ctx->out.chunk, out_produced, 0UL, ctx->gen, 0UL );
     ctx->out.chunk = fd_dcache_compact_next( ctx->out.chunk, out_produced, ctx->out.chunk0, ctx->out.wmark );
   }
 
@@ -284,6 +372,12 @@ handle_data_frag( fd_snapdc_tile_t *  ctx,
 
   ctx->dirty = frame_res!=0UL;
 
+  if( FD_UNLIKELY( !frame_res ) ) {
+    ctx->in_frame++;
+    if( FD_LIKELY( ctx->tile_idx ) ) fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_FRAME_END, 0UL, 0UL, 0UL, ctx->gen, 0UL );
+    else                             ctx->out_frame++;
+  }
+
   /* frame_res==0 means the frame ended exactly at the output boundary;
      re-polling then reports "new frame expected" and would mark the
      stream dirty at a clean EOF. */
@@ -292,22 +386,73 @@ handle_data_frag( fd_snapdc_tile_t *  ctx,
   return maybe_more_output;
 }
 
+/* handle_helper_frag runs on tile 0 for frags from the snapdc_dc link
+   of a helper.  Frags are consumed only when the helper's frame is the
+   next one to emit, so frames reach snapdc_in in stream order. */
+
+static inline int
+handle_helper_frag( fd_snapdc_tile_t *  ctx,
+                    fd_stem_context_t * stem,
+                    ulong               in_idx,
+                    ulong               sig,
+                    ulong               chunk,
+                    ulong               sz,
+                    ulong               tsorig ) {
+  uint gen = (uint)ctx->gen;
+  if( FD_UNLIKELY( (uint)tsorig!=gen ) ) {
+    /* The helper either saw an INIT that we have not yet, or this frag
+       is left over from an abandoned attempt. */
+    return (int)((int)((uint)tsorig-gen)>0);
+  }
+  if( FD_UNLIKELY( ctx->state!=FD_SNAPSHOT_STATE_PROCESSING ) ) return 0;
+  if( FD_LIKELY( frame_owner( ctx, ctx->out_frame )!=ctx->dc[ in_idx ].helper ) ) return 1;
+
+  switch( sig ) {
+    case FD_SNAPSHOT_MSG_DATA: {
+      FD_TEST( chunk>=ctx->dc[ in_idx ].chunk0 && chunk<=ctx->dc[ in_idx ].wmark && sz<=ctx->dc[ in_idx ].mtu && sz<=ctx->out.mtu );
+      fd_memcpy( fd_chunk_to_laddr( ctx->out.mem, ctx->out.chunk ), fd_chunk_to_laddr_const( ctx->dc[ in_idx ].mem, chunk ), sz );
+      fd_stem_publish( stem, 0UL, FD_SNAPSHOT_MSG_DATA, ctx->out.chunk, sz, 0UL, ctx->gen, 0UL );
+      ctx->out.chunk = fd_dcache_compact_next( ctx->out.chunk, sz, ctx->out.chunk0, ctx->out.wmark );
+      if( FD_LIKELY( ctx->full ) ) ctx->metrics.full.decompressed_bytes_written        += sz;
+      else                         ctx->metrics.incremental.decompressed_bytes_written += sz;
+      break;
+    }
+    case FD_SNAPSHOT_MSG_FRAME_END: {
+      ctx->out_frame++;
+      break;
+    }
+    case FD_SNAPSHOT_MSG_CTRL_ERROR: {
+      transition_malformed( ctx, stem );
+      break;
+    }
+    default: {
+      FD_LOG_ERR(( "unexpected frag %s (%lu) from snapdc helper %lu", fd_ssctrl_msg_ctrl_str( sig ), sig, ctx->dc[ in_idx ].helper ));
+    }
+  }
+  return 0;
+}
+
 static inline int
 returnable_frag( fd_snapdc_tile_t *  ctx,
-                 ulong               in_idx FD_PARAM_UNUSED,
+                 ulong               in_idx,
                  ulong               seq    FD_PARAM_UNUSED,
                  ulong               sig,
                  ulong               chunk,
                  ulong               sz,
                  ulong               ctl    FD_PARAM_UNUSED,
-                 ulong               tsorig FD_PARAM_UNUSED,
+                 ulong               tsorig,
                  ulong               tspub  FD_PARAM_UNUSED,
                  fd_stem_context_t * stem ) {
   FD_TEST( ctx->state!=FD_SNAPSHOT_STATE_SHUTDOWN );
 
+  if( FD_UNLIKELY( in_idx ) ) return handle_helper_frag( ctx, stem, in_idx, sig, chunk, sz, tsorig );
+
   if( FD_LIKELY( sig==FD_SNAPSHOT_MSG_DATA ) ) return handle_data_frag( ctx, stem, chunk, sz );
-  else                                                handle_control_frag( ctx, stem, sig, chunk, sz );
 
+  /* Hold FINI until the helpers have delivered every frame */
+  if( FD_UNLIKELY( sig==FD_SNAPSHOT_MSG_CTRL_FINI && ctx->state==FD_SNAPSHOT_STATE_PROCESSING && ctx->out_frame<ctx->in_frame ) ) return 1;
+
+  handle_control_frag( ctx, stem, sig, chunk, sz );
   return 0;
 }
 
@@ -355,11 +500,31 @@ unprivileged_init( fd_topo_t const *      topo,
   ctx->in.frag_pos = 0UL;
   fd_memset( &ctx->metrics, 0, sizeof(ctx->metrics) );
 
-  if( FD_UNLIKELY( tile->in_cnt !=1UL ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu ins, expected 1",  tile->in_cnt  ));
-  if( FD_UNLIKELY( tile->out_cnt!=1UL ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu outs, expected 1", tile->out_cnt ));
+  ctx->tile_idx  = tile->kind_id;
+  ctx->tile_cnt  = fd_topo_tile_name_cnt( topo, NAME );
+  ctx->gen       = 0UL;
+  ctx->in_frame  = 0UL;
+  ctx->out_frame = 0UL;
+  fd_sszstd_scan_init( ctx->scan );
+  if( FD_UNLIKELY( ctx->tile_cnt>FD_SNAPDC_TILE_MAX ) ) FD_LOG_ERR(( "too many `" NAME "` tiles %lu, max %lu", ctx->tile_cnt, FD_SNAPDC_TILE_MAX ));
+
+  /* Tile 0 consumes snapld_dc and every helper's snapdc_dc link */
+  ulong in_cnt = fd_ulong_if( !!ctx->tile_idx, 1UL, ctx->tile_cnt );
+  if( FD_UNLIKELY( tile->in_cnt !=in_cnt ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu ins, expected %lu", tile->in_cnt, in_cnt ));
+  if( FD_UNLIKELY( tile->out_cnt!=1UL    ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu outs, expected 1",  tile->out_cnt        ));
+
+  for( ulong i=1UL; i<in_cnt; i++ ) {
+    fd_topo_link_t const * dc_link = &topo->links[ tile->in_link_id[ i ] ];
+    FD_TEST( 0==strcmp( dc_link->name, "snapdc_dc" ) );
+    ctx->dc[ i ].mem    = topo->workspaces[ topo->objs[ dc_link->dcache_obj_id ].wksp_id ].wksp;
+    ctx->dc[ i ].chunk0 = fd_dcache_compact_chunk0( ctx->dc[ i ].mem, dc_link->dcache );
+    ctx->dc[ i ].wmark  = fd_dcache_compact_wmark ( ctx->dc[ i ].mem, dc_link->dcache, dc_link->mtu );
+    ctx->dc[ i ].mtu    = dc_link->mtu;
+    ctx->dc[ i ].helper = dc_link->kind_id+1UL; /* helper k publishes snapdc_dc k-1 */
+  }
 
   fd_topo_link_t const * snapin_link = &topo->links[ tile->out_link_id[ 0UL ] ];
-  FD_TEST( 0==strcmp( snapin_link->name, "snapdc_in" ) );
+  FD_TEST( 0==strcmp( snapin_link->name, ctx->tile_idx ? "snapdc_dc" : "snapdc_in" ) );
   ctx->out.mem    = topo->workspaces[ topo->objs[ snapin_link->dcache_obj_id ].wksp_id ].wksp;
   ctx->out.chunk0 = fd_dcache_compact_chunk0( ctx->out.mem, snapin_link->dcache );
   ctx->out.wmark  = fd_dcache_compact_wmark ( ctx->out.mem, snapin_link->dcache, snapin_link->mtu );
@@ -381,7 +546,8 @@ unprivileged_init( fd_topo_t const *      topo,
                  (ulong)scratch + scratch_footprint( tile ) ));
 }
 
-/* handle_data_frag can publish one data frag plus an error frag */
+/* handle_data_frag can publish one data frag plus an error or frame
+   end frag */
 #define STEM_BURST 2UL
 
 #define STEM_LAZY  (128L*3000L)
@@ -29,12 +29,36 @@
 /* The snapin tile is a state machine that parses and loads a full
    and optionally an incremental snapshot.  It is currently responsible
    for loading accounts into an in-memory database, though this may
-   change. */
+   change.
+
+   Indexing accounts into the accounts database can be spread over
+   several snapin tiles.  snapin 0 always parses the stream.  Any other
+   snapin tile is an inserter, which owns one shard of the accdb index
+   (see fd_accdb_snapshot_shard).  The parser reserves the disk space of
+   each account in stream order, as the snapwr tile lays out the file in
+   that order, and hands the account to its inserter over snapin_ix.
+   Inserters only hear about INIT, FINI, FAIL and SHUTDOWN.  The parser
+   holds FINI and FAIL until every inserter has forwarded them back over
+   snapin_rp, along with the outcome of the accounts it indexed, so
+   that all indexing is done before capitalization is checked or the
+   database is reset.
+
+   When accounts LtHash verification is enabled, the accounts LtHash of
+   the loaded snapshot is recomputed from the database once snapwr has
+   written everything out, i.e. on NEXT or DONE, and checked against
+   the manifest.  Each inserter hashes the live accounts of its own
+   shard and the parser sums the results, which it holds NEXT and DONE
+   for the same way.  Without inserters the parser hashes everything
+   itself. */
 
 /* 300 root slots in the slot deltas array, and each one references all
    151 prior blockhashes that it's able to. */
 #define FD_SNAPIN_MAX_SLOT_DELTA_GROUPS (300UL*151UL)
 
+#define FD_SNAPIN_TILE_MAX (16UL)
+
+FD_STATIC_ASSERT( FD_SSPARSE_ACC_BATCH_MAX<=FD_SSCTRL_IX_ACC_MAX, ix_acc_max );
+
 struct fd_blockhash_entry {
   fd_hash_t blockhash;
 
@@ -86,6 +110,8 @@ struct fd_snapin_tile {
   int  state;
   uint full      : 1;       /* loading a full snapshot? */
 
+  ulong tile_idx;           /* kind_id, 0 for the parser */
+
   ulong seed;
   long boot_timestamp;
 
@@ -133,6 +159,11 @@ struct fd_snapin_tile {
   ulong full_genesis_creation_time_seconds;
   uchar advertised_hash[ FD_HASH_FOOTPRINT ];
 
+  int               verify_lthash;
+  fd_lthash_value_t manifest_lthash; /* accounts lthash according to the current snapshot manifest */
+  fd_lthash_value_t lthash;          /* computed accounts lthash, summed over inserters */
+  uchar *           lthash_buf;      /* FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ bytes of scratch */
+
   ulong capitalization;          /* tracks capitalization of all loaded accounts in the current snapshot */
   ulong dup_capitalization;      /* tracks capitalization of duplicate accounts encountered during incremental snapshot loading */
   ulong manifest_capitalization; /* capitalization according to the current snapshot manifest */
@@ -186,6 +217,26 @@ struct fd_snapin_tile {
   fd_snapin_out_link_t manifest_out;
   fd_snapin_out_link_t gui_out;
 
+  /* ix_cnt is the number of inserters, 0 if the parser indexes accounts
+     itself, and is also the accdb shard count.  Parser only from here
+     on.  The batch pending for inserter i is built in place in the
+     current chunk of ix_out[ i ].  While ix_held is a held control
+     message (0 otherwise), ix_acked counts the inserters that forwarded
+     it back. */
+  ulong                ix_cnt;
+  fd_snapin_out_link_t ix_out[ FD_SNAPIN_TILE_MAX ];
+  ulong                ix_held;
+  ulong                ix_acked;
+  struct {
+    fd_wksp_t * wksp;
+    ulong       chunk0;
+    ulong       wmark;
+  } rp_in[ FD_SNAPIN_TILE_MAX ]; /* indexed by in_idx */
+
+  /* Inserter only */
+  fd_snapin_out_link_t  rp_out;
+  fd_ssctrl_ix_report_t report; /* since the last INIT */
+
   ulong gui_config_acct_sz;   /* total expected account data length (0 when not accumulating) */
   ulong gui_config_acct_off;  /* bytes accumulated so far into the current gui_out link chunk */
 
@@ -223,7 +274,7 @@ format_count( char * out, ulong out_sz, ulong n ) {
 
 static inline int
 should_shutdown( fd_snapin_tile_t * ctx ) {
-  if( FD_UNLIKELY( ctx->state==FD_SNAPSHOT_STATE_SHUTDOWN ) ) {
+  if( FD_UNLIKELY( ctx->state==FD_SNAPSHOT_STATE_SHUTDOWN && !ctx->tile_idx ) ) {
     ulong accounts_dup = ctx->metrics.accounts_ignored + ctx->metrics.accounts_replaced;
     long  elapsed_ns   = fd_log_wallclock() - ctx->boot_timestamp;
     char  loaded_buf[ 32 ];
@@ -245,6 +296,14 @@ static ulong
 scratch_footprint( fd_topo_tile_t const * tile ) {
   ulong l = FD_LAYOUT_INIT;
   l = FD_LAYOUT_APPEND( l, alignof(fd_snapin_tile_t),     sizeof(fd_snapin_tile_t)                                    );
+  if( tile->snapin.verify_lthash ) {
+    l = FD_LAYOUT_APPEND( l, 64UL,                        FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ                             );
+  }
+  if( FD_UNLIKELY( tile->kind_id ) ) {
+    /* Inserters only index accounts */
+    l = FD_LAYOUT_APPEND( l, fd_accdb_align(),            fd_accdb_footprint( tile->snapin.max_live_slots )           );
+    return FD_LAYOUT_FINI( l, scratch_align() );
+  }
   l = FD_LAYOUT_APPEND( l, fd_txncache_align(),           fd_txncache_footprint( tile->snapin.max_live_slots )        );
   l = FD_LAYOUT_APPEND( l, fd_accdb_align(),              fd_accdb_footprint( tile->snapin.max_live_slots )           );
   l = FD_LAYOUT_APPEND( l, fd_ssmanifest_parser_align(),  fd_ssmanifest_parser_footprint()                            );
@@ -259,6 +318,14 @@ metrics_write( fd_snapin_tile_t * ctx ) {
   fd_accdb_flush_metrics( ctx->accdb );
 
   FD_MGAUGE_SET( SNAPIN, STATE,                  (ulong)ctx->state );
+  if( FD_UNLIKELY( ctx->tile_idx ) ) {
+    /* Accounts an inserter indexed but has not yet reported, so the sum
+       over all snapin tiles is the live total. */
+    FD_MGAUGE_SET( SNAPIN, ACCOUNT_LOADED,   ctx->report.accounts_loaded   );
+    FD_MGAUGE_SET( SNAPIN, ACCOUNT_REPLACED, ctx->report.accounts_replaced );
+    FD_MGAUGE_SET( SNAPIN, ACCOUNT_IGNORED,  ctx->report.accounts_ignored  );
+    return;
+  }
   FD_MGAUGE_SET( SNAPIN, FULL_BYTES_READ,        ctx->metrics.full_bytes_read );
   FD_MGAUGE_SET( SNAPIN, INCREMENTAL_BYTES_READ, ctx->metrics.incremental_bytes_read );
   FD_MGAUGE_SET( SNAPIN, ACCOUNT_LOADED,         ctx->metrics.accounts_loaded );
@@ -741,6 +808,7 @@ process_manifest( fd_snapin_tile_t *  ctx,
   }
 
   ctx->bank_slot = manifest->slot;
+  fd_memcpy( ctx->manifest_lthash.bytes, manifest->accounts_lthash, FD_LTHASH_LEN_BYTES );
   ctx->manifest_capitalization = manifest->capitalization;
   if( FD_UNLIKELY( ctx->manifest_capitalization>LONG_MAX ) ) {
     /* Calculations downstream require capitalization to be treated
@@ -840,8 +908,88 @@ snoop_stake_delegation( fd_snapin_tile_t *  ctx,
       FD_STAKE_DELEGATIONS_WARMUP_COOLDOWN_RATE_ENUM_025 );
 }
 
+static inline fd_ssctrl_ix_batch_t *
+ix_batch( fd_snapin_tile_t * ctx,
+          ulong              i ) {
+  return fd_chunk_to_laddr( ctx->ix_out[ i ].mem, ctx->ix_out[ i ].chunk );
+}
+
+/* ix_publish publishes the batch pending for inserter i, if any, and
+   starts a new one. */
+
+static void
+ix_publish( fd_snapin_tile_t *  ctx,
+            fd_stem_context_t * stem,
+            ulong               i ) {
+  fd_snapin_out_link_t * out   = &ctx->ix_out[ i ];
+  fd_ssctrl_ix_batch_t * batch = ix_batch( ctx, i );
+  if( FD_UNLIKELY( !batch->cnt ) ) return;
+
+  batch->fork_id = ctx->full ? USHORT_MAX : ctx->accdb_incr_fork_id.val;
+  ulong sz = offsetof( fd_ssctrl_ix_batch_t, acc ) + batch->cnt*sizeof(fd_ssctrl_ix_acc_t);
+  fd_stem_publish( stem, out->idx, FD_SNAPSHOT_MSG_INDEX, out->chunk, sz, 0UL, 0UL, 0UL );
+  out->chunk = fd_dcache_compact_next( out->chunk, sz, out->chunk0, out->wmark );
+  ix_batch( ctx, i )->cnt = 0UL;
+}
+
+/* ix_forward forwards control message sig to every inserter.  Pending
+   batches are published first on FINI, and discarded on FAIL and
+   INIT.  NEXT and DONE carry an empty batch naming the fork to hash. */
+
+static void
+ix_forward( fd_snapin_tile_t *  ctx,
+            fd_stem_context_t * stem,
+            ulong               sig ) {
+  for( ulong i=0UL; i<ctx->ix_cnt; i++ ) {
+    fd_snapin_out_link_t * out = &ctx->ix_out[ i ];
+    if( sig==FD_SNAPSHOT_MSG_CTRL_FINI ) ix_publish( ctx, stem, i );
+    else                                 ix_batch( ctx, i )->cnt = 0UL;
+    if( FD_UNLIKELY( sig==FD_SNAPSHOT_MSG_CTRL_NEXT || sig==FD_SNAPSHOT_MSG_CTRL_DONE ) ) {
+      ix_batch( ctx, i )->fork_id = ctx->full ? USHORT_MAX : ctx->accdb_incr_fork_id.val;
+      ulong sz = offsetof( fd_ssctrl_ix_batch_t, acc );
+      fd_stem_publish( stem, out->idx, sig, out->chunk, sz, 0UL, 0UL, 0UL );
+      out->chunk = fd_dcache_compact_next( out->chunk, sz, out->chunk0, out->wmark );
+      ix_batch( ctx, i )->cnt = 0UL;
+      continue;
+    }
+    fd_stem_publish( stem, out->idx, sig, 0UL, 0UL, 0UL, 0UL, 0UL );
+  }
+}
+
+/* dispatch_account reserves disk space for an account and appends it
+   to the batch of the inserter owning it.  Capitalization counts the
+   account as loaded until the inserter reports otherwise.  Returns 1
+   if the batch filled up and was published, and 0 otherwise. */
+
+static int
+dispatch_account( fd_snapin_tile_t *  ctx,
+                  fd_stem_context_t * stem,
+                  uchar const *       pubkey,
+                  ulong               slot,
+                  ulong               lamports,
+                  ulong               data_len,
+                  int                 executable ) {
+  ulong                  i     = fd_accdb_snapshot_shard( ctx->accdb, pubkey, ctx->ix_cnt );
+  fd_ssctrl_ix_batch_t * batch = ix_batch( ctx, i );
+  fd_ssctrl_ix_acc_t *   acc   = &batch->acc[ batch->cnt++ ];
+  memcpy( acc->pubkey, pubkey, 32UL );
+  acc->slot       = slot;
+  acc->lamports   = lamports;
+  acc->data_len   = data_len;
+  acc->file_off   = fd_accdb_snapshot_reserve( ctx->accdb, data_len );
+  acc->executable = executable;
+
+  ctx->capitalization = fd_ulong_sat_add( ctx->capitalization, lamports );
+  ctx->metrics.total_accounts_processed++;
+
+  if( FD_LIKELY( batch->cnt<FD_SSCTRL_IX_ACC_MAX ) ) return 0;
+  ix_publish( ctx, stem, i );
+  return 1;
+}
+
 static int
 process_account_batch( fd_snapin_tile_t *            ctx,
+                       fd_stem_context_t *           stem,
                        fd_ssparse_advance_result_t * result ) {
   uchar const * const * entries    = result->account_batch.batch;
   ulong                 cnt        = result->account_batch.batch_cnt;
@@ -884,6 +1032,22 @@ process_account_batch( fd_snapin_tile_t *            ctx,
     }
   }
 
+  if( FD_UNLIKELY( ctx->ix_cnt ) ) {
+    ulong dup_i, dup_j;
+    if( FD_UNLIKELY( fd_accdb_snapshot_batch_dup( cnt, pubkeys, &dup_i, &dup_j ) ) ) {
+      FD_LOG_WARNING(( "corrupt snapshot: duplicate pubkey within a single batch (entries %lu and %lu)", dup_j, dup_i ));
+      return -1;
+    }
+    /* A batch holds at most FD_SSPARSE_ACC_BATCH_MAX accounts, so each
+       inserter batch fills up at most once here. */
+    int published = 0;
+    for( ulong i=0UL; i<cnt; i++ ) {
+      published |= dispatch_account( ctx, stem, pubkeys[ i ], slots[ i ], lamports[ i ], data_lens[ i ], executables[ i ] );
+    }
+    ctx->metrics.total_account_batches_processed++;
+    return published;
+  }
+
   ulong accounts_ignored, accounts_replaced, accounts_loaded, replaced_lamports, ignored_lamports;
   fd_accdb_fork_id_t fork_id = ctx->full ? (fd_accdb_fork_id_t){ .val = USHORT_MAX } : ctx->accdb_incr_fork_id;
   if( FD_UNLIKELY( 0!=fd_accdb_snapshot_write_batch( ctx->accdb, fork_id, cnt, pubkeys, slots, lamports, data_lens,
@@ -910,30 +1074,45 @@ process_account_batch( fd_snapin_tile_t *            ctx,
 }
 
 static int
-process_account_header( fd_snapin_tile_t * ctx,
+process_account_header( fd_snapin_tile_t *            ctx,
+                        fd_stem_context_t *           stem,
                         fd_ssparse_advance_result_t * result ) {
   ctx->metrics.total_account_batches_processed++;
-  ctx->metrics.total_accounts_processed++;
-  ulong replaced_lamports = 0UL;
-  fd_accdb_fork_id_t fork_id = ctx->full ? (fd_accdb_fork_id_t){ .val = USHORT_MAX } : ctx->accdb_incr_fork_id;
-  int account = fd_accdb_snapshot_write_one( ctx->accdb,
-                                             fork_id,
-                                             result->account_header.pubkey,
-                                             result->account_header.slot,
-                                             result->account_header.lamports,
-                                             result->account_header.data_len,
-                                             result->account_header.executable,
-                                             &replaced_lamports );
-  if( FD_UNLIKELY( -1==account ) ) {
-    ctx->metrics.accounts_ignored++;
+
+  /* With inserters, only the inserter learns whether the account was
+     ignored, so it is snooped like in the batch path. */
+  int early_exit = 0;
+  int account    = 1;
+  if( FD_UNLIKELY( ctx->ix_cnt ) ) {
+    early_exit = dispatch_account( ctx, stem,
+                                   result->account_header.pubkey,
+                                   result->account_header.slot,
+                                   result->account_header.lamports,
+                                   result->account_header.data_len,
+                                   result->account_header.executable );
   } else {
-    if( FD_UNLIKELY( 2==account ) ) {
-      ctx->metrics.accounts_replaced++;
-      ctx->dup_capitalization = fd_ulong_sat_add( ctx->dup_capitalization, replaced_lamports );
+    ctx->metrics.total_accounts_processed++;
+    ulong replaced_lamports = 0UL;
+    fd_accdb_fork_id_t fork_id = ctx->full ? (fd_accdb_fork_id_t){ .val = USHORT_MAX } : ctx->accdb_incr_fork_id;
+    account = fd_accdb_snapshot_write_one( ctx->accdb,
+                                           fork_id,
+                                           result->account_header.pubkey,
+                                           result->account_header.slot,
+                                           result->account_header.lamports,
+                                           result->account_header.data_len,
+                                           result->account_header.executable,
+                                           &replaced_lamports );
+    if( FD_UNLIKELY( -1==account ) ) {
+      ctx->metrics.accounts_ignored++;
     } else {
-      ctx->metrics.accounts_loaded++;
+      if( FD_UNLIKELY( 2==account ) ) {
+        ctx->metrics.accounts_replaced++;
+        ctx->dup_capitalization = fd_ulong_sat_add( ctx->dup_capitalization, replaced_lamports );
+      } else {
+        ctx->metrics.accounts_loaded++;
+      }
+      ctx->capitalization = fd_ulong_sat_add( ctx->capitalization, result->account_header.lamports );
     }
-    ctx->capitalization = fd_ulong_sat_add( ctx->capitalization, result->account_header.lamports );
   }
 
   /* Snoop SlotHistory sysvar.  Streaming path: arm the capture window
@@ -979,7 +1158,7 @@ process_account_header( fd_snapin_tile_t * ctx,
     ctx->stake_reasm.capturing = 1;
   }
 
-  return 0;
+  return early_exit;
 }
 
 static void
@@ -1138,7 +1317,7 @@ handle_data_frag( fd_snapin_tile_t *  ctx,
         break;
       }
       case FD_SSPARSE_ADVANCE_ACCOUNT_HEADER:
-        early_exit = process_account_header( ctx, result );
+        early_exit = process_account_header( ctx, stem, result );
         if( FD_UNLIKELY( early_exit<0 ) ) {
           transition_malformed( ctx, stem );
           return 0;
@@ -1186,7 +1365,7 @@ handle_data_frag( fd_snapin_tile_t *  ctx,
         }
         break;
       case FD_SSPARSE_ADVANCE_ACCOUNT_BATCH:
-        early_exit = process_account_batch( ctx, result );
+        early_exit = process_account_batch( ctx, stem, result );
         if( FD_UNLIKELY( early_exit<0 ) ) {
           transition_malformed( ctx, stem );
           return 0;
@@ -1230,6 +1409,36 @@ validate_capitalization( fd_snapin_tile_t * ctx ) {
   return 0;
 }
 
+/* verify_accounts_lthash checks the accounts LtHash of the accounts
+   database against the manifest at the end of a snapshot load.  With
+   inserters, ctx->lthash already holds the sum of their shards.
+   Returns 0 if verification passed or is disabled, -1 if not. */
+
+static int
+verify_accounts_lthash( fd_snapin_tile_t * ctx ) {
+  if( FD_LIKELY( !ctx->verify_lthash ) ) return 0;
+
+  long start = fd_log_wallclock();
+  if( !ctx->ix_cnt ) {
+    fd_accdb_fork_id_t fork_id = { .val = ctx->full ? USHORT_MAX : ctx->accdb_incr_fork_id.val };
+    fd_lthash_zero( &ctx->lthash );
+    fd_accdb_snapshot_lthash( ctx->accdb, fork_id, 0UL, 1UL, ctx->lthash_buf, &ctx->lthash );
+  }
+
+  uchar computed[ 32 ]; fd_blake3_hash( ctx->lthash.bytes,          FD_LTHASH_LEN_BYTES, computed );
+  uchar expected[ 32 ]; fd_blake3_hash( ctx->manifest_lthash.bytes, FD_LTHASH_LEN_BYTES, expected );
+  FD_BASE58_ENCODE_32_BYTES( computed, computed_enc );
+  FD_BASE58_ENCODE_32_BYTES( expected, expected_enc );
+  if( FD_UNLIKELY( !fd_lthash_eq( &ctx->lthash, &ctx->manifest_lthash ) ) ) {
+    FD_LOG_WARNING(( "%s snapshot manifest accounts lthash %s does not match computed accounts lthash %s",
+                     ctx->full?"full":"incr", expected_enc, computed_enc ));
+    return -1;
+  }
+  FD_LOG_INFO(( "verified %s snapshot accounts lthash %s in %.3f seconds",
+                ctx->full?"full":"incr", computed_enc, (double)(fd_log_wallclock()-start)/1e9 ));
+  return 0;
+}
+
 static void
 handle_control_frag( fd_snapin_tile_t *  ctx,
                      fd_stem_context_t * stem,
@@ -1317,6 +1526,8 @@ handle_control_frag( fd_snapin_tile_t *  ctx,
       fd_ssctrl_init_t const * msg = fd_chunk_to_laddr_const( ctx->in.wksp, chunk );
       ctx->advertised_slot = msg->slot;
       fd_memcpy( ctx->advertised_hash, msg->snapshot_hash, FD_HASH_FOOTPRINT );
+
+      ix_forward( ctx, stem, sig );
       break;
     }
 
@@ -1368,6 +1579,12 @@ handle_control_frag( fd_snapin_tile_t *  ctx,
         break;
       }
 
+      if( FD_UNLIKELY( verify_accounts_lthash( ctx ) ) ) {
+        transition_malformed( ctx, stem );
+        forward_msg = 0;
+        break;
+      }
+
       ctx->recovery.capitalization = ctx->capitalization;
       fd_accdb_snapshot_save_whead( ctx->accdb, &ctx->recovery.accdb_metadata );
       ctx->recovery.feature_snoop = *ctx->feature_snoop;
@@ -1398,6 +1615,12 @@ handle_control_frag( fd_snapin_tile_t *  ctx,
         break;
       }
 
+      if( FD_UNLIKELY( verify_accounts_lthash( ctx ) ) ) {
+        transition_malformed( ctx, stem );
+        forward_msg = 0;
+        break;
+      }
+
       if( !ctx->full ) {
         fd_accdb_snapshot_recover_delta( ctx->accdb, ctx->accdb_incr_fork_id );
         /* ensure that snapin tile sees all delta changes before rooting */
@@ -1441,6 +1664,7 @@ handle_control_frag( fd_snapin_tile_t *  ctx,
     case FD_SNAPSHOT_MSG_CTRL_SHUTDOWN: {
       FD_TEST( ctx->state==FD_SNAPSHOT_STATE_IDLE );
       ctx->state = FD_SNAPSHOT_STATE_SHUTDOWN;
+      ix_forward( ctx, stem, sig );
       break;
     }
 
@@ -1458,9 +1682,157 @@ handle_control_frag( fd_snapin_tile_t *  ctx,
   }
 }
 
+/* handle_report runs on the parser for an inserter forwarding back
+   the held control message. */
+
+static void
+handle_report( fd_snapin_tile_t * ctx,
+               ulong              in_idx,
+               ulong              sig,
+               ulong              chunk,
+               ulong              sz ) {
+  if( FD_UNLIKELY( sig!=ctx->ix_held ) ) {
+    FD_LOG_ERR(( "unexpected %s (%lu) from snapin inserter while holding %s (%lu)",
+                 fd_ssctrl_msg_ctrl_str( sig ), sig, fd_ssctrl_msg_ctrl_str( ctx->ix_held ), ctx->ix_held ));
+  }
+  if( FD_UNLIKELY( chunk<ctx->rp_in[ in_idx ].chunk0 || chunk>ctx->rp_in[ in_idx ].wmark || sz!=sizeof(fd_ssctrl_ix_report_t) ) ) {
+    FD_LOG_ERR(( "invalid report frag bounds (chunk=%lu chunk0=%lu wmark=%lu sz=%lu)", chunk, ctx->rp_in[ in_idx ].chunk0, ctx->rp_in[ in_idx ].wmark, sz ));
+  }
+
+  fd_ssctrl_ix_report_t const * report = fd_chunk_to_laddr_const( ctx->rp_in[ in_idx ].wksp, chunk );
+  if( FD_UNLIKELY( sig==FD_SNAPSHOT_MSG_CTRL_NEXT || sig==FD_SNAPSHOT_MSG_CTRL_DONE ) ) {
+    fd_lthash_add( &ctx->lthash, &report->lthash );
+  }
+
+  /* On FAIL the counts are discarded along with the snapshot */
+  if( FD_LIKELY( sig==FD_SNAPSHOT_MSG_CTRL_FINI ) ) {
+    ctx->metrics.accounts_loaded   += report->accounts_loaded;
+    ctx->metrics.accounts_replaced += report->accounts_replaced;
+    ctx->metrics.accounts_ignored  += report->accounts_ignored;
+    ctx->capitalization     = fd_ulong_sat_sub( ctx->capitalization,     report->ignored_lamports  );
+    ctx->dup_capitalization = fd_ulong_sat_add( ctx->dup_capitalization, report->replaced_lamports );
+  }
+  ctx->ix_acked++;
+}
+
+/* index_accounts runs on an inserter and indexes a batch from the
+   parser.  fd_accdb_snapshot_index_batch takes up to 8 distinct
+   accounts at a time, so a group also ends before a repeated pubkey. */
+
+static void
+index_accounts( fd_snapin_tile_t *           ctx,
+                fd_ssctrl_ix_batch_t const * batch ) {
+  fd_accdb_fork_id_t fork_id = { .val = batch->fork_id };
+
+  uchar const * pubkeys    [ 8 ];
+  ulong         slots      [ 8 ];
+  ulong         lamports   [ 8 ];
+  ulong         data_lens  [ 8 ];
+  int           executables[ 8 ];
+  ulong         file_offs  [ 8 ];
+  ulong         cnt = 0UL;
+  for( ulong i=0UL; i<=batch->cnt; i++ ) {
+    int flush = i==batch->cnt || cnt==8UL;
+    for( ulong j=0UL; !flush && j<cnt; j++ ) flush = !memcmp( pubkeys[ j ], batch->acc[ i ].pubkey, 32UL );
+
+    if( flush && cnt ) {
+      ulong ignored, replaced, loaded, replaced_lamports, ignored_lamports;
+      fd_accdb_snapshot_index_batch( ctx->accdb, fork_id, cnt, pubkeys, slots, lamports, data_lens, executables, file_offs,
+                                     &ignored, &replaced, &loaded, &replaced_lamports, &ignored_lamports );
+      ctx->report.accounts_loaded   += loaded;
+      ctx->report.accounts_replaced += replaced;
+      ctx->report.accounts_ignored  += ignored;
+      ctx->report.replaced_lamports  = fd_ulong_sat_add( ctx->report.replaced_lamports, replaced_lamports );
+      ctx->report.ignored_lamports   = fd_ulong_sat_add( ctx->report.ignored_lamports,  ignored_lamports  );
+      cnt = 0UL;
+    }
+    if( FD_UNLIKELY( i==batch->cnt ) ) break;
+
+    fd_ssctrl_ix_acc_t const * acc = &batch->acc[ i ];
+    pubkeys    [ cnt ] = acc->pubkey;
+    slots      [ cnt ] = acc->slot;
+    lamports   [ cnt ] = acc->lamports;
+    data_lens  [ cnt ] = acc->data_len;
+    executables[ cnt ] = acc->executable;
+    file_offs  [ cnt ] = acc->file_off;
+    cnt++;
+  }
+}
+
+static void
+handle_inserter_frag( fd_snapin_tile_t *  ctx,
+                      fd_stem_context_t * stem,
+                      ulong               sig,
+                      ulong               chunk,
+                      ulong               sz ) {
+  switch( sig ) {
+    case FD_SNAPSHOT_MSG_INDEX: {
+      FD_TEST( ctx->state==FD_SNAPSHOT_STATE_PROCESSING );
+      if( FD_UNLIKELY( chunk<ctx->in.chunk0 || chunk>ctx->in.wmark || sz>ctx->in.mtu || sz<offsetof( fd_ssctrl_ix_batch_t, acc ) ) ) {
+        FD_LOG_ERR(( "invalid index frag bounds (chunk=%lu chunk0=%lu wmark=%lu sz=%lu mtu=%lu)", chunk, ctx->in.chunk0, ctx->in.wmark, sz, ctx->in.mtu ));
+      }
+      fd_ssctrl_ix_batch_t const * batch = fd_chunk_to_laddr_const( ctx->in.wksp, chunk );
+      FD_TEST( sz==offsetof( fd_ssctrl_ix_batch_t, acc )+batch->cnt*sizeof(fd_ssctrl_ix_acc_t) );
+      index_accounts( ctx, batch );
+      break;
+    }
+
+    case FD_SNAPSHOT_MSG_CTRL_INIT_FULL:
+    case FD_SNAPSHOT_MSG_CTRL_INIT_INCR: {
+      FD_TEST( ctx->state==FD_SNAPSHOT_STATE_IDLE );
+      ctx->state = FD_SNAPSHOT_STATE_PROCESSING;
+      memset( &ctx->report, 0, sizeof(ctx->report) );
+      break;
+    }
+
+    case FD_SNAPSHOT_MSG_CTRL_FINI:
+    case FD_SNAPSHOT_MSG_CTRL_FAIL: {
+      /* Everything received before this is indexed, hand the counts
+         over to the parser. */
+      fd_memcpy( fd_chunk_to_laddr( ctx->rp_out.mem, ctx->rp_out.chunk ), &ctx->report, sizeof(fd_ssctrl_ix_report_t) );
+      fd_stem_publish( stem, ctx->rp_out.idx, sig, ctx->rp_out.chunk, sizeof(fd_ssctrl_ix_report_t), 0UL, 0UL, 0UL );
+      ctx->rp_out.chunk = fd_dcache_compact_next( ctx->rp_out.chunk, sizeof(fd_ssctrl_ix_report_t), ctx->rp_out.chunk0, ctx->rp_out.wmark );
+      memset( &ctx->report, 0, sizeof(ctx->report) );
+      ctx->state = FD_SNAPSHOT_STATE_IDLE;
+      break;
+    }
+
+    case FD_SNAPSHOT_MSG_CTRL_NEXT:
+    case FD_SNAPSHOT_MSG_CTRL_DONE: {
+      /* The snapshot is fully written out, hash the live accounts of
+         this shard. */
+      FD_TEST( ctx->state==FD_SNAPSHOT_STATE_IDLE && ctx->verify_lthash );
+      if( FD_UNLIKELY( chunk<ctx->in.chunk0 || chunk>ctx->in.wmark || sz!=offsetof( fd_ssctrl_ix_batch_t, acc ) ) ) {
+        FD_LOG_ERR(( "invalid lthash frag bounds (chunk=%lu chunk0=%lu wmark=%lu sz=%lu)", chunk, ctx->in.chunk0, ctx->in.wmark, sz ));
+      }
+      fd_ssctrl_ix_batch_t const * batch   = fd_chunk_to_laddr_const( ctx->in.wksp, chunk );
+      fd_accdb_fork_id_t           fork_id = { .val = batch->fork_id };
+      fd_ssctrl_ix_report_t *      report  = fd_chunk_to_laddr( ctx->rp_out.mem, ctx->rp_out.chunk );
+      memset( report, 0, sizeof(fd_ssctrl_ix_report_t) );
+      fd_accdb_snapshot_lthash( ctx->accdb, fork_id, ctx->tile_idx-1UL, ctx->ix_cnt, ctx->lthash_buf, &report->lthash );
+      fd_stem_publish( stem, ctx->rp_out.idx, sig, ctx->rp_out.chunk, sizeof(fd_ssctrl_ix_report_t), 0UL, 0UL, 0UL );
+      ctx->rp_out.chunk = fd_dcache_compact_next( ctx->rp_out.chunk, sizeof(fd_ssctrl_ix_report_t), ctx->rp_out.chunk0, ctx->rp_out.wmark );
+      break;
+    }
+
+    case FD_SNAPSHOT_MSG_CTRL_SHUTDOWN: {
+      FD_TEST( ctx->state==FD_SNAPSHOT_STATE_IDLE );
+      ctx->state = FD_SNAPSHOT_STATE_SHUTDOWN;
+      break;
+    }
+
+    default: {
+      FD_LOG_ERR(( "unexpected frag %s (%lu) in snapin inserter state %s (%lu)",
+                   fd_ssctrl_msg_ctrl_str( sig ), sig,
+                   fd_ssctrl_state_str( (ulong)ctx->state ), (ulong)ctx->state ));
+      break;
+    }
+  }
+}
+
 static inline int
 returnable_frag( fd_snapin_tile_t *  ctx,
-                 ulong               in_idx FD_PARAM_UNUSED,
+                 ulong               in_idx,
                  ulong               seq    FD_PARAM_UNUSED,
                  ulong               sig,
                  ulong               chunk,
@@ -1471,9 +1843,37 @@ returnable_frag( fd_snapin_tile_t *  ctx,
                  fd_stem_context_t * stem ) {
   FD_TEST( ctx->state!=FD_SNAPSHOT_STATE_SHUTDOWN );
 
+  if( FD_UNLIKELY( ctx->tile_idx ) ) {
+    handle_inserter_frag( ctx, stem, sig, chunk, sz );
+    return 0;
+  }
+  if( FD_UNLIKELY( in_idx ) ) {
+    handle_report( ctx, in_idx, sig, chunk, sz );
+    return 0;
+  }
+
   if( FD_UNLIKELY( sig==FD_SNAPSHOT_MSG_DATA ) ) return handle_data_frag( ctx, chunk, sz, stem );
-  else                                           handle_control_frag( ctx, stem, sig, chunk, sz );
 
+  /* Hold FINI and FAIL until the inserters have indexed everything
+     before it, and NEXT and DONE until they have hashed their shards.
+     A FINI that does not follow the end of the stream is malformed and
+     fails without waiting, as does anything in the ERROR state other
+     than FAIL. */
+  int hash = ctx->verify_lthash && ( sig==FD_SNAPSHOT_MSG_CTRL_NEXT || sig==FD_SNAPSHOT_MSG_CTRL_DONE );
+  if( FD_UNLIKELY( ctx->ix_cnt &&
+                   ( ( ( sig==FD_SNAPSHOT_MSG_CTRL_FINI || hash ) && ctx->state==FD_SNAPSHOT_STATE_FINISHING ) ||
+                     sig==FD_SNAPSHOT_MSG_CTRL_FAIL ) ) ) {
+    if( FD_LIKELY( !ctx->ix_held ) ) {
+      ix_forward( ctx, stem, sig );
+      ctx->ix_held  = sig;
+      ctx->ix_acked = 0UL;
+      fd_lthash_zero( &ctx->lthash );
+    }
+    if( FD_LIKELY( ctx->ix_acked<ctx->ix_cnt ) ) return 1;
+    ctx->ix_held = 0UL;
+  }
+
+  handle_control_frag( ctx, stem, sig, chunk, sz );
   return 0;
 }
 
@@ -1515,8 +1915,9 @@ privileged_init( fd_topo_t const *      topo,
 static inline fd_snapin_out_link_t
 out1( fd_topo_t const *      topo,
       fd_topo_tile_t const * tile,
-      char const *           name ) {
-  ulong idx = fd_topo_find_tile_out_link( topo, tile, name, 0UL );
+      char const *           name,
+      ulong                  kind_id ) {
+  ulong idx = fd_topo_find_tile_out_link( topo, tile, name, kind_id );
 
   if( FD_UNLIKELY( idx==ULONG_MAX ) ) return (fd_snapin_out_link_t){ .idx = ULONG_MAX, .mem = NULL, .chunk0 = 0, .wmark = 0, .chunk = 0, .mtu = 0 };
 
@@ -1536,6 +1937,44 @@ unprivileged_init( fd_topo_t const *      topo,
 
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   fd_snapin_tile_t * ctx  = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_snapin_tile_t),     sizeof(fd_snapin_tile_t)                                    );
+
+  ulong tile_cnt = fd_topo_tile_name_cnt( topo, NAME );
+  if( FD_UNLIKELY( tile_cnt>FD_SNAPIN_TILE_MAX ) ) FD_LOG_ERR(( "too many `" NAME "` tiles %lu, max %lu", tile_cnt, FD_SNAPIN_TILE_MAX ));
+  ctx->tile_idx = tile->kind_id;
+  ctx->ix_cnt   = tile_cnt-1UL;
+
+  ctx->verify_lthash = tile->snapin.verify_lthash;
+  ctx->lthash_buf    = NULL;
+  if( ctx->verify_lthash ) ctx->lthash_buf = FD_SCRATCH_ALLOC_APPEND( l, 64UL, FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ );
+  fd_lthash_zero( &ctx->lthash );
+
+  void * _accdb_shmem = fd_topo_obj_laddr( topo, tile->snapin.accdb_obj_id );
+  fd_accdb_shmem_t * accdb_shmem = fd_accdb_shmem_join( _accdb_shmem );
+  FD_TEST( accdb_shmem );
+
+  if( FD_UNLIKELY( tile->kind_id ) ) {
+    void * _accdb = FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_align(), fd_accdb_footprint( tile->snapin.max_live_slots ) );
+    ctx->accdb = fd_accdb_join( fd_accdb_new( _accdb, accdb_shmem, FD_ACCDB_FD_RW, 0UL, NULL ) );
+    FD_TEST( ctx->accdb );
+
+    /* Inserter k consumes snapin_ix k-1 and reports on snapin_rp k-1 */
+    if( FD_UNLIKELY( tile->in_cnt!=1UL ) ) FD_LOG_ERR(( "tile `" NAME "` inserter has %lu ins, expected 1", tile->in_cnt ));
+    fd_topo_link_t const * in_link = &topo->links[ tile->in_link_id[ 0UL ] ];
+    FD_TEST( 0==strcmp( in_link->name, "snapin_ix" ) );
+    ctx->in.wksp   = topo->workspaces[ topo->objs[ in_link->dcache_obj_id ].wksp_id ].wksp;
+    ctx->in.chunk0 = fd_dcache_compact_chunk0( ctx->in.wksp, in_link->dcache );
+    ctx->in.wmark  = fd_dcache_compact_wmark( ctx->in.wksp, in_link->dcache, in_link->mtu );
+    ctx->in.mtu    = in_link->mtu;
+
+    ctx->rp_out = out1( topo, tile, "snapin_rp", tile->kind_id-1UL );
+    if( FD_UNLIKELY( ctx->rp_out.idx==ULONG_MAX ) ) FD_LOG_ERR(( "tile `" NAME "` inserter missing required out link `snapin_rp`" ));
+
+    ctx->state = FD_SNAPSHOT_STATE_IDLE;
+    memset( &ctx->report,  0, sizeof(ctx->report)  );
+    memset( &ctx->metrics, 0, sizeof(ctx->metrics) );
+    return;
+  }
+
   void * _txncache        = FD_SCRATCH_ALLOC_APPEND( l, fd_txncache_align(),           fd_txncache_footprint( tile->snapin.max_live_slots )        );
   void * _accdb           = FD_SCRATCH_ALLOC_APPEND( l, fd_accdb_align(),              fd_accdb_footprint( tile->snapin.max_live_slots )           );
   void * _manifest_parser = FD_SCRATCH_ALLOC_APPEND( l, fd_ssmanifest_parser_align(),  fd_ssmanifest_parser_footprint()                            );
@@ -1546,9 +1985,6 @@ unprivileged_init( fd_topo_t const *      topo,
   ctx->full = 1;
   ctx->state = FD_SNAPSHOT_STATE_IDLE;
 
-  void * _accdb_shmem = fd_topo_obj_laddr( topo, tile->snapin.accdb_obj_id );
-  fd_accdb_shmem_t * accdb_shmem = fd_accdb_shmem_join( _accdb_shmem );
-  FD_TEST( accdb_shmem );
   ctx->accdb = fd_accdb_join( fd_accdb_new( _accdb, accdb_shmem, FD_ACCDB_FD_RW, 0UL, NULL ) );
   FD_TEST( ctx->accdb );
 
@@ -1577,12 +2013,11 @@ unprivileged_init( fd_topo_t const *      topo,
 
   fd_memset( &ctx->metrics, 0, sizeof(ctx->metrics) );
 
-  if( FD_UNLIKELY( tile->kind_id ) ) FD_LOG_ERR(( "There can only be one `" NAME "` tile" ));
-  if( FD_UNLIKELY( tile->in_cnt!=1UL ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu ins, expected 1", tile->in_cnt ));
+  if( FD_UNLIKELY( tile->in_cnt!=1UL+ctx->ix_cnt ) ) FD_LOG_ERR(( "tile `" NAME "` has %lu ins, expected %lu", tile->in_cnt, 1UL+ctx->ix_cnt ));
 
-  ctx->ct_out =       out1( topo, tile, "snapin_ct" );
-  ctx->manifest_out = out1( topo, tile, "snapin_manif" );
-  ctx->gui_out      = out1( topo, tile, "snapin_gui"   );
+  ctx->ct_out =       out1( topo, tile, "snapin_ct",    0UL );
+  ctx->manifest_out = out1( topo, tile, "snapin_manif", 0UL );
+  ctx->gui_out      = out1( topo, tile, "snapin_gui",   0UL );
 
   if( FD_UNLIKELY( ctx->ct_out.idx==ULONG_MAX ) ) FD_LOG_ERR(( "tile `" NAME "` missing required out link `snapin_ct`" ));
   if( FD_UNLIKELY( ctx->manifest_out.idx==ULONG_MAX ) ) FD_LOG_ERR(( "tile `" NAME "` missing required out link `snapin_manif`" ));
@@ -1600,6 +2035,20 @@ unprivileged_init( fd_topo_t const *      topo,
   ctx->in.mtu    = in_link->mtu;
   ctx->in.pos    = 0UL;
 
+  for( ulong i=0UL; i<ctx->ix_cnt; i++ ) {
+    ctx->ix_out[ i ] = out1( topo, tile, "snapin_ix", i );
+    if( FD_UNLIKELY( ctx->ix_out[ i ].idx==ULONG_MAX ) ) FD_LOG_ERR(( "tile `" NAME "` missing required out link `snapin_ix` %lu", i ));
+    ix_batch( ctx, i )->cnt = 0UL;
+
+    fd_topo_link_t const * rp_link = &topo->links[ tile->in_link_id[ 1UL+i ] ];
+    FD_TEST( 0==strcmp( rp_link->name, "snapin_rp" ) );
+    ctx->rp_in[ 1UL+i ].wksp   = topo->workspaces[ topo->objs[ rp_link->dcache_obj_id ].wksp_id ].wksp;
+    ctx->rp_in[ 1UL+i ].chunk0 = fd_dcache_compact_chunk0( ctx->rp_in[ 1UL+i ].wksp, rp_link->dcache );
+    ctx->rp_in[ 1UL+i ].wmark  = fd_dcache_compact_wmark( ctx->rp_in[ 1UL+i ].wksp, rp_link->dcache, rp_link->mtu );
+  }
+  ctx->ix_held  = 0UL;
+  ctx->ix_acked = 0UL;
+
   ctx->gui_config_acct_sz  = 0UL;
   ctx->gui_config_acct_off = 0UL;
 
@@ -1621,14 +2070,16 @@ unprivileged_init( fd_topo_t const *      topo,
   ctx->boot_timestamp = fd_log_wallclock();
 }
 
-/* There are 3 output links that affect the calculation of STEM_BURST:
+/* There are 4 output links that affect the calculation of STEM_BURST:
     1. snapin_ct
     2. snapin_manif - worst case: 1 message
     3. snapin_gui   - worst case: 1 message (config program account)
-   The STEM_BURST is the max value across these 3 links (not the sum).
-   Note that snapin_txn is excluded from this calculation, since it is
-   an unreliable link, working as a dcache place holder. */
-#define STEM_BURST 1UL
+    4. snapin_ix    - worst case: 2 messages (pending batch and FINI)
+   The STEM_BURST is the max value across these 4 links (not the sum).
+   Inserters publish 1 message on snapin_rp at a time.  Note that
+   snapin_txn is excluded from this calculation, since it is an
+   unreliable link, working as a dcache place holder. */
+#define STEM_BURST 2UL
 
 #define STEM_LAZY  (128L*3000L)
 
@@ -121,7 +121,7 @@ test_batch_stake_delegation( void ) {
     },
   };
 
-  FD_TEST( !process_account_batch( &ctx, &result ) );
+  FD_TEST( !process_account_batch( &ctx, NULL, &result ) );
   assert_stake_delegation( stake_delegations, &stake_account, &vote_account );
 
   free( banks_mem );
@@ -149,7 +149,7 @@ test_streaming_stake_delegation( void ) {
       .executable = 0,
     },
   };
-  FD_TEST( !process_account_header( &ctx, &header ) );
+  FD_TEST( !process_account_header( &ctx, NULL, &header ) );
 
   ulong split = sizeof(fd_stake_state_t)/2UL;
   fd_ssparse_advance_result_t data = {
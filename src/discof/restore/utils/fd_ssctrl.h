@@ -3,6 +3,7 @@
 
 #include "../../../util/net/fd_net_headers.h"
 #include "../../../flamenco/runtime/fd_runtime_const.h"
+#include "../../../ballet/lthash/fd_lthash.h"
 
 /* The snapshot tiles have a somewhat involved state machine, which is
    controlled by snapct.  Imagine first the following sequence:
@@ -118,6 +119,12 @@
 /* snapld -> snapct (via snapld_dc) */
 #define FD_SNAPSHOT_MSG_LOAD_COMPLETE         (10UL) /* snapld finished reading/downloading all data */
 
+/* snapdc helper -> snapdc (via snapdc_dc) */
+#define FD_SNAPSHOT_MSG_FRAME_END             (11UL) /* All decompressed data of the helper's current frame has been sent */
+
+/* snapin -> snapin inserter (via snapin_ix) and back (via snapin_rp) */
+#define FD_SNAPSHOT_MSG_INDEX                 (12UL) /* Fragment is a fd_ssctrl_ix_batch_t of accounts to index */
+
 /* Sent by snapct to tell snapld whether to load a local file or
    download from a particular external peer. */
 typedef struct fd_ssctrl_init {
@@ -142,6 +149,48 @@ typedef struct fd_ssctrl_meta {
   char  resolved_name[ PATH_MAX ];
 } fd_ssctrl_meta_t;
 
+/* When snapin runs with inserter tiles, the snapin parser reserves
+   the disk space of every account in stream order and hands each
+   account to the inserter owning its accdb shard, which indexes it.
+   An fd_ssctrl_ix_batch_t carries up to FD_SSCTRL_IX_ACC_MAX accounts
+   of one shard, in stream order. */
+
+#define FD_SSCTRL_IX_ACC_MAX (128UL)
+
+typedef struct fd_ssctrl_ix_acc {
+  uchar pubkey[ FD_PUBKEY_FOOTPRINT ];
+  ulong slot;
+  ulong lamports;
+  ulong data_len;
+  ulong file_off;   /* from fd_accdb_snapshot_reserve */
+  int   executable;
+} fd_ssctrl_ix_acc_t;
+
+typedef struct fd_ssctrl_ix_batch {
+  ushort             fork_id; /* accdb fork the accounts are written to */
+  ulong              cnt;
+  fd_ssctrl_ix_acc_t acc[ FD_SSCTRL_IX_ACC_MAX ];
+} fd_ssctrl_ix_batch_t;
+
+/* Sent by an inserter to the snapin parser when it forwards a FINI or
+   FAIL message, with sig set to that message.  Counts cover every
+   batch indexed since the last INIT.
+
+   When accounts LtHash verification is enabled, the parser also
+   forwards NEXT and DONE, carrying an empty fd_ssctrl_ix_batch_t that
+   names the fork to hash.  The inserter then reports the LtHash of the
+   live accounts of its shard in lthash (see fd_accdb_snapshot_lthash),
+   and the counts are zero. */
+
+typedef struct fd_ssctrl_ix_report {
+  ulong             accounts_loaded;
+  ulong             accounts_replaced;
+  ulong             accounts_ignored;
+  ulong             replaced_lamports;
+  ulong             ignored_lamports;
+  fd_lthash_value_t lthash;
+} fd_ssctrl_ix_report_t;
+
 struct fd_snapshot_account_hdr {
   uchar   pubkey[ FD_PUBKEY_FOOTPRINT ];
   uchar   owner[ FD_PUBKEY_FOOTPRINT ];
@@ -193,6 +242,8 @@ fd_ssctrl_msg_ctrl_str( ulong sig ) {
     case FD_SNAPSHOT_MSG_CTRL_ERROR:            return "error";
     case FD_SNAPSHOT_MSG_CTRL_FINI:             return "fini";
     case FD_SNAPSHOT_MSG_LOAD_COMPLETE:         return "load_complete";
+    case FD_SNAPSHOT_MSG_FRAME_END:             return "frame_end";
+    case FD_SNAPSHOT_MSG_INDEX:                 return "index";
     default:                                    return "unknown";
   }
 }
@@ -0,0 +1,123 @@
+#include "fd_sszstd.h"
+
+/* See RFC 8878 for the frame format. */
+
+#define FD_SSZSTD_MAGIC           (0xFD2FB528U)
+#define FD_SSZSTD_MAGIC_SKIPPABLE (0x184D2A50U) /* Low 4 bits are user defined */
+#define FD_SSZSTD_BLOCK_SZ_MAX    (1UL<<17)
+
+void
+fd_sszstd_scan_init( fd_sszstd_scan_t * scan ) {
+  scan->state    = FD_SSZSTD_SCAN_MAGIC;
+  scan->after    = FD_SSZSTD_SCAN_MAGIC;
+  scan->checksum = 0;
+  scan->buf_sz   = 0UL;
+  scan->skip     = 0UL;
+}
+
+/* read_field appends bytes from data[*off,sz) to scan->buf until it
+   holds need bytes.  Returns 1 if the field is complete, in which case
+   buf_sz is reset for the next field. */
+
+static inline int
+read_field( fd_sszstd_scan_t * scan,
+            uchar const *      data,
+            ulong              sz,
+            ulong *            off,
+            ulong              need ) {
+  ulong n = fd_ulong_min( need-scan->buf_sz, sz-*off );
+  fd_memcpy( scan->buf+scan->buf_sz, data+*off, n );
+  scan->buf_sz += n;
+  *off         += n;
+  if( FD_UNLIKELY( scan->buf_sz<need ) ) return 0;
+  scan->buf_sz = 0UL;
+  return 1;
+}
+
+static inline void
+skip_then( fd_sszstd_scan_t * scan,
+           ulong              skip,
+           int                after ) {
+  scan->state = FD_SSZSTD_SCAN_SKIP;
+  scan->skip  = skip;
+  scan->after = after;
+}
+
+ulong
+fd_sszstd_scan( fd_sszstd_scan_t * scan,
+                uchar const *      data,
+                ulong              sz,
+                int *              frame_end ) {
+  *frame_end = 0;
+
+  ulong off = 0UL;
+  for(;;) {
+    if( scan->state==FD_SSZSTD_SCAN_SKIP ) {
+      ulong n = fd_ulong_min( scan->skip, sz-off );
+      off        += n;
+      scan->skip -= n;
+      if( FD_LIKELY( scan->skip ) ) break;
+      if( scan->after==FD_SSZSTD_SCAN_END ) {
+        scan->state = FD_SSZSTD_SCAN_MAGIC;
+        *frame_end  = 1;
+        break;
+      }
+      scan->state = scan->after;
+      continue;
+    }
+
+    if( FD_UNLIKELY( off>=sz ) ) break;
+
+    switch( scan->state ) {
+      case FD_SSZSTD_SCAN_MAGIC: {
+        if( FD_UNLIKELY( !read_field( scan, data, sz, &off, 4UL ) ) ) break;
+        uint magic = FD_LOAD( uint, scan->buf );
+        if( FD_LIKELY( magic==FD_SSZSTD_MAGIC ) )                                  scan->state = FD_SSZSTD_SCAN_FHD;
+        else if( FD_LIKELY( (magic&0xFFFFFFF0U)==FD_SSZSTD_MAGIC_SKIPPABLE ) )     scan->state = FD_SSZSTD_SCAN_SKIP_SZ;
+        else                                                                        return ULONG_MAX;
+        break;
+      }
+
+      case FD_SSZSTD_SCAN_FHD: {
+        /* The frame header descriptor determines the size of the rest
+           of the frame header, which we skip. */
+        static uchar const dict_id_sz[ 4 ] = { 0, 1, 2, 4 };
+        uint fhd = data[ off++ ];
+        if( FD_UNLIKELY( fhd&0x08U ) ) return ULONG_MAX; /* Reserved bit */
+        uint fcs_flag    = fhd>>6;
+        uint single_seg  = (fhd>>5)&1U;
+        scan->checksum   = (int)((fhd>>2)&1U);
+        ulong fcs_sz     = fcs_flag ? (1UL<<fcs_flag) : (ulong)single_seg;
+        ulong hdr_rem    = (ulong)!single_seg + dict_id_sz[ fhd&3U ] + fcs_sz;
+        skip_then( scan, hdr_rem, FD_SSZSTD_SCAN_BLOCK_HDR );
+        break;
+      }
+
+      case FD_SSZSTD_SCAN_SKIP_SZ: {
+        if( FD_UNLIKELY( !read_field( scan, data, sz, &off, 4UL ) ) ) break;
+        skip_then( scan, (ulong)FD_LOAD( uint, scan->buf ), FD_SSZSTD_SCAN_END );
+        break;
+      }
+
+      case FD_SSZSTD_SCAN_BLOCK_HDR: {
+        if( FD_UNLIKELY( !read_field( scan, data, sz, &off, 3UL ) ) ) break;
+        uint  hdr        = (uint)scan->buf[ 0 ] | ((uint)scan->buf[ 1 ]<<8) | ((uint)scan->buf[ 2 ]<<16);
+        int   last_block = (int)(hdr&1U);
+        uint  type       = (hdr>>1)&3U;
+        ulong block_sz   = (ulong)(hdr>>3);
+        if( FD_UNLIKELY( type==3U || block_sz>FD_SSZSTD_BLOCK_SZ_MAX ) ) return ULONG_MAX;
+
+        /* RLE blocks store one byte regardless of the block size.  The
+           checksum, if any, directly follows the last block. */
+        ulong skip = fd_ulong_if( type==1U, 1UL, block_sz );
+        if( last_block ) skip_then( scan, skip+fd_ulong_if( scan->checksum, 4UL, 0UL ), FD_SSZSTD_SCAN_END );
+        else             skip_then( scan, skip,                                          FD_SSZSTD_SCAN_BLOCK_HDR );
+        break;
+      }
+
+      default: return ULONG_MAX;
+    }
+  }
+
+  return off;
+}
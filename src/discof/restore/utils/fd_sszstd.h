@@ -0,0 +1,67 @@
+#ifndef HEADER_fd_src_discof_restore_utils_fd_sszstd_h
+#define HEADER_fd_src_discof_restore_utils_fd_sszstd_h
+
+/* fd_sszstd_scan finds Zstandard frame boundaries in a compressed
+   byte stream without decompressing it.  It walks frame headers and
+   block headers only, skipping over block contents, so it touches a
+   few bytes per 128 KiB block.  It understands regular and skippable
+   frames, and is fed the stream incrementally in arbitrarily sized
+   pieces.
+
+   This lets several snapdc tiles split a multi-frame snapshot stream
+   between themselves, each decompressing its own frames and skipping
+   the others.  The scanner only checks that the framing is well
+   formed, it does not validate block contents. */
+
+#include "../../../util/bits/fd_bits.h"
+
+#define FD_SSZSTD_SCAN_MAGIC     (0)  /* Reading the magic number of a frame */
+#define FD_SSZSTD_SCAN_FHD       (1)  /* Reading the frame header descriptor */
+#define FD_SSZSTD_SCAN_SKIP_SZ   (2)  /* Reading the size of a skippable frame */
+#define FD_SSZSTD_SCAN_BLOCK_HDR (3)  /* Reading a block header */
+#define FD_SSZSTD_SCAN_SKIP      (4)  /* Skipping header fields, block contents, a checksum, or skippable frame data */
+#define FD_SSZSTD_SCAN_END       (5)  /* Only used as a skip continuation, the frame ends after the skip */
+
+struct fd_sszstd_scan {
+  int   state;
+  int   after;       /* State to enter once skip reaches zero */
+  int   checksum;    /* 1 if the frame ends with a 4 byte checksum */
+  uchar buf[ 4 ];    /* Partially read header field */
+  ulong buf_sz;      /* Bytes in buf */
+  ulong skip;        /* Bytes left to skip in FD_SSZSTD_SCAN_SKIP */
+};
+
+typedef struct fd_sszstd_scan fd_sszstd_scan_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_sszstd_scan_init resets scan to expect the start of a frame. */
+
+void
+fd_sszstd_scan_init( fd_sszstd_scan_t * scan );
+
+/* fd_sszstd_scan_idle returns 1 if scan is between frames, and 0 if
+   it is in the middle of one. */
+
+static inline int
+fd_sszstd_scan_idle( fd_sszstd_scan_t const * scan ) {
+  return scan->state==FD_SSZSTD_SCAN_MAGIC && !scan->buf_sz;
+}
+
+/* fd_sszstd_scan consumes up to sz bytes of compressed stream at data,
+   stopping early at the end of the current frame.  Returns the number
+   of bytes consumed and sets *frame_end to 1 if the frame ended at
+   that point (the scanner is then ready for the next frame), and to 0
+   otherwise.  Returns ULONG_MAX if the stream is not a valid sequence
+   of Zstandard frames, in which case scan must be re-initialized
+   before use. */
+
+ulong
+fd_sszstd_scan( fd_sszstd_scan_t * scan,
+                uchar const *      data,
+                ulong              sz,
+                int *              frame_end );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_discof_restore_utils_fd_sszstd_h */
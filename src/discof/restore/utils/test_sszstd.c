@@ -0,0 +1,196 @@
+#include "fd_sszstd.h"
+
+#include "../../../util/fd_util.h"
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include <zstd.h>
+
+#define FRAME_MAX   (16UL)
+#define STREAM_MAX  (8UL<<20)
+#define CONTENT_MAX (1UL<<20)
+
+static uchar stream [ STREAM_MAX  ];
+static uchar content[ CONTENT_MAX ];
+static uchar out    [ CONTENT_MAX ];
+
+/* make_stream fills stream with a mix of frame kinds: compressible
+   data (compressed blocks), random data (raw blocks), zeros (RLE
+   blocks), frames with and without checksums and content sizes,
+   skippable frames, and an empty frame.  Records the end offset of
+   each frame in frame_end. */
+
+static ulong
+make_stream( fd_rng_t * rng,
+             ulong *    frame_end,
+             ulong *    frame_cnt ) {
+  ZSTD_CCtx * cctx = ZSTD_createCCtx();
+  FD_TEST( cctx );
+
+  ulong off = 0UL;
+  ulong cnt = 0UL;
+  for( ulong i=0UL; i<FRAME_MAX; i++ ) {
+    ulong kind = i%5UL;
+    ulong sz   = fd_ulong_if( i==FRAME_MAX-1UL, 0UL, 1UL+fd_rng_ulong_roll( rng, CONTENT_MAX ) );
+
+    if( kind==4UL ) {
+      ulong res = ZSTD_writeSkippableFrame( stream+off, STREAM_MAX-off, content, fd_ulong_min( sz, 1000UL ), (uint)(i&15UL) );
+      FD_TEST( !ZSTD_isError( res ) );
+      off += res;
+      frame_end[ cnt++ ] = off;
+      continue;
+    }
+
+    for( ulong j=0UL; j<sz; j++ ) {
+      switch( kind ) {
+        case 0UL: content[ j ] = (uchar)(j/97UL);        break;
+        case 1UL: content[ j ] = fd_rng_uchar( rng );   break;
+        case 2UL: content[ j ] = 0;                     break;
+        default:  content[ j ] = (uchar)(fd_rng_uchar( rng )&3U); break;
+      }
+    }
+
+    FD_TEST( !ZSTD_isError( ZSTD_CCtx_reset( cctx, ZSTD_reset_session_and_parameters ) ) );
+    FD_TEST( !ZSTD_isError( ZSTD_CCtx_setParameter( cctx, ZSTD_c_checksumFlag,    (int)(i&1UL) ) ) );
+    FD_TEST( !ZSTD_isError( ZSTD_CCtx_setParameter( cctx, ZSTD_c_contentSizeFlag, (int)((i>>1)&1UL) ) ) );
+
+    /* Streaming compression with an unknown size produces a frame
+       without the single segment flag. */
+    if( i&4UL ) {
+      ulong res = ZSTD_compress2( cctx, stream+off, STREAM_MAX-off, content, sz );
+      FD_TEST( !ZSTD_isError( res ) );
+      off += res;
+    } else {
+      ZSTD_inBuffer  in = { .src = content,    .size = sz,             .pos = 0UL };
+      ZSTD_outBuffer o  = { .dst = stream+off, .size = STREAM_MAX-off, .pos = 0UL };
+      ulong rem;
+      do {
+        rem = ZSTD_compressStream2( cctx, &o, &in, ZSTD_e_end );
+        FD_TEST( !ZSTD_isError( rem ) );
+      } while( rem );
+      off += o.pos;
+    }
+    frame_end[ cnt++ ] = off;
+  }
+
+  ZSTD_freeCCtx( cctx );
+  *frame_cnt = cnt;
+  return off;
+}
+
+/* test_scan feeds the stream to the scanner in random pieces and
+   checks it reports exactly the frame boundaries. */
+
+static void
+test_scan( fd_rng_t *    rng,
+           ulong         stream_sz,
+           ulong const * frame_end,
+           ulong         frame_cnt,
+           ulong         piece_max ) {
+  fd_sszstd_scan_t scan[1];
+  fd_sszstd_scan_init( scan );
+  FD_TEST( fd_sszstd_scan_idle( scan ) );
+
+  ulong off   = 0UL;
+  ulong frame = 0UL;
+  while( off<stream_sz ) {
+    ulong piece = fd_ulong_min( 1UL+fd_rng_ulong_roll( rng, piece_max ), stream_sz-off );
+    ulong pos   = 0UL;
+    while( pos<piece ) {
+      int end;
+      ulong consumed = fd_sszstd_scan( scan, stream+off+pos, piece-pos, &end );
+      FD_TEST( consumed!=ULONG_MAX );
+      pos += consumed;
+      if( end ) {
+        FD_TEST( frame<frame_cnt );
+        FD_TEST( off+pos==frame_end[ frame ] );
+        FD_TEST( fd_sszstd_scan_idle( scan ) );
+        frame++;
+      } else {
+        FD_TEST( pos==piece );
+      }
+    }
+    off += piece;
+  }
+  FD_TEST( frame==frame_cnt );
+  FD_TEST( fd_sszstd_scan_idle( scan ) );
+}
+
+/* test_dstream_stops checks that streaming decompression never reads
+   past the end of a frame, which snapdc relies on to hand off at frame
+   boundaries. */
+
+static void
+test_dstream_stops( ulong         stream_sz,
+                    ulong const * frame_end,
+                    ulong         frame_cnt ) {
+  ZSTD_DCtx * dctx = ZSTD_createDCtx();
+  FD_TEST( dctx );
+
+  ulong off   = 0UL;
+  ulong frame = 0UL;
+  while( off<stream_sz ) {
+    ulong in_consumed = 0UL, out_produced = 0UL;
+    ulong res = ZSTD_decompressStream_simpleArgs( dctx, out, sizeof(out), &out_produced, stream+off, stream_sz-off, &in_consumed );
+    FD_TEST( !ZSTD_isError( res ) );
+    off += in_consumed;
+    if( !res ) {
+      FD_TEST( off==frame_end[ frame ] );
+      frame++;
+    }
+  }
+  FD_TEST( frame==frame_cnt );
+  ZSTD_freeDCtx( dctx );
+}
+
+static void
+test_malformed( void ) {
+  fd_sszstd_scan_t scan[1];
+  int end;
+
+  uchar bad_magic[ 8 ] = { 0x28, 0xB5, 0x2F, 0xFE, 0, 0, 0, 0 };
+  fd_sszstd_scan_init( scan );
+  FD_TEST( fd_sszstd_scan( scan, bad_magic, sizeof(bad_magic), &end )==ULONG_MAX );
+
+  uchar reserved[ 5 ] = { 0x28, 0xB5, 0x2F, 0xFD, 0x08 };
+  fd_sszstd_scan_init( scan );
+  FD_TEST( fd_sszstd_scan( scan, reserved, sizeof(reserved), &end )==ULONG_MAX );
+
+  /* Single segment, 1 byte content size, then a reserved block type. */
+  uchar block_type[ 9 ] = { 0x28, 0xB5, 0x2F, 0xFD, 0x20, 0x10, 0x07, 0x00, 0x00 };
+  fd_sszstd_scan_init( scan );
+  FD_TEST( fd_sszstd_scan( scan, block_type, sizeof(block_type), &end )==ULONG_MAX );
+
+  /* A truncated frame is consumed but never ends. */
+  uchar truncated[ 7 ] = { 0x28, 0xB5, 0x2F, 0xFD, 0x20, 0x10, 0x01 };
+  fd_sszstd_scan_init( scan );
+  FD_TEST( fd_sszstd_scan( scan, truncated, sizeof(truncated), &end )==sizeof(truncated) );
+  FD_TEST( !end );
+  FD_TEST( !fd_sszstd_scan_idle( scan ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+  ulong frame_end[ FRAME_MAX ];
+  ulong frame_cnt;
+  ulong stream_sz = make_stream( rng, frame_end, &frame_cnt );
+  FD_LOG_NOTICE(( "stream of %lu frames, %lu bytes", frame_cnt, stream_sz ));
+
+  test_scan( rng, stream_sz, frame_end, frame_cnt, 1UL        );
+  test_scan( rng, stream_sz, frame_end, frame_cnt, 7UL        );
+  test_scan( rng, stream_sz, frame_end, frame_cnt, 65408UL    );
+  test_scan( rng, stream_sz, frame_end, frame_cnt, STREAM_MAX );
+  test_dstream_stops( stream_sz, frame_end, frame_cnt );
+  test_malformed();
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
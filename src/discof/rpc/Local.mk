@@ -1,5 +1,12 @@
-$(call add-objs,fd_rpc_tile,fd_discof)
+$(call add-objs,fd_rpc_tile fd_rpc_index fd_rpc_txnstatus fd_rpc_blocks,fd_discof)
 ifdef FD_HAS_HOSTED
+$(call make-unit-test,test_rpc_index,test_rpc_index,fd_discof fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_rpc_index)
+$(call make-unit-test,test_rpc_txnstatus,test_rpc_txnstatus,fd_discof fd_ballet fd_util)
+$(call run-unit-test,test_rpc_txnstatus)
+$(call make-unit-test,test_rpc_blocks,test_rpc_blocks,fd_discof fd_ballet fd_util)
+$(call run-unit-test,test_rpc_blocks)
+$(call make-unit-test,bench_rpc_txnstatus,bench_rpc_txnstatus,fd_discof fd_ballet fd_util)
 $(call make-unit-test,test_rpc_tile,test_rpc_tile,fd_discof fd_disco fd_flamenco fd_waltz fd_tango fd_ballet fd_util)
 $(call make-fuzz-test,fuzz_rpc,fuzz_rpc,fd_discof fd_disco fd_tango fd_flamenco fd_waltz fd_ballet fd_util)
 $(call make-fuzz-test,fuzz_rpc_tarball,fuzz_rpc_tarball,fd_discof fd_disco fd_tango fd_flamenco fd_waltz fd_ballet fd_util)
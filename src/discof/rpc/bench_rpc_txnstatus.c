@@ -0,0 +1,157 @@
+#define _GNU_SOURCE
+#include "fd_rpc_txnstatus.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+/* bench_rpc_txnstatus: fill a transaction status store with
+   vote-sized transactions over a linear chain of rooted slots, then
+   measure what a single RPC tile can look up: signature queries (half
+   of them misses), signature queries followed by reading the
+   transaction back from the ring file (getTransaction), and walks of
+   the newest postings of an address (getSignaturesForAddress).  The
+   ring file is freshly written, so reads are usually served from the
+   page cache. */
+
+#define KEY_CNT   (4UL)
+#define ADDR_POOL (4096UL)
+
+static ulong
+make_txn( uchar      payload[ FD_TXN_MTU ],
+          fd_txn_t * txn,
+          ulong      seed,
+          ulong      i ) {
+  ulong off = 0UL;
+  payload[ off++ ] = 1;
+  for( ulong j=0UL; j<8UL; j++ ) { FD_STORE( ulong, payload+off, fd_ulong_hash( seed ^ i ^ (j<<56) ) ); off += 8UL; }
+  payload[ off++ ] = 1;
+  payload[ off++ ] = 0;
+  payload[ off++ ] = 1;
+  payload[ off++ ] = (uchar)KEY_CNT;
+  for( ulong k=0UL; k<KEY_CNT; k++ ) {
+    /* Fee payer is unique, the other keys are drawn from a small pool */
+    ulong a = k ? fd_ulong_hash( seed ^ (i<<8) ^ k )%ADDR_POOL : i;
+    memset( payload+off, 0, 32UL );
+    FD_STORE( ulong, payload+off,     a );
+    FD_STORE( ulong, payload+off+8UL, k ? 0UL : 1UL );
+    off += 32UL;
+  }
+  memset( payload+off, 0x77, 32UL ); off += 32UL;
+  payload[ off++ ] = 1;
+  payload[ off++ ] = (uchar)(KEY_CNT-1UL);
+  payload[ off++ ] = 0;
+  payload[ off++ ] = 120;
+  memset( payload+off, 0x42, 120UL ); off += 120UL;
+  FD_TEST( fd_txn_parse( payload, off, txn, NULL ) );
+  return off;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong        txn_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-max",      NULL, 1UL<<20   );
+  ulong        txn_per_slot = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-per-slot", NULL, 4096UL    );
+  ulong        query_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--queries",      NULL, 4000000UL );
+  ulong        seed         = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",         NULL, 42UL      );
+  char const * path         = fd_env_strip_cmdline_cstr ( &argc, &argv, "--path",         NULL, "/tmp/bench_rpc_txnstatus.bin" );
+
+  FD_TEST( txn_max && txn_per_slot );
+  ulong slot_max = 64UL + txn_max/16UL;
+  FD_LOG_NOTICE(( "rpc txnstatus bench (txn-max=%lu txn-per-slot=%lu queries=%lu seed=%lu path=%s)", txn_max, txn_per_slot, query_cnt, seed, path ));
+
+  ulong footprint = fd_rpc_txnstatus_footprint( txn_max, slot_max );
+  FD_TEST( footprint );
+  void * mem = aligned_alloc( fd_rpc_txnstatus_align(), footprint );
+  FD_TEST( mem );
+  fd_rpc_txnstatus_t * store = fd_rpc_txnstatus_join( fd_rpc_txnstatus_new( mem, txn_max, slot_max, path, seed ) );
+  FD_TEST( store );
+  FD_LOG_NOTICE(( "footprint %.1f MiB", (double)footprint/(double)(1UL<<20) ));
+
+  uchar payload[ FD_TXN_MTU ];
+  uchar txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+  fd_txn_t * txn = (fd_txn_t *)txn_mem;
+  fd_rpc_txnstatus_err_t err = { 0 };
+
+  /* Insert twice the capacity so that the store runs in steady state,
+     evicting as it goes */
+
+  ulong insert_cnt = 2UL*txn_max;
+  long  insert_ns  = 0L;
+  for( ulong i=0UL; i<insert_cnt; i++ ) {
+    ulong slot = 1UL+i/txn_per_slot;
+    ulong sz   = make_txn( payload, txn, seed, i );
+    long  t0   = fd_log_wallclock();
+    FD_TEST( fd_rpc_txnstatus_insert( store, slot, i%txn_per_slot, &err, payload, sz, txn ) );
+    if( FD_UNLIKELY( i%txn_per_slot==txn_per_slot-1UL ) ) {
+      fd_rpc_txnstatus_slot_completed( store, slot, slot-1UL );
+      fd_rpc_txnstatus_root( store, slot );
+    }
+    insert_ns += fd_log_wallclock()-t0;
+  }
+  ulong live_cnt   = fd_rpc_txnstatus_txn_cnt( store );
+  ulong first_live = insert_cnt-live_cnt;
+  FD_LOG_NOTICE(( "stored %lu, evicted %lu", live_cnt, fd_rpc_txnstatus_evict_cnt( store ) ));
+
+  /* Signature queries, odd ones miss */
+
+  ulong hit_cnt = 0UL;
+  long  t0      = fd_log_wallclock();
+  for( ulong q=0UL; q<query_cnt; q++ ) {
+    ulong i = first_live + fd_ulong_hash( q^seed )%live_cnt;
+    uchar sig[ 64 ];
+    for( ulong j=0UL; j<8UL; j++ ) FD_STORE( ulong, sig+8UL*j, fd_ulong_hash( seed ^ i ^ (j<<56) ^ ((q&1UL)<<62) ) );
+    hit_cnt += (ulong)( fd_rpc_txnstatus_sig_query( store, sig )!=FD_RPC_TXNSTATUS_IDX_NULL );
+  }
+  long sig_ns = fd_log_wallclock()-t0;
+  FD_TEST( hit_cnt==query_cnt-query_cnt/2UL );
+
+  /* getTransaction: query and read back */
+
+  ulong read_cnt = query_cnt/8UL;
+  t0 = fd_log_wallclock();
+  for( ulong q=0UL; q<read_cnt; q++ ) {
+    ulong i = first_live + fd_ulong_hash( q^~seed )%live_cnt;
+    uchar sig[ 64 ];
+    for( ulong j=0UL; j<8UL; j++ ) FD_STORE( ulong, sig+8UL*j, fd_ulong_hash( seed ^ i ^ (j<<56) ) );
+    ulong k = fd_rpc_txnstatus_sig_query( store, sig );
+    FD_TEST( k!=FD_RPC_TXNSTATUS_IDX_NULL );
+    FD_TEST( fd_rpc_txnstatus_read( store, k, payload ) );
+  }
+  long read_ns = fd_log_wallclock()-t0;
+
+  /* getSignaturesForAddress: the newest 1000 postings of an address */
+
+  ulong addr_cnt  = query_cnt/64UL;
+  ulong post_cnt  = 0UL;
+  t0 = fd_log_wallclock();
+  for( ulong q=0UL; q<addr_cnt; q++ ) {
+    uchar addr[ 32 ] = { 0 };
+    FD_STORE( ulong, addr, fd_ulong_hash( q^seed )%ADDR_POOL );
+    ulong n = 0UL;
+    for( ulong p=fd_rpc_txnstatus_addr_query( store, addr ); p!=FD_RPC_TXNSTATUS_IDX_NULL && n<1000UL; p=fd_rpc_txnstatus_addr_next( store, p ) ) {
+      ulong k = fd_rpc_txnstatus_post_txn( store, p );
+      n += (ulong)( fd_rpc_txnstatus_conf( store, k, ULONG_MAX, ULONG_MAX )==FD_RPC_TXNSTATUS_CONF_FINALIZED );
+    }
+    post_cnt += n;
+  }
+  long addr_ns = fd_log_wallclock()-t0;
+
+  double insert_s = (double)insert_ns*1e-9;
+  double sig_s    = (double)sig_ns   *1e-9;
+  double read_s   = (double)read_ns  *1e-9;
+  double addr_s   = (double)addr_ns  *1e-9;
+  FD_LOG_NOTICE(( "insert:    %lu in %.3f s, %.2f M/s/core, %.1f ns each", insert_cnt, insert_s, (double)insert_cnt/insert_s*1e-6, insert_s*1e9/(double)insert_cnt ));
+  FD_LOG_NOTICE(( "sig query: %lu in %.3f s, %.2f M/s/core, %.1f ns each", query_cnt,  sig_s,    (double)query_cnt /sig_s   *1e-6, sig_s   *1e9/(double)query_cnt  ));
+  FD_LOG_NOTICE(( "sig read:  %lu in %.3f s, %.2f M/s/core, %.1f ns each", read_cnt,   read_s,   (double)read_cnt  /read_s  *1e-6, read_s  *1e9/(double)read_cnt   ));
+  FD_LOG_NOTICE(( "addr walk: %lu in %.3f s, %.2f K/s/core, %.1f postings each", addr_cnt, addr_s, (double)addr_cnt/addr_s*1e-3, (double)post_cnt/(double)addr_cnt ));
+
+  close( fd_rpc_txnstatus_fd( store ) );
+  unlink( path );
+  free( mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,612 @@
+#define _GNU_SOURCE
+#include "fd_rpc_blocks.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* A record in the ring file is a header followed by the transactions
+   of the block, each prefixed by its size.  The header repeats the
+   slot and transaction count so that a read can check the record is
+   the one the in-memory header expects. */
+
+struct fd_rpc_blocks_rec_hdr {
+  ulong slot;
+  uint  txn_cnt;
+  uint  sz;      /* Record size, excluding alignment padding */
+};
+
+typedef struct fd_rpc_blocks_rec_hdr fd_rpc_blocks_rec_hdr_t;
+
+#define FD_RPC_BLOCKS_TXN_REC_MAX (sizeof(ushort)+FD_TXN_MTU)
+
+/* Transactions are staged in a write buffer and read back through a
+   read buffer, so that a block takes a few large I/Os rather than one
+   per transaction.  Both must hold at least one transaction. */
+
+#define FD_RPC_BLOCKS_WBUF_SZ (1UL<<20)
+#define FD_RPC_BLOCKS_RBUF_SZ (256UL<<10)
+
+struct fd_rpc_blocks_pending {
+  ulong          slot;
+  uint           map_next; /* Also used by the pool */
+  fd_rpc_block_t block;
+};
+
+typedef struct fd_rpc_blocks_pending fd_rpc_blocks_pending_t;
+
+struct fd_rpc_blocks_cache {
+  ulong slot;     /* ULONG_MAX if unused */
+  ulong variant;
+  ulong sz;
+  ulong stamp;    /* Last use */
+};
+
+typedef struct fd_rpc_blocks_cache fd_rpc_blocks_cache_t;
+
+#define POOL_NAME  pending_pool
+#define POOL_T     fd_rpc_blocks_pending_t
+#define POOL_NEXT  map_next
+#define POOL_IDX_T uint
+#include "../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME               pending_map
+#define MAP_ELE_T              fd_rpc_blocks_pending_t
+#define MAP_KEY_T              ulong
+#define MAP_KEY                slot
+#define MAP_IDX_T              uint
+#define MAP_NEXT               map_next
+#define MAP_KEY_HASH(key,seed) fd_ulong_hash( (*(key)) ^ (seed) )
+#include "../../util/tmpl/fd_map_chain.c"
+
+#define FD_RPC_BLOCKS_MAGIC (0xf17eda2cb10c5a00UL) /* firedancer rpc blocks version 0 */
+
+struct __attribute__((aligned(128UL))) fd_rpc_blocks_private {
+  ulong magic;
+  ulong block_max;
+  ulong pending_max;
+  ulong data_max;
+  ulong cache_ele_sz;
+  int   fd;
+
+  /* Archived blocks and ring file bytes are two FIFOs consumed in the
+     same order.  Positions are sequence numbers that are never
+     wrapped. */
+  ulong block_head;
+  ulong block_tail;
+  ulong data_head;
+  ulong missing_cnt;
+
+  /* Block being appended */
+  fd_rpc_block_t append;
+  ulong          append_txn_max;
+  ulong          append_off;  /* Record offset past the last transaction */
+  int            append_err;
+  ulong          wbuf_off;    /* Record offset of the start of wbuf */
+  ulong          wbuf_sz;
+
+  /* Block being read back */
+  ulong iter_rec_off;         /* Wrapped ring file offset of the record */
+  ulong iter_rec_sz;
+  ulong iter_rem;             /* Transactions left */
+  ulong iter_off;             /* Record offset of the next transaction */
+  ulong rbuf_off;             /* Record offset of the start of rbuf */
+  ulong rbuf_sz;
+
+  ulong cache_clock;
+  ulong cache_hit;
+  ulong cache_miss;
+
+  fd_rpc_block_t *          block;
+  fd_rpc_blocks_pending_t * pending_pool;
+  pending_map_t *           pending_map;
+  fd_rpc_block_t *          rooted;
+  uint *                    prune;
+  fd_rpc_blocks_cache_t     cache[ FD_RPC_BLOCKS_CACHE_CNT ];
+  uchar *                   cache_data;
+
+  uchar wbuf[ FD_RPC_BLOCKS_WBUF_SZ ] __attribute__((aligned(64UL)));
+  uchar rbuf[ FD_RPC_BLOCKS_RBUF_SZ ] __attribute__((aligned(64UL)));
+};
+
+static inline ulong
+fd_rpc_blocks_data_max( ulong block_max ) {
+  return block_max*FD_RPC_BLOCKS_DATA_PER_BLOCK;
+}
+
+static inline ulong
+fd_rpc_blocks_cache_ele_sz( ulong cache_sz ) {
+  return fd_ulong_align_dn( cache_sz/FD_RPC_BLOCKS_CACHE_CNT, 64UL );
+}
+
+FD_FN_CONST ulong
+fd_rpc_blocks_align( void ) {
+  return alignof(fd_rpc_blocks_t);
+}
+
+FD_FN_CONST ulong
+fd_rpc_blocks_footprint( ulong block_max,
+                         ulong pending_max,
+                         ulong cache_sz ) {
+  if( FD_UNLIKELY( !block_max || !pending_max ) ) return 0UL;
+  if( FD_UNLIKELY( block_max>=(1UL<<32) || pending_max>=UINT_MAX ) ) return 0UL;
+
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_blocks_t), sizeof(fd_rpc_blocks_t)                                         );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_block_t),  block_max*sizeof(fd_rpc_block_t)                                );
+  l = FD_LAYOUT_APPEND( l, pending_pool_align(),     pending_pool_footprint( pending_max )                           );
+  l = FD_LAYOUT_APPEND( l, pending_map_align(),      pending_map_footprint( pending_map_chain_cnt_est( pending_max ) ) );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_block_t),  pending_max*sizeof(fd_rpc_block_t)                              );
+  l = FD_LAYOUT_APPEND( l, alignof(uint),            pending_max*sizeof(uint)                                        );
+  l = FD_LAYOUT_APPEND( l, 64UL,                     FD_RPC_BLOCKS_CACHE_CNT*fd_rpc_blocks_cache_ele_sz( cache_sz )  );
+  return FD_LAYOUT_FINI( l, fd_rpc_blocks_align() );
+}
+
+void *
+fd_rpc_blocks_new( void *       shmem,
+                   ulong        block_max,
+                   ulong        pending_max,
+                   ulong        cache_sz,
+                   char const * file_path,
+                   ulong        seed ) {
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_rpc_blocks_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_blocks_footprint( block_max, pending_max, cache_sz ) ) ) {
+    FD_LOG_WARNING(( "invalid block_max %lu or pending_max %lu", block_max, pending_max ));
+    return NULL;
+  }
+
+  ulong data_max     = fd_rpc_blocks_data_max( block_max );
+  ulong cache_ele_sz = fd_rpc_blocks_cache_ele_sz( cache_sz );
+
+  FD_SCRATCH_ALLOC_INIT( l, shmem );
+  fd_rpc_blocks_t * blocks = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_blocks_t), sizeof(fd_rpc_blocks_t)                                           );
+  void * _block            = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_block_t),  block_max*sizeof(fd_rpc_block_t)                                  );
+  void * _pending_pool     = FD_SCRATCH_ALLOC_APPEND( l, pending_pool_align(),     pending_pool_footprint( pending_max )                             );
+  void * _pending_map      = FD_SCRATCH_ALLOC_APPEND( l, pending_map_align(),      pending_map_footprint( pending_map_chain_cnt_est( pending_max ) ) );
+  void * _rooted           = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_block_t),  pending_max*sizeof(fd_rpc_block_t)                                );
+  void * _prune            = FD_SCRATCH_ALLOC_APPEND( l, alignof(uint),            pending_max*sizeof(uint)                                          );
+  void * _cache_data       = FD_SCRATCH_ALLOC_APPEND( l, 64UL,                     FD_RPC_BLOCKS_CACHE_CNT*cache_ele_sz                              );
+
+  int fd = open( file_path, O_RDWR|O_CREAT|O_TRUNC|O_CLOEXEC, (mode_t)0600 );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "open(%s) failed (%i-%s)", file_path, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( ftruncate( fd, (off_t)data_max ) ) ) {
+    FD_LOG_WARNING(( "ftruncate(%s,%lu) failed (%i-%s)", file_path, data_max, errno, fd_io_strerror( errno ) ));
+    close( fd );
+    return NULL;
+  }
+
+  blocks->block_max    = block_max;
+  blocks->pending_max  = pending_max;
+  blocks->data_max     = data_max;
+  blocks->cache_ele_sz = cache_ele_sz;
+  blocks->fd           = fd;
+  blocks->block_head   = 0UL;
+  blocks->block_tail   = 0UL;
+  blocks->data_head    = 0UL;
+  blocks->missing_cnt  = 0UL;
+  blocks->append_err   = 1;
+  blocks->iter_rem     = 0UL;
+  blocks->cache_clock  = 0UL;
+  blocks->cache_hit    = 0UL;
+  blocks->cache_miss   = 0UL;
+  blocks->block        = (fd_rpc_block_t *)_block;
+  blocks->pending_pool = pending_pool_join( pending_pool_new( _pending_pool, pending_max ) );
+  blocks->pending_map  = pending_map_join( pending_map_new( _pending_map, pending_map_chain_cnt_est( pending_max ), seed ) );
+  blocks->rooted       = (fd_rpc_block_t *)_rooted;
+  blocks->prune        = (uint *)_prune;
+  blocks->cache_data   = (uchar *)_cache_data;
+  for( ulong i=0UL; i<FD_RPC_BLOCKS_CACHE_CNT; i++ ) blocks->cache[ i ].slot = ULONG_MAX;
+  FD_TEST( blocks->pending_pool && blocks->pending_map );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( blocks->magic ) = FD_RPC_BLOCKS_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return blocks;
+}
+
+fd_rpc_blocks_t *
+fd_rpc_blocks_join( void * shblocks ) {
+  if( FD_UNLIKELY( !shblocks ) ) {
+    FD_LOG_WARNING(( "NULL shblocks" ));
+    return NULL;
+  }
+
+  fd_rpc_blocks_t * blocks = (fd_rpc_blocks_t *)shblocks;
+  if( FD_UNLIKELY( blocks->magic!=FD_RPC_BLOCKS_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return blocks;
+}
+
+int
+fd_rpc_blocks_fd( fd_rpc_blocks_t const * blocks ) {
+  return blocks->fd;
+}
+
+static int
+fd_rpc_blocks_pwrite( int          fd,
+                      void const * buf,
+                      ulong        sz,
+                      ulong        off ) {
+  while( sz ) {
+    long res = pwrite( fd, buf, sz, (off_t)off );
+    if( FD_UNLIKELY( res<0L ) ) return errno;
+    buf  = (uchar const *)buf + res;
+    sz  -= (ulong)res;
+    off += (ulong)res;
+  }
+  return 0;
+}
+
+static int
+fd_rpc_blocks_pread( int    fd,
+                     void * buf,
+                     ulong  sz,
+                     ulong  off ) {
+  while( sz ) {
+    long res = pread( fd, buf, sz, (off_t)off );
+    if( FD_UNLIKELY( res<=0L ) ) return res ? errno : EIO;
+    buf  = (uchar *)buf + res;
+    sz  -= (ulong)res;
+    off += (ulong)res;
+  }
+  return 0;
+}
+
+int
+fd_rpc_blocks_slot_completed( fd_rpc_blocks_t *      blocks,
+                              fd_rpc_block_t const * block ) {
+  /* A slot replayed again overwrites its header */
+  fd_rpc_blocks_pending_t * e = pending_map_ele_query( blocks->pending_map, &block->slot, NULL, blocks->pending_pool );
+  if( FD_UNLIKELY( !e ) ) {
+    if( FD_UNLIKELY( !pending_pool_free( blocks->pending_pool ) ) ) return 0;
+    e = pending_pool_ele_acquire( blocks->pending_pool );
+    e->slot = block->slot;
+    pending_map_ele_insert( blocks->pending_map, e, blocks->pending_pool );
+  }
+  e->block = *block;
+  return 1;
+}
+
+ulong
+fd_rpc_blocks_root( fd_rpc_blocks_t *        blocks,
+                    ulong                    root_slot,
+                    fd_rpc_block_t const ** out ) {
+  /* The new root and its pending ancestors, which stop at the previous
+     root since everything up to it was pruned */
+  ulong cnt  = 0UL;
+  ulong slot = root_slot;
+  while( cnt<blocks->pending_max ) {
+    fd_rpc_blocks_pending_t const * e = pending_map_ele_query_const( blocks->pending_map, &slot, NULL, blocks->pending_pool );
+    if( FD_UNLIKELY( !e ) ) break;
+    blocks->rooted[ cnt++ ] = e->block;
+    slot = e->block.parent_slot;
+  }
+
+  for( ulong i=0UL; i<cnt/2UL; i++ ) fd_swap( blocks->rooted[ i ], blocks->rooted[ cnt-1UL-i ] );
+
+  fd_rpc_block_t const * last = blocks->block_head>blocks->block_tail ? &blocks->block[ (blocks->block_head-1UL) % blocks->block_max ] : NULL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_rpc_block_t * b      = &blocks->rooted[ i ];
+    fd_rpc_block_t * parent = i ? &blocks->rooted[ i-1UL ] : NULL;
+    if(      FD_LIKELY( parent && parent->slot==b->parent_slot ) ) memcpy( b->prev_blockhash, parent->blockhash, 32UL );
+    else if( FD_LIKELY( last   && last->slot  ==b->parent_slot ) ) memcpy( b->prev_blockhash, last->blockhash,   32UL );
+    else                                                           memset( b->prev_blockhash, 0,                 32UL );
+  }
+
+  /* Everything up to the root is either rooted now or abandoned */
+  ulong prune_cnt = 0UL;
+  for( pending_map_iter_t iter = pending_map_iter_init( blocks->pending_map, blocks->pending_pool );
+       !pending_map_iter_done( iter, blocks->pending_map, blocks->pending_pool );
+       iter = pending_map_iter_next( iter, blocks->pending_map, blocks->pending_pool ) ) {
+    ulong idx = pending_map_iter_idx( iter, blocks->pending_map, blocks->pending_pool );
+    if( blocks->pending_pool[ idx ].slot<=root_slot ) blocks->prune[ prune_cnt++ ] = (uint)idx;
+  }
+  for( ulong i=0UL; i<prune_cnt; i++ ) {
+    fd_rpc_blocks_pending_t * e = &blocks->pending_pool[ blocks->prune[ i ] ];
+    pending_map_idx_remove( blocks->pending_map, &e->slot, ULONG_MAX, blocks->pending_pool );
+    pending_pool_ele_release( blocks->pending_pool, e );
+  }
+
+  *out = blocks->rooted;
+  return cnt;
+}
+
+/* fd_rpc_blocks_evict removes the oldest archived block. */
+
+static inline void
+fd_rpc_blocks_evict( fd_rpc_blocks_t * blocks ) {
+  blocks->block_tail++;
+}
+
+static void
+fd_rpc_blocks_push( fd_rpc_blocks_t *      blocks,
+                    fd_rpc_block_t const * block ) {
+  if( FD_UNLIKELY( blocks->block_head-blocks->block_tail>=blocks->block_max ) ) fd_rpc_blocks_evict( blocks );
+  blocks->block[ blocks->block_head % blocks->block_max ] = *block;
+  blocks->block_head++;
+}
+
+void
+fd_rpc_blocks_append_missing( fd_rpc_blocks_t *      blocks,
+                              fd_rpc_block_t const * block ) {
+  fd_rpc_block_t b = *block;
+  b.rec_off = blocks->data_head;
+  b.rec_sz  = 0U;
+  b.txn_cnt = UINT_MAX;
+  fd_rpc_blocks_push( blocks, &b );
+  blocks->missing_cnt++;
+}
+
+int
+fd_rpc_blocks_append_begin( fd_rpc_blocks_t *      blocks,
+                            fd_rpc_block_t const * block,
+                            ulong                  txn_cnt ) {
+  /* Space for the largest possible record is reserved up front, which
+     may evict a few more old blocks than strictly needed */
+  ulong rec_max = fd_ulong_align_up( sizeof(fd_rpc_blocks_rec_hdr_t)+txn_cnt*FD_RPC_BLOCKS_TXN_REC_MAX, 8UL );
+  if( FD_UNLIKELY( txn_cnt>FD_RPC_BLOCKS_TXN_MAX || rec_max>blocks->data_max ) ) return 0;
+
+  ulong rec_off = blocks->data_head;
+  if( FD_UNLIKELY( (rec_off % blocks->data_max)+rec_max>blocks->data_max ) ) rec_off += blocks->data_max - rec_off % blocks->data_max;
+
+  while( blocks->block_head>blocks->block_tail ) {
+    fd_rpc_block_t const * oldest = &blocks->block[ blocks->block_tail % blocks->block_max ];
+    int block_full = blocks->block_head-blocks->block_tail>=blocks->block_max;
+    int data_full  = rec_off+rec_max-oldest->rec_off>blocks->data_max;
+    if( FD_LIKELY( !block_full && !data_full ) ) break;
+    fd_rpc_blocks_evict( blocks );
+  }
+
+  blocks->append         = *block;
+  blocks->append.rec_off = rec_off;
+  blocks->append.txn_cnt = 0U;
+  blocks->append_txn_max = txn_cnt;
+  blocks->append_off     = sizeof(fd_rpc_blocks_rec_hdr_t);
+  blocks->append_err     = 0;
+  blocks->wbuf_off       = blocks->append_off;
+  blocks->wbuf_sz        = 0UL;
+  return 1;
+}
+
+static void
+fd_rpc_blocks_flush( fd_rpc_blocks_t * blocks ) {
+  if( FD_LIKELY( !blocks->append_err && blocks->wbuf_sz ) ) {
+    ulong off = (blocks->append.rec_off % blocks->data_max) + blocks->wbuf_off;
+    blocks->append_err = !!fd_rpc_blocks_pwrite( blocks->fd, blocks->wbuf, blocks->wbuf_sz, off );
+  }
+  blocks->wbuf_off += blocks->wbuf_sz;
+  blocks->wbuf_sz   = 0UL;
+}
+
+void
+fd_rpc_blocks_append_txn( fd_rpc_blocks_t * blocks,
+                          uchar const *     payload,
+                          ulong             payload_sz ) {
+  if( FD_UNLIKELY( blocks->append_err ) ) return;
+  if( FD_UNLIKELY( payload_sz>FD_TXN_MTU || blocks->append.txn_cnt>=blocks->append_txn_max ) ) {
+    blocks->append_err = 1;
+    return;
+  }
+
+  ulong sz = sizeof(ushort)+payload_sz;
+  if( FD_UNLIKELY( blocks->wbuf_sz+sz>FD_RPC_BLOCKS_WBUF_SZ ) ) fd_rpc_blocks_flush( blocks );
+  FD_STORE( ushort, blocks->wbuf+blocks->wbuf_sz, (ushort)payload_sz );
+  fd_memcpy( blocks->wbuf+blocks->wbuf_sz+sizeof(ushort), payload, payload_sz );
+  blocks->wbuf_sz    += sz;
+  blocks->append_off += sz;
+  blocks->append.txn_cnt++;
+}
+
+int
+fd_rpc_blocks_append_end( fd_rpc_blocks_t * blocks ) {
+  fd_rpc_blocks_flush( blocks );
+
+  fd_rpc_block_t * b = &blocks->append;
+  fd_rpc_blocks_rec_hdr_t hdr = { .slot = b->slot, .txn_cnt = b->txn_cnt, .sz = (uint)blocks->append_off };
+  if( FD_LIKELY( !blocks->append_err && b->txn_cnt==blocks->append_txn_max ) ) {
+    blocks->append_err = !!fd_rpc_blocks_pwrite( blocks->fd, &hdr, sizeof(hdr), b->rec_off % blocks->data_max );
+  } else {
+    blocks->append_err = 1;
+  }
+
+  int ok = !blocks->append_err;
+  blocks->append_err = 1;
+  if( FD_UNLIKELY( !ok ) ) {
+    fd_rpc_blocks_append_missing( blocks, b );
+    return 0;
+  }
+
+  b->rec_sz = (uint)fd_ulong_align_up( blocks->append_off, 8UL );
+  blocks->data_head = b->rec_off+b->rec_sz;
+  fd_rpc_blocks_push( blocks, b );
+  return 1;
+}
+
+/* fd_rpc_blocks_seq returns the sequence number of archived block
+   idx. */
+
+static inline ulong
+fd_rpc_blocks_seq( fd_rpc_blocks_t const * blocks,
+                   ulong                   idx ) {
+  ulong tail_idx = blocks->block_tail % blocks->block_max;
+  return blocks->block_tail + ( idx>=tail_idx ? idx-tail_idx : idx+blocks->block_max-tail_idx );
+}
+
+ulong
+fd_rpc_blocks_lower_bound( fd_rpc_blocks_t const * blocks,
+                           ulong                   slot ) {
+  ulong lo = blocks->block_tail;
+  ulong hi = blocks->block_head;
+  while( lo<hi ) {
+    ulong mid = lo+(hi-lo)/2UL;
+    if( blocks->block[ mid % blocks->block_max ].slot<slot ) lo = mid+1UL;
+    else                                                     hi = mid;
+  }
+  return lo<blocks->block_head ? lo % blocks->block_max : FD_RPC_BLOCKS_IDX_NULL;
+}
+
+ulong
+fd_rpc_blocks_query( fd_rpc_blocks_t const * blocks,
+                     ulong                   slot ) {
+  ulong idx = fd_rpc_blocks_lower_bound( blocks, slot );
+  if( FD_UNLIKELY( idx==FD_RPC_BLOCKS_IDX_NULL || blocks->block[ idx ].slot!=slot ) ) return FD_RPC_BLOCKS_IDX_NULL;
+  return idx;
+}
+
+ulong
+fd_rpc_blocks_next( fd_rpc_blocks_t const * blocks,
+                    ulong                   idx ) {
+  ulong seq = fd_rpc_blocks_seq( blocks, idx )+1UL;
+  return seq<blocks->block_head ? seq % blocks->block_max : FD_RPC_BLOCKS_IDX_NULL;
+}
+
+fd_rpc_block_t const *
+fd_rpc_blocks_block( fd_rpc_blocks_t const * blocks,
+                     ulong                   idx ) {
+  return &blocks->block[ idx ];
+}
+
+ulong
+fd_rpc_blocks_first( fd_rpc_blocks_t const * blocks ) {
+  if( FD_UNLIKELY( blocks->block_head==blocks->block_tail ) ) return ULONG_MAX;
+  return blocks->block[ blocks->block_tail % blocks->block_max ].slot;
+}
+
+ulong
+fd_rpc_blocks_last( fd_rpc_blocks_t const * blocks ) {
+  if( FD_UNLIKELY( blocks->block_head==blocks->block_tail ) ) return ULONG_MAX;
+  return blocks->block[ (blocks->block_head-1UL) % blocks->block_max ].slot;
+}
+
+int
+fd_rpc_blocks_iter_init( fd_rpc_blocks_t * blocks,
+                         ulong             idx ) {
+  fd_rpc_block_t const * b = &blocks->block[ idx ];
+  blocks->iter_rem = 0UL;
+  if( FD_UNLIKELY( b->txn_cnt==UINT_MAX ) ) return 0;
+
+  fd_rpc_blocks_rec_hdr_t hdr;
+  ulong rec_off = b->rec_off % blocks->data_max;
+  if( FD_UNLIKELY( fd_rpc_blocks_pread( blocks->fd, &hdr, sizeof(hdr), rec_off ) ) ) return 0;
+  if( FD_UNLIKELY( hdr.slot!=b->slot || hdr.txn_cnt!=b->txn_cnt || hdr.sz>b->rec_sz ) ) return 0;
+
+  blocks->iter_rec_off = rec_off;
+  blocks->iter_rec_sz  = hdr.sz;
+  blocks->iter_rem     = hdr.txn_cnt;
+  blocks->iter_off     = sizeof(hdr);
+  blocks->rbuf_off     = sizeof(hdr);
+  blocks->rbuf_sz      = 0UL;
+  return 1;
+}
+
+/* fd_rpc_blocks_iter_fill makes sure the sz record bytes at the
+   iteration offset are in the read buffer.  Returns 0 on error. */
+
+static int
+fd_rpc_blocks_iter_fill( fd_rpc_blocks_t * blocks,
+                         ulong             sz ) {
+  if( FD_LIKELY( blocks->iter_off+sz<=blocks->rbuf_off+blocks->rbuf_sz ) ) return 1;
+  if( FD_UNLIKELY( blocks->iter_off+sz>blocks->iter_rec_sz ) ) return 0;
+  blocks->rbuf_off = blocks->iter_off;
+  blocks->rbuf_sz  = fd_ulong_min( FD_RPC_BLOCKS_RBUF_SZ, blocks->iter_rec_sz-blocks->iter_off );
+  if( FD_UNLIKELY( fd_rpc_blocks_pread( blocks->fd, blocks->rbuf, blocks->rbuf_sz, blocks->iter_rec_off+blocks->rbuf_off ) ) ) {
+    blocks->rbuf_sz = 0UL;
+    return 0;
+  }
+  return 1;
+}
+
+uchar const *
+fd_rpc_blocks_iter_next( fd_rpc_blocks_t * blocks,
+                         ulong *           payload_sz ) {
+  if( FD_UNLIKELY( !blocks->iter_rem ) ) return NULL;
+  if( FD_UNLIKELY( !fd_rpc_blocks_iter_fill( blocks, sizeof(ushort) ) ) ) goto fail;
+  ulong sz = FD_LOAD( ushort, blocks->rbuf+blocks->iter_off-blocks->rbuf_off );
+  if( FD_UNLIKELY( sz>FD_TXN_MTU || !fd_rpc_blocks_iter_fill( blocks, sizeof(ushort)+sz ) ) ) goto fail;
+
+  uchar const * payload = blocks->rbuf+blocks->iter_off-blocks->rbuf_off+sizeof(ushort);
+  blocks->iter_off += sizeof(ushort)+sz;
+  blocks->iter_rem--;
+  *payload_sz = sz;
+  return payload;
+
+fail:
+  blocks->iter_rem = 0UL;
+  return NULL;
+}
+
+uchar const *
+fd_rpc_blocks_cache_query( fd_rpc_blocks_t * blocks,
+                           ulong             slot,
+                           ulong             variant,
+                           ulong *           sz ) {
+  for( ulong i=0UL; i<FD_RPC_BLOCKS_CACHE_CNT; i++ ) {
+    fd_rpc_blocks_cache_t * c = &blocks->cache[ i ];
+    if( FD_LIKELY( c->slot!=slot || c->variant!=variant ) ) continue;
+    c->stamp = ++blocks->cache_clock;
+    blocks->cache_hit++;
+    *sz = c->sz;
+    return blocks->cache_data + i*blocks->cache_ele_sz;
+  }
+  blocks->cache_miss++;
+  return NULL;
+}
+
+void
+fd_rpc_blocks_cache_insert( fd_rpc_blocks_t * blocks,
+                            ulong             slot,
+                            ulong             variant,
+                            uchar const *     data,
+                            ulong             sz ) {
+  if( FD_UNLIKELY( sz>blocks->cache_ele_sz ) ) return;
+
+  ulong lru = 0UL;
+  for( ulong i=0UL; i<FD_RPC_BLOCKS_CACHE_CNT; i++ ) {
+    fd_rpc_blocks_cache_t const * c = &blocks->cache[ i ];
+    if( FD_UNLIKELY( c->slot==ULONG_MAX ) ) { lru = i; break; }
+    if( c->stamp<blocks->cache[ lru ].stamp ) lru = i;
+  }
+
+  fd_rpc_blocks_cache_t * c = &blocks->cache[ lru ];
+  c->slot    = slot;
+  c->variant = variant;
+  c->sz      = sz;
+  c->stamp   = ++blocks->cache_clock;
+  fd_memcpy( blocks->cache_data + lru*blocks->cache_ele_sz, data, sz );
+}
+
+ulong
+fd_rpc_blocks_block_cnt( fd_rpc_blocks_t const * blocks ) {
+  return blocks->block_head-blocks->block_tail;
+}
+
+ulong
+fd_rpc_blocks_missing_cnt( fd_rpc_blocks_t const * blocks ) {
+  return blocks->missing_cnt;
+}
+
+ulong
+fd_rpc_blocks_cache_hit( fd_rpc_blocks_t const * blocks ) {
+  return blocks->cache_hit;
+}
+
+ulong
+fd_rpc_blocks_cache_miss( fd_rpc_blocks_t const * blocks ) {
+  return blocks->cache_miss;
+}
@@ -0,0 +1,235 @@
+#ifndef HEADER_fd_src_discof_rpc_fd_rpc_blocks_h
+#define HEADER_fd_src_discof_rpc_fd_rpc_blocks_h
+
+/* fd_rpc_blocks is the RPC tile's archive of recent rooted blocks, to
+   serve getBlock, getBlocks, getBlocksWithLimit and getBlockTime
+   without a ledger.
+
+   Blocks are recorded in two steps.  When a slot completes replay, its
+   header (parent, height, time and blockhash) is kept in a table of
+   pending slots.  When the root advances, the newly rooted slots are
+   taken off that table in slot order, and each is appended to the
+   archive with the raw transactions of the block, in block order.
+
+   The archive is a FIFO of block headers in memory, ordered by slot,
+   and a file-backed byte ring holding one record per block with its
+   transactions.  Running out of either evicts the oldest block.  A
+   block whose transactions are not all known (e.g. some were evicted
+   from the transaction status store before it was rooted) is archived
+   without them, so that it is still listed by getBlocks.
+
+   Popular recent blocks are typically requested by many clients at
+   once, and encoding a block is far more expensive than copying it.
+   The archive thus also has a small LRU cache of encoded getBlock
+   results, keyed by slot and by a caller defined variant (encoding,
+   transaction details, ...).  Blocks never change once archived, so
+   cache entries never need to be invalidated; a caller must check a
+   block is still archived before looking it up in the cache.
+
+   Nothing is recovered across restarts: the ring file is truncated on
+   startup.  The archive is private to a single tile and not thread
+   safe. */
+
+#include "../../util/fd_util_base.h"
+#include "../../ballet/txn/fd_txn.h"
+
+#define FD_RPC_BLOCKS_IDX_NULL (ULONG_MAX)
+
+/* FD_RPC_BLOCKS_DATA_PER_BLOCK is the number of ring file bytes
+   budgeted per archived block.  Mainnet blocks take about 700 KiB. */
+
+#define FD_RPC_BLOCKS_DATA_PER_BLOCK (1UL<<20)
+
+/* FD_RPC_BLOCKS_TXN_MAX is the largest number of transactions in an
+   archived block. */
+
+#define FD_RPC_BLOCKS_TXN_MAX (65536UL)
+
+/* FD_RPC_BLOCKS_CACHE_CNT is the number of entries in the response
+   cache, each taking an equal share of its size. */
+
+#define FD_RPC_BLOCKS_CACHE_CNT (16UL)
+
+#define FD_RPC_BLOCKS_TIME_NULL (LONG_MIN)
+
+/* fd_rpc_block_t is the header of a block.  txn_cnt is UINT_MAX if the
+   transactions of the block are not archived. */
+
+struct fd_rpc_block {
+  ulong slot;
+  ulong parent_slot;
+  ulong block_height;
+  long  block_time;   /* Unix timestamp in seconds, FD_RPC_BLOCKS_TIME_NULL if unknown */
+  ulong txn_total;    /* Transactions since genesis, as of this block */
+  uchar blockhash[ 32 ];
+  uchar prev_blockhash[ 32 ];
+  ulong rec_off;      /* Ring file offset of the record, not wrapped */
+  uint  rec_sz;
+  uint  txn_cnt;
+};
+
+typedef struct fd_rpc_block fd_rpc_block_t;
+
+struct fd_rpc_blocks_private;
+typedef struct fd_rpc_blocks_private fd_rpc_blocks_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST ulong
+fd_rpc_blocks_align( void );
+
+/* fd_rpc_blocks_footprint returns the footprint of an archive of up to
+   block_max blocks, tracking up to pending_max completed slots that are
+   not rooted yet, with a response cache of cache_sz bytes (zero
+   disables it). */
+
+FD_FN_CONST ulong
+fd_rpc_blocks_footprint( ulong block_max,
+                         ulong pending_max,
+                         ulong cache_sz );
+
+/* fd_rpc_blocks_new formats a memory region for use as an archive
+   backed by the file at file_path, which is created if needed and
+   truncated to block_max*FD_RPC_BLOCKS_DATA_PER_BLOCK bytes (sparse).
+   Returns NULL on failure, including if the file cannot be opened.
+   fd_rpc_blocks_join joins it. */
+
+void *
+fd_rpc_blocks_new( void *       shmem,
+                   ulong        block_max,
+                   ulong        pending_max,
+                   ulong        cache_sz,
+                   char const * file_path,
+                   ulong        seed );
+
+fd_rpc_blocks_t *
+fd_rpc_blocks_join( void * shblocks );
+
+/* fd_rpc_blocks_fd returns the file descriptor of the ring file. */
+
+int
+fd_rpc_blocks_fd( fd_rpc_blocks_t const * blocks );
+
+/* fd_rpc_blocks_slot_completed records the header of slot, which
+   finished replaying.  The slot, parent_slot, block_height, block_time,
+   txn_total and blockhash fields of block are used.  Returns 0 if the
+   pending table is full, in which case the block will not be
+   archived. */
+
+int
+fd_rpc_blocks_slot_completed( fd_rpc_blocks_t *      blocks,
+                              fd_rpc_block_t const * block );
+
+/* fd_rpc_blocks_root records that root_slot is rooted.  Returns the
+   number of newly rooted slots with a pending header, and points *out
+   to their headers, in slot order, with prev_blockhash filled in (zero
+   if the parent header is unknown).  Each must then be appended to the
+   archive with the functions below.  *out is valid until the next
+   call.  Pending slots on abandoned forks are discarded. */
+
+ulong
+fd_rpc_blocks_root( fd_rpc_blocks_t *        blocks,
+                    ulong                    root_slot,
+                    fd_rpc_block_t const ** out );
+
+/* fd_rpc_blocks_append_{begin,txn,end} append block, with its txn_cnt
+   transactions, to the archive.  Blocks must be appended in slot
+   order.  append_begin returns 0 if the block cannot be archived with
+   its transactions (too many of them, or too large for the ring file),
+   in which case append_missing must be used instead.  append_end
+   returns 0 on I/O error, in which case the block is archived without
+   its transactions.
+
+   fd_rpc_blocks_append_missing appends block without its
+   transactions. */
+
+int
+fd_rpc_blocks_append_begin( fd_rpc_blocks_t *      blocks,
+                            fd_rpc_block_t const * block,
+                            ulong                  txn_cnt );
+
+void
+fd_rpc_blocks_append_txn( fd_rpc_blocks_t * blocks,
+                          uchar const *     payload,
+                          ulong             payload_sz );
+
+int
+fd_rpc_blocks_append_end( fd_rpc_blocks_t * blocks );
+
+void
+fd_rpc_blocks_append_missing( fd_rpc_blocks_t *      blocks,
+                              fd_rpc_block_t const * block );
+
+/* fd_rpc_blocks_query returns the archive index of slot, or
+   FD_RPC_BLOCKS_IDX_NULL if it is not archived.  fd_rpc_blocks_block
+   returns the header of archived block idx.  Indices are stable until
+   the block is evicted. */
+
+ulong
+fd_rpc_blocks_query( fd_rpc_blocks_t const * blocks,
+                     ulong                   slot );
+
+fd_rpc_block_t const *
+fd_rpc_blocks_block( fd_rpc_blocks_t const * blocks,
+                     ulong                   idx );
+
+/* fd_rpc_blocks_{first,last} return the oldest and newest archived
+   slots, ULONG_MAX if the archive is empty.  fd_rpc_blocks_lower_bound
+   returns the archive index of the oldest block not older than slot,
+   and fd_rpc_blocks_next the index of the block after idx, both
+   FD_RPC_BLOCKS_IDX_NULL if there is none. */
+
+ulong fd_rpc_blocks_first( fd_rpc_blocks_t const * blocks );
+ulong fd_rpc_blocks_last ( fd_rpc_blocks_t const * blocks );
+
+ulong
+fd_rpc_blocks_lower_bound( fd_rpc_blocks_t const * blocks,
+                           ulong                   slot );
+
+ulong
+fd_rpc_blocks_next( fd_rpc_blocks_t const * blocks,
+                    ulong                   idx );
+
+/* fd_rpc_blocks_iter_{init,next} read back the transactions of
+   archived block idx, in block order.  iter_init returns 0 if the
+   block has no archived transactions, or on I/O error.  iter_next
+   returns the raw bytes of the next transaction, valid until the next
+   call, and their size in *payload_sz, or NULL at the end of the block
+   or on error (a record that does not match its header).  Only one
+   iteration can be in progress at a time. */
+
+int
+fd_rpc_blocks_iter_init( fd_rpc_blocks_t * blocks,
+                         ulong             idx );
+
+uchar const *
+fd_rpc_blocks_iter_next( fd_rpc_blocks_t * blocks,
+                         ulong *           payload_sz );
+
+/* fd_rpc_blocks_cache_query returns the cached response for (slot,
+   variant) and its size in *sz, or NULL if there is none.  The response
+   is valid until the next cache insert.  fd_rpc_blocks_cache_insert
+   caches a response, replacing the least recently used one, unless it
+   is larger than a cache entry. */
+
+uchar const *
+fd_rpc_blocks_cache_query( fd_rpc_blocks_t * blocks,
+                           ulong             slot,
+                           ulong             variant,
+                           ulong *           sz );
+
+void
+fd_rpc_blocks_cache_insert( fd_rpc_blocks_t * blocks,
+                            ulong             slot,
+                            ulong             variant,
+                            uchar const *     data,
+                            ulong             sz );
+
+ulong fd_rpc_blocks_block_cnt  ( fd_rpc_blocks_t const * blocks );
+ulong fd_rpc_blocks_missing_cnt( fd_rpc_blocks_t const * blocks );
+ulong fd_rpc_blocks_cache_hit  ( fd_rpc_blocks_t const * blocks );
+ulong fd_rpc_blocks_cache_miss ( fd_rpc_blocks_t const * blocks );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_discof_rpc_fd_rpc_blocks_h */
@@ -0,0 +1,354 @@
+#include "fd_rpc_index.h"
+#include "../../flamenco/runtime/fd_system_ids.h"
+
+/* A group is the set of elements sharing one index key.  An element is
+   one (key, account) pair, linked into its group's list. */
+
+struct fd_rpc_index_gkey {
+  uint  kind;
+  uchar key[ 32 ];
+};
+
+typedef struct fd_rpc_index_gkey fd_rpc_index_gkey_t;
+
+struct fd_rpc_index_group {
+  fd_rpc_index_gkey_t gkey;
+  uint                map_next; /* Also used by the pool */
+  uint                head;     /* First element, UINT_MAX if none */
+};
+
+typedef struct fd_rpc_index_group fd_rpc_index_group_t;
+
+struct fd_rpc_index_ekey {
+  uint  group;
+  uchar pubkey[ 32 ];
+};
+
+typedef struct fd_rpc_index_ekey fd_rpc_index_ekey_t;
+
+struct fd_rpc_index_ele {
+  fd_rpc_index_ekey_t ekey;     /* ekey.group is UINT_MAX when free */
+  uint                map_next; /* Also used by the pool */
+  uint                prev;
+  uint                next;
+  ulong               slot;
+};
+
+typedef struct fd_rpc_index_ele fd_rpc_index_ele_t;
+
+#define POOL_NAME  group_pool
+#define POOL_T     fd_rpc_index_group_t
+#define POOL_NEXT  map_next
+#define POOL_IDX_T uint
+#include "../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME               group_map
+#define MAP_ELE_T              fd_rpc_index_group_t
+#define MAP_KEY_T              fd_rpc_index_gkey_t
+#define MAP_KEY                gkey
+#define MAP_IDX_T              uint
+#define MAP_NEXT               map_next
+#define MAP_KEY_EQ(k0,k1)      ((k0)->kind==(k1)->kind && !memcmp( (k0)->key, (k1)->key, 32UL ))
+#define MAP_KEY_HASH(key,seed) fd_hash( (seed), (key), sizeof(fd_rpc_index_gkey_t) )
+#include "../../util/tmpl/fd_map_chain.c"
+
+#define POOL_NAME  ele_pool
+#define POOL_T     fd_rpc_index_ele_t
+#define POOL_NEXT  map_next
+#define POOL_IDX_T uint
+#include "../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME               ele_map
+#define MAP_ELE_T              fd_rpc_index_ele_t
+#define MAP_KEY_T              fd_rpc_index_ekey_t
+#define MAP_KEY                ekey
+#define MAP_IDX_T              uint
+#define MAP_NEXT               map_next
+#define MAP_KEY_EQ(k0,k1)      ((k0)->group==(k1)->group && !memcmp( (k0)->pubkey, (k1)->pubkey, 32UL ))
+#define MAP_KEY_HASH(key,seed) fd_hash( (seed), (key), sizeof(fd_rpc_index_ekey_t) )
+#include "../../util/tmpl/fd_map_chain.c"
+
+#define FD_RPC_INDEX_MAGIC (0xf17eda2ce7a1d3c0UL) /* firedancer rpc index version 0 */
+
+struct __attribute__((aligned(128UL))) fd_rpc_index_private {
+  ulong magic;
+  ulong ele_max;
+  int   full;
+
+  fd_rpc_index_group_t * group_pool;
+  group_map_t *          group_map;
+  fd_rpc_index_ele_t *   ele_pool;
+  ele_map_t *            ele_map;
+};
+
+int
+fd_rpc_index_is_token_program( uchar const owner[ 32 ] ) {
+  return !memcmp( owner, fd_solana_spl_token_id.uc,      32UL ) ||
+         !memcmp( owner, fd_solana_spl_token_2022_id.uc, 32UL );
+}
+
+uint
+fd_rpc_index_keys( uchar const   owner[ 32 ],
+                   uchar const * data,
+                   ulong         data_sz,
+                   uchar         keys[ FD_RPC_INDEX_KIND_CNT ][ 32 ] ) {
+  memcpy( keys[ FD_RPC_INDEX_KIND_PROGRAM ], owner, 32UL );
+  uint mask = 1U<<FD_RPC_INDEX_KIND_PROGRAM;
+
+  /* Agave's GenericTokenAccount::valid_account_data.  A plain SPL
+     Token account is exactly 165 bytes and initialized.  A Token-2022
+     account may also carry extensions, in which case the byte after
+     the base layout is the account type (2 for an account) and the
+     length must not be ambiguous with a multisig. */
+  int valid;
+  if( !memcmp( owner, fd_solana_spl_token_id.uc, 32UL ) ) {
+    valid = data_sz==FD_RPC_INDEX_TOKEN_ACCOUNT_SZ && data[ FD_RPC_INDEX_TOKEN_STATE_OFF ]!=0;
+  } else if( !memcmp( owner, fd_solana_spl_token_2022_id.uc, 32UL ) ) {
+    valid = (data_sz==FD_RPC_INDEX_TOKEN_ACCOUNT_SZ && data[ FD_RPC_INDEX_TOKEN_STATE_OFF ]!=0) ||
+            (data_sz>FD_RPC_INDEX_TOKEN_ACCOUNT_SZ && data_sz!=FD_RPC_INDEX_TOKEN_MULTISIG_SZ && data[ FD_RPC_INDEX_TOKEN_ACCOUNT_SZ ]==2);
+  } else {
+    valid = 0;
+  }
+  if( !valid ) return mask;
+
+  memcpy( keys[ FD_RPC_INDEX_KIND_TOKEN_MINT  ], data+FD_RPC_INDEX_TOKEN_MINT_OFF,  32UL );
+  memcpy( keys[ FD_RPC_INDEX_KIND_TOKEN_OWNER ], data+FD_RPC_INDEX_TOKEN_OWNER_OFF, 32UL );
+  mask |= (1U<<FD_RPC_INDEX_KIND_TOKEN_MINT) | (1U<<FD_RPC_INDEX_KIND_TOKEN_OWNER);
+
+  if( FD_LOAD( uint, data+FD_RPC_INDEX_TOKEN_DELEGATE_OFF )==1U ) {
+    memcpy( keys[ FD_RPC_INDEX_KIND_TOKEN_DELEGATE ], data+FD_RPC_INDEX_TOKEN_DELEGATE_OFF+4UL, 32UL );
+    mask |= 1U<<FD_RPC_INDEX_KIND_TOKEN_DELEGATE;
+  }
+  return mask;
+}
+
+FD_FN_CONST ulong
+fd_rpc_index_align( void ) {
+  return alignof(fd_rpc_index_t);
+}
+
+FD_FN_CONST ulong
+fd_rpc_index_footprint( ulong ele_max ) {
+  if( FD_UNLIKELY( !ele_max || ele_max>=UINT_MAX ) ) return 0UL;
+
+  /* Every group holds at least one element, so there are never more
+     groups than elements. */
+  ulong chain_cnt = ele_map_chain_cnt_est( ele_max );
+
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_index_t), sizeof(fd_rpc_index_t)             );
+  l = FD_LAYOUT_APPEND( l, group_pool_align(),      group_pool_footprint( ele_max )    );
+  l = FD_LAYOUT_APPEND( l, group_map_align(),       group_map_footprint( chain_cnt )   );
+  l = FD_LAYOUT_APPEND( l, ele_pool_align(),        ele_pool_footprint( ele_max )      );
+  l = FD_LAYOUT_APPEND( l, ele_map_align(),         ele_map_footprint( chain_cnt )     );
+  return FD_LAYOUT_FINI( l, fd_rpc_index_align() );
+}
+
+void *
+fd_rpc_index_new( void * shmem,
+                  ulong  ele_max,
+                  ulong  seed ) {
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_rpc_index_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_index_footprint( ele_max ) ) ) {
+    FD_LOG_WARNING(( "invalid ele_max %lu", ele_max ));
+    return NULL;
+  }
+
+  ulong chain_cnt = ele_map_chain_cnt_est( ele_max );
+
+  FD_SCRATCH_ALLOC_INIT( l, shmem );
+  fd_rpc_index_t * index = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_index_t), sizeof(fd_rpc_index_t)           );
+  void * _group_pool     = FD_SCRATCH_ALLOC_APPEND( l, group_pool_align(),      group_pool_footprint( ele_max )  );
+  void * _group_map      = FD_SCRATCH_ALLOC_APPEND( l, group_map_align(),       group_map_footprint( chain_cnt ) );
+  void * _ele_pool       = FD_SCRATCH_ALLOC_APPEND( l, ele_pool_align(),        ele_pool_footprint( ele_max )    );
+  void * _ele_map        = FD_SCRATCH_ALLOC_APPEND( l, ele_map_align(),         ele_map_footprint( chain_cnt )   );
+
+  index->ele_max    = ele_max;
+  index->full       = 0;
+  index->group_pool = group_pool_join( group_pool_new( _group_pool, ele_max ) );
+  index->group_map  = group_map_join( group_map_new( _group_map, chain_cnt, seed ) );
+  index->ele_pool   = ele_pool_join( ele_pool_new( _ele_pool, ele_max ) );
+  index->ele_map    = ele_map_join( ele_map_new( _ele_map, chain_cnt, seed ) );
+  FD_TEST( index->group_pool && index->group_map && index->ele_pool && index->ele_map );
+
+  for( ulong i=0UL; i<ele_max; i++ ) index->ele_pool[ i ].ekey.group = UINT_MAX;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( index->magic ) = FD_RPC_INDEX_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return index;
+}
+
+fd_rpc_index_t *
+fd_rpc_index_join( void * shindex ) {
+  if( FD_UNLIKELY( !shindex ) ) {
+    FD_LOG_WARNING(( "NULL shindex" ));
+    return NULL;
+  }
+
+  fd_rpc_index_t * index = (fd_rpc_index_t *)shindex;
+  if( FD_UNLIKELY( index->magic!=FD_RPC_INDEX_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return index;
+}
+
+static void
+index_insert_key( fd_rpc_index_t * index,
+                  int              kind,
+                  uchar const      key[ 32 ],
+                  uchar const      pubkey[ 32 ],
+                  ulong            slot ) {
+  fd_rpc_index_gkey_t gkey = { .kind = (uint)kind };
+  memcpy( gkey.key, key, 32UL );
+
+  fd_rpc_index_group_t * group = group_map_ele_query( index->group_map, &gkey, NULL, index->group_pool );
+  if( FD_LIKELY( group ) ) {
+    fd_rpc_index_ekey_t ekey = { .group = (uint)group_pool_idx( index->group_pool, group ) };
+    memcpy( ekey.pubkey, pubkey, 32UL );
+    fd_rpc_index_ele_t * ele = ele_map_ele_query( index->ele_map, &ekey, NULL, index->ele_pool );
+    if( FD_LIKELY( ele ) ) {
+      ele->slot = fd_ulong_max( ele->slot, slot );
+      return;
+    }
+  }
+
+  if( FD_UNLIKELY( !ele_pool_free( index->ele_pool ) || (!group && !group_pool_free( index->group_pool )) ) ) {
+    index->full = 1;
+    return;
+  }
+
+  if( FD_UNLIKELY( !group ) ) {
+    group = group_pool_ele_acquire( index->group_pool );
+    group->gkey = gkey;
+    group->head = UINT_MAX;
+    group_map_ele_insert( index->group_map, group, index->group_pool );
+  }
+
+  uint group_idx = (uint)group_pool_idx( index->group_pool, group );
+  fd_rpc_index_ele_t * ele = ele_pool_ele_acquire( index->ele_pool );
+  ele->ekey.group = group_idx;
+  memcpy( ele->ekey.pubkey, pubkey, 32UL );
+  ele->slot = slot;
+  ele->prev = UINT_MAX;
+  ele->next = group->head;
+  uint ele_idx = (uint)ele_pool_idx( index->ele_pool, ele );
+  if( FD_LIKELY( group->head!=UINT_MAX ) ) index->ele_pool[ group->head ].prev = ele_idx;
+  group->head = ele_idx;
+  ele_map_ele_insert( index->ele_map, ele, index->ele_pool );
+}
+
+int
+fd_rpc_index_insert( fd_rpc_index_t * index,
+                     uchar const      pubkey[ 32 ],
+                     uchar const      owner[ 32 ],
+                     uchar const *    data,
+                     ulong            data_sz,
+                     ulong            slot ) {
+  uchar keys[ FD_RPC_INDEX_KIND_CNT ][ 32 ];
+  uint  mask = fd_rpc_index_keys( owner, data, data_sz, keys );
+  for( int kind=0; kind<FD_RPC_INDEX_KIND_CNT; kind++ ) {
+    if( mask & (1U<<kind) ) index_insert_key( index, kind, keys[ kind ], pubkey, slot );
+  }
+  return index->full ? -1 : 0;
+}
+
+ulong
+fd_rpc_index_head( fd_rpc_index_t const * index,
+                   int                    kind,
+                   uchar const            key[ 32 ] ) {
+  fd_rpc_index_gkey_t gkey = { .kind = (uint)kind };
+  memcpy( gkey.key, key, 32UL );
+  fd_rpc_index_group_t const * group = group_map_ele_query_const( index->group_map, &gkey, NULL, index->group_pool );
+  if( FD_UNLIKELY( !group ) ) return FD_RPC_INDEX_IDX_NULL;
+  return group->head==UINT_MAX ? FD_RPC_INDEX_IDX_NULL : (ulong)group->head;
+}
+
+ulong
+fd_rpc_index_next( fd_rpc_index_t const * index,
+                   ulong                  ele_idx ) {
+  uint next = index->ele_pool[ ele_idx ].next;
+  return next==UINT_MAX ? FD_RPC_INDEX_IDX_NULL : (ulong)next;
+}
+
+void
+fd_rpc_index_remove( fd_rpc_index_t * index,
+                     ulong            ele_idx ) {
+  fd_rpc_index_ele_t *   ele   = &index->ele_pool[ ele_idx ];
+  fd_rpc_index_group_t * group = &index->group_pool[ ele->ekey.group ];
+
+  ele_map_idx_remove( index->ele_map, &ele->ekey, ULONG_MAX, index->ele_pool );
+  if( ele->prev!=UINT_MAX ) index->ele_pool[ ele->prev ].next = ele->next;
+  else                      group->head                       = ele->next;
+  if( ele->next!=UINT_MAX ) index->ele_pool[ ele->next ].prev = ele->prev;
+
+  if( group->head==UINT_MAX ) {
+    group_map_idx_remove( index->group_map, &group->gkey, ULONG_MAX, index->group_pool );
+    group_pool_ele_release( index->group_pool, group );
+  }
+
+  ele->ekey.group = UINT_MAX;
+  ele_pool_ele_release( index->ele_pool, ele );
+}
+
+int
+fd_rpc_index_live( fd_rpc_index_t const * index,
+                   ulong                  ele_idx ) {
+  return index->ele_pool[ ele_idx ].ekey.group!=UINT_MAX;
+}
+
+int
+fd_rpc_index_kind( fd_rpc_index_t const * index,
+                   ulong                  ele_idx ) {
+  return (int)index->group_pool[ index->ele_pool[ ele_idx ].ekey.group ].gkey.kind;
+}
+
+uchar const *
+fd_rpc_index_key( fd_rpc_index_t const * index,
+                  ulong                  ele_idx ) {
+  return index->group_pool[ index->ele_pool[ ele_idx ].ekey.group ].gkey.key;
+}
+
+uchar const *
+fd_rpc_index_pubkey( fd_rpc_index_t const * index,
+                     ulong                  ele_idx ) {
+  return index->ele_pool[ ele_idx ].ekey.pubkey;
+}
+
+ulong
+fd_rpc_index_slot( fd_rpc_index_t const * index,
+                   ulong                  ele_idx ) {
+  return index->ele_pool[ ele_idx ].slot;
+}
+
+ulong
+fd_rpc_index_ele_max( fd_rpc_index_t const * index ) {
+  return index->ele_max;
+}
+
+ulong
+fd_rpc_index_ele_cnt( fd_rpc_index_t const * index ) {
+  return ele_pool_used( index->ele_pool );
+}
+
+int
+fd_rpc_index_full( fd_rpc_index_t const * index ) {
+  return index->full;
+}
+
+void
+fd_rpc_index_clear_full( fd_rpc_index_t * index ) {
+  index->full = 0;
+}
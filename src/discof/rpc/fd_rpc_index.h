@@ -0,0 +1,156 @@
+#ifndef HEADER_fd_src_discof_rpc_fd_rpc_index_h
+#define HEADER_fd_src_discof_rpc_fd_rpc_index_h
+
+/* fd_rpc_index is the RPC tile's secondary account index.  It maps an
+   index key (the owner program of an account, or the mint, owner or
+   delegate field of an SPL Token / Token-2022 token account) to the
+   set of accounts that had that key, so that getProgramAccounts and
+   getTokenAccountsBy{Owner,Delegate} visit only the accounts that can
+   match instead of scanning the whole account database.
+
+   The index is a candidate superset rather than an exact answer.  It
+   records (key, account) pairs as they are observed on any fork, tags
+   each pair with the highest slot it was observed at, and never drops
+   a pair that might still be true on some live fork.  Queries re-read
+   every candidate from accdb at the fork being queried and check the
+   key again, which makes the answer exactly as fork-aware as accdb
+   itself.  Pairs that are no longer true at the root, and not newer
+   than it, are stale and can be removed at any time.
+
+   The index is private to a single tile and not thread safe. */
+
+#include "../../util/fd_util_base.h"
+
+#define FD_RPC_INDEX_KIND_PROGRAM        (0) /* Owner program of any account */
+#define FD_RPC_INDEX_KIND_TOKEN_MINT     (1) /* Mint of a token account */
+#define FD_RPC_INDEX_KIND_TOKEN_OWNER    (2) /* Owner (authority) of a token account */
+#define FD_RPC_INDEX_KIND_TOKEN_DELEGATE (3) /* Delegate of a token account, if any */
+#define FD_RPC_INDEX_KIND_CNT            (4)
+
+/* Layout of an SPL Token account, shared by Token-2022 accounts which
+   append a one byte account type and extensions. */
+
+#define FD_RPC_INDEX_TOKEN_ACCOUNT_SZ   (165UL)
+#define FD_RPC_INDEX_TOKEN_MULTISIG_SZ  (355UL)
+#define FD_RPC_INDEX_TOKEN_MINT_OFF     (  0UL)
+#define FD_RPC_INDEX_TOKEN_OWNER_OFF    ( 32UL)
+#define FD_RPC_INDEX_TOKEN_DELEGATE_OFF ( 72UL) /* COption<Pubkey>, u32 tag then key */
+#define FD_RPC_INDEX_TOKEN_STATE_OFF    (108UL)
+
+#define FD_RPC_INDEX_IDX_NULL (ULONG_MAX)
+
+struct fd_rpc_index_private;
+typedef struct fd_rpc_index_private fd_rpc_index_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_rpc_index_is_token_program returns 1 if owner is the SPL Token or
+   the Token-2022 program. */
+
+int
+fd_rpc_index_is_token_program( uchar const owner[ 32 ] );
+
+/* fd_rpc_index_keys extracts the index keys of an account owned by
+   owner with the given data.  keys[ kind ] is set for every kind whose
+   bit is set in the returned mask.  The program key is always present.
+   The token keys are present if the account is an initialized token
+   account (matching Agave's secondary index rules), and the delegate
+   key only if a delegate is set. */
+
+uint
+fd_rpc_index_keys( uchar const   owner[ 32 ],
+                   uchar const * data,
+                   ulong         data_sz,
+                   uchar         keys[ FD_RPC_INDEX_KIND_CNT ][ 32 ] );
+
+/* fd_rpc_index_matches returns 1 if an account owned by owner with the
+   given data currently has key as its index key of the given kind. */
+
+static inline int
+fd_rpc_index_matches( int           kind,
+                      uchar const   key[ 32 ],
+                      uchar const   owner[ 32 ],
+                      uchar const * data,
+                      ulong         data_sz ) {
+  uchar keys[ FD_RPC_INDEX_KIND_CNT ][ 32 ];
+  uint  mask = fd_rpc_index_keys( owner, data, data_sz, keys );
+  return (mask & (1U<<kind)) && !memcmp( keys[ kind ], key, 32UL );
+}
+
+FD_FN_CONST ulong
+fd_rpc_index_align( void );
+
+FD_FN_CONST ulong
+fd_rpc_index_footprint( ulong ele_max );
+
+/* fd_rpc_index_new formats a memory region as an index able to hold up
+   to ele_max (key, account) pairs.  fd_rpc_index_join joins it. */
+
+void *
+fd_rpc_index_new( void * shmem,
+                  ulong  ele_max,
+                  ulong  seed );
+
+fd_rpc_index_t *
+fd_rpc_index_join( void * shindex );
+
+/* fd_rpc_index_insert records that pubkey, owned by owner and holding
+   data, was observed at slot.  A pair that is already present has its
+   slot raised to slot if lower.  Returns 0 on success.  Returns -1 if
+   the index ran out of space, in which case some pairs were not
+   recorded and the index is marked full: query results can no longer
+   be trusted to be complete. */
+
+int
+fd_rpc_index_insert( fd_rpc_index_t * index,
+                     uchar const      pubkey[ 32 ],
+                     uchar const      owner[ 32 ],
+                     uchar const *    data,
+                     ulong            data_sz,
+                     ulong            slot );
+
+/* fd_rpc_index_{head,next} iterate over the candidates recorded for key
+   of the given kind, newest insertions first.  Returns
+   FD_RPC_INDEX_IDX_NULL at the end.  An element can be removed while
+   iterating, provided next is read before the remove. */
+
+ulong
+fd_rpc_index_head( fd_rpc_index_t const * index,
+                   int                    kind,
+                   uchar const            key[ 32 ] );
+
+ulong
+fd_rpc_index_next( fd_rpc_index_t const * index,
+                   ulong                  ele_idx );
+
+/* fd_rpc_index_remove removes element ele_idx from the index. */
+
+void
+fd_rpc_index_remove( fd_rpc_index_t * index,
+                     ulong            ele_idx );
+
+/* Accessors for element ele_idx.  fd_rpc_index_live returns 0 if
+   ele_idx, in [0,fd_rpc_index_ele_max), is not currently in use, which
+   lets a caller sweep the whole index by element index. */
+
+int           fd_rpc_index_live  ( fd_rpc_index_t const * index, ulong ele_idx );
+int           fd_rpc_index_kind  ( fd_rpc_index_t const * index, ulong ele_idx );
+uchar const * fd_rpc_index_key   ( fd_rpc_index_t const * index, ulong ele_idx );
+uchar const * fd_rpc_index_pubkey( fd_rpc_index_t const * index, ulong ele_idx );
+ulong         fd_rpc_index_slot  ( fd_rpc_index_t const * index, ulong ele_idx );
+
+ulong fd_rpc_index_ele_max( fd_rpc_index_t const * index );
+ulong fd_rpc_index_ele_cnt( fd_rpc_index_t const * index );
+int   fd_rpc_index_full   ( fd_rpc_index_t const * index );
+
+/* fd_rpc_index_clear_full clears the full mark.  The caller is
+   responsible for re-inserting every pair that may have been missed
+   while the index was full, typically by rebuilding it from scratch
+   after removing stale pairs to make space. */
+
+void
+fd_rpc_index_clear_full( fd_rpc_index_t * index );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_discof_rpc_fd_rpc_index_h */
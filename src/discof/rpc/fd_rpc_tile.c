@@ -13,6 +13,9 @@
 #include "../../flamenco/features/fd_features.h"
 #include "../../flamenco/runtime/sysvar/fd_sysvar_rent.h"
 #include "../../flamenco/runtime/fd_runtime_const.h"
+#include "../../flamenco/runtime/fd_runtime_err.h"
+#include "../../flamenco/runtime/fd_executor_err.h"
+#include "../../flamenco/runtime/fd_system_ids.h"
 #include "../../flamenco/accdb/fd_accdb.h"
 #include "../../flamenco/accdb/fd_accdb_shmem.h"
 #include "../../tango/fseq/fd_fseq.h"
@@ -35,6 +38,9 @@
 #include "../../util/archive/fd_tar.h"
 #include "../../third_party/bzip2/bzlib.h"
 
+#include "fd_rpc_index.h"
+#include "fd_rpc_txnstatus.h"
+#include "fd_rpc_blocks.h"
 #include "generated/fd_rpc_tile_seccomp.h"
 
 #define FD_RPC_AGAVE_API_VERSION "4.0.0-beta.6"
@@ -47,6 +53,24 @@
 #define IN_KIND_GOSSIP_OUT  (2)
 #define IN_KIND_TOWER       (3)
 
+#define FD_RPC_INDEX_STATUS_DISABLED (0UL)
+#define FD_RPC_INDEX_STATUS_BUILDING (1UL)
+#define FD_RPC_INDEX_STATUS_READY    (2UL)
+#define FD_RPC_INDEX_STATUS_FULL     (3UL)
+
+/* Account index maintenance runs in small bursts from before_credit so
+   that it never holds off the HTTP server for long.  Every account
+   visited costs an accdb read. */
+#define FD_RPC_INDEX_SCAN_BURST  (16UL)   /* accdb chains per burst */
+#define FD_RPC_INDEX_SWEEP_BURST (16UL)   /* index elements per burst */
+#define FD_RPC_INDEX_REBUILD_FREE (8UL)   /* rebuild a full index once 1/8 of it is free */
+#define FD_RPC_INDEX_KEY_BATCH   (1024UL) /* accdb addresses per page */
+
+#define FD_RPC_FILTER_DATA_SIZE           (0)
+#define FD_RPC_FILTER_MEMCMP              (1)
+#define FD_RPC_FILTER_TOKEN_ACCOUNT_STATE (2)
+#define FD_RPC_FILTER_MAX                 (4UL)
+
 /* From bzip2 docs:
       To guarantee that the compressed data will fit in its buffer,
       allocate an output buffer of size 1% larger than the uncompressed
@@ -247,6 +271,34 @@ typedef struct fd_rpc_cluster_node fd_rpc_cluster_node_t;
 #define DLIST_NEXT dlist.next
 #include "../../util/tmpl/fd_dlist.c"
 
+/* getSignaturesForAddress collects up to FD_RPC_SIG_CAND_MAX visible
+   transactions of an address before sorting them by position in the
+   chain, which postings are only approximately ordered by when there
+   are forks. */
+
+#define FD_RPC_SIG_CAND_MAX (8192UL)
+
+struct fd_rpc_sig_cand {
+  ulong slot;
+  ulong index_in_slot;
+  ulong txn_idx;
+};
+
+typedef struct fd_rpc_sig_cand fd_rpc_sig_cand_t;
+
+#define SORT_NAME        fd_rpc_sig_cand_sort
+#define SORT_KEY_T       fd_rpc_sig_cand_t
+#define SORT_BEFORE(a,b) ( (a).slot>(b).slot || ( (a).slot==(b).slot && (a).index_in_slot>(b).index_in_slot ) )
+#include "../../util/tmpl/fd_sort.c"
+
+/* Transactions of a block being archived are sorted by block order,
+   with keys index_in_slot<<32 | transaction status store index. */
+
+#define SORT_NAME        fd_rpc_block_txn_sort
+#define SORT_KEY_T       ulong
+#define SORT_BEFORE(a,b) ((a)<(b))
+#include "../../util/tmpl/fd_sort.c"
+
 struct fd_rpc_tile {
   int delay_startup;
   fd_http_server_t * http;
@@ -306,6 +358,46 @@ struct fd_rpc_tile {
      runtime account data maximum.  Must not be in accdb shmem. */
   uchar accdb_data_buf[ FD_RUNTIME_ACC_SZ_MAX ];
 
+  /* Secondary account index for getProgramAccounts and the token
+     account queries, NULL if disabled.  It is populated from the write
+     set of every completed slot, plus a one-off incremental scan of the
+     whole account database (index_scan_chain counts the accdb chains
+     visited so far, and index_scan_after is where to resume in the
+     current chain if index_scan_resume is set) to pick up accounts
+     loaded from the snapshot.  index_sweep_idx is the next element
+     checked for staleness.
+
+     When the index runs out of space, writes stop being indexed, but
+     the sweep keeps freeing stale elements.  index_full_slot is the
+     last slot whose writes were skipped.  Once that slot is rooted and
+     the sweep has freed enough space, the index is rebuilt with a new
+     scan of the whole account database. */
+  fd_rpc_index_t * index;
+  ulong            index_seed;
+  ulong            index_scan_chain;
+  int              index_scan_resume;
+  uchar            index_scan_after[ 32 ];
+  ulong            index_sweep_idx;
+  ulong            index_full_slot;
+  ulong            index_rebuild_cnt;
+  uchar            index_keys[ FD_RPC_INDEX_KEY_BATCH ][ 32 ];
+
+  /* Transaction status store for getTransaction,
+     getSignatureStatuses and getSignaturesForAddress, NULL if
+     disabled.  It is written from the transactions executed by replay.
+     txnstatus_dropped counts executed transactions that could not be
+     stored. */
+  fd_rpc_txnstatus_t * txnstatus;
+  ulong                txnstatus_dropped;
+  fd_rpc_sig_cand_t    txnstatus_cand[ FD_RPC_SIG_CAND_MAX ];
+
+  /* Archive of rooted blocks for getBlock and friends, NULL if
+     disabled.  Block headers are recorded as slots complete, and the
+     transactions of a block are copied from the transaction status
+     store once it is rooted. */
+  fd_rpc_blocks_t * blocks;
+  ulong             block_txn[ FD_RPC_BLOCKS_TXN_MAX ];
+
   /* Redirect to snapshot server */
   int    snapshot_server_enabled;
   char   snapshot_server_url[ 288UL ];
@@ -441,6 +533,36 @@ fd_rpc_file_as_tarball( fd_rpc_tile_t * ctx,
   return tar_bz_sz;
 }
 
+/* The slot table of the transaction status store must cover the live
+   slots, plus enough rooted slots for the retained transactions, which
+   assumes at least 16 transactions per slot on average. */
+
+static inline ulong
+txnstatus_slot_max( fd_topo_tile_t const * tile ) {
+  return tile->rpc.max_live_slots+tile->rpc.transaction_status_max/16UL;
+}
+
+static inline ulong
+txnstatus_footprint( fd_topo_tile_t const * tile ) {
+  if( FD_LIKELY( !tile->rpc.transaction_status_max ) ) return 0UL;
+  return fd_rpc_txnstatus_footprint( tile->rpc.transaction_status_max, txnstatus_slot_max( tile ) );
+}
+
+/* Completed slots wait in the block archive until rooted, which
+   includes slots on forks that are only pruned once the root passes
+   them. */
+
+static inline ulong
+blocks_pending_max( fd_topo_tile_t const * tile ) {
+  return 2UL*tile->rpc.max_live_slots;
+}
+
+static inline ulong
+blocks_footprint( fd_topo_tile_t const * tile ) {
+  if( FD_LIKELY( !tile->rpc.block_archive_max ) ) return 0UL;
+  return fd_rpc_blocks_footprint( tile->rpc.block_archive_max, blocks_pending_max( tile ), tile->rpc.block_cache_sz );
+}
+
 FD_FN_CONST static inline ulong
 scratch_align( void ) {
   ulong a = alignof( fd_rpc_tile_t );
@@ -449,6 +571,9 @@ scratch_align( void ) {
   a = fd_ulong_max( a, alignof(bank_info_t) );
   a = fd_ulong_max( a, fd_rpc_cluster_node_dlist_align() );
   a = fd_ulong_max( a, fd_accdb_align() );
+  a = fd_ulong_max( a, fd_rpc_index_align() );
+  a = fd_ulong_max( a, fd_rpc_txnstatus_align() );
+  a = fd_ulong_max( a, fd_rpc_blocks_align() );
   return a;
 }
 
@@ -461,6 +586,8 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   ulong l = FD_LAYOUT_INIT;
   l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_tile_t),            sizeof(fd_rpc_tile_t)                                              );
   l = FD_LAYOUT_APPEND( l, fd_http_server_align(),            http_fp                                                            );
+  l = FD_LAYOUT_APPEND( l, fd_rpc_txnstatus_align(),          txnstatus_footprint( tile )                                        );
+  l = FD_LAYOUT_APPEND( l, fd_rpc_blocks_align(),             blocks_footprint( tile )                                           );
   l = FD_LAYOUT_APPEND( l, fd_alloc_align(),                  fd_alloc_footprint()                                               );
   l = FD_LAYOUT_APPEND( l, fd_alloc_align(),                  fd_alloc_footprint()                                               );
   l = FD_LAYOUT_APPEND( l, alignof(bank_info_t),              tile->rpc.max_live_slots*sizeof(bank_info_t)                       );
@@ -470,6 +597,7 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND( l, alignof(ulong),                    http_params.max_ws_connection_cnt*sizeof(ulong)                    );
   l = FD_LAYOUT_APPEND( l, alignof(uchar),                    fd_rpc_genesis_tar_max_sz( tile->rpc.genesis_max_message_size )    );
   l = FD_LAYOUT_APPEND( l, alignof(uchar),                    fd_rpc_genesis_tar_bz_max_sz( tile->rpc.genesis_max_message_size ) );
+  l = FD_LAYOUT_APPEND( l, fd_rpc_index_align(),              fd_rpc_index_footprint( tile->rpc.account_index_max )              );
 # if FD_HAS_ZSTD
   l = FD_LAYOUT_APPEND( l, 16UL, ZSTD_estimateCCtxSize( FD_RPC_ZSTD_LEVEL ) );
 # endif
@@ -489,6 +617,14 @@ during_housekeeping( fd_rpc_tile_t * ctx ) {
   }
 }
 
+static inline ulong
+fd_rpc_index_status( fd_rpc_tile_t const * ctx ) {
+  if( FD_UNLIKELY( !ctx->index                                        ) ) return FD_RPC_INDEX_STATUS_DISABLED;
+  if( FD_UNLIKELY( fd_rpc_index_full( ctx->index )                    ) ) return FD_RPC_INDEX_STATUS_FULL;
+  if( FD_UNLIKELY( ctx->index_scan_chain<fd_accdb_chain_cnt( ctx->accdb ) ) ) return FD_RPC_INDEX_STATUS_BUILDING;
+  return FD_RPC_INDEX_STATUS_READY;
+}
+
 static inline void
 metrics_write( fd_rpc_tile_t * ctx ) {
   FD_MHIST_COPY( RPC, REQUEST_DURATION_SECONDS,           ctx->request_duration                );
@@ -497,6 +633,141 @@ metrics_write( fd_rpc_tile_t * ctx ) {
   FD_MGAUGE_SET( RPC, WEBSOCKET_SUBSCRIPTION_ACTIVE_VOTE, ctx->ws_subscribers_vote_cnt         );
   FD_MGAUGE_SET( RPC, WEBSOCKET_SUBSCRIPTION_ACTIVE_SLOT, ctx->ws_subscribers_slot_cnt         );
   FD_ACCDB_METRICS_WRITE_RO( RPC, fd_accdb_metrics( ctx->accdb ) );
+  FD_MGAUGE_SET( RPC, ACCOUNT_INDEX_STATUS,  fd_rpc_index_status( ctx ) );
+  FD_MGAUGE_SET( RPC, ACCOUNT_INDEX_ENTRIES, ctx->index ? fd_rpc_index_ele_cnt( ctx->index ) : 0UL );
+  FD_MCNT_SET  ( RPC, ACCOUNT_INDEX_REBUILDS, ctx->index_rebuild_cnt );
+  FD_MGAUGE_SET( RPC, TRANSACTION_STATUS_ENTRIES, ctx->txnstatus ? fd_rpc_txnstatus_txn_cnt( ctx->txnstatus )   : 0UL );
+  FD_MCNT_SET  ( RPC, TRANSACTION_STATUS_EVICTED, ctx->txnstatus ? fd_rpc_txnstatus_evict_cnt( ctx->txnstatus ) : 0UL );
+  FD_MCNT_SET  ( RPC, TRANSACTION_STATUS_DROPPED, ctx->txnstatus_dropped );
+  FD_MGAUGE_SET( RPC, BLOCK_ARCHIVE_ENTRIES,     ctx->blocks ? fd_rpc_blocks_block_cnt( ctx->blocks )   : 0UL );
+  FD_MCNT_SET  ( RPC, BLOCK_ARCHIVE_UNAVAILABLE, ctx->blocks ? fd_rpc_blocks_missing_cnt( ctx->blocks ) : 0UL );
+  FD_MCNT_SET  ( RPC, BLOCK_CACHE_HIT,           ctx->blocks ? fd_rpc_blocks_cache_hit( ctx->blocks )   : 0UL );
+  FD_MCNT_SET  ( RPC, BLOCK_CACHE_MISS,          ctx->blocks ? fd_rpc_blocks_cache_miss( ctx->blocks )  : 0UL );
+}
+
+/* fd_rpc_index_observe reads pubkey at fork_id and, if it exists,
+   records its index keys as observed at slot. */
+
+static void
+fd_rpc_index_observe( fd_rpc_tile_t *    ctx,
+                      fd_accdb_fork_id_t fork_id,
+                      ulong              slot,
+                      uchar const        pubkey[ 32 ] ) {
+  if( FD_UNLIKELY( fd_rpc_index_full( ctx->index ) ) ) return;
+
+  ulong acct_lamports;
+  int   acct_executable;
+  uchar acct_owner[ 32UL ];
+  ulong acct_data_len;
+  fd_accdb_read_one_nocache( ctx->accdb, fork_id, pubkey,
+                             &acct_lamports, &acct_executable, acct_owner,
+                             ctx->accdb_data_buf, &acct_data_len );
+  if( FD_UNLIKELY( !acct_lamports ) ) return;
+
+  if( FD_UNLIKELY( fd_rpc_index_insert( ctx->index, pubkey, acct_owner, ctx->accdb_data_buf, acct_data_len, slot ) ) ) {
+    FD_LOG_WARNING(( "rpc account index is full (%lu entries), getProgramAccounts and getTokenAccountsBy* are disabled until "
+                     "stale entries are removed and the index is rebuilt. Increase [tiles.rpc.account_index_max] to avoid this",
+                     fd_rpc_index_ele_max( ctx->index ) ));
+  }
+}
+
+/* fd_rpc_index_slot_completed indexes every account written by the
+   slot that was just completed on bank.  The bank was frozen before
+   the completion was published and we hold a reference on it, so its
+   accdb fork is not purged under us, and it cannot be rooted before
+   tower has observed votes on it. */
+
+static void
+fd_rpc_index_slot_completed( fd_rpc_tile_t *     ctx,
+                             bank_info_t const * bank ) {
+  ulong cursor = 0UL;
+  while( cursor!=ULONG_MAX ) {
+    ulong cnt = fd_accdb_fork_writes( ctx->accdb, bank->accdb_fork_id, &cursor, ctx->index_keys, FD_RPC_INDEX_KEY_BATCH );
+    for( ulong i=0UL; i<cnt; i++ ) fd_rpc_index_observe( ctx, bank->accdb_fork_id, bank->slot, ctx->index_keys[ i ] );
+  }
+  if( FD_UNLIKELY( fd_rpc_index_full( ctx->index ) ) ) ctx->index_full_slot = fd_ulong_max( ctx->index_full_slot, bank->slot );
+}
+
+/* fd_rpc_index_stale returns 1 if element ele_idx of the index no
+   longer describes the account at the root bank and was not observed
+   after it, i.e. it cannot be true on any live fork. */
+
+static int
+fd_rpc_index_stale( fd_rpc_tile_t *     ctx,
+                    bank_info_t const * root,
+                    ulong               ele_idx,
+                    ulong               acct_lamports,
+                    uchar const *       acct_owner,
+                    ulong               acct_data_len ) {
+  if( FD_UNLIKELY( fd_rpc_index_slot( ctx->index, ele_idx )>root->slot ) ) return 0;
+  if( FD_UNLIKELY( !acct_lamports ) ) return 1;
+  return !fd_rpc_index_matches( fd_rpc_index_kind( ctx->index, ele_idx ), fd_rpc_index_key( ctx->index, ele_idx ),
+                                acct_owner, ctx->accdb_data_buf, acct_data_len );
+}
+
+/* fd_rpc_index_step does a burst of background index work: the
+   initial scan of the account database until it completes, and then
+   the sweep for stale elements.  Both read accounts at the root.  If
+   the index is full, it is rebuilt once every slot whose writes were
+   skipped is rooted and a sweep pass has left at least
+   1/FD_RPC_INDEX_REBUILD_FREE of the index free. */
+
+static void
+fd_rpc_index_step( fd_rpc_tile_t * ctx,
+                   int *           charge_busy ) {
+  if( FD_LIKELY( !ctx->index || ctx->finalized_idx==ULONG_MAX ) ) return;
+  bank_info_t const * root = &ctx->banks[ ctx->finalized_idx ];
+  *charge_busy = 1;
+
+  int   full      = fd_rpc_index_full( ctx->index );
+  ulong chain_cnt = fd_accdb_chain_cnt( ctx->accdb );
+  if( FD_UNLIKELY( !full && ctx->index_scan_chain<chain_cnt ) ) {
+    for( ulong i=0UL; i<FD_RPC_INDEX_SCAN_BURST && ctx->index_scan_chain<chain_cnt; i++ ) {
+      ulong cnt = fd_accdb_scan_chain( ctx->accdb, ctx->index_scan_chain, ctx->index_scan_resume ? ctx->index_scan_after : NULL,
+                                       ctx->index_keys, FD_RPC_INDEX_KEY_BATCH );
+      for( ulong j=0UL; j<cnt; j++ ) fd_rpc_index_observe( ctx, root->accdb_fork_id, root->slot, ctx->index_keys[ j ] );
+      ctx->index_scan_resume = cnt==FD_RPC_INDEX_KEY_BATCH;
+      if( FD_UNLIKELY( ctx->index_scan_resume ) ) memcpy( ctx->index_scan_after, ctx->index_keys[ cnt-1UL ], 32UL );
+      else                                        ctx->index_scan_chain++;
+    }
+    if( FD_UNLIKELY( ctx->index_scan_chain==chain_cnt && !fd_rpc_index_full( ctx->index ) ) ) {
+      FD_LOG_NOTICE(( "rpc account index ready (%lu entries)", fd_rpc_index_ele_cnt( ctx->index ) ));
+    }
+    return;
+  }
+
+  ulong ele_max = fd_rpc_index_ele_max( ctx->index );
+  int   wrapped = 0;
+  for( ulong i=0UL; i<FD_RPC_INDEX_SWEEP_BURST; i++ ) {
+    ulong ele_idx = ctx->index_sweep_idx;
+    ctx->index_sweep_idx = fd_ulong_if( ele_idx+1UL<ele_max, ele_idx+1UL, 0UL );
+    wrapped |= !ctx->index_sweep_idx;
+    if( FD_LIKELY( !fd_rpc_index_live( ctx->index, ele_idx ) ) ) continue;
+
+    ulong acct_lamports;
+    int   acct_executable;
+    uchar acct_owner[ 32UL ];
+    ulong acct_data_len;
+    fd_accdb_read_one_nocache( ctx->accdb, root->accdb_fork_id, fd_rpc_index_pubkey( ctx->index, ele_idx ),
+                               &acct_lamports, &acct_executable, acct_owner,
+                               ctx->accdb_data_buf, &acct_data_len );
+    if( FD_UNLIKELY( fd_rpc_index_stale( ctx, root, ele_idx, acct_lamports, acct_owner, acct_data_len ) ) ) {
+      fd_rpc_index_remove( ctx->index, ele_idx );
+      FD_MCNT_INC( RPC, ACCOUNT_INDEX_STALE_REMOVED, 1UL );
+    }
+  }
+
+  if( FD_UNLIKELY( full && wrapped &&
+                   root->slot>=ctx->index_full_slot &&
+                   fd_rpc_index_ele_cnt( ctx->index )<=ele_max-ele_max/FD_RPC_INDEX_REBUILD_FREE ) ) {
+    /* Writes of slots that were skipped while full are now either
+       rooted, and picked up by the scan, or dead. */
+    FD_LOG_NOTICE(( "rebuilding rpc account index (%lu entries left after removing stale entries)", fd_rpc_index_ele_cnt( ctx->index ) ));
+    fd_rpc_index_clear_full( ctx->index );
+    ctx->index_scan_chain  = 0UL;
+    ctx->index_scan_resume = 0;
+    ctx->index_rebuild_cnt++;
+  }
 }
 
 static void
@@ -515,6 +786,8 @@ before_credit( fd_rpc_tile_t *     ctx,
     *charge_busy = fd_http_server_poll( ctx->http, 0, 1UL );
     ctx->next_poll_deadline = fd_tickcount() + (long)(fd_tempo_tick_per_ns( NULL )*128L*1000L);
   }
+
+  fd_rpc_index_step( ctx, charge_busy );
 }
 
 static int
@@ -528,6 +801,10 @@ before_frag( fd_rpc_tile_t *   ctx,
            sig!=FD_GOSSIP_UPDATE_TAG_VOTE;
   }
 
+  /* Executed transactions are the bulk of the replay link, skip them
+     before reading the frag if they are not stored. */
+  if( FD_LIKELY( ctx->in_kind[ in_idx ]==IN_KIND_REPLAY ) ) return sig==REPLAY_SIG_TXN_EXECUTED && !ctx->txnstatus;
+
   return 0;
 }
 
@@ -666,6 +943,84 @@ fd_rpc_publish_slot_event( fd_rpc_tile_t *                    ctx,
   FD_MCNT_INC( RPC, WEBSOCKET_EVENT_SENT_SLOT,          sent_cnt );
 }
 
+/* fd_rpc_blocks_completed records the header of a completed slot in
+   the block archive.  The block time is the Clock sysvar timestamp of
+   the slot, as Agave records it. */
+
+static void
+fd_rpc_blocks_completed( fd_rpc_tile_t *                    ctx,
+                         fd_replay_slot_completed_t const * slot_completed ) {
+  fd_rpc_block_t block = {
+    .slot         = slot_completed->slot,
+    .parent_slot  = slot_completed->parent_slot,
+    .block_height = slot_completed->block_height,
+    .block_time   = FD_RPC_BLOCKS_TIME_NULL,
+    .txn_total    = slot_completed->transaction_count,
+  };
+  fd_memcpy( block.blockhash, slot_completed->block_hash.uc, 32UL );
+
+  ulong acct_lamports;
+  int   acct_executable;
+  uchar acct_owner[ 32UL ];
+  ulong acct_data_len;
+  fd_accdb_read_one_nocache( ctx->accdb, slot_completed->accdb_fork_id, fd_sysvar_clock_id.uc,
+                             &acct_lamports, &acct_executable, acct_owner,
+                             ctx->accdb_data_buf, &acct_data_len );
+  if( FD_LIKELY( acct_lamports && acct_data_len>=sizeof(fd_sol_sysvar_clock_t) ) ) {
+    block.block_time = FD_LOAD( long, ctx->accdb_data_buf+offsetof(fd_sol_sysvar_clock_t, unix_timestamp) );
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_blocks_slot_completed( ctx->blocks, &block ) ) ) {
+    FD_LOG_WARNING(( "too many completed slots waiting to be rooted, slot %lu will not be in the block archive", block.slot ));
+  }
+}
+
+/* fd_rpc_blocks_archive appends the blocks rooted by root_slot to the
+   block archive, with their transactions read back from the
+   transaction status store.  It must run before the store sees the new
+   root.  A block is archived without its transactions unless all of
+   them are still in the store: the transaction count since genesis of
+   the block and its parent tells how many there are, and their indices
+   in the block must be dense. */
+
+static void
+fd_rpc_blocks_archive( fd_rpc_tile_t * ctx,
+                       ulong           root_slot ) {
+  fd_rpc_block_t const * rooted;
+  ulong                  rooted_cnt = fd_rpc_blocks_root( ctx->blocks, root_slot, &rooted );
+
+  for( ulong i=0UL; i<rooted_cnt; i++ ) {
+    fd_rpc_block_t const * block = &rooted[ i ];
+
+    ulong txn_cnt = ULONG_MAX;
+    ulong last    = fd_rpc_blocks_query( ctx->blocks, fd_rpc_blocks_last( ctx->blocks ) );
+    if(      FD_LIKELY( i && rooted[ i-1UL ].slot==block->parent_slot ) ) txn_cnt = block->txn_total-rooted[ i-1UL ].txn_total;
+    else if( FD_LIKELY( last!=FD_RPC_BLOCKS_IDX_NULL && fd_rpc_blocks_block( ctx->blocks, last )->slot==block->parent_slot ) ) {
+      txn_cnt = block->txn_total-fd_rpc_blocks_block( ctx->blocks, last )->txn_total;
+    }
+
+    ulong cnt = fd_rpc_txnstatus_slot_txns( ctx->txnstatus, block->slot, ctx->block_txn, FD_RPC_BLOCKS_TXN_MAX );
+    int   ok  = cnt!=ULONG_MAX && ( txn_cnt==ULONG_MAX || cnt==txn_cnt );
+    if( FD_LIKELY( ok ) ) {
+      for( ulong j=0UL; j<cnt; j++ ) ctx->block_txn[ j ] |= fd_rpc_txnstatus_index_in_slot( ctx->txnstatus, ctx->block_txn[ j ] )<<32;
+      fd_rpc_block_txn_sort_inplace( ctx->block_txn, cnt );
+      for( ulong j=0UL; j<cnt; j++ ) ok &= (ctx->block_txn[ j ]>>32)==j;
+    }
+    if( FD_UNLIKELY( !ok || !fd_rpc_blocks_append_begin( ctx->blocks, block, cnt ) ) ) {
+      fd_rpc_blocks_append_missing( ctx->blocks, block );
+      continue;
+    }
+
+    uchar payload[ FD_TXN_MTU ];
+    for( ulong j=0UL; j<cnt; j++ ) {
+      ulong payload_sz = fd_rpc_txnstatus_read( ctx->txnstatus, ctx->block_txn[ j ] & UINT_MAX, payload );
+      if( FD_UNLIKELY( !payload_sz ) ) break; /* The block is archived without transactions */
+      fd_rpc_blocks_append_txn( ctx->blocks, payload, payload_sz );
+    }
+    fd_rpc_blocks_append_end( ctx->blocks );
+  }
+}
+
 static inline int
 returnable_frag( fd_rpc_tile_t *     ctx,
                  ulong               in_idx,
@@ -708,6 +1063,10 @@ returnable_frag( fd_rpc_tile_t *     ctx,
 
         fd_rpc_publish_slot_event( ctx, slot_completed );
 
+        if( FD_LIKELY( ctx->index ) ) fd_rpc_index_slot_completed( ctx, bank );
+        if( FD_LIKELY( ctx->txnstatus ) ) fd_rpc_txnstatus_slot_completed( ctx->txnstatus, slot_completed->slot, slot_completed->parent_slot );
+        if( FD_LIKELY( ctx->blocks ) ) fd_rpc_blocks_completed( ctx, slot_completed );
+
         /* In Agave, "processed" confirmation is the bank we've just
            voted for (handle_votable_bank), which is also guaranteed to
            have been replayed.
@@ -742,6 +1101,27 @@ returnable_frag( fd_rpc_tile_t *     ctx,
         if( FD_LIKELY( ctx->finalized_idx!=ULONG_MAX ) ) fd_stem_publish( stem, ctx->replay_out->idx, ctx->finalized_idx, 0UL, 0UL, 0UL, 0UL, 0UL );
         FD_TEST( msg->bank_idx<ctx->max_live_slots );
         ctx->finalized_idx = msg->bank_idx;
+        if( FD_LIKELY( ctx->blocks ) ) fd_rpc_blocks_archive( ctx, msg->slot );
+        if( FD_LIKELY( ctx->txnstatus ) ) fd_rpc_txnstatus_root( ctx->txnstatus, msg->slot );
+        break;
+      }
+      case REPLAY_SIG_SLOT_DEAD: {
+        fd_replay_slot_dead_t const * msg = fd_chunk_to_laddr_const( ctx->in[ in_idx ].mem, chunk );
+        if( FD_LIKELY( ctx->txnstatus ) ) fd_rpc_txnstatus_slot_dead( ctx->txnstatus, msg->slot );
+        break;
+      }
+      case REPLAY_SIG_TXN_EXECUTED: {
+        fd_replay_txn_executed_t const * msg = fd_chunk_to_laddr_const( ctx->in[ in_idx ].mem, chunk );
+        if( FD_UNLIKELY( !ctx->txnstatus || !msg->is_committable ) ) break;
+        fd_rpc_txnstatus_err_t err = {
+          .txn_err    = msg->txn_err,
+          .instr_err  = msg->exec_err,
+          .instr_idx  = msg->exec_err_idx,
+          .custom_err = msg->custom_err
+        };
+        if( FD_UNLIKELY( !fd_rpc_txnstatus_insert( ctx->txnstatus, msg->slot, msg->index_in_slot, &err, msg->txn->payload, msg->txn->payload_sz, TXN( msg->txn ) ) ) ) {
+          ctx->txnstatus_dropped++;
+        }
         break;
       }
       case REPLAY_SIG_DROP_BANK_REF: {
@@ -978,6 +1358,41 @@ fd_rpc_base58_encode_128( char * b58, ulong * b58sz, const void *data, ulong bin
   return 1;
 }
 
+/* Inverse of fd_rpc_base58_encode_128, also adapted from libbase58.
+   Decodes the cstr b58 into bin, which must have room for 128 bytes.
+   Returns 1 on success, 0 if b58 is not base58 or decodes to more than
+   128 bytes. */
+static inline int
+fd_rpc_base58_decode_128( uchar * bin, ulong * binsz, char const * b58 ) {
+  ulong b58sz = strlen( b58 );
+  if( FD_UNLIKELY( b58sz>FD_RPC_BASE58_ENCODED_128_LEN ) ) return 0;
+
+  ulong zcount = 0UL;
+  while( zcount<b58sz && b58[ zcount ]=='1' ) zcount++;
+
+  /* Each base58 digit is less than a byte, so b58sz bytes suffice */
+  uchar buf[ FD_RPC_BASE58_ENCODED_128_LEN ] = { 0 };
+  for( ulong i=zcount; i<b58sz; i++ ) {
+    char const * digit = strchr( base58_chars, b58[ i ] );
+    if( FD_UNLIKELY( !digit ) ) return 0;
+    ulong carry = (ulong)(digit-base58_chars);
+    for( ulong j=b58sz; j>0UL; j-- ) {
+      carry += 58UL * buf[ j-1UL ];
+      buf[ j-1UL ] = (uchar)(carry & 0xffUL);
+      carry >>= 8;
+    }
+  }
+
+  ulong j;
+  for( j=0UL; j<b58sz && !buf[ j ]; j++ );
+
+  if( FD_UNLIKELY( zcount+b58sz-j>128UL ) ) return 0;
+  memset( bin, 0, zcount );
+  memcpy( bin+zcount, buf+j, b58sz-j );
+  *binsz = zcount+b58sz-j;
+  return 1;
+}
+
 static inline int
 fd_rpc_validate_config( fd_rpc_tile_t *             ctx,
                         cJSON const *               id,
@@ -1283,7 +1698,6 @@ X( fd_rpc_tile_t * ctx,                                \
   return (fd_http_server_response_t){ .status = 501 }; \
 }
 
-UNIMPLEMENTED(getBlock)
 UNIMPLEMENTED(getBlockCommitment)
 
 /* fd_rpc_encode_account_data encodes account data fields
@@ -1379,6 +1793,191 @@ fd_rpc_encode_account_data( fd_rpc_tile_t *             ctx,
   return 1;
 }
 
+struct fd_rpc_filter {
+  int   kind;             /* FD_RPC_FILTER_* */
+  ulong off;              /* memcmp offset, or the exact dataSize */
+  ulong bytes_sz;
+  uchar bytes[ 128UL ];
+};
+
+typedef struct fd_rpc_filter fd_rpc_filter_t;
+
+/* fd_rpc_parse_filters parses the filters field of an
+   RpcProgramAccountsConfig into out.  Returns 1 on success, or 0 and
+   an error response in res. */
+static int
+fd_rpc_parse_filters( fd_rpc_tile_t *             ctx,
+                      cJSON const *               id,
+                      cJSON const *               filters,
+                      fd_rpc_filter_t *           out,
+                      ulong *                     out_cnt,
+                      fd_http_server_response_t * res ) {
+  *out_cnt = 0UL;
+  if( FD_LIKELY( !filters || cJSON_IsNull( filters ) ) ) return 1;
+
+  if( FD_UNLIKELY( !cJSON_IsArray( filters ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected a sequence.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( filters ), id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( (ulong)cJSON_GetArraySize( filters )>FD_RPC_FILTER_MAX ) ) {
+    CSTR_JSON( id, id_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Too many filters provided; max %lu\"},\"id\":%s}\n", FD_RPC_FILTER_MAX, id_cstr );
+    return 0;
+  }
+
+  cJSON const * filter;
+  cJSON_ArrayForEach( filter, filters ) {
+    fd_rpc_filter_t * f = &out[ *out_cnt ];
+
+    cJSON const * data_size = cJSON_GetObjectItemCaseSensitive( filter, "dataSize" );
+    cJSON const * memcmp_   = cJSON_GetObjectItemCaseSensitive( filter, "memcmp"   );
+    if( cJSON_IsString( filter ) && !strcmp( filter->valuestring, "tokenAccountState" ) ) {
+      f->kind = FD_RPC_FILTER_TOKEN_ACCOUNT_STATE;
+    } else if( cJSON_IsObject( filter ) && fd_rpc_cjson_is_integer( data_size ) && data_size->valuedouble>=0.0 ) {
+      f->kind = FD_RPC_FILTER_DATA_SIZE;
+      f->off  = data_size->valueulong;
+    } else if( cJSON_IsObject( filter ) && cJSON_IsObject( memcmp_ ) ) {
+      cJSON const * offset   = cJSON_GetObjectItemCaseSensitive( memcmp_, "offset"   );
+      cJSON const * bytes    = cJSON_GetObjectItemCaseSensitive( memcmp_, "bytes"    );
+      cJSON const * encoding = cJSON_GetObjectItemCaseSensitive( memcmp_, "encoding" );
+      int is_base64 = cJSON_IsString( encoding ) && !strcmp( encoding->valuestring, "base64" );
+      if( FD_UNLIKELY( !fd_rpc_cjson_is_integer( offset ) || offset->valuedouble<0.0 || !cJSON_IsString( bytes ) ||
+                       (encoding && !cJSON_IsNull( encoding ) && !is_base64 && !(cJSON_IsString( encoding ) && !strcmp( encoding->valuestring, "base58" ))) ) ) {
+        goto invalid;
+      }
+
+      f->kind = FD_RPC_FILTER_MEMCMP;
+      f->off  = offset->valueulong;
+      ulong bytes_len = strlen( bytes->valuestring );
+      int   valid;
+      if( is_base64 ) {
+        valid = bytes_len<=FD_BASE64_ENC_SZ( 128UL );
+        long dec_sz = valid ? fd_base64_decode( f->bytes, bytes->valuestring, bytes_len ) : -1L;
+        valid = valid && dec_sz>=0L && dec_sz<=128L;
+        f->bytes_sz = (ulong)fd_long_max( dec_sz, 0L );
+      } else {
+        valid = fd_rpc_base58_decode_128( f->bytes, &f->bytes_sz, bytes->valuestring );
+      }
+      if( FD_UNLIKELY( !valid ) ) {
+        CSTR_JSON( id, id_cstr );
+        *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid param: memcmp bytes must be valid %s of at most 128 bytes\"},\"id\":%s}\n", is_base64 ? "base64" : "base58", id_cstr );
+        return 0;
+      }
+    } else {
+      goto invalid;
+    }
+    (*out_cnt)++;
+  }
+  return 1;
+
+invalid:;
+  CSTR_JSON( id, id_cstr );
+  *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid filter, expected one of `dataSize`, `memcmp`, `tokenAccountState`.\"},\"id\":%s}\n", id_cstr );
+  return 0;
+}
+
+static int
+fd_rpc_filters_match( fd_rpc_filter_t const * filters,
+                      ulong                   filter_cnt,
+                      uchar const *           data,
+                      ulong                   data_sz ) {
+  for( ulong i=0UL; i<filter_cnt; i++ ) {
+    fd_rpc_filter_t const * f = &filters[ i ];
+    switch( f->kind ) {
+      case FD_RPC_FILTER_DATA_SIZE: {
+        if( data_sz!=f->off ) return 0;
+        break;
+      }
+      case FD_RPC_FILTER_MEMCMP: {
+        if( f->off>data_sz || data_sz-f->off<f->bytes_sz || memcmp( data+f->off, f->bytes, f->bytes_sz ) ) return 0;
+        break;
+      }
+      case FD_RPC_FILTER_TOKEN_ACCOUNT_STATE: {
+        /* Agave only looks at the data here, with the more permissive
+           Token-2022 layout rules */
+        uchar keys[ FD_RPC_INDEX_KIND_CNT ][ 32 ];
+        if( !(fd_rpc_index_keys( fd_solana_spl_token_2022_id.uc, data, data_sz, keys ) & (1U<<FD_RPC_INDEX_KIND_TOKEN_MINT)) ) return 0;
+        break;
+      }
+      default: FD_LOG_ERR(( "unreachable" ));
+    }
+  }
+  return 1;
+}
+
+/* fd_rpc_index_check returns 1 if the account index can answer
+   queries, or 0 and an error response in res. */
+static int
+fd_rpc_index_check( fd_rpc_tile_t *             ctx,
+                    cJSON const *               id,
+                    fd_http_server_response_t * res ) {
+  char const * err;
+  switch( fd_rpc_index_status( ctx ) ) {
+    case FD_RPC_INDEX_STATUS_READY:    return 1;
+    case FD_RPC_INDEX_STATUS_DISABLED: err = "account index is disabled, see [tiles.rpc.account_index_max]"; break;
+    case FD_RPC_INDEX_STATUS_BUILDING: err = "account index is still being built";                          break;
+    default:                           err = "account index is full, increase [tiles.rpc.account_index_max]"; break;
+  }
+  CSTR_JSON( id, id_cstr );
+  *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: %s\"},\"id\":%s}\n", err, id_cstr );
+  return 0;
+}
+
+/* fd_rpc_index_query appends to the staging buffer a comma separated
+   list of {"pubkey":...,"account":...} objects for every account at
+   bank info that currently has key as its index key of the given kind,
+   is owned by program (any owner if NULL) and passes the filters.
+   Candidates found to be stale along the way are removed.  Returns 1
+   on success, or 0 and an error response (see
+   fd_rpc_encode_account_data) in err_response. */
+static int
+fd_rpc_index_query( fd_rpc_tile_t *             ctx,
+                    bank_info_t const *         info,
+                    int                         kind,
+                    uchar const                 key[ 32 ],
+                    uchar const *               program,
+                    fd_rpc_filter_t const *     filters,
+                    ulong                       filter_cnt,
+                    char const *                encoding_cstr,
+                    ulong                       slice_offset,
+                    ulong                       slice_length,
+                    char const *                id_cstr,
+                    fd_http_server_response_t * err_response ) {
+  int   is_root = ctx->finalized_idx!=ULONG_MAX && info==&ctx->banks[ ctx->finalized_idx ];
+  ulong out_cnt = 0UL;
+  for( ulong ele_idx=fd_rpc_index_head( ctx->index, kind, key ); ele_idx!=FD_RPC_INDEX_IDX_NULL; ) {
+    ulong next_idx = fd_rpc_index_next( ctx->index, ele_idx );
+    FD_MCNT_INC( RPC, ACCOUNT_INDEX_CANDIDATES, 1UL );
+
+    uchar const * pubkey = fd_rpc_index_pubkey( ctx->index, ele_idx );
+    ulong acct_lamports;
+    int   acct_executable;
+    uchar acct_owner[ 32UL ];
+    ulong acct_data_len;
+    fd_accdb_read_one_nocache( ctx->accdb, info->accdb_fork_id, pubkey,
+                               &acct_lamports, &acct_executable, acct_owner,
+                               ctx->accdb_data_buf, &acct_data_len );
+
+    if( FD_UNLIKELY( !acct_lamports || !fd_rpc_index_matches( kind, key, acct_owner, ctx->accdb_data_buf, acct_data_len ) ) ) {
+      if( FD_UNLIKELY( is_root && fd_rpc_index_stale( ctx, info, ele_idx, acct_lamports, acct_owner, acct_data_len ) ) ) {
+        fd_rpc_index_remove( ctx->index, ele_idx );
+        FD_MCNT_INC( RPC, ACCOUNT_INDEX_STALE_REMOVED, 1UL );
+      }
+    } else if( (!program || !memcmp( acct_owner, program, 32UL )) && fd_rpc_filters_match( filters, filter_cnt, ctx->accdb_data_buf, acct_data_len ) ) {
+      FD_BASE58_ENCODE_32_BYTES( pubkey, pubkey_b58 );
+      fd_http_server_printf( ctx->http, "%s{\"pubkey\":\"%s\",\"account\":", out_cnt ? "," : "", pubkey_b58 );
+      if( FD_UNLIKELY( !fd_rpc_encode_account_data( ctx, ctx->accdb_data_buf, acct_data_len, acct_owner, acct_lamports, acct_executable, encoding_cstr, slice_offset, slice_length, id_cstr, err_response ) ) ) {
+        return 0;
+      }
+      fd_http_server_printf( ctx->http, "}" );
+      out_cnt++;
+    }
+    ele_idx = next_idx;
+  }
+  return 1;
+}
+
 static fd_http_server_response_t
 getAccountInfo( fd_rpc_tile_t * ctx,
                 cJSON const *   id,
@@ -1494,71 +2093,493 @@ getBlockHeight( fd_rpc_tile_t * ctx,
   return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}\n", ctx->banks[ bank_idx ].block_height, id_cstr );
 }
 
-UNIMPLEMENTED(getBlockProduction) // TODO: Used by solana-exporter
-UNIMPLEMENTED(getBlocks)
-UNIMPLEMENTED(getBlocksWithLimit)
-UNIMPLEMENTED(getBlockTime)
+/* fd_rpc_txnstatus_min_conf returns the FD_RPC_TXNSTATUS_CONF_* level
+   requested by the commitment of config (finalized by default), which
+   must have been validated by fd_rpc_validate_config.  Methods reading
+   transaction history do not support processed, if !allow_processed
+   it returns FD_RPC_TXNSTATUS_CONF_NONE and an error response in res
+   for it. */
 
-static fd_http_server_response_t
-getClusterNodes( fd_rpc_tile_t * ctx,
-                 cJSON const *   id,
-                 cJSON const *   params ) {
-  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_CLUSTER_NODES, 1UL );
+static int
+fd_rpc_txnstatus_min_conf( fd_rpc_tile_t *             ctx,
+                           cJSON const *               id,
+                           cJSON const *               config,
+                           int                         allow_processed,
+                           fd_http_server_response_t * res ) {
+  cJSON const * commitment = cJSON_GetObjectItemCaseSensitive( config, "commitment" );
+  if( FD_UNLIKELY( !commitment || !cJSON_IsString( commitment ) ) ) return FD_RPC_TXNSTATUS_CONF_FINALIZED;
+  if( FD_LIKELY( !strcmp( commitment->valuestring, "confirmed" ) ) ) return FD_RPC_TXNSTATUS_CONF_CONFIRMED;
+  if( FD_UNLIKELY( !strcmp( commitment->valuestring, "processed" ) ) ) {
+    if( FD_LIKELY( allow_processed ) ) return FD_RPC_TXNSTATUS_CONF_PROCESSED;
+    CSTR_JSON( id, id_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Method does not support commitment below `confirmed`\"},\"id\":%s}\n", id_cstr );
+    return FD_RPC_TXNSTATUS_CONF_NONE;
+  }
+  return FD_RPC_TXNSTATUS_CONF_FINALIZED;
+}
 
-  fd_http_server_response_t response;
-  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 0, 0, &response ) ) ) return response;
+/* fd_rpc_validate_u64 returns 1 and the value of the unsigned integer
+   param in *out, or 0 and an error response in res.  param must not be
+   NULL. */
 
-  fd_http_server_printf( ctx->http, "{\"jsonrpc\":\"2.0\",\"result\":[" );
+static int
+fd_rpc_validate_u64( fd_rpc_tile_t *             ctx,
+                     cJSON const *               id,
+                     cJSON const *               param,
+                     ulong *                     out,
+                     fd_http_server_response_t * res ) {
+  if( FD_UNLIKELY( cJSON_IsBool( param ) || (cJSON_IsNumber( param ) && !fd_rpc_cjson_is_integer( param )) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON( param, param_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s `%s`, expected u64.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( param ), param_cstr, id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( cJSON_IsNumber( param ) && param->valueint<0 ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON( param, param_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid value: %s `%s`, expected u64.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( param ), param_cstr, id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( cJSON_IsString( param ) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON_UNQUOTED( param, param_esc );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s \\\"%s\\\", expected u64.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( param ), param_esc, id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( !fd_rpc_cjson_is_integer( param ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected u64.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( param ), id_cstr );
+    return 0;
+  }
+  *out = param->valueulong;
+  return 1;
+}
 
-  for( fd_rpc_cluster_node_dlist_iter_t iter = fd_rpc_cluster_node_dlist_iter_rev_init( ctx->cluster_nodes_dlist, ctx->cluster_nodes );
-       !fd_rpc_cluster_node_dlist_iter_done( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes );
-       iter = fd_rpc_cluster_node_dlist_iter_rev_next( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes ) ) {
-    fd_rpc_cluster_node_t * ele = fd_rpc_cluster_node_dlist_iter_ele( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes );
-    FD_BASE58_ENCODE_32_BYTES( ele->identity.uc, identity_cstr );
-    int is_last = fd_rpc_cluster_node_dlist_iter_done( fd_rpc_cluster_node_dlist_iter_rev_next( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes ), ctx->cluster_nodes_dlist, ctx->cluster_nodes );
+/* fd_rpc_block_query returns the archive index of slot, or
+   FD_RPC_BLOCKS_IDX_NULL and an error response in res, which tells
+   apart blocks that are not rooted yet, blocks evicted from the archive
+   and skipped slots, as Agave does. */
 
-    fd_http_server_printf( ctx->http, "{\"featureSet\":%u,", ele->ci->version.feature_set );
+static ulong
+fd_rpc_block_query( fd_rpc_tile_t *             ctx,
+                    cJSON const *               id,
+                    ulong                       slot,
+                    fd_http_server_response_t * res ) {
+  CSTR_JSON( id, id_cstr );
+  if( FD_UNLIKELY( !ctx->blocks ) ) {
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: block archive is disabled, see [tiles.rpc.block_archive_max]\"},\"id\":%s}\n", id_cstr );
+    return FD_RPC_BLOCKS_IDX_NULL;
+  }
 
-    for( ulong i=0UL; i<FD_GOSSIP_CONTACT_INFO_SOCKET_CNT; i++ ) {
-      char const * name;
-      switch( i ) {
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_GOSSIP:            name = "gossip"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_SERVE_REPAIR_QUIC: name = NULL; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_RPC:               name = "rpc"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_RPC_PUBSUB:        name = "pubsub"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_SERVE_REPAIR:      name = "serveRepair"; break;
-        /* Even though Agave does not support "tpu" and "tpuForwards"
-           (hardcoded null), frankendacer/firedancer still support
-           UDP-TPU. */
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU:               name = "tpu"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_FORWARDS:      name = "tpuForwards"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_FORWARDS_QUIC: name = "tpuForwardsQuic"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_QUIC:          name = "tpuQuic"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_VOTE:          name = "tpuVote"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TVU:               name = "tvu"; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TVU_QUIC:          name = NULL; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_VOTE_QUIC:     name = NULL; break;
-        case FD_GOSSIP_CONTACT_INFO_SOCKET_ALPENGLOW:         name = NULL; break;
-        default: FD_LOG_ERR(( "unreachable "));
-      }
-      if( FD_UNLIKELY( !name ) ) continue;
+  ulong first = fd_rpc_blocks_first( ctx->blocks );
+  ulong last  = fd_rpc_blocks_last ( ctx->blocks );
+  if( FD_UNLIKELY( first==ULONG_MAX || slot>last ) ) {
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":\"Block not available for slot %lu\"},\"id\":%s}\n", FD_RPC_ERROR_BLOCK_NOT_AVAILABLE, slot, id_cstr );
+    return FD_RPC_BLOCKS_IDX_NULL;
+  }
+  if( FD_UNLIKELY( slot<first ) ) {
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":\"Block %lu cleaned up, does not exist on node. First available block: %lu\"},\"id\":%s}\n", FD_RPC_ERROR_BLOCK_CLEANED_UP, slot, first, id_cstr );
+    return FD_RPC_BLOCKS_IDX_NULL;
+  }
 
-      uint ip4 = ele->ci->sockets[ i ].is_ipv6 ? 0U : ele->ci->sockets[ i ].ip4;
-      if( FD_LIKELY( !!ip4 || !!ele->ci->sockets[ i ].port ) ) fd_http_server_printf( ctx->http, "\"%s\":\"" FD_IP4_ADDR_FMT ":%hu\",", name, FD_IP4_ADDR_FMT_ARGS( ip4 ), fd_ushort_bswap( ele->ci->sockets[ i ].port ) );
-      else                                                     fd_http_server_printf( ctx->http, "\"%s\":null,", name );
-    }
-    fd_http_server_printf( ctx->http, "\"pubkey\":\"%s\",", identity_cstr );
-    fd_http_server_printf( ctx->http, "\"shredVersion\":%u,", ele->ci->shred_version );
+  ulong idx = fd_rpc_blocks_query( ctx->blocks, slot );
+  if( FD_UNLIKELY( idx==FD_RPC_BLOCKS_IDX_NULL ) ) {
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":\"Slot %lu was skipped, or missing due to ledger jump to recent snapshot\"},\"id\":%s}\n", FD_RPC_ERROR_SLOT_SKIPPED, slot, id_cstr );
+  }
+  return idx;
+}
 
-    char version[ 64UL ];
-    FD_TEST( fd_gossip_version_cstr( ele->ci->version.major, ele->ci->version.minor, ele->ci->version.patch, version, sizeof( version ) ) );
-    fd_http_server_printf( ctx->http, "\"version\":\"%s\",", version );
+#define FD_RPC_BLOCK_DETAILS_FULL       (0)
+#define FD_RPC_BLOCK_DETAILS_SIGNATURES (1)
+#define FD_RPC_BLOCK_DETAILS_NONE       (2)
 
-    char const * client_id;
-    switch( ele->ci->version.client ) {
-      case FD_GOSSIP_CONTACT_INFO_CLIENT_SOLANA_LABS:   client_id = "SolanaLabs";     break;
-      case FD_GOSSIP_CONTACT_INFO_CLIENT_JITO_LABS:     client_id = "JitoLabs";       break;
-      case FD_GOSSIP_CONTACT_INFO_CLIENT_FRANKENDANCER: client_id = "Frankendancer";  break;
+static void
+fd_rpc_printf_txn_meta( fd_rpc_tile_t *                ctx,
+                        fd_rpc_txnstatus_err_t const * err );
+
+/* fd_rpc_printf_block_txn_meta appends the metadata of the transaction
+   with first signature sig in block slot, or null if the transaction
+   status store does not have it (disabled or evicted). */
+
+static void
+fd_rpc_printf_block_txn_meta( fd_rpc_tile_t * ctx,
+                              ulong           slot,
+                              uchar const *   sig ) {
+  if( FD_LIKELY( ctx->txnstatus ) ) {
+    for( ulong i=fd_rpc_txnstatus_sig_query( ctx->txnstatus, sig ); i!=FD_RPC_TXNSTATUS_IDX_NULL; i=fd_rpc_txnstatus_sig_next( ctx->txnstatus, i ) ) {
+      if( FD_LIKELY( fd_rpc_txnstatus_slot( ctx->txnstatus, i )==slot ) ) {
+        fd_rpc_printf_txn_meta( ctx, fd_rpc_txnstatus_err( ctx->txnstatus, i ) );
+        return;
+      }
+    }
+  }
+  fd_http_server_printf( ctx->http, "null" );
+}
+
+/* fd_rpc_printf_block_txns writes the transactions (or signatures) of
+   archived block idx to the staging buffer.  Returns 0 on success, or
+   the Agave error code of the failure, with the staging buffer
+   unstaged. */
+
+static int
+fd_rpc_printf_block_txns( fd_rpc_tile_t * ctx,
+                          ulong           idx,
+                          int             details,
+                          int             has_max_version ) {
+  fd_rpc_block_t const * block = fd_rpc_blocks_block( ctx->blocks, idx );
+  if( FD_UNLIKELY( block->txn_cnt==UINT_MAX || (block->txn_cnt && !fd_rpc_blocks_iter_init( ctx->blocks, idx )) ) ) {
+    fd_http_server_unstage( ctx->http );
+    return FD_RPC_ERROR_BLOCK_NOT_AVAILABLE;
+  }
+
+  uchar txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+  fd_txn_t const * txn = (fd_txn_t const *)txn_mem;
+  char payload_b64[ FD_BASE64_ENC_SZ( FD_TXN_MTU ) ];
+
+  fd_http_server_printf( ctx->http, details==FD_RPC_BLOCK_DETAILS_FULL ? ",\"transactions\":[" : ",\"signatures\":[" );
+  for( ulong i=0UL; i<block->txn_cnt; i++ ) {
+    ulong         payload_sz;
+    uchar const * payload = fd_rpc_blocks_iter_next( ctx->blocks, &payload_sz );
+    if( FD_UNLIKELY( !payload || !fd_txn_parse( payload, payload_sz, txn_mem, NULL ) ) ) {
+      fd_http_server_unstage( ctx->http );
+      return FD_RPC_ERROR_BLOCK_NOT_AVAILABLE;
+    }
+
+    if( FD_UNLIKELY( details==FD_RPC_BLOCK_DETAILS_SIGNATURES ) ) {
+      FD_BASE58_ENCODE_64_BYTES( payload+txn->signature_off, signature_b58 );
+      fd_http_server_printf( ctx->http, "%s\"%s\"", i ? "," : "", signature_b58 );
+      continue;
+    }
+
+    int v0 = txn->transaction_version==FD_TXN_V0;
+    if( FD_UNLIKELY( v0 && !has_max_version ) ) {
+      fd_http_server_unstage( ctx->http );
+      return FD_RPC_ERROR_UNSUPPORTED_TRANSACTION_VERSION;
+    }
+    fd_http_server_printf( ctx->http, "%s{\"transaction\":[\"", i ? "," : "" );
+    fd_http_server_memcpy( ctx->http, (uchar const *)payload_b64, fd_base64_encode( payload_b64, payload, payload_sz ) );
+    fd_http_server_printf( ctx->http, "\",\"base64\"],\"meta\":" );
+    fd_rpc_printf_block_txn_meta( ctx, block->slot, payload+txn->signature_off );
+    if( FD_LIKELY( has_max_version ) ) fd_http_server_printf( ctx->http, ",\"version\":%s", v0 ? "0" : "\"legacy\"" );
+    fd_http_server_printf( ctx->http, "}" );
+  }
+  fd_http_server_printf( ctx->http, "]" );
+  return 0;
+}
+
+static fd_http_server_response_t
+getBlock( fd_rpc_tile_t * ctx,
+          cJSON const *   id,
+          cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_BLOCK, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 2, &response ) ) ) return response;
+
+  ulong slot;
+  if( FD_UNLIKELY( !fd_rpc_validate_u64( ctx, id, cJSON_GetArrayItem( params, 0 ), &slot, &response ) ) ) return response;
+
+  /* Only rooted blocks are archived, so confirmed is accepted but
+     served like finalized.  As for getTransaction, only base64 is
+     implemented and there is no transaction metadata or rewards. */
+  ulong bank_idx = ULONG_MAX;
+  cJSON const * config = cJSON_GetArrayItem( params, 1 );
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcBlockConfig",
+                                             1, /* has_commitment */
+                                             0, /* has_encoding */
+                                             0, /* has_data_slice */
+                                             0, /* has_min_context_slot */
+                                             &bank_idx,
+                                             NULL,
+                                             NULL,
+                                             NULL,
+                                             &response );
+  if( FD_UNLIKELY( !config_valid ) ) return response;
+
+  int min_conf = fd_rpc_txnstatus_min_conf( ctx, id, config, 0, &response );
+  if( FD_UNLIKELY( min_conf==FD_RPC_TXNSTATUS_CONF_NONE ) ) return response;
+
+  cJSON const * encoding      = cJSON_GetObjectItemCaseSensitive( config, "encoding" );
+  char const *  encoding_cstr = encoding && cJSON_IsString( encoding ) ? encoding->valuestring : "json";
+  if( FD_UNLIKELY( encoding && !cJSON_IsNull( encoding ) && !cJSON_IsString( encoding ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected a string.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( encoding ), id_cstr );
+  }
+  if( FD_UNLIKELY( strcmp( encoding_cstr, "binary" ) && strcmp( encoding_cstr, "base64" ) && strcmp( encoding_cstr, "base58" ) &&
+                   strcmp( encoding_cstr, "json"   ) && strcmp( encoding_cstr, "jsonParsed" ) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON_UNQUOTED( encoding, encoding_esc );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: unknown variant `%s`, expected one of `binary`, `base64`, `base58`, `json`, `jsonParsed`.\"},\"id\":%s}\n", encoding_esc, id_cstr );
+  }
+
+  cJSON const * _details      = cJSON_GetObjectItemCaseSensitive( config, "transactionDetails" );
+  char const *  details_cstr  = _details && cJSON_IsString( _details ) ? _details->valuestring : "full";
+  if( FD_UNLIKELY( _details && !cJSON_IsNull( _details ) && !cJSON_IsString( _details ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected a string.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( _details ), id_cstr );
+  }
+  int details;
+  if(      FD_LIKELY( !strcmp( details_cstr, "full"       ) ) ) details = FD_RPC_BLOCK_DETAILS_FULL;
+  else if( FD_LIKELY( !strcmp( details_cstr, "signatures" ) ) ) details = FD_RPC_BLOCK_DETAILS_SIGNATURES;
+  else if( FD_LIKELY( !strcmp( details_cstr, "none"       ) ) ) details = FD_RPC_BLOCK_DETAILS_NONE;
+  else if( FD_LIKELY( !strcmp( details_cstr, "accounts"   ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: accounts transaction details are unsupported\"},\"id\":%s}\n", id_cstr );
+  } else {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON_UNQUOTED( _details, details_esc );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: unknown variant `%s`, expected one of `full`, `accounts`, `signatures`, `none`.\"},\"id\":%s}\n", details_esc, id_cstr );
+  }
+  if( FD_UNLIKELY( details==FD_RPC_BLOCK_DETAILS_FULL && strcmp( encoding_cstr, "base64" ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: %s encoding is unsupported, use base64\"},\"id\":%s}\n", encoding_cstr, id_cstr );
+  }
+
+  int has_max_version = 0;
+  cJSON const * _max_version = cJSON_GetObjectItemCaseSensitive( config, "maxSupportedTransactionVersion" );
+  if( FD_UNLIKELY( _max_version && !cJSON_IsNull( _max_version ) ) ) {
+    if( FD_UNLIKELY( !fd_rpc_cjson_is_integer( _max_version ) || _max_version->valueint<0 || _max_version->valueulong>UCHAR_MAX ) ) {
+      CSTR_JSON( id, id_cstr );
+      return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected u8.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( _max_version ), id_cstr );
+    }
+    has_max_version = 1;
+  }
+
+  ulong idx = fd_rpc_block_query( ctx, id, slot, &response );
+  if( FD_UNLIKELY( idx==FD_RPC_BLOCKS_IDX_NULL ) ) return response;
+  fd_rpc_block_t const * block = fd_rpc_blocks_block( ctx->blocks, idx );
+
+  /* The result part of the response does not depend on the request id,
+     so it is cached for the next request of the same block and
+     options. */
+  CSTR_JSON( id, id_cstr );
+  fd_http_server_printf( ctx->http, "{\"jsonrpc\":\"2.0\",\"result\":" );
+  ulong result_off = ctx->http->stage_len;
+
+  ulong         variant = (ulong)details | ((ulong)has_max_version<<2);
+  ulong         cached_sz;
+  uchar const * cached  = fd_rpc_blocks_cache_query( ctx->blocks, slot, variant, &cached_sz );
+  if( FD_LIKELY( cached ) ) {
+    fd_http_server_memcpy( ctx->http, cached, cached_sz );
+  } else {
+    FD_BASE58_ENCODE_32_BYTES( block->prev_blockhash, prev_blockhash_b58 );
+    FD_BASE58_ENCODE_32_BYTES( block->blockhash,      blockhash_b58      );
+    fd_http_server_printf( ctx->http, "{\"previousBlockhash\":\"%s\",\"blockhash\":\"%s\",\"parentSlot\":%lu",
+                           prev_blockhash_b58, blockhash_b58, block->parent_slot );
+
+    if( FD_LIKELY( details!=FD_RPC_BLOCK_DETAILS_NONE ) ) {
+      int err = fd_rpc_printf_block_txns( ctx, idx, details, has_max_version );
+      if( FD_UNLIKELY( err==FD_RPC_ERROR_UNSUPPORTED_TRANSACTION_VERSION ) ) {
+        return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":\"Transaction version (0) is not supported by the requesting client. Please try the request again with the following configuration parameter: \\\"maxSupportedTransactionVersion\\\": 0\"},\"id\":%s}\n", FD_RPC_ERROR_UNSUPPORTED_TRANSACTION_VERSION, id_cstr );
+      }
+      if( FD_UNLIKELY( err ) ) {
+        return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":\"Block not available for slot %lu\"},\"id\":%s}\n", FD_RPC_ERROR_BLOCK_NOT_AVAILABLE, slot, id_cstr );
+      }
+    }
+
+    if( FD_LIKELY( block->block_time!=FD_RPC_BLOCKS_TIME_NULL ) ) fd_http_server_printf( ctx->http, ",\"blockTime\":%ld", block->block_time );
+    else                                                           fd_http_server_printf( ctx->http, ",\"blockTime\":null" );
+    fd_http_server_printf( ctx->http, ",\"blockHeight\":%lu}", block->block_height );
+
+    if( FD_LIKELY( !ctx->http->stage_err ) ) {
+      uchar const * staged = ctx->http->oring+(ctx->http->stage_off%ctx->http->oring_sz);
+      fd_rpc_blocks_cache_insert( ctx->blocks, slot, variant, staged+result_off, ctx->http->stage_len-result_off );
+    }
+  }
+
+  fd_http_server_printf( ctx->http, ",\"id\":%s}\n", id_cstr );
+  return STAGE_JSON( ctx );
+}
+
+UNIMPLEMENTED(getBlockProduction) // TODO: Used by solana-exporter
+
+/* FD_RPC_GET_BLOCKS_RANGE_MAX is Agave's limit on the number of slots
+   spanned by getBlocks and getBlocksWithLimit. */
+
+#define FD_RPC_GET_BLOCKS_RANGE_MAX (500000UL)
+
+/* fd_rpc_printf_blocks writes the result of getBlocks, the archived
+   slots in [start,end] up to limit of them, to the staging buffer. */
+
+static fd_http_server_response_t
+fd_rpc_printf_blocks( fd_rpc_tile_t * ctx,
+                      cJSON const *   id,
+                      ulong           start,
+                      ulong           end,
+                      ulong           limit ) {
+  CSTR_JSON( id, id_cstr );
+  fd_http_server_printf( ctx->http, "{\"jsonrpc\":\"2.0\",\"result\":[" );
+  ulong cnt = 0UL;
+  for( ulong idx=fd_rpc_blocks_lower_bound( ctx->blocks, start ); idx!=FD_RPC_BLOCKS_IDX_NULL && cnt<limit; idx=fd_rpc_blocks_next( ctx->blocks, idx ) ) {
+    ulong slot = fd_rpc_blocks_block( ctx->blocks, idx )->slot;
+    if( FD_UNLIKELY( slot>end ) ) break;
+    fd_http_server_printf( ctx->http, "%s%lu", cnt ? "," : "", slot );
+    cnt++;
+  }
+  fd_http_server_printf( ctx->http, "],\"id\":%s}\n", id_cstr );
+  return STAGE_JSON( ctx );
+}
+
+static int
+fd_rpc_blocks_check( fd_rpc_tile_t *             ctx,
+                     cJSON const *               id,
+                     cJSON const *               config,
+                     fd_http_server_response_t * res ) {
+  ulong bank_idx = ULONG_MAX;
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcContextConfig",
+                                             1, /* has_commitment */
+                                             0, /* has_encoding */
+                                             0, /* has_data_slice */
+                                             1, /* has_min_context_slot */
+                                             &bank_idx,
+                                             NULL,
+                                             NULL,
+                                             NULL,
+                                             res );
+  if( FD_UNLIKELY( !config_valid ) ) return 0;
+  if( FD_UNLIKELY( fd_rpc_txnstatus_min_conf( ctx, id, config, 0, res )==FD_RPC_TXNSTATUS_CONF_NONE ) ) return 0;
+
+  if( FD_UNLIKELY( !ctx->blocks ) ) {
+    CSTR_JSON( id, id_cstr );
+    *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: block archive is disabled, see [tiles.rpc.block_archive_max]\"},\"id\":%s}\n", id_cstr );
+    return 0;
+  }
+  return 1;
+}
+
+static fd_http_server_response_t
+getBlocks( fd_rpc_tile_t * ctx,
+           cJSON const *   id,
+           cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_BLOCKS, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 3, &response ) ) ) return response;
+
+  ulong start;
+  if( FD_UNLIKELY( !fd_rpc_validate_u64( ctx, id, cJSON_GetArrayItem( params, 0 ), &start, &response ) ) ) return response;
+
+  /* The end slot is optional, and the config may take its place */
+  ulong         end    = fd_ulong_sat_add( start, FD_RPC_GET_BLOCKS_RANGE_MAX );
+  cJSON const * _end   = cJSON_GetArrayItem( params, 1 );
+  cJSON const * config = cJSON_GetArrayItem( params, 2 );
+  if( FD_UNLIKELY( cJSON_IsObject( _end ) && !config ) ) {
+    config = _end;
+    _end   = NULL;
+  }
+  if( FD_LIKELY( _end && !cJSON_IsNull( _end ) ) ) {
+    if( FD_UNLIKELY( !fd_rpc_validate_u64( ctx, id, _end, &end, &response ) ) ) return response;
+  }
+  if( FD_UNLIKELY( !fd_rpc_blocks_check( ctx, id, config, &response ) ) ) return response;
+
+  end = fd_ulong_min( end, fd_rpc_blocks_last( ctx->blocks ) );
+  if( FD_UNLIKELY( end>start && end-start>FD_RPC_GET_BLOCKS_RANGE_MAX ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Slot range too large; max %lu\"},\"id\":%s}\n", FD_RPC_GET_BLOCKS_RANGE_MAX, id_cstr );
+  }
+
+  return fd_rpc_printf_blocks( ctx, id, start, end, ULONG_MAX );
+}
+
+static fd_http_server_response_t
+getBlocksWithLimit( fd_rpc_tile_t * ctx,
+                    cJSON const *   id,
+                    cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_BLOCKS_WITH_LIMIT, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 2, 3, &response ) ) ) return response;
+
+  ulong start;
+  ulong limit;
+  if( FD_UNLIKELY( !fd_rpc_validate_u64( ctx, id, cJSON_GetArrayItem( params, 0 ), &start, &response ) ) ) return response;
+  if( FD_UNLIKELY( !fd_rpc_validate_u64( ctx, id, cJSON_GetArrayItem( params, 1 ), &limit, &response ) ) ) return response;
+  if( FD_UNLIKELY( !fd_rpc_blocks_check( ctx, id, cJSON_GetArrayItem( params, 2 ), &response ) ) ) return response;
+
+  if( FD_UNLIKELY( limit>FD_RPC_GET_BLOCKS_RANGE_MAX ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Limit too large; max %lu\"},\"id\":%s}\n", FD_RPC_GET_BLOCKS_RANGE_MAX, id_cstr );
+  }
+
+  return fd_rpc_printf_blocks( ctx, id, start, ULONG_MAX, limit );
+}
+
+static fd_http_server_response_t
+getBlockTime( fd_rpc_tile_t * ctx,
+              cJSON const *   id,
+              cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_BLOCK_TIME, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 1, &response ) ) ) return response;
+
+  ulong slot;
+  if( FD_UNLIKELY( !fd_rpc_validate_u64( ctx, id, cJSON_GetArrayItem( params, 0 ), &slot, &response ) ) ) return response;
+
+  ulong idx = fd_rpc_block_query( ctx, id, slot, &response );
+  if( FD_UNLIKELY( idx==FD_RPC_BLOCKS_IDX_NULL ) ) return response;
+
+  long block_time = fd_rpc_blocks_block( ctx->blocks, idx )->block_time;
+  CSTR_JSON( id, id_cstr );
+  if( FD_UNLIKELY( block_time==FD_RPC_BLOCKS_TIME_NULL ) ) return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"result\":null,\"id\":%s}\n", id_cstr );
+  return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"result\":%ld,\"id\":%s}\n", block_time, id_cstr );
+}
+
+static fd_http_server_response_t
+getClusterNodes( fd_rpc_tile_t * ctx,
+                 cJSON const *   id,
+                 cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_CLUSTER_NODES, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 0, 0, &response ) ) ) return response;
+
+  fd_http_server_printf( ctx->http, "{\"jsonrpc\":\"2.0\",\"result\":[" );
+
+  for( fd_rpc_cluster_node_dlist_iter_t iter = fd_rpc_cluster_node_dlist_iter_rev_init( ctx->cluster_nodes_dlist, ctx->cluster_nodes );
+       !fd_rpc_cluster_node_dlist_iter_done( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes );
+       iter = fd_rpc_cluster_node_dlist_iter_rev_next( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes ) ) {
+    fd_rpc_cluster_node_t * ele = fd_rpc_cluster_node_dlist_iter_ele( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes );
+    FD_BASE58_ENCODE_32_BYTES( ele->identity.uc, identity_cstr );
+    int is_last = fd_rpc_cluster_node_dlist_iter_done( fd_rpc_cluster_node_dlist_iter_rev_next( iter, ctx->cluster_nodes_dlist, ctx->cluster_nodes ), ctx->cluster_nodes_dlist, ctx->cluster_nodes );
+
+    fd_http_server_printf( ctx->http, "{\"featureSet\":%u,", ele->ci->version.feature_set );
+
+    for( ulong i=0UL; i<FD_GOSSIP_CONTACT_INFO_SOCKET_CNT; i++ ) {
+      char const * name;
+      switch( i ) {
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_GOSSIP:            name = "gossip"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_SERVE_REPAIR_QUIC: name = NULL; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_RPC:               name = "rpc"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_RPC_PUBSUB:        name = "pubsub"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_SERVE_REPAIR:      name = "serveRepair"; break;
+        /* Even though Agave does not support "tpu" and "tpuForwards"
+           (hardcoded null), frankendacer/firedancer still support
+           UDP-TPU. */
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU:               name = "tpu"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_FORWARDS:      name = "tpuForwards"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_FORWARDS_QUIC: name = "tpuForwardsQuic"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_QUIC:          name = "tpuQuic"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_VOTE:          name = "tpuVote"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TVU:               name = "tvu"; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TVU_QUIC:          name = NULL; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_TPU_VOTE_QUIC:     name = NULL; break;
+        case FD_GOSSIP_CONTACT_INFO_SOCKET_ALPENGLOW:         name = NULL; break;
+        default: FD_LOG_ERR(( "unreachable "));
+      }
+      if( FD_UNLIKELY( !name ) ) continue;
+
+      uint ip4 = ele->ci->sockets[ i ].is_ipv6 ? 0U : ele->ci->sockets[ i ].ip4;
+      if( FD_LIKELY( !!ip4 || !!ele->ci->sockets[ i ].port ) ) fd_http_server_printf( ctx->http, "\"%s\":\"" FD_IP4_ADDR_FMT ":%hu\",", name, FD_IP4_ADDR_FMT_ARGS( ip4 ), fd_ushort_bswap( ele->ci->sockets[ i ].port ) );
+      else                                                     fd_http_server_printf( ctx->http, "\"%s\":null,", name );
+    }
+    fd_http_server_printf( ctx->http, "\"pubkey\":\"%s\",", identity_cstr );
+    fd_http_server_printf( ctx->http, "\"shredVersion\":%u,", ele->ci->shred_version );
+
+    char version[ 64UL ];
+    FD_TEST( fd_gossip_version_cstr( ele->ci->version.major, ele->ci->version.minor, ele->ci->version.patch, version, sizeof( version ) ) );
+    fd_http_server_printf( ctx->http, "\"version\":\"%s\",", version );
+
+    char const * client_id;
+    switch( ele->ci->version.client ) {
+      case FD_GOSSIP_CONTACT_INFO_CLIENT_SOLANA_LABS:   client_id = "SolanaLabs";     break;
+      case FD_GOSSIP_CONTACT_INFO_CLIENT_JITO_LABS:     client_id = "JitoLabs";       break;
+      case FD_GOSSIP_CONTACT_INFO_CLIENT_FRANKENDANCER: client_id = "Frankendancer";  break;
       case FD_GOSSIP_CONTACT_INFO_CLIENT_AGAVE:         client_id = "Agave";          break;
       case FD_GOSSIP_CONTACT_INFO_CLIENT_AGAVE_PALADIN: client_id = "AgavePaladin";   break;
       case FD_GOSSIP_CONTACT_INFO_CLIENT_FIREDANCER:    client_id = "Firedancer";     break;
@@ -1932,11 +2953,429 @@ getMultipleAccounts( fd_rpc_tile_t * ctx,
   return STAGE_JSON( ctx );
 }
 
-UNIMPLEMENTED(getProgramAccounts)
+static fd_http_server_response_t
+getProgramAccounts( fd_rpc_tile_t * ctx,
+                    cJSON const *   id,
+                    cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_PROGRAM_ACCOUNTS, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 2, &response ) ) ) return response;
+
+  fd_pubkey_t program;
+  if( FD_UNLIKELY( !fd_rpc_validate_address( ctx, id, cJSON_GetArrayItem( params, 0 ), &program, &response ) ) ) return response;
+
+  ulong bank_idx = ULONG_MAX;
+  char const * encoding_cstr = NULL;
+  ulong slice_length = ULONG_MAX;
+  ulong slice_offset = 0;
+  cJSON const * config = cJSON_GetArrayItem( params, 1 );
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcProgramAccountsConfig",
+                                             1, 1, 1, 1,
+                                             &bank_idx, &encoding_cstr,
+                                             &slice_length, &slice_offset,
+                                             &response );
+  if( FD_UNLIKELY( !config_valid ) ) return response;
+
+  fd_rpc_filter_t filters[ FD_RPC_FILTER_MAX ];
+  ulong           filter_cnt;
+  if( FD_UNLIKELY( !fd_rpc_parse_filters( ctx, id, cJSON_GetObjectItemCaseSensitive( config, "filters" ), filters, &filter_cnt, &response ) ) ) return response;
+  int with_context = cJSON_IsTrue( cJSON_GetObjectItemCaseSensitive( config, "withContext" ) );
+
+  if( FD_UNLIKELY( !fd_rpc_index_check( ctx, id, &response ) ) ) return response;
+
+  bank_info_t * info = &ctx->banks[ bank_idx ];
+
+  CSTR_JSON( id, id_cstr );
+  if( FD_UNLIKELY( with_context ) ) {
+    fd_http_server_printf( ctx->http,
+        "{\"jsonrpc\":\"2.0\",\"id\":%s,\"result\":{\"context\":{\"apiVersion\":\"%s\",\"slot\":%lu},\"value\":[",
+        id_cstr, FD_RPC_AGAVE_API_VERSION, info->slot );
+  } else {
+    fd_http_server_printf( ctx->http, "{\"jsonrpc\":\"2.0\",\"id\":%s,\"result\":[", id_cstr );
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_index_query( ctx, info, FD_RPC_INDEX_KIND_PROGRAM, program.uc, NULL, filters, filter_cnt,
+                                        encoding_cstr, slice_offset, slice_length, id_cstr, &response ) ) ) {
+    return response;
+  }
+
+  fd_http_server_printf( ctx->http, with_context ? "]}}\n" : "]}\n" );
+  return STAGE_JSON( ctx );
+}
 UNIMPLEMENTED(getRecentPerformanceSamples)
 UNIMPLEMENTED(getRecentPrioritizationFees)
-UNIMPLEMENTED(getSignaturesForAddress)
-UNIMPLEMENTED(getSignatureStatuses)
+/* Agave TransactionError and InstructionError variant names, indexed
+   by -FD_RUNTIME_TXN_ERR_*-1 and -FD_EXECUTOR_INSTR_ERR_*-1. */
+
+static char const * const fd_rpc_txn_err_names[] = {
+  "AccountInUse", "AccountLoadedTwice", "AccountNotFound", "ProgramAccountNotFound",
+  "InsufficientFundsForFee", "InvalidAccountForFee", "AlreadyProcessed", "BlockhashNotFound",
+  "InstructionError", "CallChainTooDeep", "MissingSignatureForFee", "InvalidAccountIndex",
+  "SignatureFailure", "InvalidProgramForExecution", "SanitizeFailure", "ClusterMaintenance",
+  "AccountBorrowOutstanding", "WouldExceedMaxBlockCostLimit", "UnsupportedVersion", "InvalidWritableAccount",
+  "WouldExceedMaxAccountCostLimit", "WouldExceedAccountDataBlockLimit", "TooManyAccountLocks", "AddressLookupTableNotFound",
+  "InvalidAddressLookupTableOwner", "InvalidAddressLookupTableData", "InvalidAddressLookupTableIndex", "InvalidRentPayingAccount",
+  "WouldExceedMaxVoteCostLimit", "WouldExceedAccountDataTotalLimit", "DuplicateInstruction", "InsufficientFundsForRent",
+  "MaxLoadedAccountsDataSizeExceeded", "InvalidLoadedAccountsDataSizeLimit", "ResanitizationNeeded", "ProgramExecutionTemporarilyRestricted",
+  "UnbalancedTransaction", "ProgramCacheHitMaxLimit", "CommitCancelled", "BundlePeer"
+};
+
+static char const * const fd_rpc_instr_err_names[] = {
+  "GenericError", "InvalidArgument", "InvalidInstructionData", "InvalidAccountData",
+  "AccountDataTooSmall", "InsufficientFunds", "IncorrectProgramId", "MissingRequiredSignature",
+  "AccountAlreadyInitialized", "UninitializedAccount", "UnbalancedInstruction", "ModifiedProgramId",
+  "ExternalAccountLamportSpend", "ExternalAccountDataModified", "ReadonlyLamportChange", "ReadonlyDataModified",
+  "DuplicateAccountIndex", "ExecutableModified", "RentEpochModified", "NotEnoughAccountKeys",
+  "AccountDataSizeChanged", "AccountNotExecutable", "AccountBorrowFailed", "AccountBorrowOutstanding",
+  "DuplicateAccountOutOfSync", "Custom", "InvalidError", "ExecutableDataModified",
+  "ExecutableLamportChange", "ExecutableAccountNotRentExempt", "UnsupportedProgramId", "CallDepth",
+  "MissingAccount", "ReentrancyNotAllowed", "MaxSeedLengthExceeded", "InvalidSeeds",
+  "InvalidRealloc", "ComputationalBudgetExceeded", "PrivilegeEscalation", "ProgramEnvironmentSetupFailure",
+  "ProgramFailedToComplete", "ProgramFailedToCompile", "Immutable", "IncorrectAuthority",
+  "BorshIoError", "AccountNotRentExempt", "InvalidAccountOwner", "ArithmeticOverflow",
+  "UnsupportedSysvar", "IllegalOwner", "MaxAccountsDataAllocationsExceeded", "MaxAccountsExceeded",
+  "MaxInstructionTraceLengthExceeded", "BuiltinProgramsMustConsumeComputeUnits"
+};
+
+/* fd_rpc_printf_txn_err appends the JSON representation of a stored
+   transaction error to the staging buffer, as Agave serializes
+   TransactionError.  The nonce specific blockhash errors are reported
+   as BlockhashNotFound, like Agave does.  The payloads of
+   DuplicateInstruction and InsufficientFundsForRent are not recorded
+   by the runtime, so these are reported without them. */
+
+static void
+fd_rpc_printf_txn_err( fd_rpc_tile_t *                ctx,
+                       fd_rpc_txnstatus_err_t const * err ) {
+  int txn_err = err->txn_err;
+  if( FD_LIKELY( !txn_err ) ) {
+    fd_http_server_printf( ctx->http, "null" );
+    return;
+  }
+  if( FD_UNLIKELY( txn_err<=FD_RUNTIME_TXN_ERR_BLOCKHASH_NONCE_ALREADY_ADVANCED &&
+                   txn_err>=FD_RUNTIME_TXN_ERR_BLOCKHASH_FAIL_WRONG_NONCE ) ) txn_err = FD_RUNTIME_TXN_ERR_BLOCKHASH_NOT_FOUND;
+
+  ulong txn_err_idx = (ulong)(-(long)txn_err-1L);
+  if( FD_UNLIKELY( txn_err>0 || txn_err_idx>=sizeof(fd_rpc_txn_err_names)/sizeof(char const *) ) ) {
+    fd_http_server_printf( ctx->http, "\"Unknown\"" );
+    return;
+  }
+  if( FD_LIKELY( txn_err!=FD_RUNTIME_TXN_ERR_INSTRUCTION_ERROR ) ) {
+    fd_http_server_printf( ctx->http, "\"%s\"", fd_rpc_txn_err_names[ txn_err_idx ] );
+    return;
+  }
+
+  ulong instr_err_idx = (ulong)(-(long)err->instr_err-1L);
+  if( FD_UNLIKELY( err->instr_err>=0 || instr_err_idx>=sizeof(fd_rpc_instr_err_names)/sizeof(char const *) ) ) {
+    fd_http_server_printf( ctx->http, "{\"InstructionError\":[%u,\"Unknown\"]}", err->instr_idx );
+  } else if( FD_UNLIKELY( err->instr_err==FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR ) ) {
+    fd_http_server_printf( ctx->http, "{\"InstructionError\":[%u,{\"Custom\":%u}]}", err->instr_idx, err->custom_err );
+  } else {
+    fd_http_server_printf( ctx->http, "{\"InstructionError\":[%u,\"%s\"]}", err->instr_idx, fd_rpc_instr_err_names[ instr_err_idx ] );
+  }
+}
+
+static void
+fd_rpc_printf_txn_status( fd_rpc_tile_t *                ctx,
+                          fd_rpc_txnstatus_err_t const * err ) {
+  if( FD_LIKELY( !err->txn_err ) ) {
+    fd_http_server_printf( ctx->http, "{\"Ok\":null}" );
+    return;
+  }
+  fd_http_server_printf( ctx->http, "{\"Err\":" );
+  fd_rpc_printf_txn_err( ctx, err );
+  fd_http_server_printf( ctx->http, "}" );
+}
+
+/* fd_rpc_printf_txn_meta appends the transaction metadata of a stored
+   transaction.  Only the execution result is recorded, so this is the
+   err and status fields of Agave's UiTransactionStatusMeta. */
+
+static void
+fd_rpc_printf_txn_meta( fd_rpc_tile_t *                ctx,
+                        fd_rpc_txnstatus_err_t const * err ) {
+  fd_http_server_printf( ctx->http, "{\"err\":" );
+  fd_rpc_printf_txn_err( ctx, err );
+  fd_http_server_printf( ctx->http, ",\"status\":" );
+  fd_rpc_printf_txn_status( ctx, err );
+  fd_http_server_printf( ctx->http, "}" );
+}
+
+static char const * const fd_rpc_conf_cstr[] = { NULL, "processed", "confirmed", "finalized" };
+
+/* fd_rpc_txnstatus_check returns 1 if the transaction status store is
+   enabled, or 0 and an error response in res. */
+
+static int
+fd_rpc_txnstatus_check( fd_rpc_tile_t *             ctx,
+                        cJSON const *               id,
+                        fd_http_server_response_t * res ) {
+  if( FD_LIKELY( ctx->txnstatus ) ) return 1;
+  CSTR_JSON( id, id_cstr );
+  *res = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: transaction status store is disabled, see [tiles.rpc.transaction_status_max]\"},\"id\":%s}\n", id_cstr );
+  return 0;
+}
+
+/* fd_rpc_txnstatus_best returns the stored copy of the transaction
+   with first signature sig visible at the highest commitment level,
+   which must be at least min_conf, or FD_RPC_TXNSTATUS_IDX_NULL if
+   there is none.  On success, *conf is its level. */
+
+static ulong
+fd_rpc_txnstatus_best( fd_rpc_tile_t const * ctx,
+                       uchar const           sig[ 64 ],
+                       int                   min_conf,
+                       int *                 conf ) {
+  ulong processed_slot = ctx->processed_idx==ULONG_MAX ? ULONG_MAX : ctx->banks[ ctx->processed_idx ].slot;
+  ulong confirmed_slot = ctx->confirmed_idx==ULONG_MAX ? ULONG_MAX : ctx->banks[ ctx->confirmed_idx ].slot;
+
+  ulong best      = FD_RPC_TXNSTATUS_IDX_NULL;
+  int   best_conf = min_conf-1;
+  for( ulong i=fd_rpc_txnstatus_sig_query( ctx->txnstatus, sig ); i!=FD_RPC_TXNSTATUS_IDX_NULL; i=fd_rpc_txnstatus_sig_next( ctx->txnstatus, i ) ) {
+    int c = fd_rpc_txnstatus_conf( ctx->txnstatus, i, processed_slot, confirmed_slot );
+    if( c>best_conf ) { best = i; best_conf = c; }
+  }
+  *conf = best_conf;
+  return best;
+}
+
+static int
+fd_rpc_validate_signature( fd_rpc_tile_t *             ctx,
+                           cJSON const *               id,
+                           cJSON const *               signature_in,
+                           uchar                       signature_out[ 64 ],
+                           fd_http_server_response_t * response ) {
+  FD_TEST( signature_in );
+  if( FD_UNLIKELY( cJSON_IsNumber( signature_in ) || cJSON_IsBool( signature_in ) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON( signature_in, signature_in_cstr );
+    *response = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s `%s`, expected a string.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( signature_in ), signature_in_cstr, id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( !cJSON_IsString( signature_in ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    *response = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected a string.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( signature_in ), id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( fd_rpc_cstr_contains_non_base58( signature_in->valuestring ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    *response = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid param: Invalid\"},\"id\":%s}\n", id_cstr );
+    return 0;
+  }
+  if( FD_UNLIKELY( !fd_base58_decode_64( signature_in->valuestring, signature_out ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    *response = PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid param: WrongSize\"},\"id\":%s}\n", id_cstr );
+    return 0;
+  }
+
+  return 1;
+}
+
+static fd_http_server_response_t
+getSignaturesForAddress( fd_rpc_tile_t * ctx,
+                         cJSON const *   id,
+                         cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_SIGNATURES_FOR_ADDRESS, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 2, &response ) ) ) return response;
+
+  fd_pubkey_t address;
+  if( FD_UNLIKELY( !fd_rpc_validate_address( ctx, id, cJSON_GetArrayItem( params, 0 ), &address, &response ) ) ) return response;
+
+  ulong bank_idx = ULONG_MAX;
+  cJSON const * config = cJSON_GetArrayItem( params, 1 );
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcSignaturesForAddressConfig",
+                                             1, /* has_commitment */
+                                             0, /* has_encoding */
+                                             0, /* has_data_slice */
+                                             1, /* has_min_context_slot */
+                                             &bank_idx,
+                                             NULL,
+                                             NULL,
+                                             NULL,
+                                             &response );
+  if( FD_UNLIKELY( !config_valid ) ) return response;
+
+  int min_conf = fd_rpc_txnstatus_min_conf( ctx, id, config, 0, &response );
+  if( FD_UNLIKELY( min_conf==FD_RPC_TXNSTATUS_CONF_NONE ) ) return response;
+
+  ulong limit = 1000UL;
+  cJSON const * _limit = cJSON_GetObjectItemCaseSensitive( config, "limit" );
+  if( FD_UNLIKELY( _limit && !cJSON_IsNull( _limit ) ) ) {
+    if( FD_UNLIKELY( !fd_rpc_cjson_is_integer( _limit ) || _limit->valueint<0 ) ) {
+      CSTR_JSON( id, id_cstr );
+      return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected usize.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( _limit ), id_cstr );
+    }
+    limit = _limit->valueulong;
+  }
+  if( FD_UNLIKELY( !limit || limit>1000UL ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid limit; max 1000\"},\"id\":%s}\n", id_cstr );
+  }
+
+  cJSON const * _before = cJSON_GetObjectItemCaseSensitive( config, "before" );
+  cJSON const * _until  = cJSON_GetObjectItemCaseSensitive( config, "until"  );
+  uchar before[ 64 ];
+  uchar until [ 64 ];
+  int   has_before = _before && !cJSON_IsNull( _before );
+  int   has_until  = _until  && !cJSON_IsNull( _until  );
+  if( FD_UNLIKELY( has_before && !fd_rpc_validate_signature( ctx, id, _before, before, &response ) ) ) return response;
+  if( FD_UNLIKELY( has_until  && !fd_rpc_validate_signature( ctx, id, _until,  until,  &response ) ) ) return response;
+
+  if( FD_UNLIKELY( !fd_rpc_txnstatus_check( ctx, id, &response ) ) ) return response;
+
+  /* Candidates must be strictly between until and before in the chain.
+     A before signature that is not found yields no results, an until
+     signature that is not found does not bound the search (as Agave
+     does with a ledger). */
+
+  int   conf;
+  ulong before_slot = ULONG_MAX; ulong before_index = ULONG_MAX;
+  ulong until_slot  = 0UL;       ulong until_index  = 0UL;
+  int   empty       = 0;
+  if( FD_UNLIKELY( has_before ) ) {
+    ulong i = fd_rpc_txnstatus_best( ctx, before, min_conf, &conf );
+    if( FD_LIKELY( i!=FD_RPC_TXNSTATUS_IDX_NULL ) ) {
+      before_slot  = fd_rpc_txnstatus_slot( ctx->txnstatus, i );
+      before_index = fd_rpc_txnstatus_index_in_slot( ctx->txnstatus, i );
+    } else {
+      empty = 1;
+    }
+  }
+  if( FD_UNLIKELY( has_until ) ) {
+    ulong i = fd_rpc_txnstatus_best( ctx, until, min_conf, &conf );
+    if( FD_LIKELY( i!=FD_RPC_TXNSTATUS_IDX_NULL ) ) {
+      until_slot  = fd_rpc_txnstatus_slot( ctx->txnstatus, i );
+      until_index = fd_rpc_txnstatus_index_in_slot( ctx->txnstatus, i );
+    }
+  }
+
+  /* Visible transactions are all on one chain, so postings (newest
+     first) come in decreasing slot order, but transactions within a
+     slot execute out of order.  Walk until limit candidates are found
+     and the slot of the last one is complete, then sort. */
+
+  ulong processed_slot = ctx->processed_idx==ULONG_MAX ? ULONG_MAX : ctx->banks[ ctx->processed_idx ].slot;
+  ulong confirmed_slot = ctx->confirmed_idx==ULONG_MAX ? ULONG_MAX : ctx->banks[ ctx->confirmed_idx ].slot;
+
+  fd_rpc_sig_cand_t * cand     = ctx->txnstatus_cand;
+  ulong               cand_cnt = 0UL;
+  ulong               p        = empty ? FD_RPC_TXNSTATUS_IDX_NULL : fd_rpc_txnstatus_addr_query( ctx->txnstatus, address.uc );
+  for( ; p!=FD_RPC_TXNSTATUS_IDX_NULL && cand_cnt<FD_RPC_SIG_CAND_MAX; p=fd_rpc_txnstatus_addr_next( ctx->txnstatus, p ) ) {
+    ulong i = fd_rpc_txnstatus_post_txn( ctx->txnstatus, p );
+    if( fd_rpc_txnstatus_conf( ctx->txnstatus, i, processed_slot, confirmed_slot )<min_conf ) continue;
+
+    ulong slot  = fd_rpc_txnstatus_slot( ctx->txnstatus, i );
+    ulong index = fd_rpc_txnstatus_index_in_slot( ctx->txnstatus, i );
+    if( FD_UNLIKELY( cand_cnt>=limit && slot<cand[ limit-1UL ].slot ) ) break;
+    if( FD_UNLIKELY( slot<until_slot ) ) break;
+    if( slot>before_slot || ( slot==before_slot && index>=before_index ) ) continue;
+    if( slot==until_slot && index<=until_index ) continue;
+
+    cand[ cand_cnt++ ] = (fd_rpc_sig_cand_t){ .slot = slot, .index_in_slot = index, .txn_idx = i };
+  }
+  fd_rpc_sig_cand_sort_insert( cand, cand_cnt );
+  cand_cnt = fd_ulong_min( cand_cnt, limit );
+
+  CSTR_JSON( id, id_cstr );
+  fd_http_server_printf( ctx->http, "{\"jsonrpc\":\"2.0\",\"result\":[" );
+  for( ulong j=0UL; j<cand_cnt; j++ ) {
+    ulong i = cand[ j ].txn_idx;
+    FD_BASE58_ENCODE_64_BYTES( fd_rpc_txnstatus_sig( ctx->txnstatus, i ), sig_b58 );
+    int c = fd_rpc_txnstatus_conf( ctx->txnstatus, i, processed_slot, confirmed_slot );
+    fd_http_server_printf( ctx->http, "%s{\"signature\":\"%s\",\"slot\":%lu,\"err\":", j ? "," : "", sig_b58, cand[ j ].slot );
+    fd_rpc_printf_txn_err( ctx, fd_rpc_txnstatus_err( ctx->txnstatus, i ) );
+    fd_http_server_printf( ctx->http, ",\"memo\":null,\"blockTime\":null,\"confirmationStatus\":\"%s\"}", fd_rpc_conf_cstr[ c ] );
+  }
+  fd_http_server_printf( ctx->http, "],\"id\":%s}\n", id_cstr );
+  return STAGE_JSON( ctx );
+}
+
+static fd_http_server_response_t
+getSignatureStatuses( fd_rpc_tile_t * ctx,
+                      cJSON const *   id,
+                      cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_SIGNATURE_STATUSES, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 2, &response ) ) ) return response;
+
+  cJSON const * sigs_arr = cJSON_GetArrayItem( params, 0 );
+  if( FD_UNLIKELY( cJSON_IsNumber( sigs_arr ) || cJSON_IsBool( sigs_arr ) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON( sigs_arr, sigs_arr_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s `%s`, expected a sequence.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( sigs_arr ), sigs_arr_cstr, id_cstr );
+  }
+  if( FD_UNLIKELY( cJSON_IsString( sigs_arr ) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON_UNQUOTED( sigs_arr, sigs_arr_esc );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s \\\"%s\\\", expected a sequence.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( sigs_arr ), sigs_arr_esc, id_cstr );
+  }
+  if( FD_UNLIKELY( !cJSON_IsArray( sigs_arr ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected a sequence.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( sigs_arr ), id_cstr );
+  }
+
+  int cnt = cJSON_GetArraySize( sigs_arr );
+  if( FD_UNLIKELY( cnt<0 || cnt>256 ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Too many inputs provided; max 256\"},\"id\":%s}\n", id_cstr );
+  }
+
+  /* searchTransactionHistory is accepted and ignored, the store is the
+     only history available. */
+  ulong bank_idx = ULONG_MAX;
+  cJSON const * config = cJSON_GetArrayItem( params, 1 );
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcSignatureStatusConfig",
+                                             0, /* has_commitment */
+                                             0, /* has_encoding */
+                                             0, /* has_data_slice */
+                                             0, /* has_min_context_slot */
+                                             &bank_idx,
+                                             NULL,
+                                             NULL,
+                                             NULL,
+                                             &response );
+  if( FD_UNLIKELY( !config_valid ) ) return response;
+
+  uchar sigs[ 256UL ][ 64 ];
+  for( ulong i=0UL; i<(ulong)cnt; i++ ) {
+    if( FD_UNLIKELY( !fd_rpc_validate_signature( ctx, id, cJSON_GetArrayItem( sigs_arr, (int)i ), sigs[ i ], &response ) ) ) return response;
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_txnstatus_check( ctx, id, &response ) ) ) return response;
+  if( FD_UNLIKELY( ctx->processed_idx==ULONG_MAX ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: banks uninitialized\"},\"id\":%s}\n", id_cstr );
+  }
+
+  /* Statuses are reported at processed commitment.  The number of
+     confirmations is not tracked, so it is 0 until finalized. */
+
+  CSTR_JSON( id, id_cstr );
+  fd_http_server_printf( ctx->http,
+      "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"%s\",\"slot\":%lu},\"value\":[",
+      FD_RPC_AGAVE_API_VERSION, ctx->banks[ ctx->processed_idx ].slot );
+  for( ulong j=0UL; j<(ulong)cnt; j++ ) {
+    if( j ) fd_http_server_printf( ctx->http, "," );
+
+    int   conf;
+    ulong i = fd_rpc_txnstatus_best( ctx, sigs[ j ], FD_RPC_TXNSTATUS_CONF_PROCESSED, &conf );
+    if( FD_UNLIKELY( i==FD_RPC_TXNSTATUS_IDX_NULL ) ) {
+      fd_http_server_printf( ctx->http, "null" );
+      continue;
+    }
+
+    fd_rpc_txnstatus_err_t const * err = fd_rpc_txnstatus_err( ctx->txnstatus, i );
+    fd_http_server_printf( ctx->http, "{\"slot\":%lu,\"confirmations\":%s,\"status\":",
+                           fd_rpc_txnstatus_slot( ctx->txnstatus, i ), conf==FD_RPC_TXNSTATUS_CONF_FINALIZED ? "null" : "0" );
+    fd_rpc_printf_txn_status( ctx, err );
+    fd_http_server_printf( ctx->http, ",\"err\":" );
+    fd_rpc_printf_txn_err( ctx, err );
+    fd_http_server_printf( ctx->http, ",\"confirmationStatus\":\"%s\"}", fd_rpc_conf_cstr[ conf ] );
+  }
+  fd_http_server_printf( ctx->http, "]},\"id\":%s}\n", id_cstr );
+  return STAGE_JSON( ctx );
+}
 
 static fd_http_server_response_t
 getSlot( fd_rpc_tile_t * ctx,
@@ -1971,11 +3410,194 @@ UNIMPLEMENTED(getSlotLeaders)
 UNIMPLEMENTED(getStakeMinimumDelegation)
 UNIMPLEMENTED(getSupply)
 UNIMPLEMENTED(getTokenAccountBalance)
-UNIMPLEMENTED(getTokenAccountsByDelegate)
-UNIMPLEMENTED(getTokenAccountsByOwner)
+
+/* getTokenAccountsBy{Delegate,Owner} are the same query against a
+   different token account field. */
+static fd_http_server_response_t
+fd_rpc_get_token_accounts_by( fd_rpc_tile_t * ctx,
+                              cJSON const *   id,
+                              cJSON const *   params,
+                              int             kind ) {
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 2, 3, &response ) ) ) return response;
+
+  fd_pubkey_t key;
+  if( FD_UNLIKELY( !fd_rpc_validate_address( ctx, id, cJSON_GetArrayItem( params, 0 ), &key, &response ) ) ) return response;
+
+  cJSON const * filter     = cJSON_GetArrayItem( params, 1 );
+  cJSON const * mint       = cJSON_IsObject( filter ) ? cJSON_GetObjectItemCaseSensitive( filter, "mint"      ) : NULL;
+  cJSON const * program_id = cJSON_IsObject( filter ) ? cJSON_GetObjectItemCaseSensitive( filter, "programId" ) : NULL;
+  if( FD_UNLIKELY( !mint==!program_id ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: data did not match any variant of untagged enum RpcTokenAccountsFilter.\"},\"id\":%s}\n", id_cstr );
+  }
+  fd_pubkey_t filter_key;
+  if( FD_UNLIKELY( !fd_rpc_validate_address( ctx, id, mint ? mint : program_id, &filter_key, &response ) ) ) return response;
+
+  ulong bank_idx = ULONG_MAX;
+  char const * encoding_cstr = NULL;
+  ulong slice_length = ULONG_MAX;
+  ulong slice_offset = 0;
+  cJSON const * config = cJSON_GetArrayItem( params, 2 );
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcAccountInfoConfig",
+                                             1, 1, 1, 1,
+                                             &bank_idx, &encoding_cstr,
+                                             &slice_length, &slice_offset,
+                                             &response );
+  if( FD_UNLIKELY( !config_valid ) ) return response;
+
+  if( FD_UNLIKELY( !fd_rpc_index_check( ctx, id, &response ) ) ) return response;
+
+  bank_info_t * info = &ctx->banks[ bank_idx ];
+
+  /* As in Agave, a mint filter restricts the results to the token
+     program that owns the mint. */
+  fd_pubkey_t     program;
+  fd_rpc_filter_t filters[ 1 ];
+  ulong           filter_cnt = 0UL;
+  if( FD_LIKELY( program_id ) ) {
+    if( FD_UNLIKELY( !fd_rpc_index_is_token_program( filter_key.uc ) ) ) {
+      CSTR_JSON( id, id_cstr );
+      return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid param: unrecognized Token program id\"},\"id\":%s}\n", id_cstr );
+    }
+    program = filter_key;
+  } else {
+    ulong acct_lamports;
+    int   acct_executable;
+    ulong acct_data_len;
+    fd_accdb_read_one_nocache( ctx->accdb, info->accdb_fork_id, filter_key.uc,
+                               &acct_lamports, &acct_executable, program.uc,
+                               ctx->accdb_data_buf, &acct_data_len );
+    if( FD_UNLIKELY( !acct_lamports || !fd_rpc_index_is_token_program( program.uc ) ) ) {
+      CSTR_JSON( id, id_cstr );
+      return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid param: could not find mint\"},\"id\":%s}\n", id_cstr );
+    }
+    filters[ 0 ] = (fd_rpc_filter_t){ .kind = FD_RPC_FILTER_MEMCMP, .off = FD_RPC_INDEX_TOKEN_MINT_OFF, .bytes_sz = 32UL };
+    memcpy( filters[ 0 ].bytes, filter_key.uc, 32UL );
+    filter_cnt = 1UL;
+  }
+
+  CSTR_JSON( id, id_cstr );
+  fd_http_server_printf( ctx->http,
+      "{\"jsonrpc\":\"2.0\",\"id\":%s,\"result\":{\"context\":{\"apiVersion\":\"%s\",\"slot\":%lu},\"value\":[",
+      id_cstr, FD_RPC_AGAVE_API_VERSION, info->slot );
+
+  if( FD_UNLIKELY( !fd_rpc_index_query( ctx, info, kind, key.uc, program.uc, filters, filter_cnt,
+                                        encoding_cstr, slice_offset, slice_length, id_cstr, &response ) ) ) {
+    return response;
+  }
+
+  fd_http_server_printf( ctx->http, "]}}\n" );
+  return STAGE_JSON( ctx );
+}
+
+static fd_http_server_response_t
+getTokenAccountsByDelegate( fd_rpc_tile_t * ctx,
+                            cJSON const *   id,
+                            cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_TOKEN_ACCOUNTS_BY_DELEGATE, 1UL );
+  return fd_rpc_get_token_accounts_by( ctx, id, params, FD_RPC_INDEX_KIND_TOKEN_DELEGATE );
+}
+
+static fd_http_server_response_t
+getTokenAccountsByOwner( fd_rpc_tile_t * ctx,
+                         cJSON const *   id,
+                         cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_TOKEN_ACCOUNTS_BY_OWNER, 1UL );
+  return fd_rpc_get_token_accounts_by( ctx, id, params, FD_RPC_INDEX_KIND_TOKEN_OWNER );
+}
+
 UNIMPLEMENTED(getTokenLargestAccounts)
 UNIMPLEMENTED(getTokenSupply)
-UNIMPLEMENTED(getTransaction)
+static fd_http_server_response_t
+getTransaction( fd_rpc_tile_t * ctx,
+                cJSON const *   id,
+                cJSON const *   params ) {
+  FD_MCNT_INC( RPC, REQUEST_SERVED_GET_TRANSACTION, 1UL );
+
+  fd_http_server_response_t response;
+  if( FD_UNLIKELY( !fd_rpc_validate_params( ctx, id, params, 1, 2, &response ) ) ) return response;
+
+  uchar sig[ 64 ];
+  if( FD_UNLIKELY( !fd_rpc_validate_signature( ctx, id, cJSON_GetArrayItem( params, 0 ), sig, &response ) ) ) return response;
+
+  /* The encoding is checked here, as transactions support json (the
+     default) but not base64+zstd.  Only base64 is implemented, only the
+     execution result is recorded so there is not enough transaction
+     metadata to go with json. */
+  ulong bank_idx = ULONG_MAX;
+  cJSON const * config = cJSON_GetArrayItem( params, 1 );
+  int config_valid = fd_rpc_validate_config( ctx, id, config, "struct RpcTransactionConfig",
+                                             1, /* has_commitment */
+                                             0, /* has_encoding */
+                                             0, /* has_data_slice */
+                                             0, /* has_min_context_slot */
+                                             &bank_idx,
+                                             NULL,
+                                             NULL,
+                                             NULL,
+                                             &response );
+  if( FD_UNLIKELY( !config_valid ) ) return response;
+
+  int min_conf = fd_rpc_txnstatus_min_conf( ctx, id, config, 0, &response );
+  if( FD_UNLIKELY( min_conf==FD_RPC_TXNSTATUS_CONF_NONE ) ) return response;
+
+  cJSON const * encoding      = cJSON_GetObjectItemCaseSensitive( config, "encoding" );
+  char const *  encoding_cstr = encoding && cJSON_IsString( encoding ) ? encoding->valuestring : "json";
+  if( FD_UNLIKELY( encoding && !cJSON_IsNull( encoding ) && !cJSON_IsString( encoding ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected a string.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( encoding ), id_cstr );
+  }
+  if( FD_UNLIKELY( strcmp( encoding_cstr, "binary" ) && strcmp( encoding_cstr, "base64" ) && strcmp( encoding_cstr, "base58" ) &&
+                   strcmp( encoding_cstr, "json"   ) && strcmp( encoding_cstr, "jsonParsed" ) ) ) {
+    CSTR_JSON( id, id_cstr ); CSTR_JSON_UNQUOTED( encoding, encoding_esc );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: unknown variant `%s`, expected one of `binary`, `base64`, `base58`, `json`, `jsonParsed`.\"},\"id\":%s}\n", encoding_esc, id_cstr );
+  }
+  if( FD_UNLIKELY( strcmp( encoding_cstr, "base64" ) ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32065,\"message\":\"Firedancer Error: %s encoding is unsupported, use base64\"},\"id\":%s}\n", encoding_cstr, id_cstr );
+  }
+
+  int has_max_version = 0;
+  cJSON const * _max_version = cJSON_GetObjectItemCaseSensitive( config, "maxSupportedTransactionVersion" );
+  if( FD_UNLIKELY( _max_version && !cJSON_IsNull( _max_version ) ) ) {
+    if( FD_UNLIKELY( !fd_rpc_cjson_is_integer( _max_version ) || _max_version->valueint<0 || _max_version->valueulong>UCHAR_MAX ) ) {
+      CSTR_JSON( id, id_cstr );
+      return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32602,\"message\":\"Invalid params: invalid type: %s, expected u8.\"},\"id\":%s}\n", fd_rpc_cjson_type_to_cstr( _max_version ), id_cstr );
+    }
+    has_max_version = 1;
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_txnstatus_check( ctx, id, &response ) ) ) return response;
+
+  int   conf;
+  ulong i = fd_rpc_txnstatus_best( ctx, sig, min_conf, &conf );
+  uchar payload[ FD_TXN_MTU ];
+  ulong payload_sz = i==FD_RPC_TXNSTATUS_IDX_NULL ? 0UL : fd_rpc_txnstatus_read( ctx->txnstatus, i, payload );
+  if( FD_UNLIKELY( !payload_sz ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"result\":null,\"id\":%s}\n", id_cstr );
+  }
+
+  int version = fd_rpc_txnstatus_version( ctx->txnstatus, i );
+  if( FD_UNLIKELY( version==FD_TXN_V0 && !has_max_version ) ) {
+    CSTR_JSON( id, id_cstr );
+    return PRINTF_JSON( ctx, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":\"Transaction version (0) is not supported by the requesting client. Please try the request again with the following configuration parameter: \\\"maxSupportedTransactionVersion\\\": 0\"},\"id\":%s}\n", FD_RPC_ERROR_UNSUPPORTED_TRANSACTION_VERSION, id_cstr );
+  }
+
+  char payload_b64[ FD_BASE64_ENC_SZ( FD_TXN_MTU )+1UL ];
+  payload_b64[ fd_base64_encode( payload_b64, payload, payload_sz ) ] = '\0';
+
+  CSTR_JSON( id, id_cstr );
+  fd_http_server_printf( ctx->http,
+      "{\"jsonrpc\":\"2.0\",\"result\":{\"slot\":%lu,\"transaction\":[\"%s\",\"base64\"],\"meta\":",
+      fd_rpc_txnstatus_slot( ctx->txnstatus, i ), payload_b64 );
+  fd_rpc_printf_txn_meta( ctx, fd_rpc_txnstatus_err( ctx->txnstatus, i ) );
+  fd_http_server_printf( ctx->http, ",\"blockTime\":null" );
+  if( FD_LIKELY( has_max_version ) ) fd_http_server_printf( ctx->http, ",\"version\":%s", version==FD_TXN_V0 ? "0" : "\"legacy\"" );
+  fd_http_server_printf( ctx->http, "},\"id\":%s}\n", id_cstr );
+  return STAGE_JSON( ctx );
+}
 
 static fd_http_server_response_t
 getTransactionCount( fd_rpc_tile_t * ctx,
@@ -2410,6 +4032,8 @@ privileged_init( fd_topo_t const *      topo,
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   fd_rpc_tile_t * ctx      = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_rpc_tile_t ), sizeof( fd_rpc_tile_t ) );
   fd_http_server_t * _http = FD_SCRATCH_ALLOC_APPEND( l, fd_http_server_align(),   fd_http_server_footprint( http_params ) );
+  void * _txnstatus        = FD_SCRATCH_ALLOC_APPEND( l, fd_rpc_txnstatus_align(), txnstatus_footprint( tile )             );
+  void * _blocks           = FD_SCRATCH_ALLOC_APPEND( l, fd_rpc_blocks_align(),    blocks_footprint( tile )                );
 
   fd_memset( ctx, 0, sizeof(fd_rpc_tile_t) );
 
@@ -2419,6 +4043,26 @@ privileged_init( fd_topo_t const *      topo,
   const uchar * identity_key = fd_keyload_load( tile->rpc.identity_key_path, /* pubkey only: */ 1 );
   fd_memcpy( ctx->identity_pubkey, identity_key, 32UL );
 
+  /* Index keys (program ids, token owners, ...) are chosen by users,
+     so the index hash chains need an unpredictable seed. */
+  FD_TEST( fd_rng_secure( &ctx->index_seed, sizeof(ulong) ) );
+
+  /* The transaction status ring file is opened here, signatures and
+     addresses are chosen by users so they are hashed with the same
+     seed. */
+  if( FD_LIKELY( tile->rpc.transaction_status_max ) ) {
+    ctx->txnstatus = fd_rpc_txnstatus_join( fd_rpc_txnstatus_new( _txnstatus, tile->rpc.transaction_status_max, txnstatus_slot_max( tile ), tile->rpc.txnstatus_path, ctx->index_seed ) );
+    if( FD_UNLIKELY( !ctx->txnstatus ) ) FD_LOG_ERR(( "failed to create transaction status store at `%s`", tile->rpc.txnstatus_path ));
+  }
+
+  /* The block archive takes the transactions of rooted blocks from the
+     transaction status store. */
+  if( FD_LIKELY( tile->rpc.block_archive_max ) ) {
+    if( FD_UNLIKELY( !tile->rpc.transaction_status_max ) ) FD_LOG_ERR(( "[tiles.rpc.block_archive_max] requires [tiles.rpc.transaction_status_max] to be non-zero" ));
+    ctx->blocks = fd_rpc_blocks_join( fd_rpc_blocks_new( _blocks, tile->rpc.block_archive_max, blocks_pending_max( tile ), tile->rpc.block_cache_sz, tile->rpc.blocks_path, ctx->index_seed ) );
+    if( FD_UNLIKELY( !ctx->blocks ) ) FD_LOG_ERR(( "failed to create block archive at `%s`", tile->rpc.blocks_path ));
+  }
+
   fd_http_server_callbacks_t callbacks = {
     .request    = rpc_http_request,
     .ws_open    = rpc_ws_open,
@@ -2475,6 +4119,8 @@ unprivileged_init( fd_topo_t const *      topo,
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   fd_rpc_tile_t * ctx    = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_tile_t),            sizeof(fd_rpc_tile_t)                                              );
                            FD_SCRATCH_ALLOC_APPEND( l, fd_http_server_align(),            fd_http_server_footprint( http_params )                            );
+                           FD_SCRATCH_ALLOC_APPEND( l, fd_rpc_txnstatus_align(),          txnstatus_footprint( tile )                                        );
+                           FD_SCRATCH_ALLOC_APPEND( l, fd_rpc_blocks_align(),             blocks_footprint( tile )                                           );
   void * _alloc          = FD_SCRATCH_ALLOC_APPEND( l, fd_alloc_align(),                  fd_alloc_footprint()                                               );
   void * _bz2_alloc      = FD_SCRATCH_ALLOC_APPEND( l, fd_alloc_align(),                  fd_alloc_footprint()                                               );
   void * _banks          = FD_SCRATCH_ALLOC_APPEND( l, alignof(bank_info_t),              tile->rpc.max_live_slots*sizeof(bank_info_t)                       );
@@ -2484,6 +4130,7 @@ unprivileged_init( fd_topo_t const *      topo,
   void * _ws_sub_slot    = FD_SCRATCH_ALLOC_APPEND( l, alignof(ulong),                    http_params.max_ws_connection_cnt*sizeof(ulong)                    );
   void * _genesis_tar    = FD_SCRATCH_ALLOC_APPEND( l, alignof(uchar),                    fd_rpc_genesis_tar_max_sz( tile->rpc.genesis_max_message_size )    );
   void * _genesis_tar_bz = FD_SCRATCH_ALLOC_APPEND( l, alignof(uchar),                    fd_rpc_genesis_tar_bz_max_sz( tile->rpc.genesis_max_message_size ) );
+  void * _index          = FD_SCRATCH_ALLOC_APPEND( l, fd_rpc_index_align(),              fd_rpc_index_footprint( tile->rpc.account_index_max )              );
 # if FD_HAS_ZSTD
   ulong  zstd_wksp_sz = ZSTD_estimateCCtxSize( FD_RPC_ZSTD_LEVEL );
   void * _zstd_wksp   = FD_SCRATCH_ALLOC_APPEND( l, 16UL,                     zstd_wksp_sz                                           );
@@ -2562,6 +4209,17 @@ unprivileged_init( fd_topo_t const *      topo,
   ctx->accdb = fd_accdb_join_readonly( _accdb_join, accdb_shmem_ro, epoch_fseq, FD_ACCDB_FD_RO );
   FD_TEST( ctx->accdb );
 
+  ctx->index             = NULL;
+  ctx->index_scan_chain  = 0UL;
+  ctx->index_scan_resume = 0;
+  ctx->index_sweep_idx   = 0UL;
+  ctx->index_full_slot   = 0UL;
+  ctx->index_rebuild_cnt = 0UL;
+  if( FD_LIKELY( tile->rpc.account_index_max ) ) {
+    ctx->index = fd_rpc_index_join( fd_rpc_index_new( _index, tile->rpc.account_index_max, ctx->index_seed ) );
+    FD_TEST( ctx->index );
+  }
+
   fd_histf_join( fd_histf_new( ctx->request_duration, FD_MHIST_SECONDS_MIN( RPC, REQUEST_DURATION_SECONDS ),
                                                       FD_MHIST_SECONDS_MAX( RPC, REQUEST_DURATION_SECONDS ) ) );
 
@@ -2579,7 +4237,9 @@ populate_allowed_seccomp( fd_topo_t const *      topo,
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   fd_rpc_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_rpc_tile_t ), sizeof( fd_rpc_tile_t ) );
 
-  populate_sock_filter_policy_fd_rpc_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)fd_http_server_fd( ctx->http ), (uint)FD_ACCDB_FD_RO );
+  populate_sock_filter_policy_fd_rpc_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), (uint)fd_http_server_fd( ctx->http ), (uint)FD_ACCDB_FD_RO,
+                                           ctx->txnstatus ? (uint)fd_rpc_txnstatus_fd( ctx->txnstatus ) : (uint)-1,
+                                           ctx->blocks    ? (uint)fd_rpc_blocks_fd( ctx->blocks )       : (uint)-1 );
   return sock_filter_policy_fd_rpc_tile_instr_cnt;
 }
 
@@ -2592,7 +4252,7 @@ populate_allowed_fds( fd_topo_t const *      topo,
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   fd_rpc_tile_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_rpc_tile_t ), sizeof( fd_rpc_tile_t ) );
 
-  if( FD_UNLIKELY( out_fds_cnt<4UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
+  if( FD_UNLIKELY( out_fds_cnt<6UL ) ) FD_LOG_ERR(( "out_fds_cnt %lu", out_fds_cnt ));
 
   ulong out_cnt = 0UL;
   out_fds[ out_cnt++ ] = 2; /* stderr */
@@ -2600,6 +4260,10 @@ populate_allowed_fds( fd_topo_t const *      topo,
     out_fds[ out_cnt++ ] = fd_log_private_logfile_fd(); /* logfile */
   out_fds[ out_cnt++ ] = fd_http_server_fd( ctx->http ); /* rpc listen socket */
   out_fds[ out_cnt++ ] = FD_ACCDB_FD_RO; /* accounts db readonly fd */
+  if( FD_LIKELY( ctx->txnstatus ) )
+    out_fds[ out_cnt++ ] = fd_rpc_txnstatus_fd( ctx->txnstatus ); /* transaction status ring file */
+  if( FD_LIKELY( ctx->blocks ) )
+    out_fds[ out_cnt++ ] = fd_rpc_blocks_fd( ctx->blocks ); /* block archive ring file */
 
   return out_cnt;
 }
@@ -2607,8 +4271,9 @@ populate_allowed_fds( fd_topo_t const *      topo,
 static ulong
 rlimit_file_cnt( fd_topo_t const *      topo FD_PARAM_UNUSED,
                  fd_topo_tile_t const * tile ) {
-  /* pipefd, socket, stderr, logfile, and one spare for new accept() connections */
-  ulong base = 5UL;
+  /* pipefd, socket, stderr, logfile, transaction status file, block
+     archive file, and one spare for new accept() connections */
+  ulong base = 7UL;
   return base + tile->rpc.max_http_connections + tile->rpc.max_websocket_connections;
 }
 
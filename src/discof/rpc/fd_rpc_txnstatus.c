@@ -0,0 +1,689 @@
+#define _GNU_SOURCE
+#include "fd_rpc_txnstatus.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define FD_RPC_TXNSTATUS_SLOT_EXECUTING (0) /* Transactions seen, not completed yet */
+#define FD_RPC_TXNSTATUS_SLOT_COMPLETED (1)
+#define FD_RPC_TXNSTATUS_SLOT_ROOTED    (2)
+#define FD_RPC_TXNSTATUS_SLOT_DEAD      (3) /* Marked dead, or on a fork abandoned by the root */
+
+/* A record in the ring file.  The signature is repeated so that a read
+   can check the record is the one the in-memory index expects. */
+
+struct fd_rpc_txnstatus_rec_hdr {
+  ulong  slot;
+  uchar  sig[ 64 ];
+  ushort payload_sz;
+  uchar  pad[ 6 ];
+};
+
+typedef struct fd_rpc_txnstatus_rec_hdr fd_rpc_txnstatus_rec_hdr_t;
+
+#define FD_RPC_TXNSTATUS_REC_MAX (sizeof(fd_rpc_txnstatus_rec_hdr_t)+FD_TXN_MTU)
+
+struct fd_rpc_txnstatus_sigkey {
+  uchar uc[ 64 ];
+};
+
+typedef struct fd_rpc_txnstatus_sigkey fd_rpc_txnstatus_sigkey_t;
+
+struct fd_rpc_txnstatus_txn {
+  fd_rpc_txnstatus_sigkey_t sig;
+  uint                      map_next;
+  uint                      map_prev;
+  uint                      slot_idx;  /* Slot table entry */
+  uint                      post_cnt;
+  ulong                     post_off;  /* Posting sequence number of the first posting */
+  ulong                     rec_off;   /* Ring file offset of the record, not wrapped */
+  uint                      rec_sz;
+  uint                      index_in_slot;
+  int                       version;
+  fd_rpc_txnstatus_err_t    err;
+};
+
+typedef struct fd_rpc_txnstatus_txn fd_rpc_txnstatus_txn_t;
+
+/* A posting links an address to a transaction referencing it.  The
+   postings of an address form a list, newest first. */
+
+struct fd_rpc_txnstatus_post {
+  uint group;
+  uint txn;
+  uint next; /* Older posting of the same address, UINT_MAX if none */
+  uint prev; /* Newer posting of the same address, UINT_MAX if none */
+};
+
+typedef struct fd_rpc_txnstatus_post fd_rpc_txnstatus_post_t;
+
+struct fd_rpc_txnstatus_addr {
+  uchar uc[ 32 ];
+};
+
+typedef struct fd_rpc_txnstatus_addr fd_rpc_txnstatus_addr_t;
+
+struct fd_rpc_txnstatus_group {
+  fd_rpc_txnstatus_addr_t addr;
+  uint                    map_next; /* Also used by the pool */
+  uint                    head;     /* Newest posting */
+};
+
+typedef struct fd_rpc_txnstatus_group fd_rpc_txnstatus_group_t;
+
+struct fd_rpc_txnstatus_slot {
+  ulong slot;
+  uint  map_next; /* Also used by the pool */
+  uint  dlist_prev;
+  uint  dlist_next;
+  uint  txn_cnt;
+  int   state;
+  int   unrooted; /* In the unrooted list */
+  ulong parent;   /* ULONG_MAX until completed */
+  ulong seq0;     /* Sequence numbers of the first and past the last stored transaction, ULONG_MAX and 0 if none */
+  ulong seq1;
+  uint  insert_cnt;
+};
+
+typedef struct fd_rpc_txnstatus_slot fd_rpc_txnstatus_slot_t;
+
+#define MAP_NAME               sig_map
+#define MAP_ELE_T              fd_rpc_txnstatus_txn_t
+#define MAP_KEY_T              fd_rpc_txnstatus_sigkey_t
+#define MAP_KEY                sig
+#define MAP_IDX_T              uint
+#define MAP_NEXT               map_next
+#define MAP_PREV               map_prev
+#define MAP_MULTI              1
+#define MAP_OPTIMIZE_RANDOM_ACCESS_REMOVAL 1
+#define MAP_KEY_EQ(k0,k1)      (!memcmp( (k0)->uc, (k1)->uc, 64UL ))
+#define MAP_KEY_HASH(key,seed) fd_ulong_hash( (seed) ^ FD_LOAD( ulong, (key)->uc ) )
+#include "../../util/tmpl/fd_map_chain.c"
+
+#define POOL_NAME  group_pool
+#define POOL_T     fd_rpc_txnstatus_group_t
+#define POOL_NEXT  map_next
+#define POOL_IDX_T uint
+#include "../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME               group_map
+#define MAP_ELE_T              fd_rpc_txnstatus_group_t
+#define MAP_KEY_T              fd_rpc_txnstatus_addr_t
+#define MAP_KEY                addr
+#define MAP_IDX_T              uint
+#define MAP_NEXT               map_next
+#define MAP_KEY_EQ(k0,k1)      (!memcmp( (k0)->uc, (k1)->uc, 32UL ))
+#define MAP_KEY_HASH(key,seed) fd_hash( (seed), (key)->uc, 32UL )
+#include "../../util/tmpl/fd_map_chain.c"
+
+#define POOL_NAME  slot_pool
+#define POOL_T     fd_rpc_txnstatus_slot_t
+#define POOL_NEXT  map_next
+#define POOL_IDX_T uint
+#include "../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME               slot_map
+#define MAP_ELE_T              fd_rpc_txnstatus_slot_t
+#define MAP_KEY_T              ulong
+#define MAP_KEY                slot
+#define MAP_IDX_T              uint
+#define MAP_NEXT               map_next
+#define MAP_KEY_HASH(key,seed) fd_ulong_hash( (*(key)) ^ (seed) )
+#include "../../util/tmpl/fd_map_chain.c"
+
+#define DLIST_NAME  unrooted_dlist
+#define DLIST_ELE_T fd_rpc_txnstatus_slot_t
+#define DLIST_PREV  dlist_prev
+#define DLIST_NEXT  dlist_next
+#define DLIST_IDX_T uint
+#include "../../util/tmpl/fd_dlist.c"
+
+#define FD_RPC_TXNSTATUS_MAGIC (0xf17eda2c7857a700UL) /* firedancer rpc txnstatus version 0 */
+
+struct __attribute__((aligned(128UL))) fd_rpc_txnstatus_private {
+  ulong magic;
+  ulong txn_max;
+  ulong post_max;
+  ulong slot_max;
+  ulong data_max;
+  int   fd;
+
+  /* Transactions, postings and ring file bytes are three FIFOs
+     consumed in the same order.  Positions are sequence numbers that
+     are never wrapped, the oldest stored transaction tells where each
+     FIFO starts. */
+  ulong txn_head;
+  ulong txn_tail;
+  ulong post_head;
+  ulong data_head;
+  ulong evict_cnt;
+
+  fd_rpc_txnstatus_txn_t *   txn;
+  sig_map_t *                sig_map;
+  fd_rpc_txnstatus_post_t *  post;
+  fd_rpc_txnstatus_group_t * group_pool;
+  group_map_t *              group_map;
+  fd_rpc_txnstatus_slot_t *  slot_pool;
+  slot_map_t *               slot_map;
+  unrooted_dlist_t *         unrooted;
+};
+
+static inline ulong
+fd_rpc_txnstatus_post_max( ulong txn_max ) {
+  return fd_ulong_max( txn_max*FD_RPC_TXNSTATUS_POST_PER_TXN, FD_TXN_ACCT_ADDR_MAX );
+}
+
+static inline ulong
+fd_rpc_txnstatus_data_max( ulong txn_max ) {
+  return fd_ulong_max( txn_max*FD_RPC_TXNSTATUS_DATA_PER_TXN, FD_RPC_TXNSTATUS_REC_MAX );
+}
+
+FD_FN_CONST ulong
+fd_rpc_txnstatus_align( void ) {
+  return alignof(fd_rpc_txnstatus_t);
+}
+
+FD_FN_CONST ulong
+fd_rpc_txnstatus_footprint( ulong txn_max,
+                            ulong slot_max ) {
+  if( FD_UNLIKELY( !txn_max || !slot_max ) ) return 0UL;
+  if( FD_UNLIKELY( txn_max>=UINT_MAX/FD_RPC_TXNSTATUS_POST_PER_TXN || slot_max>=UINT_MAX ) ) return 0UL;
+
+  ulong post_max = fd_rpc_txnstatus_post_max( txn_max );
+
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_txnstatus_t),      sizeof(fd_rpc_txnstatus_t)                                        );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_txnstatus_txn_t),  txn_max*sizeof(fd_rpc_txnstatus_txn_t)                            );
+  l = FD_LAYOUT_APPEND( l, sig_map_align(),                  sig_map_footprint( sig_map_chain_cnt_est( txn_max ) )             );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_rpc_txnstatus_post_t), post_max*sizeof(fd_rpc_txnstatus_post_t)                          );
+  l = FD_LAYOUT_APPEND( l, group_pool_align(),               group_pool_footprint( post_max )                                  );
+  l = FD_LAYOUT_APPEND( l, group_map_align(),                group_map_footprint( group_map_chain_cnt_est( post_max ) )        );
+  l = FD_LAYOUT_APPEND( l, slot_pool_align(),                slot_pool_footprint( slot_max )                                   );
+  l = FD_LAYOUT_APPEND( l, slot_map_align(),                 slot_map_footprint( slot_map_chain_cnt_est( slot_max ) )          );
+  l = FD_LAYOUT_APPEND( l, unrooted_dlist_align(),           unrooted_dlist_footprint()                                        );
+  return FD_LAYOUT_FINI( l, fd_rpc_txnstatus_align() );
+}
+
+void *
+fd_rpc_txnstatus_new( void *       shmem,
+                      ulong        txn_max,
+                      ulong        slot_max,
+                      char const * file_path,
+                      ulong        seed ) {
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_rpc_txnstatus_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_rpc_txnstatus_footprint( txn_max, slot_max ) ) ) {
+    FD_LOG_WARNING(( "invalid txn_max %lu or slot_max %lu", txn_max, slot_max ));
+    return NULL;
+  }
+
+  ulong post_max = fd_rpc_txnstatus_post_max( txn_max );
+  ulong data_max = fd_rpc_txnstatus_data_max( txn_max );
+
+  FD_SCRATCH_ALLOC_INIT( l, shmem );
+  fd_rpc_txnstatus_t * store = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_txnstatus_t),      sizeof(fd_rpc_txnstatus_t)                                 );
+  void * _txn                = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_txnstatus_txn_t),  txn_max*sizeof(fd_rpc_txnstatus_txn_t)                     );
+  void * _sig_map            = FD_SCRATCH_ALLOC_APPEND( l, sig_map_align(),                  sig_map_footprint( sig_map_chain_cnt_est( txn_max ) )      );
+  void * _post               = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_rpc_txnstatus_post_t), post_max*sizeof(fd_rpc_txnstatus_post_t)                   );
+  void * _group_pool         = FD_SCRATCH_ALLOC_APPEND( l, group_pool_align(),               group_pool_footprint( post_max )                           );
+  void * _group_map          = FD_SCRATCH_ALLOC_APPEND( l, group_map_align(),                group_map_footprint( group_map_chain_cnt_est( post_max ) ) );
+  void * _slot_pool          = FD_SCRATCH_ALLOC_APPEND( l, slot_pool_align(),                slot_pool_footprint( slot_max )                            );
+  void * _slot_map           = FD_SCRATCH_ALLOC_APPEND( l, slot_map_align(),                 slot_map_footprint( slot_map_chain_cnt_est( slot_max ) )   );
+  void * _unrooted           = FD_SCRATCH_ALLOC_APPEND( l, unrooted_dlist_align(),           unrooted_dlist_footprint()                                 );
+
+  int fd = open( file_path, O_RDWR|O_CREAT|O_TRUNC|O_CLOEXEC, (mode_t)0600 );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "open(%s) failed (%i-%s)", file_path, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( ftruncate( fd, (off_t)data_max ) ) ) {
+    FD_LOG_WARNING(( "ftruncate(%s,%lu) failed (%i-%s)", file_path, data_max, errno, fd_io_strerror( errno ) ));
+    close( fd );
+    return NULL;
+  }
+
+  store->txn_max    = txn_max;
+  store->post_max   = post_max;
+  store->slot_max   = slot_max;
+  store->data_max   = data_max;
+  store->fd         = fd;
+  store->txn_head   = 0UL;
+  store->txn_tail   = 0UL;
+  store->post_head  = 0UL;
+  store->data_head  = 0UL;
+  store->evict_cnt  = 0UL;
+  store->txn        = (fd_rpc_txnstatus_txn_t *)_txn;
+  store->sig_map    = sig_map_join( sig_map_new( _sig_map, sig_map_chain_cnt_est( txn_max ), seed ) );
+  store->post       = (fd_rpc_txnstatus_post_t *)_post;
+  store->group_pool = group_pool_join( group_pool_new( _group_pool, post_max ) );
+  store->group_map  = group_map_join( group_map_new( _group_map, group_map_chain_cnt_est( post_max ), seed ) );
+  store->slot_pool  = slot_pool_join( slot_pool_new( _slot_pool, slot_max ) );
+  store->slot_map   = slot_map_join( slot_map_new( _slot_map, slot_map_chain_cnt_est( slot_max ), seed ) );
+  store->unrooted   = unrooted_dlist_join( unrooted_dlist_new( _unrooted ) );
+  FD_TEST( store->sig_map && store->group_pool && store->group_map && store->slot_pool && store->slot_map && store->unrooted );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( store->magic ) = FD_RPC_TXNSTATUS_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return store;
+}
+
+fd_rpc_txnstatus_t *
+fd_rpc_txnstatus_join( void * shstore ) {
+  if( FD_UNLIKELY( !shstore ) ) {
+    FD_LOG_WARNING(( "NULL shstore" ));
+    return NULL;
+  }
+
+  fd_rpc_txnstatus_t * store = (fd_rpc_txnstatus_t *)shstore;
+  if( FD_UNLIKELY( store->magic!=FD_RPC_TXNSTATUS_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return store;
+}
+
+int
+fd_rpc_txnstatus_fd( fd_rpc_txnstatus_t const * store ) {
+  return store->fd;
+}
+
+/* fd_rpc_txnstatus_slot_release frees slot table entry e, which must
+   not be in the unrooted list nor have stored transactions. */
+
+static void
+fd_rpc_txnstatus_slot_release( fd_rpc_txnstatus_t *      store,
+                               fd_rpc_txnstatus_slot_t * e ) {
+  slot_map_idx_remove( store->slot_map, &e->slot, ULONG_MAX, store->slot_pool );
+  slot_pool_ele_release( store->slot_pool, e );
+}
+
+/* fd_rpc_txnstatus_evict removes the oldest stored transaction. */
+
+static void
+fd_rpc_txnstatus_evict( fd_rpc_txnstatus_t * store ) {
+  ulong                    txn_idx = store->txn_tail % store->txn_max;
+  fd_rpc_txnstatus_txn_t * txn     = &store->txn[ txn_idx ];
+
+  sig_map_idx_remove_fast( store->sig_map, txn_idx, store->txn );
+
+  /* Every posting of the oldest transaction is the oldest posting of
+     its address, i.e. the tail of the list. */
+  for( ulong off=txn->post_off; off<txn->post_off+txn->post_cnt; off++ ) {
+    fd_rpc_txnstatus_post_t * post = &store->post[ off % store->post_max ];
+    if( FD_LIKELY( post->prev!=UINT_MAX ) ) {
+      store->post[ post->prev ].next = UINT_MAX;
+    } else {
+      fd_rpc_txnstatus_group_t * group = &store->group_pool[ post->group ];
+      group_map_idx_remove( store->group_map, &group->addr, ULONG_MAX, store->group_pool );
+      group_pool_ele_release( store->group_pool, group );
+    }
+  }
+
+  fd_rpc_txnstatus_slot_t * e = &store->slot_pool[ txn->slot_idx ];
+  e->txn_cnt--;
+  if( FD_UNLIKELY( !e->txn_cnt && !e->unrooted ) ) fd_rpc_txnstatus_slot_release( store, e );
+
+  store->txn_tail++;
+  store->evict_cnt++;
+}
+
+/* fd_rpc_txnstatus_slot_acquire returns the slot table entry of slot,
+   creating it as an unrooted executing slot if needed, evicting old
+   transactions if the table is full.  Returns NULL if the table is
+   full of unrooted slots. */
+
+static fd_rpc_txnstatus_slot_t *
+fd_rpc_txnstatus_slot_acquire( fd_rpc_txnstatus_t * store,
+                               ulong                slot ) {
+  fd_rpc_txnstatus_slot_t * e = slot_map_ele_query( store->slot_map, &slot, NULL, store->slot_pool );
+  if( FD_LIKELY( e ) ) return e;
+
+  while( FD_UNLIKELY( !slot_pool_free( store->slot_pool ) && store->txn_tail<store->txn_head ) ) fd_rpc_txnstatus_evict( store );
+  if( FD_UNLIKELY( !slot_pool_free( store->slot_pool ) ) ) return NULL;
+
+  e = slot_pool_ele_acquire( store->slot_pool );
+  e->slot       = slot;
+  e->txn_cnt    = 0U;
+  e->state      = FD_RPC_TXNSTATUS_SLOT_EXECUTING;
+  e->unrooted   = 1;
+  e->parent     = ULONG_MAX;
+  e->seq0       = ULONG_MAX;
+  e->seq1       = 0UL;
+  e->insert_cnt = 0U;
+  slot_map_ele_insert( store->slot_map, e, store->slot_pool );
+  unrooted_dlist_ele_push_tail( store->unrooted, e, store->slot_pool );
+  return e;
+}
+
+static int
+fd_rpc_txnstatus_pwrite( int          fd,
+                         void const * buf,
+                         ulong        sz,
+                         ulong        off ) {
+  while( sz ) {
+    long res = pwrite( fd, buf, sz, (off_t)off );
+    if( FD_UNLIKELY( res<0L ) ) return errno;
+    buf  = (uchar const *)buf + res;
+    sz  -= (ulong)res;
+    off += (ulong)res;
+  }
+  return 0;
+}
+
+static int
+fd_rpc_txnstatus_pread( int    fd,
+                        void * buf,
+                        ulong  sz,
+                        ulong  off ) {
+  while( sz ) {
+    long res = pread( fd, buf, sz, (off_t)off );
+    if( FD_UNLIKELY( res<=0L ) ) return res ? errno : EIO;
+    buf  = (uchar *)buf + res;
+    sz  -= (ulong)res;
+    off += (ulong)res;
+  }
+  return 0;
+}
+
+int
+fd_rpc_txnstatus_insert( fd_rpc_txnstatus_t *           store,
+                         ulong                          slot,
+                         ulong                          index_in_slot,
+                         fd_rpc_txnstatus_err_t const * err,
+                         uchar const *                  payload,
+                         ulong                          payload_sz,
+                         fd_txn_t const *               txn ) {
+  if( FD_UNLIKELY( payload_sz>FD_TXN_MTU || !txn->signature_cnt ) ) return 0;
+
+  fd_rpc_txnstatus_sigkey_t sig;
+  memcpy( sig.uc, fd_txn_get_signatures( txn, payload )[ 0 ], 64UL );
+
+  /* A slot replayed again executes the same transactions again */
+  for( ulong i=sig_map_idx_query_const( store->sig_map, &sig, ULONG_MAX, store->txn ); i!=ULONG_MAX; i=sig_map_idx_next_const( i, ULONG_MAX, store->txn ) ) {
+    if( FD_UNLIKELY( store->slot_pool[ store->txn[ i ].slot_idx ].slot==slot ) ) return 0;
+  }
+
+  ulong post_cnt = txn->acct_addr_cnt;
+  ulong rec_sz   = fd_ulong_align_up( sizeof(fd_rpc_txnstatus_rec_hdr_t)+payload_sz, 8UL );
+  ulong rec_off  = store->data_head;
+  if( FD_UNLIKELY( (rec_off % store->data_max)+rec_sz>store->data_max ) ) rec_off += store->data_max - rec_off % store->data_max;
+
+  for(;;) {
+    if( FD_UNLIKELY( store->txn_tail==store->txn_head ) ) break;
+    fd_rpc_txnstatus_txn_t const * oldest = &store->txn[ store->txn_tail % store->txn_max ];
+    int txn_full  = store->txn_head-store->txn_tail>=store->txn_max;
+    int post_full = store->post_head-oldest->post_off+post_cnt>store->post_max;
+    int data_full = rec_off+rec_sz-oldest->rec_off>store->data_max;
+    if( FD_LIKELY( !txn_full && !post_full && !data_full ) ) break;
+    fd_rpc_txnstatus_evict( store );
+  }
+
+  fd_rpc_txnstatus_slot_t * e = fd_rpc_txnstatus_slot_acquire( store, slot );
+  if( FD_UNLIKELY( !e ) ) return 0;
+
+  uchar rec[ FD_RPC_TXNSTATUS_REC_MAX ];
+  fd_rpc_txnstatus_rec_hdr_t * hdr = (fd_rpc_txnstatus_rec_hdr_t *)rec;
+  memset( hdr, 0, sizeof(fd_rpc_txnstatus_rec_hdr_t) );
+  hdr->slot       = slot;
+  hdr->payload_sz = (ushort)payload_sz;
+  memcpy( hdr->sig, sig.uc, 64UL );
+  memcpy( hdr+1, payload, payload_sz );
+  if( FD_UNLIKELY( fd_rpc_txnstatus_pwrite( store->fd, rec, sizeof(fd_rpc_txnstatus_rec_hdr_t)+payload_sz, rec_off % store->data_max ) ) ) return 0;
+
+  ulong                    txn_idx = store->txn_head % store->txn_max;
+  fd_rpc_txnstatus_txn_t * t       = &store->txn[ txn_idx ];
+  t->sig           = sig;
+  t->slot_idx      = (uint)slot_pool_idx( store->slot_pool, e );
+  t->post_cnt      = (uint)post_cnt;
+  t->post_off      = store->post_head;
+  t->rec_off       = rec_off;
+  t->rec_sz        = (uint)rec_sz;
+  t->index_in_slot = (uint)index_in_slot;
+  t->version       = txn->transaction_version;
+  t->err           = *err;
+  sig_map_idx_insert( store->sig_map, txn_idx, store->txn );
+
+  fd_acct_addr_t const * addrs = fd_txn_get_acct_addrs( txn, payload );
+  for( ulong i=0UL; i<post_cnt; i++ ) {
+    fd_rpc_txnstatus_addr_t addr;
+    memcpy( addr.uc, addrs[ i ].b, 32UL );
+    fd_rpc_txnstatus_group_t * group = group_map_ele_query( store->group_map, &addr, NULL, store->group_pool );
+    if( FD_UNLIKELY( !group ) ) {
+      group = group_pool_ele_acquire( store->group_pool ); /* Never more groups than postings */
+      group->addr = addr;
+      group->head = UINT_MAX;
+      group_map_ele_insert( store->group_map, group, store->group_pool );
+    }
+
+    uint                      post_idx = (uint)(store->post_head % store->post_max);
+    fd_rpc_txnstatus_post_t * post     = &store->post[ post_idx ];
+    post->group = (uint)group_pool_idx( store->group_pool, group );
+    post->txn   = (uint)txn_idx;
+    post->next  = group->head;
+    post->prev  = UINT_MAX;
+    if( FD_LIKELY( group->head!=UINT_MAX ) ) store->post[ group->head ].prev = post_idx;
+    group->head = post_idx;
+    store->post_head++;
+  }
+
+  e->txn_cnt++;
+  e->insert_cnt++;
+  e->seq0 = fd_ulong_min( e->seq0, store->txn_head );
+  e->seq1 = store->txn_head+1UL;
+  store->txn_head++;
+  store->data_head = rec_off+rec_sz;
+  return 1;
+}
+
+void
+fd_rpc_txnstatus_slot_completed( fd_rpc_txnstatus_t * store,
+                                 ulong                slot,
+                                 ulong                parent_slot ) {
+  fd_rpc_txnstatus_slot_t * e = fd_rpc_txnstatus_slot_acquire( store, slot );
+  if( FD_UNLIKELY( !e || !e->unrooted ) ) return; /* Rooted, or abandoned by the root already */
+  e->state  = FD_RPC_TXNSTATUS_SLOT_COMPLETED;
+  e->parent = parent_slot;
+}
+
+void
+fd_rpc_txnstatus_slot_dead( fd_rpc_txnstatus_t * store,
+                            ulong                slot ) {
+  fd_rpc_txnstatus_slot_t * e = slot_map_ele_query( store->slot_map, &slot, NULL, store->slot_pool );
+  if( FD_LIKELY( e && e->state!=FD_RPC_TXNSTATUS_SLOT_ROOTED ) ) e->state = FD_RPC_TXNSTATUS_SLOT_DEAD;
+}
+
+void
+fd_rpc_txnstatus_root( fd_rpc_txnstatus_t * store,
+                       ulong                root_slot ) {
+  /* The new root and its ancestors up to the previous root */
+  ulong slot = root_slot;
+  for(;;) {
+    fd_rpc_txnstatus_slot_t * e = slot_map_ele_query( store->slot_map, &slot, NULL, store->slot_pool );
+    if( FD_UNLIKELY( !e || e->state==FD_RPC_TXNSTATUS_SLOT_ROOTED ) ) break;
+    unrooted_dlist_ele_remove( store->unrooted, e, store->slot_pool );
+    e->unrooted = 0;
+    e->state    = FD_RPC_TXNSTATUS_SLOT_ROOTED;
+    slot          = e->parent;
+    if( FD_UNLIKELY( !e->txn_cnt ) ) fd_rpc_txnstatus_slot_release( store, e );
+  }
+
+  /* Every other slot up to the root, and every newer slot not
+     descending from the root, was abandoned.  Slots whose ancestry is
+     not fully known yet are kept. */
+  for( unrooted_dlist_iter_t iter = unrooted_dlist_iter_fwd_init( store->unrooted, store->slot_pool );
+       !unrooted_dlist_iter_done( iter, store->unrooted, store->slot_pool ); ) {
+    fd_rpc_txnstatus_slot_t * e = unrooted_dlist_iter_ele( iter, store->unrooted, store->slot_pool );
+    iter = unrooted_dlist_iter_fwd_next( iter, store->unrooted, store->slot_pool );
+    if( FD_LIKELY( e->slot>root_slot ) ) {
+      ulong s = e->slot;
+      while( s!=ULONG_MAX && s>root_slot ) {
+        fd_rpc_txnstatus_slot_t const * a = slot_map_ele_query_const( store->slot_map, &s, NULL, store->slot_pool );
+        s = a ? a->parent : ULONG_MAX;
+      }
+      if( FD_LIKELY( s==root_slot || s==ULONG_MAX ) ) continue;
+    }
+    unrooted_dlist_ele_remove( store->unrooted, e, store->slot_pool );
+    e->unrooted = 0;
+    e->state    = FD_RPC_TXNSTATUS_SLOT_DEAD;
+    if( FD_UNLIKELY( !e->txn_cnt ) ) fd_rpc_txnstatus_slot_release( store, e );
+  }
+}
+
+ulong
+fd_rpc_txnstatus_slot_txns( fd_rpc_txnstatus_t const * store,
+                            ulong                      slot,
+                            ulong *                    txn_idx,
+                            ulong                      txn_idx_max ) {
+  fd_rpc_txnstatus_slot_t const * e = slot_map_ele_query_const( store->slot_map, &slot, NULL, store->slot_pool );
+  if( FD_UNLIKELY( !e || e->txn_cnt!=e->insert_cnt || e->txn_cnt>txn_idx_max ) ) return ULONG_MAX;
+
+  /* Transactions of concurrently replayed slots are interleaved */
+  ulong slot_idx = slot_pool_idx( store->slot_pool, e );
+  ulong cnt      = 0UL;
+  for( ulong seq=fd_ulong_max( e->seq0, store->txn_tail ); seq<e->seq1 && cnt<e->txn_cnt; seq++ ) {
+    ulong i = seq % store->txn_max;
+    if( store->txn[ i ].slot_idx==slot_idx ) txn_idx[ cnt++ ] = i;
+  }
+  return cnt;
+}
+
+/* fd_rpc_txnstatus_on_fork returns 1 if slot is tip or one of its
+   unrooted ancestors. */
+
+static int
+fd_rpc_txnstatus_on_fork( fd_rpc_txnstatus_t const * store,
+                          ulong                      slot,
+                          ulong                      tip ) {
+  while( tip!=ULONG_MAX && tip>slot ) {
+    fd_rpc_txnstatus_slot_t const * e = slot_map_ele_query_const( store->slot_map, &tip, NULL, store->slot_pool );
+    if( FD_UNLIKELY( !e || e->state==FD_RPC_TXNSTATUS_SLOT_ROOTED ) ) return 0;
+    tip = e->parent;
+  }
+  return tip==slot;
+}
+
+int
+fd_rpc_txnstatus_conf( fd_rpc_txnstatus_t const * store,
+                       ulong                      txn_idx,
+                       ulong                      processed_slot,
+                       ulong                      confirmed_slot ) {
+  fd_rpc_txnstatus_slot_t const * e = &store->slot_pool[ store->txn[ txn_idx ].slot_idx ];
+  if( FD_LIKELY( e->state==FD_RPC_TXNSTATUS_SLOT_ROOTED    ) ) return FD_RPC_TXNSTATUS_CONF_FINALIZED;
+  if( FD_UNLIKELY( e->state!=FD_RPC_TXNSTATUS_SLOT_COMPLETED ) ) return FD_RPC_TXNSTATUS_CONF_NONE;
+  if( fd_rpc_txnstatus_on_fork( store, e->slot, confirmed_slot ) ) return FD_RPC_TXNSTATUS_CONF_CONFIRMED;
+  if( fd_rpc_txnstatus_on_fork( store, e->slot, processed_slot ) ) return FD_RPC_TXNSTATUS_CONF_PROCESSED;
+  return FD_RPC_TXNSTATUS_CONF_NONE;
+}
+
+ulong
+fd_rpc_txnstatus_sig_query( fd_rpc_txnstatus_t const * store,
+                            uchar const                sig[ 64 ] ) {
+  fd_rpc_txnstatus_sigkey_t key;
+  memcpy( key.uc, sig, 64UL );
+  return sig_map_idx_query_const( store->sig_map, &key, FD_RPC_TXNSTATUS_IDX_NULL, store->txn );
+}
+
+ulong
+fd_rpc_txnstatus_sig_next( fd_rpc_txnstatus_t const * store,
+                           ulong                      txn_idx ) {
+  return sig_map_idx_next_const( txn_idx, FD_RPC_TXNSTATUS_IDX_NULL, store->txn );
+}
+
+ulong
+fd_rpc_txnstatus_addr_query( fd_rpc_txnstatus_t const * store,
+                             uchar const                addr[ 32 ] ) {
+  fd_rpc_txnstatus_addr_t key;
+  memcpy( key.uc, addr, 32UL );
+  fd_rpc_txnstatus_group_t const * group = group_map_ele_query_const( store->group_map, &key, NULL, store->group_pool );
+  return group ? (ulong)group->head : FD_RPC_TXNSTATUS_IDX_NULL;
+}
+
+ulong
+fd_rpc_txnstatus_addr_next( fd_rpc_txnstatus_t const * store,
+                            ulong                      post_idx ) {
+  uint next = store->post[ post_idx ].next;
+  return next==UINT_MAX ? FD_RPC_TXNSTATUS_IDX_NULL : (ulong)next;
+}
+
+ulong
+fd_rpc_txnstatus_post_txn( fd_rpc_txnstatus_t const * store,
+                           ulong                      post_idx ) {
+  return (ulong)store->post[ post_idx ].txn;
+}
+
+uchar const *
+fd_rpc_txnstatus_sig( fd_rpc_txnstatus_t const * store,
+                      ulong                      txn_idx ) {
+  return store->txn[ txn_idx ].sig.uc;
+}
+
+ulong
+fd_rpc_txnstatus_slot( fd_rpc_txnstatus_t const * store,
+                       ulong                      txn_idx ) {
+  return store->slot_pool[ store->txn[ txn_idx ].slot_idx ].slot;
+}
+
+ulong
+fd_rpc_txnstatus_index_in_slot( fd_rpc_txnstatus_t const * store,
+                                ulong                      txn_idx ) {
+  return (ulong)store->txn[ txn_idx ].index_in_slot;
+}
+
+int
+fd_rpc_txnstatus_version( fd_rpc_txnstatus_t const * store,
+                          ulong                      txn_idx ) {
+  return store->txn[ txn_idx ].version;
+}
+
+fd_rpc_txnstatus_err_t const *
+fd_rpc_txnstatus_err( fd_rpc_txnstatus_t const * store,
+                      ulong                      txn_idx ) {
+  return &store->txn[ txn_idx ].err;
+}
+
+ulong
+fd_rpc_txnstatus_read( fd_rpc_txnstatus_t const * store,
+                       ulong                      txn_idx,
+                       uchar                      payload[ FD_TXN_MTU ] ) {
+  fd_rpc_txnstatus_txn_t const * t = &store->txn[ txn_idx ];
+
+  uchar rec[ FD_RPC_TXNSTATUS_REC_MAX ];
+  ulong sz = fd_ulong_min( t->rec_sz, FD_RPC_TXNSTATUS_REC_MAX );
+  if( FD_UNLIKELY( fd_rpc_txnstatus_pread( store->fd, rec, sz, t->rec_off % store->data_max ) ) ) return 0UL;
+
+  fd_rpc_txnstatus_rec_hdr_t const * hdr = (fd_rpc_txnstatus_rec_hdr_t const *)rec;
+  if( FD_UNLIKELY( hdr->slot!=fd_rpc_txnstatus_slot( store, txn_idx ) ||
+                   memcmp( hdr->sig, t->sig.uc, 64UL ) ||
+                   sizeof(fd_rpc_txnstatus_rec_hdr_t)+hdr->payload_sz>sz ) ) {
+    return 0UL;
+  }
+  memcpy( payload, hdr+1, hdr->payload_sz );
+  return (ulong)hdr->payload_sz;
+}
+
+ulong
+fd_rpc_txnstatus_txn_max( fd_rpc_txnstatus_t const * store ) {
+  return store->txn_max;
+}
+
+ulong
+fd_rpc_txnstatus_txn_cnt( fd_rpc_txnstatus_t const * store ) {
+  return store->txn_head-store->txn_tail;
+}
+
+ulong
+fd_rpc_txnstatus_evict_cnt( fd_rpc_txnstatus_t const * store ) {
+  return store->evict_cnt;
+}
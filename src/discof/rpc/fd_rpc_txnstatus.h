@@ -0,0 +1,234 @@
+#ifndef HEADER_fd_src_discof_rpc_fd_rpc_txnstatus_h
+#define HEADER_fd_src_discof_rpc_fd_rpc_txnstatus_h
+
+/* fd_rpc_txnstatus is the RPC tile's transaction status store.  It
+   keeps the most recent executed transactions, so that
+   getTransaction, getSignatureStatuses and getSignaturesForAddress can
+   be answered without a ledger.
+
+   The raw transactions are appended to a file-backed byte ring of
+   variable size records, one per transaction, and are only read back
+   by getTransaction.  Everything needed to find and filter transactions
+   is kept in memory, in a FIFO of transaction slots (txn_idx below):
+
+     - a signature map, from the first signature of a transaction to
+       every stored copy of it (a transaction can execute on several
+       forks),
+
+     - an address map, from every static account key of a transaction
+       to a list of postings, newest first, and
+
+     - a slot table, recording the parent and the state of each slot
+       with stored transactions or that is not yet rooted, which is
+       what makes answers fork aware.
+
+   Retention is bounded by the number of transactions, postings and
+   ring bytes.  Running out of any of them evicts the oldest
+   transaction, along with its postings and its record, which are
+   always the oldest ones since everything is kept in insertion
+   order.
+
+   Transactions are stored as they execute, on any fork.  Whether a
+   stored transaction is visible at a given commitment is decided at
+   query time: a transaction in a rooted slot is finalized, and one in
+   a completed slot is confirmed or processed if its slot is an
+   ancestor of (or is) the confirmed or processed slot.
+
+   Slots are assumed to have a single block version.  Nothing is
+   recovered across restarts: the ring file is truncated on startup.
+
+   The store is private to a single tile and not thread safe. */
+
+#include "../../util/fd_util_base.h"
+#include "../../ballet/txn/fd_txn.h"
+
+#define FD_RPC_TXNSTATUS_IDX_NULL (ULONG_MAX)
+
+/* FD_RPC_TXNSTATUS_POST_PER_TXN is the average number of address
+   postings budgeted per stored transaction.  Transactions referencing
+   more accounts than this evict correspondingly more old
+   transactions. */
+
+#define FD_RPC_TXNSTATUS_POST_PER_TXN (16UL)
+
+/* FD_RPC_TXNSTATUS_DATA_PER_TXN is the average number of ring file
+   bytes budgeted per stored transaction, including the record header.
+   Vote transactions take about 300 bytes. */
+
+#define FD_RPC_TXNSTATUS_DATA_PER_TXN (640UL)
+
+/* Commitment level a stored transaction is visible at, from the least
+   to the most committed. */
+
+#define FD_RPC_TXNSTATUS_CONF_NONE      (0) /* Not on the processed fork, or slot still executing or dead */
+#define FD_RPC_TXNSTATUS_CONF_PROCESSED (1)
+#define FD_RPC_TXNSTATUS_CONF_CONFIRMED (2)
+#define FD_RPC_TXNSTATUS_CONF_FINALIZED (3)
+
+/* Execution result of a stored transaction. */
+
+struct fd_rpc_txnstatus_err {
+  int  txn_err;    /* FD_RUNTIME_TXN_ERR_*, zero on success */
+  int  instr_err;  /* FD_EXECUTOR_INSTR_ERR_* if txn_err is FD_RUNTIME_TXN_ERR_INSTRUCTION_ERROR */
+  uint instr_idx;  /* Index of the failed instruction, ditto */
+  uint custom_err; /* Program error code if instr_err is FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR */
+};
+
+typedef struct fd_rpc_txnstatus_err fd_rpc_txnstatus_err_t;
+
+struct fd_rpc_txnstatus_private;
+typedef struct fd_rpc_txnstatus_private fd_rpc_txnstatus_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST ulong
+fd_rpc_txnstatus_align( void );
+
+/* fd_rpc_txnstatus_footprint returns the footprint of a store keeping
+   up to txn_max transactions, tracking up to slot_max slots at once.
+   slot_max must cover the slots that are not rooted yet, and should
+   be large enough that txn_max/slot_max is below the typical number
+   of transactions per slot, as running out of slots evicts
+   transactions early. */
+
+FD_FN_CONST ulong
+fd_rpc_txnstatus_footprint( ulong txn_max,
+                            ulong slot_max );
+
+/* fd_rpc_txnstatus_new formats a memory region for use as a store
+   backed by the file at file_path, which is created if needed and
+   truncated to txn_max*FD_RPC_TXNSTATUS_DATA_PER_TXN bytes (sparse).
+   Returns NULL on failure, including if the file cannot be opened.
+   fd_rpc_txnstatus_join joins it. */
+
+void *
+fd_rpc_txnstatus_new( void *       shmem,
+                      ulong        txn_max,
+                      ulong        slot_max,
+                      char const * file_path,
+                      ulong        seed );
+
+fd_rpc_txnstatus_t *
+fd_rpc_txnstatus_join( void * shstore );
+
+/* fd_rpc_txnstatus_fd returns the file descriptor of the ring file. */
+
+int
+fd_rpc_txnstatus_fd( fd_rpc_txnstatus_t const * store );
+
+/* fd_rpc_txnstatus_insert stores transaction txn, with raw bytes
+   payload, which executed at index_in_slot of slot with result err.
+   Returns 1 if stored.  Returns 0 if not, either because it is already
+   stored for this slot (the slot was replayed again) or because it
+   could not be (the slot table is full of unrooted slots, or the ring
+   file could not be written). */
+
+int
+fd_rpc_txnstatus_insert( fd_rpc_txnstatus_t *           store,
+                         ulong                          slot,
+                         ulong                          index_in_slot,
+                         fd_rpc_txnstatus_err_t const * err,
+                         uchar const *                  payload,
+                         ulong                          payload_sz,
+                         fd_txn_t const *               txn );
+
+/* fd_rpc_txnstatus_slot_completed records that slot, a child of
+   parent_slot, finished replaying successfully.
+   fd_rpc_txnstatus_slot_dead records that slot was marked dead; its
+   transactions are never visible unless it completes later. */
+
+void
+fd_rpc_txnstatus_slot_completed( fd_rpc_txnstatus_t * store,
+                                 ulong                slot,
+                                 ulong                parent_slot );
+
+void
+fd_rpc_txnstatus_slot_dead( fd_rpc_txnstatus_t * store,
+                            ulong                slot );
+
+/* fd_rpc_txnstatus_root records that root_slot, and hence its
+   ancestors, are rooted.  Every other slot not newer than root_slot is
+   on an abandoned fork and its transactions are never visible. */
+
+void
+fd_rpc_txnstatus_root( fd_rpc_txnstatus_t * store,
+                       ulong                root_slot );
+
+/* fd_rpc_txnstatus_slot_txns writes the stored transactions of slot,
+   in insertion order, to txn_idx and returns their number.  Returns
+   ULONG_MAX if the slot is unknown (its entry was released, which
+   happens once it is rooted with no transactions, so call this before
+   fd_rpc_txnstatus_root), if some of its transactions were evicted, or
+   if there are more than txn_idx_max of them. */
+
+ulong
+fd_rpc_txnstatus_slot_txns( fd_rpc_txnstatus_t const * store,
+                            ulong                      slot,
+                            ulong *                    txn_idx,
+                            ulong                      txn_idx_max );
+
+/* fd_rpc_txnstatus_conf returns the FD_RPC_TXNSTATUS_CONF_* level
+   stored transaction txn_idx is visible at, given the current
+   processed and confirmed slots (ULONG_MAX if unknown). */
+
+int
+fd_rpc_txnstatus_conf( fd_rpc_txnstatus_t const * store,
+                       ulong                      txn_idx,
+                       ulong                      processed_slot,
+                       ulong                      confirmed_slot );
+
+/* fd_rpc_txnstatus_sig_{query,next} iterate over the stored copies of
+   the transaction with the given first signature, newest first.
+   Returns FD_RPC_TXNSTATUS_IDX_NULL at the end. */
+
+ulong
+fd_rpc_txnstatus_sig_query( fd_rpc_txnstatus_t const * store,
+                            uchar const                sig[ 64 ] );
+
+ulong
+fd_rpc_txnstatus_sig_next( fd_rpc_txnstatus_t const * store,
+                           ulong                      txn_idx );
+
+/* fd_rpc_txnstatus_addr_{query,next} iterate over the postings of an
+   address, newest first, and fd_rpc_txnstatus_post_txn returns the
+   stored transaction of a posting.  Returns FD_RPC_TXNSTATUS_IDX_NULL
+   at the end. */
+
+ulong
+fd_rpc_txnstatus_addr_query( fd_rpc_txnstatus_t const * store,
+                             uchar const                addr[ 32 ] );
+
+ulong
+fd_rpc_txnstatus_addr_next( fd_rpc_txnstatus_t const * store,
+                            ulong                      post_idx );
+
+ulong
+fd_rpc_txnstatus_post_txn( fd_rpc_txnstatus_t const * store,
+                           ulong                      post_idx );
+
+/* Accessors for stored transaction txn_idx.  fd_rpc_txnstatus_version
+   returns the FD_TXN_V* transaction version. */
+
+uchar const *                  fd_rpc_txnstatus_sig          ( fd_rpc_txnstatus_t const * store, ulong txn_idx );
+ulong                          fd_rpc_txnstatus_slot         ( fd_rpc_txnstatus_t const * store, ulong txn_idx );
+ulong                          fd_rpc_txnstatus_index_in_slot( fd_rpc_txnstatus_t const * store, ulong txn_idx );
+int                            fd_rpc_txnstatus_version      ( fd_rpc_txnstatus_t const * store, ulong txn_idx );
+fd_rpc_txnstatus_err_t const * fd_rpc_txnstatus_err          ( fd_rpc_txnstatus_t const * store, ulong txn_idx );
+
+/* fd_rpc_txnstatus_read reads the raw bytes of stored transaction
+   txn_idx from the ring file into payload.  Returns the payload size
+   on success, or 0 on failure (I/O error, or a record that does not
+   match the in-memory index). */
+
+ulong
+fd_rpc_txnstatus_read( fd_rpc_txnstatus_t const * store,
+                       ulong                      txn_idx,
+                       uchar                      payload[ FD_TXN_MTU ] );
+
+ulong fd_rpc_txnstatus_txn_max  ( fd_rpc_txnstatus_t const * store );
+ulong fd_rpc_txnstatus_txn_cnt  ( fd_rpc_txnstatus_t const * store );
+ulong fd_rpc_txnstatus_evict_cnt( fd_rpc_txnstatus_t const * store );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_discof_rpc_fd_rpc_txnstatus_h */
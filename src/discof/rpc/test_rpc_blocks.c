@@ -0,0 +1,160 @@
+#define _GNU_SOURCE
+#include "fd_rpc_blocks.h"
+#include <unistd.h>
+
+#define TEST_FILE   "/tmp/test_rpc_blocks.bin"
+#define BLOCK_MAX   (8UL)
+#define PENDING_MAX (16UL)
+#define CACHE_SZ    (FD_RPC_BLOCKS_CACHE_CNT*256UL)
+
+static uchar blocks_mem[ 4UL<<20 ] __attribute__((aligned(128UL)));
+
+static void
+completed( fd_rpc_blocks_t * blocks,
+           ulong             slot,
+           ulong             parent_slot ) {
+  fd_rpc_block_t b = {
+    .slot         = slot,
+    .parent_slot  = parent_slot,
+    .block_height = slot/2UL,
+    .block_time   = (long)slot*10L,
+  };
+  memset( b.blockhash, (int)slot, 32UL );
+  FD_TEST( fd_rpc_blocks_slot_completed( blocks, &b ) );
+}
+
+/* archive appends block b with txn_cnt transactions, the j-th being j+1
+   bytes of value slot+j. */
+
+static void
+archive( fd_rpc_blocks_t *      blocks,
+         fd_rpc_block_t const * b,
+         ulong                  txn_cnt ) {
+  uchar payload[ FD_TXN_MTU ];
+  FD_TEST( fd_rpc_blocks_append_begin( blocks, b, txn_cnt ) );
+  for( ulong j=0UL; j<txn_cnt; j++ ) {
+    memset( payload, (int)(b->slot+j), j+1UL );
+    fd_rpc_blocks_append_txn( blocks, payload, j+1UL );
+  }
+  FD_TEST( fd_rpc_blocks_append_end( blocks ) );
+}
+
+static void
+check_txns( fd_rpc_blocks_t * blocks,
+            ulong             slot,
+            ulong             txn_cnt ) {
+  ulong idx = fd_rpc_blocks_query( blocks, slot );
+  FD_TEST( idx!=FD_RPC_BLOCKS_IDX_NULL );
+  FD_TEST( fd_rpc_blocks_block( blocks, idx )->txn_cnt==txn_cnt );
+  FD_TEST( fd_rpc_blocks_iter_init( blocks, idx ) );
+  ulong sz;
+  for( ulong j=0UL; j<txn_cnt; j++ ) {
+    uchar const * payload = fd_rpc_blocks_iter_next( blocks, &sz );
+    FD_TEST( payload && sz==j+1UL );
+    for( ulong k=0UL; k<sz; k++ ) FD_TEST( payload[ k ]==(uchar)(slot+j) );
+  }
+  FD_TEST( !fd_rpc_blocks_iter_next( blocks, &sz ) );
+}
+
+static void
+test_blocks( void ) {
+  FD_TEST( !fd_rpc_blocks_footprint( 0UL, PENDING_MAX, CACHE_SZ ) );
+  FD_TEST( !fd_rpc_blocks_footprint( BLOCK_MAX, 0UL, CACHE_SZ ) );
+  FD_TEST( fd_rpc_blocks_footprint( BLOCK_MAX, PENDING_MAX, CACHE_SZ )<=sizeof(blocks_mem) );
+  FD_TEST( !fd_rpc_blocks_new( blocks_mem, BLOCK_MAX, PENDING_MAX, CACHE_SZ, "/nonexistent/blocks.bin", 1UL ) );
+
+  fd_rpc_blocks_t * blocks = fd_rpc_blocks_join( fd_rpc_blocks_new( blocks_mem, BLOCK_MAX, PENDING_MAX, CACHE_SZ, TEST_FILE, 1234UL ) );
+  FD_TEST( blocks );
+  FD_TEST( fd_rpc_blocks_first( blocks )==ULONG_MAX );
+  FD_TEST( fd_rpc_blocks_query( blocks, 10UL )==FD_RPC_BLOCKS_IDX_NULL );
+
+  /* 10 <- 11 <- 13 on the main fork, 12 on a fork off 10 */
+  completed( blocks, 10UL, 9UL  );
+  completed( blocks, 11UL, 10UL );
+  completed( blocks, 12UL, 10UL );
+  completed( blocks, 13UL, 11UL );
+
+  fd_rpc_block_t const * rooted;
+  FD_TEST( fd_rpc_blocks_root( blocks, 11UL, &rooted )==2UL );
+  FD_TEST( rooted[ 0 ].slot==10UL && rooted[ 1 ].slot==11UL );
+  FD_TEST( rooted[ 1 ].prev_blockhash[ 0 ]==10 );
+  FD_TEST( rooted[ 0 ].prev_blockhash[ 0 ]==0 );
+  archive( blocks, &rooted[ 0 ], 3UL );
+  archive( blocks, &rooted[ 1 ], 0UL );
+
+  /* 12 was abandoned */
+  FD_TEST( fd_rpc_blocks_root( blocks, 13UL, &rooted )==1UL );
+  FD_TEST( rooted[ 0 ].slot==13UL );
+  FD_TEST( rooted[ 0 ].prev_blockhash[ 0 ]==11 );
+  fd_rpc_blocks_append_missing( blocks, &rooted[ 0 ] );
+  FD_TEST( fd_rpc_blocks_missing_cnt( blocks )==1UL );
+
+  FD_TEST( fd_rpc_blocks_first( blocks )==10UL );
+  FD_TEST( fd_rpc_blocks_last ( blocks )==13UL );
+  FD_TEST( fd_rpc_blocks_block_cnt( blocks )==3UL );
+  FD_TEST( fd_rpc_blocks_query( blocks, 12UL )==FD_RPC_BLOCKS_IDX_NULL );
+  ulong idx = fd_rpc_blocks_lower_bound( blocks, 12UL );
+  FD_TEST( fd_rpc_blocks_block( blocks, idx )->slot==13UL );
+  FD_TEST( fd_rpc_blocks_block( blocks, idx )->block_time==130L );
+  FD_TEST( fd_rpc_blocks_next( blocks, idx )==FD_RPC_BLOCKS_IDX_NULL );
+  FD_TEST( fd_rpc_blocks_lower_bound( blocks, 14UL )==FD_RPC_BLOCKS_IDX_NULL );
+
+  check_txns( blocks, 10UL, 3UL );
+  check_txns( blocks, 11UL, 0UL );
+  FD_TEST( !fd_rpc_blocks_iter_init( blocks, fd_rpc_blocks_query( blocks, 13UL ) ) );
+
+  /* Too many transactions to archive */
+  fd_rpc_block_t big = { .slot = 14UL };
+  FD_TEST( !fd_rpc_blocks_append_begin( blocks, &big, FD_RPC_BLOCKS_TXN_MAX+1UL ) );
+
+  /* Fewer transactions than announced archives the block without them */
+  uchar payload[ 8 ] = { 0 };
+  FD_TEST( fd_rpc_blocks_append_begin( blocks, &big, 2UL ) );
+  fd_rpc_blocks_append_txn( blocks, payload, 8UL );
+  FD_TEST( !fd_rpc_blocks_append_end( blocks ) );
+  FD_TEST( fd_rpc_blocks_block( blocks, fd_rpc_blocks_query( blocks, 14UL ) )->txn_cnt==UINT_MAX );
+
+  /* Filling the archive evicts the oldest blocks, and large blocks
+     (the ring file is BLOCK_MAX MiB) evict more of them */
+  for( ulong slot=15UL; slot<15UL+4UL*BLOCK_MAX; slot++ ) {
+    fd_rpc_block_t b = { .slot = slot, .parent_slot = slot-1UL };
+    archive( blocks, &b, slot%7UL ? 50UL : 1000UL );
+    FD_TEST( fd_rpc_blocks_block_cnt( blocks )<=BLOCK_MAX );
+    FD_TEST( fd_rpc_blocks_last( blocks )==slot );
+  }
+  FD_TEST( fd_rpc_blocks_query( blocks, 10UL )==FD_RPC_BLOCKS_IDX_NULL );
+  for( ulong slot=fd_rpc_blocks_first( blocks ); slot<15UL+4UL*BLOCK_MAX; slot++ ) {
+    check_txns( blocks, slot, slot%7UL ? 50UL : 1000UL );
+  }
+
+  /* Response cache */
+  ulong sz;
+  uchar resp[ 256 ];
+  memset( resp, 'x', sizeof(resp) );
+  FD_TEST( !fd_rpc_blocks_cache_query( blocks, 20UL, 0UL, &sz ) );
+  for( ulong i=0UL; i<FD_RPC_BLOCKS_CACHE_CNT; i++ ) fd_rpc_blocks_cache_insert( blocks, 20UL+i, 0UL, resp, i+1UL );
+  FD_TEST( fd_rpc_blocks_cache_query( blocks, 20UL, 0UL, &sz ) && sz==1UL ); /* 21 is now the LRU */
+  FD_TEST( !fd_rpc_blocks_cache_query( blocks, 20UL, 1UL, &sz ) );
+  fd_rpc_blocks_cache_insert( blocks, 99UL, 1UL, resp, 256UL );
+  FD_TEST( !fd_rpc_blocks_cache_query( blocks, 21UL, 0UL, &sz ) );
+  FD_TEST( fd_rpc_blocks_cache_query( blocks, 99UL, 1UL, &sz ) && sz==256UL );
+  fd_rpc_blocks_cache_insert( blocks, 98UL, 0UL, resp, 257UL ); /* Too large */
+  FD_TEST( !fd_rpc_blocks_cache_query( blocks, 98UL, 0UL, &sz ) );
+  FD_TEST( fd_rpc_blocks_cache_hit ( blocks )==2UL );
+  FD_TEST( fd_rpc_blocks_cache_miss( blocks )==4UL );
+
+  close( fd_rpc_blocks_fd( blocks ) );
+  unlink( TEST_FILE );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  test_blocks();
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
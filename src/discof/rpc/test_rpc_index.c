@@ -0,0 +1,177 @@
+#include "fd_rpc_index.h"
+#include "../../flamenco/runtime/fd_system_ids.h"
+
+#define ELE_MAX (64UL)
+
+static uchar index_mem[ 1UL<<20 ] __attribute__((aligned(128UL)));
+
+static void
+token_account( uchar       data[ FD_RPC_INDEX_TOKEN_ACCOUNT_SZ ],
+               uchar       mint,
+               uchar       owner,
+               uchar       delegate ) {
+  memset( data, 0, FD_RPC_INDEX_TOKEN_ACCOUNT_SZ );
+  memset( data+FD_RPC_INDEX_TOKEN_MINT_OFF,  mint,  32UL );
+  memset( data+FD_RPC_INDEX_TOKEN_OWNER_OFF, owner, 32UL );
+  if( delegate ) {
+    FD_STORE( uint, data+FD_RPC_INDEX_TOKEN_DELEGATE_OFF, 1U );
+    memset( data+FD_RPC_INDEX_TOKEN_DELEGATE_OFF+4UL, delegate, 32UL );
+  }
+  data[ FD_RPC_INDEX_TOKEN_STATE_OFF ] = 1; /* Initialized */
+}
+
+static ulong
+query_cnt( fd_rpc_index_t * index,
+           int              kind,
+           uchar            key_byte ) {
+  uchar key[ 32 ]; memset( key, key_byte, 32UL );
+  ulong cnt = 0UL;
+  for( ulong i=fd_rpc_index_head( index, kind, key ); i!=FD_RPC_INDEX_IDX_NULL; i=fd_rpc_index_next( index, i ) ) {
+    FD_TEST( fd_rpc_index_live( index, i ) );
+    FD_TEST( fd_rpc_index_kind( index, i )==kind );
+    FD_TEST( !memcmp( fd_rpc_index_key( index, i ), key, 32UL ) );
+    cnt++;
+  }
+  return cnt;
+}
+
+static void
+test_keys( void ) {
+  uchar keys[ FD_RPC_INDEX_KIND_CNT ][ 32 ];
+  uchar data[ 400 ];
+  uchar owner[ 32 ]; memset( owner, 9, 32UL );
+
+  FD_TEST( fd_rpc_index_keys( owner, NULL, 0UL, keys )==(1U<<FD_RPC_INDEX_KIND_PROGRAM) );
+  FD_TEST( !memcmp( keys[ FD_RPC_INDEX_KIND_PROGRAM ], owner, 32UL ) );
+
+  token_account( data, 1, 2, 0 );
+  FD_TEST( fd_rpc_index_keys( owner, data, FD_RPC_INDEX_TOKEN_ACCOUNT_SZ, keys )==(1U<<FD_RPC_INDEX_KIND_PROGRAM) );
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_id.uc, data, FD_RPC_INDEX_TOKEN_ACCOUNT_SZ, keys )==0x7U );
+  FD_TEST( keys[ FD_RPC_INDEX_KIND_TOKEN_MINT  ][ 31 ]==1 );
+  FD_TEST( keys[ FD_RPC_INDEX_KIND_TOKEN_OWNER ][ 0  ]==2 );
+
+  token_account( data, 1, 2, 3 );
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_id.uc, data, FD_RPC_INDEX_TOKEN_ACCOUNT_SZ, keys )==0xfU );
+  FD_TEST( keys[ FD_RPC_INDEX_KIND_TOKEN_DELEGATE ][ 0 ]==3 );
+  FD_TEST( fd_rpc_index_matches( FD_RPC_INDEX_KIND_TOKEN_DELEGATE, keys[ FD_RPC_INDEX_KIND_TOKEN_DELEGATE ], fd_solana_spl_token_id.uc, data, FD_RPC_INDEX_TOKEN_ACCOUNT_SZ ) );
+
+  /* Uninitialized, wrong size, and Token-2022 extension layouts */
+  data[ FD_RPC_INDEX_TOKEN_STATE_OFF ] = 0;
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_id.uc, data, FD_RPC_INDEX_TOKEN_ACCOUNT_SZ, keys )==1U );
+  data[ FD_RPC_INDEX_TOKEN_STATE_OFF ] = 1;
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_id.uc, data, 166UL, keys )==1U );
+
+  memset( data+FD_RPC_INDEX_TOKEN_ACCOUNT_SZ, 0, sizeof(data)-FD_RPC_INDEX_TOKEN_ACCOUNT_SZ );
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_2022_id.uc, data, 200UL, keys )==1U );
+  data[ FD_RPC_INDEX_TOKEN_ACCOUNT_SZ ] = 2;
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_2022_id.uc, data, 200UL, keys )==0xfU );
+  FD_TEST( fd_rpc_index_keys( fd_solana_spl_token_2022_id.uc, data, FD_RPC_INDEX_TOKEN_MULTISIG_SZ, keys )==1U );
+}
+
+static void
+test_index( void ) {
+  FD_TEST( fd_rpc_index_footprint( ELE_MAX )<=sizeof(index_mem) );
+  FD_TEST( !fd_rpc_index_footprint( 0UL ) );
+  fd_rpc_index_t * index = fd_rpc_index_join( fd_rpc_index_new( index_mem, ELE_MAX, 1234UL ) );
+  FD_TEST( index );
+  FD_TEST( fd_rpc_index_ele_max( index )==ELE_MAX );
+
+  uchar prog_a[ 32 ]; memset( prog_a, 0xa, 32UL );
+  uchar prog_b[ 32 ]; memset( prog_b, 0xb, 32UL );
+  uchar pubkey[ 32 ] = { 0 };
+
+  /* Ten accounts owned by A, then five of them reassigned to B on some
+     fork.  Both pairs are kept for the reassigned accounts. */
+  for( ulong i=0UL; i<10UL; i++ ) {
+    pubkey[ 0 ] = (uchar)i;
+    FD_TEST( !fd_rpc_index_insert( index, pubkey, prog_a, NULL, 0UL, 100UL ) );
+  }
+  for( ulong i=0UL; i<5UL; i++ ) {
+    pubkey[ 0 ] = (uchar)i;
+    FD_TEST( !fd_rpc_index_insert( index, pubkey, prog_b, NULL, 0UL, 101UL ) );
+  }
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_PROGRAM, 0xa )==10UL );
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_PROGRAM, 0xb )==5UL  );
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_PROGRAM, 0xc )==0UL  );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==15UL );
+
+  /* Re-inserting only raises the slot */
+  pubkey[ 0 ] = 7;
+  FD_TEST( !fd_rpc_index_insert( index, pubkey, prog_a, NULL, 0UL, 105UL ) );
+  FD_TEST( !fd_rpc_index_insert( index, pubkey, prog_a, NULL, 0UL, 103UL ) );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==15UL );
+  ulong found = 0UL;
+  for( ulong i=fd_rpc_index_head( index, FD_RPC_INDEX_KIND_PROGRAM, prog_a ); i!=FD_RPC_INDEX_IDX_NULL; i=fd_rpc_index_next( index, i ) ) {
+    if( fd_rpc_index_pubkey( index, i )[ 0 ]==7 ) { FD_TEST( fd_rpc_index_slot( index, i )==105UL ); found++; }
+  }
+  FD_TEST( found==1UL );
+
+  /* Remove the stale A pairs of the reassigned accounts while
+     iterating */
+  for( ulong i=fd_rpc_index_head( index, FD_RPC_INDEX_KIND_PROGRAM, prog_a ); i!=FD_RPC_INDEX_IDX_NULL; ) {
+    ulong next = fd_rpc_index_next( index, i );
+    if( fd_rpc_index_pubkey( index, i )[ 0 ]<5 ) fd_rpc_index_remove( index, i );
+    i = next;
+  }
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_PROGRAM, 0xa )==5UL );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==10UL );
+
+  /* Removing the last pair of a key removes the key */
+  for( ulong i=0UL; i<ELE_MAX; i++ ) {
+    if( fd_rpc_index_live( index, i ) && fd_rpc_index_key( index, i )[ 0 ]==0xb ) fd_rpc_index_remove( index, i );
+  }
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_PROGRAM, 0xb )==0UL );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==5UL );
+
+  /* Token accounts are indexed under their owner program and their
+     token fields */
+  uchar data[ FD_RPC_INDEX_TOKEN_ACCOUNT_SZ ];
+  for( ulong i=0UL; i<4UL; i++ ) {
+    pubkey[ 0 ] = (uchar)(0x80+i);
+    token_account( data, 0x1, (uchar)(0x10+(i&1UL)), (uchar)(i==3UL ? 0x20 : 0) );
+    FD_TEST( !fd_rpc_index_insert( index, pubkey, fd_solana_spl_token_id.uc, data, sizeof(data), 110UL ) );
+  }
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_TOKEN_MINT,     0x1  )==4UL );
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_TOKEN_OWNER,    0x10 )==2UL );
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_TOKEN_OWNER,    0x11 )==2UL );
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_TOKEN_DELEGATE, 0x20 )==1UL );
+  FD_TEST( query_cnt( index, FD_RPC_INDEX_KIND_TOKEN_MINT,     0x10 )==0UL );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==5UL+4UL*3UL+1UL );
+
+  /* Running out of space is sticky until the mark is cleared */
+  FD_TEST( !fd_rpc_index_full( index ) );
+  int full = 0;
+  for( ulong i=0UL; i<ELE_MAX; i++ ) {
+    pubkey[ 0 ] = 0xff; pubkey[ 1 ] = (uchar)i;
+    full |= fd_rpc_index_insert( index, pubkey, prog_b, NULL, 0UL, 120UL );
+  }
+  FD_TEST( full==-1 );
+  FD_TEST( fd_rpc_index_full( index ) );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==ELE_MAX );
+
+  ulong ele_idx = fd_rpc_index_head( index, FD_RPC_INDEX_KIND_PROGRAM, prog_b );
+  FD_TEST( ele_idx!=FD_RPC_INDEX_IDX_NULL );
+  fd_rpc_index_remove( index, ele_idx );
+  pubkey[ 0 ] = 0xfe;
+  FD_TEST( fd_rpc_index_insert( index, pubkey, prog_b, NULL, 0UL, 130UL )==-1 );
+  fd_rpc_index_clear_full( index );
+  FD_TEST( !fd_rpc_index_full( index ) );
+  FD_TEST( fd_rpc_index_ele_cnt( index )==ELE_MAX );
+  fd_rpc_index_remove( index, fd_rpc_index_head( index, FD_RPC_INDEX_KIND_PROGRAM, prog_b ) );
+  pubkey[ 0 ] = 0xfd;
+  FD_TEST( !fd_rpc_index_insert( index, pubkey, prog_b, NULL, 0UL, 130UL ) );
+  FD_TEST( !fd_rpc_index_full( index ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  test_keys();
+  test_index();
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,203 @@
+#define _GNU_SOURCE
+#include "fd_rpc_txnstatus.h"
+#include <unistd.h>
+
+#define TEST_FILE "/tmp/test_rpc_txnstatus.bin"
+#define TXN_MAX   (32UL)
+#define SLOT_MAX  (16UL)
+
+static uchar store_mem[ 1UL<<20 ] __attribute__((aligned(128UL)));
+
+/* make_txn builds a legacy transaction with one signature sig_byte,
+   fee payer sig_byte, and the given extra account keys, and parses
+   it into txn.  Returns the payload size. */
+
+static ulong
+make_txn( uchar         payload[ FD_TXN_MTU ],
+          fd_txn_t *    txn,
+          uchar         sig_byte,
+          uchar const * keys,
+          ulong         key_cnt ) {
+  ulong off = 0UL;
+  payload[ off++ ] = 1;
+  memset( payload+off, sig_byte, 64UL ); off += 64UL;
+  payload[ off++ ] = 1; /* Signatures */
+  payload[ off++ ] = 0; /* Readonly signed */
+  payload[ off++ ] = 1; /* Readonly unsigned, the program */
+  payload[ off++ ] = (uchar)(key_cnt+2UL);
+  memset( payload+off, sig_byte, 32UL ); off += 32UL;
+  for( ulong i=0UL; i<key_cnt; i++ ) { memset( payload+off, keys[ i ], 32UL ); off += 32UL; }
+  memset( payload+off, 0xee, 32UL ); off += 32UL; /* Program */
+  memset( payload+off, 0x77, 32UL ); off += 32UL; /* Recent blockhash */
+  payload[ off++ ] = 1;
+  payload[ off++ ] = (uchar)(key_cnt+1UL);
+  payload[ off++ ] = 0;
+  payload[ off++ ] = 0;
+  FD_TEST( fd_txn_parse( payload, off, txn, NULL ) );
+  return off;
+}
+
+static int
+insert( fd_rpc_txnstatus_t * store,
+        ulong                slot,
+        ulong                index_in_slot,
+        uchar                sig_byte,
+        uchar const *        keys,
+        ulong                key_cnt,
+        int                  txn_err ) {
+  uchar payload[ FD_TXN_MTU ];
+  uchar txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+  fd_txn_t * txn = (fd_txn_t *)txn_mem;
+  ulong sz = make_txn( payload, txn, sig_byte, keys, key_cnt );
+  fd_rpc_txnstatus_err_t err = { .txn_err = txn_err };
+  return fd_rpc_txnstatus_insert( store, slot, index_in_slot, &err, payload, sz, txn );
+}
+
+static ulong
+sig_query( fd_rpc_txnstatus_t * store,
+           uchar                sig_byte ) {
+  uchar sig[ 64 ]; memset( sig, sig_byte, 64UL );
+  return fd_rpc_txnstatus_sig_query( store, sig );
+}
+
+static ulong
+addr_cnt( fd_rpc_txnstatus_t * store,
+          uchar                addr_byte ) {
+  uchar addr[ 32 ]; memset( addr, addr_byte, 32UL );
+  ulong cnt       = 0UL;
+  ulong last_slot = ULONG_MAX;
+  for( ulong p=fd_rpc_txnstatus_addr_query( store, addr ); p!=FD_RPC_TXNSTATUS_IDX_NULL; p=fd_rpc_txnstatus_addr_next( store, p ) ) {
+    ulong slot = fd_rpc_txnstatus_slot( store, fd_rpc_txnstatus_post_txn( store, p ) );
+    FD_TEST( slot<=last_slot ); /* Newest first */
+    last_slot = slot;
+    cnt++;
+  }
+  return cnt;
+}
+
+static void
+test_store( void ) {
+  FD_TEST( !fd_rpc_txnstatus_footprint( 0UL, SLOT_MAX ) );
+  FD_TEST( !fd_rpc_txnstatus_footprint( TXN_MAX, 0UL ) );
+  FD_TEST( fd_rpc_txnstatus_footprint( TXN_MAX, SLOT_MAX )<=sizeof(store_mem) );
+  FD_TEST( !fd_rpc_txnstatus_new( store_mem, TXN_MAX, SLOT_MAX, "/nonexistent/txnstatus.bin", 1UL ) );
+
+  fd_rpc_txnstatus_t * store = fd_rpc_txnstatus_join( fd_rpc_txnstatus_new( store_mem, TXN_MAX, SLOT_MAX, TEST_FILE, 1234UL ) );
+  FD_TEST( store );
+  FD_TEST( fd_rpc_txnstatus_txn_max( store )==TXN_MAX );
+
+  uchar keys[ 2 ] = { 0xa1, 0xa2 };
+
+  /* Slot 10 on the main fork, 11 and 12 on two forks off 10 */
+  FD_TEST( insert( store, 10UL, 0UL, 0x01, keys, 2UL, 0 ) );
+  FD_TEST( insert( store, 10UL, 1UL, 0x02, keys, 1UL, -9 ) );
+  FD_TEST( insert( store, 11UL, 0UL, 0x03, keys, 1UL, 0 ) );
+  FD_TEST( insert( store, 12UL, 0UL, 0x03, keys, 1UL, 0 ) ); /* Same transaction on the other fork */
+  FD_TEST( !insert( store, 12UL, 0UL, 0x03, keys, 1UL, 0 ) ); /* Slot replayed again */
+  FD_TEST( fd_rpc_txnstatus_txn_cnt( store )==4UL );
+
+  ulong txn_idx[ 4 ];
+  FD_TEST( fd_rpc_txnstatus_slot_txns( store, 10UL, txn_idx, 4UL )==2UL );
+  FD_TEST( fd_rpc_txnstatus_index_in_slot( store, txn_idx[ 0 ] )==0UL );
+  FD_TEST( fd_rpc_txnstatus_index_in_slot( store, txn_idx[ 1 ] )==1UL );
+  FD_TEST( fd_rpc_txnstatus_slot_txns( store, 10UL, txn_idx, 1UL )==ULONG_MAX );
+  FD_TEST( fd_rpc_txnstatus_slot_txns( store, 12UL, txn_idx, 4UL )==1UL );
+  FD_TEST( fd_rpc_txnstatus_slot_txns( store, 14UL, txn_idx, 4UL )==ULONG_MAX );
+
+  ulong i = sig_query( store, 0x02 );
+  FD_TEST( i!=FD_RPC_TXNSTATUS_IDX_NULL );
+  FD_TEST( fd_rpc_txnstatus_sig_next( store, i )==FD_RPC_TXNSTATUS_IDX_NULL );
+  FD_TEST( fd_rpc_txnstatus_slot( store, i )==10UL );
+  FD_TEST( fd_rpc_txnstatus_index_in_slot( store, i )==1UL );
+  FD_TEST( fd_rpc_txnstatus_err( store, i )->txn_err==-9 );
+  FD_TEST( fd_rpc_txnstatus_version( store, i )==FD_TXN_VLEGACY );
+  FD_TEST( sig_query( store, 0x04 )==FD_RPC_TXNSTATUS_IDX_NULL );
+
+  uchar payload[ FD_TXN_MTU ];
+  uchar expected[ FD_TXN_MTU ];
+  uchar txn_mem[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+  ulong sz = make_txn( expected, (fd_txn_t *)txn_mem, 0x02, keys, 1UL );
+  FD_TEST( fd_rpc_txnstatus_read( store, i, payload )==sz );
+  FD_TEST( !memcmp( payload, expected, sz ) );
+
+  FD_TEST( addr_cnt( store, 0xa1 )==4UL );
+  FD_TEST( addr_cnt( store, 0xa2 )==1UL );
+  FD_TEST( addr_cnt( store, 0x01 )==1UL ); /* Fee payer */
+  FD_TEST( addr_cnt( store, 0xee )==4UL ); /* Program */
+  FD_TEST( addr_cnt( store, 0xb0 )==0UL );
+
+  /* Nothing is visible until its slot completes */
+  FD_TEST( fd_rpc_txnstatus_conf( store, i, 10UL, 10UL )==FD_RPC_TXNSTATUS_CONF_NONE );
+  fd_rpc_txnstatus_slot_completed( store, 10UL, 9UL );
+  fd_rpc_txnstatus_slot_completed( store, 11UL, 10UL );
+  fd_rpc_txnstatus_slot_completed( store, 12UL, 10UL );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i, 10UL, ULONG_MAX )==FD_RPC_TXNSTATUS_CONF_PROCESSED );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i, 12UL, 11UL      )==FD_RPC_TXNSTATUS_CONF_CONFIRMED );
+
+  /* Each copy of the forked transaction is visible on its fork only */
+  ulong i12 = sig_query( store, 0x03 );
+  ulong i11 = fd_rpc_txnstatus_sig_next( store, i12 );
+  FD_TEST( fd_rpc_txnstatus_slot( store, i12 )==12UL );
+  FD_TEST( fd_rpc_txnstatus_slot( store, i11 )==11UL );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i12, 12UL, 10UL )==FD_RPC_TXNSTATUS_CONF_PROCESSED );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i11, 12UL, 10UL )==FD_RPC_TXNSTATUS_CONF_NONE );
+
+  /* Rooting 11 finalizes 10 and 11 and abandons 12 */
+  fd_rpc_txnstatus_root( store, 11UL );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i,   11UL, 11UL )==FD_RPC_TXNSTATUS_CONF_FINALIZED );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i11, 11UL, 11UL )==FD_RPC_TXNSTATUS_CONF_FINALIZED );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i12, 12UL, 12UL )==FD_RPC_TXNSTATUS_CONF_NONE );
+  fd_rpc_txnstatus_slot_completed( store, 12UL, 10UL );
+  FD_TEST( fd_rpc_txnstatus_conf( store, i12, 12UL, 12UL )==FD_RPC_TXNSTATUS_CONF_NONE );
+
+  /* Dead slots are not visible */
+  FD_TEST( insert( store, 13UL, 0UL, 0x05, keys, 0UL, 0 ) );
+  fd_rpc_txnstatus_slot_dead( store, 13UL );
+  FD_TEST( fd_rpc_txnstatus_conf( store, sig_query( store, 0x05 ), 13UL, 13UL )==FD_RPC_TXNSTATUS_CONF_NONE );
+
+  /* Filling the store evicts the oldest transactions with their
+     postings, and the slot table entries they kept alive */
+  ulong slot = 14UL;
+  for( ulong j=0UL; j<4UL*TXN_MAX; j++ ) {
+    if( j%8UL==7UL ) {
+      fd_rpc_txnstatus_slot_completed( store, slot, slot==14UL ? 11UL : slot-1UL );
+      fd_rpc_txnstatus_root( store, slot );
+      slot++;
+    }
+    uchar key = (uchar)(0xc0+(j%4UL));
+    FD_TEST( insert( store, slot, j%8UL, (uchar)(0x10+j), &key, 1UL, 0 ) );
+    FD_TEST( fd_rpc_txnstatus_txn_cnt( store )<=TXN_MAX );
+  }
+  FD_TEST( fd_rpc_txnstatus_txn_cnt( store )==TXN_MAX );
+  FD_TEST( fd_rpc_txnstatus_evict_cnt( store )==4UL*TXN_MAX+5UL-TXN_MAX );
+  FD_TEST( sig_query( store, 0x01 )==FD_RPC_TXNSTATUS_IDX_NULL );
+  FD_TEST( fd_rpc_txnstatus_slot_txns( store, 10UL, txn_idx, 4UL )==ULONG_MAX );
+  FD_TEST( addr_cnt( store, 0xa1 )==0UL );
+  FD_TEST( addr_cnt( store, 0xee )==TXN_MAX );
+  FD_TEST( addr_cnt( store, 0xc0 )==TXN_MAX/4UL );
+
+  /* Every remaining record still reads back */
+  for( ulong j=3UL*TXN_MAX; j<4UL*TXN_MAX; j++ ) {
+    uchar key = (uchar)(0xc0+(j%4UL));
+    ulong k   = sig_query( store, (uchar)(0x10+j) );
+    FD_TEST( k!=FD_RPC_TXNSTATUS_IDX_NULL );
+    sz = make_txn( expected, (fd_txn_t *)txn_mem, (uchar)(0x10+j), &key, 1UL );
+    FD_TEST( fd_rpc_txnstatus_read( store, k, payload )==sz );
+    FD_TEST( !memcmp( payload, expected, sz ) );
+  }
+
+  close( fd_rpc_txnstatus_fd( store ) );
+  unlink( TEST_FILE );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  test_store();
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
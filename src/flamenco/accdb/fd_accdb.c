@@ -7,6 +7,7 @@
 #include "../../ballet/txn/fd_txn.h"
 #include "../../ballet/base58/fd_base58.h"
 #endif
+#include "../../ballet/lthash/fd_lthash_adder.h"
 #include "../../util/racesan/fd_racesan_target.h"
 
 #include "../../disco/events/generated/fd_event_gen.h"
@@ -30,6 +31,9 @@ ulong fd_accdb_dbg_reloc_cnt;
 #include <errno.h>
 #include <sys/uio.h>
 
+#include "../../util/io_uring/fd_io_uring_setup.h"
+#include "../../util/io_uring/fd_io_uring_register.h"
+
 struct fd_accdb_fork {
   fd_accdb_fork_shmem_t * shmem;
   descends_set_t * descends;
@@ -44,6 +48,11 @@ typedef struct fd_accdb_fork fd_accdb_fork_t;
 struct __attribute__((aligned(FD_ACCDB_ALIGN))) fd_accdb_private {
   int fd;
 
+  /* Optional io_uring instance used to serve cache misses in acquire
+     with a single batched submission, or NULL if misses are read with
+     preadv2.  See fd_accdb_attach_io_uring. */
+  fd_io_uring_t * ring;
+
   int acquire_state;
 
   fd_accdb_shmem_t * shmem;
@@ -100,6 +109,16 @@ struct __attribute__((aligned(FD_ACCDB_ALIGN))) fd_accdb_private {
 
   fd_accdb_metrics_t metrics[1];
 
+  /* Sampling state for fd_accdb_cache_rebalance.  Only meaningful on
+     the joiner that drives the rebalance (the accdb tile).  last_miss /
+     last_stall are the shmem pressure counters at the previous sample,
+     score is a per-class decayed pressure average in 1/256 units. */
+  struct {
+    ulong last_miss [ FD_ACCDB_CACHE_CLASS_CNT ];
+    ulong last_stall[ FD_ACCDB_CACHE_CLASS_CNT ];
+    ulong score     [ FD_ACCDB_CACHE_CLASS_CNT ];
+  } rebalance;
+
   /* Set by fd_accdb_snapshot_load_begin/end.  When non-zero, layer-0
      partition handoffs (in change_partition) re-tier the partitions
      that fell out of the snapshot-load working set: P-2 to Warm and
@@ -277,6 +296,7 @@ fd_accdb_new( void *              ljoin,
   void * _local_fork_pool = FD_SCRATCH_ALLOC_APPEND( l2, alignof(fd_accdb_fork_t), max_live_slots*sizeof(fd_accdb_fork_t) );
 
   accdb->fd = fd;
+  accdb->ring = NULL;
   accdb->acquire_state = FD_ACCDB_ACQUIRE_STATE_IDLE;
   accdb->snapshot_loading = 0;
 
@@ -324,6 +344,12 @@ fd_accdb_new( void *              ljoin,
   memset( accdb->metrics,      0, sizeof(fd_accdb_metrics_t) );
   memset( &accdb->write_stats, 0, sizeof(accdb->write_stats) );
 
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    accdb->rebalance.last_miss [ c ] = FD_VOLATILE_CONST( shmem->cache_class_pressure[ c ].miss  );
+    accdb->rebalance.last_stall[ c ] = FD_VOLATILE_CONST( shmem->cache_class_pressure[ c ].stall );
+    accdb->rebalance.score     [ c ] = 0UL;
+  }
+
   return accdb;
 }
 
@@ -380,6 +406,8 @@ fd_accdb_reset( fd_accdb_t * accdb ) {
     shmem->cache_free[ c ].ver_top   = (ulong)UINT_MAX;
     shmem->cache_free_cnt[ c ].val   = 0UL;
     shmem->cache_class_init[ c ].val = 0UL;
+    shmem->cache_free_target[ c ]    = shmem->cache_free_target_base[ c ];
+    shmem->cache_free_low_water[ c ] = (shmem->cache_free_target_base[ c ]*3UL)/4UL;
     if( shmem->cache_class_max[ c ]>=shmem->cache_min_reserved*shmem->joiner_cnt_max )
       shmem->cache_class_used[ c ].val = ULONG_MAX;
     else
@@ -641,6 +669,89 @@ fd_accdb_join( void * shaccdb ) {
   return (fd_accdb_t*)shaccdb;
 }
 
+fd_accdb_t *
+fd_accdb_attach_io_uring( fd_accdb_t *    accdb,
+                          fd_io_uring_t * ring ) {
+  if( FD_UNLIKELY( !accdb ) ) {
+    FD_LOG_WARNING(( "NULL accdb" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( ring && ( !ring->sq->depth || ring->cq->depth<ring->sq->depth ) ) ) {
+    FD_LOG_WARNING(( "unsupported io_uring (sq depth %u, cq depth %lu)", ring->sq->depth, ring->cq->depth ));
+    return NULL;
+  }
+
+  accdb->ring = ring;
+  return accdb;
+}
+
+fd_io_uring_t *
+fd_accdb_io_uring_init( fd_io_uring_t * ring,
+                        void *          shmem,
+                        ulong           depth,
+                        int             fd ) {
+  if( FD_UNLIKELY( !fd_ulong_is_pow2( depth ) || depth>UINT_MAX ) ) {
+    FD_LOG_WARNING(( "invalid io_uring depth %lu", depth ));
+    return NULL;
+  }
+
+  fd_io_uring_params_t params[1];
+  fd_io_uring_params_init( params, (uint)depth );
+  params->flags |= IORING_SETUP_COOP_TASKRUN | IORING_SETUP_DEFER_TASKRUN;
+  if( FD_UNLIKELY( !fd_io_uring_init_shmem( ring, params, shmem, depth, depth ) ) ) {
+    FD_LOG_WARNING(( "fd_io_uring_init_shmem failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( fd_io_uring_register_files( ring->ioring_fd, &fd, 1U )<0 ) ) {
+    FD_LOG_WARNING(( "io_uring_register_files() failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    fd_io_uring_fini( ring );
+    return NULL;
+  }
+
+  fd_io_uring_restriction_t restrictions[] = {
+    { .opcode    = FD_IORING_RESTRICTION_SQE_OP,             .sqe_op    = FD_IORING_OP_READ },
+    { .opcode    = FD_IORING_RESTRICTION_SQE_FLAGS_REQUIRED, .sqe_flags = IOSQE_FIXED_FILE  },
+  };
+  if( FD_UNLIKELY( fd_io_uring_register_restrictions( ring->ioring_fd, restrictions,
+                                                      (uint)( sizeof(restrictions)/sizeof(restrictions[0]) ) )<0 ) ) {
+    FD_LOG_WARNING(( "io_uring_register_restrictions() failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    fd_io_uring_fini( ring );
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( fd_io_uring_enable_rings( ring->ioring_fd )<0 ) ) {
+    FD_LOG_WARNING(( "io_uring_enable_rings() failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    fd_io_uring_fini( ring );
+    return NULL;
+  }
+
+  return ring;
+}
+
+ulong
+fd_accdb_io_uring_align( void ) {
+  return fd_io_uring_shmem_align();
+}
+
+ulong
+fd_accdb_io_uring_footprint( ulong depth ) {
+  return depth ? fd_io_uring_shmem_footprint( depth, depth ) : 0UL;
+}
+
+void
+fd_accdb_io_uring_setup( fd_io_uring_t * ring,
+                         void *          shmem,
+                         ulong           depth,
+                         int             fd ) {
+  ring->ioring_fd = -1;
+  if( !depth ) return;
+  if( FD_UNLIKELY( !fd_accdb_io_uring_init( ring, shmem, depth, fd ) ) ) {
+    FD_LOG_ERR(( "failed to create accdb io_uring (depth %lu)", depth ));
+  }
+}
+
 fd_accdb_t *
 fd_accdb_join_readonly( void *             ljoin,
                         fd_accdb_shmem_t * shmem,
@@ -678,7 +789,7 @@ fd_accdb_join_readonly( void *             ljoin,
   void * _descends_sets    = FD_SCRATCH_ALLOC_APPEND( l, descends_set_align(),           max_live_slots*descends_set_footprint( max_live_slots ) );
   void * _acc_map          = FD_SCRATCH_ALLOC_APPEND( l, alignof(uint),                  chain_cnt*sizeof(uint)                                  );
   void * _acc_pool_ele     = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_accdb_accmeta_t),    max_accounts*sizeof(fd_accdb_accmeta_t)                 );
-                             FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_accdb_txn_t),        txn_max*sizeof(fd_accdb_txn_t)                          );
+  void * _txn_pool_ele     = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_accdb_txn_t),        txn_max*sizeof(fd_accdb_txn_t)                          );
                              FD_SCRATCH_ALLOC_APPEND( l, partition_pool_align(),         partition_pool_footprint( partition_cnt )               );
   for( ulong k=0UL; k<FD_ACCDB_COMPACTION_LAYER_CNT; k++ ) {
                              FD_SCRATCH_ALLOC_APPEND( l, compaction_dlist_align(),       compaction_dlist_footprint()                            );
@@ -690,6 +801,7 @@ fd_accdb_join_readonly( void *             ljoin,
   void * _local_fork_pool = FD_SCRATCH_ALLOC_APPEND( l2, alignof(fd_accdb_fork_t), max_live_slots*sizeof(fd_accdb_fork_t) );
 
   accdb->fd    = fd_ro;
+  accdb->ring  = NULL;
   accdb->acquire_state = FD_ACCDB_ACQUIRE_STATE_IDLE;
   accdb->shmem = shmem;
   FD_TEST( acc_pool_join( accdb->acc_pool_join, shmem->acc_pool, _acc_pool_ele, max_accounts ) );
@@ -697,6 +809,10 @@ fd_accdb_join_readonly( void *             ljoin,
   accdb->acc_map  = _acc_map;
   for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) accdb->cache[ c ] = (uchar *)shmem + shmem->cache_region_off[ c ];
 
+  /* The txn pool is only walked (never acquired from or released to)
+     by fd_accdb_fork_writes. */
+  FD_TEST( txn_pool_join( accdb->txn_pool, shmem->txn_pool, _txn_pool_ele, txn_max ) );
+
   /* Writer-only structures: leave NULL so any accidental writer-path
      call from a readonly joiner crashes loudly rather than corrupting
      state. */
@@ -737,6 +853,12 @@ fd_accdb_join_readonly( void *             ljoin,
   memset( accdb->metrics,      0, sizeof(fd_accdb_metrics_t) );
   memset( &accdb->write_stats, 0, sizeof(accdb->write_stats) );
 
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    accdb->rebalance.last_miss [ c ] = FD_VOLATILE_CONST( shmem->cache_class_pressure[ c ].miss  );
+    accdb->rebalance.last_stall[ c ] = FD_VOLATILE_CONST( shmem->cache_class_pressure[ c ].stall );
+    accdb->rebalance.score     [ c ] = 0UL;
+  }
+
   return accdb;
 }
 
@@ -1587,6 +1709,8 @@ acquire_cache_line( fd_accdb_t * accdb,
 
     if( FD_UNLIKELY( FD_ATOMIC_CAS( &line->refcnt, 0U, FD_ACCDB_EVICT_SENTINEL )!=0U ) ) continue;
 
+    FD_ATOMIC_FETCH_AND_ADD( &accdb->shmem->cache_class_pressure[ size_class ].stall, 1UL );
+
     /* The line is now claimed for eviction (refcnt==EVICT_SENTINEL).  A
        concurrent acc_unlink that targets this same line's accmeta will
        observe the sentinel here and take its do-nothing branch — see the
@@ -2108,6 +2232,7 @@ cold_load_acc( fd_accdb_t *     accdb,
     /* We hold the claim.  Allocate a cache line and publish. */
     ulong size_class = fd_accdb_cache_class( FD_ACCDB_SIZE_DATA( old_es ) );
     fd_accdb_cache_line_t * line = acquire_cache_line( accdb, size_class, out_evicted_acc_idx );
+    FD_ATOMIC_FETCH_AND_ADD( &accdb->shmem->cache_class_pressure[ size_class ].miss, 1UL );
     fd_memcpy( line->key.pubkey, accmeta->key.pubkey, 32UL );
     line->key.generation = accmeta->key.generation;
     /* Leave acc_idx at UINT_MAX (the "loading" sentinel) until step 12
@@ -2137,6 +2262,113 @@ cold_load_acc( fd_accdb_t *     accdb,
   }
 }
 
+/* read_batch_io_uring performs the cache miss reads of an acquire
+   (read_cnt reads of read_sizes[i] bytes at file offset read_offsets[i]
+   into read_bases[i]) through accdb->ring instead of one blocking
+   preadv2 per account.  All reads are put into the submission queue
+   and submitted with a single io_uring_enter that also waits for their
+   completion, so the device services them concurrently and the caller
+   pays for the slowest read rather than for the sum of all of them.
+   Short reads and transient errors are resubmitted for the remainder.
+   The accounts file must be registered as fixed file 0 of the ring. */
+
+static void
+read_batch_io_uring( fd_accdb_t *    accdb,
+                     ulong           read_cnt,
+                     ulong const *   read_offsets,
+                     uchar * const * read_bases,
+                     ulong const *   read_sizes ) {
+  fd_io_uring_t * ring = accdb->ring;
+
+  ulong read_done[ FD_ACCDB_CACHE_CLASS_CNT*FD_ACCDB_MAX_ACQUIRE_CNT ];
+  ulong pending  [ FD_ACCDB_CACHE_CLASS_CNT*FD_ACCDB_MAX_ACQUIRE_CNT ];
+  ulong pending_cnt = read_cnt;
+  for( ulong i=0UL; i<read_cnt; i++ ) {
+    read_done[ i ] = 0UL;
+    pending  [ i ] = read_cnt-1UL-i;
+  }
+
+  ulong inflight = 0UL;
+  while( pending_cnt || inflight ) {
+    /* Never have more reads in flight than there is space in the
+       completion queue for. */
+    ulong space = fd_ulong_min( fd_io_uring_sq_space_left( ring->sq ), ring->cq->depth-inflight );
+    while( pending_cnt && space ) {
+      ulong i = pending[ --pending_cnt ];
+      struct io_uring_sqe * sqe = fd_io_uring_get_sqe( ring->sq );
+      FD_TEST( sqe );
+      *sqe = (struct io_uring_sqe) {
+        .opcode    = FD_IORING_OP_READ,
+        .flags     = IOSQE_FIXED_FILE,
+        .fd        = 0,
+        .off       = read_offsets[ i ]+read_done[ i ],
+        .addr      = (ulong)( read_bases[ i ]+read_done[ i ] ),
+        .len       = (uint)( read_sizes[ i ]-read_done[ i ] ),
+        .user_data = i
+      };
+      space--;
+      inflight++;
+    }
+
+    int res = fd_io_uring_submit( ring->sq, ring->ioring_fd, (uint)inflight, IORING_ENTER_GETEVENTS );
+    if( FD_UNLIKELY( res<0 && errno!=EINTR && errno!=EAGAIN && errno!=EBUSY ) ) {
+      FD_LOG_ERR(( "io_uring_enter() failed (%d-%s)", errno, fd_io_strerror( errno ) ));
+    }
+
+    for( uint ready=fd_io_uring_cq_ready( ring->cq ); ready; ready-- ) {
+      struct io_uring_cqe * cqe = fd_io_uring_cq_head( ring->cq );
+      ulong i      = cqe->user_data;
+      int   result = cqe->res;
+      fd_io_uring_cq_advance( ring->cq, 1U );
+      inflight--;
+
+      FD_TEST( i<read_cnt );
+      if( FD_UNLIKELY( result==-EINTR || result==-EAGAIN ) ) {
+        pending[ pending_cnt++ ] = i;
+        continue;
+      }
+      else if( FD_UNLIKELY( result<0 ) ) FD_LOG_ERR(( "io_uring read failed (%d-%s)", -result, fd_io_strerror( -result ) ));
+      else if( FD_UNLIKELY( !result ) ) FD_LOG_ERR(( "accounts database is corrupt, data expected at offset %lu with size %lu exceeded file extents",
+                                                     read_offsets[ i ]+read_done[ i ], read_sizes[ i ] ));
+      fd_accdb_partition_read_bump( accdb, read_offsets[ i ]+read_done[ i ], (ulong)result );
+      read_done[ i ] += (ulong)result;
+      accdb->metrics->bytes_read += (ulong)result;
+      accdb->metrics->read_ops++;
+
+      if( FD_UNLIKELY( read_done[ i ]<read_sizes[ i ] ) ) pending[ pending_cnt++ ] = i;
+    }
+  }
+}
+
+/* fd_accdb_chain_find returns the acc_pool index of the newest version
+   of pubkey visible on fork_id, or UINT_MAX if there is none.  A
+   version is visible if it is rooted or was written on fork_id or one
+   of its ancestors.  This is the single-key form of the chain walk in
+   fd_accdb_acquire_inner (see there for why it is safe against
+   concurrent prepends).  Caller must have published its epoch. */
+
+static inline uint
+fd_accdb_chain_find( fd_accdb_t *       accdb,
+                     fd_accdb_fork_id_t fork_id,
+                     uchar const *      pubkey ) {
+  uint root_generation = accdb->fork_pool[ accdb->shmem->root_fork_id.val ].shmem->generation;
+  fd_accdb_fork_t * fork = &accdb->fork_pool[ fork_id.val ];
+  ulong hash = fd_accdb_hash( pubkey, accdb->shmem->seed )&(accdb->shmem->chain_cnt-1UL);
+  uint acc = FD_VOLATILE_CONST( accdb->acc_map[ hash ] );
+  while( acc!=UINT_MAX ) {
+    fd_accdb_accmeta_t const * candidate_acc = &accdb->acc_pool[ acc ];
+    uint next_acc = FD_VOLATILE_CONST( candidate_acc->map.next );
+
+    if( FD_UNLIKELY( (candidate_acc->key.generation>root_generation && fd_accdb_acc_fork_id(candidate_acc)!=fork_id.val && !descends_set_test( fork->descends, fd_accdb_acc_fork_id(candidate_acc) )) ) || memcmp( pubkey, candidate_acc->key.pubkey, 32UL ) ) {
+      acc = next_acc;
+      continue;
+    }
+
+    break;
+  }
+  return acc;
+}
+
 #define RESERVATION_TYPE_SIMPLE            (0)
 #define RESERVATION_TYPE_MAYBE_PROGRAMDATA (1)
 #define RESERVATION_TYPE_ALREADY_RESERVED  (2)
@@ -2832,21 +3064,28 @@ fd_accdb_acquire_inner( fd_accdb_t *          accdb,
   //   snapshotted the old offset have exited, so the data at the
   //   remains stable for the duration of this read — no post-read
   //   validation or retry is needed.
-  for( ulong i=0UL; i<read_ops_cnt; i++ ) {
-    ulong bytes_read = 0UL;
-    while( FD_LIKELY( bytes_read<read_sizes[ i ] ) ) {
-      long result = preadv2( accdb->fd, &read_ops[ i ], 1, (long)(read_offsets[ i ]+bytes_read), 0 );
-      if( FD_UNLIKELY( -1==result && (errno==EINTR || errno==EAGAIN || errno==EWOULDBLOCK ) ) ) continue;
-      else if( FD_UNLIKELY( -1==result ) ) FD_LOG_ERR(( "preadv2() failed (%d-%s)", errno, fd_io_strerror( errno ) ));
-      else if( FD_UNLIKELY( !result ) ) FD_LOG_ERR(( "accounts database is corrupt, data expected at offset %lu with size %lu exceeded file extents",
-                                                     read_offsets[ i ]+bytes_read, read_sizes[ i ] ));
-      fd_accdb_partition_read_bump( accdb, read_offsets[ i ]+bytes_read, (ulong)result );
-      bytes_read += (ulong)result;
-      accdb->metrics->bytes_read += (ulong)result;
-      accdb->metrics->read_ops++;
-
-      read_ops[ i ].iov_base = read_bases[ i ] + bytes_read;
-      read_ops[ i ].iov_len  = read_sizes[ i ] - bytes_read;
+  //
+  //   If the joiner has an io_uring attached, all of the reads are
+  //   instead submitted as one batch (see read_batch_io_uring).
+  if( FD_UNLIKELY( accdb->ring ) ) {
+    read_batch_io_uring( accdb, read_ops_cnt, read_offsets, read_bases, read_sizes );
+  } else {
+    for( ulong i=0UL; i<read_ops_cnt; i++ ) {
+      ulong bytes_read = 0UL;
+      while( FD_LIKELY( bytes_read<read_sizes[ i ] ) ) {
+        long result = preadv2( accdb->fd, &read_ops[ i ], 1, (long)(read_offsets[ i ]+bytes_read), 0 );
+        if( FD_UNLIKELY( -1==result && (errno==EINTR || errno==EAGAIN || errno==EWOULDBLOCK ) ) ) continue;
+        else if( FD_UNLIKELY( -1==result ) ) FD_LOG_ERR(( "preadv2() failed (%d-%s)", errno, fd_io_strerror( errno ) ));
+        else if( FD_UNLIKELY( !result ) ) FD_LOG_ERR(( "accounts database is corrupt, data expected at offset %lu with size %lu exceeded file extents",
+                                                       read_offsets[ i ]+bytes_read, read_sizes[ i ] ));
+        fd_accdb_partition_read_bump( accdb, read_offsets[ i ]+bytes_read, (ulong)result );
+        bytes_read += (ulong)result;
+        accdb->metrics->bytes_read += (ulong)result;
+        accdb->metrics->read_ops++;
+
+        read_ops[ i ].iov_base = read_bases[ i ] + bytes_read;
+        read_ops[ i ].iov_len  = read_sizes[ i ] - bytes_read;
+      }
     }
   }
 
@@ -3487,24 +3726,8 @@ fd_accdb_read_one_nocache( fd_accdb_t *       accdb,
   ///   Walk the hash chain at acc_map[hash(pubkey)] using the same
   //    visibility test as fd_accdb_acquire_inner.  See that function
   //    for the detailed safety argument under concurrent prepend.
-  uint root_generation = accdb->fork_pool[ accdb->shmem->root_fork_id.val ].shmem->generation;
-  fd_accdb_fork_t * fork = &accdb->fork_pool[ fork_id.val ];
-  ulong hash = fd_accdb_hash( pubkey, accdb->shmem->seed )&(accdb->shmem->chain_cnt-1UL);
-  uint acc_idx = FD_VOLATILE_CONST( accdb->acc_map[ hash ] );
-  fd_accdb_accmeta_t const * accmeta = NULL;
-  while( acc_idx!=UINT_MAX ) {
-    fd_accdb_accmeta_t const * candidate = &accdb->acc_pool[ acc_idx ];
-    uint next_idx = FD_VOLATILE_CONST( candidate->map.next );
-    if( FD_UNLIKELY( (candidate->key.generation>root_generation &&
-                      fd_accdb_acc_fork_id(candidate)!=fork_id.val &&
-                      !descends_set_test( fork->descends, fd_accdb_acc_fork_id(candidate) )) ) ||
-                     memcmp( pubkey, candidate->key.pubkey, 32UL ) ) {
-      acc_idx = next_idx;
-      continue;
-    }
-    accmeta = candidate;
-    break;
-  }
+  uint acc_idx = fd_accdb_chain_find( accdb, fork_id, pubkey );
+  fd_accdb_accmeta_t const * accmeta = acc_idx!=UINT_MAX ? &accdb->acc_pool[ acc_idx ] : NULL;
 
   if( FD_UNLIKELY( !accmeta ) ) {
     accdb->metrics->accounts_acquired_per_class[ 0 ]++;
@@ -3649,21 +3872,7 @@ fd_accdb_exists( fd_accdb_t *       accdb,
   FD_VOLATILE( *accdb->my_epoch_slot ) = FD_VOLATILE_CONST( accdb->shmem->epoch );
   FD_HW_MFENCE();
 
-  uint root_generation = accdb->fork_pool[ accdb->shmem->root_fork_id.val ].shmem->generation;
-  fd_accdb_fork_t * fork = &accdb->fork_pool[ fork_id.val ];
-  ulong hash = fd_accdb_hash( pubkey, accdb->shmem->seed )&(accdb->shmem->chain_cnt-1UL);
-  uint acc = FD_VOLATILE_CONST( accdb->acc_map[ hash ] );
-  while( acc!=UINT_MAX ) {
-    fd_accdb_accmeta_t const * candidate_acc = &accdb->acc_pool[ acc ];
-    uint next_acc = FD_VOLATILE_CONST( candidate_acc->map.next );
-
-    if( FD_UNLIKELY( (candidate_acc->key.generation>root_generation && fd_accdb_acc_fork_id(candidate_acc)!=fork_id.val && !descends_set_test( fork->descends, fd_accdb_acc_fork_id(candidate_acc) )) ) || memcmp( pubkey, candidate_acc->key.pubkey, 32UL ) ) {
-      acc = next_acc;
-      continue;
-    }
-
-    break;
-  }
+  uint acc = fd_accdb_chain_find( accdb, fork_id, pubkey );
 
   int result;
   if( FD_UNLIKELY( acc==UINT_MAX ) ) result = 0;
@@ -3685,21 +3894,8 @@ fd_accdb_probe_pd_this_fork( fd_accdb_t *       accdb,
   FD_VOLATILE( *accdb->my_epoch_slot ) = FD_VOLATILE_CONST( accdb->shmem->epoch );
   FD_HW_MFENCE();
 
-  uint root_generation = accdb->fork_pool[ accdb->shmem->root_fork_id.val ].shmem->generation;
   fd_accdb_fork_t * fork = &accdb->fork_pool[ fork_id.val ];
-  ulong hash = fd_accdb_hash( pubkey, accdb->shmem->seed )&(accdb->shmem->chain_cnt-1UL);
-  uint acc = FD_VOLATILE_CONST( accdb->acc_map[ hash ] );
-  while( acc!=UINT_MAX ) {
-    fd_accdb_accmeta_t const * candidate_acc = &accdb->acc_pool[ acc ];
-    uint next_acc = FD_VOLATILE_CONST( candidate_acc->map.next );
-
-    if( FD_UNLIKELY( (candidate_acc->key.generation>root_generation && fd_accdb_acc_fork_id(candidate_acc)!=fork_id.val && !descends_set_test( fork->descends, fd_accdb_acc_fork_id(candidate_acc) )) ) || memcmp( pubkey, candidate_acc->key.pubkey, 32UL ) ) {
-      acc = next_acc;
-      continue;
-    }
-
-    break;
-  }
+  uint acc = fd_accdb_chain_find( accdb, fork_id, pubkey );
 
   int   pd        = 0;
   int   gen_match = 0;
@@ -3733,25 +3929,143 @@ fd_accdb_lamports( fd_accdb_t *       accdb,
   FD_VOLATILE( *accdb->my_epoch_slot ) = FD_VOLATILE_CONST( accdb->shmem->epoch );
   FD_HW_MFENCE();
 
-  uint root_generation = accdb->fork_pool[ accdb->shmem->root_fork_id.val ].shmem->generation;
-  fd_accdb_fork_t * fork = &accdb->fork_pool[ fork_id.val ];
-  ulong hash = fd_accdb_hash( pubkey, accdb->shmem->seed )&(accdb->shmem->chain_cnt-1UL);
-  uint acc = FD_VOLATILE_CONST( accdb->acc_map[ hash ] );
+  uint acc = fd_accdb_chain_find( accdb, fork_id, pubkey );
+
+  ulong result;
+  if( FD_UNLIKELY( acc==UINT_MAX ) ) result = 0UL;
+  else                               result = FD_VOLATILE_CONST( accdb->acc_pool[ acc ].lamports );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *accdb->my_epoch_slot ) = ULONG_MAX;
+  return result;
+}
+
+ulong
+fd_accdb_fork_writes( fd_accdb_t *       accdb,
+                      fd_accdb_fork_id_t fork_id,
+                      ulong *            cursor,
+                      uchar              out_pubkeys[][ 32 ],
+                      ulong              out_max ) {
+  if( FD_UNLIKELY( *cursor==ULONG_MAX ) ) return 0UL;
+
+  /* The txn list of a frozen fork is immutable until the fork is rooted
+     or purged, which the caller prevents.  The epoch keeps the acc pool
+     elements it refers to from being recycled while we copy keys. */
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *accdb->my_epoch_slot ) = FD_VOLATILE_CONST( accdb->shmem->epoch );
+  FD_HW_MFENCE();
+
+  ulong txn_max = txn_pool_ele_max( accdb->txn_pool );
+  uint  txn_idx = *cursor ? (uint)(*cursor-1UL) : FD_VOLATILE_CONST( accdb->fork_pool[ fork_id.val ].shmem->txn_head );
+  ulong cnt     = 0UL;
+  while( txn_idx!=UINT_MAX && cnt<out_max ) {
+    if( FD_UNLIKELY( (ulong)txn_idx>=txn_max ) ) FD_LOG_CRIT(( "corrupt txn list on fork %u", (uint)fork_id.val ));
+    fd_accdb_txn_t const * txn = txn_pool_ele( accdb->txn_pool, (ulong)txn_idx );
+    memcpy( out_pubkeys[ cnt++ ], accdb->acc_pool[ txn->acc_pool_idx ].key.pubkey, 32UL );
+    txn_idx = txn->fork.next;
+  }
+  *cursor = txn_idx==UINT_MAX ? ULONG_MAX : (ulong)txn_idx+1UL;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *accdb->my_epoch_slot ) = ULONG_MAX;
+  return cnt;
+}
+
+ulong
+fd_accdb_chain_cnt( fd_accdb_t const * accdb ) {
+  return accdb->shmem->chain_cnt;
+}
+
+ulong
+fd_accdb_scan_chain( fd_accdb_t *  accdb,
+                     ulong         chain_idx,
+                     uchar const * after,
+                     uchar         out_pubkeys[][ 32 ],
+                     ulong         out_max ) {
+  if( FD_UNLIKELY( !out_max ) ) return 0UL;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *accdb->my_epoch_slot ) = FD_VOLATILE_CONST( accdb->shmem->epoch );
+  FD_HW_MFENCE();
+
+  /* Same concurrent prepend safety argument as the chain walk in
+     fd_accdb_read_one_nocache.  A chain holds every live version of
+     its accounts, newest first, so several entries can share a key.
+     out_pubkeys is kept sorted and holds the out_max smallest distinct
+     keys greater than after seen so far, which dedups versions and
+     gives a resume point that stays valid when the chain changes
+     between calls. */
+  ulong cnt = 0UL;
+  uint  acc = FD_VOLATILE_CONST( accdb->acc_map[ chain_idx ] );
   while( acc!=UINT_MAX ) {
     fd_accdb_accmeta_t const * candidate_acc = &accdb->acc_pool[ acc ];
-    uint next_acc = FD_VOLATILE_CONST( candidate_acc->map.next );
-
-    if( FD_UNLIKELY( (candidate_acc->key.generation>root_generation && fd_accdb_acc_fork_id(candidate_acc)!=fork_id.val && !descends_set_test( fork->descends, fd_accdb_acc_fork_id(candidate_acc) )) ) || memcmp( pubkey, candidate_acc->key.pubkey, 32UL ) ) {
-      acc = next_acc;
-      continue;
+    uint          next_acc = FD_VOLATILE_CONST( candidate_acc->map.next );
+    uchar const * key      = candidate_acc->key.pubkey;
+    acc = next_acc;
+
+    if( after && memcmp( key, after, 32UL )<=0 ) continue;
+
+    ulong lo = 0UL;
+    ulong hi = cnt;
+    int   dup = 0;
+    while( lo<hi ) {
+      ulong mid = (lo+hi)>>1;
+      int   c   = memcmp( key, out_pubkeys[ mid ], 32UL );
+      if( FD_UNLIKELY( !c ) ) { dup = 1; break; }
+      if( c<0 ) hi = mid;
+      else      lo = mid+1UL;
     }
+    if( dup || lo==out_max ) continue;
 
-    break;
+    ulong move_cnt = fd_ulong_min( cnt, out_max-1UL ) - lo;
+    memmove( out_pubkeys[ lo+1UL ], out_pubkeys[ lo ], move_cnt*32UL );
+    memcpy( out_pubkeys[ lo ], key, 32UL );
+    cnt = fd_ulong_min( cnt+1UL, out_max );
   }
 
-  ulong result;
-  if( FD_UNLIKELY( acc==UINT_MAX ) ) result = 0UL;
-  else                               result = FD_VOLATILE_CONST( accdb->acc_pool[ acc ].lamports );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *accdb->my_epoch_slot ) = ULONG_MAX;
+  return cnt;
+}
+
+int
+fd_accdb_prefetch( fd_accdb_t *       accdb,
+                   fd_accdb_fork_id_t fork_id,
+                   uchar const *      pubkey ) {
+  /* Same epoch protection as fd_accdb_exists.  The epoch keeps
+     compaction from relocating the record between reading offset_fork
+     and issuing the readahead, which would otherwise only warm the
+     wrong pages (harmless, but wasted). */
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *accdb->my_epoch_slot ) = FD_VOLATILE_CONST( accdb->shmem->epoch );
+  FD_HW_MFENCE();
+
+  uint acc = fd_accdb_chain_find( accdb, fork_id, pubkey );
+
+  int result = FD_ACCDB_PREFETCH_MISSING;
+  if( FD_LIKELY( acc!=UINT_MAX ) ) {
+    fd_accdb_accmeta_t const * accmeta = &accdb->acc_pool[ acc ];
+    uint  es   = FD_VOLATILE_CONST( accmeta->executable_size );
+    uint  cidx = FD_VOLATILE_CONST( accmeta->cache_idx );
+    ulong off  = FD_VOLATILE_CONST( accmeta->offset_fork ) & FD_ACCDB_OFF_MASK;
+    if( FD_UNLIKELY( !FD_VOLATILE_CONST( accmeta->lamports ) ) ) {
+      result = FD_ACCDB_PREFETCH_MISSING;
+    } else if( FD_ACCDB_SIZE_CACHE_VALID( es ) && cidx!=FD_ACCDB_ACC_CIDX_INVAL ) {
+      result = FD_ACCDB_PREFETCH_CACHED;
+    } else if( FD_UNLIKELY( off==FD_ACCDB_OFF_INVAL ) ) {
+      /* A writer is still publishing the record, it will be resident
+         (or at least in the page cache) by the time anyone reads it. */
+      result = FD_ACCDB_PREFETCH_CACHED;
+    } else {
+      /* The accounts file is opened without O_DIRECT, so warming the
+         page cache turns the synchronous preadv2 in the later acquire
+         into a memory copy.  Failure is not an error, the acquire will
+         simply go to disk as it would have without the hint. */
+      ulong sz = sizeof(fd_accdb_disk_meta_t)+(ulong)FD_ACCDB_SIZE_DATA( es );
+      if( FD_LIKELY( !readahead( accdb->fd, (long)off, sz ) ) ) result = FD_ACCDB_PREFETCH_ISSUED;
+      else                                                     result = FD_ACCDB_PREFETCH_CACHED;
+    }
+  }
 
   FD_COMPILER_MFENCE();
   FD_VOLATILE( *accdb->my_epoch_slot ) = ULONG_MAX;
@@ -3770,10 +4084,10 @@ fd_accdb_lamports( fd_accdb_t *       accdb,
   Budget: at most 256 CLOCK ticks per class per invocation to keep the
   background loop responsive.  The function is called every tick of
   fd_accdb_background, so large refills happen across several ticks
-  rather than blocking.  The low_water / target thresholds are static
-  per-class watermarks computed at initialization; pre-eviction only
-  converts resident lines into free-list entries and does not consume
-  cache-slot reservations.
+  rather than blocking.  The low_water / target thresholds are per-class
+  watermarks seeded at initialization and periodically retuned by
+  fd_accdb_cache_rebalance; pre-eviction only converts resident lines
+  into free-list entries and does not consume cache-slot reservations.
 
   force: when non-zero, ignore the watermark and sweep every line in
   every class.  Always 0 in normal operation; used only by
@@ -3787,13 +4101,13 @@ background_preevict( fd_accdb_t * accdb,
   fd_accdb_shmem_t * shmem = accdb->shmem;
 
   for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
-    ulong target = shmem->cache_free_target[ c ];
+    ulong target = FD_VOLATILE_CONST( shmem->cache_free_target[ c ] );
     ulong max_c  = shmem->cache_class_max[ c ];
     ulong init   = fd_ulong_min( FD_VOLATILE_CONST( shmem->cache_class_init[ c ].val ), max_c );
     ulong freec  = FD_VOLATILE_CONST( shmem->cache_free_cnt[ c ].val );
     ulong live   = init>freec ? init-freec : 0UL;
     ulong avail  = max_c-live;
-    if( FD_LIKELY( !force && avail>=shmem->cache_free_low_water[ c ] ) ) continue;
+    if( FD_LIKELY( !force && avail>=FD_VOLATILE_CONST( shmem->cache_free_low_water[ c ] ) ) ) continue;
 
     *charge_busy = 1;
 
@@ -4012,21 +4326,31 @@ fd_accdb_snapshot_write_one( fd_accdb_t *       accdb,
   return ( replace || cross_fork ) ? 2 : 1;
 }
 
-int
-fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
-                               fd_accdb_fork_id_t  fork_id,
-                               ulong               cnt,
-                               uchar const * const pubkeys[],
-                               ulong  const        slots[],
-                               ulong  const        lamports[],
-                               ulong  const        data_lens[],
-                               int    const        executables[],
-                               ulong *             accounts_ignored,
-                               ulong *             accounts_replaced,
-                               ulong *             accounts_loaded,
-                               ulong *             out_replaced_lamports,
-                               ulong *             out_ignored_lamports ) {
+/* snapshot_index_batch is the body of fd_accdb_snapshot_write_batch
+   and fd_accdb_snapshot_index_batch.  If file_offs is NULL, disk space
+   for each account is allocated here in order, and the caller must be
+   the only joiner modifying the index.  Otherwise file_offs[i] was
+   already reserved with fd_accdb_snapshot_reserve, and the shared pool,
+   txn list and metric updates use atomics so that several joiners can
+   index disjoint shards at the same time. */
+
+static inline void
+snapshot_index_batch( fd_accdb_t *        accdb,
+                      fd_accdb_fork_id_t  fork_id,
+                      ulong               cnt,
+                      uchar const * const pubkeys[],
+                      ulong  const        slots[],
+                      ulong  const        lamports[],
+                      ulong  const        data_lens[],
+                      int    const        executables[],
+                      ulong  const *      file_offs,
+                      ulong *             accounts_ignored,
+                      ulong *             accounts_replaced,
+                      ulong *             accounts_loaded,
+                      ulong *             out_replaced_lamports,
+                      ulong *             out_ignored_lamports ) {
   int incremental = fork_id.val!=USHORT_MAX;
+  int para        = !!file_offs;
 
   fd_accdb_fork_t * fork     = NULL;
   uint              fork_gen = 0U;
@@ -4049,12 +4373,6 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
   ulong replaced_lamports = 0UL;
   ulong ignored_lamports  = 0UL;
 
-  /* Snapshot slots are stored in the 32-bit cache_idx scratch field
-     during loading.  Reject anything that would truncate. */
-  for( ulong i=0UL; i<cnt; i++ ) {
-    if( FD_UNLIKELY( slots[ i ]>UINT_MAX ) ) FD_LOG_ERR(( "snapshot slot %lu exceeds 2^32-1, accdb format must be widened", slots[ i ] ));
-  }
-
   /* Phase 1: compute hashes and prefetch chain heads. */
 
   ulong                hashes[ 8 ];
@@ -4107,24 +4425,6 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
     }
   }
 
-  /* Phase 2b: reject intra-batch duplicate pubkeys.  Snapin always
-     populates a batch from a single AppendVec, so every slot in the
-     batch is identical and a duplicate pubkey means the same account
-     appears twice at the same slot — i.e. a corrupt snapshot per the
-     Agave spec.  We have no principled way to pick a winner; return
-     -1 so the caller can flag the snapshot malformed.  Batches are
-     bounded (<=8) so the O(n^2) scan is trivial. */
-
-  for( ulong i=1UL; i<cnt; i++ ) {
-    for( ulong j=0UL; j<i; j++ ) {
-      if( hashes[ j ]!=hashes[ i ] ) continue;
-      if( FD_UNLIKELY( !memcmp( pubkeys[ j ], pubkeys[ i ], 32UL ) ) ) {
-        FD_LOG_WARNING(( "corrupt snapshot: duplicate pubkey within a single batch (entries %lu and %lu, slots %lu and %lu)", j, i, slots[ j ], slots[ i ] ));
-        return -1;
-      }
-    }
-  }
-
   /* Phase 3: commit.  For each account either update the existing
      entry in-place (replace), allocate and insert at the chain head
      (new), or skip entirely (ignore).  This matches the
@@ -4134,14 +4434,15 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
   ulong used_bytes_removed = 0UL;
 
   for( ulong i=0UL; i<cnt; i++ ) {
+    ulong entry_sz = sizeof(fd_accdb_disk_meta_t)+data_lens[ i ];
+
     if( FD_UNLIKELY( skip[ i ] ) ) {
       /* Still advance the write head so snapwr and snapin stay in
          sync — snapwr unconditionally writes every account to disk.
          Mark the space as immediately freed since it is dead on
          arrival. */
-      ulong dead_sz  = sizeof(fd_accdb_disk_meta_t)+data_lens[ i ];
-      ulong dead_off = allocate_next_write( accdb, dead_sz );
-      fd_accdb_shmem_bytes_freed( accdb->shmem, dead_off, dead_sz );
+      ulong dead_off = para ? file_offs[ i ] : allocate_next_write( accdb, entry_sz );
+      fd_accdb_shmem_bytes_freed( accdb->shmem, dead_off, entry_sz );
       ignored_lamports += lamports[ i ];
       ignored++;
       continue;
@@ -4158,7 +4459,7 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
       replaced_lamports += accmeta->lamports;
       replaced++;
     } else {
-      accmeta = acc_pool_acquire_nolock( accdb->acc_pool_join );
+      accmeta = para ? acc_pool_acquire( accdb->acc_pool_join ) : acc_pool_acquire_nolock( accdb->acc_pool_join );
       if( FD_UNLIKELY( !accmeta ) ) FD_LOG_ERR(( "accounts database ran out of space during snapshot loading" ));
 
       uint acc_idx = (uint)acc_pool_idx( accdb->acc_pool_join, accmeta );
@@ -4174,8 +4475,17 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
         txn->acc_map_idx  = (uint)hashes[ i ];
         txn->acc_pool_idx = acc_idx;
         uint txn_idx      = (uint)txn_pool_idx( accdb->txn_pool, txn );
-        txn->fork.next          = fork->shmem->txn_head;
-        fork->shmem->txn_head   = txn_idx;
+        if( FD_LIKELY( !para ) ) {
+          txn->fork.next          = fork->shmem->txn_head;
+          fork->shmem->txn_head   = txn_idx;
+        } else {
+          for(;;) {
+            uint old_head = FD_VOLATILE_CONST( fork->shmem->txn_head );
+            txn->fork.next = old_head;
+            if( FD_LIKELY( FD_ATOMIC_CAS( &fork->shmem->txn_head, old_head, txn_idx )==old_head ) ) break;
+            FD_SPIN_PAUSE();
+          }
+        }
       }
 
       if( cross_existing[ i ] ) {
@@ -4190,31 +4500,197 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
     accmeta->cache_idx       = (uint)slots[ i ];
     accmeta->lamports        = lamports[ i ];
     accmeta->executable_size = FD_ACCDB_SIZE_PACK( (uint)data_lens[ i ], executables[ i ] );
-    ulong entry_sz       = sizeof(fd_accdb_disk_meta_t)+data_lens[ i ];
-    ulong file_off       = allocate_next_write( accdb, entry_sz );
+    ulong file_off       = para ? file_offs[ i ] : allocate_next_write( accdb, entry_sz );
     accmeta->offset_fork = incremental ? fd_accdb_acc_pack_offset_fork( file_off, fork_id.val ) : file_off;
     used_bytes_added    += entry_sz;
   }
 
-  accdb->shmem->shmetrics->disk_used_bytes += used_bytes_added;
-  accdb->shmem->shmetrics->disk_used_bytes -= used_bytes_removed;
-
   /* accounts_total tracks acc_pool entries: increment for every new
      allocation (both genuinely new accounts and cross-fork overrides
      that insert a second pool entry).  The output counter
      *accounts_loaded excludes cross-fork overrides to match
      snapshot_write_one semantics (cross-fork returns 2 = replaced). */
-  accdb->shmem->shmetrics->accounts_total += loaded + cross_replaced;
+  if( FD_LIKELY( !para ) ) {
+    accdb->shmem->shmetrics->disk_used_bytes += used_bytes_added;
+    accdb->shmem->shmetrics->disk_used_bytes -= used_bytes_removed;
+    accdb->shmem->shmetrics->accounts_total  += loaded + cross_replaced;
+  } else {
+    FD_ATOMIC_FETCH_AND_ADD( &accdb->shmem->shmetrics->disk_used_bytes, used_bytes_added   );
+    FD_ATOMIC_FETCH_AND_SUB( &accdb->shmem->shmetrics->disk_used_bytes, used_bytes_removed );
+    FD_ATOMIC_FETCH_AND_ADD( &accdb->shmem->shmetrics->accounts_total,  loaded + cross_replaced );
+  }
 
   *accounts_ignored      = ignored;
   *accounts_replaced     = replaced;
   *accounts_loaded       = loaded;
   *out_replaced_lamports = replaced_lamports;
   *out_ignored_lamports  = ignored_lamports;
+}
+
+int
+fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
+                               fd_accdb_fork_id_t  fork_id,
+                               ulong               cnt,
+                               uchar const * const pubkeys[],
+                               ulong  const        slots[],
+                               ulong  const        lamports[],
+                               ulong  const        data_lens[],
+                               int    const        executables[],
+                               ulong *             accounts_ignored,
+                               ulong *             accounts_replaced,
+                               ulong *             accounts_loaded,
+                               ulong *             out_replaced_lamports,
+                               ulong *             out_ignored_lamports ) {
+  /* Snapshot slots are stored in the 32-bit cache_idx scratch field
+     during loading.  Reject anything that would truncate. */
+  for( ulong i=0UL; i<cnt; i++ ) {
+    if( FD_UNLIKELY( slots[ i ]>UINT_MAX ) ) FD_LOG_ERR(( "snapshot slot %lu exceeds 2^32-1, accdb format must be widened", slots[ i ] ));
+  }
 
+  /* Reject intra-batch duplicate pubkeys.  Snapin always populates a
+     batch from a single AppendVec, so every slot in the batch is
+     identical and a duplicate pubkey means the same account appears
+     twice at the same slot — i.e. a corrupt snapshot per the Agave
+     spec.  We have no principled way to pick a winner; return -1 so
+     the caller can flag the snapshot malformed.  Batches are bounded
+     (<=8) so the O(n^2) scan is trivial. */
+
+  ulong dup_i, dup_j;
+  if( FD_UNLIKELY( fd_accdb_snapshot_batch_dup( cnt, pubkeys, &dup_i, &dup_j ) ) ) {
+    FD_LOG_WARNING(( "corrupt snapshot: duplicate pubkey within a single batch (entries %lu and %lu, slots %lu and %lu)", dup_j, dup_i, slots[ dup_j ], slots[ dup_i ] ));
+    return -1;
+  }
+
+  snapshot_index_batch( accdb, fork_id, cnt, pubkeys, slots, lamports, data_lens, executables, NULL,
+                        accounts_ignored, accounts_replaced, accounts_loaded, out_replaced_lamports, out_ignored_lamports );
   return 0;
 }
 
+ulong
+fd_accdb_snapshot_reserve( fd_accdb_t * accdb,
+                           ulong        data_len ) {
+  return allocate_next_write( accdb, sizeof(fd_accdb_disk_meta_t)+data_len );
+}
+
+ulong
+fd_accdb_snapshot_shard( fd_accdb_t const * accdb,
+                         uchar const *      pubkey,
+                         ulong              shard_cnt ) {
+  /* Shard by hash chain rather than by pubkey hash alone, so that two
+     shards never link into the same chain. */
+  ulong chain = fd_accdb_hash( pubkey, accdb->shmem->seed ) & (accdb->shmem->chain_cnt-1UL);
+  return chain % shard_cnt;
+}
+
+void
+fd_accdb_snapshot_index_batch( fd_accdb_t *        accdb,
+                               fd_accdb_fork_id_t  fork_id,
+                               ulong               cnt,
+                               uchar const * const pubkeys[],
+                               ulong  const        slots[],
+                               ulong  const        lamports[],
+                               ulong  const        data_lens[],
+                               int    const        executables[],
+                               ulong  const        file_offs[],
+                               ulong *             accounts_ignored,
+                               ulong *             accounts_replaced,
+                               ulong *             accounts_loaded,
+                               ulong *             out_replaced_lamports,
+                               ulong *             out_ignored_lamports ) {
+  for( ulong i=0UL; i<cnt; i++ ) {
+    if( FD_UNLIKELY( slots[ i ]>UINT_MAX ) ) FD_LOG_ERR(( "snapshot slot %lu exceeds 2^32-1, accdb format must be widened", slots[ i ] ));
+  }
+
+  snapshot_index_batch( accdb, fork_id, cnt, pubkeys, slots, lamports, data_lens, executables, file_offs,
+                        accounts_ignored, accounts_replaced, accounts_loaded, out_replaced_lamports, out_ignored_lamports );
+}
+
+static void
+snapshot_pread( fd_accdb_t * accdb,
+                uchar *      buf,
+                ulong        sz,
+                ulong        file_off ) {
+  ulong bytes_read = 0UL;
+  while( FD_LIKELY( bytes_read<sz ) ) {
+    long result = pread( accdb->fd, buf+bytes_read, sz-bytes_read, (long)(file_off+bytes_read) );
+    if( FD_UNLIKELY( -1==result && (errno==EINTR || errno==EAGAIN || errno==EWOULDBLOCK ) ) ) continue;
+    else if( FD_UNLIKELY( -1==result ) ) FD_LOG_ERR(( "pread() failed (%d-%s)", errno, fd_io_strerror( errno ) ));
+    else if( FD_UNLIKELY( !result ) ) FD_LOG_ERR(( "accounts database is corrupt, data expected at offset %lu with size %lu exceeded file extents",
+                                                   file_off+bytes_read, sz ));
+    fd_accdb_partition_read_bump( accdb, file_off+bytes_read, (ulong)result );
+    bytes_read += (ulong)result;
+  }
+}
+
+void
+fd_accdb_snapshot_lthash( fd_accdb_t *        accdb,
+                          fd_accdb_fork_id_t  fork_id,
+                          ulong               shard,
+                          ulong               shard_cnt,
+                          uchar *             buf,
+                          fd_lthash_value_t * sum ) {
+  int  incremental = fork_id.val!=USHORT_MAX;
+  uint fork_gen    = incremental ? accdb->fork_pool[ fork_id.val ].shmem->generation : 0U;
+  uint root_gen    = accdb->fork_pool[ accdb->shmem->root_fork_id.val ].shmem->generation;
+
+  fd_lthash_adder_t adder[1];
+  fd_lthash_adder_new( adder );
+
+  ulong chain_cnt = accdb->shmem->chain_cnt;
+  for( ulong chain=shard; chain<chain_cnt; chain+=shard_cnt ) {
+    for( uint idx=accdb->acc_map[ chain ]; idx!=UINT_MAX; idx=accdb->acc_pool[ idx ].map.next ) {
+      fd_accdb_accmeta_t const * acc = &accdb->acc_pool[ idx ];
+      if( FD_LIKELY( acc->map.next!=UINT_MAX ) ) __builtin_prefetch( &accdb->acc_pool[ acc->map.next ], 0, 1 );
+
+      /* An incremental override is linked in ahead of the rooted
+         version it shadows, so a rooted account is live unless an
+         earlier entry in its chain has the same pubkey. */
+      int live = acc->key.generation<=root_gen || ( incremental && acc->key.generation==fork_gen );
+      if( FD_UNLIKELY( live && incremental && acc->key.generation!=fork_gen ) ) {
+        for( uint j=accdb->acc_map[ chain ]; j!=idx; j=accdb->acc_pool[ j ].map.next ) {
+          if( FD_UNLIKELY( !memcmp( accdb->acc_pool[ j ].key.pubkey, acc->key.pubkey, 32UL ) ) ) { live = 0; break; }
+        }
+      }
+      if( FD_UNLIKELY( !live || !acc->lamports ) ) continue;
+
+      ulong data_len = FD_ACCDB_SIZE_DATA( acc->executable_size );
+      uchar exec     = (uchar)FD_ACCDB_SIZE_EXEC( acc->executable_size );
+      ulong file_off = fd_accdb_acc_offset( acc );
+      ulong rec_sz   = sizeof(fd_accdb_disk_meta_t)+data_len;
+
+      if( FD_LIKELY( rec_sz<=FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ ) ) {
+        snapshot_pread( accdb, buf, rec_sz, file_off );
+        fd_accdb_disk_meta_t const * meta = (fd_accdb_disk_meta_t const *)buf;
+        fd_lthash_adder_push_solana_account( adder, sum, acc->key.pubkey, buf+sizeof(fd_accdb_disk_meta_t), data_len,
+                                             acc->lamports, exec, meta->owner );
+        continue;
+      }
+
+      /* Too large for buf, stream the data through BLAKE3 in pieces.
+         The input layout matches fd_hashes_account_lthash_simple. */
+      fd_accdb_disk_meta_t meta[1];
+      snapshot_pread( accdb, meta->b, sizeof(fd_accdb_disk_meta_t), file_off );
+      fd_blake3_t b3[1];
+      fd_blake3_init( b3 );
+      fd_blake3_append( b3, &acc->lamports, sizeof(ulong) );
+      for( ulong off=0UL; off<data_len; off+=FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ ) {
+        ulong piece = fd_ulong_min( data_len-off, FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ );
+        snapshot_pread( accdb, buf, piece, file_off+sizeof(fd_accdb_disk_meta_t)+off );
+        fd_blake3_append( b3, buf, piece );
+      }
+      fd_blake3_append( b3, &exec,           1UL  );
+      fd_blake3_append( b3, meta->owner,     32UL );
+      fd_blake3_append( b3, acc->key.pubkey, 32UL );
+      fd_lthash_value_t value[1];
+      fd_blake3_fini_2048( b3, value->bytes );
+      fd_lthash_add( sum, value );
+    }
+  }
+
+  fd_lthash_adder_flush( adder, sum );
+  fd_lthash_adder_delete( adder );
+}
+
 static void
 delta_reset( fd_accdb_t * accdb ) {
   if( !accdb->shmem->delta.head ) return; /* clean */
@@ -4343,13 +4819,86 @@ fd_accdb_cache_class_thresholds( fd_accdb_t * accdb,
                                  ulong *      low_water_used ) {
   for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
     ulong max_c    = accdb->shmem->cache_class_max     [ c ];
-    ulong free_tgt = accdb->shmem->cache_free_target   [ c ];
-    ulong free_lwm = accdb->shmem->cache_free_low_water[ c ];
+    ulong free_tgt = FD_VOLATILE_CONST( accdb->shmem->cache_free_target   [ c ] );
+    ulong free_lwm = FD_VOLATILE_CONST( accdb->shmem->cache_free_low_water[ c ] );
     target_used   [ c ] = max_c>free_tgt ? max_c-free_tgt : 0UL;
     low_water_used[ c ] = max_c>free_lwm ? max_c-free_lwm : 0UL;
   }
 }
 
+void
+fd_accdb_cache_class_pressure( fd_accdb_t * accdb,
+                               ulong *      miss,
+                               ulong *      stall ) {
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    miss [ c ] = FD_VOLATILE_CONST( accdb->shmem->cache_class_pressure[ c ].miss  );
+    stall[ c ] = FD_VOLATILE_CONST( accdb->shmem->cache_class_pressure[ c ].stall );
+  }
+}
+
+/* The pre-eviction budget is the byte total of the init-time free
+   targets.  Half of it is pinned as a floor of base/2 lines per class,
+   so a class that goes quiet can still absorb a burst, and the other
+   half is handed out in proportion to each class's decayed pressure
+   score.  A foreground stall weighs 4x a miss: a miss served from the
+   free list costs one read, a stall additionally costs a CLOCK sweep
+   and possibly a synchronous writeback on the acquire path.  Targets
+   never exceed half of the lines above the min_reserved floor, so
+   pre-eviction cannot starve the reservations it exists to serve. */
+
+int
+fd_accdb_cache_rebalance( fd_accdb_t * accdb ) {
+  fd_accdb_shmem_t * shmem = accdb->shmem;
+
+  ulong score_sum = 0UL;
+  ulong budget    = 0UL;
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    ulong miss  = FD_VOLATILE_CONST( shmem->cache_class_pressure[ c ].miss  );
+    ulong stall = FD_VOLATILE_CONST( shmem->cache_class_pressure[ c ].stall );
+    ulong delta = (miss -accdb->rebalance.last_miss [ c ]) +
+                  (stall-accdb->rebalance.last_stall[ c ])*4UL;
+    accdb->rebalance.last_miss [ c ] = miss;
+    accdb->rebalance.last_stall[ c ] = stall;
+
+    /* score = 3/4 score + 1/4 delta, in 1/256 units.  The sample is
+       saturated so the weighting below cannot overflow. */
+    delta = fd_ulong_min( delta, 1UL<<40 );
+    accdb->rebalance.score[ c ] = (accdb->rebalance.score[ c ]*3UL + (delta<<8))>>2;
+
+    /* Below one event per interval a class is idle.  Without the
+       cutoff a lone class with a vanishing score would keep the whole
+       budget until the average reached exactly zero. */
+    if( accdb->rebalance.score[ c ]<256UL ) accdb->rebalance.score[ c ] = 0UL;
+
+    score_sum += accdb->rebalance.score[ c ];
+    budget    += shmem->cache_free_target_base[ c ]*fd_accdb_cache_slot_sz[ c ];
+  }
+
+  int changed = 0;
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    ulong base  = shmem->cache_free_target_base[ c ];
+    ulong max_c = shmem->cache_class_max[ c ];
+    ulong floor = fd_ulong_min( shmem->cache_min_reserved, max_c );
+    ulong ceil  = fd_ulong_max( (max_c-floor)/2UL, base );
+
+    ulong target = base;
+    if( FD_LIKELY( score_sum ) ) {
+      ulong weight = (accdb->rebalance.score[ c ]<<10) / score_sum; /* in [0,1024] */
+      ulong share  = ((budget/2UL)*weight)>>10;                     /* bytes */
+      target = fd_ulong_min( base/2UL + share/fd_accdb_cache_slot_sz[ c ], ceil );
+    }
+
+    if( target!=shmem->cache_free_target[ c ] ) {
+      FD_VOLATILE( shmem->cache_free_target   [ c ] ) = target;
+      FD_VOLATILE( shmem->cache_free_low_water[ c ] ) = (target*3UL)/4UL;
+      changed = 1;
+    }
+  }
+
+  accdb->metrics->cache_rebalances += (ulong)changed;
+  return changed;
+}
+
 #if FD_HAS_RACESAN
 
 /* Force pre-eviction (ignore the watermark) so a deterministic
@@ -3,6 +3,8 @@
 
 #include "fd_accdb_base.h"
 #include "fd_accdb_shmem.h"
+#include "../../ballet/lthash/fd_lthash.h"
+#include "../../util/io_uring/fd_io_uring.h"
 
 /* The accdb is a fork aware database that can be queried to get the
    current state of any accounts as-of a given fork, and update them. */
@@ -89,6 +91,67 @@ fd_accdb_new( void *              ljoin,
 fd_accdb_t *
 fd_accdb_join( void * shaccdb );
 
+/* fd_accdb_attach_io_uring makes the writer joiner accdb serve the
+   cache misses of fd_accdb_acquire{,_a,_b} through ring: instead of one
+   blocking preadv2 per missing account, all disk reads of an acquire
+   (up to FD_ACCDB_MAX_ACQUIRE_CNT accounts for a batch) are submitted
+   to the kernel at once and reaped together, such that an acquire
+   with many cold accounts waits for roughly one device round trip
+   rather than one per account.  The acquire still returns only once
+   all of its reads have completed.
+
+   ring must be an enabled io_uring instance owned by the caller's
+   thread (IORING_SETUP_SINGLE_ISSUER), with the accounts file
+   registered as fixed file 0, permitting FD_IORING_OP_READ with
+   IOSQE_FIXED_FILE, and with a completion queue at least as deep as
+   its submission queue.  The ring must not have any other requests in
+   flight while an acquire is in progress.  Pass ring==NULL to go back
+   to preadv2.  Returns accdb on success and NULL (logs details) on
+   failure. */
+
+fd_accdb_t *
+fd_accdb_attach_io_uring( fd_accdb_t *    accdb,
+                          fd_io_uring_t * ring );
+
+/* fd_accdb_io_uring_init creates an io_uring instance in ring that is
+   suitable for fd_accdb_attach_io_uring.  shmem points to a memory
+   region with fd_io_uring_shmem_{align,footprint}( depth, depth ) that
+   holds the rings, depth is a power of two and fd is the accounts file
+   (as given to fd_accdb_new).  The ring is restricted to reading from
+   fd, such that it can be handed to a sandboxed tile (which then only
+   needs io_uring_enter on ring->ioring_fd).  Must be called from the
+   thread that will do the acquires.  Returns ring on success and NULL
+   on failure (logs details, e.g. io_uring not supported by the kernel).
+   Free with fd_io_uring_fini. */
+
+fd_io_uring_t *
+fd_accdb_io_uring_init( fd_io_uring_t * ring,
+                        void *          shmem,
+                        ulong           depth,
+                        int             fd );
+
+/* fd_accdb_io_uring_{align,footprint} give the alignment and footprint
+   of the ring memory for an io_uring of the given depth.  footprint is
+   0 if depth is 0 (no io_uring).
+
+   fd_accdb_io_uring_setup is fd_accdb_io_uring_init for tiles with an
+   optional io_uring.  If depth is 0, marks ring as unused
+   (ring->ioring_fd is -1).  Otherwise creates the ring in shmem (with
+   the above alignment and footprint).  Called from privileged_init,
+   before the tile is sandboxed.  Terminates the process on failure. */
+
+ulong
+fd_accdb_io_uring_align( void );
+
+ulong
+fd_accdb_io_uring_footprint( ulong depth );
+
+void
+fd_accdb_io_uring_setup( fd_io_uring_t * ring,
+                         void *          shmem,
+                         ulong           depth,
+                         int             fd );
+
 /* fd_accdb_join_readonly is the read-only counterpart of fd_accdb_new +
    fd_accdb_join.  shmem_ro may point into a read-only mapping of the
    shmem region; the function will not write to it.  my_epoch_slot_rw
@@ -488,6 +551,78 @@ fd_accdb_lamports( fd_accdb_t *       accdb,
                    fd_accdb_fork_id_t fork_id,
                    uchar const *      pubkey );
 
+/* fd_accdb_fork_writes copies into out_pubkeys the addresses of up to
+   out_max accounts that were written on fork_id itself (not on any of
+   its ancestors), in no particular order.  *cursor should be zero on
+   the first call, and is updated so that a subsequent call resumes
+   where this one left off.  It is set to ULONG_MAX once every write
+   has been returned.  Returns the number of addresses copied.
+
+   The caller must ensure that fork_id is frozen and that it is neither
+   rooted nor purged until the iteration is done, for example by holding
+   a reference on the bank that owns it.  Supported on a readonly
+   join. */
+
+ulong
+fd_accdb_fork_writes( fd_accdb_t *       accdb,
+                      fd_accdb_fork_id_t fork_id,
+                      ulong *            cursor,
+                      uchar              out_pubkeys[][ 32 ],
+                      ulong              out_max );
+
+/* fd_accdb_chain_cnt returns the number of hash chains in the account
+   index.  fd_accdb_scan_chain copies into out_pubkeys, in increasing
+   byte order, up to out_max of the distinct addresses of the accounts
+   with at least one version (on any fork) in chain chain_idx, in
+   [0,fd_accdb_chain_cnt), that are greater than after (NULL to start
+   from the beginning of the chain).  Returns the number of addresses
+   copied.  If that is out_max, the chain may hold more: call again with
+   after set to the last address copied.  Chains are short (two entries
+   on average at full occupancy), so a single call usually suffices, but
+   there is no bound on the length of a chain.  Each call walks the
+   whole chain.
+
+   Visiting every chain visits every account in the database, which
+   lets a caller build a derived index incrementally without stalling.
+   Accounts inserted into an already visited chain (or part of a chain)
+   concurrently with the scan are not reported.  Supported on a readonly
+   join. */
+
+ulong
+fd_accdb_chain_cnt( fd_accdb_t const * accdb );
+
+ulong
+fd_accdb_scan_chain( fd_accdb_t *  accdb,
+                     ulong         chain_idx,
+                     uchar const * after,
+                     uchar         out_pubkeys[][ 32 ],
+                     ulong         out_max );
+
+/* fd_accdb_prefetch hints that the account at fork_id will soon be
+   acquired.  If the account exists but is not resident in the cache,
+   a readahead of its on-disk record is issued so that the eventual
+   cache fill is served from the page cache rather than the device.
+   Does not wait for the read to complete, but the hint is submitted
+   with readahead(2), which usually only queues the read and can still
+   block (e.g. when the device request queue is full or file metadata
+   has to be read first), so it is best issued when the caller is
+   otherwise idle.  Takes no reference and never modifies any cache
+   line, so it can be called from any full join at any time.
+
+   Returns FD_ACCDB_PREFETCH_ISSUED if a readahead was issued,
+   FD_ACCDB_PREFETCH_CACHED if the account was already resident (or
+   the hint could not be issued) and FD_ACCDB_PREFETCH_MISSING if the
+   account does not exist on fork_id. */
+
+#define FD_ACCDB_PREFETCH_MISSING (0)
+#define FD_ACCDB_PREFETCH_CACHED  (1)
+#define FD_ACCDB_PREFETCH_ISSUED  (2)
+
+int
+fd_accdb_prefetch( fd_accdb_t *       accdb,
+                   fd_accdb_fork_id_t fork_id,
+                   uchar const *      pubkey );
+
 /* fd_accdb_reset reinitializes the accdb to the state immediately after
    fd_accdb_new.  All in-memory index state is cleared and all pool
    joins are re-established.  The caller is responsible for truncating
@@ -571,6 +706,101 @@ fd_accdb_snapshot_write_batch( fd_accdb_t *        accdb,
                                ulong *             out_replaced_lamports,
                                ulong *             out_ignored_lamports );
 
+/* fd_accdb_snapshot_batch_dup returns 1 if two of the cnt pubkeys
+   are equal, in which case *dup_i and *dup_j (dup_j<dup_i) are set to
+   the indices of the first such pair, and 0 otherwise. */
+
+static inline int
+fd_accdb_snapshot_batch_dup( ulong               cnt,
+                             uchar const * const pubkeys[],
+                             ulong *             dup_i,
+                             ulong *             dup_j ) {
+  for( ulong i=1UL; i<cnt; i++ ) {
+    for( ulong j=0UL; j<i; j++ ) {
+      if( FD_UNLIKELY( !memcmp( pubkeys[ j ], pubkeys[ i ], 32UL ) ) ) {
+        *dup_i = i;
+        *dup_j = j;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/* fd_accdb_snapshot_{reserve,shard,index_batch} split
+   fd_accdb_snapshot_write_batch so that account indexing can be spread
+   over several joiners while the on-disk layout stays in stream order.
+
+   fd_accdb_snapshot_reserve reserves disk space for the next account
+   of the snapshot stream, which has data_len bytes of data, and
+   returns its file offset.  It must be called by a single joiner for
+   every account in stream order, exactly as the write head would be
+   advanced by fd_accdb_snapshot_write_{one,batch}, since snapwr lays
+   out the file independently in that order.
+
+   fd_accdb_snapshot_shard returns the shard in [0,shard_cnt) that
+   pubkey belongs to.  Accounts in different shards never share a hash
+   chain.
+
+   fd_accdb_snapshot_index_batch is fd_accdb_snapshot_write_batch for
+   up to 8 accounts whose disk space file_offs[i] was reserved with
+   fd_accdb_snapshot_reserve.  It may be called concurrently by
+   different joiners provided every joiner only passes accounts of its
+   own shard, and that accounts of a shard are passed in stream order
+   (which preserves the newest slot wins rule for duplicates).  The
+   caller is responsible for rejecting intra-batch duplicates (see
+   fd_accdb_snapshot_batch_dup). */
+
+ulong
+fd_accdb_snapshot_reserve( fd_accdb_t * accdb,
+                           ulong        data_len );
+
+ulong
+fd_accdb_snapshot_shard( fd_accdb_t const * accdb,
+                         uchar const *      pubkey,
+                         ulong              shard_cnt );
+
+void
+fd_accdb_snapshot_index_batch( fd_accdb_t *        accdb,
+                               fd_accdb_fork_id_t  fork_id,
+                               ulong               cnt,
+                               uchar const * const pubkeys[],
+                               ulong  const        slots[],
+                               ulong  const        lamports[],
+                               ulong  const        data_lens[],
+                               int    const        executables[],
+                               ulong  const        file_offs[],
+                               ulong *             accounts_ignored,
+                               ulong *             accounts_replaced,
+                               ulong *             accounts_loaded,
+                               ulong *             out_replaced_lamports,
+                               ulong *             out_ignored_lamports );
+
+/* fd_accdb_snapshot_lthash adds to sum the LtHash of every account of
+   shard (see fd_accdb_snapshot_shard) that is live at the end of a
+   snapshot load.  fork_id is USHORT_MAX after a full snapshot, in
+   which case only rooted accounts are visible, or the incremental fork
+   after an incremental snapshot, in which case its accounts shadow the
+   rooted versions they override.  Zero lamport accounts hash to zero
+   as usual.  Account data is read back from disk, so this must only be
+   called once the snapwr tile has written out the whole snapshot.
+
+   buf is scratch space of FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ bytes.
+   Accounts that do not fit are streamed through it.  Different shards
+   may be hashed concurrently by different joiners, and since LtHash
+   addition commutes, the sum over all shards is the accounts LtHash of
+   the snapshot. */
+
+#define FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ (1UL<<20)
+
+void
+fd_accdb_snapshot_lthash( fd_accdb_t *        accdb,
+                          fd_accdb_fork_id_t  fork_id,
+                          ulong               shard,
+                          ulong               shard_cnt,
+                          uchar *             buf,
+                          fd_lthash_value_t * sum );
+
 /* fd_accdb_background performs one unit of background work.
 
    THREADING MODEL
@@ -655,13 +885,41 @@ fd_accdb_cache_class_occupancy( fd_accdb_t * accdb,
    used count the background preevict pass tries to drive towards (max -
    cache_free_target).  low_water_used[c] is the used count at which the
    preevict pass starts firing (max - cache_free_low_water).  Both are
-   set once at init and are stable for the lifetime of the cache. */
+   seeded at init and move whenever fd_accdb_cache_rebalance retunes
+   the class. */
 
 void
 fd_accdb_cache_class_thresholds( fd_accdb_t * accdb,
                                  ulong *      target_used,
                                  ulong *      low_water_used );
 
+/* fd_accdb_cache_class_pressure snapshots the cumulative per-size-class
+   cache pressure counters shared by all joiners.  miss[c] is the number
+   of class c lines allocated to load an account that was not resident.
+   stall[c] is the number of class c lines an acquire had to reclaim
+   itself with a CLOCK sweep because background preeviction had not
+   left a free line.  Each output array must have
+   FD_ACCDB_CACHE_CLASS_CNT entries. */
+
+void
+fd_accdb_cache_class_pressure( fd_accdb_t * accdb,
+                               ulong *      miss,
+                               ulong *      stall );
+
+/* fd_accdb_cache_rebalance samples the pressure counters since the
+   previous call and redistributes the background preevict budget
+   (the per-class free targets and low water marks) towards the classes
+   that are missing and stalling the most.  The slot capacity of each
+   class is fixed at shmem creation, so what moves between classes is
+   how many of their slots are kept free ahead of demand, bounded so no
+   class preevicts into its min_reserved floor.  With no pressure the
+   targets decay back to their init-time values.  Must only be called
+   from a single joiner (the accdb tile), at a roughly fixed interval.
+   Returns 1 if any class was retuned and 0 otherwise. */
+
+int
+fd_accdb_cache_rebalance( fd_accdb_t * accdb );
+
 /* FD_ACCDB_METRICS_WRITE publishes the per-joiner accdb runtime metrics
    for tile prefix TILE.  TILE must be a tile that declares the
    AccdbAccountAcquired/... counters in metrics.xml (e.g. EXECLE,
@@ -446,11 +446,24 @@ struct fd_accdb_shmem_private {
      */
   ulong cache_region_off[ FD_ACCDB_CACHE_CLASS_CNT ];
 
-  /* Background pre-eviction watermarks (computed once in shmem_new).
+  /* Background pre-eviction watermarks.  Seeded in shmem_new and
+     retuned at runtime by fd_accdb_cache_rebalance (single writer, the
+     accdb tile).
+     cache_free_target_base[c]: init-time target, the rebalance budget.
      cache_free_target[c]: desired free-list depth for class c.
      cache_free_low_water[c]: trigger threshold ((target*3)/4). */
-  ulong cache_free_target   [ FD_ACCDB_CACHE_CLASS_CNT ];
-  ulong cache_free_low_water[ FD_ACCDB_CACHE_CLASS_CNT ];
+  ulong cache_free_target_base[ FD_ACCDB_CACHE_CLASS_CNT ];
+  ulong cache_free_target     [ FD_ACCDB_CACHE_CLASS_CNT ];
+  ulong cache_free_low_water  [ FD_ACCDB_CACHE_CLASS_CNT ];
+
+  /* Per-class cache pressure counters, shared by all joiners and
+     sampled by fd_accdb_cache_rebalance.  miss counts cache lines
+     allocated to load a non-resident account, stall counts lines an
+     acquire had to reclaim with a foreground CLOCK sweep because the
+     free list and the lazy-init tail were both empty.  Both are only
+     bumped on paths that already go to disk.  Each element is on its
+     own cacheline to avoid false sharing between classes. */
+  struct __attribute__((aligned(64))) { ulong miss; ulong stall; } cache_class_pressure[ FD_ACCDB_CACHE_CLASS_CNT ];
 
   /* cache_class_used[i].val holds the number of reserved cache
      slots in size class i.  Acquire atomically increments; if the
@@ -363,8 +363,11 @@ fd_accdb_shmem_new( void * shmem,
     ulong cap         = fd_ulong_min( 8192UL, (64UL<<20) / fd_accdb_cache_slot_sz[ c ] );
     ulong burst_floor = fd_ulong_min( 512UL, headroom/2UL );
     ulong target      = fd_ulong_min( cap, fd_ulong_max( headroom/10UL, burst_floor ) );
-    accdb->cache_free_target   [ c ] = target;
-    accdb->cache_free_low_water[ c ] = (target * 3UL) / 4UL;
+    accdb->cache_free_target_base[ c ] = target;
+    accdb->cache_free_target     [ c ] = target;
+    accdb->cache_free_low_water  [ c ] = (target * 3UL) / 4UL;
+    accdb->cache_class_pressure  [ c ].miss  = 0UL;
+    accdb->cache_class_pressure  [ c ].stall = 0UL;
   }
 
   for( ulong k=0UL; k<FD_ACCDB_COMPACTION_LAYER_CNT; k++ ) {
@@ -43,6 +43,7 @@ struct fd_accdb_metrics {
   ulong accounts_evicted_per_class[ FD_ACCDB_CACHE_CLASS_CNT ];
   ulong accounts_preevicted;
   ulong accounts_preevicted_per_class[ FD_ACCDB_CACHE_CLASS_CNT ];
+  ulong cache_rebalances;
   ulong accounts_committed_new_per_class[ FD_ACCDB_CACHE_CLASS_CNT ];
   ulong accounts_committed_overwrite_per_class[ FD_ACCDB_CACHE_CLASS_CNT ];
   ulong accounts_not_found_per_class[ FD_ACCDB_CACHE_CLASS_CNT ];
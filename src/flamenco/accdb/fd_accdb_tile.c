@@ -19,11 +19,19 @@
    (optional). */
 #define FD_ACCDB_TILE_MAX_EXTERNAL_EPOCHS (128UL)
 
+/* Interval between cache size class rebalances.  Long enough that a
+   sample covers many slots worth of acquires, short enough to follow a
+   shift in workload within a few seconds. */
+#define FD_ACCDB_TILE_REBALANCE_INTERVAL_NS (250L*1000L*1000L)
+
 struct fd_accdb_tile_ctx {
   fd_accdb_t * accdb;
 
   fd_startup_gate_t startup_gate[1];
 
+  long rebalance_interval; /* in ticks */
+  long next_rebalance;
+
   ulong seed;
 };
 
@@ -80,6 +88,22 @@ metrics_write( fd_accdb_tile_ctx_t * ctx ) {
   fd_accdb_cache_class_thresholds( ctx->accdb, cache_target_used, cache_lwm_used );
   FD_MGAUGE_ENUM_COPY( ACCDB, CACHE_CLASS_TARGET_USED,    cache_target_used );
   FD_MGAUGE_ENUM_COPY( ACCDB, CACHE_CLASS_LOW_WATER_USED, cache_lwm_used    );
+
+  ulong cache_miss [ FD_ACCDB_CACHE_CLASS_CNT ];
+  ulong cache_stall[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_pressure( ctx->accdb, cache_miss, cache_stall );
+  FD_MCNT_ENUM_COPY( ACCDB, CACHE_CLASS_MISS,  cache_miss  );
+  FD_MCNT_ENUM_COPY( ACCDB, CACHE_CLASS_STALL, cache_stall );
+  FD_MCNT_SET( ACCDB, CACHE_REBALANCED, rt->cache_rebalances );
+}
+
+static inline void
+during_housekeeping( fd_accdb_tile_ctx_t * ctx ) {
+  long now = fd_tickcount();
+  if( FD_UNLIKELY( now>=ctx->next_rebalance ) ) {
+    fd_accdb_cache_rebalance( ctx->accdb );
+    ctx->next_rebalance = now + ctx->rebalance_interval;
+  }
 }
 
 static inline void
@@ -155,6 +179,9 @@ unprivileged_init( fd_topo_t const *      topo,
 
   fd_startup_gate_init( ctx->startup_gate, topo, tile->in_cnt );
 
+  ctx->rebalance_interval = (long)( fd_tempo_tick_per_ns( NULL )*(double)FD_ACCDB_TILE_REBALANCE_INTERVAL_NS );
+  ctx->next_rebalance     = fd_tickcount() + ctx->rebalance_interval;
+
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
   if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
     FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
@@ -190,11 +217,12 @@ populate_allowed_fds( fd_topo_t const *      topo,
 #define STEM_BURST (1UL)
 #define STEM_LAZY  (128L*3000L)
 
-#define STEM_CALLBACK_CONTEXT_TYPE  fd_accdb_tile_ctx_t
-#define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_accdb_tile_ctx_t)
+#define STEM_CALLBACK_CONTEXT_TYPE        fd_accdb_tile_ctx_t
+#define STEM_CALLBACK_CONTEXT_ALIGN       alignof(fd_accdb_tile_ctx_t)
 
-#define STEM_CALLBACK_METRICS_WRITE metrics_write
-#define STEM_CALLBACK_BEFORE_CREDIT before_credit
+#define STEM_CALLBACK_METRICS_WRITE       metrics_write
+#define STEM_CALLBACK_DURING_HOUSEKEEPING during_housekeeping
+#define STEM_CALLBACK_BEFORE_CREDIT       before_credit
 
 #include "../../disco/stem/fd_stem.c"
 
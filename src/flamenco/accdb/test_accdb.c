@@ -4,6 +4,7 @@
 #include "fd_accdb_cache.h"
 #include "fd_accdb_private.h"
 #include "../../util/fd_util.h"
+#include "../../util/io_uring/fd_io_uring_setup.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -1519,6 +1520,302 @@ test_deferred_write_stats_two_joiners( void ) {
   test_teardown( accdb_a, fd );
 }
 
+/* test_snapshot_index_sharded loads the same account stream once with
+   fd_accdb_snapshot_write_batch and once sharded over several joiners
+   that index concurrently, with the disk space reserved up front in
+   stream order, and checks the two end up identical. */
+
+#define SHARD_ACC_CNT  (2048UL)
+#define SHARD_KEY_CNT  (1500UL)
+#define SHARD_CNT      (3UL)
+
+typedef struct {
+  uchar pubkey[ SHARD_ACC_CNT ][ 32UL ];
+  ulong slot    [ SHARD_ACC_CNT ];
+  ulong lamports[ SHARD_ACC_CNT ];
+  ulong data_len[ SHARD_ACC_CNT ];
+  ulong file_off[ SHARD_ACC_CNT ];
+  ulong shard   [ SHARD_ACC_CNT ];
+} test_shard_stream_t;
+
+typedef struct {
+  fd_accdb_t *                accdb;
+  test_shard_stream_t const * stream;
+  fd_accdb_fork_id_t          fork_id;
+  ulong                       shard;
+  ulong                       counts[ 5 ];
+} test_shard_ctx_t;
+
+static void
+test_shard_count( ulong       counts[ 5 ],
+                  ulong       ignored,
+                  ulong       replaced,
+                  ulong       loaded,
+                  ulong       replaced_lamports,
+                  ulong       ignored_lamports ) {
+  counts[ 0 ] += ignored;
+  counts[ 1 ] += replaced;
+  counts[ 2 ] += loaded;
+  counts[ 3 ] += replaced_lamports;
+  counts[ 4 ] += ignored_lamports;
+}
+
+static void *
+run_shard( void * _ctx ) {
+  test_shard_ctx_t *          ctx = _ctx;
+  test_shard_stream_t const * s   = ctx->stream;
+
+  uchar const * pubkeys  [ 8 ];
+  ulong         slots    [ 8 ];
+  ulong         lamports [ 8 ];
+  ulong         data_lens[ 8 ];
+  int           execs    [ 8 ] = { 0 };
+  ulong         offs     [ 8 ];
+  ulong         cnt = 0UL;
+  for( ulong i=0UL; i<=SHARD_ACC_CNT; i++ ) {
+    if( i<SHARD_ACC_CNT && s->shard[ i ]!=ctx->shard ) continue;
+
+    /* Flush at the end of the stream, when the batch is full, or
+       before a pubkey that is already in the batch. */
+    int flush = i==SHARD_ACC_CNT || cnt==8UL;
+    for( ulong j=0UL; !flush && j<cnt; j++ ) flush = !memcmp( pubkeys[ j ], s->pubkey[ i ], 32UL );
+    if( flush && cnt ) {
+      ulong ignored, replaced, loaded, replaced_lamports, ignored_lamports;
+      fd_accdb_snapshot_index_batch( ctx->accdb, ctx->fork_id, cnt, pubkeys, slots, lamports, data_lens, execs, offs,
+                                     &ignored, &replaced, &loaded, &replaced_lamports, &ignored_lamports );
+      test_shard_count( ctx->counts, ignored, replaced, loaded, replaced_lamports, ignored_lamports );
+      cnt = 0UL;
+    }
+    if( i==SHARD_ACC_CNT ) break;
+
+    pubkeys  [ cnt ] = s->pubkey  [ i ];
+    slots    [ cnt ] = s->slot    [ i ];
+    lamports [ cnt ] = s->lamports[ i ];
+    data_lens[ cnt ] = s->data_len[ i ];
+    offs     [ cnt ] = s->file_off[ i ];
+    cnt++;
+  }
+  return NULL;
+}
+
+static void
+test_snapshot_index_sharded( void ) {
+  static test_shard_stream_t s[1];
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 7U, 0UL ) );
+
+  /* Every pubkey is written once and some again later in the stream,
+     at an older or a newer slot. */
+  for( ulong i=0UL; i<SHARD_ACC_CNT; i++ ) {
+    ulong key = i%SHARD_KEY_CNT;
+    memset( s->pubkey[ i ], 0, 32UL );
+    FD_STORE( ulong, s->pubkey[ i ],     fd_ulong_hash( key ) );
+    FD_STORE( ulong, s->pubkey[ i ]+8UL, key                  );
+    s->slot    [ i ] = 1UL+fd_rng_ulong_roll( rng, 100UL );
+    s->lamports[ i ] = 1UL+i;
+    s->data_len[ i ] = fd_rng_ulong_roll( rng, 512UL );
+  }
+
+  /* Reference load. */
+
+  int fd;
+  fd_accdb_t * accdb = test_setup( &fd, 4096UL, 64UL, 8192UL, 8192UL, 1UL<<30UL );
+  fd_accdb_shmem_metrics_t const * shmetrics = fd_accdb_shmetrics( accdb );
+
+  fd_accdb_fork_id_t root = fd_accdb_attach_child( accdb, SENTINEL );
+  fd_accdb_snapshot_load_begin( accdb );
+  ulong ref_counts[ 5 ] = { 0UL };
+  for( ulong i=0UL; i<SHARD_ACC_CNT; i+=8UL ) {
+    uchar const * pubkeys[ 8 ];
+    int           execs  [ 8 ] = { 0 };
+    for( ulong j=0UL; j<8UL; j++ ) pubkeys[ j ] = s->pubkey[ i+j ];
+    ulong ignored, replaced, loaded, replaced_lamports, ignored_lamports;
+    FD_TEST( !fd_accdb_snapshot_write_batch( accdb, SENTINEL, 8UL, pubkeys, s->slot+i, s->lamports+i, s->data_len+i, execs,
+                                             &ignored, &replaced, &loaded, &replaced_lamports, &ignored_lamports ) );
+    test_shard_count( ref_counts, ignored, replaced, loaded, replaced_lamports, ignored_lamports );
+  }
+  fd_accdb_snapshot_recovery_t ref_recovery;
+  fd_accdb_snapshot_save_whead( accdb, &ref_recovery );
+  fd_accdb_snapshot_load_end( accdb );
+
+  ulong ref_accounts_total = shmetrics->accounts_total;
+  ulong ref_disk_used      = shmetrics->disk_used_bytes;
+  FD_TEST( ref_counts[ 2 ]==SHARD_KEY_CNT );
+  FD_TEST( ref_counts[ 0 ]+ref_counts[ 1 ]==SHARD_ACC_CNT-SHARD_KEY_CNT );
+
+  static ulong ref_lamports[ SHARD_KEY_CNT ];
+  for( ulong k=0UL; k<SHARD_KEY_CNT; k++ ) {
+    ulong data_len;
+    FD_TEST( accdb_read( accdb, root, s->pubkey[ k ], &ref_lamports[ k ], NULL, &data_len, NULL ) );
+  }
+  test_teardown( accdb, fd );
+
+  /* Sharded load. */
+
+  accdb = test_setup_ex( &fd, 4096UL, 64UL, 8192UL, 8192UL, 1UL<<30UL,
+                         TEST_CACHE_FOOTPRINT, TEST_CACHE_MIN_RESERVED, 1UL+SHARD_CNT );
+  shmetrics = fd_accdb_shmetrics( accdb );
+
+  root = fd_accdb_attach_child( accdb, SENTINEL );
+  fd_accdb_snapshot_load_begin( accdb );
+
+  ulong shard_hit[ SHARD_CNT ] = { 0UL };
+  for( ulong i=0UL; i<SHARD_ACC_CNT; i++ ) {
+    s->file_off[ i ] = fd_accdb_snapshot_reserve( accdb, s->data_len[ i ] );
+    s->shard   [ i ] = fd_accdb_snapshot_shard( accdb, s->pubkey[ i ], SHARD_CNT );
+    FD_TEST( s->shard[ i ]<SHARD_CNT );
+    FD_TEST( !i || s->file_off[ i ]>s->file_off[ i-1UL ] );
+    shard_hit[ s->shard[ i ] ]++;
+  }
+  for( ulong j=0UL; j<SHARD_CNT; j++ ) FD_TEST( shard_hit[ j ] );
+
+  test_shard_ctx_t ctx[ SHARD_CNT ];
+  pthread_t        thread[ SHARD_CNT ];
+  for( ulong j=0UL; j<SHARD_CNT; j++ ) {
+    ctx[ j ] = (test_shard_ctx_t){ .accdb = test_join_writer( fd ), .stream = s, .fork_id = SENTINEL, .shard = j };
+    FD_TEST( !pthread_create( &thread[ j ], NULL, run_shard, &ctx[ j ] ) );
+  }
+  ulong counts[ 5 ] = { 0UL };
+  for( ulong j=0UL; j<SHARD_CNT; j++ ) {
+    FD_TEST( !pthread_join( thread[ j ], NULL ) );
+    for( ulong k=0UL; k<5UL; k++ ) counts[ k ] += ctx[ j ].counts[ k ];
+  }
+
+  fd_accdb_snapshot_recovery_t recovery;
+  fd_accdb_snapshot_save_whead( accdb, &recovery );
+  fd_accdb_snapshot_load_end( accdb );
+
+  for( ulong k=0UL; k<5UL; k++ ) FD_TEST( counts[ k ]==ref_counts[ k ] );
+  FD_TEST( shmetrics->accounts_total ==ref_accounts_total );
+  FD_TEST( shmetrics->disk_used_bytes==ref_disk_used      );
+  FD_TEST( recovery.disk_current_bytes==ref_recovery.disk_current_bytes );
+
+  for( ulong k=0UL; k<SHARD_KEY_CNT; k++ ) {
+    ulong lamports, data_len;
+    FD_TEST( accdb_read( accdb, root, s->pubkey[ k ], &lamports, NULL, &data_len, NULL ) );
+    FD_TEST( lamports==ref_lamports[ k ] );
+  }
+
+  for( ulong j=0UL; j<SHARD_CNT; j++ ) free( ctx[ j ].accdb );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  test_teardown( accdb, fd );
+}
+
+/* test_snapshot_lthash loads accounts the way the snapshot pipeline
+   does (index the account, and write its record where snapwr would)
+   and checks that the sum of fd_accdb_snapshot_lthash over all shards
+   only covers the live version of each account, both after a full
+   and after an incremental snapshot. */
+
+#define LTHASH_KEY_CNT (72UL)
+#define LTHASH_BIG_SZ  ((3UL<<20)/2UL)
+
+static uchar             lthash_data[ LTHASH_BIG_SZ ];
+static fd_lthash_value_t lthash_live[ LTHASH_KEY_CNT ]; /* by key */
+
+static void
+lthash_put( fd_accdb_t *       accdb,
+            int                fd,
+            fd_rng_t *         rng,
+            fd_accdb_fork_id_t fork_id,
+            ulong              key,
+            ulong              slot,
+            ulong              lamports,
+            ulong              data_len ) {
+  uchar pubkey[ 32UL ] = { 0xE0, (uchar)key };
+  uchar owner [ 32UL ] = { 0xE1, (uchar)fd_rng_uint( rng ) };
+  int   exec           = (int)(fd_rng_uint( rng )&1U);
+  for( ulong i=0UL; i<data_len; i++ ) lthash_data[ i ] = fd_rng_uchar( rng );
+
+  ulong file_off = fd_accdb_snapshot_reserve( accdb, data_len );
+  fd_accdb_disk_meta_t meta = {0};
+  fd_memcpy( meta.pubkey, pubkey, 32UL );
+  fd_memcpy( meta.owner,  owner,  32UL );
+  meta.size = FD_ACCDB_SIZE_PACK( data_len, exec );
+  FD_TEST( pwrite( fd, meta.b,      sizeof(meta), (long)file_off                )==(long)sizeof(meta) );
+  FD_TEST( pwrite( fd, lthash_data, data_len,     (long)(file_off+sizeof(meta)) )==(long)data_len     );
+
+  uchar const * pubkeys[ 1 ] = { pubkey };
+  ulong ignored, replaced, loaded, replaced_lamports, ignored_lamports;
+  fd_accdb_snapshot_index_batch( accdb, fork_id, 1UL, pubkeys, &slot, &lamports, &data_len, &exec, &file_off,
+                                 &ignored, &replaced, &loaded, &replaced_lamports, &ignored_lamports );
+  if( ignored ) return;
+
+  fd_lthash_zero( &lthash_live[ key ] );
+  if( !lamports ) return;
+  uchar exec_flag = (uchar)exec;
+  fd_blake3_t b3[1];
+  fd_blake3_init( b3 );
+  fd_blake3_append( b3, &lamports,   sizeof(ulong) );
+  fd_blake3_append( b3, lthash_data, data_len      );
+  fd_blake3_append( b3, &exec_flag,  1UL           );
+  fd_blake3_append( b3, owner,       32UL          );
+  fd_blake3_append( b3, pubkey,      32UL          );
+  fd_blake3_fini_2048( b3, lthash_live[ key ].bytes );
+}
+
+static void
+lthash_check( fd_accdb_t *       accdb,
+              fd_accdb_fork_id_t fork_id ) {
+  static uchar buf[ FD_ACCDB_SNAPSHOT_LTHASH_BUF_SZ ];
+
+  fd_lthash_value_t expected[1];
+  fd_lthash_zero( expected );
+  for( ulong k=0UL; k<LTHASH_KEY_CNT; k++ ) fd_lthash_add( expected, &lthash_live[ k ] );
+
+  fd_lthash_value_t sum[1];
+  fd_lthash_zero( sum );
+  for( ulong shard=0UL; shard<3UL; shard++ ) fd_accdb_snapshot_lthash( accdb, fork_id, shard, 3UL, buf, sum );
+  FD_TEST( fd_lthash_eq( sum, expected ) );
+
+  fd_lthash_zero( sum );
+  fd_accdb_snapshot_lthash( accdb, fork_id, 0UL, 1UL, buf, sum );
+  FD_TEST( fd_lthash_eq( sum, expected ) );
+}
+
+static void
+test_snapshot_lthash( void ) {
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 11U, 0UL ) );
+
+  int fd;
+  fd_accdb_t * accdb = test_setup( &fd, 1024UL, 64UL, 8192UL, 8192UL, 1UL<<30UL );
+  memset( lthash_live, 0, sizeof(lthash_live) );
+
+  /* Full snapshot: key 0 has no lamports, key 1 does not fit in the
+     scratch buffer, keys 2..9 are replaced by a newer version and key
+     10 ignores an older one. */
+  fd_accdb_fork_id_t root = fd_accdb_attach_child( accdb, SENTINEL );
+  fd_accdb_snapshot_load_begin( accdb );
+  for( ulong k=0UL; k<64UL; k++ ) {
+    ulong data_len = fd_ulong_if( k==1UL, LTHASH_BIG_SZ, fd_rng_ulong_roll( rng, 600UL ) );
+    lthash_put( accdb, fd, rng, SENTINEL, k, 10UL, k, data_len );
+  }
+  for( ulong k=2UL; k<10UL; k++ ) lthash_put( accdb, fd, rng, SENTINEL, k, 11UL, 1000UL+k, fd_rng_ulong_roll( rng, 600UL ) );
+  lthash_put( accdb, fd, rng, SENTINEL, 10UL, 5UL, 7UL, 100UL );
+  fd_accdb_snapshot_load_end( accdb );
+  lthash_check( accdb, SENTINEL );
+
+  /* Incremental snapshot: keys 20..29 are overridden (key 21 is
+     deleted), keys 64.. are new. */
+  fd_lthash_value_t full_live[ LTHASH_KEY_CNT ];
+  fd_memcpy( full_live, lthash_live, sizeof(lthash_live) );
+  fd_accdb_fork_id_t incr = fd_accdb_attach_child( accdb, root );
+  fd_accdb_snapshot_load_begin( accdb );
+  for( ulong k=20UL; k<30UL; k++ ) lthash_put( accdb, fd, rng, incr, k, 20UL, fd_ulong_if( k==21UL, 0UL, 2000UL+k ), fd_rng_ulong_roll( rng, 600UL ) );
+  for( ulong k=64UL; k<LTHASH_KEY_CNT; k++ ) lthash_put( accdb, fd, rng, incr, k, 20UL, 3000UL+k, fd_rng_ulong_roll( rng, 600UL ) );
+  fd_accdb_snapshot_load_end( accdb );
+  lthash_check( accdb, incr );
+
+  /* The rooted view is unchanged by the incremental fork. */
+  fd_memcpy( lthash_live, full_live, sizeof(lthash_live) );
+  lthash_check( accdb, SENTINEL );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  test_teardown( accdb, fd );
+}
+
 /* test_incremental_cross_fork_override verifies that incremental
    cross-fork overrides create new acc_pool entries with txn records,
    and that purging the incremental fork + revert_whead fully restores
@@ -1747,6 +2044,316 @@ test_sentinel_index_wrap( void ) {
   FD_TEST( fp ); /* 0 would mean partition_cnt==8192 was rejected */
 }
 
+/* test_io_uring_cold_reads: with an io_uring attached, cache misses
+   of a multi-account acquire are served by one batched submission.
+   Writes more small accounts than class 0 of a minimal cache can hold
+   so that many of them get evicted, then reads all of them back in batches and checks that
+   the data made it through the ring intact.  Skipped if the kernel (or
+   sandbox) does not provide io_uring. */
+static void
+test_io_uring_cold_reads( void ) {
+  int fd;
+  fd_accdb_t * accdb = test_setup_ex( &fd, 4096UL, 64UL, 8192UL, 8192UL, 1UL<<30UL,
+                                      23UL<<20UL, TEST_CACHE_MIN_RESERVED, 1UL );
+
+  fd_io_uring_t ring[1];
+  FD_TEST( !fd_accdb_io_uring_footprint( 0UL ) );
+  fd_accdb_io_uring_setup( ring, NULL, 0UL, fd );
+  FD_TEST( ring->ioring_fd==-1 );
+
+  void * ring_mem = aligned_alloc( fd_accdb_io_uring_align(), fd_accdb_io_uring_footprint( 16UL ) );
+  FD_TEST( ring_mem );
+  FD_TEST( !fd_accdb_io_uring_init( ring, ring_mem, 12UL, fd ) );
+  if( FD_UNLIKELY( !fd_accdb_io_uring_init( ring, ring_mem, 16UL, fd ) ) ) {
+    FD_LOG_WARNING(( "skip: io_uring unavailable" ));
+    free( ring_mem );
+    test_teardown( accdb, fd );
+    return;
+  }
+
+  fd_io_uring_t bad_ring[1] = {{ 0 }};
+  FD_TEST( !fd_accdb_attach_io_uring( NULL, ring ) );
+  FD_TEST( !fd_accdb_attach_io_uring( accdb, bad_ring ) );
+  FD_TEST( fd_accdb_attach_io_uring( accdb, ring )==accdb );
+
+  ulong used[ FD_ACCDB_CACHE_CLASS_CNT ], max[ FD_ACCDB_CACHE_CLASS_CNT ], reserved[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_occupancy( accdb, used, max, reserved );
+  ulong acc_cnt = fd_ulong_min( max[ 0 ]+768UL, 4000UL );
+
+  fd_accdb_fork_id_t root = fd_accdb_attach_child( accdb, SENTINEL );
+
+  uchar data[ 96UL ];
+  for( ulong i=0UL; i<acc_cnt; i++ ) {
+    uchar pk[ 32UL ] = { 0 };
+    FD_STORE( ulong, pk, i+1UL );
+    memset( data, (int)(i&0xffUL), sizeof(data) );
+    FD_STORE( ulong, data, i );
+    accdb_write( accdb, root, pk, i+1UL, data, sizeof(data), owner2 );
+  }
+
+  ulong read_ops0 = fd_accdb_metrics( accdb )->read_ops;
+
+  #define BATCH (24UL)
+  uchar         pks[ BATCH ][ 32UL ];
+  uchar const * pk_ptrs[ BATCH ];
+  int           wr[ BATCH ];
+  fd_acc_t      accs[ BATCH ];
+  for( ulong i0=0UL; i0<acc_cnt; i0+=BATCH ) {
+    ulong cnt = fd_ulong_min( BATCH, acc_cnt-i0 );
+    for( ulong j=0UL; j<cnt; j++ ) {
+      memset( pks[ j ], 0, 32UL );
+      FD_STORE( ulong, pks[ j ], i0+j+1UL );
+      pk_ptrs[ j ] = pks[ j ];
+      wr[ j ] = 0;
+    }
+    memset( accs, 0, sizeof(accs) );
+    fd_accdb_acquire( accdb, root, cnt, pk_ptrs, wr, accs );
+    for( ulong j=0UL; j<cnt; j++ ) {
+      ulong i = i0+j;
+      FD_TEST( accs[ j ].lamports==i+1UL );
+      FD_TEST( accs[ j ].data_len==sizeof(data) );
+      FD_TEST( !memcmp( accs[ j ].owner, owner2, 32UL ) );
+      FD_TEST( FD_LOAD( ulong, accs[ j ].data )==i );
+      FD_TEST( accs[ j ].data[ sizeof(data)-1UL ]==(uchar)(i&0xffUL) );
+    }
+    fd_accdb_release( accdb, cnt, accs );
+  }
+  #undef BATCH
+
+  /* Most of the accounts were evicted and had to be read back */
+  FD_TEST( fd_accdb_metrics( accdb )->read_ops-read_ops0 >= acc_cnt-max[ 0 ] );
+  FD_TEST( !fd_io_uring_cq_ready( ring->cq ) );
+
+  FD_TEST( fd_accdb_attach_io_uring( accdb, NULL )==accdb );
+  fd_io_uring_fini( ring );
+  free( ring_mem );
+  test_teardown( accdb, fd );
+}
+
+/* test_prefetch: fd_accdb_prefetch classifies accounts as missing,
+   resident or cold without disturbing the cache. */
+
+static void
+test_prefetch( void ) {
+  int fd;
+  fd_accdb_t * accdb = test_setup_ex( &fd, 4096UL, 64UL, 8192UL, 8192UL, 1UL<<30UL,
+                                      23UL<<20UL, TEST_CACHE_MIN_RESERVED, 1UL );
+
+  ulong used[ FD_ACCDB_CACHE_CLASS_CNT ], max[ FD_ACCDB_CACHE_CLASS_CNT ], reserved[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_occupancy( accdb, used, max, reserved );
+  ulong acc_cnt = fd_ulong_min( max[ 0 ]+256UL, 4000UL );
+
+  fd_accdb_fork_id_t root = fd_accdb_attach_child( accdb, SENTINEL );
+
+  uchar data[ 96UL ];
+  for( ulong i=0UL; i<acc_cnt; i++ ) {
+    uchar pk[ 32UL ] = { 0 };
+    FD_STORE( ulong, pk, i+1UL );
+    memset( data, (int)(i&0xffUL), sizeof(data) );
+    accdb_write( accdb, root, pk, i+1UL, data, sizeof(data), owner2 );
+  }
+
+  uchar pk[ 32UL ] = { 0 };
+  FD_STORE( ulong, pk, acc_cnt+1UL );
+  FD_TEST( fd_accdb_prefetch( accdb, root, pk )==FD_ACCDB_PREFETCH_MISSING );
+
+  FD_STORE( ulong, pk, acc_cnt );
+  FD_TEST( fd_accdb_prefetch( accdb, root, pk )==FD_ACCDB_PREFETCH_CACHED );
+
+  /* Early accounts were evicted to make room.  The readahead itself
+     may be refused by the backing file (memfd), in which case the
+     account reports as cached, but it is never reported missing. */
+  ulong issued = 0UL;
+  for( ulong i=0UL; i<acc_cnt; i++ ) {
+    FD_STORE( ulong, pk, i+1UL );
+    int r = fd_accdb_prefetch( accdb, root, pk );
+    FD_TEST( r==FD_ACCDB_PREFETCH_CACHED || r==FD_ACCDB_PREFETCH_ISSUED );
+    issued += (ulong)( r==FD_ACCDB_PREFETCH_ISSUED );
+  }
+  FD_TEST( issued<=acc_cnt-1UL );
+
+  /* Prefetching never changes what is read back */
+  fd_accdb_cache_class_occupancy( accdb, used, max, reserved );
+  ulong used0 = used[ 0 ];
+  FD_STORE( ulong, pk, 1UL );
+  FD_TEST( fd_accdb_prefetch( accdb, root, pk )!=FD_ACCDB_PREFETCH_MISSING );
+  fd_accdb_cache_class_occupancy( accdb, used, max, reserved );
+  FD_TEST( used[ 0 ]==used0 );
+  fd_acc_t acc = fd_accdb_read_one( accdb, root, pk );
+  FD_TEST( acc.lamports==1UL );
+  FD_TEST( acc.data_len==sizeof(data) );
+  FD_TEST( acc.data[ 0 ]==0 );
+  fd_accdb_unread_one( accdb, &acc );
+
+  test_teardown( accdb, fd );
+}
+
+/* test_fork_writes_and_scan: fd_accdb_fork_writes reports exactly the
+   accounts written on a fork (not its ancestors), across cursor
+   resumes, and scanning every chain visits every account once. */
+
+static void
+test_fork_writes_and_scan( void ) {
+  int fd;
+  fd_accdb_t * accdb = test_setup( &fd, 1024UL, 64UL, 8192UL, 8192UL, 1UL<<30UL );
+
+  fd_accdb_fork_id_t root = fd_accdb_attach_child( accdb, SENTINEL );
+  fd_accdb_fork_id_t f1   = fd_accdb_attach_child( accdb, root );
+
+  uchar pk[ 32UL ] = { 0 };
+  for( ulong i=0UL; i<100UL; i++ ) {
+    FD_STORE( ulong, pk, i+1UL );
+    accdb_write( accdb, root, pk, 1UL, NULL, 0UL, owner2 );
+  }
+  for( ulong i=50UL; i<130UL; i++ ) {
+    FD_STORE( ulong, pk, i+1UL );
+    accdb_write( accdb, f1, pk, 2UL, NULL, 0UL, owner3 );
+  }
+
+  uchar out[ 7UL ][ 32UL ];
+  uchar seen[ 131UL ] = { 0 };
+  ulong cursor = 0UL;
+  ulong total  = 0UL;
+  while( cursor!=ULONG_MAX ) {
+    ulong cnt = fd_accdb_fork_writes( accdb, f1, &cursor, out, 7UL );
+    FD_TEST( cnt<=7UL );
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ulong k = FD_LOAD( ulong, out[ i ] );
+      FD_TEST( k>50UL && k<=130UL );
+      FD_TEST( !seen[ k ] );
+      seen[ k ] = 1;
+    }
+    total += cnt;
+  }
+  FD_TEST( total==80UL );
+  FD_TEST( !fd_accdb_fork_writes( accdb, f1, &cursor, out, 7UL ) );
+
+  /* Accounts 51..100 have two versions in the same chain, but are
+     reported once, in increasing order, however small the pages. */
+  for( ulong page_max=1UL; page_max<=7UL; page_max+=6UL ) {
+    memset( seen, 0, sizeof(seen) );
+    total = 0UL;
+    for( ulong c=0UL; c<fd_accdb_chain_cnt( accdb ); c++ ) {
+      uchar after[ 32UL ];
+      int   resume = 0;
+      for(;;) {
+        ulong cnt = fd_accdb_scan_chain( accdb, c, resume ? after : NULL, out, page_max );
+        FD_TEST( cnt<=page_max );
+        for( ulong i=0UL; i<cnt; i++ ) {
+          ulong k = FD_LOAD( ulong, out[ i ] );
+          FD_TEST( k>=1UL && k<=130UL );
+          FD_TEST( !seen[ k ] );
+          FD_TEST( !resume || memcmp( out[ i ], after, 32UL )>0 );
+          FD_TEST( !i || memcmp( out[ i ], out[ i-1UL ], 32UL )>0 );
+          seen[ k ] = 1;
+        }
+        total += cnt;
+        if( cnt<page_max ) break;
+        memcpy( after, out[ cnt-1UL ], 32UL );
+        resume = 1;
+      }
+    }
+    FD_TEST( total==130UL );
+  }
+
+  test_teardown( accdb, fd );
+}
+
+/* test_cache_rebalance: cold loads that thrash one size class move the
+   preevict budget towards that class, and the budget returns to the
+   init-time split once the pressure stops. */
+
+static void
+test_cache_rebalance( void ) {
+  int fd;
+  fd_accdb_t * accdb = test_setup_ex( &fd, 4096UL, 64UL, 8192UL, 8192UL, 1UL<<30UL,
+                                      64UL<<20UL, TEST_CACHE_MIN_RESERVED, 1UL );
+
+  /* 4 KiB accounts land in class 3 */
+  ulong const hot = 3UL;
+  static uchar data[ 4096UL ];
+  FD_TEST( fd_accdb_cache_class( sizeof(data) )==hot );
+
+  ulong used[ FD_ACCDB_CACHE_CLASS_CNT ], max[ FD_ACCDB_CACHE_CLASS_CNT ], reserved[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_occupancy( accdb, used, max, reserved );
+  ulong acc_cnt = max[ hot ]+768UL;
+  FD_TEST( acc_cnt<=4000UL );
+
+  ulong tgt0[ FD_ACCDB_CACHE_CLASS_CNT ], lwm0[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_thresholds( accdb, tgt0, lwm0 );
+
+  /* No pressure yet, nothing to do */
+  FD_TEST( !fd_accdb_cache_rebalance( accdb ) );
+
+  fd_accdb_fork_id_t root = fd_accdb_attach_child( accdb, SENTINEL );
+
+  for( ulong i=0UL; i<acc_cnt; i++ ) {
+    uchar pk[ 32UL ] = { 0 };
+    FD_STORE( ulong, pk, i+1UL );
+    memset( data, (int)(i&0xffUL), sizeof(data) );
+    accdb_write( accdb, root, pk, i+1UL, data, sizeof(data), owner2 );
+  }
+
+  ulong miss0[ FD_ACCDB_CACHE_CLASS_CNT ], stall0[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_pressure( accdb, miss0, stall0 );
+
+  for( ulong i=0UL; i<acc_cnt; i++ ) {
+    uchar pk[ 32UL ] = { 0 };
+    FD_STORE( ulong, pk, i+1UL );
+    uchar const * pk_ptr[1] = { pk };
+    int           wr[1]     = { 0 };
+    fd_acc_t      acc[1];
+    fd_accdb_acquire( accdb, root, 1UL, pk_ptr, wr, acc );
+    FD_TEST( acc->lamports==i+1UL );
+    FD_TEST( acc->data[ 0 ]==(uchar)(i&0xffUL) );
+    fd_accdb_release( accdb, 1UL, acc );
+  }
+
+  /* The reads only miss in the hot class */
+  ulong miss[ FD_ACCDB_CACHE_CLASS_CNT ], stall[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_pressure( accdb, miss, stall );
+  FD_TEST( miss [ hot ]-miss0 [ hot ]>=acc_cnt-max[ hot ] );
+  FD_TEST( stall[ hot ]-stall0[ hot ]>0UL );
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    if( c!=hot ) FD_TEST( miss[ c ]==miss0[ c ] );
+  }
+
+  FD_TEST( fd_accdb_cache_rebalance( accdb ) );
+  FD_TEST( fd_accdb_metrics( accdb )->cache_rebalances==1UL );
+
+  /* The thrashing class keeps more lines free, up to half of the lines
+     above its reserved floor.  Every other class gives budget back but
+     keeps at least half of it. */
+  ulong tgt1[ FD_ACCDB_CACHE_CLASS_CNT ], lwm1[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_thresholds( accdb, tgt1, lwm1 );
+  FD_TEST( tgt1[ hot ]<tgt0[ hot ] );
+  FD_TEST( lwm1[ hot ]<lwm0[ hot ] );
+  FD_TEST( max[ hot ]-tgt1[ hot ]<=(max[ hot ]-TEST_CACHE_MIN_RESERVED)/2UL );
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    if( c==hot ) continue;
+    FD_TEST( tgt1[ c ]>=tgt0[ c ] );
+    FD_TEST( max[ c ]-tgt1[ c ]>=(max[ c ]-tgt0[ c ])/2UL );
+  }
+
+  /* Background preeviction keeps the hot class under its new low
+     water mark */
+  for( ulong i=0UL; i<64UL; i++ ) drain_background( accdb );
+  fd_accdb_cache_class_occupancy( accdb, used, max, reserved );
+  FD_TEST( used[ hot ]<=lwm1[ hot ] );
+
+  /* Pressure decays and the split returns to the init-time one */
+  for( ulong i=0UL; i<64UL; i++ ) fd_accdb_cache_rebalance( accdb );
+  FD_TEST( !fd_accdb_cache_rebalance( accdb ) );
+  ulong tgt2[ FD_ACCDB_CACHE_CLASS_CNT ], lwm2[ FD_ACCDB_CACHE_CLASS_CNT ];
+  fd_accdb_cache_class_thresholds( accdb, tgt2, lwm2 );
+  for( ulong c=0UL; c<FD_ACCDB_CACHE_CLASS_CNT; c++ ) {
+    FD_TEST( tgt2[ c ]==tgt0[ c ] );
+    FD_TEST( lwm2[ c ]==lwm0[ c ] );
+  }
+
+  test_teardown( accdb, fd );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -1830,6 +2437,12 @@ main( int     argc,
   FD_LOG_NOTICE(( "test_deferred_write_stats_two_joiners ..." ));
   test_deferred_write_stats_two_joiners();
 
+  FD_LOG_NOTICE(( "test_snapshot_index_sharded ..." ));
+  test_snapshot_index_sharded();
+
+  FD_LOG_NOTICE(( "test_snapshot_lthash ..." ));
+  test_snapshot_lthash();
+
   FD_LOG_NOTICE(( "test_incremental_cross_fork_override ..." ));
   test_incremental_cross_fork_override();
 
@@ -1839,6 +2452,18 @@ main( int     argc,
   FD_LOG_NOTICE(( "test_pd_write_bit_and_probe ..." ));
   test_pd_write_bit_and_probe();
 
+  FD_LOG_NOTICE(( "test_io_uring_cold_reads ..." ));
+  test_io_uring_cold_reads();
+
+  FD_LOG_NOTICE(( "test_prefetch ..." ));
+  test_prefetch();
+
+  FD_LOG_NOTICE(( "test_fork_writes_and_scan ..." ));
+  test_fork_writes_and_scan();
+
+  FD_LOG_NOTICE(( "test_cache_rebalance ..." ));
+  test_cache_rebalance();
+
   FD_LOG_NOTICE(( "success" ));
 
   fd_halt();
@@ -6,6 +6,7 @@ $(call add-objs,fd_bloom fd_crds fd_active_set fd_ping_tracker fd_gossip_wsample
 
 $(call make-unit-test,test_bloom,test_bloom,fd_flamenco fd_ballet fd_util)
 $(call run-unit-test,test_bloom)
+$(call make-unit-test,bench_bloom,bench_bloom,fd_flamenco fd_ballet fd_util)
 
 $(call make-unit-test,test_active_set,test_active_set,fd_flamenco fd_ballet fd_util)
 $(call run-unit-test,test_active_set)
@@ -0,0 +1,75 @@
+#include "../../util/fd_util.h"
+#include "fd_bloom.h"
+
+#include <stdlib.h>
+
+/* bench_bloom: build a bloom filter shaped like the ones carried by
+   gossip pull requests (up to 9664 bits, sized for ~2000 items at a
+   0.1 false positive rate), then measure how fast a single core can
+   check 32 byte CRDS value hashes against it, one by one with
+   fd_bloom_contains and in batches with fd_bloom_contains_batch.  About
+   half of the queried hashes are in the filter. */
+
+#define KEY_CNT (4096UL)
+
+static uchar keys[ KEY_CNT ][ 32 ];
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong max_bits  = fd_env_strip_cmdline_ulong( &argc, &argv, "--max-bits",  NULL, 9664UL     );
+  ulong items     = fd_env_strip_cmdline_ulong( &argc, &argv, "--items",     NULL, 2010UL     ); /* At most KEY_CNT/2 */
+  ulong batch     = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch",     NULL, 16UL       );
+  ulong query_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--queries",   NULL, 16UL<<20   );
+
+  FD_TEST( batch>=1UL && batch<=FD_BLOOM_BATCH_MAX );
+  FD_TEST( items<=KEY_CNT/2UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  void * mem = aligned_alloc( fd_bloom_align(), fd_bloom_footprint( 0.1, max_bits ) );
+  FD_TEST( mem );
+  fd_bloom_t * bloom = fd_bloom_join( fd_bloom_new( mem, rng, 0.1, max_bits ) );
+  FD_TEST( bloom );
+  fd_bloom_initialize( bloom, items );
+
+  for( ulong i=0UL; i<KEY_CNT; i++ ) {
+    for( ulong j=0UL; j<32UL; j+=8UL ) FD_STORE( ulong, keys[ i ]+j, fd_rng_ulong( rng ) );
+    if( (i&1UL) && i<2UL*items ) fd_bloom_insert( bloom, keys[ i ], 32UL );
+  }
+  FD_LOG_NOTICE(( "bloom bench (bits=%lu hash fns=%lu batch=%lu queries=%lu)", bloom->bits_len, bloom->keys_len, batch, query_cnt ));
+
+  /* Scalar */
+
+  ulong hit_cnt = 0UL;
+  long  dt      = -fd_log_wallclock();
+  for( ulong q=0UL; q<query_cnt; q++ ) {
+    hit_cnt += (ulong)fd_bloom_contains( bloom, keys[ q&(KEY_CNT-1UL) ], 32UL );
+  }
+  dt += fd_log_wallclock();
+  FD_TEST( hit_cnt>=query_cnt*items/KEY_CNT );
+  FD_LOG_NOTICE(( "fd_bloom_contains:       %.2f M/s/core, %.1f ns each (hits %lu)", (double)query_cnt/(double)dt*1e3, (double)dt/(double)query_cnt, hit_cnt ));
+
+  /* Batched */
+
+  uchar const * key[ FD_BLOOM_BATCH_MAX ];
+  ulong batch_hit_cnt = 0UL;
+  dt = -fd_log_wallclock();
+  for( ulong q=0UL; q<query_cnt; q+=batch ) {
+    ulong cnt = fd_ulong_min( batch, query_cnt-q );
+    for( ulong i=0UL; i<cnt; i++ ) key[ i ] = keys[ (q+i)&(KEY_CNT-1UL) ];
+    batch_hit_cnt += (ulong)fd_ulong_popcnt( fd_bloom_contains_batch( bloom, key, 32UL, cnt ) );
+  }
+  dt += fd_log_wallclock();
+  FD_TEST( batch_hit_cnt==hit_cnt );
+  FD_LOG_NOTICE(( "fd_bloom_contains_batch: %.2f M/s/core, %.1f ns each", (double)query_cnt/(double)dt*1e3, (double)dt/(double)query_cnt ));
+
+  free( mem );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -4,6 +4,15 @@
 
 #include <math.h>
 
+#if FD_HAS_AVX512
+#include "../../util/simd/fd_avx512.h"
+#endif
+#if FD_HAS_AVX
+#include "../../util/simd/fd_avx.h"
+#endif
+
+#define FNV_PRIME (1099511628211UL) /* 2^40 + 0x1b3 */
+
 static const double FD_BLOOM_LN_2 = 0.69314718055994530941723212145818;
 static ulong
 fnv_hasher( uchar const * ele,
@@ -11,11 +20,121 @@ fnv_hasher( uchar const * ele,
             ulong         key ) {
   for( ulong i=0UL; i<ele_sz; i++ ) {
     key ^= (ulong)ele[i];
-    key *= 1099511628211UL; /* FNV prime */
+    key *= FNV_PRIME;
   }
   return key;
 }
 
+/* fnv_hasher_x16x2 computes fnv_hasher( ele_l, ele_sz, key0 ) into
+   out0[ l ] and fnv_hasher( ele_l, ele_sz, key1 ) into out1[ l ] for 16
+   elements at once, where tb[ i ][ l ] is byte i of element l.  Each
+   hash is a serial chain of ele_sz multiplies, so the 32 hashes are run
+   as several independent vector chains to hide the multiply latency. */
+
+static void
+fnv_hasher_x16x2( ulong const tb[][ 16 ],
+                  ulong       ele_sz,
+                  ulong       key0,
+                  ulong       key1,
+                  ulong       out0[ static 16 ],
+                  ulong       out1[ static 16 ] ) {
+  /* x*FNV_PRIME is computed as (x<<40) + lo32(x)*0x1b3 +
+     (hi32(x)*0x1b3)<<32.  AVX2 has no 64-bit multiply, and this has
+     a much shorter dependency chain than AVX-512's. */
+#if FD_HAS_AVX512
+  wwl_t c  = wwl_bcast( 0x1b3L );
+# define FNV_MUL( x ) wwl_add( wwl_add( wwl_shl( (x), 40 ), wwv_mul_ll( (x), c ) ), wwl_shl( wwv_mul_ll( wwl_shru( (x), 32 ), c ), 32 ) )
+  wwl_t a0 = wwl_bcast( (long)key0 ); wwl_t a1 = a0;
+  wwl_t b0 = wwl_bcast( (long)key1 ); wwl_t b1 = b0;
+  for( ulong i=0UL; i<ele_sz; i++ ) {
+    wwl_t x0 = wwl_ld( (long const *)tb[ i ]     );
+    wwl_t x1 = wwl_ld( (long const *)tb[ i ]+8UL );
+    a0 = FNV_MUL( wwl_xor( a0, x0 ) );
+    a1 = FNV_MUL( wwl_xor( a1, x1 ) );
+    b0 = FNV_MUL( wwl_xor( b0, x0 ) );
+    b1 = FNV_MUL( wwl_xor( b1, x1 ) );
+  }
+# undef FNV_MUL
+  wwl_st( (long *)out0,     a0 );
+  wwl_st( (long *)out0+8UL, a1 );
+  wwl_st( (long *)out1,     b0 );
+  wwl_st( (long *)out1+8UL, b1 );
+#elif FD_HAS_AVX
+  wv_t c = wv_bcast( 0x1b3UL );
+# define FNV_MUL( x ) wv_add( wv_add( wv_shl( (x), 40 ), wv_mul_ll( (x), c ) ), wv_shl( wv_mul_ll( wv_shr( (x), 32 ), c ), 32 ) )
+  wv_t a[ 4 ]; wv_t b[ 4 ];
+  for( ulong j=0UL; j<4UL; j++ ) { a[ j ] = wv_bcast( key0 ); b[ j ] = wv_bcast( key1 ); }
+  for( ulong i=0UL; i<ele_sz; i++ ) {
+    for( ulong j=0UL; j<4UL; j++ ) {
+      wv_t x = wv_ld( tb[ i ]+4UL*j );
+      a[ j ] = FNV_MUL( wv_xor( a[ j ], x ) );
+      b[ j ] = FNV_MUL( wv_xor( b[ j ], x ) );
+    }
+  }
+# undef FNV_MUL
+  for( ulong j=0UL; j<4UL; j++ ) { wv_st( out0+4UL*j, a[ j ] ); wv_st( out1+4UL*j, b[ j ] ); }
+#else
+  for( ulong l=0UL; l<16UL; l++ ) { out0[ l ] = key0; out1[ l ] = key1; }
+  for( ulong i=0UL; i<ele_sz; i++ ) {
+    for( ulong l=0UL; l<16UL; l++ ) {
+      out0[ l ] = (out0[ l ]^tb[ i ][ l ])*FNV_PRIME;
+      out1[ l ] = (out1[ l ]^tb[ i ][ l ])*FNV_PRIME;
+    }
+  }
+#endif
+}
+
+/* transpose_x16 sets tb[ i ][ l ] to byte i of ele[ l ], for i in
+   [0,ele_sz).  Bytes are extracted from 8 byte words of each element,
+   which takes far fewer loads than going byte by byte. */
+
+static void
+transpose_x16( ulong               tb[][ 16 ],
+               uchar const * const ele[ static 16 ],
+               ulong               ele_sz ) {
+  ulong w[ 16 ] __attribute__((aligned(64)));
+  ulong i = 0UL;
+  for( ; i+8UL<=ele_sz; i+=8UL ) {
+    for( ulong l=0UL; l<16UL; l++ ) w[ l ] = fd_ulong_load_8( ele[ l ]+i );
+#if FD_HAS_AVX512
+    wwl_t m  = wwl_bcast( 0xffL );
+    wwl_t x0 = wwl_ld( (long const *)w       );
+    wwl_t x1 = wwl_ld( (long const *)w+8UL );
+    for( ulong b=0UL; b<8UL; b++ ) {
+      wwl_st( (long *)tb[ i+b ],     wwl_and( wwl_shru( x0, 8UL*b ), m ) );
+      wwl_st( (long *)tb[ i+b ]+8UL, wwl_and( wwl_shru( x1, 8UL*b ), m ) );
+    }
+#else
+    for( ulong b=0UL; b<8UL; b++ ) {
+      for( ulong l=0UL; l<16UL; l++ ) tb[ i+b ][ l ] = (w[ l ]>>(8UL*b)) & 0xffUL;
+    }
+#endif
+  }
+  for( ; i<ele_sz; i++ ) {
+    for( ulong l=0UL; l<16UL; l++ ) tb[ i ][ l ] = (ulong)ele[ l ][ i ];
+  }
+}
+
+/* bit_idx returns h % d, given m = ULONG_MAX/d.  The quotient estimate
+   (h*m)>>64 is at most 2 below the true quotient, which replaces a
+   64-bit division by two multiplies. */
+
+static inline ulong
+bit_idx( ulong h,
+         ulong d,
+         ulong m ) {
+#if FD_HAS_INT128
+  ulong q = (ulong)( ( (uint128)h*(uint128)m )>>64 );
+  ulong r = h - q*d;
+  r = fd_ulong_if( r>=d, r-d, r );
+  r = fd_ulong_if( r>=d, r-d, r );
+  return r;
+#else
+  (void)m;
+  return h % d;
+#endif
+}
+
 FD_FN_CONST ulong
 fd_bloom_align( void ) {
   return FD_BLOOM_ALIGN;
@@ -154,6 +273,56 @@ fd_bloom_contains( fd_bloom_t *  bloom,
   return 1;
 }
 
+ulong
+fd_bloom_contains_batch( fd_bloom_t const *    bloom,
+                         uchar const * const * key,
+                         ulong                 key_sz,
+                         ulong                 key_cnt ) {
+  if( FD_UNLIKELY( !bloom->keys_len || !bloom->bits_len ) ) return 0UL;
+
+  ulong d   = bloom->bits_len;
+  ulong m   = ULONG_MAX / d;
+  ulong res = 0UL;
+
+  ulong tb[ FD_BLOOM_BATCH_KEY_SZ_MAX ][ 16 ] __attribute__((aligned(64)));
+  ulong h0[ 16 ]                               __attribute__((aligned(64)));
+  ulong h1[ 16 ]                               __attribute__((aligned(64)));
+
+  for( ulong base=0UL; base<key_cnt; base+=16UL ) {
+    ulong lane_cnt = fd_ulong_min( key_cnt-base, 16UL );
+
+    if( FD_UNLIKELY( key_sz>FD_BLOOM_BATCH_KEY_SZ_MAX ) ) {
+      for( ulong l=0UL; l<lane_cnt; l++ ) {
+        res |= (ulong)fd_bloom_contains( (fd_bloom_t *)bloom, key[ base+l ], key_sz )<<(base+l);
+      }
+      continue;
+    }
+
+    /* Transpose the keys so that each byte position is a vector, unused
+       lanes hash the first key */
+    uchar const * lane[ 16 ];
+    for( ulong l=0UL; l<16UL; l++ ) lane[ l ] = key[ base+fd_ulong_if( l<lane_cnt, l, 0UL ) ];
+    transpose_x16( tb, lane, key_sz );
+
+    /* Hash functions are evaluated two at a time (the second one
+       repeated if there is an odd number of them), stopping once every
+       key is known to be missing */
+    ulong live = fd_ulong_mask_lsb( (int)lane_cnt );
+    for( ulong k=0UL; live && k<bloom->keys_len; k+=2UL ) {
+      ulong k1 = fd_ulong_min( k+1UL, bloom->keys_len-1UL );
+      fnv_hasher_x16x2( (ulong const (*)[ 16 ])tb, key_sz, bloom->keys[ k ], bloom->keys[ k1 ], h0, h1 );
+      for( ulong l=0UL; l<lane_cnt; l++ ) {
+        ulong bit0 = bit_idx( h0[ l ], d, m );
+        ulong bit1 = bit_idx( h1[ l ], d, m );
+        ulong hit  = (bloom->bits[ bit0/64UL ]>>(bit0%64UL)) & (bloom->bits[ bit1/64UL ]>>(bit1%64UL)) & 1UL;
+        live &= ~( (hit^1UL)<<l );
+      }
+    }
+    res |= live<<base;
+  }
+  return res;
+}
+
 int
 fd_bloom_init_inplace( ulong *      keys,
                        ulong *      bits,
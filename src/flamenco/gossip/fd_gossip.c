@@ -482,6 +482,41 @@ txbuild_flush( fd_gossip_t *         gossip,
   fd_gossip_txbuild_init( txbuild, gossip->identity_pubkey, txbuild->tag );
 }
 
+/* pull_resp_append appends the candidates the caller is missing, those
+   not in its bloom filter, to pull_resp.  Candidates are checked
+   against the filter in batches of PULL_SCAN_BATCH, as hashing them
+   one by one dominates the cost of answering a pull request.  Returns 1
+   if the outbound data budget was exhausted, 0 otherwise. */
+
+#define PULL_SCAN_BATCH (16UL)
+
+static int
+pull_resp_append( fd_gossip_t *                   gossip,
+                  fd_bloom_t const *              filter,
+                  fd_crds_entry_t const * const * candidates,
+                  ulong                           candidates_cnt,
+                  fd_gossip_txbuild_t *           pull_resp,
+                  fd_stem_context_t *             stem,
+                  fd_ip4_port_t                   peer_addr,
+                  long                            now ) {
+  uchar const * hashes[ PULL_SCAN_BATCH ] = { NULL };
+  for( ulong i=0UL; i<candidates_cnt; i++ ) hashes[ i ] = fd_crds_entry_hash( candidates[ i ] );
+  ulong contained = fd_bloom_contains_batch( filter, hashes, 32UL, candidates_cnt );
+
+  for( ulong i=0UL; i<candidates_cnt; i++ ) {
+    if( FD_UNLIKELY( fd_ulong_extract_bit( contained, (int)i ) ) ) continue;
+
+    uchar const * crds_val;
+    ulong         crds_size;
+    fd_crds_entry_value( candidates[ i ], &crds_val, &crds_size );
+    if( FD_UNLIKELY( !fd_gossip_txbuild_can_fit( pull_resp, crds_size ) ) ) txbuild_flush( gossip, pull_resp, stem, peer_addr, now );
+    fd_gossip_txbuild_append( pull_resp, crds_size, crds_val );
+
+    if( FD_UNLIKELY( !gossip->outbound_budget.remaining ) ) return 1;
+  }
+  return 0;
+}
+
 /* pull_scan_range iterates CRDS entries in [start_hash, end_hash] and
    appends values the caller is missing to pull_resp.  Returns 1 if a
    budget was exhausted (iteration or outbound data), 0 if the range was
@@ -499,27 +534,32 @@ pull_scan_range( fd_gossip_t *         gossip,
                  long                  now ) {
   uchar iter_mem[ 16UL ];
 
+  fd_crds_entry_t const * batch[ PULL_SCAN_BATCH ];
+  ulong                   batch_cnt = 0UL;
+  int                     exhausted = 0;
+
   for( fd_crds_mask_iter_t * it = fd_crds_mask_iter_init_range( gossip->crds, start_hash, end_hash, iter_mem );
        !fd_crds_mask_iter_done( it, gossip->crds );
        it=fd_crds_mask_iter_next( it, gossip->crds ) ) {
-    if( FD_UNLIKELY( !gossip->scan_budget.remaining ) ) return 1;
+    if( FD_UNLIKELY( !gossip->scan_budget.remaining ) ) {
+      exhausted = 1;
+      break;
+    }
     gossip->scan_budget.remaining--;
 
     fd_crds_entry_t const * candidate = fd_crds_mask_iter_entry( it, gossip->crds );
 
     if( FD_UNLIKELY( fd_crds_entry_wallclock( candidate )>adjusted_wallclock_ms ) ) continue;
 
-    if( FD_UNLIKELY( fd_bloom_contains( filter, fd_crds_entry_hash( candidate ), 32UL ) ) ) continue;
-
-    uchar const * crds_val;
-    ulong         crds_size;
-    fd_crds_entry_value( candidate, &crds_val, &crds_size );
-    if( FD_UNLIKELY( !fd_gossip_txbuild_can_fit( pull_resp, crds_size ) ) ) txbuild_flush( gossip, pull_resp, stem, peer_addr, now );
-    fd_gossip_txbuild_append( pull_resp, crds_size, crds_val );
-
-    if( FD_UNLIKELY( !gossip->outbound_budget.remaining ) ) return 1;
+    batch[ batch_cnt++ ] = candidate;
+    if( FD_UNLIKELY( batch_cnt==PULL_SCAN_BATCH ) ) {
+      if( FD_UNLIKELY( pull_resp_append( gossip, filter, batch, batch_cnt, pull_resp, stem, peer_addr, now ) ) ) return 1;
+      batch_cnt = 0UL;
+    }
   }
-  return 0;
+
+  if( FD_LIKELY( batch_cnt ) && FD_UNLIKELY( pull_resp_append( gossip, filter, batch, batch_cnt, pull_resp, stem, peer_addr, now ) ) ) return 1;
+  return exhausted;
 }
 
 static void
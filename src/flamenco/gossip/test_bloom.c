@@ -213,6 +213,54 @@ test_keys_oob( void ) {
   free( bytes );
 }
 
+/* fd_bloom_contains_batch must agree with fd_bloom_contains for every
+   key size and batch size, including partial SIMD batches. */
+void
+test_contains_batch( void ) {
+  ulong const max_bits = 9664UL;
+  void * bytes = aligned_alloc( fd_bloom_align(), fd_bloom_footprint( 0.1, max_bits ) );
+  FD_TEST( bytes );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1U, 0UL ) );
+  FD_TEST( rng );
+
+  fd_bloom_t * bloom = fd_bloom_join( fd_bloom_new( bytes, rng, 0.1, max_bits ) );
+  FD_TEST( bloom );
+
+  static uchar keys[ 2UL*FD_BLOOM_BATCH_MAX ][ 80 ];
+  uchar const * key[ FD_BLOOM_BATCH_MAX ];
+
+  ulong const key_szs[] = { 1UL, 5UL, 32UL, FD_BLOOM_BATCH_KEY_SZ_MAX, FD_BLOOM_BATCH_KEY_SZ_MAX+1UL, 80UL };
+  for( ulong s=0UL; s<sizeof(key_szs)/sizeof(ulong); s++ ) {
+    ulong key_sz = key_szs[ s ];
+    for( ulong round=0UL; round<16UL; round++ ) {
+      fd_bloom_initialize( bloom, 64UL+round*64UL );
+      for( ulong i=0UL; i<2UL*FD_BLOOM_BATCH_MAX; i++ ) {
+        for( ulong j=0UL; j<key_sz; j++ ) keys[ i ][ j ] = fd_rng_uchar( rng );
+        if( i&1UL ) fd_bloom_insert( bloom, keys[ i ], key_sz );
+      }
+
+      for( ulong cnt=0UL; cnt<=FD_BLOOM_BATCH_MAX; cnt++ ) {
+        ulong off = fd_rng_ulong_roll( rng, FD_BLOOM_BATCH_MAX+1UL );
+        ulong expected = 0UL;
+        for( ulong i=0UL; i<cnt; i++ ) {
+          key[ i ] = keys[ off+i ];
+          expected |= (ulong)fd_bloom_contains( bloom, key[ i ], key_sz )<<i;
+        }
+        ulong res = fd_bloom_contains_batch( bloom, key, key_sz, cnt );
+        FD_TEST( res==expected );
+        for( ulong i=0UL; i<cnt; i++ ) if( (off+i)&1UL ) FD_TEST( fd_ulong_extract_bit( res, (int)i ) );
+      }
+    }
+  }
+
+  bloom->keys_len = 0UL;
+  key[ 0 ] = keys[ 1 ];
+  FD_TEST( !fd_bloom_contains_batch( bloom, key, 32UL, 1UL ) );
+
+  free( bytes );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -226,6 +274,7 @@ main( int     argc,
   test_bitvec_deserialize();
   test_epoch_slots_bitvec_deserialize();
   test_keys_oob();
+  test_contains_batch();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -27,6 +27,8 @@ struct fd_progcache_shmem {
 
   ulong alloc_gaddr;
 
+  ulong jit_seq; /* last fd_progcache_jit_hdr_t id handed out */
+
   struct {
     uint  max;
     ulong map_gaddr;
@@ -38,6 +38,41 @@ fd_progcache_val_alloc( fd_progcache_rec_t *  rec,
   return mem;
 }
 
+void *
+fd_progcache_val_grow( fd_progcache_rec_t *  rec,
+                       fd_progcache_join_t * join,
+                       ulong                 val_sz,
+                       ulong                 val_footprint ) {
+  FD_TEST( rec->data_gaddr );
+  FD_TEST( val_sz<=rec->data_max );
+  void * old_mem = fd_wksp_laddr_fast( join->data_base, rec->data_gaddr );
+  if( val_footprint<=rec->data_max ) return old_mem;
+  if( FD_UNLIKELY( val_footprint>UINT_MAX ) ) return NULL;
+
+  ulong  val_max = 0UL;
+  void * mem;
+  ulong  gaddr;
+  if( FD_UNLIKELY( use_malloc() ) ) { /* test only */
+    mem = aligned_alloc( fd_progcache_val_align(), val_footprint );
+    if( FD_UNLIKELY( !mem ) ) return NULL;
+    val_max = val_footprint;
+    gaddr   = (ulong)mem;
+  } else {
+    mem = fd_alloc_malloc_at_least( join->alloc, fd_progcache_val_align(), val_footprint, &val_max );
+    if( FD_UNLIKELY( !mem ) ) return NULL;
+    FD_CHECK_CRIT( val_max<=UINT_MAX, "massive" ); /* unreachable */
+    gaddr = fd_wksp_gaddr_fast( join->data_base, mem );
+  }
+  fd_memcpy( mem, old_mem, val_sz );
+
+  if( FD_UNLIKELY( use_malloc() ) ) free( old_mem );
+  else                              fd_alloc_free( join->alloc, old_mem );
+
+  rec->data_gaddr = gaddr;
+  rec->data_max   = (uint)val_max;
+  return mem;
+}
+
 void
 fd_progcache_val_free1( fd_progcache_rec_t * rec,
                         void *               val,
@@ -51,6 +86,7 @@ fd_progcache_val_free1( fd_progcache_rec_t * rec,
   rec->data_max   = 0U;
   rec->rodata_off = 0U;
   rec->rodata_sz  = 0U;
+  rec->jit_off    = 0U;
 }
 
 void
@@ -120,6 +156,7 @@ fd_progcache_rec_load( fd_progcache_rec_t *            rec,
 
   rec->calldests_off = has_calldests ? (uint)( (ulong)calldests_mem - (ulong)val ) : UINT_MAX;
   rec->rodata_off    = (uint)( (ulong)rodata_mem - (ulong)val );
+  rec->jit_off       = 0U;
   rec->entry_pc      = 0;
   rec->rodata_sz     = 0;
 
@@ -215,6 +252,7 @@ fd_progcache_rec_nx( fd_progcache_rec_t * rec ) {
   rec->rodata_sz     = 0;
   rec->calldests_off = UINT_MAX;
   rec->rodata_off    = 0;
+  rec->jit_off       = 0;
   rec->sbpf_version  = 0;
   return rec;
 }
@@ -26,7 +26,8 @@ fd_progcache_rec_key_eq( fd_progcache_rec_key_t const * k0,
    verification) or executable.  Non-executable entry objects consist
    only of this header struct.  Executable entry objects are variable-
    sized and contain additional structures past this header (rodata/ROM
-   segment, control flow metadata, ...). */
+   segment, control flow metadata, an optional ready-to-run JIT image,
+   ...). */
 
 struct __attribute__((aligned(64))) fd_progcache_rec {
   fd_progcache_rec_key_t pair;  /* Transaction id and record key pair */
@@ -51,6 +52,7 @@ struct __attribute__((aligned(64))) fd_progcache_rec {
 
   uint calldests_off;  /* offset to sbpf_calldests map */
   uint rodata_off;     /* offset to rodata segment */
+  uint jit_off;        /* offset to fd_progcache_jit_hdr_t, 0 if none */
 
   uint reclaim_next;
 
@@ -78,6 +80,34 @@ fd_progcache_rec_calldests( fd_progcache_rec_t const * rec,
   return fd_sbpf_calldests_join( fd_wksp_laddr_fast( wksp, rec->data_gaddr + rec->calldests_off ) );
 }
 
+/* fd_progcache_jit_hdr_t is the header of the optional JIT section of
+   an executable cache entry.  It is followed (at FD_PROGCACHE_JIT_IMG_OFF
+   bytes from the start of the header) by image_sz bytes of a compiled
+   fd_vm_jit_t image (see fd_vm_jit_image_sz).  The image is position
+   independent and is copied by progcache clients into local executable
+   memory before running it (see fd_progcache_jit_acquire).
+
+   id is unique across all JIT sections ever created in a progcache
+   instance (never zero).  Clients use it to tell whether a local copy
+   of the image is still current.  The section is immutable once the
+   record is published and is freed with the rest of the record. */
+
+struct fd_progcache_jit_hdr {
+  ulong id;
+  ulong image_sz;
+};
+
+typedef struct fd_progcache_jit_hdr fd_progcache_jit_hdr_t;
+
+#define FD_PROGCACHE_JIT_IMG_OFF (64UL)
+
+static inline fd_progcache_jit_hdr_t const *
+fd_progcache_rec_jit_hdr( fd_progcache_rec_t const * rec,
+                          fd_wksp_t *                wksp ) {
+  if( !rec->jit_off ) return NULL;
+  return fd_wksp_laddr_fast( wksp, rec->data_gaddr + rec->jit_off );
+}
+
 /* Heap allocator for variable-size cache entry data */
 
 /* fd_progcache_use_malloc allows link-time (build-time) selection of
@@ -106,6 +136,20 @@ fd_progcache_val_alloc( fd_progcache_rec_t *  rec,
                         ulong                 val_align,
                         ulong                 val_footprint );
 
+/* fd_progcache_val_grow moves the value of rec to a new heap
+   allocation of at least val_footprint bytes (with alignment
+   fd_progcache_val_align()), preserving the first val_sz bytes.  Stays
+   in place if the existing allocation is already large enough.  Returns
+   a pointer to the (possibly moved) value on success.  On allocation
+   failure, returns NULL and leaves rec unmodified.  rec must not be a
+   spill record. */
+
+void *
+fd_progcache_val_grow( fd_progcache_rec_t *  rec,
+                       fd_progcache_join_t * join,
+                       ulong                 val_sz,
+                       ulong                 val_footprint );
+
 void
 fd_progcache_val_free1( fd_progcache_rec_t * rec,
                         void *               val,
@@ -1,8 +1,15 @@
+#define _GNU_SOURCE /* memfd_create */
+
 #include "fd_prog_load.h"
 #include "fd_progcache_user.h"
 #include "fd_progcache_reclaim.h"
 #include "fd_progcache_clock.h"
 #include "../../util/racesan/fd_racesan_target.h"
+#if FD_HAS_X86
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 FD_TL fd_progcache_metrics_t fd_progcache_metrics_default;
 
@@ -51,6 +58,7 @@ fd_progcache_leave( fd_progcache_t *        cache,
   if( FD_UNLIKELY( !fd_progcache_shmem_leave( cache->join, opt_shmem ) ) ) return NULL;
   cache->scratch    = NULL;
   cache->scratch_sz = 0UL;
+  memset( &cache->jit, 0, sizeof(cache->jit) );
   return cache;
 }
 
@@ -374,6 +382,118 @@ insert_params( insert_params_t *          p,
   return p;
 }
 
+/* JIT slot management ************************************************/
+
+#if FD_HAS_X86
+
+static inline uchar *
+fd_progcache_jit_slot_mem( fd_progcache_t const *          cache,
+                           fd_progcache_jit_slot_t const * slot ) {
+  return cache->jit.mem + (ulong)( slot - cache->jit.slot )*cache->jit.slot_sz;
+}
+
+static inline fd_vm_jit_t const *
+fd_progcache_jit_slot_exec( fd_progcache_t const *          cache,
+                            fd_progcache_jit_slot_t const * slot ) {
+  return (fd_vm_jit_t const *)( cache->jit.exec_mem + (ulong)( slot - cache->jit.slot )*cache->jit.slot_sz );
+}
+
+/* fd_progcache_jit_slot_victim returns the least recently used JIT
+   slot that is not in use by an invocation, or NULL if all are. */
+
+static fd_progcache_jit_slot_t *
+fd_progcache_jit_slot_victim( fd_progcache_t * cache ) {
+  fd_progcache_jit_slot_t * victim = NULL;
+  for( ulong i=0UL; i<cache->jit.slot_cnt; i++ ) {
+    fd_progcache_jit_slot_t * slot = &cache->jit.slot[ i ];
+    if( slot->ref_cnt ) continue;
+    if( !victim || slot->last_use<victim->last_use ) victim = slot;
+  }
+  return victim;
+}
+
+/* fd_progcache_jit_fill compiles the freshly loaded program of rec
+   (write locked) and appends the resulting JIT section to rec's value.
+   val_sz is the number of bytes of rec's value in use.  The image is
+   compiled in a local JIT slot, which is then tagged with the new image
+   such that the first invocation does not need to copy it.  Call
+   immediates are resolved against the syscalls active at feature_slot,
+   same as the loader did.  On failure, rec is left without a JIT
+   section (always safe, invocations then use the interpreter). */
+
+static void
+fd_progcache_jit_fill( fd_progcache_t *      cache,
+                       fd_progcache_rec_t *  rec,
+                       ulong                 val_sz,
+                       ulong                 feature_slot,
+                       fd_features_t const * features ) {
+  if( !cache->jit.mem ) return;
+  fd_progcache_join_t * join = cache->join;
+
+  ulong                     text_cnt  = rec->text_cnt;
+  ulong                     footprint = fd_vm_jit_footprint( text_cnt );
+  fd_progcache_jit_slot_t * slot      = fd_progcache_jit_slot_victim( cache );
+  if( FD_UNLIKELY( (!footprint) | (footprint>cache->jit.slot_sz) | (!slot) ) ) {
+    cache->metrics->jit_fail_cnt++;
+    return;
+  }
+
+  slot->id = 0UL;
+  fd_vm_jit_t * jit = fd_vm_jit_join( fd_vm_jit_new( fd_progcache_jit_slot_mem( cache, slot ), text_cnt ) );
+  if( FD_UNLIKELY( !jit ) ) FD_LOG_CRIT(( "fd_vm_jit_new failed" ));
+
+  fd_sbpf_syscalls_t _syscalls[ FD_SBPF_SYSCALLS_SLOT_CNT ];
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) );
+  if( FD_UNLIKELY( fd_vm_syscall_register_slot( syscalls, feature_slot, features, /* is_deploy */ 0 )!=FD_VM_SUCCESS ) ) {
+    FD_LOG_CRIT(( "fd_vm_syscall_register_slot failed" ));
+  }
+
+  uchar const * rodata = fd_progcache_rec_rodata( rec, join->data_base );
+  int err = fd_vm_jit_compile( jit,
+                               (ulong const *)( rodata + rec->text_off ),
+                               text_cnt,
+                               rec->text_off,
+                               rec->entry_pc,
+                               fd_progcache_rec_calldests( rec, join->data_base ),
+                               syscalls,
+                               rec->sbpf_version );
+  if( FD_UNLIKELY( err!=FD_VM_SUCCESS ) ) {
+    cache->metrics->jit_fail_cnt++;
+    return;
+  }
+
+  ulong   image_sz = fd_vm_jit_image_sz( jit );
+  ulong   jit_off  = fd_ulong_align_up( val_sz, FD_PROGCACHE_JIT_IMG_OFF );
+  uchar * val      = fd_progcache_val_grow( rec, join, val_sz, jit_off + FD_PROGCACHE_JIT_IMG_OFF + image_sz );
+  if( FD_UNLIKELY( !val ) ) {
+    cache->metrics->oom_heap_cnt++;
+    cache->metrics->jit_fail_cnt++;
+    return;
+  }
+
+  /* Growing the value may have moved the program */
+
+  fd_vm_jit_bind( jit,
+                  (ulong const *)( fd_progcache_rec_rodata( rec, join->data_base ) + rec->text_off ),
+                  fd_progcache_rec_calldests( rec, join->data_base ),
+                  fd_vm_jit_syscalls_hash( syscalls ) );
+
+  ulong id = FD_ATOMIC_FETCH_AND_ADD( &join->shmem->jit_seq, 1UL ) + 1UL;
+  fd_progcache_jit_hdr_t * hdr = (fd_progcache_jit_hdr_t *)( val + jit_off );
+  hdr->id       = id;
+  hdr->image_sz = image_sz;
+  fd_memcpy( val + jit_off + FD_PROGCACHE_JIT_IMG_OFF, jit, image_sz );
+  rec->jit_off = (uint)jit_off;
+
+  slot->id       = id;
+  slot->last_use = ++cache->jit.clock;
+
+  cache->metrics->jit_fill_cnt++;
+  cache->metrics->jit_fill_tot_sz += image_sz;
+}
+
+#endif /* FD_HAS_X86 */
+
 /* fd_progcache_spill_open loads a program into the cache spill buffer.
    The spill area is an "emergency" area for temporary program loads in
    case the record pool/heap are too contended. */
@@ -526,6 +646,11 @@ fd_progcache_insert( fd_progcache_t *        cache,
       fd_progcache_val_free( rec, ljoin );
       fd_progcache_rec_nx( rec );
     }
+#if FD_HAS_X86
+    else if( rec->text_cnt ) {
+      fd_progcache_jit_fill( cache, rec, fd_progcache_val_footprint( elf_info ), feature_slot, features );
+    }
+#endif
     dt += fd_tickcount();
     cache->metrics->cum_load_ticks += (ulong)dt;
   }
@@ -619,3 +744,174 @@ fd_progcache_rec_close( fd_progcache_t *     cache,
     fd_progcache_spill_close( cache );
   }
 }
+
+fd_progcache_t *
+fd_progcache_jit_attach( fd_progcache_t * cache,
+                         void *           mem,
+                         void const *     exec_mem,
+                         ulong            slot_cnt,
+                         ulong            slot_sz ) {
+  if( FD_UNLIKELY( !cache ) ) {
+    FD_LOG_WARNING(( "NULL cache" ));
+    return NULL;
+  }
+#if FD_HAS_X86
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_vm_jit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !exec_mem ) ) {
+    FD_LOG_WARNING(( "NULL exec_mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)exec_mem, fd_vm_jit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned exec_mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (!slot_cnt) | (slot_cnt>FD_PROGCACHE_JIT_SLOT_MAX) ) ) {
+    FD_LOG_WARNING(( "invalid slot_cnt %lu (max %lu)", slot_cnt, FD_PROGCACHE_JIT_SLOT_MAX ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (!slot_sz) | (!fd_ulong_is_aligned( slot_sz, fd_vm_jit_align() )) | (slot_sz>(1UL<<40)) ) ) {
+    FD_LOG_WARNING(( "invalid slot_sz %lu", slot_sz ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( cache->jit.mem ) ) {
+    FD_LOG_WARNING(( "JIT slots already attached" ));
+    return NULL;
+  }
+
+  memset( &cache->jit, 0, sizeof(cache->jit) );
+  cache->jit.mem      = mem;
+  cache->jit.exec_mem = exec_mem;
+  cache->jit.slot_cnt = slot_cnt;
+  cache->jit.slot_sz  = slot_sz;
+  return cache;
+#else
+  (void)mem; (void)exec_mem; (void)slot_cnt; (void)slot_sz;
+  FD_LOG_WARNING(( "JIT not supported on this target" ));
+  return NULL;
+#endif
+}
+
+void
+fd_progcache_jit_map( ulong         slot_cnt,
+                      ulong         slot_sz,
+                      void **       mem,
+                      void const ** exec_mem ) {
+  *mem      = NULL;
+  *exec_mem = NULL;
+  if( !slot_cnt ) return;
+#if FD_HAS_X86
+  ulong sz = slot_cnt*slot_sz;
+  int   fd = memfd_create( "fd_jit", MFD_CLOEXEC );
+  if( FD_UNLIKELY( -1==fd ) ) FD_LOG_ERR(( "memfd_create(fd_jit) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( -1==ftruncate( fd, (off_t)sz ) ) ) {
+    FD_LOG_ERR(( "ftruncate(fd_jit,%lu KiB) failed (%i-%s)", sz>>10, errno, fd_io_strerror( errno ) ));
+  }
+  void * rw = mmap( NULL, sz, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0 );
+  if( FD_UNLIKELY( rw==MAP_FAILED ) ) {
+    FD_LOG_ERR(( "mmap(NULL,%lu KiB,PROT_READ|PROT_WRITE,MAP_SHARED,fd_jit,0) failed (%i-%s)", sz>>10, errno, fd_io_strerror( errno ) ));
+  }
+  void * rx = mmap( NULL, sz, PROT_READ|PROT_EXEC, MAP_SHARED, fd, 0 );
+  if( FD_UNLIKELY( rx==MAP_FAILED ) ) {
+    FD_LOG_ERR(( "mmap(NULL,%lu KiB,PROT_READ|PROT_EXEC,MAP_SHARED,fd_jit,0) failed (%i-%s)", sz>>10, errno, fd_io_strerror( errno ) ));
+  }
+  if( FD_UNLIKELY( -1==close( fd ) ) ) FD_LOG_ERR(( "close(fd_jit) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  *mem      = rw;
+  *exec_mem = rx;
+#else
+  (void)slot_sz;
+  FD_LOG_ERR(( "JIT not supported on this target" ));
+#endif
+}
+
+void
+fd_progcache_jit_unmap( ulong        slot_cnt,
+                        ulong        slot_sz,
+                        void *       mem,
+                        void const * exec_mem ) {
+#if FD_HAS_X86
+  ulong sz = slot_cnt*slot_sz;
+  if( mem      && FD_UNLIKELY( munmap( mem,              sz ) ) ) FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( exec_mem && FD_UNLIKELY( munmap( (void *)exec_mem, sz ) ) ) FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+#else
+  (void)slot_cnt; (void)slot_sz; (void)mem; (void)exec_mem;
+#endif
+}
+
+fd_vm_jit_t const *
+fd_progcache_jit_acquire( fd_progcache_t *           cache,
+                          fd_progcache_rec_t const * rec,
+                          ulong                      syscalls_hash ) {
+#if FD_HAS_X86
+  if( !cache->jit.mem ) return NULL;
+  fd_progcache_jit_hdr_t const * hdr = fd_progcache_rec_jit_hdr( rec, cache->join->data_base );
+  if( !hdr ) return NULL;
+  ulong id = hdr->id;
+
+  /* Images are bound to the program's text and calldests, which may be
+     at a different address in this join than where the image was
+     compiled (or where the previous acquire saw them), so every
+     acquire rebinds through the writable view. */
+
+  ulong const * text      = (ulong const *)( fd_progcache_rec_rodata( rec, cache->join->data_base ) + rec->text_off );
+  ulong const * calldests = fd_progcache_rec_calldests( rec, cache->join->data_base );
+
+  /* Hit: image already in a slot (possibly in use by an enclosing
+     invocation of the same program, compiled code is not modified
+     while running) */
+
+  for( ulong i=0UL; i<cache->jit.slot_cnt; i++ ) {
+    fd_progcache_jit_slot_t * slot = &cache->jit.slot[ i ];
+    if( slot->id==id ) {
+      if( FD_UNLIKELY( !fd_vm_jit_bind( (fd_vm_jit_t *)fd_progcache_jit_slot_mem( cache, slot ), text, calldests, syscalls_hash ) ) ) return NULL;
+      slot->ref_cnt++;
+      slot->last_use = ++cache->jit.clock;
+      cache->metrics->jit_hit_cnt++;
+      return fd_progcache_jit_slot_exec( cache, slot );
+    }
+  }
+
+  /* Miss: copy image into the least recently used idle slot */
+
+  ulong                     image_sz = hdr->image_sz;
+  fd_progcache_jit_slot_t * slot     = fd_progcache_jit_slot_victim( cache );
+  if( FD_UNLIKELY( (!slot) | (image_sz>cache->jit.slot_sz) ) ) return NULL;
+
+  uchar * mem = fd_progcache_jit_slot_mem( cache, slot );
+  fd_memcpy( mem, (uchar const *)hdr + FD_PROGCACHE_JIT_IMG_OFF, image_sz );
+  fd_vm_jit_t * jit = fd_vm_jit_join( mem );
+  if( FD_UNLIKELY( (!jit) || !fd_vm_jit_bind( jit, text, calldests, syscalls_hash ) ) ) {
+    slot->id = 0UL;
+    return NULL;
+  }
+
+  slot->id       = id;
+  slot->ref_cnt  = 1UL;
+  slot->last_use = ++cache->jit.clock;
+  cache->metrics->jit_miss_cnt++;
+  cache->metrics->jit_miss_tot_sz += image_sz;
+  return fd_progcache_jit_slot_exec( cache, slot );
+#else
+  (void)cache; (void)rec; (void)syscalls_hash;
+  return NULL;
+#endif
+}
+
+void
+fd_progcache_jit_release( fd_progcache_t *    cache,
+                          fd_vm_jit_t const * jit ) {
+  if( !jit ) return;
+  ulong off = (ulong)jit - (ulong)cache->jit.exec_mem;
+  if( FD_UNLIKELY( ( (ulong)jit<(ulong)cache->jit.exec_mem ) | ( off>=cache->jit.slot_cnt*cache->jit.slot_sz ) ) ) {
+    FD_LOG_CRIT(( "invalid jit %p", (void const *)jit ));
+  }
+  fd_progcache_jit_slot_t * slot = &cache->jit.slot[ off/cache->jit.slot_sz ];
+  FD_TEST( slot->ref_cnt );
+  slot->ref_cnt--;
+}
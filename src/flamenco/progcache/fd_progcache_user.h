@@ -51,11 +51,27 @@
    1. a database fork is cancelled (e.g. slot is rooted and competing
       history dies, or consensus layer prunes a fork)
    2. a cache entry is orphaned (updated or invalidated by an epoch
-      boundary) */
+      boundary)
+
+   ### JIT images
+
+   A client can optionally attach a small set of local executable
+   "JIT slots" (see fd_progcache_jit_attach).  Such a client compiles
+   every program it fills into the cache with fd_vm_jit and stores the
+   resulting (position independent) image in the cache entry next to
+   the rodata segment.  The image thus shares the entry's fork-aware
+   lineage, eviction and reclamation: it is compiled once per program
+   revision and feature set, not once per invocation.
+
+   Since the progcache heap is not executable, a client copies an image
+   into one of its JIT slots before running it.  Slots are tagged with
+   the image id and retained across invocations, so a hot program runs
+   straight from its slot (no load, compile, or copy work). */
 
 #include "fd_progcache.h"
 #include "fd_prog_load.h"
 #include "fd_progcache_lineage.h"
+#include "../vm/fd_vm_jit.h"
 #include "../runtime/fd_runtime_const.h"
 
 struct fd_progcache_metrics {
@@ -72,10 +88,31 @@ struct fd_progcache_metrics {
   ulong evict_tot_sz;
   ulong cum_pull_ticks;
   ulong cum_load_ticks;
+  ulong jit_fill_cnt;      /* JIT images created */
+  ulong jit_fill_tot_sz;
+  ulong jit_fail_cnt;      /* fills without a JIT image (too large, OOM, ...) */
+  ulong jit_hit_cnt;       /* acquires served from a JIT slot */
+  ulong jit_miss_cnt;      /* acquires that copied an image into a slot */
+  ulong jit_miss_tot_sz;
 };
 
 typedef struct fd_progcache_metrics fd_progcache_metrics_t;
 
+/* FD_PROGCACHE_JIT_SLOT_MAX is the max number of local JIT slots of a
+   progcache client.  A program invocation pins a slot for its
+   duration, so slot_cnt should exceed the max instruction stack depth
+   for nested (CPI) invocations to also use JIT images. */
+
+#define FD_PROGCACHE_JIT_SLOT_MAX (16UL)
+
+struct fd_progcache_jit_slot {
+  ulong id;       /* fd_progcache_jit_hdr_t id of the image held, 0 if none */
+  ulong last_use; /* for LRU replacement */
+  ulong ref_cnt;  /* number of in-progress invocations using this slot */
+};
+
+typedef struct fd_progcache_jit_slot fd_progcache_jit_slot_t;
+
 /* fd_progcache_t is a thread-local client to a program cache instance.
    This struct is quite large and therefore not local/stack
    declaration-friendly. */
@@ -90,6 +127,15 @@ struct fd_progcache {
   ulong   scratch_sz;
 
   uint spill_active;
+
+  struct {
+    uchar *       mem;      /* NULL if no JIT slots attached */
+    uchar const * exec_mem; /* executable view of mem */
+    ulong         slot_sz;
+    ulong         slot_cnt;
+    ulong         clock;
+    fd_progcache_jit_slot_t slot[ FD_PROGCACHE_JIT_SLOT_MAX ];
+  } jit;
 };
 
 FD_PROTOTYPES_BEGIN
@@ -160,6 +206,69 @@ void
 fd_progcache_rec_close( fd_progcache_t *     cache,
                         fd_progcache_rec_t * rec );
 
+/* fd_progcache_jit_attach attaches slot_cnt local JIT slots of slot_sz
+   bytes each to a progcache client.  mem points to a region of
+   slot_cnt*slot_sz bytes aligned fd_vm_jit_align() that is mapped
+   readable and writable, owned by the client for the lifetime of the
+   join.  exec_mem is an executable mapping of the same memory (e.g. a
+   second mapping of a memfd), such that images are written through mem
+   and run through exec_mem without any page being writable and
+   executable at once (see fd_progcache_jit_map).  exec_mem has the
+   same alignment requirements.  slot_sz is a multiple of fd_vm_jit_align() and
+   bounds the largest program that gets compiled (see
+   fd_vm_jit_footprint).  Returns cache on success.  On failure (bad
+   args, or JIT not supported on this target) logs details and returns
+   NULL (cache is left without JIT slots, which is always safe). */
+
+fd_progcache_t *
+fd_progcache_jit_attach( fd_progcache_t * cache,
+                         void *           mem,
+                         void const *     exec_mem,
+                         ulong            slot_cnt,
+                         ulong            slot_sz );
+
+/* fd_progcache_jit_map maps memory for slot_cnt JIT slots of slot_sz
+   bytes each, suitable for fd_progcache_jit_attach.  The slots are a
+   memfd mapped twice: on return, *mem is a readable and writable view
+   and *exec_mem a readable and executable view of it.  The memfd is
+   closed before returning.  Tiles call this from privileged_init, as a
+   sandboxed tile can not map executable memory.  If slot_cnt is zero,
+   sets both to NULL.  Terminates the process on failure.
+
+   fd_progcache_jit_unmap unmaps both views mapped by
+   fd_progcache_jit_map with the same slot_cnt and slot_sz. */
+
+void
+fd_progcache_jit_map( ulong         slot_cnt,
+                      ulong         slot_sz,
+                      void **       mem,
+                      void const ** exec_mem );
+
+void
+fd_progcache_jit_unmap( ulong        slot_cnt,
+                        ulong        slot_sz,
+                        void *       mem,
+                        void const * exec_mem );
+
+/* fd_progcache_jit_acquire returns a joined, ready to run jit for the
+   program of cache entry rec (read locked by caller, e.g. from
+   fd_progcache_pull), or NULL if there is none (the entry has no JIT
+   image, the client has no JIT slots, all slots are in use, or the
+   image was compiled against a different syscall key set than the one
+   with fd_vm_jit_syscalls_hash syscalls_hash the caller will run it
+   with).  The returned jit is in the executable view of the slots.  It
+   stays valid (even if rec gets evicted) until released with
+   fd_progcache_jit_release.  Acquires nest (e.g. for CPI). */
+
+fd_vm_jit_t const *
+fd_progcache_jit_acquire( fd_progcache_t *           cache,
+                          fd_progcache_rec_t const * rec,
+                          ulong                      syscalls_hash );
+
+void
+fd_progcache_jit_release( fd_progcache_t *    cache,
+                          fd_vm_jit_t const * jit );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_progcache_fd_progcache_user_h */
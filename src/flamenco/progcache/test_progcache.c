@@ -1182,6 +1182,129 @@ FD_UNIT_TEST( pull_refreshes_clock_bit ) {
   test_env_destroy( env );
 }
 
+#if FD_HAS_X86
+
+#define TEST_JIT_SLOT_CNT (2UL)
+#define TEST_JIT_SLOT_SZ  (16UL<<20)
+
+/* test_jit_image: A client with JIT slots stores a JIT image in the
+   cache entries it fills.  The image is reused by later invocations on
+   the same client (slot hit) and copied by other clients (slot miss). */
+
+FD_UNIT_TEST( jit_image ) {
+  test_env_t * env = test_env_create( wksp );
+  fd_progcache_t * cache = env->progcache;
+  void *       jit_mem;
+  void const * jit_exec_mem;
+  fd_progcache_jit_map( TEST_JIT_SLOT_CNT, TEST_JIT_SLOT_SZ, &jit_mem, &jit_exec_mem );
+  FD_TEST( jit_mem && jit_exec_mem && jit_exec_mem!=jit_mem );
+
+  FD_TEST( !fd_progcache_jit_attach( NULL,  jit_mem,               jit_exec_mem,                     TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, NULL,                  jit_exec_mem,                     TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, (uchar *)jit_mem+64UL, jit_exec_mem,                     TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               NULL,                             TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               (uchar const *)jit_exec_mem+64UL, TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               jit_exec_mem,                     0UL,                           TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               jit_exec_mem,                     FD_PROGCACHE_JIT_SLOT_MAX+1UL, TEST_JIT_SLOT_SZ      ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               jit_exec_mem,                     TEST_JIT_SLOT_CNT,             0UL                   ) );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               jit_exec_mem,                     TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ+64UL ) );
+  FD_TEST(  fd_progcache_jit_attach( cache, jit_mem,               jit_exec_mem,                     TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      )==cache );
+  FD_TEST( !fd_progcache_jit_attach( cache, jit_mem,               jit_exec_mem,                     TEST_JIT_SLOT_CNT,             TEST_JIT_SLOT_SZ      ) ); /* already attached */
+
+  fd_progcache_fork_id_t fork_a = fd_progcache_attach_child( cache->join, fd_progcache_fork_id_initial() );
+  fd_pubkey_t key = test_key( 1UL );
+  test_account_t acc;
+  test_account_init( &acc, &key, &fd_solana_bpf_loader_program_id,
+                     1, valid_program_data, valid_program_data_sz );
+  fd_prog_load_env_t load_env = {
+    .features     = env->features,
+    .feature_slot = 0UL
+  };
+
+  /* Fill compiles the program and tags a local slot with the image */
+
+  fd_progcache_metrics_t m0 = *cache->metrics;
+  fd_progcache_rec_t * rec = fd_progcache_pull( cache, fork_a, &key, &load_env, acc.entry );
+  FD_TEST( rec );
+  FD_TEST( rec->jit_off );
+  FD_TEST( cache->metrics->jit_fill_cnt==m0.jit_fill_cnt+1UL );
+  fd_progcache_jit_hdr_t const * hdr = fd_progcache_rec_jit_hdr( rec, cache->join->data_base );
+  FD_TEST( hdr );
+  FD_TEST( hdr->id );
+  FD_TEST( hdr->image_sz>0UL && hdr->image_sz<=TEST_JIT_SLOT_SZ );
+  FD_TEST( rec->jit_off+FD_PROGCACHE_JIT_IMG_OFF+hdr->image_sz<=rec->data_max );
+  uchar const * image = (uchar const *)hdr + FD_PROGCACHE_JIT_IMG_OFF;
+
+  /* Images are only handed out for the syscall key set they were
+     compiled against */
+
+  fd_sbpf_syscalls_t _syscalls[ FD_SBPF_SYSCALLS_SLOT_CNT ];
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) );
+  FD_TEST( fd_vm_syscall_register_slot( syscalls, load_env.feature_slot, load_env.features, 0 )==FD_VM_SUCCESS );
+  ulong syscalls_hash = fd_vm_jit_syscalls_hash( syscalls );
+  FD_TEST( !fd_progcache_jit_acquire( cache, rec, syscalls_hash+1UL ) );
+
+  fd_vm_jit_t const * jit0 = fd_progcache_jit_acquire( cache, rec, syscalls_hash );
+  FD_TEST( jit0 );
+  FD_TEST( cache->metrics->jit_hit_cnt ==m0.jit_hit_cnt+1UL );
+  FD_TEST( cache->metrics->jit_miss_cnt==m0.jit_miss_cnt    );
+  FD_TEST( fd_vm_jit_code_sz( jit0 ) );
+  FD_TEST( fd_vm_jit_image_sz( jit0 )==hdr->image_sz );
+  FD_TEST( fd_memeq( jit0, image, hdr->image_sz ) );
+
+  /* Nested invocations of the same program share the slot */
+
+  fd_vm_jit_t const * jit1 = fd_progcache_jit_acquire( cache, rec, syscalls_hash );
+  FD_TEST( jit1==jit0 );
+  fd_progcache_jit_release( cache, jit1 );
+  fd_progcache_jit_release( cache, jit0 );
+
+  /* Another client copies the image into its own slot.  Its slots are
+     dual mapped, so images are written through one view and handed out
+     from the other. */
+
+  fd_progcache_t * other = fd_wksp_alloc_laddr( wksp, alignof(fd_progcache_t), sizeof(fd_progcache_t), 1UL );
+  FD_TEST( other );
+  FD_TEST( fd_progcache_join( other, cache->join->shmem, NULL, 0UL ) );
+  void *       other_mem;
+  void const * other_exec_mem;
+  fd_progcache_jit_map( TEST_JIT_SLOT_CNT, TEST_JIT_SLOT_SZ, &other_mem, &other_exec_mem );
+  FD_TEST( fd_progcache_jit_attach( other, other_mem, other_exec_mem, TEST_JIT_SLOT_CNT, TEST_JIT_SLOT_SZ )==other );
+  ulong miss_cnt = other->metrics->jit_miss_cnt;
+  fd_vm_jit_t const * jit2 = fd_progcache_jit_acquire( other, rec, syscalls_hash );
+  FD_TEST( jit2 && jit2!=jit0 );
+  FD_TEST( (ulong)jit2>=(ulong)other_exec_mem && (ulong)jit2<(ulong)other_exec_mem+TEST_JIT_SLOT_CNT*TEST_JIT_SLOT_SZ );
+  FD_TEST( other->metrics->jit_miss_cnt==miss_cnt+1UL );
+  FD_TEST( fd_memeq( jit2, image, hdr->image_sz ) );
+  fd_progcache_jit_release( other, jit2 );
+  FD_TEST( fd_progcache_jit_acquire( other, rec, syscalls_hash )==jit2 ); /* now a hit */
+  fd_progcache_jit_release( other, jit2 );
+
+  fd_progcache_rec_close( cache, rec );
+
+  /* Clients without JIT slots do not create JIT images */
+
+  fd_pubkey_t key2 = test_key( 2UL );
+  test_account_t acc2;
+  test_account_init( &acc2, &key2, &fd_solana_bpf_loader_program_id,
+                     1, bigger_valid_program_data, bigger_valid_program_data_sz );
+  FD_TEST( fd_progcache_leave( other, NULL ) );
+  FD_TEST( fd_progcache_join( other, cache->join->shmem, NULL, 0UL ) );
+  fd_progcache_rec_t const * rec2 = test_pull( other, acc2.entry, fork_a, &key2, &load_env );
+  FD_TEST( rec2 && rec2->data_gaddr && !rec2->jit_off );
+  FD_TEST( !fd_progcache_jit_acquire( other, rec2, syscalls_hash ) );
+  FD_TEST( !fd_progcache_jit_acquire( cache, rec2, syscalls_hash ) );
+  FD_TEST( fd_progcache_leave( other, NULL ) );
+  fd_wksp_free_laddr( other );
+  fd_progcache_jit_unmap( TEST_JIT_SLOT_CNT, TEST_JIT_SLOT_SZ, other_mem, other_exec_mem );
+
+  fd_progcache_cancel_fork( cache->join, fork_a );
+  test_env_destroy( env );
+  fd_progcache_jit_unmap( TEST_JIT_SLOT_CNT, TEST_JIT_SLOT_SZ, jit_mem, jit_exec_mem );
+}
+
+#endif /* FD_HAS_X86 */
+
 int
 main( int     argc,
       char ** argv ) {
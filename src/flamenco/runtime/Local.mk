@@ -64,6 +64,7 @@ endif
 
 ifdef FD_HAS_HOSTED
 $(call make-unit-test,test_txncache,test_txncache,fd_flamenco fd_ballet fd_util)
+$(call make-unit-test,bench_txncache,bench_txncache,fd_flamenco fd_ballet fd_util)
 ifdef FD_HAS_ATOMIC
 $(call make-fuzz-test,fuzz_txncache_fork_graph,fuzz_txncache_fork_graph,fd_flamenco fd_ballet fd_util)
 endif
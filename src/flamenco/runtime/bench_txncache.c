@@ -0,0 +1,132 @@
+#include "fd_txncache.h"
+#include "fd_txncache_private.h"
+#include "../../util/fd_util.h"
+
+#include <stdlib.h>
+
+/* bench_txncache: replay a linear chain of slots into a txn cache,
+   inserting txn_per_slot transactions per slot that reference random
+   recent blockhashes, and rooting each slot as soon as it is finalized.
+   Then query the tip of the chain for a mix of transactions that were
+   inserted and ones that were not.  Reports single core insert and
+   query throughput.  All transaction hashes are regenerated from their
+   (slot, index) pair rather than stored, so memory traffic is all from
+   the txn cache itself.
+
+   The default rate of 400,000 transactions per slot is 1M TPS at 400ms
+   slots, where each blockhash spans several txnpages.  Pass a lower
+   --txn-per-slot to measure the single page regime. */
+
+/* Transactions reference one of the last BH_DEPTH blockhashes, and
+   queries are for transactions from the last BH_DEPTH slots, so that
+   every queried blockhash is still live at the tip. */
+
+#define BH_DEPTH (64UL)
+FD_STATIC_ASSERT( 2UL*BH_DEPTH<FD_TXNCACHE_MAX_BLOCKHASH_DISTANCE, bh_depth );
+
+static void
+blockhash( uchar out[ static 32 ],
+           ulong slot ) {
+  fd_memset( out, 0, 32UL );
+  FD_STORE( ulong, out, slot+1UL );
+}
+
+static void
+txnhash( uchar out[ static 32 ],
+         ulong seed,
+         ulong slot,
+         ulong idx ) {
+  ulong x = (slot<<32) | idx;
+  for( ulong i=0UL; i<4UL; i++ ) FD_STORE( ulong, out+8UL*i, fd_ulong_hash( x ^ seed ^ (i<<60) ) );
+}
+
+/* ref_slot returns the slot whose blockhash transaction idx in slot
+   references.  Every slot in the last BH_DEPTH is equally likely. */
+
+static ulong
+ref_slot( ulong seed,
+          ulong slot,
+          ulong idx ) {
+  ulong depth = fd_ulong_min( slot, BH_DEPTH );
+  return slot-1UL-fd_ulong_hash( seed ^ (slot<<32) ^ idx ^ 0x5555UL )%depth;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong slot_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--slots",        NULL, 200UL    );
+  ulong txn_per_slot = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-per-slot", NULL, 400000UL );
+  ulong query_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--queries",      NULL, 2000000UL );
+  ulong seed         = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",         NULL, 42UL     );
+  ulong live_slots   = 4UL;
+
+  FD_TEST( slot_cnt>1UL && txn_per_slot && txn_per_slot<(1UL<<32) );
+  FD_LOG_NOTICE(( "txncache bench (slots=%lu txn-per-slot=%lu queries=%lu seed=%lu)", slot_cnt, txn_per_slot, query_cnt, seed ));
+
+  ulong shmem_fp = fd_txncache_shmem_footprint( live_slots, txn_per_slot, 0 );
+  FD_TEST( shmem_fp );
+  void * shmem_mem = aligned_alloc( fd_txncache_shmem_align(), shmem_fp );
+  FD_TEST( shmem_mem );
+  fd_txncache_shmem_t * shmem = fd_txncache_shmem_join( fd_txncache_shmem_new( shmem_mem, live_slots, txn_per_slot, 0, seed ) );
+  FD_TEST( shmem );
+
+  void * ljoin_mem = aligned_alloc( fd_txncache_align(), fd_txncache_footprint( live_slots ) );
+  FD_TEST( ljoin_mem );
+  fd_txncache_t * tc = fd_txncache_join( fd_txncache_new( ljoin_mem, shmem ) );
+  FD_TEST( tc );
+  FD_LOG_NOTICE(( "shmem footprint %.1f MiB", (double)shmem_fp/(double)(1UL<<20) ));
+
+  uchar bh[ 32 ];
+  uchar th[ 32 ];
+
+  fd_txncache_fork_id_t fork = fd_txncache_attach_child( tc, (fd_txncache_fork_id_t){ .val = USHORT_MAX } );
+  blockhash( bh, 0UL );
+  fd_txncache_finalize_fork( tc, fork, 0UL, bh );
+
+  long  insert_ns  = 0L;
+  ulong insert_cnt = 0UL;
+  for( ulong slot=1UL; slot<slot_cnt; slot++ ) {
+    fork = fd_txncache_attach_child( tc, fork );
+    long t0 = fd_log_wallclock();
+    for( ulong i=0UL; i<txn_per_slot; i++ ) {
+      blockhash( bh, ref_slot( seed, slot, i ) );
+      txnhash( th, seed, slot, i );
+      fd_txncache_insert( tc, fork, bh, th );
+    }
+    insert_ns += fd_log_wallclock()-t0;
+    insert_cnt += txn_per_slot;
+    blockhash( bh, slot );
+    fd_txncache_finalize_fork( tc, fork, 0UL, bh );
+    fd_txncache_advance_root( tc, fork );
+  }
+
+  /* Odd queries hit, even queries miss. */
+
+  ulong first_slot = fd_ulong_if( slot_cnt>BH_DEPTH+1UL, slot_cnt-BH_DEPTH, 1UL );
+  ulong span       = slot_cnt-first_slot;
+  ulong hit_cnt    = 0UL;
+  long  t0 = fd_log_wallclock();
+  for( ulong q=0UL; q<query_cnt; q++ ) {
+    ulong slot = first_slot + fd_ulong_hash( q ^ seed )%span;
+    ulong idx  = fd_ulong_hash( q ^ ~seed )%txn_per_slot;
+    blockhash( bh, ref_slot( seed, slot, idx ) );
+    txnhash( th, seed, slot, idx ^ ((q&1UL)<<31) );
+    hit_cnt += (ulong)fd_txncache_query( tc, fork, bh, th );
+  }
+  long query_ns = fd_log_wallclock()-t0;
+  FD_TEST( hit_cnt==query_cnt/2UL );
+
+  double insert_s = (double)insert_ns*1e-9;
+  double query_s  = (double)query_ns *1e-9;
+  FD_LOG_NOTICE(( "insert: %lu in %.3f s, %.2f M/s/core, %.1f ns each", insert_cnt, insert_s, (double)insert_cnt/insert_s*1e-6, insert_s*1e9/(double)insert_cnt ));
+  FD_LOG_NOTICE(( "query:  %lu in %.3f s, %.2f M/s/core, %.1f ns each", query_cnt,  query_s,  (double)query_cnt /query_s *1e-6, query_s *1e9/(double)query_cnt  ));
+
+  free( ljoin_mem );
+  free( shmem_mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
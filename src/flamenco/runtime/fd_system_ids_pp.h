@@ -67,6 +67,8 @@
                                            0xdaU,0xc4U,0x39U,0xdcU,0x1aU,0xebU,0x3bU,0x55U,0x98U,0xa0U,0xf0U,0x00U,0x00U,0x00U,0x00U,0x01U
 #define TOKEN_PROG_ID                      0x06U,0xddU,0xf6U,0xe1U,0xd7U,0x65U,0xa1U,0x93U,0xd9U,0xcbU,0xe1U,0x46U,0xceU,0xebU,0x79U,0xacU, \
                                            0x1cU,0xb4U,0x85U,0xedU,0x5fU,0x5bU,0x37U,0x91U,0x3aU,0x8cU,0xf5U,0x85U,0x7eU,0xffU,0x00U,0xa9U
+#define TOKEN_2022_PROG_ID                 0x06U,0xddU,0xf6U,0xe1U,0xeeU,0x75U,0x8fU,0xdeU,0x18U,0x42U,0x5dU,0xbcU,0xe4U,0x6cU,0xcdU,0xdaU, \
+                                           0xb6U,0x1aU,0xfcU,0x4dU,0x83U,0xb9U,0x0dU,0x27U,0xfeU,0xbdU,0xf9U,0x28U,0xd8U,0xa1U,0x8bU,0xfcU
 #define ZK_TOKEN_PROG_ID                   0x08U,0x63U,0xbaU,0x8dU,0xd9U,0xc4U,0xc2U,0xfbU,0x17U,0x4aU,0x05U,0xcbU,0xa2U,0x7eU,0x2aU,0x2cU, \
                                            0xd6U,0x23U,0x57U,0x3dU,0x79U,0xe9U,0x0bU,0x35U,0xb5U,0x79U,0xfcU,0x0dU,0x00U,0x00U,0x00U,0x00U
 #define ZK_EL_GAMAL_PROG_ID                0x08U,0x63U,0x75U,0xacU,0xe2U,0xaeU,0xeaU,0x28U,0x1aU,0x6bU,0x37U,0x4dU,0x68U,0x1bU,0xa7U,0x6aU, \
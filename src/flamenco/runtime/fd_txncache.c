@@ -1,14 +1,15 @@
 #include "fd_txncache.h"
 #include "fd_txncache_private.h"
 #include "../../util/log/fd_log.h"
+#if FD_HAS_AVX
+#include "../../util/simd/fd_avx.h"
+#endif
 
 struct blockcache {
   fd_txncache_blockcache_shmem_t * shmem;
 
-  uint * heads;          /* The hash table for the blockhash.  Each entry is a pointer to the head of a linked list of
-                            transactions that reference this blockhash.  As we add transactions to the bucket, the head
-                            pointer is updated to the new item, and the new item is pointed to the previous head. */
-  ushort * pages;        /* A list of the txnpages containing the transactions for this blockcache. */
+  ushort * pages;        /* A list of the txnpages containing the transactions for this blockcache.  Each page indexes
+                            its own transactions, so a lookup probes the index of each page in turn. */
 
   descends_set_t * descends; /* Each fork can descend from other forks in the txncache, and this bit vector contains one
                                 value for each fork in the txncache.  If this fork descends from some other fork F, then
@@ -32,7 +33,6 @@ struct fd_txncache_private {
                                        (just the pages are acquired/released, rather than each txn). */
 
   ushort * scratch_pages;
-  uint * scratch_heads;
   fd_txncache_txnpage_t * scratch_txnpage;
 };
 
@@ -67,7 +67,6 @@ fd_txncache_new( void *                ljoin,
 
   ulong max_active_slots = shmem->active_slots_max;
   ulong blockhash_map_chains = fd_ulong_pow2_up( 2UL*shmem->active_slots_max );
-  ulong bucket_cnt = shmem->bucket_cnt;
 
   /* Page counts come from the shmem header rather than being
      re-derived, so the layout walk below cannot desync from the one in
@@ -86,12 +85,10 @@ fd_txncache_new( void *                ljoin,
   void * _blockhash_map       = FD_SCRATCH_ALLOC_APPEND( l, blockhash_map_align(),           blockhash_map_footprint( blockhash_map_chains )             );
   void * _blockcache_pool     = FD_SCRATCH_ALLOC_APPEND( l, blockcache_pool_align(),         blockcache_pool_footprint( max_active_slots )               );
   void * _blockcache_pages    = FD_SCRATCH_ALLOC_APPEND( l, alignof(ushort),                 max_active_slots*_max_txnpages_per_blockhash*sizeof(ushort) );
-  void * _blockcache_heads    = FD_SCRATCH_ALLOC_APPEND( l, alignof(uint),                   max_active_slots*bucket_cnt*sizeof(uint)                    );
   void * _blockcache_descends = FD_SCRATCH_ALLOC_APPEND( l, descends_set_align(),            max_active_slots*_descends_footprint                        );
   void * _txnpages_free       = FD_SCRATCH_ALLOC_APPEND( l, alignof(ushort),                 _max_txnpages*sizeof(ushort)                                );
   void * _txnpages            = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_txncache_txnpage_t),  _max_txnpages*sizeof(fd_txncache_txnpage_t)                 );
   void * _scratch_pages       = FD_SCRATCH_ALLOC_APPEND( l, alignof(ushort),                 _max_txnpages_per_blockhash*sizeof(ushort)                  );
-  void * _scratch_heads       = FD_SCRATCH_ALLOC_APPEND( l, alignof(uint),                   bucket_cnt*sizeof(uint)                                     );
   void * _scratch_txnpage     = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_txncache_txnpage_t),  sizeof(fd_txncache_txnpage_t)                               );
 
   FD_SCRATCH_ALLOC_INIT( l2, ljoin );
@@ -105,7 +102,6 @@ fd_txncache_new( void *                ljoin,
 
   for( ulong i=0UL; i<shmem->active_slots_max; i++ ) {
     ltc->blockcache_pool[ i ].pages    = (ushort *)_blockcache_pages + i*_max_txnpages_per_blockhash;
-    ltc->blockcache_pool[ i ].heads    = (uint *)_blockcache_heads + i*bucket_cnt;
     ltc->blockcache_pool[ i ].descends = descends_set_join( (uchar *)_blockcache_descends + i*_descends_footprint );
     ltc->blockcache_pool[ i ].shmem    = ltc->blockcache_shmem_pool + i;
     FD_TEST( ltc->blockcache_pool[ i ].shmem );
@@ -120,7 +116,6 @@ fd_txncache_new( void *                ljoin,
   ltc->txnpages      = (fd_txncache_txnpage_t *)_txnpages;
 
   ltc->scratch_pages   = _scratch_pages;
-  ltc->scratch_heads   = _scratch_heads;
   ltc->scratch_txnpage = _scratch_txnpage;
 
   return (void *)ltc;
@@ -160,11 +155,96 @@ fd_txncache_reset( fd_txncache_t * tc ) {
 }
 
 FD_FN_PURE static inline ulong
-fd_txncache_bucket( fd_txncache_t const * tc,
-                    uchar const *         txnhash ) {
-  return fd_ulong_hash( FD_LOAD( ulong, txnhash )^tc->shmem->seed )%tc->shmem->bucket_cnt;
+fd_txncache_key_hash( fd_txncache_t const * tc,
+                      uchar const *         txnhash ) {
+  return fd_ulong_hash( FD_LOAD( ulong, txnhash )^tc->shmem->seed );
+}
+
+/* The home bucket and tag of a key come from disjoint bits of its
+   hash.  Tag 0 is reserved for empty slots. */
+
+FD_FN_CONST static inline ulong
+fd_txncache_key_bucket( ulong hash ) {
+  return (hash&UINT_MAX)%FD_TXNCACHE_TAG_BUCKETS_PER_PAGE;
+}
+
+FD_FN_CONST static inline ushort
+fd_txncache_key_tag( ulong hash ) {
+  ushort tag = (ushort)(hash>>48);
+  return fd_ushort_if( !!tag, tag, (ushort)1 );
+}
+
+static inline void
+fd_txncache_txnpage_index_init( fd_txncache_txnpage_t * txnpage ) {
+  for( ulong i=0UL; i<FD_TXNCACHE_TAG_BUCKETS_PER_PAGE; i++ ) {
+    memset( txnpage->index[ i ].tag, 0x00, sizeof(txnpage->index[ i ].tag) );
+    memset( txnpage->index[ i ].idx, 0xFF, sizeof(txnpage->index[ i ].idx) );
+  }
+}
+
+/* fd_txncache_txnpage_index_insert adds txn_idx, which must already be
+   written to the page, to the page index.  Safe to call concurrently
+   with other inserts and queries on the same page.  A slot is claimed
+   by its idx, and becomes visible to queries when its tag is stored.
+   Cannot fail because the index has more slots than the page has
+   transactions. */
+
+static inline void
+fd_txncache_txnpage_index_insert( fd_txncache_txnpage_t * txnpage,
+                                  ulong                   hash,
+                                  ulong                   txn_idx ) {
+  ushort tag    = fd_txncache_key_tag( hash );
+  ulong  bucket = fd_txncache_key_bucket( hash );
+  for(;;) {
+    fd_txncache_tag_bucket_t * b = txnpage->index + bucket;
+    for( ulong i=0UL; i<FD_TXNCACHE_TAG_BUCKET_SLOTS; i++ ) {
+      if( FD_LIKELY( FD_VOLATILE_CONST( b->idx[ i ] )!=(ushort)USHORT_MAX ) ) continue;
+      if( FD_UNLIKELY( FD_ATOMIC_CAS( &b->idx[ i ], (ushort)USHORT_MAX, (ushort)txn_idx )!=(ushort)USHORT_MAX ) ) continue;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( b->tag[ i ] ) = tag;
+      return;
+    }
+    bucket = fd_ulong_if( bucket+1UL<FD_TXNCACHE_TAG_BUCKETS_PER_PAGE, bucket+1UL, 0UL );
+  }
+}
+
+/* fd_txncache_tag_match returns a mask with bits 2i and 2i+1 set for
+   each slot i in bucket b with the given tag.  fd_txncache_tag_free
+   returns non-zero if b has a free slot, in which case no key with
+   this home bucket was ever pushed further along the probe sequence. */
+
+#if FD_HAS_AVX
+
+static inline uint
+fd_txncache_tag_match( fd_txncache_tag_bucket_t const * b,
+                       ushort                           tag ) {
+  return (uint)_mm256_movemask_epi8( wh_eq( wh_ld( b->tag ), wh_bcast( tag ) ) );
+}
+
+static inline int
+fd_txncache_tag_free( fd_txncache_tag_bucket_t const * b ) {
+  return !!_mm256_movemask_epi8( wh_eq( wh_ld( b->idx ), wh_bcast( USHORT_MAX ) ) );
+}
+
+#else
+
+static inline uint
+fd_txncache_tag_match( fd_txncache_tag_bucket_t const * b,
+                       ushort                           tag ) {
+  uint mask = 0U;
+  for( ulong i=0UL; i<FD_TXNCACHE_TAG_BUCKET_SLOTS; i++ ) mask |= fd_uint_if( b->tag[ i ]==tag, 3U<<(2UL*i), 0U );
+  return mask;
 }
 
+static inline int
+fd_txncache_tag_free( fd_txncache_tag_bucket_t const * b ) {
+  int free = 0;
+  for( ulong i=0UL; i<FD_TXNCACHE_TAG_BUCKET_SLOTS; i++ ) free |= b->idx[ i ]==(ushort)USHORT_MAX;
+  return free;
+}
+
+#endif
+
 static fd_txncache_txnpage_t *
 fd_txncache_ensure_txnpage( fd_txncache_t * tc,
                             blockcache_t *  blockcache ) {
@@ -195,6 +275,7 @@ fd_txncache_ensure_txnpage( fd_txncache_t * tc,
     ushort txnpage_idx = tc->txnpages_free[ txnpages_free_cnt-1UL ];
     fd_txncache_txnpage_t * txnpage = &tc->txnpages[ txnpage_idx ];
     txnpage->free = FD_TXNCACHE_TXNS_PER_PAGE;
+    fd_txncache_txnpage_index_init( txnpage );
     FD_COMPILER_MFENCE();
     blockcache->pages[ page_cnt ] = txnpage_idx;
     FD_COMPILER_MFENCE();
@@ -217,8 +298,6 @@ fd_txncache_insert_txn( fd_txncache_t *         tc,
                         fd_txncache_txnpage_t * txnpage,
                         fd_txncache_fork_id_t   fork_id,
                         uchar const *           txnhash ) {
-  ulong txnpage_idx = (ulong)(txnpage - tc->txnpages);
-
   for(;;) {
     ushort txnpage_free = txnpage->free;
     if( FD_UNLIKELY( !txnpage_free ) ) return 0;
@@ -234,15 +313,7 @@ fd_txncache_insert_txn( fd_txncache_t *         tc,
     txnpage->txns[ txn_idx ]->generation = tc->blockcache_pool[ fork_id.val ].shmem->generation;
     FD_COMPILER_MFENCE();
 
-    ulong txn_bucket = fd_txncache_bucket( tc, txnhash+txnhash_offset );
-    for(;;) {
-      uint head = blockcache->heads[ txn_bucket ];
-      txnpage->txns[ txn_idx ]->blockcache_next = head;
-      FD_COMPILER_MFENCE();
-      if( FD_LIKELY( FD_ATOMIC_CAS( &blockcache->heads[ txn_bucket ], head, (uint)(FD_TXNCACHE_TXNS_PER_PAGE*txnpage_idx+txn_idx) )==head ) ) break;
-      FD_SPIN_PAUSE();
-    }
-
+    fd_txncache_txnpage_index_insert( txnpage, fd_txncache_key_hash( tc, txnhash+txnhash_offset ), txn_idx );
     return 1;
   }
 }
@@ -284,7 +355,6 @@ fd_txncache_attach_child( fd_txncache_t *       tc,
 
   fork->shmem->txnhash_offset = 0UL;
   fork->shmem->frozen = 0;
-  memset( fork->heads, 0xFF, tc->shmem->bucket_cnt*sizeof(uint) );
   fork->shmem->pages_cnt = 0;
   memset( fork->pages, 0xFF, tc->shmem->txnpages_per_blockhash_max*sizeof(fork->pages[ 0 ]) );
 
@@ -452,7 +522,6 @@ static void
 purge_stale_on_blockcache( fd_txncache_t * tc,
                            blockcache_t *  blockcache ) {
   FD_TEST( blockcache->shmem->frozen>=0 );
-  memset( tc->scratch_heads, 0xFF, tc->shmem->bucket_cnt*sizeof(tc->scratch_heads[ 0 ]) );
   memset( tc->scratch_pages, 0xFF, tc->shmem->txnpages_per_blockhash_max*sizeof(tc->scratch_pages[ 0 ]) );
   ushort scratch_pages_cnt = 0;
   ushort scratch_txnpage_idx = USHORT_MAX;
@@ -473,17 +542,13 @@ purge_stale_on_blockcache( fd_txncache_t * tc,
           }
           scratch_txnpage_idx = curr_txnpage_idx;
           tc->scratch_txnpage->free = FD_TXNCACHE_TXNS_PER_PAGE;
+          fd_txncache_txnpage_index_init( tc->scratch_txnpage );
           tc->scratch_pages[ scratch_pages_cnt ] = scratch_txnpage_idx;
           scratch_pages_cnt++;
         }
         ulong txn_idx = FD_TXNCACHE_TXNS_PER_PAGE-tc->scratch_txnpage->free;
         memcpy( tc->scratch_txnpage->txns[ txn_idx ], curr_txn, sizeof(*curr_txn) );
-        ulong txn_bucket = fd_txncache_bucket( tc, curr_txn->txnhash );
-        uint head = tc->scratch_heads[ txn_bucket ];
-        tc->scratch_txnpage->txns[ txn_idx ]->blockcache_next = head;
-        ulong txn_gidx = FD_TXNCACHE_TXNS_PER_PAGE*scratch_txnpage_idx+txn_idx;
-        FD_TEST( txn_gidx<UINT_MAX );
-        tc->scratch_heads[ txn_bucket ] = (uint)txn_gidx;
+        fd_txncache_txnpage_index_insert( tc->scratch_txnpage, fd_txncache_key_hash( tc, curr_txn->txnhash ), txn_idx );
         tc->scratch_txnpage->free--;
       } else {
         /* Stale transaction.  Drop. */
@@ -502,7 +567,6 @@ purge_stale_on_blockcache( fd_txncache_t * tc,
   }
   blockcache->shmem->pages_cnt = scratch_pages_cnt;
   memcpy( blockcache->pages, tc->scratch_pages, tc->shmem->txnpages_per_blockhash_max*sizeof(blockcache->pages[0]) );
-  memcpy( blockcache->heads, tc->scratch_heads, tc->shmem->bucket_cnt*sizeof(blockcache->heads[0]) );
 }
 
 static void
@@ -586,16 +650,28 @@ fd_txncache_query( fd_txncache_t *       tc,
 
   int found = 0;
 
-  ulong txnhash_offset = blockcache->shmem->txnhash_offset;
-  ulong head_hash = fd_txncache_bucket( tc, txnhash+txnhash_offset );
-  for( uint head=blockcache->heads[ head_hash ]; head!=UINT_MAX; head=tc->txnpages[ head/FD_TXNCACHE_TXNS_PER_PAGE ].txns[ head%FD_TXNCACHE_TXNS_PER_PAGE ]->blockcache_next ) {
-    fd_txncache_single_txn_t * txn = tc->txnpages[ head/FD_TXNCACHE_TXNS_PER_PAGE ].txns[ head%FD_TXNCACHE_TXNS_PER_PAGE ];
-
-    blockcache_t const * txn_fork = &tc->blockcache_pool[ txn->fork_id.val ];
-    int descends = (txn->fork_id.val==fork_id.val || descends_set_test( fork->descends, txn->fork_id.val )) && txn_fork->shmem->frozen>=0 && txn_fork->shmem->generation==txn->generation;
-    if( FD_LIKELY( descends && !memcmp( txnhash+txnhash_offset, txn->txnhash, 20UL ) ) ) {
-      found = 1;
-      break;
+  uchar const * key  = txnhash+blockcache->shmem->txnhash_offset;
+  ulong         hash = fd_txncache_key_hash( tc, key );
+  ushort        tag  = fd_txncache_key_tag( hash );
+  ulong pages_cnt = FD_VOLATILE_CONST( blockcache->shmem->pages_cnt );
+  for( ulong i=0UL; !found && i<pages_cnt; i++ ) {
+    fd_txncache_txnpage_t const * txnpage = &tc->txnpages[ blockcache->pages[ i ] ];
+    ulong bucket = fd_txncache_key_bucket( hash );
+    for(;;) {
+      fd_txncache_tag_bucket_t const * b = txnpage->index + bucket;
+      for( uint match=fd_txncache_tag_match( b, tag ); match; match=fd_uint_pop_lsb( fd_uint_pop_lsb( match ) ) ) {
+        ushort txn_idx = FD_VOLATILE_CONST( b->idx[ fd_uint_find_lsb( match )>>1 ] );
+        fd_txncache_single_txn_t const * txn = txnpage->txns[ txn_idx ];
+
+        blockcache_t const * txn_fork = &tc->blockcache_pool[ txn->fork_id.val ];
+        int descends = (txn->fork_id.val==fork_id.val || descends_set_test( fork->descends, txn->fork_id.val )) && txn_fork->shmem->frozen>=0 && txn_fork->shmem->generation==txn->generation;
+        if( FD_LIKELY( descends && !memcmp( key, txn->txnhash, 20UL ) ) ) {
+          found = 1;
+          break;
+        }
+      }
+      if( FD_LIKELY( found || fd_txncache_tag_free( b ) ) ) break;
+      bucket = fd_ulong_if( bucket+1UL<FD_TXNCACHE_TAG_BUCKETS_PER_PAGE, bucket+1UL, 0UL );
     }
   }
 
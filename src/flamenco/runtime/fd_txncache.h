@@ -52,15 +52,19 @@
    equivocations, which would be impossible if they were under one
    blockhash).
 
-   Both hash maps are chained hash maps, and for the txnhash map items
-   come from a pool of pages of transactions.  We use pages of
-   transactions to support fast removal of a blockhash from the top
-   level map.
+   The blockhash map is a chained hash map.  The txnhash map is split
+   across a pool of pages of transactions, and each page carries an
+   open addressed index of the transactions in it, with sixteen 16-bit
+   tags per cache line bucket so a probe is a single vector compare.
+   We use pages of transactions to support fast removal of a blockhash
+   from the top level map, and since the index lives in the page it
+   goes with it.  A query probes the index of each page of the
+   blockhash in turn.
 
    This adds additional memory overhead, a blockhash with only one
    transaction in it will still consume a full page (16,384) of
    transactions of memory.  Allocating a new transaction page to a
-   chained map is rare (once every 16,384 inserts) so the cost amortizes
+   blockhash is rare (once every 16,384 inserts) so the cost amortizes
    to zero.  Creating a blockhash happens once per blockhash, so also
    amortizes to zero, the only operation we care about is then the
    simple insert case with an unfull transaction page into an existing
@@ -78,8 +82,8 @@
       // 3. Write the transaction into the page and the map
 
          page.txns[ idx ] = txn;
-         page.txns[ idx ].next = by_blockhash.txns[ txnhash ].idx;
-         by_blockhash.txns[ txnhash ].head.compare_and_swap( current, idx );
+         page.index[ txnhash ].idx.compare_and_swap( FREE, idx );
+         page.index[ txnhash ].tag = tag( txnhash );
 
    Step 1 is fast assuming equivocation is rare, since there will only
    ever be one matching blockhash in the multi map.
@@ -18,8 +18,35 @@
    [149, 300). */
 #define FD_TXNCACHE_MAX_BLOCKHASH_DISTANCE (151UL)
 
+/* Each txnpage carries its own open addressed index of the
+   transactions in it, so that releasing the pages of a blockcache also
+   releases its index, and purging stays O(pages).  The index is an
+   array of FD_TXNCACHE_TAG_BUCKETS_PER_PAGE cache line sized buckets,
+   each with FD_TXNCACHE_TAG_BUCKET_SLOTS slots.  A slot holds a 16-bit
+   tag derived from the transaction hash (0 means the slot is empty or
+   being written) and the index of the transaction in the page
+   (USHORT_MAX means the slot is free).  All tags in a bucket are
+   compared against a query with one vector compare, and only matching
+   slots are followed into the page to check the full 20 byte hash.
+   Buckets are probed linearly, and the index is sized at a load factor
+   of 2/3 so probes rarely leave the home bucket. */
+
+#define FD_TXNCACHE_TAG_BUCKET_SLOTS     (16UL)
+#define FD_TXNCACHE_TAG_BUCKETS_PER_PAGE (1536UL)
+
+FD_STATIC_ASSERT( FD_TXNCACHE_TAG_BUCKET_SLOTS*FD_TXNCACHE_TAG_BUCKETS_PER_PAGE>FD_TXNCACHE_TXNS_PER_PAGE, tag_index );
+FD_STATIC_ASSERT( FD_TXNCACHE_TXNS_PER_PAGE<USHORT_MAX, tag_index );
+
+struct __attribute__((aligned(64UL))) fd_txncache_tag_bucket {
+  ushort tag[ FD_TXNCACHE_TAG_BUCKET_SLOTS ];
+  ushort idx[ FD_TXNCACHE_TAG_BUCKET_SLOTS ];
+};
+
+typedef struct fd_txncache_tag_bucket fd_txncache_tag_bucket_t;
+
+FD_STATIC_ASSERT( sizeof(fd_txncache_tag_bucket_t)==64UL, fd_txncache_tag_bucket );
+
 struct __attribute__((packed)) fd_txncache_single_txn {
-  uint  blockcache_next; /* Pointer to the next element in the blockcache hash chain containing this entry from the pool. */
   uint  generation;      /* The generation of the fork when this transaction was inserted.  Used to
                             determine if the transaction is still valid for a fork that might have
                             advanced since insertion. */
@@ -33,9 +60,10 @@ struct __attribute__((packed)) fd_txncache_single_txn {
 
 typedef struct fd_txncache_single_txn fd_txncache_single_txn_t;
 
-FD_STATIC_ASSERT( sizeof(fd_txncache_single_txn_t)==30UL, fd_txncache_single_txn );
+FD_STATIC_ASSERT( sizeof(fd_txncache_single_txn_t)==26UL, fd_txncache_single_txn );
 
 struct fd_txncache_txnpage {
+  fd_txncache_tag_bucket_t index[ FD_TXNCACHE_TAG_BUCKETS_PER_PAGE ]; /* Index of the transactions in the page. */
   ushort                   free; /* The number of free txn entries in this page. */
   fd_txncache_single_txn_t txns[ FD_TXNCACHE_TXNS_PER_PAGE][ 1 ]; /* The transactions in the page. */
 };
@@ -127,8 +155,6 @@ struct __attribute__((aligned(FD_TXNCACHE_SHMEM_ALIGN))) fd_txncache_shmem_priva
 
   ulong  txn_per_slot_max;
   ulong  active_slots_max;
-  ulong  bucket_cnt;      /* Hash buckets per blockcache.  Decoupled from txn_per_slot_max (load
-                             factor 8) to reduce the heads arrays' memory footprint. */
   ushort txnpages_per_blockhash_max;
   ushort max_txnpages;
 
@@ -156,11 +182,6 @@ fd_txncache_max_txnpages( ulong max_active_slots,
                           ulong max_txn_per_slot,
                           int   larger_max_cost_per_block );
 
-FD_FN_CONST static inline ulong
-fd_txncache_bucket_cnt( ulong max_txn_per_slot ) {
-  return fd_ulong_max( 1UL, (max_txn_per_slot+7UL)/8UL );
-}
-
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_runtime_fd_txncache_private_h */
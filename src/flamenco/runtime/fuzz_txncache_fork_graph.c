@@ -26,7 +26,6 @@
 
 typedef struct fuzz_blockcache_private {
   fd_txncache_blockcache_shmem_t * shmem;
-  uint *                           heads;
   ushort *                         pages;
   descends_set_t *                 descends;
 } fuzz_blockcache_private_t;
@@ -39,7 +38,6 @@ struct fd_txncache_private {
   ushort *                         txnpages_free;
   fd_txncache_txnpage_t *          txnpages;
   ushort *                         scratch_pages;
-  uint *                           scratch_heads;
   fd_txncache_txnpage_t *          scratch_txnpage;
 };
 
@@ -508,7 +508,20 @@ fd_bpf_execute( fd_exec_instr_ctx_t *      instr_ctx,
 
   long const regime1 = fd_tickcount();
 
-  int exec_err = fd_vm_exec( vm );
+  /* Run the program's JIT image if the program cache has one ready
+     for us (identical results, see fd_vm_jit.h) */
+
+  int exec_err = FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+#if FD_HAS_X86
+  if( FD_LIKELY( !vm->trace ) ) {
+    fd_vm_jit_t const * jit = fd_progcache_jit_acquire( instr_ctx->runtime->progcache, cache_entry, fd_vm_jit_syscalls_hash( syscalls ) );
+    if( jit ) {
+      exec_err = fd_vm_exec_jit( vm, jit );
+      fd_progcache_jit_release( instr_ctx->runtime->progcache, jit );
+    }
+  }
+#endif
+  if( exec_err==FD_VM_ERR_EBPF_JIT_NOT_COMPILED ) exec_err = fd_vm_exec( vm );
   instr_ctx->txn_out->details.compute_budget.compute_meter = vm->cu;
 
   long const regime2 = fd_tickcount();
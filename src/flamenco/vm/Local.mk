@@ -1,6 +1,10 @@
 ifdef FD_HAS_HOSTED
 $(call add-hdrs,fd_vm_base.h fd_vm.h fd_vm_private.h) # FIXME: PRIVATE TEMPORARILY HERE DUE TO SOME MESSINESS IN FD_VM_SYSCALL.H
 $(call add-objs,fd_vm fd_vm_interp fd_vm_disasm fd_vm_trace,fd_flamenco)
+ifdef FD_HAS_X86
+$(call add-hdrs,fd_vm_jit.h)
+$(call add-objs,fd_vm_jit,fd_flamenco)
+endif
 
 $(call add-hdrs,test_vm_util.h)
 $(call add-objs,test_vm_util,fd_flamenco)
@@ -19,6 +23,10 @@ endif
 ifdef FD_HAS_BLST
 $(call make-unit-test,test_vm_instr,test_vm_instr,fd_flamenco fd_ballet fd_util,$(BLST_LIBS))
 $(call run-unit-test,test_vm_instr)
+ifdef FD_HAS_X86
+$(call make-unit-test,test_vm_jit,test_vm_jit,fd_flamenco fd_ballet fd_util,$(BLST_LIBS))
+$(call run-unit-test,test_vm_jit)
+endif
 endif
 
 ifdef FD_HAS_HOSTED
@@ -3,6 +3,12 @@
 #include "../../ballet/murmur3/fd_murmur3.h"
 #include "../runtime/tests/fd_dump_pb.h"
 
+void
+fd_vm_dump_syscall( fd_vm_t const * vm,
+                    char const *    name ) {
+  fd_dump_vm_syscall_to_protobuf( vm, name );
+}
+
 /* FIXME: MAKE DIFFERENT VERSIONS FOR EACH COMBO OF CHECK_ALIGN/TRACE? */
 /* TODO: factor out common unpacking code */
 
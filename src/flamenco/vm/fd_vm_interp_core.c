@@ -158,7 +158,7 @@
 # define FD_VM_INTERP_SYSCALL_EXEC_DUMP                                       \
   /* Dumping for debugging purposes */                                        \
   if( FD_UNLIKELY( vm->dump_syscall_to_pb ) ) {                               \
-    fd_dump_vm_syscall_to_protobuf( vm, syscall->name );                      \
+    fd_vm_dump_syscall( vm, syscall->name );                                  \
   }
 
 # define FD_VM_INTERP_SYSCALL_EXEC                                            \
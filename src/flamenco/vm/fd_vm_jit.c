@@ -0,0 +1,1601 @@
+#include "fd_vm_jit.h"
+#include "fd_vm_private.h"
+#include "../../ballet/murmur3/fd_murmur3.h"
+
+#if !FD_HAS_X86
+#error "fd_vm_jit requires an x86-64 target"
+#endif
+
+/* Compiled image layout **********************************************
+
+   A fd_vm_jit_t is a header followed by a dispatch table with one
+   entry per text word (plus one for the phantom word at text_cnt),
+   followed by the machine code.  Compile time scratch lives after the
+   code region and is not part of the image.
+
+   The dispatch table is used for dynamic control flow (returns, callx
+   and entering the program at an arbitrary pc).  For each text word
+   pc, it holds idx, the number of instructions in [0,pc) (LDDW counts
+   as a single instruction), run_end, one plus the idx of the last
+   instruction of the linear run starting at pc, and code_off, the
+   offset of the native code for pc.
+
+   Register assignment (sBPF -> x86-64):
+
+     r0 rax   r1 rdi   r2 rsi   r3 rdx   r4 r8   r5 r9
+     r6 rbx   r7 r12   r8 r13   r9 r14   r10 r15
+
+   rbp holds a pointer to the fd_vm_jit_ctx_t of the execution, r10
+   holds the instruction meter and rcx / r11 are scratch.
+
+   The instruction meter M is the remaining compute budget at the
+   start of the current linear run plus the idx of the first
+   instruction of the run.  Thus, at any instruction pc of the run,
+   M-idx(pc) is the budget the interpreter would have before executing
+   pc and a branch at pc leaves M-idx(pc)-1.  A run starting at t can
+   be executed completely iff M>=run_end(t), which is what the compiled
+   code checks whenever it enters a run. */
+
+struct fd_vm_jit_pc {
+  uint idx;
+  uint run_end;
+  uint code_off;
+  uint flags;    /* FD_VM_JIT_PC_FLAG_* (compile time only) */
+};
+
+typedef struct fd_vm_jit_pc fd_vm_jit_pc_t;
+
+#define FD_VM_JIT_PC_FLAG_ADDL   (1U) /* second word of a LDDW */
+#define FD_VM_JIT_PC_FLAG_BRANCH (2U) /* terminates a linear run */
+
+#define FD_VM_JIT_MAGIC (0xf17eda2c37317a00UL) /* firedancer vm jit ver 0 */
+
+struct __attribute__((aligned(FD_VM_JIT_ALIGN))) fd_vm_jit_private {
+  ulong magic;         /* ==FD_VM_JIT_MAGIC */
+  ulong text_cnt_max;
+  ulong code_max;
+
+  /* Compiled program (text_cnt==0 if not compiled) */
+
+  ulong text_cnt;
+  ulong text_off;
+  ulong entry_pc;
+  ulong sbpf_version;
+  ulong syscalls_hash; /* fd_vm_jit_syscalls_hash of the compile map */
+  ulong code_sz;
+
+  /* Program the image is bound to (see fd_vm_jit_bind) */
+
+  ulong const * text;
+  ulong const * calldests;
+
+  /* Followed by fd_vm_jit_pc_t pc_tbl[ text_cnt_max+1 ] (aligned 16),
+     uchar code[ code_max ] (aligned 64) and compile scratch */
+};
+
+/* FD_VM_JIT_INSTR_MAX bounds the number of bytes of code emitted for a
+   single sBPF instruction or stub.  FD_VM_JIT_CODE_PER_WORD bounds the
+   total code size (including stubs) emitted per text word. */
+
+#define FD_VM_JIT_INSTR_MAX     (256UL)
+#define FD_VM_JIT_CODE_PER_WORD (384UL)
+#define FD_VM_JIT_CODE_EXTRA    (4096UL)
+
+/* Compile time fixups and out-of-line stubs */
+
+#define FD_VM_JIT_FIX_PC   (0U) /* rel32 to the native code of pc         */
+#define FD_VM_JIT_FIX_EXIT (1U) /* rel32 to the exit stub of pc           */
+#define FD_VM_JIT_FIX_MEM  (2U) /* rel32 to memory slow path stub idx     */
+
+struct fd_vm_jit_fixup {
+  uint pos;
+  uint kind;
+  uint arg;
+};
+
+typedef struct fd_vm_jit_fixup fd_vm_jit_fixup_t;
+
+struct fd_vm_jit_mstub {
+  uint  pc;    /* instruction */
+  uint  pos;   /* code offset of the stub */
+  uint  ret;   /* where to continue with r11 holding the haddr */
+  int   off;   /* vaddr = reg[ base ] + off */
+  uchar base;  /* sBPF register */
+  uchar sz;    /* access size in bytes */
+  uchar write; /* 1 if a store */
+};
+
+typedef struct fd_vm_jit_mstub fd_vm_jit_mstub_t;
+
+#define FD_VM_JIT_FIXUP_PER_WORD (8UL)
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_private_tbl_off( void ) {
+  return fd_ulong_align_up( sizeof(fd_vm_jit_t), 16UL );
+}
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_private_code_off( ulong text_cnt_max ) {
+  return fd_ulong_align_up( fd_vm_jit_private_tbl_off() + (text_cnt_max+1UL)*sizeof(fd_vm_jit_pc_t), 64UL );
+}
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_private_code_max( ulong text_cnt_max ) {
+  return (text_cnt_max+1UL)*FD_VM_JIT_CODE_PER_WORD + FD_VM_JIT_CODE_EXTRA;
+}
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_private_fix_max( ulong text_cnt_max ) {
+  return (text_cnt_max+1UL)*FD_VM_JIT_FIXUP_PER_WORD + 64UL;
+}
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_private_scratch_off( ulong text_cnt_max ) {
+  return fd_ulong_align_up( fd_vm_jit_private_code_off( text_cnt_max ) + fd_vm_jit_private_code_max( text_cnt_max ), 16UL );
+}
+
+static inline fd_vm_jit_pc_t *
+fd_vm_jit_private_tbl( fd_vm_jit_t const * jit ) {
+  return (fd_vm_jit_pc_t *)((ulong)jit + fd_vm_jit_private_tbl_off());
+}
+
+static inline uchar *
+fd_vm_jit_private_code( fd_vm_jit_t const * jit ) {
+  return (uchar *)((ulong)jit + fd_vm_jit_private_code_off( jit->text_cnt_max ));
+}
+
+ulong
+fd_vm_jit_align( void ) {
+  return FD_VM_JIT_ALIGN;
+}
+
+ulong
+fd_vm_jit_footprint( ulong text_cnt_max ) {
+  if( FD_UNLIKELY( (!text_cnt_max) | (text_cnt_max>(ulong)INT_MAX/FD_VM_JIT_CODE_PER_WORD) ) ) return 0UL;
+  ulong fix_max = fd_vm_jit_private_fix_max( text_cnt_max );
+  return fd_ulong_align_up( fd_vm_jit_private_scratch_off( text_cnt_max )
+                            + fix_max                 *sizeof(fd_vm_jit_fixup_t)
+                            + (text_cnt_max+1UL)      *sizeof(fd_vm_jit_mstub_t)
+                            + (text_cnt_max+1UL)      *sizeof(uint),
+                            FD_VM_JIT_ALIGN );
+}
+
+void *
+fd_vm_jit_new( void * shmem,
+               ulong  text_cnt_max ) {
+  fd_vm_jit_t * jit = (fd_vm_jit_t *)shmem;
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_vm_jit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_vm_jit_footprint( text_cnt_max ) ) ) {
+    FD_LOG_WARNING(( "bad text_cnt_max" ));
+    return NULL;
+  }
+
+  memset( jit, 0, sizeof(fd_vm_jit_t) );
+
+  jit->text_cnt_max = text_cnt_max;
+  jit->code_max     = fd_vm_jit_private_code_max( text_cnt_max );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( jit->magic ) = FD_VM_JIT_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_vm_jit_t *
+fd_vm_jit_join( void * shjit ) {
+  fd_vm_jit_t * jit = (fd_vm_jit_t *)shjit;
+
+  if( FD_UNLIKELY( !jit ) ) {
+    FD_LOG_WARNING(( "NULL shjit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( jit->magic!=FD_VM_JIT_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return jit;
+}
+
+void *
+fd_vm_jit_leave( fd_vm_jit_t * jit ) {
+
+  if( FD_UNLIKELY( !jit ) ) {
+    FD_LOG_WARNING(( "NULL jit" ));
+    return NULL;
+  }
+
+  return (void *)jit;
+}
+
+void *
+fd_vm_jit_delete( void * shjit ) {
+  fd_vm_jit_t * jit = (fd_vm_jit_t *)shjit;
+
+  if( FD_UNLIKELY( !jit ) ) {
+    FD_LOG_WARNING(( "NULL shjit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( jit->magic!=FD_VM_JIT_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( jit->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return (void *)jit;
+}
+
+ulong
+fd_vm_jit_code_sz( fd_vm_jit_t const * jit ) {
+  return jit->text_cnt ? jit->code_sz : 0UL;
+}
+
+ulong
+fd_vm_jit_image_sz( fd_vm_jit_t const * jit ) {
+  return fd_vm_jit_private_code_off( jit->text_cnt_max ) + fd_vm_jit_code_sz( jit );
+}
+
+/* Execution context **************************************************/
+
+/* fd_vm_jit_ctx_t is the state shared between the compiled code (which
+   addresses it through rbp) and the C helpers below.  region_lim gives
+   for each access type (load / store), access size (1,2,4,8) and
+   region the exclusive upper bound on the region offset of an access
+   that can be translated without calling fd_vm_mem_haddr (0 if all
+   accesses to the region must go through fd_vm_mem_haddr). */
+
+typedef struct fd_vm_jit_ctx fd_vm_jit_ctx_t;
+
+typedef ulong (*fd_vm_jit_haddr_fn_t  )( fd_vm_jit_ctx_t * ctx, ulong vaddr, ulong szw );
+typedef int   (*fd_vm_jit_syscall_fn_t)( fd_vm_jit_ctx_t * ctx, ulong imm );
+
+struct fd_vm_jit_ctx {
+  fd_vm_t *              vm;
+  ulong                  ick;        /* vm ic + cu invariant (changes only on syscalls) */
+  ulong                  frame_cnt;
+  ulong                  frame_bump; /* added to r10 on a call */
+  fd_vm_shadow_t *       shadow;
+  fd_vm_jit_pc_t const * pc_tbl;
+  ulong                  code;
+  fd_vm_jit_haddr_fn_t   haddr_fn;
+  fd_vm_jit_syscall_fn_t syscall_fn;
+  ulong                  region_haddr[ 8 ];
+  ulong                  region_lim  [ 2 ][ 4 ][ 8 ];
+};
+
+/* fd_vm_jit_ctx_refresh recomputes the inline translation tables from
+   vm.  This is needed whenever the memory map might have changed
+   (syscalls and input region resizes). */
+
+static void
+fd_vm_jit_ctx_refresh( fd_vm_jit_ctx_t * ctx ) {
+  fd_vm_t const * vm = ctx->vm;
+
+  ulong haddr[ 5 ];
+  ulong ld_sz[ 5 ];
+  ulong st_sz[ 5 ];
+  for( ulong r=0UL; r<4UL; r++ ) {
+    haddr[ r ] = vm->region_haddr[ r ];
+    ld_sz[ r ] = (ulong)vm->region_ld_sz[ r ];
+    st_sz[ r ] = (ulong)vm->region_st_sz[ r ];
+  }
+
+  /* Stack accesses need gap handling when frames are not contiguous */
+
+  if( FD_UNLIKELY( vm->stack_push_frame_count>1UL ) ) {
+    ld_sz[ FD_VM_STACK_REGION ] = 0UL;
+    st_sz[ FD_VM_STACK_REGION ] = 0UL;
+  }
+
+  /* The input region is inlined only when it consists of a single
+     memory region mapped at the start of the input region (the common
+     case without direct mapping).  Accesses beyond its current size
+     still go to fd_vm_mem_haddr such that resizing is handled. */
+
+  haddr[ FD_VM_INPUT_REGION ] = 0UL;
+  ld_sz[ FD_VM_INPUT_REGION ] = 0UL;
+  st_sz[ FD_VM_INPUT_REGION ] = 0UL;
+  if( FD_LIKELY( vm->input_mem_regions_cnt==1U && !vm->input_mem_regions[0].vaddr_offset ) ) {
+    fd_vm_input_region_t const * region = vm->input_mem_regions;
+    haddr[ FD_VM_INPUT_REGION ] = region->haddr;
+    ld_sz[ FD_VM_INPUT_REGION ] = (ulong)region->region_sz;
+    st_sz[ FD_VM_INPUT_REGION ] = region->is_writable ? (ulong)region->region_sz : 0UL;
+  }
+
+  for( ulong r=0UL; r<5UL; r++ ) {
+    ctx->region_haddr[ r ] = haddr[ r ];
+    for( ulong s=0UL; s<4UL; s++ ) {
+      ulong sz = 1UL<<s;
+      ctx->region_lim[ 0 ][ s ][ r ] = ld_sz[ r ]>=sz ? ld_sz[ r ]-sz+1UL : 0UL;
+      ctx->region_lim[ 1 ][ s ][ r ] = st_sz[ r ]>=sz ? st_sz[ r ]-sz+1UL : 0UL;
+    }
+  }
+}
+
+/* fd_vm_jit_haddr is the slow path of memory translation.  szw is the
+   access size with the write flag in bit 8.  Returns 0 if the access
+   faults. */
+
+static ulong
+fd_vm_jit_haddr( fd_vm_jit_ctx_t * ctx,
+                 ulong             vaddr,
+                 ulong             szw ) {
+  fd_vm_t * vm    = ctx->vm;
+  ulong     sz    = szw & 255UL;
+  uchar     write = (uchar)(szw>>8);
+  ulong     haddr = fd_vm_mem_haddr( vm, vaddr, sz, vm->region_haddr, write ? vm->region_st_sz : vm->region_ld_sz, write, 0UL );
+  if( FD_UNLIKELY( FD_VADDR_TO_REGION( vaddr )==FD_VM_INPUT_REGION ) ) fd_vm_jit_ctx_refresh( ctx ); /* might have resized */
+  return haddr;
+}
+
+/* fd_vm_jit_syscall does a syscall on behalf of the compiled code.  On
+   entry, the vm state has been flushed to vm as it would be at the
+   start of a linear run at the call instruction.  This mirrors
+   FD_VM_INTERP_SYSCALL_EXEC (including its error handling).  Returns
+   FD_VM_JIT_RESUME (without modifying vm) if imm is not a syscall, 0
+   on success and the error to halt with otherwise. */
+
+static int
+fd_vm_jit_syscall( fd_vm_jit_ctx_t * ctx,
+                   ulong             imm ) {
+  fd_vm_t * vm = ctx->vm;
+
+  fd_sbpf_syscalls_t const * syscall = fd_sbpf_syscalls_query_const( vm->syscalls, imm, NULL );
+  if( FD_UNLIKELY( !syscall ) ) return FD_VM_JIT_RESUME;
+
+  /* Bill the call (the run check guarantees cu>=1) */
+
+  ulong cu = vm->cu - 1UL;
+  vm->ic++;
+  vm->cu = cu;
+
+  if( FD_UNLIKELY( vm->dump_syscall_to_pb ) ) fd_vm_dump_syscall( vm, syscall->name );
+
+  ulong * reg = vm->reg;
+  ulong   ret[1];
+  int     err = syscall->func( vm, reg[1], reg[2], reg[3], reg[4], reg[5], ret );
+  reg[0] = ret[0];
+
+  cu = fd_ulong_min( vm->cu, cu );
+  if( FD_UNLIKELY( err ) ) {
+    if( err==FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED ) cu = 0UL;
+    vm->cu = cu;
+    FD_VM_TEST_ERR_EXISTS( vm );
+    return FD_VM_ERR_EBPF_SYSCALL_ERROR;
+  }
+
+  vm->cu   = cu;
+  ctx->ick = vm->ic + cu;
+  fd_vm_jit_ctx_refresh( ctx );
+  return 0;
+}
+
+/* x86-64 assembler ***************************************************/
+
+#define RAX (0UL)
+#define RCX (1UL)
+#define RDX (2UL)
+#define RBX (3UL)
+#define RSP (4UL)
+#define RBP (5UL)
+#define RSI (6UL)
+#define RDI (7UL)
+#define R8  (8UL)
+#define R9  (9UL)
+#define R10 (10UL)
+#define R11 (11UL)
+#define R12 (12UL)
+#define R13 (13UL)
+#define R14 (14UL)
+#define R15 (15UL)
+
+#define RM  R10 /* instruction meter */
+
+static uchar const fd_vm_jit_reg[ FD_VM_REG_CNT ] = { RAX, RDI, RSI, RDX, R8, R9, RBX, R12, R13, R14, R15 };
+
+#define CC_B  (0x2UL)
+#define CC_AE (0x3UL)
+#define CC_E  (0x4UL)
+#define CC_NE (0x5UL)
+#define CC_BE (0x6UL)
+#define CC_A  (0x7UL)
+#define CC_L  (0xcUL)
+#define CC_GE (0xdUL)
+#define CC_LE (0xeUL)
+#define CC_G  (0xfUL)
+
+struct fd_vm_jit_cstate {
+  uchar *                  code;
+  ulong                    sz;
+  ulong                    max;
+
+  fd_vm_jit_pc_t *         tbl;
+  ulong const *            text;
+  ulong                    text_cnt;
+  ulong                    text_off;
+  ulong                    entry_pc;
+  ulong const *            calldests;
+  fd_sbpf_syscalls_t const * syscalls; /* NULL if syscalls are static */
+  ulong                    sbpf_version;
+
+  fd_vm_jit_fixup_t *      fix;
+  ulong                    fix_cnt;
+  ulong                    fix_max;
+  fd_vm_jit_mstub_t *      mstub;
+  ulong                    mstub_cnt;
+  uint *                   exit_pos;
+
+  ulong                    lbl_epilogue;
+  ulong                    lbl_flush;
+  ulong                    lbl_reload;
+  ulong                    lbl_resume;
+  ulong                    lbl_halt;
+  ulong                    lbl_dispatch;
+};
+
+typedef struct fd_vm_jit_cstate fd_vm_jit_cstate_t;
+
+static inline void asm_u8 ( fd_vm_jit_cstate_t * c, ulong x ) { c->code[ c->sz++ ] = (uchar)x; }
+static inline void asm_u16( fd_vm_jit_cstate_t * c, ulong x ) { FD_STORE( ushort, c->code + c->sz, (ushort)x ); c->sz += 2UL; }
+static inline void asm_u32( fd_vm_jit_cstate_t * c, ulong x ) { FD_STORE( uint,   c->code + c->sz, (uint)x   ); c->sz += 4UL; }
+static inline void asm_u64( fd_vm_jit_cstate_t * c, ulong x ) { FD_STORE( ulong,  c->code + c->sz, x         ); c->sz += 8UL; }
+
+static inline void
+asm_rex( fd_vm_jit_cstate_t * c,
+         int                  w,
+         ulong                r,
+         ulong                x,
+         ulong                b,
+         int                  force ) {
+  ulong rex = 0x40UL | ((ulong)w<<3) | ((r>>3)<<2) | ((x>>3)<<1) | (b>>3);
+  if( rex!=0x40UL || force ) asm_u8( c, rex );
+}
+
+static inline void
+asm_op( fd_vm_jit_cstate_t * c,
+        ulong                op ) {
+  if( op>0xffUL ) asm_u8( c, op>>8 );
+  asm_u8( c, op & 0xffUL );
+}
+
+/* asm_rr emits op with a register direct modrm (reg is the modrm reg
+   field / opcode extension, rm the modrm rm register). */
+
+static inline void
+asm_rr( fd_vm_jit_cstate_t * c,
+        int                  w,
+        ulong                op,
+        ulong                reg,
+        ulong                rm ) {
+  asm_rex( c, w, reg, 0UL, rm, 0 );
+  asm_op ( c, op );
+  asm_u8 ( c, 0xc0UL | ((reg&7UL)<<3) | (rm&7UL) );
+}
+
+/* asm_rm emits op with a [base+disp] memory operand */
+
+static inline void
+asm_rm_x( fd_vm_jit_cstate_t * c,
+          int                  w,
+          ulong                op,
+          ulong                reg,
+          ulong                base,
+          long                 disp,
+          int                  force ) {
+  asm_rex( c, w, reg, 0UL, base, force );
+  asm_op ( c, op );
+  ulong mod = (!disp && (base&7UL)!=RBP) ? 0UL : (disp>=-128L && disp<=127L) ? 1UL : 2UL;
+  asm_u8( c, (mod<<6) | ((reg&7UL)<<3) | (base&7UL) );
+  if( (base&7UL)==RSP ) asm_u8( c, 0x24UL );
+  if     ( mod==1UL ) asm_u8 ( c, (ulong)disp );
+  else if( mod==2UL ) asm_u32( c, (ulong)disp );
+}
+
+static inline void
+asm_rm( fd_vm_jit_cstate_t * c,
+        int                  w,
+        ulong                op,
+        ulong                reg,
+        ulong                base,
+        long                 disp ) {
+  asm_rm_x( c, w, op, reg, base, disp, 0 );
+}
+
+/* asm_rmi emits op with a [base+index*(1<<scale_lg)+disp32] memory
+   operand */
+
+static inline void
+asm_rmi( fd_vm_jit_cstate_t * c,
+         int                  w,
+         ulong                op,
+         ulong                reg,
+         ulong                base,
+         ulong                index,
+         ulong                scale_lg,
+         long                 disp ) {
+  asm_rex( c, w, reg, index, base, 0 );
+  asm_op ( c, op );
+  asm_u8 ( c, 0x84UL | ((reg&7UL)<<3) );
+  asm_u8 ( c, (scale_lg<<6) | ((index&7UL)<<3) | (base&7UL) );
+  asm_u32( c, (ulong)disp );
+}
+
+/* Frequently used instructions */
+
+static inline void asm_mov_rr   ( fd_vm_jit_cstate_t * c, ulong d, ulong s ) { asm_rr( c, 1, 0x89UL, s, d ); }
+static inline void asm_mov_rr32 ( fd_vm_jit_cstate_t * c, ulong d, ulong s ) { asm_rr( c, 0, 0x89UL, s, d ); }
+static inline void asm_ld       ( fd_vm_jit_cstate_t * c, ulong d, ulong b, long disp ) { asm_rm( c, 1, 0x8bUL, d, b, disp ); }
+static inline void asm_st       ( fd_vm_jit_cstate_t * c, ulong b, long disp, ulong s ) { asm_rm( c, 1, 0x89UL, s, b, disp ); }
+static inline void asm_push     ( fd_vm_jit_cstate_t * c, ulong r ) { if( r>=8UL ) asm_u8( c, 0x41UL ); asm_u8( c, 0x50UL+(r&7UL) ); }
+static inline void asm_pop      ( fd_vm_jit_cstate_t * c, ulong r ) { if( r>=8UL ) asm_u8( c, 0x41UL ); asm_u8( c, 0x58UL+(r&7UL) ); }
+
+/* asm_alu_ri emits a group 1 (ext in [0,8)) op r, imm32 */
+
+static inline void
+asm_alu_ri( fd_vm_jit_cstate_t * c,
+            int                  w,
+            ulong                ext,
+            ulong                r,
+            ulong                imm ) {
+  asm_rr ( c, w, 0x81UL, ext, r );
+  asm_u32( c, imm );
+}
+
+static inline void
+asm_mov_ri32( fd_vm_jit_cstate_t * c, /* zero extends */
+              ulong                r,
+              ulong                imm ) {
+  asm_rex( c, 0, 0UL, 0UL, r, 0 );
+  asm_u8 ( c, 0xb8UL + (r&7UL) );
+  asm_u32( c, imm );
+}
+
+static inline void
+asm_mov_ri64( fd_vm_jit_cstate_t * c,
+              ulong                r,
+              ulong                imm ) {
+  if( imm<=(ulong)UINT_MAX ) { asm_mov_ri32( c, r, imm ); return; }
+  if( (ulong)(long)(int)imm==imm ) { asm_rr( c, 1, 0xc7UL, 0UL, r ); asm_u32( c, imm ); return; }
+  asm_rex( c, 1, 0UL, 0UL, r, 0 );
+  asm_u8 ( c, 0xb8UL + (r&7UL) );
+  asm_u64( c, imm );
+}
+
+/* asm_{add,sub}_ri adds/subtracts a small constant to a 64-bit reg */
+
+static inline void
+asm_add_ri( fd_vm_jit_cstate_t * c,
+            ulong                r,
+            long                 imm ) {
+  if( !imm ) return;
+  asm_alu_ri( c, 1, 0UL, r, (ulong)imm );
+}
+
+/* Labels and fixups */
+
+static inline ulong
+asm_jcc( fd_vm_jit_cstate_t * c,
+         ulong                cc ) {
+  asm_u8 ( c, 0x0fUL );
+  asm_u8 ( c, 0x80UL | cc );
+  ulong pos = c->sz;
+  asm_u32( c, 0UL );
+  return pos;
+}
+
+static inline ulong
+asm_jmp( fd_vm_jit_cstate_t * c ) {
+  asm_u8 ( c, 0xe9UL );
+  ulong pos = c->sz;
+  asm_u32( c, 0UL );
+  return pos;
+}
+
+static inline ulong
+asm_jcc8( fd_vm_jit_cstate_t * c,
+          ulong                cc ) {
+  asm_u8( c, 0x70UL | cc );
+  ulong pos = c->sz;
+  asm_u8( c, 0UL );
+  return pos;
+}
+
+static inline void
+asm_patch( fd_vm_jit_cstate_t * c,
+           ulong                pos,
+           ulong                target ) {
+  FD_STORE( int, c->code + pos, (int)((long)target - (long)(pos+4UL)) );
+}
+
+static inline void
+asm_patch8( fd_vm_jit_cstate_t * c,
+            ulong                pos,
+            ulong                target ) {
+  long rel = (long)target - (long)(pos+1UL);
+  FD_TEST( rel>=-128L && rel<=127L );
+  c->code[ pos ] = (uchar)rel;
+}
+
+static inline void
+asm_call_lbl( fd_vm_jit_cstate_t * c,
+              ulong                target ) {
+  asm_u8( c, 0xe8UL );
+  ulong pos = c->sz;
+  asm_u32( c, 0UL );
+  asm_patch( c, pos, target );
+}
+
+static inline void
+asm_jmp_lbl( fd_vm_jit_cstate_t * c,
+             ulong                target ) {
+  asm_patch( c, asm_jmp( c ), target );
+}
+
+static inline void
+asm_jcc_lbl( fd_vm_jit_cstate_t * c,
+             ulong                cc,
+             ulong                target ) {
+  asm_patch( c, asm_jcc( c, cc ), target );
+}
+
+static inline void
+fix_add( fd_vm_jit_cstate_t * c,
+         ulong                pos,
+         uint                 kind,
+         ulong                arg ) {
+  FD_TEST( c->fix_cnt<c->fix_max ); /* bounded by construction */
+  c->fix[ c->fix_cnt++ ] = (fd_vm_jit_fixup_t){ .pos = (uint)pos, .kind = kind, .arg = (uint)arg };
+}
+
+/* jcc_exit / jmp_exit jump to the exit stub of pc (which stops the
+   compiled code with the state at the start of pc) */
+
+static inline void jcc_exit( fd_vm_jit_cstate_t * c, ulong cc, ulong pc ) { fix_add( c, asm_jcc( c, cc ), FD_VM_JIT_FIX_EXIT, pc ); }
+static inline void jmp_exit( fd_vm_jit_cstate_t * c,           ulong pc ) { fix_add( c, asm_jmp( c     ), FD_VM_JIT_FIX_EXIT, pc ); }
+
+/* Runtime support routines *******************************************/
+
+#define CTX_OFF(f) ((long)offsetof(fd_vm_jit_ctx_t,f))
+#define VM_OFF(f)  ((long)offsetof(fd_vm_t,f))
+
+/* emit_runtime emits the entry point (at offset 0) and the shared
+   routines used by the compiled code. */
+
+static void
+emit_runtime( fd_vm_jit_cstate_t * c ) {
+
+  /* Entry: int entry( fd_vm_jit_ctx_t * ctx ) with the SysV ABI.  The
+     prologue keeps the stack 16 byte aligned for helper calls. */
+
+  static ulong const saved[6] = { RBX, RBP, R12, R13, R14, R15 };
+  for( ulong i=0UL; i<6UL; i++ ) asm_push( c, saved[i] );
+  asm_alu_ri( c, 1, 5UL, RSP, 8UL );                   /* sub rsp,8 */
+  asm_mov_rr( c, RBP, RDI );
+  ulong entry_call = c->sz; asm_call_lbl( c, 0UL );    /* call reload (patched below) */
+  asm_ld    ( c, R11, RBP, CTX_OFF( vm ) );
+  asm_ld    ( c, RCX, R11, VM_OFF( pc ) );
+  ulong entry_jmp = asm_jmp( c );                      /* jmp dispatch (patched below) */
+
+  /* epilogue: return eax */
+
+  c->lbl_epilogue = c->sz;
+  asm_alu_ri( c, 1, 0UL, RSP, 8UL );                   /* add rsp,8 */
+  for( ulong i=6UL; i; i-- ) asm_pop( c, saved[i-1UL] );
+  asm_u8( c, 0xc3UL );                                 /* ret */
+
+  /* flush: writes back the vm state for resuming at pc rcx with
+     budget RM.  Clobbers rcx and r11. */
+
+  c->lbl_flush = c->sz;
+  asm_ld( c, R11, RBP, CTX_OFF( vm ) );
+  asm_st( c, R11, VM_OFF( pc ), RCX );
+  asm_st( c, R11, VM_OFF( cu ), RM  );
+  asm_ld( c, RCX, RBP, CTX_OFF( ick ) );
+  asm_rr( c, 1, 0x29UL, RM, RCX );                     /* sub rcx,RM */
+  asm_st( c, R11, VM_OFF( ic ), RCX );
+  asm_ld( c, RCX, RBP, CTX_OFF( frame_cnt ) );
+  asm_st( c, R11, VM_OFF( frame_cnt ), RCX );
+  for( ulong i=0UL; i<FD_VM_REG_CNT; i++ ) asm_st( c, R11, VM_OFF( reg ) + 8L*(long)i, fd_vm_jit_reg[ i ] );
+  asm_u8( c, 0xc3UL );
+
+  /* reload: reads registers and the budget (into RM) from vm.
+     Clobbers r11. */
+
+  c->lbl_reload = c->sz;
+  asm_ld( c, R11, RBP, CTX_OFF( vm ) );
+  for( ulong i=0UL; i<FD_VM_REG_CNT; i++ ) asm_ld( c, fd_vm_jit_reg[ i ], R11, VM_OFF( reg ) + 8L*(long)i );
+  asm_ld( c, RM, R11, VM_OFF( cu ) );
+  asm_u8( c, 0xc3UL );
+  asm_patch( c, entry_call+1UL, c->lbl_reload );
+
+  /* resume: stop and have the interpreter continue at pc rcx with
+     budget RM */
+
+  c->lbl_resume = c->sz;
+  asm_call_lbl( c, c->lbl_flush );
+  asm_mov_ri32( c, RAX, (ulong)(uint)FD_VM_JIT_RESUME );
+  asm_jmp_lbl ( c, c->lbl_epilogue );
+
+  /* halt: normal program termination at the exit at pc rcx with
+     budget RM */
+
+  c->lbl_halt = c->sz;
+  asm_call_lbl( c, c->lbl_flush );
+  asm_rr      ( c, 0, 0x31UL, RAX, RAX );              /* xor eax,eax */
+  asm_jmp_lbl ( c, c->lbl_epilogue );
+
+  /* dispatch: continue at pc rcx with budget RM (any pc) */
+
+  c->lbl_dispatch = c->sz;
+  asm_patch( c, entry_jmp, c->lbl_dispatch );
+  asm_alu_ri( c, 1, 7UL, RCX, c->text_cnt );           /* cmp rcx,text_cnt */
+  asm_jcc_lbl( c, CC_AE, c->lbl_resume );
+  asm_mov_rr( c, R11, RCX );
+  asm_rr    ( c, 1, 0xc1UL, 4UL, R11 ); asm_u8( c, 4UL ); /* shl r11,4 */
+  asm_rm    ( c, 1, 0x03UL, R11, RBP, CTX_OFF( pc_tbl ) ); /* add r11,[pc_tbl] */
+  asm_rm    ( c, 0, 0x8bUL, RCX, R11, 0L );              /* mov ecx,[r11+idx] */
+  asm_rr    ( c, 1, 0x01UL, RCX, RM );                   /* add RM,rcx */
+  asm_rm    ( c, 0, 0x8bUL, RCX, R11, 4L );              /* mov ecx,[r11+run_end] */
+  asm_rr    ( c, 1, 0x39UL, RCX, RM );                   /* cmp RM,rcx */
+  ulong short_run = asm_jcc8( c, CC_B );
+  asm_rm    ( c, 0, 0x8bUL, RCX, R11, 8L );              /* mov ecx,[r11+code_off] */
+  asm_rm    ( c, 1, 0x03UL, RCX, RBP, CTX_OFF( code ) ); /* add rcx,[code] */
+  asm_rr    ( c, 0, 0xffUL, 4UL, RCX );                  /* jmp rcx */
+  asm_patch8( c, short_run, c->sz );
+  asm_rm    ( c, 0, 0x8bUL, RCX, R11, 0L );              /* mov ecx,[r11+idx] */
+  asm_rr    ( c, 1, 0x29UL, RCX, RM );                   /* sub RM,rcx */
+  asm_rm    ( c, 1, 0x2bUL, R11, RBP, CTX_OFF( pc_tbl ) ); /* sub r11,[pc_tbl] */
+  asm_rr    ( c, 1, 0xc1UL, 5UL, R11 ); asm_u8( c, 4UL ); /* shr r11,4 */
+  asm_mov_rr( c, RCX, R11 );
+  asm_jmp_lbl( c, c->lbl_resume );
+}
+
+/* Instruction selection **********************************************/
+
+/* fd_vm_jit_decode maps an opcode to the interpreter label that
+   executes it for the given sBPF version (mirrors
+   fd_vm_interp_jump_table.c).  Returns the opcode, the opcode with one
+   of the flags below set, or FD_VM_JIT_OP_SIGILL. */
+
+#define FD_VM_JIT_OP_DEPR   (0x100UL)
+#define FD_VM_JIT_OP_JMP32  (0x200UL)
+#define FD_VM_JIT_OP_STATIC (0x400UL)
+#define FD_VM_JIT_OP_SIGILL (0x800UL)
+
+FD_FN_CONST static ulong
+fd_vm_jit_decode( ulong opcode,
+                  ulong v ) {
+  int move  = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( v );
+  int pqr   = FD_VM_SBPF_ENABLE_PQR( v );
+  int jmp32 = FD_VM_SBPF_ENABLE_JMP32( v );
+  switch( opcode ) {
+  case 0x05: case 0x07: case 0x0f: case 0x15: case 0x1d: case 0x1f: case 0x25: case 0x2d: case 0x35: case 0x3d:
+  case 0x44: case 0x45: case 0x47: case 0x4c: case 0x4d: case 0x4f: case 0x54: case 0x55: case 0x57: case 0x5c:
+  case 0x5d: case 0x5f: case 0x64: case 0x65: case 0x67: case 0x6c: case 0x6d: case 0x6f: case 0x74: case 0x75:
+  case 0x77: case 0x7c: case 0x7d: case 0x7f: case 0x8d: case 0x95: case 0xa4: case 0xa5: case 0xa7: case 0xac:
+  case 0xad: case 0xaf: case 0xb4: case 0xb5: case 0xb7: case 0xbd: case 0xbf: case 0xc4: case 0xc5: case 0xc7:
+  case 0xcc: case 0xcd: case 0xcf: case 0xd5: case 0xdc: case 0xdd:
+    return opcode;
+  case 0x04: case 0x0c: case 0x1c: case 0xbc:
+    return FD_VM_SBPF_EXPLICIT_SIGN_EXTENSION_OF_RESULTS( v ) ? opcode : (opcode | FD_VM_JIT_OP_DEPR);
+  case 0x14: case 0x17:
+    return FD_VM_SBPF_SWAP_SUB_REG_IMM_OPERANDS( v ) ? opcode : (opcode | FD_VM_JIT_OP_DEPR);
+  case 0x18: return FD_VM_SBPF_DISABLE_LDDW( v ) ? FD_VM_JIT_OP_SIGILL : opcode;
+  case 0xf7: return FD_VM_SBPF_DISABLE_LDDW( v ) ? opcode : FD_VM_JIT_OP_SIGILL;
+  case 0xd4: return FD_VM_SBPF_DISABLE_LE  ( v ) ? FD_VM_JIT_OP_SIGILL : opcode;
+  case 0x84: return FD_VM_SBPF_DISABLE_NEG ( v ) ? FD_VM_JIT_OP_SIGILL : opcode;
+  case 0x85: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? (opcode | FD_VM_JIT_OP_STATIC) : opcode;
+  case 0x24: case 0x34: case 0x94:
+    return pqr ? FD_VM_JIT_OP_SIGILL : opcode;
+  case 0x86: case 0x8e: case 0x96: case 0x9e: case 0xe6: case 0xee: case 0xf6: case 0xfe:
+    return pqr ? opcode : FD_VM_JIT_OP_SIGILL;
+  case 0x36: case 0x3e: case 0x46: case 0x4e: case 0x56: case 0x5e: case 0x66: case 0x6e:
+  case 0x76: case 0x7e: case 0xb6: case 0xbe: case 0xc6: case 0xce: case 0xd6: case 0xde:
+    return jmp32 ? (opcode | FD_VM_JIT_OP_JMP32) : pqr ? opcode : FD_VM_JIT_OP_SIGILL;
+  case 0x16: case 0x1e: case 0x26: case 0x2e: case 0xa6: case 0xae:
+    return jmp32 ? (opcode | FD_VM_JIT_OP_JMP32) : FD_VM_JIT_OP_SIGILL;
+  case 0x61: return move ? FD_VM_JIT_OP_SIGILL : 0x8cUL;
+  case 0x62: return move ? FD_VM_JIT_OP_SIGILL : 0x87UL;
+  case 0x63: return move ? FD_VM_JIT_OP_SIGILL : 0x8fUL;
+  case 0x69: return move ? FD_VM_JIT_OP_SIGILL : 0x3cUL;
+  case 0x6a: return move ? FD_VM_JIT_OP_SIGILL : 0x37UL;
+  case 0x6b: return move ? FD_VM_JIT_OP_SIGILL : 0x3fUL;
+  case 0x71: return move ? FD_VM_JIT_OP_SIGILL : 0x2cUL;
+  case 0x72: return move ? FD_VM_JIT_OP_SIGILL : 0x27UL;
+  case 0x73: return move ? FD_VM_JIT_OP_SIGILL : 0x2fUL;
+  case 0x79: return move ? FD_VM_JIT_OP_SIGILL : 0x9cUL;
+  case 0x7a: return move ? FD_VM_JIT_OP_SIGILL : 0x97UL;
+  case 0x7b: return move ? FD_VM_JIT_OP_SIGILL : 0x9fUL;
+  case 0x8c: case 0x8f:
+    return move ? opcode : FD_VM_JIT_OP_SIGILL;
+  case 0x27: case 0x2c: case 0x2f: case 0x37: case 0x3c: case 0x3f: case 0x87: case 0x97: case 0x9c: case 0x9f:
+    return move ? opcode : (opcode | FD_VM_JIT_OP_DEPR);
+  default:
+    return FD_VM_JIT_OP_SIGILL;
+  }
+}
+
+FD_FN_CONST static inline int
+fd_vm_jit_op_is_branch( ulong op ) {
+  if( op & FD_VM_JIT_OP_SIGILL ) return 0;
+  if( op & FD_VM_JIT_OP_JMP32  ) return 1;
+  return (op & 7UL)==5UL; /* JA, Jcc, CALL_IMM, CALL_REG, EXIT */
+}
+
+/* fd_vm_jit_private_cc returns the x86 condition code for a sBPF
+   conditional jump (opcode>>4).  JSET uses test, others cmp. */
+
+FD_FN_CONST static inline ulong
+fd_vm_jit_private_cc( ulong opcode ) {
+  switch( opcode>>4 ) {
+  case 0x1: return CC_E;
+  case 0x2: return CC_A;
+  case 0x3: return CC_AE;
+  case 0x4: return CC_NE; /* JSET */
+  case 0x5: return CC_NE;
+  case 0x6: return CC_G;
+  case 0x7: return CC_GE;
+  case 0xa: return CC_B;
+  case 0xb: return CC_BE;
+  case 0xc: return CC_L;
+  case 0xd: return CC_LE;
+  default:  return CC_E; /* not reached */
+  }
+}
+
+/* emit_goto emits the transfer of control from the branch at pc to
+   the start of a new linear run at t (given as a long as t might be
+   out of bounds).  fall is 1 if the code for t will be emitted right
+   after. */
+
+static void
+emit_goto( fd_vm_jit_cstate_t * c,
+           ulong                pc,
+           long                 t,
+           int                  fall ) {
+  long pc_idx = (long)c->tbl[ pc ].idx;
+
+  if( FD_UNLIKELY( t<0L || (ulong)t>c->text_cnt ) ) {
+
+    /* Resume at the out of bounds pc (the interpreter will fault with
+       exactly the same billing) */
+
+    asm_add_ri  ( c, RM, -(pc_idx+1L) );
+    asm_mov_ri64( c, RCX, (ulong)t );
+    asm_jmp_lbl ( c, c->lbl_resume );
+    return;
+  }
+
+  fd_vm_jit_pc_t const * e = c->tbl + t;
+  asm_add_ri( c, RM, (long)e->idx - pc_idx - 1L );
+  if( (ulong)t==c->text_cnt || (e->flags & FD_VM_JIT_PC_FLAG_ADDL) ) {
+    jmp_exit( c, (ulong)t );
+    return;
+  }
+  asm_alu_ri( c, 1, 7UL, RM, (ulong)e->run_end );      /* cmp RM,run_end */
+  jcc_exit  ( c, CC_B, (ulong)t );
+  if( !fall ) fix_add( c, asm_jmp( c ), FD_VM_JIT_FIX_PC, (ulong)t );
+}
+
+/* emit_push_frame emits FD_VM_INTERP_STACK_PUSH for the call at pc
+   (the caller has already checked the call depth).  Clobbers rcx and
+   r11. */
+
+static void
+emit_push_frame( fd_vm_jit_cstate_t * c,
+                 ulong                pc ) {
+  asm_ld ( c, RCX, RBP, CTX_OFF( frame_cnt ) );
+  asm_rmi( c, 1, 0x8dUL, R11, RCX, RCX, 1UL, 0L );               /* lea r11,[rcx+rcx*2] */
+  asm_rr ( c, 1, 0xc1UL, 4UL, R11 ); asm_u8( c, 4UL );            /* shl r11,4 */
+  asm_rm ( c, 1, 0x03UL, R11, RBP, CTX_OFF( shadow ) );           /* add r11,[shadow] */
+  asm_st ( c, R11, (long)offsetof( fd_vm_shadow_t, r6  ), RBX );
+  asm_st ( c, R11, (long)offsetof( fd_vm_shadow_t, r7  ), R12 );
+  asm_st ( c, R11, (long)offsetof( fd_vm_shadow_t, r8  ), R13 );
+  asm_st ( c, R11, (long)offsetof( fd_vm_shadow_t, r9  ), R14 );
+  asm_st ( c, R11, (long)offsetof( fd_vm_shadow_t, r10 ), R15 );
+  asm_rm ( c, 1, 0xc7UL, 0UL, R11, (long)offsetof( fd_vm_shadow_t, pc ) ); asm_u32( c, pc );
+  asm_rr ( c, 1, 0xffUL, 0UL, RCX );                               /* inc rcx */
+  asm_st ( c, RBP, CTX_OFF( frame_cnt ), RCX );
+  asm_rm ( c, 1, 0x03UL, R15, RBP, CTX_OFF( frame_bump ) );       /* add r15,[frame_bump] */
+}
+
+/* emit_depth_check exits at pc if a call at pc would exceed the call
+   depth limit */
+
+static void
+emit_depth_check( fd_vm_jit_cstate_t * c,
+                  ulong                pc ) {
+  asm_rm( c, 1, 0x83UL, 7UL, RBP, CTX_OFF( frame_cnt ) ); asm_u8( c, FD_VM_STACK_FRAME_MAX-1UL ); /* cmp [frame_cnt],max-1 */
+  jcc_exit( c, CC_AE, pc );
+}
+
+/* emit_syscall emits a call to the syscall imm at pc */
+
+static void
+emit_syscall( fd_vm_jit_cstate_t * c,
+              ulong                pc,
+              ulong                imm ) {
+  asm_add_ri  ( c, RM, -(long)c->tbl[ pc ].idx );
+  asm_mov_ri32( c, RCX, pc );
+  asm_call_lbl( c, c->lbl_flush );
+  asm_mov_rr  ( c, RDI, RBP );
+  asm_mov_ri32( c, RSI, imm );
+  asm_rm      ( c, 0, 0xffUL, 2UL, RBP, CTX_OFF( syscall_fn ) ); /* call [syscall_fn] */
+  asm_rr      ( c, 0, 0x85UL, RAX, RAX );                        /* test eax,eax */
+  asm_jcc_lbl ( c, CC_NE, c->lbl_epilogue );
+  asm_call_lbl( c, c->lbl_reload );
+  asm_add_ri  ( c, RM, (long)c->tbl[ pc ].idx + 1L );
+  emit_goto   ( c, pc, (long)pc+1L, 1 );
+}
+
+/* emit_mem_translate emits the address translation of a load or
+   store at pc of sz=1<<lg_sz bytes at reg[ base ]+off.  The fast path
+   translates accesses to regions inlined in the ctx tables, anything
+   else (including faults) goes through an out-of-line stub calling
+   fd_vm_jit_haddr.  On return r11 holds the host address. */
+
+static void
+emit_mem_translate( fd_vm_jit_cstate_t * c,
+                    ulong                pc,
+                    ulong                base,
+                    long                 off,
+                    ulong                lg_sz,
+                    int                  write ) {
+  ulong stub = c->mstub_cnt++;
+  asm_rm    ( c, 1, 0x8dUL, R11, fd_vm_jit_reg[ base ], off );  /* lea r11,[base+off] */
+  asm_mov_rr( c, RCX, R11 );
+  asm_rr    ( c, 1, 0xc1UL, 5UL, RCX ); asm_u8( c, 32UL );      /* shr rcx,32 */
+  asm_alu_ri( c, 1, 7UL, RCX, FD_VM_INPUT_REGION );             /* cmp rcx,4 */
+  fix_add   ( c, asm_jcc( c, CC_A ), FD_VM_JIT_FIX_MEM, stub );
+  asm_mov_rr32( c, R11, R11 );                                  /* mov r11d,r11d */
+  asm_rmi   ( c, 1, 0x3bUL, R11, RBP, RCX, 3UL, CTX_OFF( region_lim[ write ][ lg_sz ] ) );
+  fix_add   ( c, asm_jcc( c, CC_AE ), FD_VM_JIT_FIX_MEM, stub );
+  asm_rmi   ( c, 1, 0x03UL, R11, RBP, RCX, 3UL, CTX_OFF( region_haddr ) );
+  c->mstub[ stub ] = (fd_vm_jit_mstub_t){
+    .pc = (uint)pc, .ret = (uint)c->sz, .off = (int)off, .base = (uchar)base, .sz = (uchar)(1UL<<lg_sz), .write = (uchar)write
+  };
+}
+
+static void
+emit_mem_stub( fd_vm_jit_cstate_t *      c,
+               fd_vm_jit_mstub_t const * s ) {
+  static ulong const saved[7] = { RAX, RDI, RSI, RDX, R8, R9, R10 };
+  asm_rm( c, 1, 0x8dUL, R11, fd_vm_jit_reg[ s->base ], (long)s->off );
+  for( ulong i=0UL; i<7UL; i++ ) asm_push( c, saved[i] );
+  asm_alu_ri  ( c, 1, 5UL, RSP, 8UL );
+  asm_mov_rr  ( c, RDI, RBP );
+  asm_mov_rr  ( c, RSI, R11 );
+  asm_mov_ri32( c, RDX, (ulong)s->sz | ((ulong)s->write<<8) );
+  asm_rm      ( c, 0, 0xffUL, 2UL, RBP, CTX_OFF( haddr_fn ) );  /* call [haddr_fn] */
+  asm_mov_rr  ( c, R11, RAX );
+  asm_alu_ri  ( c, 1, 0UL, RSP, 8UL );
+  for( ulong i=7UL; i; i-- ) asm_pop( c, saved[i-1UL] );
+  asm_rr      ( c, 1, 0x85UL, R11, R11 );                       /* test r11,r11 */
+  jcc_exit    ( c, CC_E, s->pc );
+  asm_jmp_lbl ( c, s->ret );
+}
+
+/* emit_muldiv emits the ops that need rax/rdx.  kind is F7 opcode
+   extension (4 mul, 5 imul, 6 div, 7 idiv).  rcx holds the other
+   operand.  If hi, the result is taken from rdx (remainder or high
+   half), otherwise from rax. */
+
+static void
+emit_muldiv( fd_vm_jit_cstate_t * c,
+             ulong                d,
+             int                  w,
+             ulong                kind,
+             int                  hi ) {
+  ulong xd = fd_vm_jit_reg[ d ];
+  asm_mov_rr( c, R11, xd );
+  asm_push  ( c, RAX );
+  asm_push  ( c, RDX );
+  asm_mov_rr( c, RAX, R11 );
+  if     ( kind==6UL ) asm_rr( c, 0, 0x31UL, RDX, RDX );            /* xor edx,edx */
+  else if( kind==7UL ) { if( w ) asm_u8( c, 0x48UL ); asm_u8( c, 0x99UL ); } /* cqo / cdq */
+  asm_rr( c, w, 0xf7UL, kind, RCX );
+  if( w ) asm_mov_rr  ( c, R11, hi ? RDX : RAX );
+  else    asm_mov_rr32( c, R11, hi ? RDX : RAX );
+  asm_pop   ( c, RDX );
+  asm_pop   ( c, RAX );
+  asm_mov_rr( c, xd, R11 );
+}
+
+/* emit_div emits a division / remainder.  The divisor is in rcx.
+   Division by zero and overflow exit (the interpreter reproduces the
+   fault). */
+
+static void
+emit_div( fd_vm_jit_cstate_t * c,
+          ulong                pc,
+          ulong                d,
+          int                  w,
+          int                  sign,
+          int                  rem,
+          int                  check_zero,
+          int                  check_ovfl ) {
+  ulong xd = fd_vm_jit_reg[ d ];
+  if( check_zero ) {
+    asm_rr  ( c, w, 0x85UL, RCX, RCX );                          /* test rcx,rcx */
+    jcc_exit( c, CC_E, pc );
+  }
+  if( check_ovfl ) {
+    asm_rr( c, w, 0x83UL, 7UL, RCX ); asm_u8( c, 0xffUL );       /* cmp rcx,-1 */
+    ulong skip = asm_jcc8( c, CC_NE );
+    if( w ) { asm_mov_ri64( c, R11, (ulong)LONG_MIN ); asm_rr( c, 1, 0x39UL, R11, xd ); }
+    else    { asm_alu_ri( c, 0, 7UL, xd, 0x80000000UL ); }
+    jcc_exit( c, CC_E, pc );
+    asm_patch8( c, skip, c->sz );
+  }
+  emit_muldiv( c, d, w, sign ? 7UL : 6UL, rem );
+}
+
+/* emit_instr emits the code for the instruction at pc */
+
+static void
+emit_instr( fd_vm_jit_cstate_t * c,
+            ulong                pc ) {
+  ulong instr  = c->text[ pc ];
+  ulong op     = fd_vm_jit_decode( fd_vm_instr_opcode( instr ), c->sbpf_version );
+  ulong dst    = fd_vm_instr_dst   ( instr );
+  ulong src    = fd_vm_instr_src   ( instr );
+  long  off    = (long)fd_vm_instr_offset( instr );
+  ulong imm    = (ulong)fd_vm_instr_imm( instr );
+  ulong simm   = (ulong)(long)(int)(uint)imm; /* sign extended imm */
+
+  if( FD_UNLIKELY( op & FD_VM_JIT_OP_SIGILL ) ) { jmp_exit( c, pc ); return; }
+
+  /* Register operands in [11,16) are left to the interpreter.  The
+     cases below that do not use dst (or src) return early. */
+
+  ulong opcode = op & 0xffUL;
+  int   is_jmp = fd_vm_jit_op_is_branch( op );
+
+  switch( op ) {
+  case 0x05: /* JA */
+    emit_goto( c, pc, (long)pc + off + 1L, 0 );
+    return;
+
+  case 0x85: { /* CALL_IMM */
+    /* Like the interpreter, a key in the syscall map is a syscall
+       even if it would also resolve to a local call */
+    int   is_syscall = c->syscalls && imm!=fd_sbpf_syscalls_key_null() && !!fd_sbpf_syscalls_query_const( c->syscalls, imm, NULL );
+    ulong target     = ULONG_MAX;
+    if( is_syscall ) {
+      /* dispatched through the vm's syscall map */
+    } else if( imm==0x71e3cf81UL ) {
+      target = c->entry_pc;
+    } else {
+      ulong t = (ulong)fd_pchash_inverse( (uint)imm );
+      if( t<c->text_cnt && c->calldests && fd_sbpf_calldests_test( c->calldests, t ) ) target = t;
+    }
+    if( target==ULONG_MAX ) { emit_syscall( c, pc, imm ); return; } /* exits if not a syscall */
+    emit_depth_check( c, pc );
+    emit_push_frame ( c, pc );
+    emit_goto       ( c, pc, (long)target, 0 );
+    return;
+  }
+
+  case 0x85 | FD_VM_JIT_OP_STATIC: /* CALL_IMM (static syscalls) */
+    if( src==0UL ) { emit_syscall( c, pc, imm ); return; }
+    if( src==1UL ) {
+      long t = (long)pc + (long)(int)(uint)imm + 1L;
+      if( t<0L || (ulong)t>=c->text_cnt ) { jmp_exit( c, pc ); return; }
+      emit_depth_check( c, pc );
+      emit_push_frame ( c, pc );
+      emit_goto       ( c, pc, t, 0 );
+      return;
+    }
+    jmp_exit( c, pc );
+    return;
+
+  case 0x8d: { /* CALL_REG */
+    ulong r; int post_push;
+    if     ( fd_sbpf_callx_uses_src_reg_enabled( c->sbpf_version ) ) { r = src;        post_push = 0; }
+    else if( fd_sbpf_callx_uses_dst_reg_enabled( c->sbpf_version ) ) { r = dst;        post_push = 1; }
+    else                                                             { r = imm & 15UL; post_push = 1; }
+    if( r>=FD_VM_REG_CNT ) { jmp_exit( c, pc ); return; }
+    asm_mov_rr( c, RCX, fd_vm_jit_reg[ r ] );
+    if( post_push && r==10UL ) asm_rm( c, 1, 0x03UL, RCX, RBP, CTX_OFF( frame_bump ) ); /* reg[10] after push */
+    asm_mov_rr  ( c, R11, RCX );
+    asm_rr      ( c, 1, 0xc1UL, 5UL, R11 ); asm_u8( c, 32UL );    /* shr r11,32 */
+    asm_alu_ri  ( c, 1, 7UL, R11, 1UL );                          /* cmp r11,1 */
+    jcc_exit    ( c, CC_NE, pc );
+    asm_mov_rr32( c, RCX, RCX );
+    asm_mov_ri64( c, R11, c->text_off );
+    asm_rr      ( c, 1, 0x29UL, R11, RCX );                       /* sub rcx,r11 */
+    asm_rr      ( c, 1, 0xc1UL, 5UL, RCX ); asm_u8( c, 3UL );     /* shr rcx,3 */
+    asm_alu_ri  ( c, 1, 7UL, RCX, c->text_cnt );
+    jcc_exit    ( c, CC_AE, pc );
+    emit_depth_check( c, pc );
+    asm_push    ( c, RCX );
+    emit_push_frame( c, pc );
+    asm_pop     ( c, RCX );
+    asm_add_ri  ( c, RM, -(long)c->tbl[ pc ].idx - 1L );
+    asm_jmp_lbl ( c, c->lbl_dispatch );
+    return;
+  }
+
+  case 0x95: { /* EXIT */
+    asm_ld( c, RCX, RBP, CTX_OFF( frame_cnt ) );
+    asm_rr( c, 1, 0x85UL, RCX, RCX );
+    ulong ret = asm_jcc8( c, CC_NE );
+    asm_add_ri  ( c, RM, -(long)c->tbl[ pc ].idx - 1L );
+    asm_mov_ri32( c, RCX, pc );
+    asm_jmp_lbl ( c, c->lbl_halt );
+    asm_patch8  ( c, ret, c->sz );
+    asm_rr ( c, 1, 0xffUL, 1UL, RCX );                            /* dec rcx */
+    asm_st ( c, RBP, CTX_OFF( frame_cnt ), RCX );
+    asm_rmi( c, 1, 0x8dUL, R11, RCX, RCX, 1UL, 0L );              /* lea r11,[rcx+rcx*2] */
+    asm_rr ( c, 1, 0xc1UL, 4UL, R11 ); asm_u8( c, 4UL );          /* shl r11,4 */
+    asm_rm ( c, 1, 0x03UL, R11, RBP, CTX_OFF( shadow ) );
+    asm_ld ( c, RBX, R11, (long)offsetof( fd_vm_shadow_t, r6  ) );
+    asm_ld ( c, R12, R11, (long)offsetof( fd_vm_shadow_t, r7  ) );
+    asm_ld ( c, R13, R11, (long)offsetof( fd_vm_shadow_t, r8  ) );
+    asm_ld ( c, R14, R11, (long)offsetof( fd_vm_shadow_t, r9  ) );
+    asm_ld ( c, R15, R11, (long)offsetof( fd_vm_shadow_t, r10 ) );
+    asm_ld ( c, RCX, R11, (long)offsetof( fd_vm_shadow_t, pc  ) );
+    asm_rr ( c, 1, 0xffUL, 0UL, RCX );                            /* inc rcx */
+    asm_add_ri ( c, RM, -(long)c->tbl[ pc ].idx - 1L );
+    asm_jmp_lbl( c, c->lbl_dispatch );
+    return;
+  }
+
+  default: break;
+  }
+
+  if( is_jmp ) { /* Conditional jumps */
+    if( dst>=FD_VM_REG_CNT ) { jmp_exit( c, pc ); return; }
+    int   w      = !(op & FD_VM_JIT_OP_JMP32);
+    int   is_reg = !!(opcode & 0x08UL);
+    ulong cc     = fd_vm_jit_private_cc( opcode );
+    int   is_set = (opcode>>4)==0x4UL;
+    ulong xd     = fd_vm_jit_reg[ dst ];
+    if( is_reg ) {
+      if( src>=FD_VM_REG_CNT ) { jmp_exit( c, pc ); return; }
+      asm_rr( c, w, is_set ? 0x85UL : 0x39UL, fd_vm_jit_reg[ src ], xd );
+    } else {
+      if( is_set ) { asm_rr( c, w, 0xf7UL, 0UL, xd ); asm_u32( c, imm ); }
+      else         asm_alu_ri( c, w, 7UL, xd, imm );
+    }
+    ulong fall = asm_jcc( c, cc ^ 1UL );
+    emit_goto( c, pc, (long)pc + off + 1L, 0 );
+    asm_patch( c, fall, c->sz );
+    emit_goto( c, pc, (long)pc + 1L, 1 );
+    return;
+  }
+
+  if( dst>=FD_VM_REG_CNT ) { jmp_exit( c, pc ); return; }
+  ulong xd = fd_vm_jit_reg[ dst ];
+
+  /* Immediate operand instructions */
+
+  switch( op ) {
+  case 0x04:                      asm_alu_ri( c, 0, 0UL, xd, imm ); return;                                 /* ADD_IMM */
+  case 0x04 | FD_VM_JIT_OP_DEPR:  asm_alu_ri( c, 0, 0UL, xd, imm ); asm_rr( c, 1, 0x63UL, xd, xd ); return;
+  case 0x07:                      asm_alu_ri( c, 1, 0UL, xd, imm ); return;                                 /* ADD64_IMM */
+  case 0x14:                      asm_rr( c, 0, 0xf7UL, 3UL, xd ); asm_alu_ri( c, 0, 0UL, xd, imm ); return; /* SUB_IMM */
+  case 0x14 | FD_VM_JIT_OP_DEPR:  asm_alu_ri( c, 0, 5UL, xd, imm ); asm_rr( c, 1, 0x63UL, xd, xd ); return;
+  case 0x17:                      asm_rr( c, 1, 0xf7UL, 3UL, xd ); asm_alu_ri( c, 1, 0UL, xd, imm ); return; /* SUB64_IMM */
+  case 0x17 | FD_VM_JIT_OP_DEPR:  asm_alu_ri( c, 1, 5UL, xd, imm ); return;
+  case 0x18: {                                                                                                  /* LDDW */
+    ulong hi = (ulong)fd_vm_instr_imm( c->text[ pc+1UL ] );
+    asm_mov_ri64( c, xd, imm | (hi<<32) );
+    return;
+  }
+  case 0x24:                      asm_rr( c, 0, 0x69UL, xd, xd ); asm_u32( c, imm ); asm_rr( c, 1, 0x63UL, xd, xd ); return; /* MUL_IMM */
+  case 0x27 | FD_VM_JIT_OP_DEPR:                                                                               /* MUL64_IMM */
+  case 0x96:                      asm_rr( c, 1, 0x69UL, xd, xd ); asm_u32( c, imm ); return;                   /* LMUL64_IMM */
+  case 0x86:                      asm_rr( c, 0, 0x69UL, xd, xd ); asm_u32( c, imm ); return;                   /* LMUL32_IMM */
+  case 0x34: case 0x46: case 0x94: case 0x66:                                                                  /* DIV_IMM UDIV32_IMM MOD_IMM UREM32_IMM */
+    if( !(uint)imm ) { jmp_exit( c, pc ); return; }
+    asm_mov_ri32( c, RCX, imm );
+    emit_div( c, pc, dst, 0, 0, opcode==0x94UL || opcode==0x66UL, 0, 0 );
+    return;
+  case 0x56: case 0x76:                                                                                        /* UDIV64_IMM UREM64_IMM */
+    if( !imm ) { jmp_exit( c, pc ); return; }
+    asm_mov_ri32( c, RCX, imm );
+    emit_div( c, pc, dst, 1, 0, opcode==0x76UL, 0, 0 );
+    return;
+  case 0x37 | FD_VM_JIT_OP_DEPR: case 0x97 | FD_VM_JIT_OP_DEPR:                                                  /* DIV64_IMM MOD64_IMM */
+    if( !imm ) { jmp_exit( c, pc ); return; }
+    asm_mov_ri64( c, RCX, simm );
+    emit_div( c, pc, dst, 1, 0, opcode==0x97UL, 0, 0 );
+    return;
+  case 0xc6: case 0xe6:                                                                                        /* SDIV32_IMM SREM32_IMM */
+    if( !imm ) { jmp_exit( c, pc ); return; }
+    asm_mov_ri32( c, RCX, imm );
+    emit_div( c, pc, dst, 0, 1, opcode==0xe6UL, 0, (uint)imm==UINT_MAX );
+    return;
+  case 0xd6: case 0xf6:                                                                                        /* SDIV64_IMM SREM64_IMM */
+    if( !imm ) { jmp_exit( c, pc ); return; }
+    asm_mov_ri64( c, RCX, simm );
+    emit_div( c, pc, dst, 1, 1, opcode==0xf6UL, 0, (uint)imm==UINT_MAX );
+    return;
+  case 0x36:                                                                                                   /* UHMUL64_IMM */
+    asm_mov_ri32( c, RCX, imm );
+    emit_muldiv( c, dst, 1, 4UL, 1 );
+    return;
+  case 0xb6:                                                                                                   /* SHMUL64_IMM */
+    asm_mov_ri64( c, RCX, simm );
+    emit_muldiv( c, dst, 1, 5UL, 1 );
+    return;
+  case 0x44:                      asm_alu_ri( c, 0, 1UL, xd, imm ); return;                                   /* OR_IMM */
+  case 0x47:                      asm_alu_ri( c, 1, 1UL, xd, imm ); return;                                   /* OR64_IMM */
+  case 0x54:                      asm_alu_ri( c, 0, 4UL, xd, imm ); return;                                   /* AND_IMM */
+  case 0x57:                      asm_alu_ri( c, 1, 4UL, xd, imm ); return;                                   /* AND64_IMM */
+  case 0xa4:                      asm_alu_ri( c, 0, 6UL, xd, imm ); return;                                   /* XOR_IMM */
+  case 0xa7:                      asm_alu_ri( c, 1, 6UL, xd, imm ); return;                                   /* XOR64_IMM */
+  case 0x64:                      asm_rr( c, 0, 0xc1UL, 4UL, xd ); asm_u8( c, imm & 31UL ); return;           /* LSH_IMM */
+  case 0x67:                      asm_rr( c, 1, 0xc1UL, 4UL, xd ); asm_u8( c, imm & 63UL ); return;           /* LSH64_IMM */
+  case 0x74:                      asm_rr( c, 0, 0xc1UL, 5UL, xd ); asm_u8( c, imm & 31UL ); return;           /* RSH_IMM */
+  case 0x77:                      asm_rr( c, 1, 0xc1UL, 5UL, xd ); asm_u8( c, imm & 63UL ); return;           /* RSH64_IMM */
+  case 0xc4:                      asm_rr( c, 0, 0xc1UL, 7UL, xd ); asm_u8( c, imm & 31UL ); return;           /* ARSH_IMM */
+  case 0xc7:                      asm_rr( c, 1, 0xc1UL, 7UL, xd ); asm_u8( c, imm & 63UL ); return;           /* ARSH64_IMM */
+  case 0x84:                      asm_rr( c, 0, 0xf7UL, 3UL, xd ); return;                                    /* NEG */
+  case 0x87 | FD_VM_JIT_OP_DEPR:  asm_rr( c, 1, 0xf7UL, 3UL, xd ); return;                                    /* NEG64 */
+  case 0xb4:                      asm_mov_ri32( c, xd, imm ); return;                                         /* MOV_IMM */
+  case 0xb7:                      asm_mov_ri64( c, xd, simm ); return;                                        /* MOV64_IMM */
+  case 0xf7:                                                                                                   /* HOR64 */
+    if( imm ) { asm_mov_ri64( c, RCX, imm<<32 ); asm_rr( c, 1, 0x09UL, RCX, xd ); }
+    return;
+  case 0xd4:                                                                                                   /* END_LE */
+    if     ( imm==16UL ) asm_rr( c, 0, 0x0fb7UL, xd, xd );
+    else if( imm==32UL ) asm_mov_rr32( c, xd, xd );
+    return;
+  case 0xdc:                                                                                                   /* END_BE */
+    if( imm==16UL ) {
+      asm_u8( c, 0x66UL ); asm_rr( c, 0, 0xc1UL, 0UL, xd ); asm_u8( c, 8UL ); /* rol r16,8 */
+      asm_rr( c, 0, 0x0fb7UL, xd, xd );
+    } else {
+      asm_rex( c, imm==64UL, 0UL, 0UL, xd, 0 ); asm_u8( c, 0x0fUL ); asm_u8( c, 0xc8UL + (xd&7UL) ); /* bswap */
+    }
+    return;
+
+  /* Stores of immediates */
+
+  case 0x27: case 0x37: case 0x87: case 0x97: {                                                              /* STB STH STW STDW */
+    ulong lg_sz = opcode==0x27UL ? 0UL : opcode==0x37UL ? 1UL : opcode==0x87UL ? 2UL : 3UL;
+    emit_mem_translate( c, pc, dst, off, lg_sz, 1 );
+    switch( lg_sz ) {
+    case 0UL: asm_rm( c, 0, 0xc6UL, 0UL, R11, 0L ); asm_u8 ( c, imm ); break;
+    case 1UL: asm_u8( c, 0x66UL ); asm_rm( c, 0, 0xc7UL, 0UL, R11, 0L ); asm_u16( c, imm ); break;
+    case 2UL: asm_rm( c, 0, 0xc7UL, 0UL, R11, 0L ); asm_u32( c, imm ); break;
+    default:  asm_rm( c, 1, 0xc7UL, 0UL, R11, 0L ); asm_u32( c, imm ); break;
+    }
+    return;
+  }
+
+  default: break;
+  }
+
+  /* Register operand instructions */
+
+  if( src>=FD_VM_REG_CNT ) { jmp_exit( c, pc ); return; }
+  ulong xs = fd_vm_jit_reg[ src ];
+
+  switch( op ) {
+  case 0x0c:                      asm_rr( c, 0, 0x01UL, xs, xd ); return;                                     /* ADD_REG */
+  case 0x0c | FD_VM_JIT_OP_DEPR:  asm_rr( c, 0, 0x01UL, xs, xd ); asm_rr( c, 1, 0x63UL, xd, xd ); return;
+  case 0x0f:                      asm_rr( c, 1, 0x01UL, xs, xd ); return;                                     /* ADD64_REG */
+  case 0x1c:                      asm_rr( c, 0, 0x29UL, xs, xd ); return;                                     /* SUB_REG */
+  case 0x1c | FD_VM_JIT_OP_DEPR:  asm_rr( c, 0, 0x29UL, xs, xd ); asm_rr( c, 1, 0x63UL, xd, xd ); return;
+  case 0x1f:                      asm_rr( c, 1, 0x29UL, xs, xd ); return;                                     /* SUB64_REG */
+  case 0x2c | FD_VM_JIT_OP_DEPR:  asm_rr( c, 0, 0x0fafUL, xd, xs ); asm_rr( c, 1, 0x63UL, xd, xd ); return;    /* MUL_REG */
+  case 0x2f | FD_VM_JIT_OP_DEPR:                                                                              /* MUL64_REG */
+  case 0x9e:                      asm_rr( c, 1, 0x0fafUL, xd, xs ); return;                                   /* LMUL64_REG */
+  case 0x8e:                      asm_rr( c, 0, 0x0fafUL, xd, xs ); return;                                   /* LMUL32_REG */
+  case 0x3c | FD_VM_JIT_OP_DEPR: case 0x9c | FD_VM_JIT_OP_DEPR: case 0x4e: case 0x6e:                          /* DIV_REG MOD_REG UDIV32_REG UREM32_REG */
+    asm_mov_rr32( c, RCX, xs );
+    emit_div( c, pc, dst, 0, 0, opcode==0x9cUL || opcode==0x6eUL, 1, 0 );
+    return;
+  case 0x3f | FD_VM_JIT_OP_DEPR: case 0x9f | FD_VM_JIT_OP_DEPR: case 0x5e: case 0x7e:                          /* DIV64_REG MOD64_REG UDIV64_REG UREM64_REG */
+    asm_mov_rr( c, RCX, xs );
+    emit_div( c, pc, dst, 1, 0, opcode==0x9fUL || opcode==0x7eUL, 1, 0 );
+    return;
+  case 0xce: case 0xee:                                                                                        /* SDIV32_REG SREM32_REG */
+    asm_mov_rr32( c, RCX, xs );
+    emit_div( c, pc, dst, 0, 1, opcode==0xeeUL, 1, 1 );
+    return;
+  case 0xde: case 0xfe:                                                                                        /* SDIV64_REG SREM64_REG */
+    asm_mov_rr( c, RCX, xs );
+    emit_div( c, pc, dst, 1, 1, opcode==0xfeUL, 1, 1 );
+    return;
+  case 0x3e:                                                                                                   /* UHMUL64_REG */
+    asm_mov_rr( c, RCX, xs );
+    emit_muldiv( c, dst, 1, 4UL, 1 );
+    return;
+  case 0xbe:                                                                                                   /* SHMUL64_REG */
+    asm_mov_rr( c, RCX, xs );
+    emit_muldiv( c, dst, 1, 5UL, 1 );
+    return;
+  case 0x4c:                      asm_rr( c, 0, 0x09UL, xs, xd ); return;                                     /* OR_REG */
+  case 0x4f:                      asm_rr( c, 1, 0x09UL, xs, xd ); return;                                     /* OR64_REG */
+  case 0x5c:                      asm_rr( c, 0, 0x21UL, xs, xd ); return;                                     /* AND_REG */
+  case 0x5f:                      asm_rr( c, 1, 0x21UL, xs, xd ); return;                                     /* AND64_REG */
+  case 0xac:                      asm_rr( c, 0, 0x31UL, xs, xd ); return;                                     /* XOR_REG */
+  case 0xaf:                      asm_rr( c, 1, 0x31UL, xs, xd ); return;                                     /* XOR64_REG */
+  case 0x6c: case 0x6f: case 0x7c: case 0x7f: case 0xcc: case 0xcf: {                                         /* LSH RSH ARSH (32/64) _REG */
+    ulong ext = (opcode>>4)==0x6UL ? 4UL : (opcode>>4)==0x7UL ? 5UL : 7UL;
+    asm_mov_rr32( c, RCX, xs );
+    asm_rr( c, (opcode & 7UL)==7UL, 0xd3UL, ext, xd );
+    return;
+  }
+  case 0xbc:                      asm_rr( c, 1, 0x63UL, xd, xs ); return;                                     /* MOV_REG */
+  case 0xbc | FD_VM_JIT_OP_DEPR:  asm_mov_rr32( c, xd, xs ); return;
+  case 0xbf:                      asm_mov_rr( c, xd, xs ); return;                                            /* MOV64_REG */
+
+  /* Loads (base is src) */
+
+  case 0x2c: case 0x3c: case 0x8c: case 0x9c: {                                                              /* LDXB LDXH LDXW LDXDW */
+    ulong lg_sz = opcode==0x2cUL ? 0UL : opcode==0x3cUL ? 1UL : opcode==0x8cUL ? 2UL : 3UL;
+    emit_mem_translate( c, pc, src, off, lg_sz, 0 );
+    switch( lg_sz ) {
+    case 0UL: asm_rm( c, 0, 0x0fb6UL, xd, R11, 0L ); break;
+    case 1UL: asm_rm( c, 0, 0x0fb7UL, xd, R11, 0L ); break;
+    case 2UL: asm_rm( c, 0, 0x8bUL,   xd, R11, 0L ); break;
+    default:  asm_rm( c, 1, 0x8bUL,   xd, R11, 0L ); break;
+    }
+    return;
+  }
+
+  /* Stores of registers (base is dst) */
+
+  case 0x2f: case 0x3f: case 0x8f: case 0x9f: {                                                              /* STXB STXH STXW STXDW */
+    ulong lg_sz = opcode==0x2fUL ? 0UL : opcode==0x3fUL ? 1UL : opcode==0x8fUL ? 2UL : 3UL;
+    emit_mem_translate( c, pc, dst, off, lg_sz, 1 );
+    switch( lg_sz ) {
+    case 0UL: asm_rm_x( c, 0, 0x88UL, xs, R11, 0L, 1 ); break;
+    case 1UL: asm_u8( c, 0x66UL ); asm_rm( c, 0, 0x89UL, xs, R11, 0L ); break;
+    case 2UL: asm_rm( c, 0, 0x89UL, xs, R11, 0L ); break;
+    default:  asm_rm( c, 1, 0x89UL, xs, R11, 0L ); break;
+    }
+    return;
+  }
+
+  default:
+    FD_LOG_CRIT(( "unhandled op %#lx", op )); /* not reached */
+  }
+}
+
+/* Compiler ***********************************************************/
+
+static inline int
+fd_vm_jit_private_reserve( fd_vm_jit_cstate_t * c ) {
+  return c->sz + FD_VM_JIT_INSTR_MAX <= c->max;
+}
+
+static ulong
+emit_exit_stub( fd_vm_jit_cstate_t * c,
+                ulong                pc ) {
+  if( c->exit_pos[ pc ] ) return c->exit_pos[ pc ];
+  ulong pos = c->sz;
+  asm_mov_ri32( c, RCX, pc );
+  asm_add_ri  ( c, RM, -(long)c->tbl[ pc ].idx );
+  asm_jmp_lbl ( c, c->lbl_resume );
+  c->exit_pos[ pc ] = (uint)pos;
+  return pos;
+}
+
+int
+fd_vm_jit_compile( fd_vm_jit_t *              jit,
+                   ulong const *              text,
+                   ulong                      text_cnt,
+                   ulong                      text_off,
+                   ulong                      entry_pc,
+                   ulong const *              calldests,
+                   fd_sbpf_syscalls_t const * syscalls,
+                   ulong                      sbpf_version ) {
+
+  if( FD_UNLIKELY( !jit ) ) return FD_VM_ERR_INVAL;
+  jit->text_cnt = 0UL; /* not compiled until the end */
+  jit->code_sz  = 0UL;
+
+  if( FD_UNLIKELY( (!text) | (!text_cnt) | (entry_pc>=text_cnt) | (sbpf_version>=FD_SBPF_VERSION_COUNT) ) ) return FD_VM_ERR_INVAL;
+  if( FD_UNLIKELY( text_cnt>jit->text_cnt_max ) ) return FD_VM_ERR_FULL;
+
+  /* Matches the normalization done by fd_vm_init */
+
+  if( FD_VM_SBPF_ENABLE_LOWER_RODATA_VADDR( sbpf_version ) ) text_off = 0UL;
+
+  ulong text_cnt_max = jit->text_cnt_max;
+  uchar * scratch    = (uchar *)jit + fd_vm_jit_private_scratch_off( text_cnt_max );
+  ulong   fix_max    = fd_vm_jit_private_fix_max( text_cnt_max );
+
+  fd_vm_jit_cstate_t c[1] = {{
+    .code         = fd_vm_jit_private_code( jit ),
+    .sz           = 0UL,
+    .max          = jit->code_max,
+    .tbl          = fd_vm_jit_private_tbl( jit ),
+    .text         = text,
+    .text_cnt     = text_cnt,
+    .text_off     = text_off,
+    .entry_pc     = entry_pc,
+    .calldests    = calldests,
+    .syscalls     = FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ? NULL : syscalls,
+    .sbpf_version = sbpf_version,
+    .fix          = (fd_vm_jit_fixup_t *)scratch,
+    .fix_cnt      = 0UL,
+    .fix_max      = fix_max,
+    .mstub        = (fd_vm_jit_mstub_t *)(scratch + fix_max*sizeof(fd_vm_jit_fixup_t)),
+    .mstub_cnt    = 0UL,
+    .exit_pos     = (uint *)(scratch + fix_max*sizeof(fd_vm_jit_fixup_t) + (text_cnt_max+1UL)*sizeof(fd_vm_jit_mstub_t))
+  }};
+  fd_vm_jit_pc_t * tbl = c->tbl;
+
+  /* Decode the program into instructions, computing instruction
+     indices and the linear runs */
+
+  ulong idx = 0UL;
+  for( ulong pc=0UL; pc<text_cnt; ) {
+    ulong instr = text[ pc ];
+    ulong op    = fd_vm_jit_decode( fd_vm_instr_opcode( instr ), sbpf_version );
+    tbl[ pc ] = (fd_vm_jit_pc_t){ .idx = (uint)idx, .flags = fd_vm_jit_op_is_branch( op ) ? FD_VM_JIT_PC_FLAG_BRANCH : 0U };
+    c->exit_pos[ pc ] = 0U;
+    idx++;
+    if( op==0x18UL ) { /* LDDW */
+      if( FD_UNLIKELY( pc+1UL>=text_cnt ) ) return FD_VM_ERR_INCOMPLETE_LDQ;
+      tbl[ pc+1UL ] = (fd_vm_jit_pc_t){ .idx = (uint)idx, .flags = FD_VM_JIT_PC_FLAG_ADDL };
+      c->exit_pos[ pc+1UL ] = 0U;
+      pc += 2UL;
+      continue;
+    }
+    if( op==0xd4UL || op==0xdcUL ) { /* END_LE / END_BE faults without billing, which we cannot resume exactly */
+      ulong imm = fd_vm_instr_imm( instr );
+      if( FD_UNLIKELY( imm!=16UL && imm!=32UL && imm!=64UL ) ) return FD_VM_ERR_INVALID_END_IMM;
+    }
+    pc++;
+  }
+  tbl[ text_cnt ] = (fd_vm_jit_pc_t){ .idx = (uint)idx, .run_end = (uint)idx+1U };
+  c->exit_pos[ text_cnt ] = 0U;
+
+  for( ulong pc=text_cnt; pc; pc-- ) {
+    fd_vm_jit_pc_t * e = tbl + pc - 1UL;
+    if( e->flags & FD_VM_JIT_PC_FLAG_ADDL ) { e->run_end = 0U; continue; }
+    if( e->flags & FD_VM_JIT_PC_FLAG_BRANCH ) { e->run_end = e->idx+1U; continue; }
+    ulong next = pc - 1UL + ( fd_vm_jit_decode( fd_vm_instr_opcode( text[ pc-1UL ] ), sbpf_version )==0x18UL ? 2UL : 1UL );
+    e->run_end = tbl[ next ].run_end;
+  }
+
+  /* Emit the code */
+
+  emit_runtime( c );
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    if( FD_UNLIKELY( !fd_vm_jit_private_reserve( c ) ) ) return FD_VM_ERR_FULL;
+    if( tbl[ pc ].flags & FD_VM_JIT_PC_FLAG_ADDL ) continue; /* code_off set below */
+    tbl[ pc ].code_off = (uint)c->sz;
+    emit_instr( c, pc );
+  }
+  if( FD_UNLIKELY( !fd_vm_jit_private_reserve( c ) ) ) return FD_VM_ERR_FULL;
+  tbl[ text_cnt ].code_off = (uint)emit_exit_stub( c, text_cnt ); /* falling off the end of the text */
+
+  for( ulong i=0UL; i<c->mstub_cnt; i++ ) {
+    if( FD_UNLIKELY( !fd_vm_jit_private_reserve( c ) ) ) return FD_VM_ERR_FULL;
+    c->mstub[ i ].pos = (uint)c->sz;
+    emit_mem_stub( c, c->mstub + i );
+  }
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    if( !(tbl[ pc ].flags & FD_VM_JIT_PC_FLAG_ADDL) ) continue;
+    if( FD_UNLIKELY( !fd_vm_jit_private_reserve( c ) ) ) return FD_VM_ERR_FULL;
+    tbl[ pc ].code_off = (uint)emit_exit_stub( c, pc );
+  }
+
+  /* Resolve fixups (exit stubs are emitted on first use) */
+
+  for( ulong i=0UL; i<c->fix_cnt; i++ ) {
+    fd_vm_jit_fixup_t const * f = c->fix + i;
+    ulong target;
+    switch( f->kind ) {
+    case FD_VM_JIT_FIX_PC:   target = tbl[ f->arg ].code_off; break;
+    case FD_VM_JIT_FIX_MEM:  target = c->mstub[ f->arg ].pos; break;
+    default:
+      if( FD_UNLIKELY( !fd_vm_jit_private_reserve( c ) ) ) return FD_VM_ERR_FULL;
+      target = emit_exit_stub( c, f->arg );
+      break;
+    }
+    asm_patch( c, f->pos, target );
+  }
+
+  jit->text_cnt      = text_cnt;
+  jit->text_off      = text_off;
+  jit->entry_pc      = entry_pc;
+  jit->sbpf_version  = sbpf_version;
+  jit->syscalls_hash = fd_vm_jit_syscalls_hash( c->syscalls );
+  jit->code_sz       = c->sz;
+  jit->text          = text;
+  jit->calldests     = calldests;
+  return FD_VM_SUCCESS;
+}
+
+ulong
+fd_vm_jit_syscalls_hash( fd_sbpf_syscalls_t const * syscalls ) {
+  if( !syscalls ) return 0UL;
+
+  /* Order independent, such that maps with the same keys inserted in
+     a different order (and thus at different slots) hash the same */
+
+  ulong hash = 0UL;
+  for( ulong i=0UL; i<FD_SBPF_SYSCALLS_SLOT_CNT; i++ ) {
+    ulong key = syscalls[ i ].key;
+    if( key!=fd_sbpf_syscalls_key_null() ) hash += fd_ulong_hash( key );
+  }
+  return hash;
+}
+
+int
+fd_vm_jit_bind( fd_vm_jit_t * jit,
+                ulong const * text,
+                ulong const * calldests,
+                ulong         syscalls_hash ) {
+
+  /* Static syscall versions never consult the map */
+
+  if( FD_UNLIKELY( !FD_VM_SBPF_STATIC_SYSCALLS( jit->sbpf_version ) && syscalls_hash!=jit->syscalls_hash ) ) {
+    jit->text      = NULL;
+    jit->calldests = NULL;
+    return 0;
+  }
+  jit->text      = text;
+  jit->calldests = calldests;
+  return 1;
+}
+
+/* Execution **********************************************************/
+
+typedef int (*fd_vm_jit_entry_t)( fd_vm_jit_ctx_t * ctx );
+
+#define FD_VM_JIT_CU_MAX (1UL<<40)
+
+int
+fd_vm_exec_jit( fd_vm_t *           vm,
+                fd_vm_jit_t const * jit ) {
+
+  if( FD_UNLIKELY( (!jit) | (!vm) ) ) return FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+  if( FD_UNLIKELY( (!jit->text_cnt)                       |
+                   (!!vm->trace)                          |
+                   (vm->text        !=jit->text         ) |
+                   (vm->calldests   !=jit->calldests    ) |
+                   (vm->text_cnt    !=jit->text_cnt     ) |
+                   (vm->text_off    !=jit->text_off     ) |
+                   (vm->entry_pc    !=jit->entry_pc     ) |
+                   (vm->sbpf_version!=jit->sbpf_version ) ) ) return FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+
+  /* The instruction meter assumes the budget is bounded by protocol
+     limits (see FD_VM_INTERP_BLOCK_TEXT_LIMIT) */
+
+  if( FD_UNLIKELY( vm->cu>FD_VM_JIT_CU_MAX ) ) return fd_vm_exec_notrace( vm );
+
+  fd_vm_jit_ctx_t ctx[1];
+  ctx->vm         = vm;
+  ctx->ick        = vm->ic + vm->cu;
+  ctx->frame_cnt  = vm->frame_cnt;
+  ctx->frame_bump = vm->stack_frame_sz * vm->stack_push_frame_count;
+  ctx->shadow     = vm->shadow;
+  ctx->pc_tbl     = fd_vm_jit_private_tbl( jit );
+  ctx->code       = (ulong)fd_vm_jit_private_code( jit );
+  ctx->haddr_fn   = fd_vm_jit_haddr;
+  ctx->syscall_fn = fd_vm_jit_syscall;
+  fd_vm_jit_ctx_refresh( ctx );
+
+  int err = ((fd_vm_jit_entry_t)ctx->code)( ctx );
+  if( FD_UNLIKELY( err==FD_VM_JIT_RESUME ) ) err = fd_vm_exec_notrace( vm );
+  return err;
+}
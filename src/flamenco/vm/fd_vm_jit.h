@@ -0,0 +1,197 @@
+#ifndef HEADER_fd_src_flamenco_vm_fd_vm_jit_h
+#define HEADER_fd_src_flamenco_vm_fd_vm_jit_h
+
+/* fd_vm_jit is an sBPF to x86-64 just-in-time compiler.  It is an
+   optional fast path alongside the interpreter in fd_vm_interp_core.c:
+   a program is compiled once into a fd_vm_jit_t and can then be run
+   any number of times against vms that were initialized with the same
+   program text.
+
+   The JIT does not try to reproduce the interpreter's fault reporting.
+   Instead, compiled code runs only while it can prove that doing so is
+   observably identical to the interpreter:
+
+   - Compute metering uses an instruction meter register (the Agave
+     IM' form, see the CU model analysis at the end of
+     fd_vm_interp_core.c).  At the start of every linear run, the
+     compiled code checks that the remaining budget covers the whole
+     run.  If it does not, no instruction in the run is executed.
+
+   - Any instruction that might fault (failed memory translations,
+     division by zero / overflow, invalid call targets, call depth
+     exhaustion, unsupported opcodes, unknown syscalls, jumps into the
+     middle of a multiword instruction or outside the text ...) is
+     checked before it modifies any state.
+
+   In both cases the compiled code stops with the vm state (pc, ic, cu,
+   frame_cnt, registers) exactly as the interpreter would have it at
+   the start of that instruction and fd_vm_exec_jit finishes the
+   program with fd_vm_exec_notrace.  Since compute billing is additive
+   over linear runs, the resulting ic, cu, error code and memory are
+   bit-for-bit what the interpreter alone would have produced.  The
+   fallback path is rare in practice (it is hit on faults and when the
+   budget is about to be exhausted).
+
+   Call immediates are resolved at compile time: an immediate that is
+   a key of the syscall map given to fd_vm_jit_compile is compiled as a
+   syscall (shadowing any local function with the same hash, as the
+   interpreter checks the syscall map first), anything else as a local
+   call.  The syscall itself is still looked up in the vm's syscall map
+   at run time.  The image records a hash of the compile time key set
+   (fd_vm_jit_syscalls_hash) and fd_vm_jit_bind refuses to bind it for
+   a vm whose syscall map has different keys, such that a mismatch
+   falls back to the interpreter instead of resolving calls
+   differently.
+
+   The compiled code is position independent (it only references its
+   own dispatch table and helpers through a context register), such
+   that a compiled image can be cached and copied between memory
+   regions (see fd_vm_jit_image_sz).  The memory holding a fd_vm_jit_t
+   must be mapped executable when fd_vm_exec_jit runs.  Since execution
+   never writes to it, a jit can be compiled through a writable mapping
+   and run through a separate read-only executable mapping of the same
+   memory.
+
+   Only available on x86-64 hosted targets (FD_HAS_X86). */
+
+#include "fd_vm.h"
+
+/* FD_VM_JIT_ALIGN is the alignment of a fd_vm_jit_t.  Page aligned
+   such that the caller can change the protection of the memory
+   region. */
+
+#define FD_VM_JIT_ALIGN (4096UL)
+
+/* FD_VM_JIT_RESUME is returned by the compiled code when it stopped
+   before an instruction it cannot run natively.  Internal to
+   fd_vm_exec_jit (never returned to the caller). */
+
+#define FD_VM_JIT_RESUME (1)
+
+struct fd_vm_jit_private;
+typedef struct fd_vm_jit_private fd_vm_jit_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vm_jit_{align,footprint} give the required alignment and
+   footprint of a memory region suitable for holding a fd_vm_jit_t
+   that can compile programs with up to text_cnt_max sBPF words.
+   footprint returns 0 if text_cnt_max is not valid. */
+
+FD_FN_CONST ulong
+fd_vm_jit_align( void );
+
+FD_FN_CONST ulong
+fd_vm_jit_footprint( ulong text_cnt_max );
+
+/* fd_vm_jit_new formats the memory region shmem as a fd_vm_jit_t.
+   fd_vm_jit_join joins the caller to it.  fd_vm_jit_leave and
+   fd_vm_jit_delete are the usual inverses.  Returns NULL (and logs
+   details) on failure.  The memory region should be mapped readable
+   and writable. */
+
+void *
+fd_vm_jit_new( void * shmem,
+               ulong  text_cnt_max );
+
+fd_vm_jit_t *
+fd_vm_jit_join( void * shjit );
+
+void *
+fd_vm_jit_leave( fd_vm_jit_t * jit );
+
+void *
+fd_vm_jit_delete( void * shjit );
+
+/* fd_vm_jit_compile compiles the sBPF program given by text (indexed
+   [0,text_cnt)) with the given callx text offset, entry point, local
+   call destinations (NULL if none), syscall map (NULL if none) and
+   sBPF version.  These must match the corresponding values that will
+   be given to fd_vm_init for the vms that execute it.  text is
+   expected to have passed fd_vm_validate.  The compiled jit is bound to
+   text and calldests (see fd_vm_jit_bind).
+
+   Returns FD_VM_SUCCESS on success and a FD_VM_ERR code on failure.
+   On failure, jit is left in a not-compiled state (fd_vm_exec_jit will
+   return FD_VM_ERR_EBPF_JIT_NOT_COMPILED).  Reasons for failure
+   include invalid arguments (FD_VM_ERR_INVAL), text_cnt too large for
+   jit (FD_VM_ERR_FULL) and malformed programs that fd_vm_validate
+   would have rejected (FD_VM_ERR_INVALID_END_IMM,
+   FD_VM_ERR_INCOMPLETE_LDQ). */
+
+int
+fd_vm_jit_compile( fd_vm_jit_t *              jit,
+                   ulong const *              text,
+                   ulong                      text_cnt,
+                   ulong                      text_off,
+                   ulong                      entry_pc,
+                   ulong const *              calldests,
+                   fd_sbpf_syscalls_t const * syscalls,
+                   ulong                      sbpf_version );
+
+/* fd_vm_jit_bind binds a compiled jit to the program at text, with
+   local call destinations calldests, in the caller's address space.
+   fd_vm_exec_jit only runs vms initialized with these exact text and
+   calldests pointers.  Used after copying an image (or after the
+   program it was compiled from moved), the caller promises that text
+   and calldests have the same contents as the ones it was compiled
+   from.  syscalls_hash is the fd_vm_jit_syscalls_hash of the syscall
+   map the vms will use.  Returns 1 on success.  If jit resolves call
+   immediates against the syscall map and syscalls_hash differs from
+   the one of the map jit was compiled with, returns 0 and leaves jit
+   unbound (fd_vm_exec_jit will return FD_VM_ERR_EBPF_JIT_NOT_COMPILED
+   until it is rebound). */
+
+int
+fd_vm_jit_bind( fd_vm_jit_t * jit,
+                ulong const * text,
+                ulong const * calldests,
+                ulong         syscalls_hash );
+
+/* fd_vm_jit_syscalls_hash returns a hash of the key set of syscall map
+   syscalls (0 if syscalls is NULL or empty).  The hash does not depend
+   on the order the keys were inserted in. */
+
+FD_FN_PURE ulong
+fd_vm_jit_syscalls_hash( fd_sbpf_syscalls_t const * syscalls );
+
+/* fd_vm_jit_code_sz returns the number of bytes of machine code
+   generated by the last successful compile (0 if jit is not compiled).
+   fd_vm_jit_image_sz returns the number of bytes at the start of jit's
+   memory region that hold the complete compiled image (header,
+   dispatch table and code).  A compiled image can be copied with a
+   plain memcpy of that many bytes into another suitably aligned and
+   fd_vm_jit_footprint sized region, and joined and run there (or from
+   an executable mapping of it). */
+
+FD_FN_PURE ulong
+fd_vm_jit_code_sz( fd_vm_jit_t const * jit );
+
+FD_FN_PURE ulong
+fd_vm_jit_image_sz( fd_vm_jit_t const * jit );
+
+/* fd_vm_exec_jit runs vm with the program compiled into jit.  vm
+   should be set up exactly as it would be for fd_vm_exec (it can also
+   be resumed from a state left by a previous execution).  Returns the
+   same values as fd_vm_exec_notrace with identical vm state on return.
+
+   Returns FD_VM_ERR_EBPF_JIT_NOT_COMPILED without modifying vm if jit
+   can not be used to run vm (jit is not compiled, vm is attached to a
+   trace, or vm's text, calldests, entry point, text offset or sBPF
+   version differ from the ones jit is bound to).  The caller should
+   use fd_vm_exec in this case.  vm's syscall map is not checked here,
+   see fd_vm_jit_bind.
+
+   Differential testing: since fd_vm_exec_jit and fd_vm_exec_notrace
+   must produce identical results, running both on identically
+   initialized vms and comparing registers, pc, ic, cu, frame_cnt,
+   error codes and memory is the intended way to test the compiler
+   (see test_vm_jit.c). */
+
+int
+fd_vm_exec_jit( fd_vm_t *           vm,
+                fd_vm_jit_t const * jit );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_vm_fd_vm_jit_h */
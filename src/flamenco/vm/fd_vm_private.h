@@ -545,6 +545,14 @@ static inline void fd_vm_mem_st_8( ulong haddr,
   memcpy( (void *)haddr, &val, sizeof(ulong) );
 }
 
+/* fd_vm_dump_syscall dumps the syscall named name that vm is about to
+   make for seed corpora.  Called by the interpreter and the JIT when
+   vm->dump_syscall_to_pb is set. */
+
+void
+fd_vm_dump_syscall( fd_vm_t const * vm,
+                    char const *    name );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_vm_fd_vm_private_h */
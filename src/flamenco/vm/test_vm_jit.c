@@ -0,0 +1,584 @@
+#define _DEFAULT_SOURCE
+#include "fd_vm_jit.h"
+#include "fd_vm_private.h"
+#include "../../ballet/murmur3/fd_murmur3.h"
+
+#include <sys/mman.h>
+
+/* test_vm_jit differentially tests the JIT against the interpreter:
+   random programs are run with fd_vm_exec_notrace and fd_vm_exec_jit
+   on identically initialized vms and the complete observable vm state
+   is compared afterwards. */
+
+#define TEXT_MAX  (256UL)
+#define INPUT_SZ  (512UL)
+#define HEAP_SZ   (4096UL)
+
+static uint test_syscall_cu;
+
+static int
+test_syscall_acc( void *  _vm,
+                  ulong   arg0,
+                  ulong   arg1,
+                  ulong   arg2,
+                  ulong   arg3,
+                  ulong   arg4,
+                  ulong * ret ) {
+  fd_vm_t * vm = (fd_vm_t *)_vm;
+  *ret = arg0 + arg1 + arg2 + arg3 + arg4;
+  if( vm->cu<test_syscall_cu ) { vm->cu = 0UL; return FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED; }
+  vm->cu -= test_syscall_cu;
+  vm->reg[ 6 ] ^= 0x5a5aUL; /* syscalls can see and modify the vm */
+  return 0;
+}
+
+static int
+test_syscall_fail( FD_PARAM_UNUSED void *  _vm,
+                   FD_PARAM_UNUSED ulong   arg0,
+                   FD_PARAM_UNUSED ulong   arg1,
+                   FD_PARAM_UNUSED ulong   arg2,
+                   FD_PARAM_UNUSED ulong   arg3,
+                   FD_PARAM_UNUSED ulong   arg4,
+                   /**/            ulong * ret ) {
+  *ret = 42UL;
+  return FD_VM_SYSCALL_ERR_INVALID_STRING;
+}
+
+#define SYSCALL_ACC  (fd_murmur3_32( "test_acc",  8UL, 0U ))
+#define SYSCALL_FAIL (fd_murmur3_32( "test_fail", 9UL, 0U ))
+
+/* Per execution environment */
+
+struct test_env {
+  fd_vm_t              vm[1];
+  uchar                input[ INPUT_SZ ];
+  fd_vm_input_region_t region[ 2 ];
+};
+
+typedef struct test_env test_env_t;
+
+static test_env_t env[2];
+
+struct test_prog {
+  ulong   text[ TEXT_MAX ];
+  ulong   text_cnt;
+  ulong   sbpf_version;
+  ulong   entry_pc;
+  ulong   entry_cu;
+  uint    region_cnt;
+  uchar   writable;
+  ulong   reg[ FD_VM_REG_CNT ];
+  uchar   input[ INPUT_SZ ];
+};
+
+typedef struct test_prog test_prog_t;
+
+static void
+env_init( test_env_t *          e,
+          test_prog_t const *   p,
+          fd_sbpf_calldests_t * calldests,
+          fd_sbpf_syscalls_t *  syscalls ) {
+  memcpy( e->input, p->input, INPUT_SZ );
+  if( p->region_cnt==1U ) {
+    e->region[0] = (fd_vm_input_region_t){ .vaddr_offset = 0UL, .haddr = (ulong)e->input, .region_sz = (uint)INPUT_SZ,
+                                           .address_space_reserved = INPUT_SZ, .is_writable = p->writable };
+  } else {
+    e->region[0] = (fd_vm_input_region_t){ .vaddr_offset = 0UL, .haddr = (ulong)e->input, .region_sz = 128U,
+                                           .address_space_reserved = 128UL, .is_writable = 1U };
+    e->region[1] = (fd_vm_input_region_t){ .vaddr_offset = 128UL, .haddr = (ulong)e->input+128UL, .region_sz = (uint)(INPUT_SZ-128UL),
+                                           .address_space_reserved = INPUT_SZ-128UL, .is_writable = p->writable };
+  }
+
+  FD_TEST( fd_vm_init(
+      /* vm                                     */ e->vm,
+      /* instr_ctx                              */ NULL,
+      /* heap_max                               */ HEAP_SZ,
+      /* entry_cu                               */ p->entry_cu,
+      /* rodata                                 */ (uchar const *)p->text,
+      /* rodata_sz                              */ p->text_cnt * sizeof(ulong),
+      /* text                                   */ p->text,
+      /* text_cnt                               */ p->text_cnt,
+      /* text_off                               */ 0UL,
+      /* text_sz                                */ p->text_cnt * sizeof(ulong),
+      /* entry_pc                               */ p->entry_pc,
+      /* calldests                              */ calldests,
+      /* sbpf_version                           */ p->sbpf_version,
+      /* syscalls                               */ syscalls,
+      /* trace                                  */ NULL,
+      /* sha                                    */ NULL,
+      /* mem_regions                            */ e->region,
+      /* mem_regions_cnt                        */ p->region_cnt,
+      /* mem_regions_accs                       */ NULL,
+      /* is_deprecated                          */ 0,
+      /* direct mapping                         */ 0,
+      /* syscall_parameter_address_restrictions */ 0,
+      /* virtual_address_space_adjustments      */ 0,
+      /* dump_syscall_to_pb                     */ 0,
+      /* r2_initial_value                       */ 0UL ) );
+
+  for( ulong i=0UL; i<10UL; i++ ) e->vm->reg[ i ] = p->reg[ i ];
+  memset( e->vm->stack,  0, FD_VM_STACK_MAX );
+  memset( e->vm->heap,   0, HEAP_SZ );
+  memset( e->vm->shadow, 0, sizeof(e->vm->shadow) );
+}
+
+/* env_diff returns 0 if the observable state of a and b is identical */
+
+static int
+env_diff( test_env_t const * a,
+          test_env_t const * b ) {
+  fd_vm_t const * va = a->vm;
+  fd_vm_t const * vb = b->vm;
+  if( va->pc!=vb->pc               ) { FD_LOG_WARNING(( "pc %lu %lu",        va->pc,        vb->pc        )); return 1; }
+  if( va->ic!=vb->ic               ) { FD_LOG_WARNING(( "ic %lu %lu",        va->ic,        vb->ic        )); return 1; }
+  if( va->cu!=vb->cu               ) { FD_LOG_WARNING(( "cu %lu %lu",        va->cu,        vb->cu        )); return 1; }
+  if( va->frame_cnt!=vb->frame_cnt ) { FD_LOG_WARNING(( "frame_cnt %lu %lu", va->frame_cnt, vb->frame_cnt )); return 1; }
+  for( ulong i=0UL; i<FD_VM_REG_CNT; i++ ) {
+    if( va->reg[i]!=vb->reg[i] ) { FD_LOG_WARNING(( "r%lu %016lx %016lx", i, va->reg[i], vb->reg[i] )); return 1; }
+  }
+  if( va->segv_vaddr      !=vb->segv_vaddr       ||
+      va->segv_access_len !=vb->segv_access_len  ||
+      va->segv_access_type!=vb->segv_access_type ) { FD_LOG_WARNING(( "segv" )); return 1; }
+  if( memcmp( va->shadow, vb->shadow, sizeof(va->shadow) ) ) { FD_LOG_WARNING(( "shadow" )); return 1; }
+  if( memcmp( va->stack,  vb->stack,  FD_VM_STACK_MAX    ) ) { FD_LOG_WARNING(( "stack"  )); return 1; }
+  if( memcmp( va->heap,   vb->heap,   HEAP_SZ            ) ) { FD_LOG_WARNING(( "heap"   )); return 1; }
+  if( memcmp( a->input,   b->input,   INPUT_SZ           ) ) { FD_LOG_WARNING(( "input"  )); return 1; }
+  return 0;
+}
+
+/* Random program generation */
+
+static uint
+rand_imm( fd_rng_t * rng ) {
+  switch( fd_rng_uint_roll( rng, 8U ) ) {
+  case 0U: return 0U;
+  case 1U: return UINT_MAX;
+  case 2U: return 0x80000000U;
+  case 3U: return fd_rng_uint_roll( rng, 8U );
+  case 4U: return (uint)(-(int)fd_rng_uint_roll( rng, 8U ));
+  case 5U: return fd_rng_uint_roll( rng, 70U );
+  default: return fd_rng_uint( rng );
+  }
+}
+
+static ulong
+rand_reg( fd_rng_t * rng ) {
+  if( FD_UNLIKELY( !fd_rng_uint_roll( rng, 64U ) ) ) return 11UL + fd_rng_ulong_roll( rng, 5UL );
+  return fd_rng_ulong_roll( rng, 11UL );
+}
+
+static ulong
+rand_region_ptr( fd_rng_t * rng ) {
+  switch( fd_rng_uint_roll( rng, 5U ) ) {
+  case 0U: return FD_VM_MEM_MAP_STACK_REGION_START + fd_rng_ulong_roll( rng, 2UL*FD_VM_STACK_FRAME_SZ );
+  case 1U: return FD_VM_MEM_MAP_HEAP_REGION_START  + fd_rng_ulong_roll( rng, HEAP_SZ + 16UL );
+  case 2U: return FD_VM_MEM_MAP_PROGRAM_REGION_START + fd_rng_ulong_roll( rng, 64UL );
+  default: return FD_VM_MEM_MAP_INPUT_REGION_START + fd_rng_ulong_roll( rng, INPUT_SZ + 16UL );
+  }
+}
+
+static uchar const alu_ops[] = {
+  0x04, 0x07, 0x0c, 0x0f, 0x14, 0x17, 0x1c, 0x1f, 0x24, 0x27, 0x2c, 0x2f, 0x34, 0x36, 0x37, 0x3c, 0x3e, 0x3f,
+  0x44, 0x46, 0x47, 0x4c, 0x4e, 0x4f, 0x54, 0x56, 0x57, 0x5c, 0x5e, 0x5f, 0x64, 0x66, 0x67, 0x6c, 0x6e, 0x6f,
+  0x74, 0x76, 0x77, 0x7c, 0x7e, 0x7f, 0x84, 0x86, 0x87, 0x8e, 0x94, 0x96, 0x97, 0x9c, 0x9e, 0x9f, 0xa4, 0xa7,
+  0xac, 0xaf, 0xb4, 0xb6, 0xb7, 0xbc, 0xbe, 0xbf, 0xc4, 0xc6, 0xc7, 0xcc, 0xce, 0xcf, 0xd4, 0xd6, 0xdc, 0xde,
+  0xe6, 0xee, 0xf6, 0xf7, 0xfe
+};
+
+static uchar const jmp_ops[] = {
+  0x15, 0x1d, 0x25, 0x2d, 0x35, 0x3d, 0x45, 0x4d, 0x55, 0x5d, 0x65, 0x6d, 0x75, 0x7d, 0xa5, 0xad, 0xb5, 0xbd,
+  0xc5, 0xcd, 0xd5, 0xdd, 0x16, 0x1e, 0x26, 0x2e, 0x36, 0x3e, 0x46, 0x4e, 0x56, 0x5e, 0x66, 0x6e, 0x76, 0x7e,
+  0xa6, 0xae, 0xb6, 0xbe, 0xc6, 0xce, 0xd6, 0xde
+};
+
+static uchar const mem_ops_v2[] = { 0x27, 0x2c, 0x2f, 0x37, 0x3c, 0x3f, 0x87, 0x8c, 0x8f, 0x97, 0x9c, 0x9f };
+static uchar const mem_ops_v0[] = { 0x72, 0x71, 0x73, 0x6a, 0x69, 0x6b, 0x62, 0x61, 0x63, 0x7a, 0x79, 0x7b };
+
+static void
+gen_prog( test_prog_t *         p,
+          fd_sbpf_calldests_t * calldests,
+          fd_rng_t *            rng,
+          ulong                 sbpf_version ) {
+  ulong text_cnt = 4UL + fd_rng_ulong_roll( rng, TEXT_MAX-4UL );
+  int   lddw_ok  = !FD_VM_SBPF_DISABLE_LDDW( sbpf_version );
+  int   is_v2    = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version );
+
+  p->text_cnt     = text_cnt;
+  p->sbpf_version = sbpf_version;
+  p->entry_pc     = fd_rng_uint_roll( rng, 4U ) ? 0UL : fd_rng_ulong_roll( rng, text_cnt );
+  p->region_cnt   = fd_rng_uint_roll( rng, 4U ) ? 1U : 2U;
+  p->writable     = (uchar)!!fd_rng_uint_roll( rng, 8U );
+
+  switch( fd_rng_uint_roll( rng, 4U ) ) {
+  case 0U:  p->entry_cu = fd_rng_ulong_roll( rng, 64UL );   break;
+  case 1U:  p->entry_cu = fd_rng_ulong_roll( rng, 1024UL ); break;
+  default:  p->entry_cu = 20000UL;                          break;
+  }
+
+  for( ulong i=0UL; i<10UL; i++ ) {
+    switch( fd_rng_uint_roll( rng, 4U ) ) {
+    case 0U:  p->reg[i] = fd_rng_ulong( rng );               break;
+    case 1U:  p->reg[i] = fd_rng_ulong_roll( rng, 16UL );    break;
+    default:  p->reg[i] = rand_region_ptr( rng );            break;
+    }
+  }
+  for( ulong i=0UL; i<INPUT_SZ; i++ ) p->input[i] = fd_rng_uchar( rng );
+
+  /* Local function entries */
+
+  ulong func[8];
+  ulong func_cnt = 1UL + fd_rng_ulong_roll( rng, 7UL );
+  for( ulong i=0UL; i<func_cnt; i++ ) {
+    func[i] = fd_rng_ulong_roll( rng, text_cnt );
+    if( calldests ) fd_sbpf_calldests_insert( calldests, func[i] );
+  }
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    ulong dst = rand_reg( rng );
+    ulong src = rand_reg( rng );
+    short off = (short)((int)fd_rng_uint_roll( rng, 17U ) - 6);
+    uint  imm = rand_imm( rng );
+    ulong op;
+
+    uint kind = fd_rng_uint_roll( rng, 100U );
+    if( kind<40U ) {        /* ALU */
+      op = alu_ops[ fd_rng_ulong_roll( rng, sizeof(alu_ops) ) ];
+      if( op==0xd4UL || op==0xdcUL ) imm = 16U << fd_rng_uint_roll( rng, 3U );
+    } else if( kind<60U ) { /* Memory */
+      op = ( is_v2 ? mem_ops_v2 : mem_ops_v0 )[ fd_rng_ulong_roll( rng, 12UL ) ];
+      off = (short)((int)fd_rng_uint_roll( rng, 64U ) - 8);
+      if( !fd_rng_uint_roll( rng, 32U ) ) off = (short)fd_rng_uint( rng );
+      dst = fd_rng_uint_roll( rng, 8U ) ? fd_rng_ulong_roll( rng, 11UL ) : rand_reg( rng );
+      src = fd_rng_uint_roll( rng, 8U ) ? fd_rng_ulong_roll( rng, 11UL ) : rand_reg( rng );
+    } else if( kind<78U ) { /* Conditional jumps */
+      op = jmp_ops[ fd_rng_ulong_roll( rng, sizeof(jmp_ops) ) ];
+      if( !fd_rng_uint_roll( rng, 32U ) ) off = (short)fd_rng_uint( rng );
+    } else if( kind<81U ) { /* JA */
+      op = 0x05UL;
+    } else if( kind<86U ) { /* Syscalls and local calls */
+      op = 0x85UL;
+      uint which = fd_rng_uint_roll( rng, 8U );
+      ulong f = func[ fd_rng_ulong_roll( rng, func_cnt ) ];
+      if( FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ) {
+        if     ( which<3U ) { src = 0UL; imm = SYSCALL_ACC;  }
+        else if( which<4U ) { src = 0UL; imm = SYSCALL_FAIL; }
+        else if( which<7U ) { src = 1UL; imm = (uint)((long)f - (long)pc - 1L); }
+        else                { src = fd_rng_ulong_roll( rng, 3UL ); }
+      } else {
+        if     ( which<3U ) imm = SYSCALL_ACC;
+        else if( which<4U ) imm = SYSCALL_FAIL;
+        else if( which<7U ) imm = fd_pchash( (uint)f );
+        else if( which<8U ) imm = fd_rng_uint_roll( rng, 2U ) ? 0x71e3cf81U : fd_pchash( fd_rng_uint_roll( rng, (uint)text_cnt ) );
+      }
+    } else if( kind<88U ) { /* Indirect calls */
+      op = 0x8dUL;
+      if( !FD_VM_SBPF_CALLX_USES_SRC_REG( sbpf_version ) && !FD_VM_SBPF_CALLX_USES_DST_REG( sbpf_version ) ) imm = (uint)rand_reg( rng );
+    } else if( kind<93U ) { /* Set up a register for indirect calls or memory accesses */
+      op = 0xb7UL;
+      if( lddw_ok && pc+1UL<text_cnt ) {
+        ulong v = fd_rng_uint_roll( rng, 2U ) ? rand_region_ptr( rng )
+                : FD_VM_MEM_MAP_PROGRAM_REGION_START + 8UL*func[ fd_rng_ulong_roll( rng, func_cnt ) ];
+        p->text[ pc++ ] = fd_vm_instr( 0x18UL, dst, 0UL, 0, (uint)v );
+        p->text[ pc   ] = fd_vm_instr( 0x00UL, 0UL, 0UL, 0, (uint)(v>>32) );
+        continue;
+      }
+    } else if( kind<96U ) { /* Exit */
+      op = 0x95UL;
+    } else {               /* Anything */
+      op = fd_rng_ulong_roll( rng, 256UL );
+      if( op==0xd4UL || op==0xdcUL ) imm = 16U << fd_rng_uint_roll( rng, 3U );
+      if( op==0x18UL && ( !lddw_ok || pc+1UL>=text_cnt ) ) op = 0x00UL;
+    }
+    switch( op ) { /* fd_vm_validate rejects division by a zero immediate */
+    case 0x34: case 0x37: case 0x46: case 0x56: case 0x66: case 0x76: case 0x94: case 0x97: case 0xc6: case 0xd6: case 0xe6: case 0xf6:
+      if( !imm ) imm = 1U;
+      break;
+    default: break;
+    }
+    if( op==0x18UL ) { /* LDDW from the "anything" case */
+      p->text[ pc++ ] = fd_vm_instr( op, dst, src, off, imm );
+      p->text[ pc   ] = fd_vm_instr( 0x00UL, 0UL, 0UL, 0, rand_imm( rng ) );
+      continue;
+    }
+    p->text[ pc ] = fd_vm_instr( op, dst, src, off, imm );
+  }
+
+}
+
+static ulong test_cnt;
+
+static void
+run_prog( test_prog_t const *   p,
+          fd_vm_jit_t *         jit,
+          fd_sbpf_syscalls_t *  syscalls,
+          fd_sbpf_calldests_t * _calldests ) {
+
+  fd_sbpf_calldests_t * calldests = FD_VM_SBPF_ENABLE_STRICTER_ELF_HEADERS( p->sbpf_version ) ? NULL : _calldests;
+
+  int err = fd_vm_jit_compile( jit, p->text, p->text_cnt, 0UL, p->entry_pc, calldests, syscalls, p->sbpf_version );
+  FD_TEST( err==FD_VM_SUCCESS );
+
+  env_init( &env[0], p, calldests, syscalls );
+  env_init( &env[1], p, calldests, syscalls );
+
+  int err_interp = fd_vm_exec_notrace( env[0].vm );
+  int err_jit    = fd_vm_exec_jit    ( env[1].vm, jit );
+  FD_TEST( err_jit!=FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+
+  if( FD_UNLIKELY( err_interp!=err_jit || env_diff( &env[0], &env[1] ) ) ) {
+    FD_LOG_WARNING(( "mismatch (sbpf_version %lu, entry_pc %lu, entry_cu %lu, err %i %i)",
+                     p->sbpf_version, p->entry_pc, p->entry_cu, err_interp, err_jit ));
+    for( ulong pc=0UL; pc<p->text_cnt; pc++ ) FD_LOG_WARNING(( "%3lu: %016lx", pc, p->text[ pc ] ));
+    FD_LOG_ERR(( "FAIL" ));
+  }
+
+  test_cnt++;
+}
+
+/* Directed tests */
+
+static void
+test_api( fd_vm_jit_t *         jit,
+          fd_sbpf_syscalls_t *  syscalls,
+          fd_sbpf_calldests_t * calldests,
+          void *                jit_mem2,
+          ulong                 footprint ) {
+
+  ulong text[4] = {
+    fd_vm_instr( 0xb7UL, 0UL, 0UL, 0, 7U ),
+    fd_vm_instr( 0x07UL, 0UL, 0UL, 0, 5U ),
+    fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U ),
+    fd_vm_instr( 0x18UL, 1UL, 0UL, 0, 1U )  /* incomplete LDDW */
+  };
+
+  FD_TEST( fd_vm_jit_compile( NULL, text, 3UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_ERR_INVAL );
+  FD_TEST( fd_vm_jit_compile( jit, NULL, 3UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_ERR_INVAL );
+  FD_TEST( fd_vm_jit_compile( jit, text, 0UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_ERR_INVAL );
+  FD_TEST( fd_vm_jit_compile( jit, text, 3UL, 0UL, 3UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_ERR_INVAL );
+  FD_TEST( fd_vm_jit_compile( jit, text, TEXT_MAX+1UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_ERR_FULL );
+  FD_TEST( fd_vm_jit_compile( jit, text, 4UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V0 )==FD_VM_ERR_INCOMPLETE_LDQ );
+  FD_TEST( !fd_vm_jit_code_sz( jit ) );
+
+  ulong bad_end[2] = { fd_vm_instr( 0xdcUL, 0UL, 0UL, 0, 8U ), fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U ) };
+  FD_TEST( fd_vm_jit_compile( jit, bad_end, 2UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_ERR_INVALID_END_IMM );
+
+  static test_prog_t p[1];
+  memset( p, 0, sizeof(test_prog_t) );
+  memcpy( p->text, text, 3UL*sizeof(ulong) );
+  p->text_cnt     = 3UL;
+  p->sbpf_version = FD_SBPF_V3;
+  p->entry_cu     = 100UL;
+  p->region_cnt   = 1U;
+  p->writable     = 1U;
+
+  /* Not compiled */
+
+  env_init( &env[1], p, NULL, syscalls );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  FD_TEST( env[1].vm->ic==0UL && env[1].vm->cu==100UL );
+
+  /* Compiled for a different program */
+
+  FD_TEST( fd_vm_jit_compile( jit, p->text, 2UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  FD_TEST( fd_vm_jit_compile( jit, text, 3UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+
+  FD_TEST( fd_vm_jit_compile( jit, p->text, 3UL, 0UL, 0UL, NULL, syscalls, FD_SBPF_V3 )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_jit_code_sz( jit ) );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_SUCCESS );
+  FD_TEST( env[1].vm->reg[0]==12UL && env[1].vm->ic==3UL && env[1].vm->cu==97UL && env[1].vm->pc==2UL );
+
+  /* Copy the compiled image elsewhere */
+
+  ulong image_sz = fd_vm_jit_image_sz( jit );
+  FD_TEST( image_sz<=footprint );
+  memcpy( jit_mem2, jit, image_sz );
+  fd_vm_jit_t * jit2 = fd_vm_jit_join( jit_mem2 );
+  FD_TEST( jit2 );
+  env_init( &env[1], p, NULL, syscalls );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit2 )==FD_VM_SUCCESS );
+  FD_TEST( env[1].vm->reg[0]==12UL && env[1].vm->ic==3UL && env[1].vm->cu==97UL );
+
+  /* Same program at a different address (and different calldests)
+     only runs once the image is rebound to it */
+
+  static test_prog_t p2[1];
+  memcpy( p2, p, sizeof(test_prog_t) );
+  env_init( &env[1], p2, NULL, syscalls );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit2 )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  ulong syscalls_hash = fd_vm_jit_syscalls_hash( syscalls );
+  FD_TEST( fd_vm_jit_bind( jit2, p2->text, fd_sbpf_calldests_null( calldests ), syscalls_hash ) );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit2 )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  FD_TEST( fd_vm_jit_bind( jit2, p2->text, NULL, syscalls_hash ) );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit2 )==FD_VM_SUCCESS );
+  FD_TEST( env[1].vm->reg[0]==12UL && env[1].vm->ic==3UL && env[1].vm->cu==97UL );
+  env_init( &env[1], p, NULL, syscalls );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit2 )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  FD_TEST( fd_vm_jit_leave( jit2 )==jit_mem2 );
+
+  /* Traced vms are not supported */
+
+  env_init( &env[1], p, NULL, syscalls );
+  env[1].vm->trace = (fd_vm_trace_t *)1UL;
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  env[1].vm->trace = NULL;
+
+  /* A syscall whose key is the hash of a local function shadows it
+     (the interpreter checks the syscall map first) */
+
+  memset( p, 0, sizeof(test_prog_t) );
+  p->text[0]      = fd_vm_instr( 0x85UL, 0UL, 0UL, 0, fd_pchash( 3U ) ); /* call function at 3 */
+  p->text[1]      = fd_vm_instr( 0x07UL, 0UL, 0UL, 0, 1U  );             /* r0 += 1 */
+  p->text[2]      = fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U  );
+  p->text[3]      = fd_vm_instr( 0xb7UL, 0UL, 0UL, 0, 40U );             /* r0 = 40 */
+  p->text[4]      = fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U  );
+  p->text_cnt     = 5UL;
+  p->sbpf_version = FD_SBPF_V0;
+  p->entry_cu     = 100UL;
+  p->region_cnt   = 1U;
+  p->writable     = 1U;
+  p->reg[1]       = 2UL;
+  fd_sbpf_calldests_insert( fd_sbpf_calldests_null( calldests ), 3UL );
+
+  static fd_sbpf_syscalls_t _shadow[ FD_SBPF_SYSCALLS_SLOT_CNT ];
+  fd_sbpf_syscalls_t * shadow = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _shadow ) );
+  FD_TEST( shadow );
+  fd_sbpf_syscalls_t * syscall = fd_sbpf_syscalls_insert( shadow, (ulong)fd_pchash( 3U ) );
+  FD_TEST( syscall );
+  syscall->func = test_syscall_acc;
+  syscall->name = "test_shadow";
+
+  ulong const expected[2] = { 41UL, 3UL };
+  fd_sbpf_syscalls_t * maps[2] = { syscalls, shadow };
+  for( ulong i=0UL; i<2UL; i++ ) {
+    FD_TEST( fd_vm_jit_compile( jit, p->text, p->text_cnt, 0UL, 0UL, calldests, maps[i], p->sbpf_version )==FD_VM_SUCCESS );
+    env_init( &env[0], p, calldests, maps[i] );
+    env_init( &env[1], p, calldests, maps[i] );
+    FD_TEST( fd_vm_exec_notrace( env[0].vm      )==FD_VM_SUCCESS );
+    FD_TEST( fd_vm_exec_jit    ( env[1].vm, jit )==FD_VM_SUCCESS );
+    FD_TEST( !env_diff( &env[0], &env[1] ) );
+    FD_TEST( env[1].vm->reg[0]==expected[i] );
+  }
+
+  /* An image compiled against one syscall key set does not bind for
+     vms using another (the call above would resolve differently) */
+
+  ulong shadow_hash = fd_vm_jit_syscalls_hash( shadow );
+  FD_TEST( shadow_hash!=syscalls_hash );
+  FD_TEST( fd_vm_jit_syscalls_hash( NULL )==0UL );
+  FD_TEST( !fd_vm_jit_bind( jit, p->text, calldests, syscalls_hash ) );
+  env_init( &env[1], p, calldests, syscalls );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+  FD_TEST( fd_vm_jit_bind( jit, p->text, calldests, shadow_hash ) );
+  env_init( &env[1], p, calldests, shadow );
+  FD_TEST( fd_vm_exec_jit( env[1].vm, jit )==FD_VM_SUCCESS );
+  FD_TEST( env[1].vm->reg[0]==3UL );
+
+  FD_TEST( fd_sbpf_syscalls_delete( fd_sbpf_syscalls_leave( shadow ) )==_shadow );
+}
+
+/* bench_loop runs a simple counting loop with both engines */
+
+static void
+bench_loop( fd_vm_jit_t *        jit,
+            fd_sbpf_syscalls_t * syscalls ) {
+  static test_prog_t p[1];
+  memset( p, 0, sizeof(test_prog_t) );
+  ulong text[] = {
+    fd_vm_instr( 0xb7UL, 0UL, 0UL, 0, 0U       ), /* r0 = 0 */
+    fd_vm_instr( 0xb7UL, 2UL, 0UL, 0, 0U       ), /* r2 = 0 */
+    fd_vm_instr( 0x0fUL, 0UL, 2UL, 0, 0U       ), /* loop: r0 += r2 */
+    fd_vm_instr( 0x7bUL, 10UL, 0UL, -8, 0U     ), /* *(r10-8) = r0 */
+    fd_vm_instr( 0x07UL, 2UL, 0UL, 0, 1U       ), /* r2++ */
+    fd_vm_instr( 0xa5UL, 2UL, 0UL, -4, 100000U ), /* if r2<100000 goto loop */
+    fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U       )
+  };
+  p->text_cnt     = sizeof(text)/sizeof(ulong);
+  memcpy( p->text, text, sizeof(text) );
+  p->sbpf_version = FD_SBPF_V0;
+  p->entry_cu     = FD_VM_COMPUTE_UNIT_LIMIT;
+  p->region_cnt   = 1U;
+  p->writable     = 1U;
+
+  FD_TEST( fd_vm_jit_compile( jit, p->text, p->text_cnt, 0UL, 0UL, NULL, syscalls, p->sbpf_version )==FD_VM_SUCCESS );
+
+  long dt_interp = 0L;
+  long dt_jit    = 0L;
+  for( ulong iter=0UL; iter<8UL; iter++ ) {
+    env_init( &env[0], p, NULL, syscalls );
+    env_init( &env[1], p, NULL, syscalls );
+    dt_interp -= fd_log_wallclock(); FD_TEST( fd_vm_exec_notrace( env[0].vm             )==FD_VM_SUCCESS ); dt_interp += fd_log_wallclock();
+    dt_jit    -= fd_log_wallclock(); FD_TEST( fd_vm_exec_jit    ( env[1].vm, jit        )==FD_VM_SUCCESS ); dt_jit    += fd_log_wallclock();
+    FD_TEST( !env_diff( &env[0], &env[1] ) );
+  }
+  FD_TEST( env[1].vm->reg[0]==4999950000UL );
+  double ic = (double)(8UL*env[1].vm->ic);
+  FD_LOG_NOTICE(( "loop: interp %.3f ns/instr, jit %.3f ns/instr", (double)dt_interp/ic, (double)dt_jit/ic ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-max", NULL, 20000UL );
+
+  ulong  footprint = fd_vm_jit_footprint( TEXT_MAX );
+  FD_TEST( footprint );
+  FD_TEST( !fd_vm_jit_footprint( 0UL ) );
+  void * jit_mem = mmap( NULL, 2UL*footprint, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+  if( FD_UNLIKELY( jit_mem==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "skip: unable to map executable memory" ));
+    fd_halt();
+    return 0;
+  }
+  void * jit_mem2 = (uchar *)jit_mem + footprint;
+
+  FD_TEST( !fd_vm_jit_new( NULL, TEXT_MAX ) );
+  FD_TEST( !fd_vm_jit_new( (uchar *)jit_mem+1UL, TEXT_MAX ) );
+  FD_TEST( !fd_vm_jit_new( jit_mem, 0UL ) );
+  FD_TEST( !fd_vm_jit_join( jit_mem2 ) );
+  FD_TEST( fd_vm_jit_new( jit_mem,  TEXT_MAX )==jit_mem  );
+  FD_TEST( fd_vm_jit_new( jit_mem2, TEXT_MAX )==jit_mem2 );
+  fd_vm_jit_t * jit = fd_vm_jit_join( jit_mem );
+  FD_TEST( jit );
+
+  static fd_sbpf_syscalls_t _syscalls[ FD_SBPF_SYSCALLS_SLOT_CNT ];
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) );
+  FD_TEST( syscalls );
+  FD_TEST( fd_vm_syscall_register( syscalls, "test_acc",  test_syscall_acc  )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_syscall_register( syscalls, "test_fail", test_syscall_fail )==FD_VM_SUCCESS );
+
+  void * calldests_mem = aligned_alloc( fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint( TEXT_MAX ) );
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, TEXT_MAX ) );
+  FD_TEST( calldests );
+
+  for( ulong i=0UL; i<2UL; i++ ) FD_TEST( fd_vm_join( fd_vm_new( env[i].vm ) )==env[i].vm );
+
+  test_api( jit, syscalls, calldests, jit_mem2, footprint );
+  FD_LOG_NOTICE(( "pass: api" ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+  static test_prog_t prog[1];
+  for( ulong iter=0UL; iter<iter_max; iter++ ) {
+    ulong sbpf_version = iter % FD_SBPF_VERSION_COUNT;
+    test_syscall_cu = fd_rng_uint_roll( rng, 20U );
+    gen_prog( prog, fd_sbpf_calldests_null( calldests ), rng, sbpf_version );
+    run_prog( prog, jit, syscalls, calldests );
+  }
+  FD_LOG_NOTICE(( "pass: differential (%lu programs)", test_cnt ));
+
+  bench_loop( jit, syscalls );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  free( fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) ) );
+  FD_TEST( fd_sbpf_syscalls_delete( fd_sbpf_syscalls_leave( syscalls ) )==_syscalls );
+  FD_TEST( fd_vm_jit_delete( fd_vm_jit_leave( jit ) )==jit_mem );
+  FD_TEST( !fd_vm_jit_join( jit_mem ) );
+  munmap( jit_mem, 2UL*footprint );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,4 @@
+#define FIREDANCER_COMMIT_REF_CSTR "939f80efa110678c89f9b14135e154e32e685af2"
+#define FD_VERSION_MAJOR 0
+#define FD_VERSION_MINOR 1
+#define FD_VERSION_PATCH 1
@@ -1,4 +1,4 @@
-$(call add-hdrs,fd_bplus.c fd_deque.c fd_deque_dynamic.c fd_dlist.c fd_heap.c fd_map.c fd_map_chain.c fd_map_dynamic.c fd_map_giant.c fd_map_chain_para.c fd_map_slot.c fd_map_slot_para.c fd_pool.c fd_pool_para.c fd_prq.c fd_queue.c fd_queue_dynamic.c fd_set.c fd_set_dynamic.c fd_smallset.c fd_sort.c fd_stack.c fd_treap.c fd_vec.c fd_voff.c)
+$(call add-hdrs,fd_bplus.c fd_deque.c fd_deque_dynamic.c fd_dlist.c fd_heap.c fd_map.c fd_map_chain.c fd_map_dynamic.c fd_map_giant.c fd_map_group.c fd_map_chain_para.c fd_map_slot.c fd_map_slot_para.c fd_pool.c fd_pool_para.c fd_prq.c fd_queue.c fd_queue_dynamic.c fd_set.c fd_set_dynamic.c fd_smallset.c fd_sort.c fd_stack.c fd_treap.c fd_vec.c fd_voff.c)
 $(call add-objs,fd_map_util,fd_util)
 $(call make-unit-test,test_bplus,test_bplus,fd_util)
 $(call make-unit-test,test_deque,test_deque,fd_util)
@@ -12,6 +12,7 @@ $(call make-unit-test,test_map_chain_multi,test_map_chain_multi,fd_util)
 $(call make-unit-test,test_map_dynamic,test_map_dynamic,fd_util)
 $(call make-unit-test,test_map_giant,test_map_giant,fd_util)
 $(call make-unit-test,test_map_giant_mem,test_map_giant_mem,fd_util)
+$(call make-unit-test,test_map_group,test_map_group,fd_util)
 ifdef FD_HAS_HOSTED # FIXME: HMMM ....
 $(call make-unit-test,test_map_giant_concur,test_map_giant_concur,fd_util)
 endif
@@ -45,6 +46,7 @@ $(call run-unit-test,test_map_chain_multi)
 $(call run-unit-test,test_map_dynamic)
 $(call run-unit-test,test_map_giant)
 $(call run-unit-test,test_map_giant_mem)
+$(call run-unit-test,test_map_group)
 $(call run-unit-test,test_map_chain_para)
 $(call run-unit-test,test_map_perfect)
 $(call run-unit-test,test_map_slot)
@@ -0,0 +1,852 @@
+/* Declare ultra high performance dynamic key-val maps of bounded
+   run time size based on open addressing with SIMD group probing (a la
+   "Swiss tables").  This is a drop in replacement for fd_map_dynamic
+   (same MAP_* customization macros and same API) that degrades much
+   more gracefully at high load factors.
+
+   Each slot has a one byte control tag that is either EMPTY, DELETED
+   or holds 7 bits of the slot key's hash.  A query computes the key's
+   hash, uses the upper bits to pick a starting slot and then scans the
+   control tags of MAP_GROUP_WIDTH consecutive slots at a time with a
+   handful of SIMD instructions.  Only slots whose tag matches the low 7
+   bits of the key's hash (~1/128 false positive rate) have their keys
+   compared.  A scan stops at the first group that has an EMPTY tag.
+   Groups are probed with a triangular (quadratic) sequence.  As such,
+   unlike the linear probing of fd_map_dynamic, long probe sequences
+   from primary clustering are rare and expensive key comparisons are
+   done almost only for the slot that matches.  The map is usable at
+   load factors up to ~7/8 (vs the ~1/2 recommended for
+   fd_map_dynamic).  The tradeoff is that the control tags are stored
+   separately from the slots so a lookup touches a control cache line
+   in addition to the slot's cache line.
+
+   Typical usage:
+
+     struct mymap {
+       ulong key;  // Technically "MAP_KEY_T  MAP_KEY;"  (default is ulong key)
+       uint  hash; // Technically "MAP_HASH_T MAP_HASH;" (default is uint  hash), ==mymap_hash(key)
+       ... key and hash can be located arbitrarily in struct
+       ... hash is not required if MAP_MEMOIZE is zero
+       ... the rest of the struct is POD state/values associated with key
+       ... the mapping of a key to a map slot is arbitrary and might
+       ... change over the lifetime of the key
+     };
+
+     typedef struct mymap mymap_t;
+
+     #define MAP_NAME mymap
+     #define MAP_T    mymap_t
+     #include "util/tmpl/fd_map_group.c"
+
+  will declare the same static inline APIs as fd_map_dynamic as a
+  header only style library in the compilation unit:
+
+    ulong     mymap_align    ( void            );
+    ulong     mymap_footprint( int lg_slot_cnt );
+    void *    mymap_new      ( void *    shmem, int lg_slot_cnt, ulong seed );
+    mymap_t * mymap_join     ( void *    shmap ); // Indexed [0,2^lg_slot_cnt)
+    void *    mymap_leave    ( mymap_t * map   );
+    void *    mymap_delete   ( void *    shmap );
+
+    ulong mymap_key_cnt    ( mymap_t const * map ); // In [0,key_max]
+    ulong mymap_key_max    ( mymap_t const * map ); // == 2^lg_slot_cnt - 1
+    int   mymap_lg_slot_cnt( mymap_t const * map ); // In [MAP_GROUP_LG,63]
+    ulong mymap_slot_cnt   ( mymap_t const * map ); // == 2^lg_slot_cnt
+    ulong mymap_seed       ( mymap_t const * map );
+    ulong mymap_slot_idx   ( mymap_t const * map, mymap_t const * slot );
+
+    ulong mymap_key_null ( void );
+    int   mymap_key_inval( ulong key );
+    int   mymap_key_equal( ulong k0, ulong k1 );
+    uint  mymap_key_hash ( ulong key, ulong seed );
+
+    mymap_t * mymap_insert( mymap_t * map, ulong key );
+    void      mymap_remove( mymap_t * map, mymap_t * entry );
+    void      mymap_clear ( mymap_t * map );
+    mymap_t * mymap_query ( mymap_t * map, ulong key, mymap_t * null );
+
+  See fd_map_dynamic for details.  Differences:
+
+  - lg_slot_cnt is rounded up to at least MAP_GROUP_LG (the footprint
+    reflects this and mymap_lg_slot_cnt returns the rounded value).
+
+  - The low 7 bits of a key's hash are used as its control tag and the
+    remaining bits select its starting slot.  So MAP_HASH_T should
+    have at least lg_slot_cnt+7 bits of entropy.
+
+  - Insert never moves existing entries.  Remove marks the removed
+    slot's tag as DELETED (tombstone) unless it can prove no probe
+    sequence passes through the slot.  When tombstones exceed 1/8 of
+    the slots, remove rehashes the map in place (amortized O(1)), which
+    moves entries via MAP_MOVE.  Like fd_map_dynamic, pointers returned
+    by insert and query are thus valid until any remove or leave.  As
+    in fd_map_dynamic, the key of a free slot is MAP_KEY_NULL, so
+    iterating over all slots and skipping invalid keys works.
+
+  - Queries, inserts and removes are bounded by slot_cnt/MAP_GROUP_WIDTH
+    group probes worst case (regardless of tombstones).
+
+  - MAP_QUERY_OPT is accepted for source compatibility but ignored.
+
+  If MAP_CONCUR is non-zero, the map additionally supports lockless
+  speculative queries concurrent with writers (modeled on the
+  query_try / query_test API of fd_map_slot_para).  The map has a
+  version number that writers increment around their operations:
+
+    // mymap_lock blocks the caller until it has exclusive write access
+    // to the map.  mymap_unlock releases it.  All mymap_insert,
+    // mymap_remove, mymap_clear calls and writes to entries found by
+    // mymap_query by a writer (e.g. initializing the values of an
+    // inserted entry) should be done while holding the lock.
+
+    void mymap_lock  ( mymap_t * map );
+    void mymap_unlock( mymap_t * map );
+
+    // mymap_query_try speculatively queries the map for key and returns
+    // a pointer to the entry holding key (or null if key was not found
+    // or a writer holds the lock).  *_version is set to the map version
+    // observed at the start of the query.  mymap_query_test returns
+    // FD_MAP_SUCCESS if no writer held the lock at any point since the
+    // corresponding query_try started (i.e. the query result and
+    // anything speculatively read from the entry are valid) and
+    // FD_MAP_ERR_AGAIN otherwise.  E.g.:
+
+    for(;;) {
+      ulong           version;
+      mymap_t const * e = mymap_query_try( map, key, NULL, &version );
+      ulong           v = e ? e->val : 0UL;
+      if( FD_LIKELY( !mymap_query_test( map, version ) ) ) { ... use e!=NULL and v ...; break; }
+      FD_SPIN_PAUSE();
+    }
+
+    mymap_t const * mymap_query_try ( mymap_t const * map, ulong key, mymap_t const * null, ulong * _version );
+    int             mymap_query_test( mymap_t const * map, ulong version );
+
+  IMPORTANT SAFETY TIP!  As in fd_map_slot_para, speculative readers
+  should be prepared to see arbitrary and inconsistent entry values
+  and should not commit any results until query_test succeeds.  The
+  version is map wide, so this is best suited for read mostly maps.
+
+  You can do this as often as you like in a compilation unit to get
+  different types of maps.  Since it is all static inline, it is fine
+  to do this in a header too. */
+
+#include "../bits/fd_bits.h"
+#include "fd_map.h"
+#include <stddef.h>
+
+#ifndef offsetof
+#  define offsetof(TYPE,MEMB) ((ulong)((TYPE*)0)->MEMB)
+#endif
+
+#ifndef MAP_NAME
+#error "Define MAP_NAME"
+#endif
+
+/* A MAP_T should be something reasonable to shallow copy with
+   the fields described above. */
+
+#ifndef MAP_T
+#error "Define MAP_T struct"
+#endif
+
+/* MAP_HASH_T should be an unsigned integral type. */
+
+#ifndef MAP_HASH_T
+#define MAP_HASH_T uint
+#endif
+
+/* MAP_HASH is the MAP_T hash field name.  Defaults to hash. */
+
+#ifndef MAP_HASH
+#define MAP_HASH hash
+#endif
+
+/* MAP_KEY_T should be something reasonable to pass to a static inline
+   by value, assign to MAP_KEY_NULL, compare for equality and copy.
+   E.g. a uint, ulong, __m128i, etc. */
+
+#ifndef MAP_KEY_T
+#define MAP_KEY_T ulong
+#else
+#if !defined(MAP_KEY_NULL) || !defined(MAP_KEY_INVAL) || !defined(MAP_KEY_EQUAL) || !defined(MAP_KEY_EQUAL_IS_SLOW) || !defined(MAP_KEY_HASH)
+#error "Define MAP_KEY_NULL, MAP_KEY_INVAL, MAP_KEY_EQUAL, MAP_KEY_EQUAL_IS_SLOW, and MAP_KEY_HASH if using a custom MAP_KEY_T"
+#endif
+#endif
+
+/* MAP_KEY is the MAP_T key field name.  Defaults to key. */
+
+#ifndef MAP_KEY
+#define MAP_KEY key
+#endif
+
+/* MAP_KEY_NULL is a key that will never be inserted. */
+
+#ifndef MAP_KEY_NULL
+#define MAP_KEY_NULL 0UL
+#endif
+
+/* MAP_KEY_INVAL returns 1 if k0 is key that will never be inserted
+   and zero otherwise.  Note that MAP_KEY_INVAL( MAP_KEY_NULL ) should
+   be true.  This should be generally fast. */
+
+#ifndef MAP_KEY_INVAL
+#define MAP_KEY_INVAL(k) !(k)
+#endif
+
+/* MAP_KEY_EQUAL returns 0/1 if k0 is the same/different */
+
+#ifndef MAP_KEY_EQUAL
+#define MAP_KEY_EQUAL(k0,k1) (k0)==(k1)
+#endif
+
+/* If MAP_KEY_EQUAL_IS_SLOW is slow (e.g. variable length string
+   compare, large buffer compares, etc), set MAP_KEY_EQUAL_IS_SLOW to
+   non-zero.  Then, if MAP_MEMOIZE (below) is set, precomputed key
+   hashes will be used to filter the (already rare) control tag false
+   positives before key comparisons. */
+
+#ifndef MAP_KEY_EQUAL_IS_SLOW
+#define MAP_KEY_EQUAL_IS_SLOW 0
+#endif
+
+/* MAP_KEY_HASH takes a key and maps it into MAP_HASH_T uniform pseudo
+   randomly. */
+
+#ifndef MAP_KEY_HASH
+#define MAP_KEY_HASH(key,seed) ((MAP_HASH_T)fd_ulong_hash( (key) ^ (seed) ))
+#endif
+
+/* MAP_KEY_MOVE moves the contents from src to dst.  Non-POD key types
+   need to customize this accordingly (and handle the case of
+   ks==MAP_KEY_NULL).  Defaults to shallow copy. */
+
+#ifndef MAP_KEY_MOVE
+#define MAP_KEY_MOVE(kd,ks) (kd)=(ks)
+#endif
+
+/* MAP_MOVE moves the contents of a MAP_T from src to dst.  Non-POD key
+   types need to customize this accordingly.  Defaults to shallow copy. */
+
+#ifndef MAP_MOVE
+#define MAP_MOVE(d,s) (d)=(s)
+#endif
+
+/* If MAP_MEMOIZE is defined to non-zero, the MAP_T requires a
+   "map_hash" field that will hold the value of the MAP_KEY_HASH of the
+   MAP_T's MAP_KEY when the map slot is not empty (undefined otherwise).
+   This is useful for accelerating user operations that might need a
+   hash of the key and for accelerating in place rehashing.  It is also
+   potentially useful as a way to accelerate slow key comparison
+   operations (see MAP_KEY_EQUAL_IS_SLOW). */
+
+#ifndef MAP_MEMOIZE
+#define MAP_MEMOIZE 1
+#endif
+
+/* MAP_QUERY_OPT is accepted for compatibility with fd_map_dynamic and
+   ignored. */
+
+#ifndef MAP_QUERY_OPT
+#define MAP_QUERY_OPT 0
+#endif
+
+/* MAP_GROUP_WIDTH is the number of control tags scanned per group
+   probe.  Supported values are 8 (portable SWAR), 16 (requires
+   FD_HAS_SSE), 32 (requires FD_HAS_AVX) and 64 (requires
+   FD_HAS_AVX512).  Defaults to 16 on targets with SSE and 8 otherwise.
+   MAP_GROUP_LG is log2 MAP_GROUP_WIDTH. */
+
+#ifndef MAP_GROUP_WIDTH
+#if FD_HAS_SSE
+#define MAP_GROUP_WIDTH 16
+#else
+#define MAP_GROUP_WIDTH 8
+#endif
+#endif
+
+#if MAP_GROUP_WIDTH==8
+#define MAP_GROUP_LG 3
+#elif MAP_GROUP_WIDTH==16 && FD_HAS_SSE
+#define MAP_GROUP_LG 4
+#include "../simd/fd_sse.h"
+#elif MAP_GROUP_WIDTH==32 && FD_HAS_AVX
+#define MAP_GROUP_LG 5
+#include "../simd/fd_avx.h"
+#elif MAP_GROUP_WIDTH==64 && FD_HAS_AVX512
+#define MAP_GROUP_LG 6
+#include "../simd/fd_avx512.h"
+#else
+#error "Unsupported MAP_GROUP_WIDTH for this target"
+#endif
+
+/* If MAP_CONCUR is non-zero, the map supports lockless speculative
+   queries concurrent with (lock serialized) writers as described
+   above. */
+
+#ifndef MAP_CONCUR
+#define MAP_CONCUR 0
+#endif
+
+#if FD_TMPL_USE_HANDHOLDING
+#include "../log/fd_log.h"
+#endif
+
+/* Implementation *****************************************************/
+
+#define MAP_(n) FD_EXPAND_THEN_CONCAT3(MAP_NAME,_,n)
+
+/* Control tags.  A full slot's tag is in [0,127] (high bit clear).
+   EMPTY and DELETED both have the high bit set.  The control tag array
+   is stored immediately after the slot array and has slot_cnt +
+   MAP_GROUP_WIDTH-1 entries.  The last MAP_GROUP_WIDTH-1 are copies of
+   the first MAP_GROUP_WIDTH-1 such that a group can be loaded at any
+   slot without wrapping. */
+
+#define MAP_PRIVATE_CTRL_EMPTY   ((uchar)0x80)
+#define MAP_PRIVATE_CTRL_DELETED ((uchar)0xFE)
+
+struct MAP_(private) {
+  ulong key_cnt;     /* == number of keys currently in map */
+  ulong tomb_cnt;    /* == number of DELETED control tags */
+  ulong seed;        /* Hash seed, arbitrary */
+  ulong slot_mask;   /* == key_max == 2^lg_slot_cnt - 1 */
+  int   lg_slot_cnt; /* In [MAP_GROUP_LG,63] */
+# if MAP_CONCUR
+  ulong version;     /* Odd while a writer holds the map lock */
+# endif
+  MAP_T slot[];      /* Actually 2^lg_slot_cnt in size, followed by the control tags */
+};
+
+typedef struct MAP_(private) MAP_(private_t);
+
+FD_PROTOTYPES_BEGIN
+
+/* Private APIs *******************************************************/
+
+/* private_from_slot return a pointer to the map_private given a pointer
+   to the map's slot.  private_from_map_const also provided for
+   const-correctness purposes. */
+
+FD_FN_CONST static inline MAP_(private_t) *
+MAP_(private_from_slot)( MAP_T * slot ) {
+  ulong slot_ofs = offsetof( MAP_(private_t), slot );
+  return (MAP_(private_t) *)( (ulong)slot - (ulong)slot_ofs );
+}
+
+FD_FN_CONST static inline MAP_(private_t) const *
+MAP_(private_from_slot_const)( MAP_T const * slot ) {
+  ulong slot_ofs = offsetof( MAP_(private_t), slot );
+  return (MAP_(private_t) const *)( (ulong)slot - (ulong)slot_ofs );
+}
+
+/* private_lg_slot_cnt returns the lg_slot_cnt actually used for a
+   requested lg_slot_cnt. */
+
+FD_FN_CONST static inline int
+MAP_(private_lg_slot_cnt)( int lg_slot_cnt ) {
+  return fd_int_max( lg_slot_cnt, MAP_GROUP_LG );
+}
+
+/* private_ctrl returns the location of the control tags for a map with
+   the given slot_mask. */
+
+FD_FN_CONST static inline uchar *
+MAP_(private_ctrl)( MAP_T const * map,
+                    ulong         slot_mask ) {
+  return (uchar *)(map + slot_mask + 1UL);
+}
+
+/* private_ctrl_set sets the control tag of slot to c (and its copy if
+   slot is in [0,MAP_GROUP_WIDTH-1)). */
+
+static inline void
+MAP_(private_ctrl_set)( uchar * ctrl,
+                        ulong   slot_mask,
+                        ulong   slot,
+                        uchar   c ) {
+  ctrl[ slot ] = c;
+  ctrl[ ((slot - (ulong)(MAP_GROUP_WIDTH-1)) & slot_mask) + (ulong)(MAP_GROUP_WIDTH-1) ] = c;
+}
+
+/* Get the starting slot and control tag for a key hash */
+
+FD_FN_CONST static inline ulong MAP_(private_start)( MAP_HASH_T hash, ulong slot_mask ) { return (((ulong)hash) >> 7) & slot_mask; }
+FD_FN_CONST static inline uchar MAP_(private_tag)  ( MAP_HASH_T hash                  ) { return (uchar)(((ulong)hash) & 127UL); }
+
+/* private_match{,_empty,_free} return a bit mask indicating which slots
+   of the group of MAP_GROUP_WIDTH control tags starting at g have tag
+   tag, are EMPTY and are EMPTY or DELETED respectively.  Slot i of the
+   group is indicated by bit i<<MAP_PRIVATE_MASK_SHIFT.  The portable
+   implementation can report false positive matches for tag (but never
+   for EMPTY or DELETED), which is fine as matches are verified with a
+   key comparison. */
+
+#if MAP_GROUP_WIDTH==8
+
+#define MAP_PRIVATE_MASK_SHIFT 3
+
+FD_FN_PURE static inline ulong
+MAP_(private_match)( uchar const * g,
+                     uchar         tag ) {
+  ulong x = FD_LOAD( ulong, g ) ^ (0x0101010101010101UL*(ulong)tag);
+  return (x - 0x0101010101010101UL) & ~x & 0x8080808080808080UL;
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_empty)( uchar const * g ) {
+  ulong x = FD_LOAD( ulong, g );
+  return x & ~(x<<6) & 0x8080808080808080UL; /* EMPTY is the only tag with bit 7 set and bit 1 clear */
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_free)( uchar const * g ) {
+  return FD_LOAD( ulong, g ) & 0x8080808080808080UL;
+}
+
+#elif MAP_GROUP_WIDTH==16
+
+#define MAP_PRIVATE_MASK_SHIFT 0
+
+FD_FN_PURE static inline ulong
+MAP_(private_match)( uchar const * g,
+                     uchar         tag ) {
+  return (ulong)(uint)_mm_movemask_epi8( vb_eq( vb_ldu( g ), vb_bcast( tag ) ) );
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_empty)( uchar const * g ) {
+  return (ulong)(uint)_mm_movemask_epi8( vb_eq( vb_ldu( g ), vb_bcast( MAP_PRIVATE_CTRL_EMPTY ) ) );
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_free)( uchar const * g ) {
+  return (ulong)(uint)_mm_movemask_epi8( vb_ldu( g ) );
+}
+
+#elif MAP_GROUP_WIDTH==32
+
+#define MAP_PRIVATE_MASK_SHIFT 0
+
+FD_FN_PURE static inline ulong
+MAP_(private_match)( uchar const * g,
+                     uchar         tag ) {
+  return (ulong)(uint)_mm256_movemask_epi8( wb_eq( wb_ldu( g ), wb_bcast( tag ) ) );
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_empty)( uchar const * g ) {
+  return (ulong)(uint)_mm256_movemask_epi8( wb_eq( wb_ldu( g ), wb_bcast( MAP_PRIVATE_CTRL_EMPTY ) ) );
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_free)( uchar const * g ) {
+  return (ulong)(uint)_mm256_movemask_epi8( wb_ldu( g ) );
+}
+
+#else /* MAP_GROUP_WIDTH==64 */
+
+#define MAP_PRIVATE_MASK_SHIFT 0
+
+FD_FN_PURE static inline ulong
+MAP_(private_match)( uchar const * g,
+                     uchar         tag ) {
+  return wwb_eq( _mm512_loadu_si512( g ), wwb_bcast( tag ) );
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_empty)( uchar const * g ) {
+  return wwb_eq( _mm512_loadu_si512( g ), wwb_bcast( MAP_PRIVATE_CTRL_EMPTY ) );
+}
+
+FD_FN_PURE static inline ulong
+MAP_(private_match_free)( uchar const * g ) {
+  return (ulong)_mm512_movepi8_mask( _mm512_loadu_si512( g ) );
+}
+
+#endif
+
+/* private_mask_{lo,hi} return the group index of the lowest / highest
+   slot indicated by non-zero mask m. */
+
+FD_FN_CONST static inline ulong MAP_(private_mask_lo)( ulong m ) { return ((ulong)fd_ulong_find_lsb( m )) >> MAP_PRIVATE_MASK_SHIFT; }
+FD_FN_CONST static inline ulong MAP_(private_mask_hi)( ulong m ) { return ((ulong)fd_ulong_find_msb( m )) >> MAP_PRIVATE_MASK_SHIFT; }
+
+/* private_find_free returns the first EMPTY or DELETED slot in the
+   probe sequence for hash.  Assumes the map has at least one such slot
+   (the probe sequence covers every slot in slot_cnt/MAP_GROUP_WIDTH
+   group probes). */
+
+FD_FN_PURE static inline ulong
+MAP_(private_find_free)( uchar const * ctrl,
+                         ulong         slot_mask,
+                         MAP_HASH_T    hash ) {
+  ulong pos    = MAP_(private_start)( hash, slot_mask );
+  ulong stride = 0UL;
+  for(;;) {
+    ulong m = MAP_(private_match_free)( ctrl + pos );
+    if( FD_LIKELY( m ) ) return (pos + MAP_(private_mask_lo)( m )) & slot_mask;
+    stride += (ulong)MAP_GROUP_WIDTH;
+    pos     = (pos + stride) & slot_mask;
+  }
+}
+
+/* private_rehash rehashes all the keys in the map in place, eliminating
+   all tombstones.  This is the in place "drop deletes" algorithm used
+   by Swiss tables: all full slots are marked DELETED (i.e. needs
+   rehash) and all other slots are marked EMPTY.  Then, for each slot
+   that needs rehash, we find the first free slot in its key's probe
+   sequence.  If that is in the same probe group, the entry stays put.
+   If it is EMPTY, the entry is moved there.  Otherwise, it holds an
+   entry that needs rehash and the two are swapped (and we process the
+   swapped in entry next). */
+
+FD_FN_UNUSED static void /* Work around -Winline */
+MAP_(private_rehash)( MAP_T * map ) {
+  MAP_(private_t) * hdr = MAP_(private_from_slot)( map );
+
+  ulong   slot_mask = hdr->slot_mask;
+  ulong   slot_cnt  = slot_mask + 1UL;
+  uchar * ctrl      = MAP_(private_ctrl)( map, slot_mask );
+
+  for( ulong slot=0UL; slot<slot_cnt; slot++ )
+    ctrl[ slot ] = (ctrl[ slot ] & (uchar)0x80) ? MAP_PRIVATE_CTRL_EMPTY : MAP_PRIVATE_CTRL_DELETED;
+  for( ulong slot=0UL; slot<(ulong)(MAP_GROUP_WIDTH-1); slot++ ) ctrl[ slot_cnt + slot ] = ctrl[ slot ];
+
+  for( ulong slot=0UL; slot<slot_cnt; slot++ ) {
+    if( ctrl[ slot ]!=MAP_PRIVATE_CTRL_DELETED ) continue;
+
+#   if MAP_MEMOIZE
+    MAP_HASH_T hash = map[ slot ].MAP_HASH;
+#   else
+    MAP_HASH_T hash = (MAP_KEY_HASH( (map[ slot ].MAP_KEY), (hdr->seed) ));
+#   endif
+    uchar tag   = MAP_(private_tag)( hash );
+    ulong start = MAP_(private_start)( hash, slot_mask );
+    ulong dst   = MAP_(private_find_free)( ctrl, slot_mask, hash );
+
+    if( FD_LIKELY( (((slot-start) & slot_mask) >> MAP_GROUP_LG)==(((dst-start) & slot_mask) >> MAP_GROUP_LG) ) ) {
+      MAP_(private_ctrl_set)( ctrl, slot_mask, slot, tag );
+      continue;
+    }
+
+    if( ctrl[ dst ]==MAP_PRIVATE_CTRL_EMPTY ) {
+      MAP_(private_ctrl_set)( ctrl, slot_mask, dst, tag );
+      MAP_MOVE( map[ dst ], map[ slot ] );
+      map[ slot ].MAP_KEY = (MAP_KEY_NULL);
+      MAP_(private_ctrl_set)( ctrl, slot_mask, slot, MAP_PRIVATE_CTRL_EMPTY );
+    } else {
+      MAP_(private_ctrl_set)( ctrl, slot_mask, dst, tag );
+      MAP_T tmp;
+      MAP_MOVE( tmp,         map[ dst  ] );
+      MAP_MOVE( map[ dst  ], map[ slot ] );
+      MAP_MOVE( map[ slot ], tmp         );
+      slot--; /* Process the entry swapped into slot (wraps and unwraps for slot 0) */
+    }
+  }
+
+  hdr->tomb_cnt = 0UL;
+}
+
+/* Public APIS ********************************************************/
+
+FD_FN_CONST static inline ulong MAP_(align)( void ) { return alignof(MAP_(private_t)); }
+
+FD_FN_CONST static inline ulong
+MAP_(footprint)( int lg_slot_cnt ) {
+  ulong slot_cnt = 1UL << MAP_(private_lg_slot_cnt)( lg_slot_cnt );
+  return fd_ulong_align_up( fd_ulong_align_up( sizeof(MAP_(private_t)), alignof(MAP_T) ) + sizeof(MAP_T)*slot_cnt
+                            + slot_cnt + (ulong)(MAP_GROUP_WIDTH-1), alignof(MAP_(private_t)) );
+}
+
+static inline void
+MAP_(clear)( MAP_T * map ) {
+  MAP_(private_t) * hdr = MAP_(private_from_slot)( map );
+  hdr->key_cnt  = 0UL;
+  hdr->tomb_cnt = 0UL;
+  ulong   slot_cnt = hdr->slot_mask + 1UL;
+  MAP_T * slot     = hdr->slot;
+  for( ulong slot_idx=0UL; slot_idx<slot_cnt; slot_idx++ )
+    slot[ slot_idx ].MAP_KEY = (MAP_KEY_NULL);
+  memset( MAP_(private_ctrl)( slot, hdr->slot_mask ), MAP_PRIVATE_CTRL_EMPTY, slot_cnt + (ulong)(MAP_GROUP_WIDTH-1) );
+}
+
+static inline void *
+MAP_(new)( void *  shmem,
+           int     lg_slot_cnt,
+           ulong   seed ) {
+# if FD_TMPL_USE_HANDHOLDING
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, MAP_(align)() ) ) ) FD_LOG_CRIT(( "unaligned shmem" ));
+  if( FD_UNLIKELY( (lg_slot_cnt<0) | (lg_slot_cnt>63)                  ) ) FD_LOG_CRIT(( "invalid lg_slot_cnt" ));
+# endif
+  lg_slot_cnt = MAP_(private_lg_slot_cnt)( lg_slot_cnt );
+
+  MAP_(private_t) * map = (MAP_(private_t) *)shmem;
+
+  map->seed        = seed;
+  map->slot_mask   = (1UL<<lg_slot_cnt) - 1UL;
+  map->lg_slot_cnt = lg_slot_cnt;
+# if MAP_CONCUR
+  map->version     = 0UL;
+# endif
+
+  MAP_T * slot = map->slot; FD_COMPILER_FORGET( slot );
+  MAP_(clear)( slot );
+
+  return map;
+}
+
+static inline MAP_T *
+MAP_(join)( void * shmap ) {
+  MAP_(private_t) * map = (MAP_(private_t) *)shmap;
+  MAP_T * slot = map->slot; FD_COMPILER_FORGET( slot );
+  return slot;
+}
+
+static inline void * MAP_(leave) ( MAP_T * slot  ) { return (void *)MAP_(private_from_slot)( slot ); }
+static inline void * MAP_(delete)( void *  shmap ) { return shmap; }
+
+FD_FN_PURE static inline ulong MAP_(key_cnt)    ( MAP_T const * slot ) { return MAP_(private_from_slot_const)( slot )->key_cnt;       }
+FD_FN_PURE static inline ulong MAP_(key_max)    ( MAP_T const * slot ) { return MAP_(private_from_slot_const)( slot )->slot_mask;     }
+FD_FN_PURE static inline int   MAP_(lg_slot_cnt)( MAP_T const * slot ) { return MAP_(private_from_slot_const)( slot )->lg_slot_cnt;   }
+FD_FN_PURE static inline ulong MAP_(slot_cnt)   ( MAP_T const * slot ) { return MAP_(private_from_slot_const)( slot )->slot_mask+1UL; }
+FD_FN_PURE static inline ulong MAP_(seed)       ( MAP_T const * slot ) { return MAP_(private_from_slot_const)( slot )->seed;          }
+
+FD_FN_CONST static inline ulong
+MAP_(slot_idx)( MAP_T const * map, MAP_T const * entry ) {
+# if FD_TMPL_USE_HANDHOLDING
+  if( FD_UNLIKELY( ((ulong)(entry-map)>=MAP_(slot_cnt)( map )) | (map>entry) ) ) FD_LOG_CRIT(( "index out of bounds" ));
+# endif
+  return (ulong)(entry-map);
+}
+
+FD_FN_CONST static inline MAP_KEY_T MAP_(key_null)( void ) { return (MAP_KEY_NULL); }
+
+/* These are FD_FN_PURE instead of FD_FN_CONST in case a non-POD
+   MAP_KEY_T. */
+
+FD_FN_PURE static inline int MAP_(key_inval)( MAP_KEY_T k0               ) { return (MAP_KEY_INVAL(k0)); }
+FD_FN_PURE static inline int MAP_(key_equal)( MAP_KEY_T k0, MAP_KEY_T k1 ) { return (MAP_KEY_EQUAL(k0,k1)); }
+
+FD_FN_PURE static inline MAP_HASH_T
+MAP_(key_hash)( MAP_KEY_T key,
+                ulong     seed ) {
+  (void)seed;
+  return (MAP_KEY_HASH( (key), (seed) ));
+}
+
+FD_FN_UNUSED static MAP_T * /* Work around -Winline */
+MAP_(insert)( MAP_T *   map,
+              MAP_KEY_T key ) {
+# if FD_TMPL_USE_HANDHOLDING
+  if( FD_UNLIKELY( MAP_(key_inval)( key ) ) ) FD_LOG_CRIT(( "invalid key" ));
+# endif
+  MAP_(private_t) * hdr = MAP_(private_from_slot)( map );
+
+  ulong key_cnt   = hdr->key_cnt;
+  ulong slot_mask = hdr->slot_mask; /* == key_max */
+  if( FD_UNLIKELY( key_cnt >= slot_mask ) ) return NULL;
+
+  uchar *    ctrl = MAP_(private_ctrl)( map, slot_mask );
+  MAP_HASH_T hash = MAP_(key_hash)( key, hdr->seed );
+  uchar      tag  = MAP_(private_tag)( hash );
+
+  /* Make sure key is not already in the map, noting the first free
+     slot in key's probe sequence as we go. */
+
+  ulong dst       = ULONG_MAX;
+  ulong pos       = MAP_(private_start)( hash, slot_mask );
+  ulong stride    = 0UL;
+  ulong probe_rem = (slot_mask >> MAP_GROUP_LG) + 1UL;
+  do {
+    uchar const * g = ctrl + pos;
+
+    ulong m = MAP_(private_match)( g, tag );
+    while( m ) {
+      MAP_T * e = map + ((pos + MAP_(private_mask_lo)( m )) & slot_mask);
+#     if MAP_MEMOIZE && MAP_KEY_EQUAL_IS_SLOW
+      if( FD_UNLIKELY( e->MAP_HASH==hash && MAP_(key_equal)( e->MAP_KEY, key ) ) ) return NULL;
+#     else
+      if( FD_UNLIKELY( MAP_(key_equal)( e->MAP_KEY, key ) ) ) return NULL;
+#     endif
+      m = fd_ulong_pop_lsb( m );
+    }
+
+    if( dst==ULONG_MAX ) {
+      ulong f = MAP_(private_match_free)( g );
+      if( f ) dst = (pos + MAP_(private_mask_lo)( f )) & slot_mask;
+    }
+
+    if( FD_LIKELY( MAP_(private_match_empty)( g ) ) ) break; /* Optimize for not found */
+
+    stride += (ulong)MAP_GROUP_WIDTH;
+    pos     = (pos + stride) & slot_mask;
+  } while( --probe_rem );
+
+  /* At this point, the key is not in the map and, as key_cnt<slot_cnt,
+     dst is the first free slot in its probe sequence. */
+
+  hdr->tomb_cnt -= (ulong)(ctrl[ dst ]==MAP_PRIVATE_CTRL_DELETED);
+  MAP_(private_ctrl_set)( ctrl, slot_mask, dst, tag );
+
+  MAP_T * m = map + dst;
+  MAP_KEY_MOVE( m->MAP_KEY, key );
+# if MAP_MEMOIZE
+  m->MAP_HASH = hash;
+# endif
+  hdr->key_cnt = key_cnt + 1UL;
+  return m;
+}
+
+static inline void
+MAP_(remove)( MAP_T * map,
+              MAP_T * entry ) {
+  MAP_(private_t) * hdr = MAP_(private_from_slot)( map );
+
+  ulong   slot_mask = hdr->slot_mask;
+  uchar * ctrl      = MAP_(private_ctrl)( map, slot_mask );
+  ulong   slot      = MAP_(slot_idx)( map, entry );
+
+# if FD_TMPL_USE_HANDHOLDING
+  if( FD_UNLIKELY( !hdr->key_cnt                     ) ) FD_LOG_CRIT(( "map is empty" ));
+  if( FD_UNLIKELY( MAP_(key_inval)( entry->MAP_KEY ) ) ) FD_LOG_CRIT(( "entry is not valid" ));
+  if( FD_UNLIKELY( ctrl[ slot ] & (uchar)0x80        ) ) FD_LOG_CRIT(( "entry is not in the map" ));
+# endif
+
+  hdr->key_cnt--;
+
+  /* If there is no run of MAP_GROUP_WIDTH non-EMPTY slots that covers
+     slot, no group probe could have found the group containing slot
+     full and continued past it.  So no probe sequence depends on slot
+     being occupied and we can mark it EMPTY.  Otherwise, we need a
+     tombstone. */
+
+  ulong empty_after  = MAP_(private_match_empty)( ctrl + slot );
+  ulong empty_before = MAP_(private_match_empty)( ctrl + ((slot - (ulong)MAP_GROUP_WIDTH) & slot_mask) );
+  int   never_full   = (!!empty_before) & (!!empty_after) &&
+                       (MAP_(private_mask_lo)( empty_after ) + ((ulong)(MAP_GROUP_WIDTH-1) - MAP_(private_mask_hi)( empty_before )))
+                       < (ulong)MAP_GROUP_WIDTH;
+
+  entry->MAP_KEY = (MAP_KEY_NULL);
+  MAP_(private_ctrl_set)( ctrl, slot_mask, slot, never_full ? MAP_PRIVATE_CTRL_EMPTY : MAP_PRIVATE_CTRL_DELETED );
+
+  ulong tomb_cnt = hdr->tomb_cnt + (ulong)!never_full;
+  hdr->tomb_cnt = tomb_cnt;
+  if( FD_UNLIKELY( tomb_cnt > (slot_mask >> 3) ) ) MAP_(private_rehash)( map );
+}
+
+FD_FN_PURE FD_FN_UNUSED static MAP_T * /* Work around -Winline */
+MAP_(query)( MAP_T *   map,
+             MAP_KEY_T key,
+             MAP_T *   null ) {
+# if FD_TMPL_USE_HANDHOLDING
+  if( FD_UNLIKELY( MAP_KEY_INVAL( key ) ) ) FD_LOG_CRIT(( "invalid key" ));
+# endif
+  MAP_(private_t) * hdr = MAP_(private_from_slot)( map );
+
+  ulong         slot_mask = hdr->slot_mask;
+  uchar const * ctrl      = MAP_(private_ctrl)( map, slot_mask );
+  MAP_HASH_T    hash      = MAP_(key_hash)( key, hdr->seed );
+  uchar         tag       = MAP_(private_tag)( hash );
+
+  ulong pos       = MAP_(private_start)( hash, slot_mask );
+  ulong stride    = 0UL;
+  ulong probe_rem = (slot_mask >> MAP_GROUP_LG) + 1UL;
+  do {
+    uchar const * g = ctrl + pos;
+
+    ulong m = MAP_(private_match)( g, tag );
+    while( FD_LIKELY( m ) ) {
+      MAP_T * e = map + ((pos + MAP_(private_mask_lo)( m )) & slot_mask);
+#     if MAP_MEMOIZE && MAP_KEY_EQUAL_IS_SLOW
+      if( FD_LIKELY( e->MAP_HASH==hash && MAP_(key_equal)( e->MAP_KEY, key ) ) ) return e;
+#     else
+      if( FD_LIKELY( MAP_(key_equal)( e->MAP_KEY, key ) ) ) return e;
+#     endif
+      m = fd_ulong_pop_lsb( m );
+    }
+
+    if( FD_LIKELY( MAP_(private_match_empty)( g ) ) ) break;
+
+    stride += (ulong)MAP_GROUP_WIDTH;
+    pos     = (pos + stride) & slot_mask;
+  } while( --probe_rem );
+
+  return null;
+}
+
+#if MAP_CONCUR
+
+static inline void
+MAP_(lock)( MAP_T * map ) {
+  ulong volatile * _version = &MAP_(private_from_slot)( map )->version;
+  for(;;) {
+    ulong version = *_version;
+#   if FD_HAS_ATOMIC
+    if( FD_LIKELY( !(version & 1UL) ) && FD_LIKELY( FD_ATOMIC_CAS( _version, version, version+1UL )==version ) ) break;
+#   else /* Note: this assumes platforms without HAS_ATOMIC will not be running this multithreaded */
+    if( FD_LIKELY( !(version & 1UL) ) ) { *_version = version+1UL; break; }
+#   endif
+    FD_SPIN_PAUSE();
+  }
+  FD_COMPILER_MFENCE();
+}
+
+static inline void
+MAP_(unlock)( MAP_T * map ) {
+  ulong volatile * _version = &MAP_(private_from_slot)( map )->version;
+  FD_COMPILER_MFENCE();
+  *_version = *_version + 1UL;
+  FD_COMPILER_MFENCE();
+}
+
+static inline MAP_T const *
+MAP_(query_try)( MAP_T const * map,
+                 MAP_KEY_T     key,
+                 MAP_T const * null,
+                 ulong *       _version ) {
+  ulong version = FD_VOLATILE_CONST( MAP_(private_from_slot_const)( map )->version );
+  *_version = version;
+  FD_COMPILER_MFENCE();
+  if( FD_UNLIKELY( version & 1UL ) ) return null;
+  return MAP_(query)( (MAP_T *)map, key, (MAP_T *)null );
+}
+
+static inline int
+MAP_(query_test)( MAP_T const * map,
+                  ulong         version ) {
+  FD_COMPILER_MFENCE();
+  ulong _version = FD_VOLATILE_CONST( MAP_(private_from_slot_const)( map )->version );
+  FD_COMPILER_MFENCE();
+  return ((_version==version) & !(version & 1UL)) ? FD_MAP_SUCCESS : FD_MAP_ERR_AGAIN;
+}
+
+#endif
+
+FD_PROTOTYPES_END
+
+#undef MAP_PRIVATE_MASK_SHIFT
+#undef MAP_PRIVATE_CTRL_DELETED
+#undef MAP_PRIVATE_CTRL_EMPTY
+#undef MAP_
+
+/* End implementation *************************************************/
+
+#undef MAP_CONCUR
+#undef MAP_GROUP_LG
+#undef MAP_GROUP_WIDTH
+#undef MAP_QUERY_OPT
+#undef MAP_MEMOIZE
+#undef MAP_MOVE
+#undef MAP_KEY_MOVE
+#undef MAP_KEY_HASH
+#undef MAP_KEY_EQUAL_IS_SLOW
+#undef MAP_KEY_EQUAL
+#undef MAP_KEY_INVAL
+#undef MAP_KEY_NULL
+#undef MAP_KEY
+#undef MAP_KEY_T
+#undef MAP_HASH
+#undef MAP_HASH_T
+#undef MAP_T
+#undef MAP_NAME
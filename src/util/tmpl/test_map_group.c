@@ -0,0 +1,436 @@
+#include "../fd_util.h"
+#if FD_HAS_HOSTED
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define LG_SLOT_CNT 9
+
+struct pair {
+  ulong mykey;
+  uint  myhash;
+  uint  val;
+};
+
+typedef struct pair pair_t;
+
+/* map is the default configuration (MAP_GROUP_WIDTH 16 on targets with
+   SSE), mapm memoizes hashes and filters key compares with them, maps
+   uses the portable SWAR groups and mapc supports speculative
+   queries. */
+
+#define MAP_NAME    map
+#define MAP_T       pair_t
+#define MAP_MEMOIZE 0
+#define MAP_KEY     mykey
+#include "fd_map_group.c"
+
+#define MAP_NAME              mapm
+#define MAP_T                 pair_t
+#define MAP_MEMOIZE           1
+#define MAP_KEY               mykey
+#define MAP_HASH              myhash
+#define MAP_KEY_NULL          0UL
+#define MAP_KEY_INVAL(k)      !(k)
+#define MAP_KEY_EQUAL(k0,k1)  (k0)==(k1)
+#define MAP_KEY_EQUAL_IS_SLOW 1
+#define MAP_KEY_HASH(k,s)     ((uint)fd_ulong_hash( (k) ^ (s) ))
+#define MAP_KEY_T             ulong
+#include "fd_map_group.c"
+
+#define MAP_NAME        maps
+#define MAP_T           pair_t
+#define MAP_MEMOIZE     0
+#define MAP_KEY         mykey
+#define MAP_GROUP_WIDTH 8
+#include "fd_map_group.c"
+
+#define MAP_NAME    mapc
+#define MAP_T       pair_t
+#define MAP_MEMOIZE 0
+#define MAP_KEY     mykey
+#define MAP_CONCUR  1
+#include "fd_map_group.c"
+
+/* Baselines for the benchmark */
+
+#define MAP_NAME    mapd
+#define MAP_T       pair_t
+#define MAP_MEMOIZE 0
+#define MAP_KEY     mykey
+#include "fd_map_dynamic.c"
+
+#if FD_HAS_AVX
+#define MAP_NAME        mapw
+#define MAP_T           pair_t
+#define MAP_MEMOIZE     0
+#define MAP_KEY         mykey
+#define MAP_GROUP_WIDTH 32
+#include "fd_map_group.c"
+#endif
+
+uchar mem[ 16384 ] __attribute__((aligned(8)));
+
+/* Concurrent test of mapc: the writer (tile 0) randomly inserts,
+   modifies and removes tile_key[0,tile_key_cnt/2) under the map lock,
+   keeping val==(uint)mykey ^ myhash for every live entry.  The reader
+   (tile 1) speculatively queries random keys of tile_key[0,tile_key_cnt)
+   and checks that every query that passes query_test saw a consistent
+   entry and never saw a key the writer does not own.  The writer keeps
+   going until the reader has completed tile_query_min queries, such
+   that the test overlaps even if the tiles share a core. */
+
+static pair_t *      tile_map;
+static ulong const * tile_key;
+static ulong         tile_key_cnt;
+static ulong         tile_iter_cnt;
+static ulong         tile_query_min;
+static ulong         tile_query_cnt;
+static ulong         tile_go;
+static ulong         tile_done;
+
+static int
+tile_reader( int     argc,
+             char ** argv ) {
+  (void)argc; (void)argv;
+  pair_t const * map = tile_map;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1U, 0UL ) );
+
+  while( !FD_VOLATILE_CONST( tile_go ) ) FD_SPIN_PAUSE();
+
+  ulong ok_cnt    = 0UL;
+  ulong again_cnt = 0UL;
+  while( !FD_VOLATILE_CONST( tile_done ) ) {
+    ulong i = fd_rng_ulong_roll( rng, tile_key_cnt );
+    ulong k = tile_key[ i ];
+    for(;;) {
+      ulong          version;
+      pair_t const * e = mapc_query_try( map, k, NULL, &version );
+      ulong spec_key = e ? e->mykey  : 0UL;
+      uint  spec_mod = e ? e->myhash : 0U;
+      uint  spec_val = e ? e->val    : 0U;
+      if( FD_UNLIKELY( mapc_query_test( map, version ) ) ) { again_cnt++; FD_SPIN_PAUSE(); continue; }
+      if( e ) {
+        FD_TEST( i<tile_key_cnt/2UL );
+        FD_TEST( spec_key==k );
+        FD_TEST( spec_val==((uint)k ^ spec_mod) );
+      }
+      ok_cnt++;
+      FD_VOLATILE( tile_query_cnt ) = ok_cnt;
+      break;
+    }
+  }
+
+  FD_LOG_NOTICE(( "mapc reader: %lu queries, %lu retries", ok_cnt, again_cnt ));
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+static void
+tile_writer( fd_rng_t * rng ) {
+  pair_t *      map     = tile_map;
+  ulong const * key     = tile_key;
+  ulong         own_cnt = tile_key_cnt/2UL;
+  ulong         max     = mapc_key_max( map );
+
+  for( ulong iter=0UL; iter<tile_iter_cnt || FD_VOLATILE_CONST( tile_query_cnt )<tile_query_min; iter++ ) {
+    ulong    k = key[ fd_rng_ulong_roll( rng, own_cnt ) ];
+    uint     r = fd_rng_uint( rng );
+    mapc_lock( map );
+    pair_t * e = mapc_query( map, k, NULL );
+    if( !e ) {
+      if( mapc_key_cnt( map )<max ) {
+        e = mapc_insert( map, k ); FD_TEST( e );
+        e->myhash = r;
+        e->val    = (uint)k ^ r;
+      }
+    } else if( r & 1U ) {
+      e->myhash = r;
+      e->val    = (uint)k ^ r;
+    } else {
+      mapc_remove( map, e );
+    }
+    mapc_unlock( map );
+  }
+}
+
+static void
+shuffle_pair( fd_rng_t * rng,
+              pair_t *   pair,
+              ulong      cnt ) {
+  for( ulong i=1UL; i<cnt; i++ ) {
+    ulong j  = fd_rng_ulong_roll( rng, i+1UL );
+    pair_t t = pair[i]; pair[i] = pair[j]; pair[j] = t;
+  }
+}
+
+/* TEST_MAP runs the fd_map_dynamic style insert / query / remove test
+   of map type M on tst (max unique keys), taking the map right to its
+   algorithmic limit, followed by a random insert / remove churn at high
+   load that exercises tombstones and in place rehashing. */
+
+#define TEST_MAP( M, MEMOIZE ) do {                                                                  \
+    ulong footprint = M##_footprint( LG_SLOT_CNT );                                                  \
+    FD_TEST( footprint<=16384UL && M##_align()<=8UL );                                               \
+    FD_TEST( fd_ulong_is_pow2   ( M##_align()            ) );                                        \
+    FD_TEST( fd_ulong_is_aligned( footprint, M##_align() ) );                                        \
+                                                                                                     \
+    ulong    seed  = fd_rng_ulong( rng );                                                            \
+    void   * shmap = M##_new ( mem, LG_SLOT_CNT, seed ); FD_TEST( shmap );                           \
+    pair_t * map   = M##_join( shmap );                  FD_TEST( map   );                           \
+                                                                                                     \
+    FD_TEST( M##_key_cnt    ( map )==0UL                          );                                 \
+    FD_TEST( M##_key_max    ( map )==max                          );                                 \
+    FD_TEST( M##_lg_slot_cnt( map )==LG_SLOT_CNT                  );                                 \
+    FD_TEST( M##_slot_cnt   ( map )==fd_ulong_pow2( LG_SLOT_CNT ) );                                 \
+    FD_TEST( M##_seed       ( map )==seed                         );                                 \
+    for( ulong s=0UL; s<max+1UL; s++ ) FD_TEST( M##_slot_idx( map, &map[s] )==s );                   \
+    FD_TEST( M##_key_inval( M##_key_null() ) );                                                      \
+                                                                                                     \
+    for( ulong iter=0UL; iter<20UL; iter++ ) {                                                       \
+      shuffle_pair( rng, tst, max );                                                                 \
+      for( ulong i=0UL; i<max; i++ ) {                                                               \
+        ulong ki = tst[i].mykey;                                                                     \
+        FD_TEST( !M##_query( map, ki, NULL ) );                                                      \
+        pair_t * p = M##_insert( map, ki );                                                          \
+        FD_TEST( p && M##_key_equal( p->mykey, ki ) );                                               \
+        if( MEMOIZE ) FD_TEST( p->myhash==(uint)M##_key_hash( ki, seed ) );                          \
+        p->val = tst[i].val;                                                                         \
+        FD_TEST( M##_key_cnt( map )==(i+1UL) );                                                      \
+        FD_TEST( !M##_insert( map, ki ) );                                                           \
+        FD_TEST( M##_query( map, ki, NULL )==p );                                                    \
+      }                                                                                              \
+      for( ulong j=0UL; j<max; j++ ) {                                                               \
+        pair_t * p = M##_query( map, tst[j].mykey, NULL );                                           \
+        FD_TEST( p && p->val==tst[j].val );                                                          \
+      }                                                                                              \
+      FD_TEST( !M##_insert( map, 1UL ) ); /* Full */                                                 \
+                                                                                                     \
+      shuffle_pair( rng, tst, max );                                                                 \
+      for( ulong i=0UL; i<max; i++ ) {                                                               \
+        pair_t * p = M##_query( map, tst[i].mykey, NULL );                                           \
+        FD_TEST( p && p->val==tst[i].val );                                                          \
+        M##_remove( map, p );                                                                        \
+        FD_TEST( M##_key_cnt( map )==(max-i-1UL) );                                                  \
+        FD_TEST( !M##_query( map, tst[i].mykey, NULL ) );                                            \
+        for( ulong j=i+1UL; j<max; j++ ) {                                                           \
+          pair_t * q = M##_query( map, tst[j].mykey, NULL );                                         \
+          FD_TEST( q && q->val==tst[j].val );                                                        \
+        }                                                                                            \
+      }                                                                                              \
+    }                                                                                                \
+                                                                                                     \
+    /* Churn: tst[0,cnt) are in the map */                                                           \
+                                                                                                     \
+    ulong cnt = 0UL;                                                                                 \
+    for( ulong iter=0UL; iter<200000UL; iter++ ) {                                                   \
+      uint r = fd_rng_uint( rng );                                                                   \
+      if( (cnt<max) & ((cnt<(max*7UL)/8UL) | !(r&1U)) ) {                                            \
+        ulong    i = cnt + fd_rng_ulong_roll( rng, max-cnt );                                        \
+        pair_t * p = M##_insert( map, tst[i].mykey );                                                \
+        FD_TEST( p );                                                                                \
+        p->val = tst[i].val;                                                                         \
+        pair_t t = tst[i]; tst[i] = tst[cnt]; tst[cnt] = t;                                          \
+        cnt++;                                                                                       \
+      } else if( cnt ) {                                                                             \
+        ulong    i = fd_rng_ulong_roll( rng, cnt );                                                  \
+        pair_t * p = M##_query( map, tst[i].mykey, NULL );                                           \
+        FD_TEST( p && p->val==tst[i].val );                                                          \
+        M##_remove( map, p );                                                                        \
+        cnt--;                                                                                       \
+        pair_t t = tst[i]; tst[i] = tst[cnt]; tst[cnt] = t;                                          \
+      }                                                                                              \
+      FD_TEST( M##_key_cnt( map )==cnt );                                                            \
+      if( !(iter & 1023UL) ) {                                                                       \
+        for( ulong j=0UL; j<max; j++ ) {                                                             \
+          pair_t * q = M##_query( map, tst[j].mykey, NULL );                                         \
+          if( j<cnt ) FD_TEST( q && q->val==tst[j].val );                                            \
+          else        FD_TEST( !q );                                                                 \
+        }                                                                                            \
+        ulong live = 0UL;                                                                            \
+        for( ulong s=0UL; s<max+1UL; s++ ) live += (ulong)!M##_key_inval( map[s].mykey );            \
+        FD_TEST( live==cnt );                                                                        \
+      }                                                                                              \
+    }                                                                                                \
+                                                                                                     \
+    M##_clear( map );                                                                                \
+    FD_TEST( !M##_key_cnt( map ) );                                                                  \
+    for( ulong j=0UL; j<max; j++ ) FD_TEST( !M##_query( map, tst[j].mykey, NULL ) );                 \
+                                                                                                     \
+    FD_TEST( M##_leave ( map   )==shmap       );                                                     \
+    FD_TEST( M##_delete( shmap )==(void *)mem );                                                     \
+    FD_LOG_NOTICE(( "%s: pass", #M ));                                                               \
+  } while(0)
+
+/* BENCH_MAP measures the average ticks per query hit and per query
+   miss of map type M loaded to load percent. */
+
+#define BENCH_MAP( M, lg_slot_cnt, load ) do {                                                       \
+    pair_t * map = M##_join( M##_new( bench_mem, (lg_slot_cnt), 1234UL ) );                          \
+    FD_TEST( map );                                                                                  \
+    ulong key_cnt = (M##_slot_cnt( map )*(load))/1000UL;                                             \
+    for( ulong i=0UL; i<key_cnt; i++ ) FD_TEST( M##_insert( map, bench_key[i] ) );                   \
+    ulong qcnt = 1UL<<22;                                                                            \
+    ulong hit  = 0UL;                                                                                \
+    long  dt0  = -fd_tickcount();                                                                    \
+    for( ulong q=0UL; q<qcnt; q++ ) hit += (ulong)!!M##_query( map, bench_key[ bench_idx[ q & 65535UL ] % key_cnt ], NULL ); \
+    dt0 += fd_tickcount();                                                                           \
+    long  dt1  = -fd_tickcount();                                                                    \
+    for( ulong q=0UL; q<qcnt; q++ ) hit += (ulong)!!M##_query( map, bench_key[ key_cnt + bench_idx[ q & 65535UL ] ], NULL ); \
+    dt1 += fd_tickcount();                                                                           \
+    FD_TEST( hit==qcnt );                                                                            \
+    FD_LOG_NOTICE(( "%-5s lg_slot_cnt %i load %5.1f%%: hit %6.1f ticks/query, miss %6.1f ticks/query", \
+                    #M, (lg_slot_cnt), (double)(load)/10., (double)dt0/(double)qcnt, (double)dt1/(double)qcnt )); \
+    M##_delete( M##_leave( map ) );                                                                  \
+  } while(0)
+
+#define BENCH_LG_SLOT_CNT_MAX (20)
+
+static uchar bench_mem[ 24UL<<BENCH_LG_SLOT_CNT_MAX ] __attribute__((aligned(8)));
+static ulong bench_key[ (1UL<<BENCH_LG_SLOT_CNT_MAX) + 65536UL ];
+static ulong bench_idx[ 65536UL ];
+
+static void
+bench( fd_rng_t * rng,
+       int        lg_slot_cnt ) {
+  FD_TEST( (lg_slot_cnt>=4) & (lg_slot_cnt<=BENCH_LG_SLOT_CNT_MAX) );
+  FD_TEST( mapd_footprint( lg_slot_cnt )<=sizeof(bench_mem) && map_footprint( lg_slot_cnt )<=sizeof(bench_mem) );
+  ulong key_max = (1UL<<lg_slot_cnt) + 65536UL;
+  for( ulong i=0UL; i<key_max; i++ ) bench_key[i] = ((fd_rng_ulong( rng ) | 1UL) << 24) | i; /* Unique and non-zero */
+  for( ulong i=0UL; i<65536UL; i++ ) bench_idx[i] = fd_rng_ulong_roll( rng, 65536UL );
+
+  static ulong const load[4] = { 500UL, 750UL, 875UL, 940UL }; /* In per mille */
+  for( ulong l=0UL; l<4UL; l++ ) {
+    BENCH_MAP( mapd, lg_slot_cnt, load[l] );
+    BENCH_MAP( map,  lg_slot_cnt, load[l] );
+    BENCH_MAP( maps, lg_slot_cnt, load[l] );
+#   if FD_HAS_AVX
+    BENCH_MAP( mapw, lg_slot_cnt, load[l] );
+#   endif
+  }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  int lg_bench = fd_env_strip_cmdline_int( &argc, &argv, "--bench-lg-slot-cnt", NULL, 0 ); /* 0 to skip */
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  pair_t tst[511];
+  ulong max = (1UL<<LG_SLOT_CNT) - 1UL; /* Take map right to its algorithmic limit */
+  for( ulong idx=0UL; idx<max; idx++ ) {
+    tst[idx].mykey  = ((fd_rng_ulong( rng ) | 1UL) << 9) | idx; /* Every map key is unique, non-zero and not 1 */
+    tst[idx].myhash = 0U;
+    tst[idx].val    = fd_rng_uint( rng );
+  }
+
+  TEST_MAP( map,  0 );
+  TEST_MAP( mapm, 1 );
+  TEST_MAP( maps, 0 );
+# if FD_HAS_AVX
+  TEST_MAP( mapw, 0 );
+# endif
+  TEST_MAP( mapc, 0 );
+
+  /* Speculative queries */
+
+  pair_t * mc = mapc_join( mapc_new( mem, LG_SLOT_CNT, 5678UL ) );
+  FD_TEST( mc );
+  mapc_lock( mc );
+  pair_t * e = mapc_insert( mc, tst[0].mykey ); FD_TEST( e );
+  e->val = 42U;
+  ulong version;
+  FD_TEST( !mapc_query_try( mc, tst[0].mykey, NULL, &version ) ); /* Locked */
+  FD_TEST( mapc_query_test( mc, version )==FD_MAP_ERR_AGAIN );
+  mapc_unlock( mc );
+
+  pair_t const * f = mapc_query_try( mc, tst[0].mykey, NULL, &version );
+  FD_TEST( f==e && f->val==42U );
+  FD_TEST( !mapc_query_try( mc, tst[1].mykey, NULL, &version ) );
+  FD_TEST( mapc_query_test( mc, version )==FD_MAP_SUCCESS );
+
+  mapc_lock( mc ); mapc_remove( mc, e ); mapc_unlock( mc );
+  FD_TEST( mapc_query_test( mc, version )==FD_MAP_ERR_AGAIN );
+  FD_TEST( !mapc_query_try( mc, tst[0].mykey, NULL, &version ) );
+  FD_TEST( mapc_query_test( mc, version )==FD_MAP_SUCCESS );
+  mapc_delete( mapc_leave( mc ) );
+
+  /* Speculative queries concurrent with a writer */
+
+  if( fd_tile_cnt()>=2UL ) {
+    static ulong key[ 1024 ];
+    for( ulong i=0UL; i<1024UL; i++ ) key[i] = ((fd_rng_ulong( rng ) | 1UL) << 10) | i; /* Unique and non-zero */
+
+    tile_map       = mapc_join( mapc_new( mem, LG_SLOT_CNT, 9012UL ) ); FD_TEST( tile_map );
+    tile_key       = key;
+    tile_key_cnt   = 1024UL;
+    tile_iter_cnt  = 1000000UL;
+    tile_query_min = 100000UL;
+    FD_VOLATILE( tile_query_cnt ) = 0UL;
+    FD_VOLATILE( tile_go        ) = 0UL;
+    FD_VOLATILE( tile_done      ) = 0UL;
+    FD_COMPILER_MFENCE();
+
+    fd_tile_exec_t * exec = fd_tile_exec_new( 1UL, tile_reader, 0, NULL ); FD_TEST( exec );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( tile_go ) = 1UL;
+    FD_COMPILER_MFENCE();
+
+    tile_writer( rng );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( tile_done ) = 1UL;
+    FD_COMPILER_MFENCE();
+
+    fd_tile_exec_delete( exec, NULL );
+    mapc_delete( mapc_leave( tile_map ) );
+    FD_LOG_NOTICE(( "mapc concurrent: pass" ));
+  } else {
+    FD_LOG_WARNING(( "skip: concurrent mapc test, requires at least 2 tiles" ));
+  }
+
+  /* test handholding */
+#if FD_HAS_HOSTED && FD_TMPL_USE_HANDHOLDING
+#define FD_EXPECT_LOG_CRIT( CALL ) do {                            \
+    FD_LOG_DEBUG(( "Testing that "#CALL" triggers FD_LOG_CRIT" )); \
+    pid_t pid = fork();                                            \
+    FD_TEST( pid >= 0 );                                           \
+    if( pid == 0 ) {                                               \
+      fd_log_level_logfile_set( 6 );                               \
+      __typeof__(CALL) res = (CALL);                               \
+      __asm__("" : "+r"(res));                                     \
+      _exit( 0 );                                                  \
+    }                                                              \
+    int status = 0;                                                \
+    wait( &status );                                               \
+                                                                   \
+    FD_TEST( WIFSIGNALED(status) && WTERMSIG(status)==6 );         \
+  } while( 0 )
+
+  FD_EXPECT_LOG_CRIT( map_new( (void*)((char*)mem+1), 5, 0UL ) );
+  FD_EXPECT_LOG_CRIT( map_new( mem,                  -1, 0UL ) );
+  FD_EXPECT_LOG_CRIT( map_new( mem,                  64, 0UL ) );
+
+  pair_t * m = map_join( map_new( mem, LG_SLOT_CNT, 0UL ) ); FD_TEST( m );
+  FD_EXPECT_LOG_CRIT( map_insert  ( m, map_key_null() ) );
+  FD_EXPECT_LOG_CRIT( map_query   ( m, map_key_null(), 0UL ) );
+  pair_t p = { 1UL, 0U, 23U };
+  FD_EXPECT_LOG_CRIT( map_slot_idx( m, &p ) );
+
+#else
+  FD_LOG_WARNING(( "skip: testing handholding, requires hosted" ));
+#endif
+
+  if( lg_bench>0 ) bench( rng, lg_bench );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -996,6 +996,15 @@ fd_wksp_pod_unmap( void * obj );
    will make a best effort to clean up after any partially written
    checkpt file.
 
+   For FD_WKSP_CHECKPT_STYLE_V2 and V3 checkpts, the wksp allocations
+   are split into groups that are compressed in parallel over threads
+   (t0,t1) when there is more than one thread.  The checkpt is written
+   via memory mapped I/O in this case, so path should be on a file
+   system that supports it (falls back to a serial checkpt otherwise).
+   The bytes written for the allocations are identical regardless of
+   the range of threads used (the info in the checkpt about when, where
+   and by whom the checkpt was made will naturally differ).
+
    fd_wksp_checkpt is a convenience wrapper for serial checkpts. */
 
 int
@@ -10,6 +10,196 @@
 
 #define FD_WKSP_CHECKPT_V2_CGROUP_MAX (1024UL)
 
+/* FD_WKSP_CHECKPT_V2_INFO_BUF_MAX is the size of the buffer used to
+   assemble the info frame cstrs. */
+
+#define FD_WKSP_CHECKPT_V2_INFO_BUF_MAX (65536UL)
+
+/* fd_wksp_private_checkpt_v2_csz_max returns an upper bound on the
+   number of bytes a sz byte fd_checkpt_{meta,data} can append to a
+   frame of any supported style.  Compressed frames store a buffer as
+   ceil(sz/CHUNK_USZ_MAX) chunks, each at most CSZ_MAX(chunk_usz) bytes,
+   and the sum of floor(chunk_usz/255) over the chunks is at most
+   floor(sz/255). */
+
+FD_FN_CONST static inline ulong
+fd_wksp_private_checkpt_v2_csz_max( ulong sz ) {
+  ulong chunk_cnt = (sz + FD_CHECKPT_PRIVATE_CHUNK_USZ_MAX - 1UL) / FD_CHECKPT_PRIVATE_CHUNK_USZ_MAX;
+  return sz + sz/255UL + chunk_cnt*FD_CHECKPT_PRIVATE_CSZ_MAX( 0UL );
+}
+
+/* fd_wksp_private_checkpt_v2_cgroup writes the frame of the cgroup
+   whose partitions are given by the stack_cidx linked list headed by
+   head_cidx to checkpt.  On success, returns FD_CHECKPT_SUCCESS and
+   *_off_lo / *_off_hi will hold the checkpt offset of the frame's first
+   byte / one past its last byte.  On failure, returns a FD_CHECKPT_ERR
+   code (logs details).  The frame bytes depend only on the cgroup's
+   partitions and frame_style (i.e. not on whether checkpt is streaming
+   or mmio or what was written to it before). */
+
+static int
+fd_wksp_private_checkpt_v2_cgroup( fd_checkpt_t * checkpt,
+                                   fd_wksp_t *    wksp,
+                                   uint           head_cidx,
+                                   int            frame_style,
+                                   ulong *        _off_lo,
+                                   ulong *        _off_hi ) {
+
+  fd_wksp_private_pinfo_t * pinfo = fd_wksp_private_pinfo( wksp );
+
+  int err = fd_checkpt_open_advanced( checkpt, frame_style, _off_lo ); /* logs details */
+  if( FD_UNLIKELY( err ) ) return err;
+
+  /* Write cgroup commands */
+
+  fd_wksp_checkpt_v2_cmd_t cmd[1];
+
+  ulong part_idx = fd_wksp_private_pinfo_idx( head_cidx );
+  while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+
+    /* Command: "meta (tag,gaddr_lo,gaddr_hi)" */
+
+    cmd->meta.tag      = pinfo[ part_idx ].tag;      /* Note: non-zero */
+    cmd->meta.gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+    cmd->meta.gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+    err = fd_checkpt_meta( checkpt, cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) ); /* logs details */
+    if( FD_UNLIKELY( err ) ) return err;
+
+    part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+  }
+
+  /* Command: "corresponding data follows" */
+
+  cmd->data.tag        = 0UL;
+  cmd->data.cgroup_cnt = ULONG_MAX;
+  cmd->data.frame_off  = ULONG_MAX;
+
+  err = fd_checkpt_meta( checkpt, cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) ); /* logs details */
+  if( FD_UNLIKELY( err ) ) return err;
+
+  /* Write cgroup partition data */
+
+  part_idx = fd_wksp_private_pinfo_idx( head_cidx );
+  while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+    ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+    ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+    err = fd_checkpt_data( checkpt, fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo ); /* logs details */
+    if( FD_UNLIKELY( err ) ) return err;
+
+    part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+  }
+
+  return fd_checkpt_close_advanced( checkpt, _off_hi ); /* logs details */
+}
+
+/* fd_wksp_private_checkpt_v2_node dispatches cgroup frame compression
+   to tpool threads [t0,t1).  Cgroup cgroup_idx is written into the
+   cgroup_frame_sz[cgroup_idx] bytes of mmio starting at
+   cgroup_frame_off[cgroup_idx] (an upper bound of the frame's size).  On
+   return, cgroup_frame_sz[cgroup_idx] will hold the frame's actual size.
+   If any errors were encountered, returns the first error encountered
+   on the lowest indexed thread in the int location pointed to by _err
+   (a FD_CHECKPT_ERR code).  Assumes the caller is thread t0 and threads
+   (t0,t1) are available.  This mirrors
+   fd_wksp_private_restore_v2_node. */
+
+static void
+fd_wksp_private_checkpt_v2_node( void * tpool,
+                                 ulong  tpool_t0,
+                                 ulong  tpool_t1,          /* Assumes t1>t0 */
+                                 void * _wksp,
+                                 void * _mmio,
+                                 ulong  frame_style,
+                                 ulong  _cgroup_head_cidx,
+                                 ulong  _cgroup_frame_off,
+                                 ulong  _cgroup_frame_sz,
+                                 ulong  _cgroup_nxt,
+                                 ulong  cgroup_cnt,
+                                 ulong  _err ) {
+
+  /* This node is responsible for threads [t0,t1).  If this range has
+     more than one thread, split the range into left and right halves,
+     have the first right half thread handle the right half, use this
+     thread to handle the left half and then reduce the results from
+     the two halves. */
+
+  ulong tpool_cnt = tpool_t1 - tpool_t0;
+  if( tpool_cnt>1UL ) {
+    ulong tpool_ts = tpool_t0 + fd_tpool_private_split( tpool_cnt );
+
+    int err0;
+    int err1;
+
+    fd_tpool_exec( tpool, tpool_ts, fd_wksp_private_checkpt_v2_node,
+                   tpool, tpool_ts, tpool_t1, _wksp, _mmio, frame_style, _cgroup_head_cidx, _cgroup_frame_off, _cgroup_frame_sz,
+                   _cgroup_nxt, cgroup_cnt, (ulong)&err1 );
+    fd_wksp_private_checkpt_v2_node(
+                   tpool, tpool_t0, tpool_ts, _wksp, _mmio, frame_style, _cgroup_head_cidx, _cgroup_frame_off, _cgroup_frame_sz,
+                   _cgroup_nxt, cgroup_cnt, (ulong)&err0 );
+    fd_tpool_wait( tpool, tpool_ts );
+
+    *(int *)_err = fd_int_if( !!err0, err0, err1 ); /* Return first error encountered */
+    return;
+  }
+
+  /* This node is responsible for a single thread.  Unpack the input
+     arguments. */
+
+  fd_wksp_t *   wksp             = (fd_wksp_t *)   _wksp;
+  uchar *       mmio             = (uchar *)       _mmio;
+  uint const *  cgroup_head_cidx = (uint const *)  _cgroup_head_cidx;
+  ulong const * cgroup_frame_off = (ulong const *) _cgroup_frame_off;
+  ulong *       cgroup_frame_sz  = (ulong *)       _cgroup_frame_sz;
+
+  int err = FD_CHECKPT_SUCCESS;
+
+  for(;;) {
+
+    /* Get the next cgroup to checkpt.  As in restore, we use a dynamic
+       task queue model because the amount of work per cgroup is large
+       and variable.  The frame bytes do not depend on which thread
+       compresses them, so this does not impact the checkpt itself. */
+
+#   if FD_HAS_ATOMIC
+    FD_COMPILER_MFENCE();
+    ulong cgroup_idx = FD_ATOMIC_FETCH_AND_ADD( (ulong *)_cgroup_nxt, 1UL );
+    FD_COMPILER_MFENCE();
+#   else /* Note: this assumes platforms without HAS_ATOMIC will not be running this multithreaded */
+    ulong cgroup_idx = (*(ulong *)_cgroup_nxt)++;
+#   endif
+
+    if( FD_UNLIKELY( cgroup_idx>=cgroup_cnt ) ) break; /* No more cgroups to process */
+
+    /* Checkpt this cgroup into its own region of the file with its own
+       checkpt object (we can't have multiple threads operate
+       concurrently on the same checkpt object). */
+
+    fd_checkpt_t _checkpt_local[1];
+    fd_checkpt_t * checkpt_local =
+      fd_checkpt_init_mmio( _checkpt_local, mmio + cgroup_frame_off[ cgroup_idx ], cgroup_frame_sz[ cgroup_idx ] ); /* logs details */
+    if( FD_UNLIKELY( !checkpt_local ) ) {
+      err = FD_CHECKPT_ERR_INVAL;
+      break;
+    }
+
+    ulong off_lo;
+    ulong off_hi;
+    err = fd_wksp_private_checkpt_v2_cgroup( checkpt_local, wksp, cgroup_head_cidx[ cgroup_idx ], (int)frame_style,
+                                             &off_lo, &off_hi ); /* logs details */
+
+    if( FD_UNLIKELY( fd_checkpt_in_frame( checkpt_local ) ) ) fd_checkpt_close( checkpt_local );
+    fd_checkpt_fini( checkpt_local );
+
+    if( FD_UNLIKELY( err ) ) break; /* abort if we encountered an error */
+
+    cgroup_frame_sz[ cgroup_idx ] = off_hi - off_lo;
+  }
+
+  *(int *)_err = err;
+}
+
 int
 fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
                             ulong        t0,
@@ -20,8 +210,6 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
                             char const * uinfo,
                             int          frame_style_compressed ) {
 
-  (void)tpool; (void)t0; (void)t1; /* Thread parallelization not currently implemented */
-
   char const * binfo = fd_log_build_info;
 
   if( FD_UNLIKELY( !fd_checkpt_frame_style_is_supported( frame_style_compressed ) ) ) {
@@ -33,6 +221,8 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
 
   int            locked  =  0;
   int            fd      = -1;
+  void *         mmio    = NULL;
+  ulong          mmio_sz = 0UL;
   fd_checkpt_t * checkpt = NULL;
 
   fd_wksp_private_pinfo_t * pinfo = fd_wksp_private_pinfo( wksp );
@@ -271,29 +461,102 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
      partitions for each cgroup are given in a singly linked list sorted
      in ascending order by gaddr_lo. */
 
-  /* Create the checkpt file */
+  /* If we have multiple threads and cgroups, we compress the cgroup
+     frames in parallel.  To do this, we size the checkpt file to an
+     upper bound of the checkpt size (sparse), memory map it, have each
+     thread compress its cgroups directly into a region of the file that
+     is guaranteed large enough, compact the frames and then truncate
+     the file to its actual size.  Since frames are independent, this
+     produces the same cgroup frames as a serial checkpt.  Determine the
+     bounds here (note: in principle we could thread parallelize this
+     too but it is cheap relative to compression). */
+
+  int parallel = (!!tpool) & (t1>t0+1UL) & (cgroup_cnt>1UL);
+
+  ulong cgroup_frame_sz[ FD_WKSP_CHECKPT_V2_CGROUP_MAX ]; /* Frame size upper bound, then actual frame size (parallel only) */
+  ulong checkpt_sz_max = 0UL;
+
+  if( parallel ) {
+    ulong cmd_csz_max = fd_wksp_private_checkpt_v2_csz_max( sizeof(fd_wksp_checkpt_v2_cmd_t) );
+
+    checkpt_sz_max = sizeof(fd_wksp_checkpt_v2_hdr_t)
+                   + fd_wksp_private_checkpt_v2_csz_max( sizeof(fd_wksp_checkpt_v2_info_t) )
+                   + fd_wksp_private_checkpt_v2_csz_max( FD_WKSP_CHECKPT_V2_INFO_BUF_MAX   );
+
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+      ulong frame_sz_max = cmd_csz_max;
+      ulong part_idx = fd_wksp_private_pinfo_idx( cgroup_head_cidx[ cgroup_idx ] );
+      while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+        frame_sz_max += cmd_csz_max + fd_wksp_private_checkpt_v2_csz_max( pinfo[ part_idx ].gaddr_hi - pinfo[ part_idx ].gaddr_lo );
+        part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+      }
+      cgroup_frame_sz[ cgroup_idx ] = frame_sz_max;
+      checkpt_sz_max += frame_sz_max;
+    }
+
+    checkpt_sz_max += cmd_csz_max + 2UL*fd_wksp_private_checkpt_v2_csz_max( cgroup_cnt*sizeof(ulong) ) /* appendix */
+                    + cmd_csz_max                                                                      /* volumes */
+                    + sizeof(fd_wksp_checkpt_v2_ftr_t);
+  }
+
+  /* Create the checkpt file (memory mapping requires read access) */
 
   {
+    int flags = parallel ? (O_CREAT|O_EXCL|O_RDWR) : (O_CREAT|O_EXCL|O_WRONLY);
+
     mode_t old_mask = umask( (mode_t)0 );
-    fd = open( path, O_CREAT|O_EXCL|O_WRONLY, (mode_t)mode );
+    fd = open( path, flags, (mode_t)mode );
     umask( old_mask );
     if( FD_UNLIKELY( fd==-1 ) ) {
-      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed opening file with flags_O_CREAT|O_EXCL|O_WRONLY in mode 0%03lo "
-                      "(%i-%s); attempting to continue", name, path, mode, errno, fd_io_strerror( errno ) ));
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed opening file with flags %s in mode 0%03lo "
+                      "(%i-%s); attempting to continue", name, path, parallel ? "O_CREAT|O_EXCL|O_RDWR" : "O_CREAT|O_EXCL|O_WRONLY",
+                      mode, errno, fd_io_strerror( errno ) ));
       err_fail = FD_WKSP_ERR_FAIL;
       goto fail;
     }
   }
 
-  /* Initialize the checkpt */
+  if( parallel ) {
+    if( FD_UNLIKELY( ftruncate( fd, (off_t)checkpt_sz_max ) ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when sizing file to %lu bytes (%i-%s); attempting to continue",
+                       name, path, checkpt_sz_max, errno, fd_io_strerror( errno ) ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
+    }
+
+    int err = fd_io_mmio_init( fd, FD_IO_MMIO_MODE_READ_WRITE, &mmio, &mmio_sz );
+    if( FD_UNLIKELY( err ) ) {
+
+      /* Fall back to a serial streaming checkpt */
+
+      FD_LOG_INFO(( "\"%s\" does not appear to support mmio (%i-%s); checkpointing with streaming",
+                    path, err, fd_io_strerror( err ) ));
+
+      if( FD_UNLIKELY( ftruncate( fd, (off_t)0 ) ) ) {
+        FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when resizing file (%i-%s); attempting to continue",
+                         name, path, errno, fd_io_strerror( errno ) ));
+        err_fail = FD_WKSP_ERR_FAIL;
+        goto fail;
+      }
+
+      parallel = 0;
+    }
+  }
+
+  /* Initialize the checkpt.  Frame offsets are relative to the start
+     of the file.  frame_off_base is the file offset of the first byte
+     of the current checkpt object (non-zero if a parallel checkpt has
+     restarted the checkpt after the compacted cgroup frames). */
 
   ulong frame_off[ FD_WKSP_CHECKPT_V2_CGROUP_MAX+6UL ];
-  ulong frame_cnt = 0UL;
+  ulong frame_cnt      = 0UL;
+  ulong frame_off_base = 0UL;
 
   fd_checkpt_t  _checkpt[ 1 ];
   uchar         wbuf[ FD_CHECKPT_WBUF_MIN ];
 
-  checkpt = fd_checkpt_init_stream( _checkpt, fd, wbuf, FD_CHECKPT_WBUF_MIN ); /* logs details */
+  if( parallel ) checkpt = fd_checkpt_init_mmio  ( _checkpt, mmio, mmio_sz                  ); /* logs details */
+  else           checkpt = fd_checkpt_init_stream( _checkpt, fd,   wbuf,    FD_CHECKPT_WBUF_MIN ); /* logs details */
   if( FD_UNLIKELY( !checkpt ) ) {
     FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when initializing; attempting to continue", name, path ));
     err_fail = FD_WKSP_ERR_FAIL;
@@ -308,6 +571,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
       err_fail = FD_WKSP_ERR_FAIL;                                                                                     \
       goto fail;                                                                                                       \
     }                                                                                                                  \
+    frame_off[ frame_cnt ] += frame_off_base;                                                                          \
   } while(0)
 
 # define CHECKPT_CLOSE() do {                                                                                       \
@@ -319,6 +583,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
       err_fail = FD_WKSP_ERR_FAIL;                                                                                  \
       goto fail;                                                                                                    \
     }                                                                                                               \
+    frame_off[ frame_cnt ] += frame_off_base;                                                                       \
   } while(0)
 
   /* Note: sz must be at most FD_CHECKPT_META_MAX */
@@ -369,7 +634,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
 
   {
     fd_wksp_checkpt_v2_info_t info[1];
-    char                      buf[ 65536 ];
+    char                      buf[ FD_WKSP_CHECKPT_V2_INFO_BUF_MAX ];
     char *                    p = buf;
 
     info->mode      = mode;
@@ -411,59 +676,87 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
   }
 
   /* Checkpt the volume cgroups.  Note: This implementation just
-     checkpoints 1 volume with at most CGROUP_MAX cgroup_cnt groups.
+     checkpoints 1 volume with at most CGROUP_MAX cgroup_cnt groups. */
 
-     Note: this loop can be parallelized over multiple threads if
-     willing to leave holes in the file (and then maybe do a second pass
-     to compact the holes or maybe do a planning pass and then a real
-     pass or maybe leave the holes and do a second pass of run length
-     and entropy coding or maybe write to separate files and distribute
-     as a multiple files or maybe use non-POSIX filesystem mojo to
-     stitch together the separate files to appear as one file or ...) */
+  if( !parallel ) {
 
-  for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
-
-    CHECKPT_OPEN( frame_style_compressed );
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+      int _err = fd_wksp_private_checkpt_v2_cgroup( checkpt, wksp, cgroup_head_cidx[ cgroup_idx ], frame_style_compressed,
+                                                    &frame_off[ frame_cnt ], &frame_off[ frame_cnt+1UL ] ); /* logs details */
+      if( FD_UNLIKELY( _err ) ) {
+        FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when writing cgroup %lu (%i-%s); attempting to continue",
+                         name, path, cgroup_idx, _err, fd_checkpt_strerror( _err ) ));
+        err_fail = FD_WKSP_ERR_FAIL;
+        goto fail;
+      }
+      frame_cnt++;
+    }
 
-    /* Write cgroup commands */
+  } else {
 
-    fd_wksp_checkpt_v2_cmd_t cmd[1];
+    /* Assign each cgroup frame a provisional location in the file such
+       that it can't overlap with any other frame and dispatch the
+       compression to tpool threads [t0,t1).  This assumes we are tpool
+       thread t0 and threads (t0,t1) are available for dispatch. */
 
-    ulong part_idx = fd_wksp_private_pinfo_idx( cgroup_head_cidx[ cgroup_idx ] );
-    while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+    ulong * cgroup_frame_off = frame_off + frame_cnt;
 
-      /* Command: "meta (tag,gaddr_lo,gaddr_hi)" */
+    ulong off = frame_off[ frame_cnt ];
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+      cgroup_frame_off[ cgroup_idx ] = off;
+      off += cgroup_frame_sz[ cgroup_idx ];
+    }
 
-      cmd->meta.tag      = pinfo[ part_idx ].tag;      /* Note: non-zero */
-      cmd->meta.gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-      cmd->meta.gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+    ulong cgroup_nxt[1];
 
-      CHECKPT_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( cgroup_nxt[0] ) = 0UL;
+    FD_COMPILER_MFENCE();
 
-      part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+    int _err;
+    fd_wksp_private_checkpt_v2_node( (void *)tpool, t0, t1, (void *)wksp, mmio, (ulong)frame_style_compressed,
+                                     (ulong)cgroup_head_cidx, (ulong)cgroup_frame_off, (ulong)cgroup_frame_sz,
+                                     (ulong)cgroup_nxt, cgroup_cnt, (ulong)&_err );
+    if( FD_UNLIKELY( _err ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when writing cgroups (%i-%s); attempting to continue",
+                       name, path, _err, fd_checkpt_strerror( _err ) ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
     }
 
-    /* Command: "corresponding data follows" */
-
-    cmd->data.tag        = 0UL;
-    cmd->data.cgroup_cnt = ULONG_MAX;
-    cmd->data.frame_off  = ULONG_MAX;
+    /* Compact the cgroup frames in order (a frame's final location is
+       at or before its provisional location and after the final
+       locations of all previous frames so this never clobbers a frame
+       that has not been moved yet). */
 
-    CHECKPT_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
-
-    /* Write cgroup partition data */
+    off = cgroup_frame_off[ 0 ];
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+      ulong frame_sz = cgroup_frame_sz[ cgroup_idx ];
+      if( FD_LIKELY( off<cgroup_frame_off[ cgroup_idx ] ) )
+        memmove( (uchar *)mmio + off, (uchar *)mmio + cgroup_frame_off[ cgroup_idx ], frame_sz );
+      cgroup_frame_off[ cgroup_idx ] = off;
+      off += frame_sz;
+    }
 
-    part_idx = fd_wksp_private_pinfo_idx( cgroup_head_cidx[ cgroup_idx ] );
-    while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
-      ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-      ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+    frame_cnt += cgroup_cnt;
+    frame_off[ frame_cnt ] = off;
 
-      CHECKPT_DATA( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+    /* Restart the checkpt just after the compacted frames for the
+       remaining frames. */
 
-      part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+    if( FD_UNLIKELY( !fd_checkpt_fini( checkpt ) ) ) { /* logs details */
+      checkpt  = NULL;
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
     }
 
-    CHECKPT_CLOSE();
+    checkpt = fd_checkpt_init_mmio( _checkpt, (uchar *)mmio + off, mmio_sz - off ); /* logs details */
+    if( FD_UNLIKELY( !checkpt ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when initializing; attempting to continue", name, path ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
+    }
+    frame_off_base = off;
 
   }
 
@@ -553,6 +846,22 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
     goto fail;
   }
 
+  /* If this was a parallel checkpt, unmap the file and trim it to its
+     actual size */
+
+  if( parallel ) {
+    fd_io_mmio_fini( mmio, mmio_sz );
+    mmio    = NULL;
+    mmio_sz = 0UL;
+
+    if( FD_UNLIKELY( ftruncate( fd, (off_t)frame_off[ frame_cnt ] ) ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when trimming file (%i-%s); attempting to continue",
+                       name, path, errno, fd_io_strerror( errno ) ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
+    }
+  }
+
   /* Close the file */
 
   if( FD_UNLIKELY( close( fd ) ) ) {
@@ -581,6 +890,8 @@ fail:
       FD_LOG_WARNING(( "fd_checkpt_fini failed; attempting to continue" ));
   }
 
+  if( FD_LIKELY( mmio_sz ) ) fd_io_mmio_fini( mmio, mmio_sz );
+
   if( FD_LIKELY( fd!=-1 ) && FD_UNLIKELY( close( fd ) ) )
     FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue", path, errno, fd_io_strerror( errno ) ));
 
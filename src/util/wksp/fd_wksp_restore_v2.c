@@ -469,7 +469,7 @@ fd_wksp_private_restore_v2_node( void * tpool,
     ulong cgroup_idx = FD_ATOMIC_FETCH_AND_ADD( (ulong *)_cgroup_nxt, 1UL );
     FD_COMPILER_MFENCE();
 #   else /* Note: this assumes platforms without HAS_ATOMIC will not be running this multithreaded */
-    ulong cgroup_idx = (*(ulong *)_cgroup_nxt) + 1UL;
+    ulong cgroup_idx = (*(ulong *)_cgroup_nxt)++;
 #   endif
 
     if( FD_UNLIKELY( cgroup_idx>=cgroup_cnt ) ) break; /* No more cgroups to process */
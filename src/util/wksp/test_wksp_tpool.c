@@ -1,4 +1,5 @@
 #include "../fd_util.h"
+#include "fd_wksp_private.h"
 /* FIXME: CLEANUP */
 #include <errno.h>
 #include <unistd.h>
@@ -75,6 +76,99 @@ static FD_FOR_ALL_BEGIN( alloc_test, 1L ) {
 
 } FD_FOR_ALL_END
 
+#define CGROUP_MAX (1024UL) /* At least the max cgroup_cnt of a checkpt */
+
+/* checkpt_v2_cgroups maps the v2 checkpt at path and returns a
+   pointer to the first byte of its cgroup frames.  On return, *_mmio
+   and *_mmio_sz give the mapping, *_cgroup_cnt the number of cgroups,
+   cgroup_frame_off[cgroup_idx] the offset of each cgroup frame relative
+   to the first cgroup frame, cgroup_alloc_cnt[cgroup_idx] the number of
+   allocations in each cgroup and *_sz the total size of the cgroup
+   frames.  The cgroup frames hold all the wksp allocations and, unlike
+   the info frame, should be bit-for-bit identical for a given wksp
+   regardless of how the checkpt was made. */
+
+static uchar const *
+checkpt_v2_cgroups( char const *  path,
+                    void const ** _mmio,
+                    ulong *       _mmio_sz,
+                    ulong *       _cgroup_cnt,
+                    ulong *       cgroup_frame_off,
+                    ulong *       cgroup_alloc_cnt,
+                    ulong *       _sz ) {
+  int fd = open( path, O_RDONLY, (mode_t)0 );
+  FD_TEST( fd!=-1 );
+  FD_TEST( !fd_io_mmio_init( fd, FD_IO_MMIO_MODE_READ_ONLY, _mmio, _mmio_sz ) );
+  FD_TEST( !close( fd ) );
+
+  uchar const * mmio    = (uchar const *)*_mmio;
+  ulong         mmio_sz = *_mmio_sz;
+
+  FD_TEST( mmio_sz>sizeof(fd_wksp_checkpt_v2_ftr_t) );
+  fd_wksp_checkpt_v2_ftr_t ftr[1];
+  memcpy( ftr, mmio + mmio_sz - sizeof(fd_wksp_checkpt_v2_ftr_t), sizeof(fd_wksp_checkpt_v2_ftr_t) );
+  FD_TEST( ftr->checkpt_sz==mmio_sz );
+  FD_TEST( ftr->volume_cnt==1UL );
+  FD_TEST( ftr->cgroup_cnt<=CGROUP_MAX );
+
+  fd_restore_t _restore[1];
+  fd_restore_t * restore = fd_restore_init_mmio( _restore, mmio, mmio_sz );
+  FD_TEST( restore );
+
+  fd_wksp_checkpt_v2_cmd_t cmd[1];
+
+  FD_TEST( !fd_restore_seek( restore, ftr->frame_off ) );
+  FD_TEST( !fd_restore_open( restore, ftr->frame_style_compressed ) );
+  FD_TEST( !fd_restore_meta( restore, cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) ) );
+  FD_TEST( !fd_restore_close( restore ) );
+  FD_TEST( fd_wksp_checkpt_v2_cmd_is_volumes( cmd ) );
+
+  ulong frame_off_appendix = cmd->volumes.frame_off;
+
+  FD_TEST( !fd_restore_seek( restore, frame_off_appendix ) );
+  FD_TEST( !fd_restore_open( restore, ftr->frame_style_compressed ) );
+  FD_TEST( !fd_restore_meta( restore, cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) ) );
+  FD_TEST( fd_wksp_checkpt_v2_cmd_is_appendix( cmd ) );
+  ulong cgroup_cnt = cmd->appendix.cgroup_cnt;
+  FD_TEST( cgroup_cnt==ftr->cgroup_cnt );
+  FD_TEST( !fd_restore_data( restore, cgroup_frame_off, cgroup_cnt*sizeof(ulong) ) );
+  FD_TEST( !fd_restore_data( restore, cgroup_alloc_cnt, cgroup_cnt*sizeof(ulong) ) );
+  FD_TEST( !fd_restore_close( restore ) );
+  FD_TEST( fd_restore_fini( restore ) );
+
+  ulong off0 = cgroup_cnt ? cgroup_frame_off[0] : frame_off_appendix;
+  for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) cgroup_frame_off[ cgroup_idx ] -= off0;
+
+  *_cgroup_cnt = cgroup_cnt;
+  *_sz         = frame_off_appendix - off0;
+  return mmio + off0;
+}
+
+/* checkpt_v2_cgroups_test tests the checkpts at path0 and path1 have
+   identical cgroup frames. */
+
+static void
+checkpt_v2_cgroups_test( char const * path0,
+                         char const * path1 ) {
+  static ulong frame_off0[ CGROUP_MAX ]; static ulong alloc_cnt0[ CGROUP_MAX ];
+  static ulong frame_off1[ CGROUP_MAX ]; static ulong alloc_cnt1[ CGROUP_MAX ];
+
+  void const * mmio0; ulong mmio_sz0; ulong cgroup_cnt0; ulong sz0;
+  void const * mmio1; ulong mmio_sz1; ulong cgroup_cnt1; ulong sz1;
+
+  uchar const * cgroups0 = checkpt_v2_cgroups( path0, &mmio0, &mmio_sz0, &cgroup_cnt0, frame_off0, alloc_cnt0, &sz0 );
+  uchar const * cgroups1 = checkpt_v2_cgroups( path1, &mmio1, &mmio_sz1, &cgroup_cnt1, frame_off1, alloc_cnt1, &sz1 );
+
+  FD_TEST( cgroup_cnt0==cgroup_cnt1 );
+  FD_TEST( sz0==sz1 );
+  FD_TEST( !memcmp( frame_off0, frame_off1, cgroup_cnt0*sizeof(ulong) ) );
+  FD_TEST( !memcmp( alloc_cnt0, alloc_cnt1, cgroup_cnt0*sizeof(ulong) ) );
+  FD_TEST( !memcmp( cgroups0,   cgroups1,   sz0                       ) );
+
+  fd_io_mmio_fini( mmio1, mmio_sz1 );
+  fd_io_mmio_fini( mmio0, mmio_sz0 );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -89,10 +183,14 @@ main( int     argc,
   ulong        page_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",   NULL,             1UL );
   ulong        near_cpu   = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu",   NULL, fd_log_cpu_id() );
   ulong        iter_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-max",   NULL,           100UL );
+  ulong        bench_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--bench-cnt",  NULL,             3UL );
 
   char tmp_path[256];
   if( !path ) path = fd_cstr_printf( tmp_path, 256UL, NULL, "/tmp/test_wksp_tpool.%lu.%li", fd_log_group_id(), fd_log_wallclock() );
 
+  char ref_path[ 4096 ];
+  FD_TEST( fd_cstr_printf_check( ref_path, 4096UL, NULL, "%s.ref", path ) );
+
   ulong mode = fd_cstr_to_ulong_octal( _mode );
 
   FD_LOG_NOTICE(( "Using --path %s --mode 0%03lo --keep %i", path, mode, keep ));
@@ -164,6 +262,16 @@ main( int     argc,
 
     FD_TEST( !fd_wksp_checkpt_tpool( tpool, t0, t1, wksp, path, mode, style, "test_wksp_tpool" ) );
 
+    /* Make a serial checkpt with the same style and verify the
+       allocations were checkpointed bit-for-bit identically */
+
+    if( style!=FD_WKSP_CHECKPT_STYLE_V1 ) {
+      unlink( ref_path );
+      FD_TEST( !fd_wksp_checkpt( wksp, ref_path, mode, style, "test_wksp_tpool" ) );
+      checkpt_v2_cgroups_test( path, ref_path );
+      unlink( ref_path );
+    }
+
     /* Zero out all the allocations */
 
     FD_FOR_ALL( alloc_zero, tpool,0UL,worker_cnt, 0L,alloc_cnt, wksp, info );
@@ -183,6 +291,49 @@ main( int     argc,
     /* TODO: TEST THERE ARE NO OTHER ALLOCATIONS IN THE WKSP TOO! */
   }
 
+  if( bench_cnt ) {
+
+    /* Fill the wksp with large allocations of moderately compressible
+       data and benchmark checkpt / restore throughput for increasing
+       numbers of threads. */
+
+    fd_wksp_reset( wksp, fd_rng_uint( rng ) );
+
+    fd_wksp_usage_t usage[1];
+    fd_wksp_usage( wksp, NULL, 0UL, usage );
+    ulong sz = fd_ulong_max( usage->free_sz / 4096UL, 1UL );
+
+    ulong data_sz = 0UL;
+    for(;;) {
+      ulong gaddr = fd_wksp_alloc( wksp, 1UL, sz, 1UL );
+      if( FD_UNLIKELY( !gaddr ) ) break;
+      uchar * p = (uchar *)fd_wksp_laddr_fast( wksp, gaddr );
+      for( ulong off=0UL; off<sz; off++ ) p[ off ] = (uchar)fd_rng_uint_roll( rng, 16U );
+      data_sz += sz;
+    }
+
+    for( ulong thread_cnt=1UL; thread_cnt<=worker_cnt; thread_cnt = fd_ulong_if( thread_cnt<worker_cnt, fd_ulong_min( 2UL*thread_cnt, worker_cnt ), worker_cnt+1UL ) ) {
+      long dt_checkpt = LONG_MAX;
+      long dt_restore = LONG_MAX;
+      for( ulong bench_idx=0UL; bench_idx<bench_cnt; bench_idx++ ) {
+        unlink( path );
+        long dt = -fd_log_wallclock();
+        FD_TEST( !fd_wksp_checkpt_tpool( tpool, 0UL, thread_cnt, wksp, path, mode, FD_WKSP_CHECKPT_STYLE_DEFAULT, "bench" ) );
+        dt += fd_log_wallclock();
+        dt_checkpt = fd_long_min( dt_checkpt, dt );
+
+        dt = -fd_log_wallclock();
+        FD_TEST( !fd_wksp_restore_tpool( tpool, 0UL, thread_cnt, wksp, path, fd_rng_uint( rng ) ) );
+        dt += fd_log_wallclock();
+        dt_restore = fd_long_min( dt_restore, dt );
+      }
+      FD_LOG_NOTICE(( "bench (%lu threads, %.3f GiB): checkpt %.3f GiB/s, restore %.3f GiB/s", thread_cnt,
+                      (double)data_sz / (double)(1UL<<30),
+                      (double)data_sz / (double)dt_checkpt / 1.073741824,
+                      (double)data_sz / (double)dt_restore / 1.073741824 ));
+    }
+  }
+
   FD_LOG_NOTICE(( "Cleaning up" ));
 
   if( FD_LIKELY( !keep ) && FD_UNLIKELY( unlink( path ) ) )
@@ -5,4 +5,10 @@ $(call make-unit-test,test_vinyl_io_bd,test_vinyl_io_bd,fd_vinyl fd_tango fd_uti
 $(call make-unit-test,test_vinyl_io_mm,test_vinyl_io_mm,fd_vinyl fd_tango fd_util)
 $(call run-unit-test,test_vinyl_io_bd)
 $(call run-unit-test,test_vinyl_io_mm)
+ifdef FD_HAS_LINUX
+$(call add-objs,fd_vinyl_io_ur,fd_vinyl)
+$(call make-unit-test,test_vinyl_io_ur,test_vinyl_io_ur,fd_vinyl fd_tango fd_util)
+$(call make-unit-test,bench_vinyl_io,bench_vinyl_io,fd_vinyl fd_tango fd_util)
+$(call run-unit-test,test_vinyl_io_ur)
+endif
 endif
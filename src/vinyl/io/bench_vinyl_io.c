@@ -0,0 +1,214 @@
+/* bench_vinyl_io compares the throughput of the fd_vinyl_io
+   implementations (mm, bd and ur) on the same bstream store.  For each
+   implementation, it appends pair sized chunks to fill a fresh bstream
+   (via the scratch pad like the vinyl tile does), then does random
+   immediate reads and random batched reads (batch reads in flight, the
+   way the vinyl tile issues reads for a burst of acquires).
+
+   Unless --path is an uncached block device, bd and ur reads are served
+   from the page cache such that this measures the per request software
+   overhead of each implementation (which is what batching and
+   registered resources reduce). */
+
+#include "../fd_vinyl.h"
+
+#include <stdlib.h> /* For mkstemp, aligned_alloc */
+#include <errno.h>  /* For errno */
+#include <unistd.h> /* For ftruncate */
+#include <fcntl.h>  /* For open */
+
+static fd_vinyl_io_t *
+io_init( char const * type,
+         void *       mem,
+         ulong        spad_max,
+         int          fd,
+         void *       mmio,
+         ulong        mmio_sz,
+         ulong        depth,
+         int          sqpoll,
+         ulong        io_seed ) {
+  if( !strcmp( type, "mm" ) ) return fd_vinyl_io_mm_init( mem, spad_max, mmio, mmio_sz, 1, "bench", 6UL, io_seed );
+  if( !strcmp( type, "bd" ) ) return fd_vinyl_io_bd_init( mem, spad_max, fd,            1, "bench", 6UL, io_seed );
+  if( !strcmp( type, "ur" ) ) return fd_vinyl_io_ur_init( mem, spad_max, fd, depth, sqpoll ? FD_VINYL_IO_UR_FLAG_SQPOLL : 0,
+                                                          1, "bench", 6UL, io_seed );
+  FD_LOG_ERR(( "unsupported --type %s", type ));
+}
+
+static void
+bench( char const * type,
+       void *       mem,
+       ulong        spad_max,
+       int          fd,
+       void *       mmio,
+       ulong        mmio_sz,
+       ulong        depth,
+       int          sqpoll,
+       ulong        io_seed,
+       ulong        wr_sz,
+       ulong        rd_sz,
+       ulong        batch,
+       ulong        iter_max,
+       uchar *      rd_buf,
+       fd_rng_t *   rng ) {
+
+  fd_vinyl_io_t * io = io_init( type, mem, spad_max, fd, mmio, mmio_sz, depth, sqpoll, io_seed );
+  if( FD_UNLIKELY( !io ) ) {
+    FD_LOG_WARNING(( "skip: --type %s init failed", type ));
+    return;
+  }
+
+  /* Fill ~3/4 of the store (leaving room for the store's own
+     bookkeeping) */
+
+  ulong fill_sz = fd_ulong_align_dn( (mmio_sz - FD_VINYL_BSTREAM_BLOCK_SZ)/4UL*3UL, wr_sz );
+
+  long dt = -fd_log_wallclock();
+  for( ulong off=0UL; off<fill_sz; off+=wr_sz ) {
+    uchar * buf = (uchar *)fd_vinyl_io_alloc( io, wr_sz, FD_VINYL_IO_FLAG_BLOCKING );
+    memset( buf, (int)(off / wr_sz), wr_sz );
+    fd_vinyl_io_append( io, buf, wr_sz );
+  }
+  FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+  dt += fd_log_wallclock();
+
+  double append_gbps = (double)fill_sz / (double)dt;
+
+  ulong seq_past    = fd_vinyl_io_seq_past   ( io );
+  ulong seq_present = fd_vinyl_io_seq_present( io );
+  ulong rd_cnt      = (seq_present - seq_past - rd_sz) / FD_VINYL_BSTREAM_BLOCK_SZ;
+
+  /* Random immediate reads */
+
+  dt = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iter_max; iter++ ) {
+    ulong seq = seq_past + FD_VINYL_BSTREAM_BLOCK_SZ*fd_rng_ulong_roll( rng, rd_cnt );
+    fd_vinyl_io_read_imm( io, seq, rd_buf, rd_sz );
+  }
+  dt += fd_log_wallclock();
+
+  double read_imm_ns = (double)dt / (double)iter_max;
+
+  /* Random batched reads */
+
+  fd_vinyl_io_rd_t * rd = (fd_vinyl_io_rd_t *)aligned_alloc( alignof(fd_vinyl_io_rd_t), batch*sizeof(fd_vinyl_io_rd_t) );
+  FD_TEST( rd );
+
+  ulong iter_cnt = fd_ulong_max( iter_max / batch, 1UL );
+
+  dt = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    for( ulong idx=0UL; idx<batch; idx++ ) {
+      rd[ idx ].ctx = idx;
+      rd[ idx ].seq = seq_past + FD_VINYL_BSTREAM_BLOCK_SZ*fd_rng_ulong_roll( rng, rd_cnt );
+      rd[ idx ].dst = rd_buf + idx*rd_sz;
+      rd[ idx ].sz  = rd_sz;
+      fd_vinyl_io_read( io, rd + idx );
+    }
+    for( ulong rem=batch; rem; rem-- ) {
+      fd_vinyl_io_rd_t * _rd;
+      FD_TEST( !fd_vinyl_io_poll( io, &_rd, FD_VINYL_IO_FLAG_BLOCKING ) );
+    }
+  }
+  dt += fd_log_wallclock();
+
+  ulong  read_cnt  = iter_cnt*batch;
+  double read_mops = 1e3*(double)read_cnt / (double)dt;
+  double read_gbps = (double)(read_cnt*rd_sz) / (double)dt;
+
+  free( rd );
+
+  FD_LOG_NOTICE(( "--type %s"
+                  "\n\tappend         %7.3f GB/s (--wr-sz %lu)"
+                  "\n\tread_imm       %7.1f ns/read (--rd-sz %lu)"
+                  "\n\tread (batched) %7.3f Mread/s, %7.3f GB/s (--batch %lu)",
+                  type, append_gbps, wr_sz, read_imm_ns, rd_sz, read_mops, read_gbps, batch ));
+
+  FD_TEST( fd_vinyl_io_fini( io )==mem );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _type    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--type",     NULL,                "all" );
+  char const * path     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--path",     NULL,                 NULL );
+  ulong        dev_sz   = fd_env_strip_cmdline_ulong( &argc, &argv, "--dev-sz",   NULL,            1UL << 30 );
+  ulong        spad_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--spad-max", NULL, fd_vinyl_io_spad_est() );
+  ulong        io_seed  = fd_env_strip_cmdline_ulong( &argc, &argv, "--io-seed",  NULL,               1234UL );
+  ulong        depth    = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth",    NULL,                 64UL );
+  int          sqpoll   = fd_env_strip_cmdline_int  ( &argc, &argv, "--sqpoll",   NULL,                    0 );
+  ulong        wr_sz    = fd_env_strip_cmdline_ulong( &argc, &argv, "--wr-sz",    NULL,              65536UL );
+  ulong        rd_sz    = fd_env_strip_cmdline_ulong( &argc, &argv, "--rd-sz",    NULL,               4096UL );
+  ulong        batch    = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch",    NULL,                 32UL );
+  ulong        iter_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-max", NULL,           (ulong)1e6 );
+  ulong        seed     = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",     NULL,               5678UL );
+
+  spad_max = fd_ulong_align_up( spad_max, FD_VINYL_BSTREAM_BLOCK_SZ );
+  dev_sz   = fd_ulong_align_dn( dev_sz,   FD_VINYL_BSTREAM_BLOCK_SZ );
+
+  if( FD_UNLIKELY( !( fd_ulong_is_aligned( wr_sz, FD_VINYL_BSTREAM_BLOCK_SZ ) & (0UL<wr_sz) & (wr_sz<=spad_max) ) ) )
+    FD_LOG_ERR(( "--wr-sz should be a positive BLOCK_SZ multiple of at most --spad-max" ));
+  if( FD_UNLIKELY( !( fd_ulong_is_aligned( rd_sz, FD_VINYL_BSTREAM_BLOCK_SZ ) & (0UL<rd_sz) & (rd_sz<dev_sz/2UL) ) ) )
+    FD_LOG_ERR(( "--rd-sz should be a positive BLOCK_SZ multiple much smaller than --dev-sz" ));
+  if( FD_UNLIKELY( !batch ) ) FD_LOG_ERR(( "--batch should be positive" ));
+
+  FD_LOG_NOTICE(( "Using --type %s --dev-sz %lu --spad-max %lu --io-seed %lu --depth %lu --sqpoll %i "
+                  "--wr-sz %lu --rd-sz %lu --batch %lu --iter-max %lu --seed %lu",
+                  _type, dev_sz, spad_max, io_seed, depth, sqpoll, wr_sz, rd_sz, batch, iter_max, seed ));
+
+  fd_rng_t rng[1]; fd_rng_join( fd_rng_new( rng, (uint)seed, 0UL ) );
+
+  char _path[] = "/tmp/bench_vinyl_io.XXXXXX";
+
+  int fd;
+  int tmp = !path;
+  if( FD_UNLIKELY( path ) ) {
+    FD_LOG_NOTICE(( "Using --path %s for the store", path ));
+    fd = open( path, O_RDWR | O_CREAT, (mode_t)0644 );
+    if( FD_UNLIKELY( fd==-1 ) ) FD_LOG_ERR(( "open failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  } else {
+    FD_LOG_NOTICE(( "--path not specified, using a temp file for the store" ));
+    fd = mkstemp( _path );
+    if( FD_UNLIKELY( fd==-1 ) ) FD_LOG_ERR(( "mkstemp failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    path = _path;
+  }
+
+  if( FD_UNLIKELY( ftruncate( fd, (off_t)dev_sz ) ) )
+    FD_LOG_ERR(( "ftruncate failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  void * mmio;
+  ulong  mmio_sz;
+  int err = fd_io_mmio_init( fd, FD_IO_MMIO_MODE_READ_WRITE, &mmio, &mmio_sz );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_io_mmio_init failed (%i-%s)", err, fd_io_strerror( err ) ));
+
+  ulong align     = fd_ulong_max( fd_ulong_max( fd_vinyl_io_mm_align(), fd_vinyl_io_bd_align() ), fd_vinyl_io_ur_align() );
+  ulong footprint = fd_ulong_max( fd_ulong_max( fd_vinyl_io_mm_footprint( spad_max ), fd_vinyl_io_bd_footprint( spad_max ) ),
+                                  fd_vinyl_io_ur_footprint( spad_max ) );
+  FD_TEST( footprint );
+
+  void *  mem    = aligned_alloc( align, fd_ulong_align_up( footprint, align ) );                 FD_TEST( mem    );
+  uchar * rd_buf = (uchar *)aligned_alloc( FD_VINYL_BSTREAM_BLOCK_SZ, fd_ulong_max( batch, 1UL )*rd_sz ); FD_TEST( rd_buf );
+
+  static char const * type_all[3] = { "mm", "bd", "ur" };
+  int all = !strcmp( _type, "all" );
+  for( ulong idx=0UL; idx<(all ? 3UL : 1UL); idx++ )
+    bench( all ? type_all[ idx ] : _type, mem, spad_max, fd, mmio, mmio_sz, depth, sqpoll, io_seed,
+           wr_sz, rd_sz, batch, iter_max, rd_buf, rng );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  free( rd_buf );
+  free( mem );
+
+  fd_io_mmio_fini( mmio, mmio_sz );
+
+  if( FD_UNLIKELY( close( fd ) ) ) FD_LOG_WARNING(( "close failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( tmp && FD_UNLIKELY( unlink( path ) ) ) FD_LOG_WARNING(( "unlink failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -539,6 +539,55 @@ fd_vinyl_io_mm_init( void *       lmem,
                      ulong        info_sz,
                      ulong        io_seed );
 
+/* fd_vinyl_io_ur *****************************************************/
+
+/* fd_vinyl_io_ur_* is the same as fd_vinyl_io_bd_* but moves data with
+   a Linux io_uring instance owned by the io.  The result is bit-level
+   identical to fd_vinyl_io_bd (and vice versa).  Specifically:
+
+   - fd_vinyl_io_read only prepares the request.  Reads started between
+     polls are submitted to the kernel as a single batch on the next
+     fd_vinyl_io_poll and reads complete in completion order (not
+     necessarily the order they were started).
+
+   - appends and copies are written asynchronously (the scratch pad is
+     registered with the kernel as a fixed buffer such that writes out
+     of the scratch pad skip the per request page pinning).  commit
+     waits for all writes in flight to complete.
+
+   - read_imm and sync are synchronous (they are latency sensitive and
+     issued one at a time).
+
+   depth is the maximum number of io_uring requests in flight (a power
+   of 2 in [2,FD_VINYL_IO_UR_DEPTH_MAX]).  flags is a bit-or of
+   FD_VINYL_IO_UR_FLAG_*.  If SQPOLL is set, the ring uses a kernel
+   submission queue poller thread such that the caller can submit
+   requests without a system call (at the cost of a kernel thread
+   spinning while the io is busy).
+
+   dev_fd is registered with the ring (it should not be closed while
+   the io is in use).  init requires io_uring support from the kernel
+   and will fail (logs details) if not available.  fini waits for
+   any in-flight requests and destroys the ring. */
+
+#define FD_VINYL_IO_UR_DEPTH_MAX   (4096UL)
+
+#define FD_VINYL_IO_UR_FLAG_SQPOLL (1) /* Use a kernel submission queue poller */
+
+ulong fd_vinyl_io_ur_align    ( void );
+ulong fd_vinyl_io_ur_footprint( ulong spad_max );
+
+fd_vinyl_io_t *
+fd_vinyl_io_ur_init( void *       lmem,
+                     ulong        spad_max,
+                     int          dev_fd,
+                     ulong        depth,
+                     int          flags,
+                     int          reset,
+                     void const * info,
+                     ulong        info_sz,
+                     ulong        io_seed );
+
 /* fd_vinyl_{mmio,mmio_sz} return {a pointer in the caller's address
    space to the raw bstream storage,the raw bstream storage byte size).
    These are a _subset_ of the dev / dev_sz region passed to mm_init and
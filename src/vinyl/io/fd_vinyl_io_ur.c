@@ -0,0 +1,965 @@
+#include "fd_vinyl_io.h"
+#include "../../util/io_uring/fd_io_uring_setup.h"
+#include "../../util/io_uring/fd_io_uring_register.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+/* FD_VINYL_IO_UR_SQE_MAX is the largest number of bytes a single
+   io_uring read / write request will move (the SQE len field is 32
+   bits).  Larger requests are split into multiple SQEs. */
+
+#define FD_VINYL_IO_UR_SQE_MAX (1UL<<30)
+
+/* FD_VINYL_IO_UR_SQPOLL_IDLE is how long (in ms) the kernel submission
+   queue poller thread spins without work before going to sleep. */
+
+#define FD_VINYL_IO_UR_SQPOLL_IDLE (1000U)
+
+static inline void
+ur_read( int    fd,
+         ulong  off,
+         void * buf,
+         ulong  sz ) {
+  ssize_t ssz = pread( fd, buf, sz, (off_t)off );
+  if( FD_LIKELY( ssz==(ssize_t)sz ) ) return;
+  if( ssz<(ssize_t)0 ) FD_LOG_CRIT(( "pread(fd %i,off %lu,sz %lu) failed (%i-%s)", fd, off, sz, errno, fd_io_strerror( errno ) ));
+  /**/                 FD_LOG_CRIT(( "pread(fd %i,off %lu,sz %lu) failed (unexpected sz %li)", fd, off, sz, (long)ssz ));
+}
+
+static inline void
+ur_write( int          fd,
+          ulong        off,
+          void const * buf,
+          ulong        sz ) {
+  ssize_t ssz = pwrite( fd, buf, sz, (off_t)off );
+  if( FD_LIKELY( ssz==(ssize_t)sz ) ) return;
+  if( ssz<(ssize_t)0 ) FD_LOG_CRIT(( "pwrite(fd %i,off %lu,sz %lu) failed (%i-%s)", fd, off, sz, errno, fd_io_strerror( errno ) ));
+  else                 FD_LOG_CRIT(( "pwrite(fd %i,off %lu,sz %lu) failed (unexpected sz %li)", fd, off, sz, (long)ssz ));
+}
+
+struct fd_vinyl_io_ur_rd;
+typedef struct fd_vinyl_io_ur_rd fd_vinyl_io_ur_rd_t;
+
+struct fd_vinyl_io_ur_rd {
+  ulong                 ctx;  /* Must mirror fd_vinyl_io_rd_t */
+  ulong                 seq;  /* " */
+  void *                dst;  /* " */
+  ulong                 sz;   /* " */
+  fd_vinyl_io_ur_rd_t * next; /* Next element in ur completed rd queue */
+  ulong                 done; /* Bytes read so far */
+  ulong                 pend; /* Number of SQEs for this read still in flight */
+};
+
+FD_STATIC_ASSERT( sizeof(fd_vinyl_io_ur_rd_t)<=sizeof(fd_vinyl_io_rd_t), layout );
+
+struct fd_vinyl_io_ur {
+  fd_vinyl_io_t            base[1];
+  int                      dev_fd;       /* File descriptor of block device (registered as fixed file 0) */
+  ulong                    dev_sync;     /* Offset to block that holds bstream sync (BLOCK_SZ multiple) */
+  ulong                    dev_base;     /* Offset to first block (BLOCK_SZ multiple) */
+  ulong                    dev_sz;       /* Block store byte size (BLOCK_SZ multiple) */
+  fd_io_uring_t            ring[1];      /* io_uring instance (spad registered as fixed buffer 0) */
+  ulong                    depth;        /* Max SQEs in flight (ring sq and cq depth) */
+  int                      sqpoll;       /* Non-zero if the ring uses a kernel submission queue poller */
+  ulong                    sqe_pend;     /* Number of SQEs prepared but not yet published to the kernel */
+  ulong                    sqe_inflight; /* Number of SQEs published whose CQE was not yet reaped (includes sqe_pend) */
+  ulong                    rd_inflight;  /* Number of reads with SQEs in flight */
+  ulong                    wr_inflight;  /* Number of write SQEs in flight */
+  ulong                    wr_sz;        /* Bytes of appends / copies started since the last commit */
+  ulong                    wr_done;      /* Bytes of appends / copies completed since the last commit */
+  fd_vinyl_io_ur_rd_t *    rd_head;      /* Pointer to completed queue head */
+  fd_vinyl_io_ur_rd_t **   rd_tail_next; /* Pointer to completed queue &tail->next or &rd_head if empty. */
+  fd_vinyl_bstream_block_t sync[1];
+  /* spad_max bytes follow */
+};
+
+typedef struct fd_vinyl_io_ur fd_vinyl_io_ur_t;
+
+/* ur_submit publishes all prepared SQEs to the kernel and, if wait is
+   non-zero, blocks the caller until at least one completion is
+   available.  With a submission queue poller, publishing is just a
+   store of the queue tail (plus a wakeup if the poller went idle) and
+   a syscall is only made if the caller needs to wait. */
+
+static void
+ur_submit( fd_vinyl_io_ur_t * ur,
+           int                wait ) {
+  fd_io_uring_sq_t * sq = ur->ring->sq;
+
+  uint flags = wait ? (uint)IORING_ENTER_GETEVENTS : 0U;
+
+  if( ur->sqpoll ) {
+    atomic_store_explicit( sq->ktail, sq->sqe_tail, memory_order_release );
+    atomic_thread_fence( memory_order_seq_cst );
+    if( FD_UNLIKELY( atomic_load_explicit( sq->kflags, memory_order_relaxed ) & IORING_SQ_NEED_WAKEUP ) )
+      flags |= (uint)IORING_ENTER_SQ_WAKEUP;
+    ur->sqe_pend = 0UL;
+    if( !flags ) return;
+    for(;;) {
+      int res = fd_io_uring_enter( ur->ring->ioring_fd, 0U, (uint)!!wait, flags, NULL, 0UL );
+      if( FD_LIKELY( res>=0 ) ) return;
+      if( FD_UNLIKELY( errno!=EINTR ) ) FD_LOG_CRIT(( "io_uring_enter() failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    }
+  }
+
+  if( FD_UNLIKELY( !ur->sqe_pend && !wait ) ) return;
+
+  for(;;) {
+    int res = fd_io_uring_submit( sq, ur->ring->ioring_fd, (uint)!!wait, flags );
+    if( FD_LIKELY( res>=0 ) ) {
+      ur->sqe_pend -= fd_ulong_min( (ulong)res, ur->sqe_pend );
+      if( FD_LIKELY( !ur->sqe_pend ) ) return;
+      continue;
+    }
+    if( FD_UNLIKELY( errno!=EINTR && errno!=EAGAIN ) ) FD_LOG_CRIT(( "io_uring_enter() failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+}
+
+/* ur_rd_done moves a read whose SQEs have all completed to the
+   completed queue. */
+
+static inline void
+ur_rd_done( fd_vinyl_io_ur_t *    ur,
+            fd_vinyl_io_ur_rd_t * rd ) {
+  if( FD_UNLIKELY( rd->done!=rd->sz ) )
+    FD_LOG_CRIT(( "bstream read [%016lx,%016lx)/%lu failed (unexpected sz %lu)", rd->seq, rd->seq+rd->sz, rd->sz, rd->done ));
+  rd->next          = NULL;
+  *ur->rd_tail_next = rd;
+  ur->rd_tail_next  = &rd->next;
+  ur->rd_inflight--;
+}
+
+/* ur_reap processes all available completions.  Completed reads are
+   moved to the completed queue in completion order and completed
+   writes are accumulated into wr_done.  Any failed or short transfer
+   is fatal (matching the synchronous backends). */
+
+static void
+ur_reap( fd_vinyl_io_ur_t * ur ) {
+  fd_io_uring_cq_t * cq  = ur->ring->cq;
+  uint               cnt = fd_io_uring_cq_ready( cq );
+
+  for( uint i=0U; i<cnt; i++ ) {
+    struct io_uring_cqe * cqe = &cq->cqes[ (atomic_load_explicit( cq->khead, memory_order_relaxed ) + i) & (cq->depth-1UL) ];
+
+    ulong user_data = (ulong)cqe->user_data;
+    int   res       = cqe->res;
+
+    if( FD_UNLIKELY( res<0 ) )
+      FD_LOG_CRIT(( "io_uring %s failed (%i-%s)", user_data ? "read" : "write", -res, fd_io_strerror( -res ) ));
+
+    if( !user_data ) { /* append / copy write */
+      ur->wr_done += (ulong)res;
+      ur->wr_inflight--;
+    } else {           /* read */
+      fd_vinyl_io_ur_rd_t * rd = (fd_vinyl_io_ur_rd_t *)user_data;
+      rd->done += (ulong)res;
+      if( !--rd->pend ) ur_rd_done( ur, rd );
+    }
+  }
+
+  fd_io_uring_cq_advance( cq, cnt );
+  ur->sqe_inflight -= cnt;
+}
+
+/* ur_sqe returns a free SQE, submitting and waiting for completions if
+   the ring is at capacity.  Keeping at most depth SQEs in flight
+   guarantees the completion queue (also depth entries) never
+   overflows. */
+
+static struct io_uring_sqe *
+ur_sqe( fd_vinyl_io_ur_t * ur ) {
+  while( FD_UNLIKELY( ur->sqe_inflight>=ur->depth ) ) {
+    ur_submit( ur, 1 );
+    ur_reap( ur );
+  }
+
+  struct io_uring_sqe * sqe;
+  for(;;) {
+    sqe = fd_io_uring_get_sqe( ur->ring->sq );
+    if( FD_LIKELY( sqe ) ) break;
+    /* Only possible with a submission queue poller that has not yet
+       consumed previously published entries. */
+    ur_submit( ur, 0 );
+    fd_io_uring_sq_space_left( ur->ring->sq );
+    FD_SPIN_PAUSE();
+  }
+
+  memset( sqe, 0, sizeof(struct io_uring_sqe) );
+  ur->sqe_pend++;
+  ur->sqe_inflight++;
+  return sqe;
+}
+
+/* ur_prep prepares SQEs to transfer sz bytes between buf and the
+   device at byte offset off (no wrap around).  Returns the number of
+   SQEs used. */
+
+static ulong
+ur_prep( fd_vinyl_io_ur_t * ur,
+         int                opcode,
+         ulong              off,
+         void *             buf,
+         ulong              sz,
+         ulong              user_data ) {
+  ulong cnt = 0UL;
+  while( sz ) {
+    ulong csz = fd_ulong_min( sz, FD_VINYL_IO_UR_SQE_MAX );
+
+    struct io_uring_sqe * sqe = ur_sqe( ur );
+    sqe->opcode    = (uchar)opcode;
+    sqe->flags     = IOSQE_FIXED_FILE;
+    sqe->fd        = 0; /* dev_fd */
+    sqe->off       = off;
+    sqe->addr      = (ulong)buf;
+    sqe->len       = (uint)csz;
+    sqe->buf_index = 0; /* spad (only used by WRITE_FIXED) */
+    sqe->user_data = user_data;
+
+    off += csz;
+    buf  = (uchar *)buf + csz;
+    sz  -= csz;
+    cnt++;
+  }
+  return cnt;
+}
+
+/* ur_write_start starts writing sz bytes at src to device offset off.
+   Uses the registered buffer if src is entirely in the scratch pad. */
+
+static void
+ur_write_start( fd_vinyl_io_ur_t * ur,
+                ulong              off,
+                void const *       src,
+                ulong              sz ) {
+  ulong spad0 = (ulong)(ur+1);
+  ulong spad1 = spad0 + ur->base->spad_max;
+  ulong src0  = (ulong)src;
+  int   fixed = (spad0<=src0) & ((src0+sz)<=spad1);
+  ur->wr_inflight += ur_prep( ur, fixed ? FD_IORING_OP_WRITE_FIXED : FD_IORING_OP_WRITE, off, (void *)src, sz, 0UL );
+  ur->wr_sz       += sz;
+}
+
+/* ur_write_wait waits for all started writes to complete.  Returns
+   FD_VINYL_SUCCESS if there are no writes in flight and
+   FD_VINYL_ERR_AGAIN if there are and blocking is zero. */
+
+static int
+ur_write_wait( fd_vinyl_io_ur_t * ur,
+               int                blocking ) {
+  ur_submit( ur, 0 );
+  ur_reap( ur );
+
+  while( ur->wr_inflight ) {
+    if( !blocking ) return FD_VINYL_ERR_AGAIN;
+    ur_submit( ur, 1 );
+    ur_reap( ur );
+  }
+
+  if( FD_UNLIKELY( ur->wr_done!=ur->wr_sz ) )
+    FD_LOG_CRIT(( "bstream write failed (short write, %lu of %lu bytes)", ur->wr_done, ur->wr_sz ));
+
+  ur->wr_sz   = 0UL;
+  ur->wr_done = 0UL;
+
+  return FD_VINYL_SUCCESS;
+}
+
+static void
+fd_vinyl_io_ur_read_imm( fd_vinyl_io_t * io,
+                         ulong           seq0,
+                         void *          _dst,
+                         ulong           sz ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io;  /* Note: io must be non-NULL to have even been called */
+
+  /* If this is a request to read nothing, succeed immediately.  If
+     this is a request to read outside the bstream's past, fail. */
+
+  if( FD_UNLIKELY( !sz ) ) return;
+
+  uchar * dst  = (uchar *)_dst;
+  ulong   seq1 = seq0 + sz;
+
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+
+  int bad_seq  = !fd_ulong_is_aligned( seq0, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dst  = !dst;
+  int bad_sz   = !fd_ulong_is_aligned( sz,   FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_past = !(fd_vinyl_seq_le( seq_past, seq0 ) & fd_vinyl_seq_lt( seq0, seq1 ) & fd_vinyl_seq_le( seq1, seq_present ));
+
+  if( FD_UNLIKELY( bad_seq | bad_dst | bad_sz | bad_past ) )
+    FD_LOG_CRIT(( "bstream read_imm [%016lx,%016lx)/%lu failed (past [%016lx,%016lx)/%lu, %s)",
+                  seq0, seq1, sz, seq_past, seq_present, seq_present-seq_past,
+                  bad_seq ? "misaligned seq" :
+                  bad_dst ? "NULL dst"       :
+                  bad_sz  ? "misaligned sz"  :
+                            "not in past" ));
+
+  /* An immediate read is on the caller's critical path.  A plain pread
+     has the lowest latency for a single request (no ring round trip)
+     and the bstream past is never written by in-flight appends. */
+
+  int   dev_fd   = ur->dev_fd;
+  ulong dev_base = ur->dev_base;
+  ulong dev_sz   = ur->dev_sz;
+
+  ulong dev_off = seq0 % dev_sz;
+
+  ulong rsz = fd_ulong_min( sz, dev_sz - dev_off );
+  ur_read( dev_fd, dev_base + dev_off, dst, rsz );
+  sz -= rsz;
+
+  if( FD_UNLIKELY( sz ) ) ur_read( dev_fd, dev_base, dst + rsz, sz );
+}
+
+static void
+fd_vinyl_io_ur_read( fd_vinyl_io_t *    io,
+                     fd_vinyl_io_rd_t * _rd ) {
+  fd_vinyl_io_ur_t *    ur = (fd_vinyl_io_ur_t *)   io;  /* Note: io must be non-NULL to have even been called */
+  fd_vinyl_io_ur_rd_t * rd = (fd_vinyl_io_ur_rd_t *)_rd;
+
+  ulong   seq0 =          rd->seq;
+  uchar * dst  = (uchar *)rd->dst;
+  ulong   sz   =          rd->sz;
+
+  /* If this is a request to read nothing, succeed immediately.  If
+     this is a request to read outside the bstream's past, fail. */
+
+  if( FD_UNLIKELY( !sz ) ) {
+    rd->next          = NULL;
+    *ur->rd_tail_next = rd;
+    ur->rd_tail_next  = &rd->next;
+    return;
+  }
+
+  ulong seq1 = seq0 + sz;
+
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+
+  int bad_seq  = !fd_ulong_is_aligned( seq0, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dst  = !dst;
+  int bad_sz   = !fd_ulong_is_aligned( sz,   FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_past = !(fd_vinyl_seq_le( seq_past, seq0 ) & fd_vinyl_seq_lt( seq0, seq1 ) & fd_vinyl_seq_le( seq1, seq_present ));
+
+  if( FD_UNLIKELY( bad_seq | bad_dst | bad_sz | bad_past ) )
+    FD_LOG_CRIT(( "bstream read [%016lx,%016lx)/%lu failed (past [%016lx,%016lx)/%lu, %s)",
+                  seq0, seq1, sz, seq_past, seq_present, seq_present-seq_past,
+                  bad_seq ? "misaligned seq" :
+                  bad_dst ? "NULL dst"       :
+                  bad_sz  ? "misaligned sz"  :
+                            "not in past" ));
+
+  /* At this point, we have a valid read request.  Map seq0 into the
+     bstream store and prepare SQEs for the lesser of sz bytes or until
+     the store end (and the wrapped remainder at the store start).  The
+     SQEs are not submitted here such that a burst of reads is submitted
+     to the kernel with a single syscall on the next poll. */
+
+  ulong dev_base = ur->dev_base;
+  ulong dev_sz   = ur->dev_sz;
+
+  ulong dev_off = seq0 % dev_sz;
+
+  /* ur_sqe might reap completions of this read's earlier SQEs while
+     later ones are being prepared.  pend starts huge such that the read
+     can't complete until its SQE count is known. */
+
+  rd->done = 0UL;
+  rd->pend = ULONG_MAX;
+  ur->rd_inflight++;
+
+  ulong rsz = fd_ulong_min( sz, dev_sz - dev_off );
+  ulong cnt = ur_prep( ur, FD_IORING_OP_READ, dev_base + dev_off, dst, rsz, (ulong)rd );
+  sz -= rsz;
+
+  if( FD_UNLIKELY( sz ) ) cnt += ur_prep( ur, FD_IORING_OP_READ, dev_base, dst + rsz, sz, (ulong)rd );
+
+  rd->pend -= ULONG_MAX - cnt;
+  if( FD_UNLIKELY( !rd->pend ) ) ur_rd_done( ur, rd );
+}
+
+static int
+fd_vinyl_io_ur_poll( fd_vinyl_io_t *     io,
+                     fd_vinyl_io_rd_t ** _rd,
+                     int                 flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t * )io; /* Note: io must be non-NULL to have even been called */
+
+  int blocking = !!(flags & FD_VINYL_IO_FLAG_BLOCKING);
+
+  /* Publish any batched reads and reap what has completed.  Without a
+     submission queue poller, completions are only posted when we enter
+     the kernel so a non-blocking poll with reads in flight enters (but
+     does not wait). */
+
+  if( ur->sqe_pend | (!ur->sqpoll & !ur->rd_head & !!ur->rd_inflight) ) ur_submit( ur, 0 );
+  ur_reap( ur );
+
+  fd_vinyl_io_ur_rd_t * rd = ur->rd_head;
+
+  while( FD_UNLIKELY( !rd ) ) {
+    if( FD_UNLIKELY( !ur->rd_inflight ) ) {
+      *_rd = NULL;
+      return FD_VINYL_ERR_EMPTY;
+    }
+    if( !blocking ) {
+      *_rd = NULL;
+      return FD_VINYL_ERR_AGAIN;
+    }
+    ur_submit( ur, 1 );
+    ur_reap( ur );
+    rd = ur->rd_head;
+  }
+
+  fd_vinyl_io_ur_rd_t ** rd_tail_next = ur->rd_tail_next;
+  fd_vinyl_io_ur_rd_t *  rd_next      = rd->next;
+
+  ur->rd_head      = rd_next;
+  ur->rd_tail_next = fd_ptr_if( !!rd_next, rd_tail_next, &ur->rd_head );
+
+  *_rd = (fd_vinyl_io_rd_t *)rd;
+  return FD_VINYL_SUCCESS;
+}
+
+static ulong
+fd_vinyl_io_ur_append( fd_vinyl_io_t * io,
+                       void const *    _src,
+                       ulong           sz ) {
+  fd_vinyl_io_ur_t * ur  = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+  uchar const *      src = (uchar const *)_src;
+
+  /* Validate the input args. */
+
+  ulong seq_future  = ur->base->seq_future;  if( FD_UNLIKELY( !sz ) ) return seq_future;
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong dev_base    = ur->dev_base;
+  ulong dev_sz      = ur->dev_sz;
+
+  int bad_src      = !src;
+  int bad_align    = !fd_ulong_is_aligned( (ulong)src, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_sz       = !fd_ulong_is_aligned( sz,         FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_capacity = sz > (dev_sz - (seq_future-seq_ancient));
+
+  if( FD_UNLIKELY( bad_src | bad_align | bad_sz | bad_capacity ) )
+    FD_LOG_CRIT(( bad_src   ? "NULL src"       :
+                  bad_align ? "misaligned src" :
+                  bad_sz    ? "misaligned sz"  :
+                              "device full" ));
+
+  /* At this point, we appear to have a valid append request.  Map it to
+     the bstream (updating seq_future) and map it to the device.  Then
+     start writing the lesser of sz bytes or until the store end (and
+     the wrapped remainder at the store start).  The caller promises src
+     is not modified until the next commit, which waits for the writes
+     to complete. */
+
+  ulong seq = seq_future;
+  ur->base->seq_future = seq + sz;
+
+  ulong dev_off = seq % dev_sz;
+
+  ulong wsz = fd_ulong_min( sz, dev_sz - dev_off );
+  ur_write_start( ur, dev_base + dev_off, src, wsz );
+  sz -= wsz;
+  if( sz ) ur_write_start( ur, dev_base, src + wsz, sz );
+
+  return seq;
+}
+
+static int
+fd_vinyl_io_ur_commit( fd_vinyl_io_t * io,
+                       int             flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  int err = ur_write_wait( ur, !!(flags & FD_VINYL_IO_FLAG_BLOCKING) );
+  if( FD_UNLIKELY( err ) ) return err;
+
+  ur->base->seq_present = ur->base->seq_future;
+  ur->base->spad_used   = 0UL;
+
+  return FD_VINYL_SUCCESS;
+}
+
+static ulong
+fd_vinyl_io_ur_hint( fd_vinyl_io_t * io,
+                     ulong           sz ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  ulong seq_future  = ur->base->seq_future;  if( FD_UNLIKELY( !sz ) ) return seq_future;
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong dev_sz      = ur->dev_sz;
+
+  int bad_sz       = !fd_ulong_is_aligned( sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_capacity = sz > (dev_sz - (seq_future-seq_ancient));
+
+  if( FD_UNLIKELY( bad_sz | bad_capacity ) ) FD_LOG_CRIT(( bad_sz ? "misaligned sz" : "device full" ));
+
+  return ur->base->seq_future;
+}
+
+static void *
+fd_vinyl_io_ur_alloc( fd_vinyl_io_t * io,
+                      ulong           sz,
+                      int             flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  ulong spad_max  = ur->base->spad_max;
+  ulong spad_used = ur->base->spad_used; if( FD_UNLIKELY( !sz ) ) return ((uchar *)(ur+1)) + spad_used;
+
+  int bad_align = !fd_ulong_is_aligned( sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_sz    = sz > spad_max;
+
+  if( FD_UNLIKELY( bad_align | bad_sz ) ) FD_LOG_CRIT(( bad_align ? "misaligned sz" : "sz too large" ));
+
+  if( FD_UNLIKELY( sz > (spad_max - spad_used ) ) ) {
+    if( FD_UNLIKELY( fd_vinyl_io_ur_commit( io, flags ) ) ) return NULL;
+    spad_used = 0UL;
+  }
+
+  ur->base->spad_used = spad_used + sz;
+
+  return ((uchar *)(ur+1)) + spad_used;
+}
+
+static ulong
+fd_vinyl_io_ur_copy( fd_vinyl_io_t * io,
+                     ulong           seq_src0,
+                     ulong           sz ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Validate the input args */
+
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;   if( FD_UNLIKELY( !sz ) ) return seq_future;
+  ulong spad_max    = ur->base->spad_max;
+  int   dev_fd      = ur->dev_fd;
+  ulong dev_base    = ur->dev_base;
+  ulong dev_sz      = ur->dev_sz;
+
+  ulong seq_src1 = seq_src0 + sz;
+
+  int bad_past     = !( fd_vinyl_seq_le( seq_past, seq_src0    ) &
+                        fd_vinyl_seq_lt( seq_src0, seq_src1    ) &
+                        fd_vinyl_seq_le( seq_src1, seq_present ) );
+  int bad_src      = !fd_ulong_is_aligned( seq_src0, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_sz       = !fd_ulong_is_aligned( sz,       FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_capacity = sz > (dev_sz - (seq_future-seq_ancient));
+
+  if( FD_UNLIKELY( bad_past | bad_src | bad_sz | bad_capacity ) )
+    FD_LOG_CRIT(( bad_past ? "src is not in the past"    :
+                  bad_src  ? "misaligned src_seq"        :
+                  bad_sz   ? "misaligned sz"             :
+                             "device full" ));
+
+  /* At this point, we appear to have a valid copy request.  Map the dst
+     to the bstream (updating seq_future) and map the src and dst
+     regions onto the device.  Then copy as much as we can at a time,
+     handling device wrap around.  Since writes complete asynchronously,
+     each chunk gets its own region of the scratch pad.  When the
+     scratch pad is exhausted, we wait for the writes in flight to
+     complete to recycle it (there are no live allocations at this
+     point and, unlike a commit, this does not move the partial copy
+     into the bstream's past). */
+
+  ulong seq = seq_future;
+  ur->base->seq_future = seq + sz;
+
+  ulong seq_dst0 = seq;
+
+  for(;;) {
+    ulong spad_used = ur->base->spad_used;
+    if( FD_UNLIKELY( spad_used==spad_max ) ) {
+      ur_write_wait( ur, 1 );
+      spad_used = 0UL;
+    }
+
+    uchar * buf = (uchar *)(ur+1) + spad_used;
+
+    ulong src_off = seq_src0 % dev_sz;
+    ulong dst_off = seq_dst0 % dev_sz;
+    ulong csz     = fd_ulong_min( fd_ulong_min( sz, spad_max - spad_used ), fd_ulong_min( dev_sz - src_off, dev_sz - dst_off ) );
+
+    ur_read( dev_fd, dev_base + src_off, buf, csz );
+    ur_write_start( ur, dev_base + dst_off, buf, csz );
+    ur->base->spad_used = spad_used + csz;
+
+    sz -= csz;
+    if( !sz ) break;
+
+    seq_src0 += csz;
+    seq_dst0 += csz;
+  }
+
+  return seq;
+}
+
+static void
+fd_vinyl_io_ur_forget( fd_vinyl_io_t * io,
+                       ulong           seq ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Validate input arguments (see fd_vinyl_io_bd_forget for details) */
+
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;
+
+  int bad_seq    = !fd_ulong_is_aligned( seq, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dir    = !(fd_vinyl_seq_le( seq_past, seq ) & fd_vinyl_seq_le( seq, seq_present ));
+  int bad_read   = (!!ur->rd_head) | (!!ur->rd_inflight);
+  int bad_append = fd_vinyl_seq_ne( seq_present, seq_future );
+
+  if( FD_UNLIKELY( bad_seq | bad_dir | bad_read | bad_append ) )
+    FD_LOG_CRIT(( "forget to seq %016lx failed (past [%016lx,%016lx)/%lu, %s)",
+                  seq, seq_past, seq_present, seq_present-seq_past,
+                  bad_seq  ? "misaligned seq"             :
+                  bad_dir  ? "seq out of bounds"          :
+                  bad_read ? "reads in progress"          :
+                             "appends/copies in progress" ));
+
+  ur->base->seq_past = seq;
+}
+
+static void
+fd_vinyl_io_ur_rewind( fd_vinyl_io_t * io,
+                       ulong           seq ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  /* Validate input arguments (see fd_vinyl_io_bd_rewind for details) */
+
+  ulong seq_ancient = ur->base->seq_ancient;
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;
+
+  int bad_seq    = !fd_ulong_is_aligned( seq, FD_VINYL_BSTREAM_BLOCK_SZ );
+  int bad_dir    = fd_vinyl_seq_gt( seq, seq_present );
+  int bad_read   = (!!ur->rd_head) | (!!ur->rd_inflight);
+  int bad_append = fd_vinyl_seq_ne( seq_present, seq_future );
+
+  if( FD_UNLIKELY( bad_seq | bad_dir | bad_read | bad_append ) )
+    FD_LOG_CRIT(( "rewind to seq %016lx failed (present %016lx, %s)", seq, seq_present,
+                  bad_seq  ? "misaligned seq"             :
+                  bad_dir  ? "seq after seq_present"      :
+                  bad_read ? "reads in progress"          :
+                             "appends/copies in progress" ));
+
+  ur->base->seq_ancient = fd_ulong_if( fd_vinyl_seq_ge( seq, seq_ancient ), seq_ancient, seq );
+  ur->base->seq_past    = fd_ulong_if( fd_vinyl_seq_ge( seq, seq_past    ), seq_past,    seq );
+  ur->base->seq_present = seq;
+  ur->base->seq_future  = seq;
+}
+
+static int
+fd_vinyl_io_ur_sync( fd_vinyl_io_t * io,
+                     int             flags ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+  (void)flags;
+
+  ulong seed        = ur->base->seed;
+  ulong seq_past    = ur->base->seq_past;
+  ulong seq_present = ur->base->seq_present;
+
+  int   dev_fd       = ur->dev_fd;
+  ulong dev_sync     = ur->dev_sync;
+
+  fd_vinyl_bstream_block_t * block = ur->sync;
+
+  /* block->sync.ctl     current (static) */
+  block->sync.seq_past    = seq_past;
+  block->sync.seq_present = seq_present;
+  /* block->sync.info_sz current (static) */
+  /* block->sync.info    current (static) */
+
+  block->sync.hash_trail  = 0UL;
+  block->sync.hash_blocks = 0UL;
+  fd_vinyl_bstream_block_hash( seed, block ); /* sets hash_trail back to seed */
+
+  /* The bstream past is fully written by construction (commit waits
+     for all writes) so the sync block can be written directly. */
+
+  ur_write( dev_fd, dev_sync, block, FD_VINYL_BSTREAM_BLOCK_SZ );
+
+  ur->base->seq_ancient = seq_past;
+
+  return FD_VINYL_SUCCESS;
+}
+
+static void *
+fd_vinyl_io_ur_fini( fd_vinyl_io_t * io ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)io; /* Note: io must be non-NULL to have even been called */
+
+  ulong seq_present = ur->base->seq_present;
+  ulong seq_future  = ur->base->seq_future;
+
+  if( FD_UNLIKELY( ur->rd_head || ur->rd_inflight             ) ) FD_LOG_WARNING(( "fini completing outstanding reads" ));
+  if( FD_UNLIKELY( fd_vinyl_seq_ne( seq_present, seq_future ) ) ) FD_LOG_WARNING(( "fini discarding uncommited blocks" ));
+
+  /* The kernel might still be writing into caller memory, so wait for
+     everything in flight before tearing down the ring. */
+
+  ur_submit( ur, 0 );
+  ur_reap( ur );
+  while( ur->sqe_inflight ) {
+    ur_submit( ur, 1 );
+    ur_reap( ur );
+  }
+
+  fd_io_uring_fini( ur->ring );
+
+  return io;
+}
+
+static fd_vinyl_io_impl_t fd_vinyl_io_ur_impl[1] = { {
+  fd_vinyl_io_ur_read_imm,
+  fd_vinyl_io_ur_read,
+  fd_vinyl_io_ur_poll,
+  fd_vinyl_io_ur_append,
+  fd_vinyl_io_ur_commit,
+  fd_vinyl_io_ur_hint,
+  fd_vinyl_io_ur_alloc,
+  fd_vinyl_io_ur_copy,
+  fd_vinyl_io_ur_forget,
+  fd_vinyl_io_ur_rewind,
+  fd_vinyl_io_ur_sync,
+  fd_vinyl_io_ur_fini
+} };
+
+FD_STATIC_ASSERT( alignof(fd_vinyl_io_ur_t)==FD_VINYL_BSTREAM_BLOCK_SZ, layout );
+
+ulong
+fd_vinyl_io_ur_align( void ) {
+  return alignof(fd_vinyl_io_ur_t);
+}
+
+ulong
+fd_vinyl_io_ur_footprint( ulong spad_max ) {
+  if( FD_UNLIKELY( !((0UL<spad_max) & (spad_max<(1UL<<63)) & fd_ulong_is_aligned( spad_max, FD_VINYL_BSTREAM_BLOCK_SZ )) ) )
+    return 0UL;
+  return sizeof(fd_vinyl_io_ur_t) + spad_max;
+}
+
+fd_vinyl_io_t *
+fd_vinyl_io_ur_init( void *       mem,
+                     ulong        spad_max,
+                     int          dev_fd,
+                     ulong        depth,
+                     int          flags,
+                     int          reset,
+                     void const * info,
+                     ulong        info_sz,
+                     ulong        io_seed ) {
+  fd_vinyl_io_ur_t * ur = (fd_vinyl_io_ur_t *)mem;
+
+  if( FD_UNLIKELY( !ur ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)ur, fd_vinyl_io_ur_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_vinyl_io_ur_footprint( spad_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad spad_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((2UL<=depth) & (depth<=FD_VINYL_IO_UR_DEPTH_MAX) & fd_ulong_is_pow2( depth )) ) ) {
+    FD_LOG_WARNING(( "bad depth" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( flags & ~FD_VINYL_IO_UR_FLAG_SQPOLL ) ) {
+    FD_LOG_WARNING(( "bad flags" ));
+    return NULL;
+  }
+
+  off_t _dev_sz = lseek( dev_fd, (off_t)0, SEEK_END );
+  if( FD_UNLIKELY( _dev_sz<(off_t)0 ) ) {
+    FD_LOG_WARNING(( "lseek failed, bstream must be seekable (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+  ulong dev_sz = (ulong)_dev_sz;
+
+  ulong dev_sz_min = 3UL*FD_VINYL_BSTREAM_BLOCK_SZ /* sync block, move block, closing partition */
+                   + fd_vinyl_bstream_pair_sz( FD_VINYL_VAL_MAX ); /* worst case pair (FIXME: LZ4_COMPRESSBOUND?) */
+
+  int too_small  = dev_sz < dev_sz_min;
+  int too_large  = dev_sz > (ulong)LONG_MAX;
+  int misaligned = !fd_ulong_is_aligned( dev_sz, FD_VINYL_BSTREAM_BLOCK_SZ );
+
+  if( FD_UNLIKELY( too_small | too_large | misaligned ) ) {
+    FD_LOG_WARNING(( "bstream size %s", too_small ? "too small" :
+                                        too_large ? "too large" :
+                                                    "not a block size multiple" ));
+    return NULL;
+  }
+
+  if( reset ) {
+    if( FD_UNLIKELY( !info ) ) info_sz = 0UL;
+    if( FD_UNLIKELY( info_sz>FD_VINYL_BSTREAM_SYNC_INFO_MAX ) ) {
+      FD_LOG_WARNING(( "info_sz too large" ));
+      return NULL;
+    }
+  }
+
+  memset( ur, 0, footprint );
+
+  ur->base->type = FD_VINYL_IO_TYPE_UR;
+
+  /* io_seed, seq_ancient, seq_past, seq_present, seq_future are init
+     below */
+
+  ur->base->spad_max  = spad_max;
+  ur->base->spad_used = 0UL;
+  ur->base->impl      = fd_vinyl_io_ur_impl;
+
+  ur->dev_fd   = dev_fd;
+  ur->dev_sync = 0UL;                            /* Use the beginning of the file for the sync block */
+  ur->dev_base = FD_VINYL_BSTREAM_BLOCK_SZ;      /* Use the rest for the actual bstream store (at least 3.5 KiB) */
+  ur->dev_sz   = dev_sz - FD_VINYL_BSTREAM_BLOCK_SZ;
+
+  ur->depth  = depth;
+  ur->sqpoll = !!(flags & FD_VINYL_IO_UR_FLAG_SQPOLL);
+
+  ur->rd_head      = NULL;
+  ur->rd_tail_next = &ur->rd_head;
+
+  /* The on device format is identical to fd_vinyl_io_bd (see
+     fd_vinyl_io_bd_init for details). */
+
+  fd_vinyl_bstream_block_t * block = ur->sync;
+
+  if( reset ) {
+
+    /* We are starting a new bstream.  Write the initial sync block. */
+
+    ur->base->seed        = io_seed;
+    ur->base->seq_ancient = 0UL;
+    ur->base->seq_past    = 0UL;
+    ur->base->seq_present = 0UL;
+    ur->base->seq_future  = 0UL;
+
+    memset( block, 0, FD_VINYL_BSTREAM_BLOCK_SZ ); /* bulk zero */
+
+    block->sync.ctl         = fd_vinyl_bstream_ctl( FD_VINYL_BSTREAM_CTL_TYPE_SYNC, 0, FD_VINYL_VAL_MAX );
+  //block->sync.seq_past    = ...; /* init by sync */
+  //block->sync.seq_present = ...; /* init by sync */
+    block->sync.info_sz     = info_sz;
+    if( info_sz ) memcpy( block->sync.info, info, info_sz );
+  //block->sync.hash_trail  = ...; /* init by sync */
+  //block->sync.hash_blocks = ...; /* init by sync */
+
+    int err = fd_vinyl_io_ur_sync( ur->base, FD_VINYL_IO_FLAG_BLOCKING ); /* logs details */
+    if( FD_UNLIKELY( err ) ) {
+      FD_LOG_WARNING(( "sync block write failed (%i-%s)", err, fd_vinyl_strerror( err ) ));
+      return NULL;
+    }
+
+  } else {
+
+    /* We are resuming an existing bstream.  Read and validate the
+       bstream's sync block. */
+
+    ur_read( dev_fd, ur->dev_sync, block, FD_VINYL_BSTREAM_BLOCK_SZ ); /* logs details */
+
+    int   type        = fd_vinyl_bstream_ctl_type ( block->sync.ctl );
+    int   version     = fd_vinyl_bstream_ctl_style( block->sync.ctl );
+    ulong val_max     = fd_vinyl_bstream_ctl_sz   ( block->sync.ctl );
+    ulong seq_past    = block->sync.seq_past;
+    ulong seq_present = block->sync.seq_present;
+    /**/  info_sz     = block->sync.info_sz;    // overrides user info_sz
+    /**/  info        = block->sync.info;       // overrides user info
+    /**/  io_seed     = block->sync.hash_trail; // overrides user io_seed
+
+    int bad_type        = (type != FD_VINYL_BSTREAM_CTL_TYPE_SYNC);
+    int bad_version     = (version != 0);
+    int bad_val_max     = (val_max != FD_VINYL_VAL_MAX);
+    int bad_seq_past    = !fd_ulong_is_aligned( seq_past,    FD_VINYL_BSTREAM_BLOCK_SZ );
+    int bad_seq_present = !fd_ulong_is_aligned( seq_present, FD_VINYL_BSTREAM_BLOCK_SZ );
+    int bad_info_sz     = (info_sz > FD_VINYL_BSTREAM_SYNC_INFO_MAX);
+    int bad_past_order  = fd_vinyl_seq_gt( seq_past, seq_present );
+    int bad_past_sz     = ((seq_present-seq_past) > ur->dev_sz);
+
+    if( FD_UNLIKELY( bad_type | bad_version | bad_val_max | bad_seq_past | bad_seq_present | bad_info_sz |
+                     bad_past_order | bad_past_sz ) ) {
+      FD_LOG_WARNING(( "bad sync block when recovering bstream (%s)",
+                       bad_type        ? "unexpected type"                             :
+                       bad_version     ? "unexpected version"                          :
+                       bad_val_max     ? "unexpected max pair value decoded byte size" :
+                       bad_seq_past    ? "unaligned seq_past"                          :
+                       bad_seq_present ? "unaligned seq_present"                       :
+                       bad_info_sz     ? "unexpected info size"                        :
+                       bad_past_order  ? "unordered seq_past and seq_present"          :
+                                         "past size larger than bstream store" ));
+      return NULL;
+    }
+
+    if( FD_UNLIKELY( fd_vinyl_bstream_block_test( io_seed, block ) ) ) {
+      FD_LOG_WARNING(( "corrupt sync block when recovering bstream" ));
+      return NULL;
+    }
+
+    ur->base->seed        = io_seed;
+    ur->base->seq_ancient = seq_past;
+    ur->base->seq_past    = seq_past;
+    ur->base->seq_present = seq_present;
+    ur->base->seq_future  = seq_present;
+
+  }
+
+  /* Create the ring.  dev_fd is registered as fixed file 0 (saves the
+     per request fget/fput) and the scratch pad as fixed buffer 0 (saves
+     the per request page pinning for appends and copies out of the
+     scratch pad).  A submission queue poller is incompatible with the
+     cooperative task run modes. */
+
+  fd_io_uring_params_t params[1];
+  fd_io_uring_params_init( params, (uint)depth );
+  if( ur->sqpoll ) {
+    params->flags          |= IORING_SETUP_SQPOLL;
+    params->sq_thread_idle  = FD_VINYL_IO_UR_SQPOLL_IDLE;
+  } else {
+    params->flags          |= IORING_SETUP_COOP_TASKRUN | IORING_SETUP_DEFER_TASKRUN;
+  }
+
+  if( FD_UNLIKELY( !fd_io_uring_init_mmap( ur->ring, params ) ) ) {
+    FD_LOG_WARNING(( "io_uring_setup failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  struct iovec spad_iov[1] = {{ .iov_base = (void *)(ur+1), .iov_len = spad_max }};
+
+  char const * fail = NULL;
+  if(      FD_UNLIKELY( fd_io_uring_register_files  ( ur->ring->ioring_fd, &dev_fd,  1UL )<0 ) ) fail = "io_uring_register_files";
+  else if( FD_UNLIKELY( fd_io_uring_register_buffers( ur->ring->ioring_fd, spad_iov, 1UL )<0 ) ) fail = "io_uring_register_buffers";
+  else if( FD_UNLIKELY( fd_io_uring_enable_rings    ( ur->ring->ioring_fd                )<0 ) ) fail = "io_uring_enable_rings";
+  if( FD_UNLIKELY( fail ) ) {
+    FD_LOG_WARNING(( "%s failed (%i-%s)", fail, errno, fd_io_strerror( errno ) ));
+    fd_io_uring_fini( ur->ring );
+    return NULL;
+  }
+
+  FD_LOG_NOTICE(( "IO config"
+                  "\n\ttype     ur"
+                  "\n\tspad_max %lu bytes"
+                  "\n\tdev_sz   %lu bytes"
+                  "\n\tdepth    %lu"
+                  "\n\tsqpoll   %i"
+                  "\n\treset    %i"
+                  "\n\tinfo     \"%s\" (info_sz %lu%s)"
+                  "\n\tio_seed  0x%016lx%s",
+                  spad_max, dev_sz, depth, ur->sqpoll, reset,
+                  info ? (char const *)info : "", info_sz, reset ? "" : ", discovered",
+                  io_seed, reset ? "" : " (discovered)" ));
+
+  return ur->base;
+}
@@ -10,6 +10,15 @@ static ulong seq_future;
 
 static uchar bcache[ BCACHE_SZ ];
 
+/* io has a read interest in append sources until the next commit
+   (matters for implementations that write asynchronously).  Appends
+   are sourced from append_buf, which is recycled on commit. */
+
+#define APPEND_BUF_SZ (1UL<<20)
+
+static uchar append_buf[ APPEND_BUF_SZ ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+static ulong append_buf_used;
+
 static void
 bcache_read( ulong seq0, void * _dst, ulong sz ) {
   if( !sz ) return;
@@ -61,7 +70,8 @@ bcache_copy( ulong seq_src0, ulong sz ) {
 
 static int
 bcache_commit( void ) {
-  seq_present = seq_future;
+  seq_present     = seq_future;
+  append_buf_used = 0UL;
   return FD_VINYL_SUCCESS;
 }
 
@@ -109,11 +119,18 @@ test( fd_vinyl_io_t * io,
       ulong dev_free = BCACHE_SZ - (seq_future-seq_ancient);
       ulong sz       = fd_ulong_min( FD_VINYL_BSTREAM_BLOCK_SZ*fd_rng_coin_tosses( rng ), fd_ulong_min( dev_free, 16384UL ) );
 
-      uchar buf[ 16384 ] __attribute__((aligned(FD_VINYL_BSTREAM_BLOCK_SZ)));
+      if( FD_UNLIKELY( sz > APPEND_BUF_SZ-append_buf_used ) ) {
+        FD_TEST( !bcache_commit() );
+        FD_TEST( !fd_vinyl_io_commit( io, FD_VINYL_IO_FLAG_BLOCKING ) );
+      }
 
       void * src;
       if( !sz ) src = (void *)fd_rng_ulong( rng );
-      else      src = buf, memset( buf, (int)(fd_rng_uint( rng ) & 255U), sz );
+      else {
+        src = append_buf + append_buf_used;
+        append_buf_used += sz;
+        memset( src, (int)(fd_rng_uint( rng ) & 255U), sz );
+      }
 
       ulong seq_ref  =      bcache_append(     src, sz );
       ulong seq_tst  = fd_vinyl_io_append( io, src, sz );
@@ -1,2 +1,2 @@
-$(call add-hdrs,fd_quic_crypto_suites.h)
-$(call add-objs,fd_quic_crypto_suites,fd_quic)
+$(call add-hdrs,fd_quic_crypto_suites.h fd_quic_crypto_batch.h)
+$(call add-objs,fd_quic_crypto_suites fd_quic_crypto_batch,fd_quic)
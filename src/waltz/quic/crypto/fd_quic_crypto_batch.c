@@ -0,0 +1,122 @@
+#include "fd_quic_crypto_batch.h"
+
+#if FD_HAS_AESNI
+#include "../../../util/simd/fd_sse.h"
+#endif
+
+/* Header protection **************************************************/
+
+#if FD_HAS_AESNI
+
+/* HP_LANE_CNT independent AES-128 encryptions are in flight at once.
+   AESENC has a latency of ~4 cycles and a throughput of 1 or 2 per
+   cycle on recent x86 cores, so 8 lanes keep the pipeline full.  The
+   round keys are expanded on the fly alongside the rounds, which hides
+   the latency of the key expansion chain behind the other lanes too. */
+
+#define HP_LANE_CNT (8UL)
+
+static inline vb_t
+hp_expand_step( vb_t k,
+                vb_t a ) {
+  a = _mm_shuffle_epi32( a, 0xff );
+  k = vb_xor( k, _mm_slli_si128( k, 4 ) );
+  k = vb_xor( k, _mm_slli_si128( k, 4 ) );
+  k = vb_xor( k, _mm_slli_si128( k, 4 ) );
+  return vb_xor( k, a );
+}
+
+static void
+hp_mask_lanes( uchar                                 mask[][ 16 ],
+               fd_quic_crypto_keys_t const * const * keys,
+               uchar const * const *                 sample,
+               ulong                                 cnt ) {
+  vb_t k[ HP_LANE_CNT ];
+  vb_t s[ HP_LANE_CNT ];
+  for( ulong l=0UL; l<HP_LANE_CNT; l++ ) {
+    ulong i = l<cnt ? l : 0UL; /* idle lanes redo lane 0 */
+    k[ l ] = vb_ldu( keys[ i ]->hp_key );
+    s[ l ] = vb_xor( vb_ldu( sample[ i ] ), k[ l ] );
+  }
+
+# define ROUND( rcon ) do {                                                       \
+    for( ulong l=0UL; l<HP_LANE_CNT; l++ ) {                                      \
+      k[ l ] = hp_expand_step( k[ l ], _mm_aeskeygenassist_si128( k[ l ], (rcon) ) ); \
+      s[ l ] = _mm_aesenc_si128( s[ l ], k[ l ] );                                \
+    }                                                                             \
+  } while(0)
+  ROUND( 0x01 ); ROUND( 0x02 ); ROUND( 0x04 ); ROUND( 0x08 ); ROUND( 0x10 );
+  ROUND( 0x20 ); ROUND( 0x40 ); ROUND( 0x80 ); ROUND( 0x1B );
+# undef ROUND
+
+  for( ulong l=0UL; l<HP_LANE_CNT; l++ ) {
+    k[ l ] = hp_expand_step( k[ l ], _mm_aeskeygenassist_si128( k[ l ], 0x36 ) );
+    s[ l ] = _mm_aesenclast_si128( s[ l ], k[ l ] );
+  }
+  for( ulong l=0UL; l<cnt; l++ ) vb_stu( mask[ l ], s[ l ] );
+}
+
+void
+fd_quic_crypto_hp_mask_batch( uchar                                 mask[][ 16 ],
+                              fd_quic_crypto_keys_t const * const * keys,
+                              uchar const * const *                 sample,
+                              ulong                                 cnt ) {
+  for( ulong i=0UL; i<cnt; i+=HP_LANE_CNT ) {
+    hp_mask_lanes( mask+i, keys+i, sample+i, fd_ulong_min( cnt-i, HP_LANE_CNT ) );
+  }
+}
+
+#else /* portable */
+
+void
+fd_quic_crypto_hp_mask_batch( uchar                                 mask[][ 16 ],
+                              fd_quic_crypto_keys_t const * const * keys,
+                              uchar const * const *                 sample,
+                              ulong                                 cnt ) {
+  fd_aes_key_t ecb[1];
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_aes_set_encrypt_key( keys[ i ]->hp_key, 128, ecb );
+    fd_aes_encrypt( sample[ i ], mask[ i ], ecb );
+  }
+}
+
+#endif /* FD_HAS_AESNI */
+
+/* Payload decryption *************************************************/
+
+/* GCM_SLOT_CNT AEAD key setups are kept around during a batch.  A
+   batch usually carries packets of a handful of connections, with
+   those of the same connection close together. */
+
+#define GCM_SLOT_CNT (4UL)
+
+ulong
+fd_quic_crypto_decrypt_batch( fd_quic_crypto_dec_t const * dec,
+                              ulong                        cnt ) {
+  fd_aes_gcm_t                  gcm     [ GCM_SLOT_CNT ] __attribute__((aligned(FD_AES_GCM_ALIGN)));
+  fd_quic_crypto_keys_t const * gcm_keys[ GCM_SLOT_CNT ] = { NULL };
+  ulong                         gcm_next = 0UL;
+
+  ulong ok = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_quic_crypto_dec_t const * d = dec+i;
+
+    uchar nonce[ FD_QUIC_NONCE_SZ ];
+    fd_quic_get_nonce( nonce, d->keys->iv, d->pkt_number );
+
+    ulong slot;
+    for( slot=0UL; slot<GCM_SLOT_CNT && gcm_keys[ slot ]!=d->keys; slot++ ) {}
+    if( FD_LIKELY( slot<GCM_SLOT_CNT ) ) {
+      fd_aes_gcm_set_iv( gcm+slot, nonce );
+    } else {
+      slot             = gcm_next;
+      gcm_next         = (gcm_next+1UL) % GCM_SLOT_CNT;
+      gcm_keys[ slot ] = d->keys;
+      fd_aes_128_gcm_init( gcm+slot, d->keys->pkt_key, nonce );
+    }
+
+    int decrypt_ok = fd_aes_gcm_decrypt( gcm+slot, d->ct, d->pt, d->ct_sz, d->hdr, d->hdr_sz, d->ct+d->ct_sz );
+    ok |= (ulong)(!!decrypt_ok) << i;
+  }
+  return ok;
+}
@@ -0,0 +1,69 @@
+#ifndef HEADER_fd_src_waltz_quic_crypto_fd_quic_crypto_batch_h
+#define HEADER_fd_src_waltz_quic_crypto_fd_quic_crypto_batch_h
+
+#include "fd_quic_crypto_suites.h"
+
+/* fd_quic_crypto_batch provides batched variants of the receive side
+   packet protection APIs in fd_quic_crypto_suites.h.  Removing
+   protection from one small packet at a time leaves the AES units
+   mostly idle: each header protection mask is a single dependent chain
+   of AES rounds, and each payload decryption starts with an AES key
+   expansion and GHASH key setup that usually costs more than the
+   decryption itself.  The batched APIs instead
+
+   - compute the header protection masks of a batch of packets with
+     their AES-ECB lanes interleaved, so that the rounds of independent
+     packets overlap in the AES pipeline, and
+
+   - set up each distinct AEAD key of a batch once and decrypt all
+     packets protected with it, only switching the nonce in between.
+
+   Results are identical to those of the one packet at a time APIs. */
+
+/* FD_QUIC_CRYPTO_BATCH_MAX is the max number of packets per batch. */
+
+#define FD_QUIC_CRYPTO_BATCH_MAX (16UL)
+
+/* fd_quic_crypto_dec_t describes the payload decryption of one packet
+   for fd_quic_crypto_decrypt_batch. */
+
+struct fd_quic_crypto_dec {
+  fd_quic_crypto_keys_t const * keys;       /* packet protection keys */
+  ulong                         pkt_number; /* reconstructed packet number */
+  uchar const *                 hdr;        /* unprotected header (AAD) */
+  ulong                         hdr_sz;
+  uchar const *                 ct;         /* ct_sz bytes of ciphertext followed by the auth tag */
+  ulong                         ct_sz;
+  uchar *                       pt;         /* ct_sz bytes of plaintext written here */
+};
+
+typedef struct fd_quic_crypto_dec fd_quic_crypto_dec_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_quic_crypto_hp_mask_batch computes the header protection masks of
+   cnt packets, cnt in [0,FD_QUIC_CRYPTO_BATCH_MAX].  mask[i] is set to
+   the AES-128 encryption of the FD_QUIC_HP_SAMPLE_SZ bytes at sample[i]
+   under keys[i]->hp_key, to be applied with fd_quic_crypto_hp_unmask. */
+
+void
+fd_quic_crypto_hp_mask_batch( uchar                                 mask[][ 16 ],
+                              fd_quic_crypto_keys_t const * const * keys,
+                              uchar const * const *                 sample,
+                              ulong                                 cnt );
+
+/* fd_quic_crypto_decrypt_batch authenticates and decrypts the payloads
+   of cnt packets, cnt in [0,FD_QUIC_CRYPTO_BATCH_MAX].  Packets sharing
+   the same keys pointer share the AEAD key setup.  Returns a bit mask
+   where bit i is set if dec[i] was successfully decrypted (equivalent
+   to fd_quic_crypto_decrypt returning FD_QUIC_SUCCESS).  dec[i].pt
+   contents are unspecified on failure.  dec[i].pt may alias dec[i].ct
+   but must not overlap any other packet's buffers. */
+
+ulong
+fd_quic_crypto_decrypt_batch( fd_quic_crypto_dec_t const * dec,
+                              ulong                        cnt );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_waltz_quic_crypto_fd_quic_crypto_batch_h */
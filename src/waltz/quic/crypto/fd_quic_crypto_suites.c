@@ -318,9 +318,7 @@ fd_quic_crypto_decrypt_hdr(
     return FD_QUIC_FAILED;
   }
 
-  uint          first      = buf[0]; /* first byte */
-  uint          long_hdr   = first & 0x80u;  /* long header? (this bit is not encrypted) */
-  ulong         sample_off = pkt_number_off + 4;
+  ulong sample_off = pkt_number_off + 4;
 
   if( FD_UNLIKELY( sample_off + FD_QUIC_HP_SAMPLE_SZ > buf_sz ) ) {
     FD_DEBUG( FD_LOG_WARNING(( "decrypt hdr: not enough bytes for a sample" )) );
@@ -336,7 +334,26 @@ fd_quic_crypto_decrypt_hdr(
   fd_aes_encrypt( sample, hp_cipher, ecb );
 
   /* hp_cipher is mask */
-  uchar const * mask = hp_cipher;
+  return fd_quic_crypto_hp_unmask( buf, buf_sz, pkt_number_off, hp_cipher );
+}
+
+int
+fd_quic_crypto_hp_unmask(
+    uchar *     buf,
+    ulong       buf_sz,
+    ulong       pkt_number_off,
+    uchar const mask[ 16 ] ) {
+
+  /* bounds checks */
+  if( FD_UNLIKELY( ( buf_sz < FD_QUIC_CRYPTO_TAG_SZ ) |
+                   ( pkt_number_off >= buf_sz       ) |
+                   ( pkt_number_off + 4 + FD_QUIC_HP_SAMPLE_SZ > buf_sz ) ) ) {
+    FD_DEBUG( FD_LOG_WARNING(( "hp unmask: bounds checks failed" )) );
+    return FD_QUIC_FAILED;
+  }
+
+  uint first    = buf[0]; /* first byte */
+  uint long_hdr = first & 0x80u;  /* long header? (this bit is not encrypted) */
 
   /* undo first byte mask */
   first  ^= (uint)mask[0] & ( long_hdr ? 0x0fu : 0x1fu );
@@ -235,6 +235,20 @@ fd_quic_crypto_decrypt_hdr(
     ulong                          pkt_number_off,
     fd_quic_crypto_keys_t const *  keys );
 
+/* fd_quic_crypto_hp_unmask removes header protection from the QUIC
+   packet in buf given the header protection mask computed from the
+   packet's sample (see fd_quic_crypto_hp_mask_batch).  Arguments,
+   bounds checks and return values are those of
+   fd_quic_crypto_decrypt_hdr, which is equivalent to computing the mask
+   and calling this. */
+
+int
+fd_quic_crypto_hp_unmask(
+    uchar *     buf,
+    ulong       buf_sz,
+    ulong       pkt_number_off,
+    uchar const mask[ 16 ] );
+
 /* nonce is quic-iv XORed with 62-bits of byte-order packet-number */
 static inline void
 fd_quic_get_nonce(
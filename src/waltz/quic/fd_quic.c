@@ -2112,10 +2112,14 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *      quic,
   pkt->enc_level = fd_quic_enc_level_appdata_id;
 
 # if !FD_QUIC_DISABLE_CRYPTO
-  if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt_hdr( cur_ptr, tot_sz,
-                                    pn_offset,
-                                    &conn->keys[3][0] ) != FD_QUIC_SUCCESS ) ) {
+  /* Packet protection may have been removed ahead of time by
+     fd_quic_rx_batch_prepare */
+  fd_quic_rx_pkt_t const * rx = fd_quic_rx_batch_query( state, conn, cur_ptr, tot_sz );
+
+  int hdr_rc;
+  if( rx ) hdr_rc = fd_quic_crypto_hp_unmask  ( cur_ptr, tot_sz, pn_offset, rx->hp_mask );
+  else     hdr_rc = fd_quic_crypto_decrypt_hdr( cur_ptr, tot_sz, pn_offset, &conn->keys[3][0] );
+  if( FD_UNLIKELY( hdr_rc != FD_QUIC_SUCCESS ) ) {
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt_hdr failed" )) );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]++;
     return FD_QUIC_PARSE_FAIL;
@@ -2140,12 +2144,21 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *      quic,
       instead.  Note that the key phase bit is untrusted at this point. */
   fd_quic_crypto_keys_t * keys = current_key_phase ? &conn->keys[3][0] : &conn->new_keys[0];
 
-  /* this decrypts the header and payload */
-  if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt( cur_ptr, tot_sz,
-                                pn_offset,
-                                pkt_number,
-                                keys ) != FD_QUIC_SUCCESS ) ) {
+  ulong hdr_sz = pn_offset + pkt_number_sz;
+  int   dec_rc;
+  if( rx && rx->dec_ok &&
+      rx->pkt_number==pkt_number && rx->hdr_sz==hdr_sz &&
+      fd_memeq( &rx->keys, keys,    sizeof(fd_quic_crypto_keys_t) ) &&
+      fd_memeq( rx->hdr,   cur_ptr, hdr_sz ) ) {
+    /* Decrypted with the same keys, nonce and AAD */
+    ulong idx = (ulong)( rx - state->rx_batch->pkt );
+    fd_memcpy( cur_ptr+hdr_sz, state->rx_batch->plaintext[ idx ], tot_sz-hdr_sz-FD_QUIC_CRYPTO_TAG_SZ );
+    dec_rc = FD_QUIC_SUCCESS;
+  } else {
+    /* this decrypts the header and payload */
+    dec_rc = fd_quic_crypto_decrypt( cur_ptr, tot_sz, pn_offset, pkt_number, keys );
+  }
+  if( FD_UNLIKELY( dec_rc != FD_QUIC_SUCCESS ) ) {
     /* remove connection from map, and insert into free list */
     FD_DTRACE_PROBE_3( quic_err_decrypt_1rtt_pkt, pkt->ip4, conn->our_conn_id, pkt->pkt_number );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]++;
@@ -2562,6 +2575,115 @@ fd_quic_process_packet( fd_quic_t  *  quic,
   fd_histf_sample( quic->metrics.receive_duration, (ulong)delta_ticks );
 }
 
+/* fd_quic_rx_batch_prepare removes packet protection ahead of time
+   from the 1-RTT packets among the batch_cnt (at most
+   FD_QUIC_CRYPTO_BATCH_MAX) packets in batch, so that the AES work of
+   the whole batch can be done at once with the batched crypto APIs.
+   The packets are left untouched: masks and plaintexts are kept in
+   state->rx_batch, to be used by fd_quic_handle_v1_one_rtt if still
+   valid when the packet is handled. */
+
+static void
+fd_quic_rx_batch_prepare( fd_quic_t *               quic,
+                          fd_aio_pkt_info_t const * batch,
+                          ulong                     batch_cnt ) {
+  fd_quic_state_t *    state = fd_quic_get_state( quic );
+  fd_quic_rx_batch_t * rx    = state->rx_batch;
+  ulong const          pn_offset = 1UL + FD_QUIC_CONN_ID_SZ;
+
+  fd_quic_crypto_keys_t const * hp_keys[ FD_QUIC_CRYPTO_BATCH_MAX ];
+  uchar const *                 sample [ FD_QUIC_CRYPTO_BATCH_MAX ];
+  ulong                         hp_idx [ FD_QUIC_CRYPTO_BATCH_MAX ];
+  ulong                         hp_cnt = 0UL;
+
+  for( ulong j=0UL; j<batch_cnt; j++ ) {
+    fd_quic_rx_pkt_t * p = rx->pkt + j;
+    p->data   = NULL;
+    p->dec_ok = 0;
+
+    /* Find the QUIC packet like fd_quic_process_packet_impl would.
+       Datagrams starting with a long header packet are left alone. */
+    uchar * cur_ptr = batch[ j ].buf;
+    ulong   cur_sz  = batch[ j ].buf_sz;
+    fd_ip4_hdr_t ip4[1];
+    fd_udp_hdr_t udp[1];
+    ulong ip4_sz = fd_quic_decode_ip4( ip4, cur_ptr, cur_sz );
+    if( FD_UNLIKELY( ip4_sz==FD_QUIC_PARSE_FAIL ) ) continue;
+    cur_ptr += ip4_sz;
+    cur_sz  -= ip4_sz;
+    ulong udp_sz = fd_quic_decode_udp( udp, cur_ptr, cur_sz );
+    if( FD_UNLIKELY( ( udp_sz==FD_QUIC_PARSE_FAIL ) |
+                     ( udp->net_len<sizeof(fd_udp_hdr_t) ) |
+                     ( udp->net_len>cur_sz ) ) ) continue;
+    cur_ptr += udp_sz;
+    cur_sz   = udp->net_len - udp_sz;
+    if( FD_UNLIKELY( ( cur_sz<pn_offset+4UL+FD_QUIC_HP_SAMPLE_SZ ) |
+                     ( cur_sz>FD_QUIC_MTU                        ) |
+                     ( fd_quic_h0_hdr_form( cur_ptr[0] )         ) ) ) continue;
+
+    fd_quic_conn_t * conn = fd_quic_conn_query( state->conn_map, fd_ulong_load_8( cur_ptr+1 ) );
+    if( FD_UNLIKELY( !conn || !fd_uint_extract_bit( conn->keys_avail, fd_quic_enc_level_appdata_id ) ) ) continue;
+
+    p->data = cur_ptr;
+    p->sz   = cur_sz;
+    p->conn = conn;
+    memcpy( p->hp_key, conn->keys[3][0].hp_key, FD_AES_128_KEY_SZ );
+    hp_keys[ hp_cnt ] = &conn->keys[3][0];
+    sample [ hp_cnt ] = cur_ptr + pn_offset + 4UL;
+    hp_idx [ hp_cnt ] = j;
+    hp_cnt++;
+  }
+
+  uchar hp_mask[ FD_QUIC_CRYPTO_BATCH_MAX ][ 16 ];
+  fd_quic_crypto_hp_mask_batch( hp_mask, hp_keys, sample, hp_cnt );
+
+  /* Guess the packet number and keys from the connection's current
+     state, as fd_quic_handle_v1_one_rtt will do */
+
+  fd_quic_crypto_dec_t dec    [ FD_QUIC_CRYPTO_BATCH_MAX ];
+  ulong                dec_idx[ FD_QUIC_CRYPTO_BATCH_MAX ];
+  ulong                dec_cnt = 0UL;
+  for( ulong h=0UL; h<hp_cnt; h++ ) {
+    ulong              j    = hp_idx[ h ];
+    fd_quic_rx_pkt_t * p    = rx->pkt + j;
+    fd_quic_conn_t *   conn = (fd_quic_conn_t *)p->conn;
+    memcpy( p->hp_mask, hp_mask[ h ], 16UL );
+
+    uint  first         = p->data[0] ^ ( hp_mask[ h ][0] & 0x1fu );
+    ulong pkt_number_sz = fd_quic_h0_pkt_num_len( first ) + 1u;
+    ulong hdr_sz        = pn_offset + pkt_number_sz;
+    if( FD_UNLIKELY( p->sz < hdr_sz+FD_QUIC_CRYPTO_TAG_SZ ) ) continue;
+
+    memcpy( p->hdr, p->data, hdr_sz );
+    p->hdr[0] = (uchar)first;
+    for( ulong k=0UL; k<pkt_number_sz; k++ ) p->hdr[ pn_offset+k ] ^= hp_mask[ h ][ 1UL+k ];
+
+    ulong pktnum_comp = fd_quic_pktnum_decode( p->hdr+pn_offset, pkt_number_sz );
+    p->pkt_number = fd_quic_reconstruct_pkt_num( pktnum_comp, pkt_number_sz, conn->exp_pkt_number[2] );
+    p->hdr_sz     = hdr_sz;
+    fd_quic_crypto_keys_t const * keys =
+        conn->key_phase==fd_quic_one_rtt_key_phase( first ) ? &conn->keys[3][0] : &conn->new_keys[0];
+    p->keys = *keys;
+
+    dec[ dec_cnt ] = (fd_quic_crypto_dec_t) {
+      .keys       = keys,
+      .pkt_number = p->pkt_number,
+      .hdr        = p->hdr,
+      .hdr_sz     = hdr_sz,
+      .ct         = p->data + hdr_sz,
+      .ct_sz      = p->sz - hdr_sz - FD_QUIC_CRYPTO_TAG_SZ,
+      .pt         = rx->plaintext[ j ]
+    };
+    dec_idx[ dec_cnt ] = j;
+    dec_cnt++;
+  }
+
+  ulong dec_ok = fd_quic_crypto_decrypt_batch( dec, dec_cnt );
+  for( ulong d=0UL; d<dec_cnt; d++ ) {
+    rx->pkt[ dec_idx[ d ] ].dec_ok = (int)( (dec_ok>>d) & 1UL );
+  }
+}
+
 /* main receive-side entry point */
 int
 fd_quic_aio_cb_receive( void *                    context,
@@ -2571,14 +2693,30 @@ fd_quic_aio_cb_receive( void *                    context,
                         int                       flush ) {
   (void)flush;
 
-  fd_quic_t * quic = context;
-  long now = fd_quic_get_state( quic )->now;
+  fd_quic_t *          quic = context;
+  long                 now  = fd_quic_get_state( quic )->now;
+  fd_quic_rx_batch_t * rx   = fd_quic_get_state( quic )->rx_batch;
 
   /* this aio interface is configured as one-packet per buffer
      so batch[0] refers to one buffer
      as such, we simply forward each individual packet to a handling function */
-  for( ulong j = 0; j < batch_cnt; ++j ) {
-    fd_quic_process_packet( quic, batch[ j ].buf, batch[ j ].buf_sz, now );
+  if( FD_LIKELY( !FD_QUIC_DISABLE_CRYPTO && !rx->pkt_cnt ) ) {
+    for( ulong j = 0; j < batch_cnt; j += FD_QUIC_CRYPTO_BATCH_MAX ) {
+      ulong cnt = fd_ulong_min( batch_cnt-j, FD_QUIC_CRYPTO_BATCH_MAX );
+      fd_quic_rx_batch_prepare( quic, batch+j, cnt );
+      rx->pkt_cnt = cnt;
+      for( ulong k = 0; k < cnt; ++k ) {
+        rx->pkt_idx = k;
+        fd_quic_process_packet( quic, batch[ j+k ].buf, batch[ j+k ].buf_sz, now );
+      }
+      rx->pkt_cnt = 0UL;
+    }
+  } else {
+    /* Called back from a packet handler (e.g. through a virtual pair),
+       leave the outer batch alone */
+    for( ulong j = 0; j < batch_cnt; ++j ) {
+      fd_quic_process_packet( quic, batch[ j ].buf, batch[ j ].buf_sz, now );
+    }
   }
 
   /* the assumption here at present is that any packet that could not be processed
@@ -11,6 +11,7 @@
 #include "fd_quic_stream_pool.h"
 #include "fd_quic_pretty_print.h"
 #include "fd_quic_svc_q.h"
+#include "crypto/fd_quic_crypto_batch.h"
 #include <math.h>
 
 #include "../../util/log/fd_dtrace.h"
@@ -47,6 +48,40 @@
 #define FD_QUIC_K_TIME_THRESHOLD 1.125f
 #define FD_QUIC_K_GRANULARITY_NS 1000000L
 
+/* fd_quic_rx_pkt_t holds the packet protection removal results that
+   fd_quic_rx_batch_prepare computed ahead of time for a 1-RTT packet
+   of an RX batch.  They are speculative: the connection's state may
+   change while earlier packets of the batch are handled, so
+   fd_quic_handle_v1_one_rtt only uses them after checking that the
+   keys, header and packet number they were computed with are still the
+   right ones. */
+
+struct fd_quic_rx_pkt {
+  uchar const *           data;        /* QUIC packet, NULL if no results */
+  ulong                   sz;
+  fd_quic_conn_t const *  conn;
+  uchar                   hp_key [ FD_AES_128_KEY_SZ ];
+  uchar                   hp_mask[ 16 ];
+
+  /* Valid if dec_ok */
+  int                     dec_ok;
+  fd_quic_crypto_keys_t   keys;        /* copy of packet protection keys */
+  ulong                   pkt_number;
+  ulong                   hdr_sz;
+  uchar                   hdr[ 1+FD_QUIC_CONN_ID_SZ+4 ]; /* unprotected header */
+};
+
+typedef struct fd_quic_rx_pkt fd_quic_rx_pkt_t;
+
+struct fd_quic_rx_batch {
+  ulong            pkt_cnt; /* 0 if no batch is in progress */
+  ulong            pkt_idx; /* index of the packet being handled */
+  fd_quic_rx_pkt_t pkt[ FD_QUIC_CRYPTO_BATCH_MAX ];
+  uchar            plaintext[ FD_QUIC_CRYPTO_BATCH_MAX ][ FD_QUIC_MTU ];
+};
+
+typedef struct fd_quic_rx_batch fd_quic_rx_batch_t;
+
 /* fd_quic_state_t is the internal state of an fd_quic_t.  Valid for
    lifetime of join. */
 
@@ -105,6 +140,10 @@ struct __attribute__((aligned(16UL))) fd_quic_state_private {
   /* Scratch space for packet protection */
   uchar                   crypt_scratch[FD_QUIC_MTU];
 
+  /* Packet protection removed ahead of time for the RX batch being
+     handled by fd_quic_aio_cb_receive */
+  fd_quic_rx_batch_t      rx_batch[1];
+
   /* the timer structs, large private fields / data follow */
   fd_quic_svc_timers_t  * svc_timers;
 };
@@ -155,6 +194,25 @@ fd_quic_get_state_const( fd_quic_t const * quic ) {
   return (fd_quic_state_t const *)( (ulong)quic + FD_QUIC_STATE_OFF );
 }
 
+/* fd_quic_rx_batch_query returns the results computed ahead of time by
+   fd_quic_rx_batch_prepare for the 1-RTT packet at data of sz bytes of
+   conn, or NULL if there are none (not received through
+   fd_quic_aio_cb_receive, or conn or its header protection key
+   changed since). */
+
+static inline fd_quic_rx_pkt_t const *
+fd_quic_rx_batch_query( fd_quic_state_t const * state,
+                        fd_quic_conn_t const *  conn,
+                        uchar const *           data,
+                        ulong                   sz ) {
+  fd_quic_rx_batch_t const * rx = state->rx_batch;
+  if( FD_LIKELY( rx->pkt_idx>=rx->pkt_cnt ) ) return NULL;
+  fd_quic_rx_pkt_t const * pkt = rx->pkt + rx->pkt_idx;
+  if( FD_UNLIKELY( ( pkt->data!=data ) | ( pkt->sz!=sz ) | ( pkt->conn!=conn ) ) ) return NULL;
+  if( FD_UNLIKELY( !fd_memeq( pkt->hp_key, conn->keys[3][0].hp_key, FD_AES_128_KEY_SZ ) ) ) return NULL;
+  return pkt;
+}
+
 /* fd_quic_conn_service is called periodically to perform pending
    operations and time based operations.
 
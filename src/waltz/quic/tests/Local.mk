@@ -41,6 +41,7 @@ $(call run-unit-test,test_quic_tls_hs)
 # fd_quic_crypto unit tests
 $(call make-unit-test,test_quic_crypto,test_quic_crypto,$(QUIC_TEST_LIBS))
 $(call run-unit-test,test_quic_crypto)
+$(call make-unit-test,bench_quic_rx,bench_quic_rx,$(QUIC_TEST_LIBS))
 
 # Manual test programs
 $(call make-unit-test,test_quic_client_flood,test_quic_client_flood,$(QUIC_TEST_LIBS))
@@ -0,0 +1,234 @@
+#include "fd_quic_sandbox.h"
+#include "../fd_quic_private.h"
+#include "../templ/fd_quic_parse_util.h"
+
+#include <stdlib.h>
+
+/* bench_quic_rx: measure how many small 1-RTT packets per second a
+   single core can push through the fd_quic receive path, one packet at
+   a time via fd_quic_process_packet and in batches via the aio receive
+   callback (which removes packet protection from a whole batch at once,
+   see fd_quic_rx_batch_prepare).  Each packet carries a PING frame
+   padded to --pkt-sz bytes (UDP payload).  Packets are spread round
+   robin over --conns established connections with distinct keys.
+   Packets are decrypted in place, so each pass starts by copying them
+   from a pristine buffer; the cost of that copy alone is reported
+   too, as is the cost of removing packet protection alone, one by one
+   and with the batched crypto APIs. */
+
+#define PKT_CNT (1024UL)
+
+static uchar pristine[ PKT_CNT ][ FD_QUIC_MTU ];
+static uchar work    [ PKT_CNT ][ FD_QUIC_MTU ];
+static ulong pkt_sz  [ PKT_CNT ];
+
+static void
+make_pkt( ulong            idx,
+          fd_quic_conn_t * conn,
+          ulong            pkt_number,
+          ulong            quic_sz ) {
+  uchar * buf = pristine[ idx ];
+
+  fd_ip4_hdr_t ip4 = {
+    .verihl       = FD_IP4_VERIHL(4,5),
+    .net_tot_len  = (ushort)( sizeof(fd_ip4_hdr_t)+sizeof(fd_udp_hdr_t)+quic_sz ),
+    .net_frag_off = 0x4000u, /* don't fragment */
+    .ttl          = 64,
+    .protocol     = FD_IP4_HDR_PROTOCOL_UDP,
+    .saddr        = FD_QUIC_SANDBOX_PEER_IP4,
+    .daddr        = FD_QUIC_SANDBOX_SELF_IP4,
+  };
+  fd_udp_hdr_t udp = {
+    .net_sport = FD_QUIC_SANDBOX_PEER_PORT,
+    .net_dport = FD_QUIC_SANDBOX_SELF_PORT,
+    .net_len   = (ushort)( sizeof(fd_udp_hdr_t)+quic_sz ),
+  };
+  fd_ip4_hdr_bswap( &ip4 );
+  fd_udp_hdr_bswap( &udp );
+  memcpy( buf,                      &ip4, sizeof(fd_ip4_hdr_t) );
+  memcpy( buf+sizeof(fd_ip4_hdr_t), &udp, sizeof(fd_udp_hdr_t) );
+  ulong off = sizeof(fd_ip4_hdr_t)+sizeof(fd_udp_hdr_t);
+
+  /* 1-RTT header with a 4 byte packet number, then a PING frame
+     followed by PADDING frames */
+  uchar hdr[ 13 ];
+  hdr[0] = fd_quic_one_rtt_h0( /* spin */ 0, /* key_phase */ !!conn->key_phase, /* pktnum_len-1 */ 3 );
+  memcpy( hdr+1, &conn->our_conn_id, FD_QUIC_CONN_ID_SZ );
+  FD_STORE( uint, hdr+9, fd_uint_bswap( (uint)pkt_number ) );
+
+  uchar frames[ FD_QUIC_MTU ] = {0};
+  frames[0] = 0x01; /* PING */
+  ulong frames_sz = quic_sz - sizeof(hdr) - FD_QUIC_CRYPTO_TAG_SZ;
+
+  fd_quic_crypto_keys_t * keys = &conn->keys[ fd_quic_enc_level_appdata_id ][0];
+  ulong out_sz = FD_QUIC_MTU-off;
+  FD_TEST( fd_quic_crypto_encrypt( buf+off, &out_sz, hdr, sizeof(hdr), frames, frames_sz, keys, keys, pkt_number )==FD_QUIC_SUCCESS );
+  FD_TEST( out_sz==quic_sz );
+  pkt_sz[ idx ] = off+out_sz;
+}
+
+/* crypto_pass removes packet protection from the packets in work,
+   one by one or batched.  Packet i is protected with keys[i%conn_cnt]
+   and has packet number i/conn_cnt. */
+
+#define UDP_OFF (sizeof(fd_ip4_hdr_t)+sizeof(fd_udp_hdr_t))
+#define PN_OFF  (1UL+FD_QUIC_CONN_ID_SZ)
+
+static void
+crypto_pass( fd_quic_crypto_keys_t const ** keys,
+             ulong                          conn_cnt,
+             int                            batched ) {
+  if( !batched ) {
+    for( ulong i=0UL; i<PKT_CNT; i++ ) {
+      fd_quic_crypto_keys_t const * k  = keys[ i%conn_cnt ];
+      uchar *                       q  = work[ i ] + UDP_OFF;
+      ulong                         sz = pkt_sz[ i ] - UDP_OFF;
+      FD_TEST( fd_quic_crypto_decrypt_hdr( q, sz, PN_OFF,               k )==FD_QUIC_SUCCESS );
+      FD_TEST( fd_quic_crypto_decrypt    ( q, sz, PN_OFF, i/conn_cnt, k )==FD_QUIC_SUCCESS );
+    }
+    return;
+  }
+
+  ulong const batch = FD_QUIC_CRYPTO_BATCH_MAX;
+  for( ulong i=0UL; i<PKT_CNT; i+=batch ) {
+    fd_quic_crypto_keys_t const * k     [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    uchar const *                 sample[ FD_QUIC_CRYPTO_BATCH_MAX ];
+    uchar                         mask  [ FD_QUIC_CRYPTO_BATCH_MAX ][ 16 ];
+    fd_quic_crypto_dec_t          dec   [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    for( ulong j=0UL; j<batch; j++ ) {
+      k     [ j ] = keys[ (i+j)%conn_cnt ];
+      sample[ j ] = work[ i+j ] + UDP_OFF + PN_OFF + 4UL;
+    }
+    fd_quic_crypto_hp_mask_batch( mask, k, sample, batch );
+    for( ulong j=0UL; j<batch; j++ ) {
+      uchar * q      = work[ i+j ] + UDP_OFF;
+      ulong   sz     = pkt_sz[ i+j ] - UDP_OFF;
+      ulong   hdr_sz = PN_OFF + 4UL;
+      FD_TEST( fd_quic_crypto_hp_unmask( q, sz, PN_OFF, mask[ j ] )==FD_QUIC_SUCCESS );
+      dec[ j ] = (fd_quic_crypto_dec_t) {
+        .keys       = k[ j ],
+        .pkt_number = (i+j)/conn_cnt,
+        .hdr        = q,
+        .hdr_sz     = hdr_sz,
+        .ct         = q + hdr_sz,
+        .ct_sz      = sz - hdr_sz - FD_QUIC_CRYPTO_TAG_SZ,
+        .pt         = q + hdr_sz
+      };
+    }
+    FD_TEST( fd_quic_crypto_decrypt_batch( dec, batch )==fd_ulong_mask_lsb( (int)batch ) );
+  }
+}
+
+static long
+bench_pass( fd_quic_t * quic,
+            ulong       mode,     /* 0: copy only, 1: one by one, 2: aio batches */
+            ulong       batch,
+            ulong       pass_cnt ) {
+  fd_aio_t const *  aio_rx = fd_quic_get_aio_net_rx( quic );
+  fd_aio_pkt_info_t info[ PKT_CNT ];
+  for( ulong i=0UL; i<PKT_CNT; i++ ) info[ i ] = (fd_aio_pkt_info_t){ .buf = work[ i ], .buf_sz = (ushort)pkt_sz[ i ] };
+
+  long now = fd_quic_get_state( quic )->now;
+  long dt  = -fd_log_wallclock();
+  for( ulong pass=0UL; pass<pass_cnt; pass++ ) {
+    for( ulong i=0UL; i<PKT_CNT; i+=batch ) {
+      ulong cnt = fd_ulong_min( batch, PKT_CNT-i );
+      for( ulong j=i; j<i+cnt; j++ ) fd_memcpy( work[ j ], pristine[ j ], pkt_sz[ j ] );
+      if( mode==1UL ) {
+        for( ulong j=i; j<i+cnt; j++ ) fd_quic_process_packet( quic, work[ j ], pkt_sz[ j ], now );
+      } else if( mode==2UL ) {
+        fd_aio_send( aio_rx, info+i, cnt, NULL, 1 );
+      }
+    }
+  }
+  dt += fd_log_wallclock();
+  return dt;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong conn_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--conns",  NULL,   4UL );
+  ulong quic_sz  = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-sz", NULL, 200UL );
+  ulong batch    = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch",  NULL,  64UL );
+  ulong pass_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--passes", NULL, 256UL );
+
+  FD_TEST( conn_cnt>=1UL && conn_cnt<=PKT_CNT );
+  FD_TEST( quic_sz>=64UL && quic_sz<=1472UL );
+  FD_TEST( batch>=1UL && batch<=PKT_CNT );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_quic_limits_t quic_limits = {
+    .conn_cnt           = conn_cnt,
+    .handshake_cnt      = 1UL,
+    .conn_id_cnt        = 4UL,
+    .stream_id_cnt      = 8UL,
+    .inflight_frame_cnt = 8UL * conn_cnt,
+    .tx_buf_sz          = 512UL,
+    .stream_pool_cnt    = 8UL,
+  };
+  ulong sandbox_sz  = fd_quic_sandbox_footprint( &quic_limits, 128UL, 1500UL );
+  FD_TEST( sandbox_sz );
+  void * sandbox_mem = aligned_alloc( fd_quic_sandbox_align(), fd_ulong_align_up( sandbox_sz, fd_quic_sandbox_align() ) );
+  FD_TEST( sandbox_mem );
+  fd_quic_sandbox_t * sandbox = fd_quic_sandbox_new( sandbox_mem, &quic_limits, 128UL, 1500UL );
+  FD_TEST( sandbox );
+  FD_TEST( fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER ) );
+  fd_quic_t * quic = sandbox->quic;
+
+  /* Connections with random keys */
+
+  fd_quic_conn_t * conn[ PKT_CNT ];
+  for( ulong c=0UL; c<conn_cnt; c++ ) {
+    conn[ c ] = fd_quic_sandbox_new_conn_established( sandbox, rng );
+    FD_TEST( conn[ c ] );
+    fd_quic_crypto_keys_t * keys = &conn[ c ]->keys[ fd_quic_enc_level_appdata_id ][0];
+    for( ulong b=0UL; b<sizeof(fd_quic_crypto_keys_t); b++ ) ((uchar *)keys)[ b ] = fd_rng_uchar( rng );
+  }
+  for( ulong i=0UL; i<PKT_CNT; i++ ) make_pkt( i, conn[ i%conn_cnt ], i/conn_cnt, quic_sz );
+
+  FD_LOG_NOTICE(( "quic rx bench (conns=%lu pkt_sz=%lu batch=%lu pkts=%lu)", conn_cnt, quic_sz, batch, PKT_CNT*pass_cnt ));
+
+  /* Warm up, and check that every packet gets through */
+
+  bench_pass( quic, 1UL, batch, 1UL );
+  bench_pass( quic, 2UL, batch, 1UL );
+  FD_TEST( quic->metrics.net_rx_pkt_cnt==2UL*PKT_CNT );
+  FD_TEST( quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]==0UL );
+  FD_TEST( quic->metrics.frame_rx_err_cnt==0UL );
+
+  double pkt_cnt = (double)( PKT_CNT*pass_cnt );
+  long   dt_copy = bench_pass( quic, 0UL, batch, pass_cnt );
+  long   dt_one  = bench_pass( quic, 1UL, batch, pass_cnt );
+  long   dt_aio  = bench_pass( quic, 2UL, batch, pass_cnt );
+  FD_TEST( quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]==0UL );
+
+  fd_quic_crypto_keys_t const * keys[ PKT_CNT ];
+  for( ulong c=0UL; c<conn_cnt; c++ ) keys[ c ] = &conn[ c ]->keys[ fd_quic_enc_level_appdata_id ][0];
+  long dt_crypto[2];
+  for( int batched=0; batched<2; batched++ ) {
+    dt_crypto[ batched ] = -fd_log_wallclock();
+    for( ulong pass=0UL; pass<pass_cnt; pass++ ) {
+      for( ulong i=0UL; i<PKT_CNT; i++ ) fd_memcpy( work[ i ], pristine[ i ], pkt_sz[ i ] );
+      crypto_pass( keys, conn_cnt, batched );
+    }
+    dt_crypto[ batched ] += fd_log_wallclock();
+  }
+
+  FD_LOG_NOTICE(( "packet copy only:       %.3f Mpkt/s/core, %.1f ns each", pkt_cnt/(double)dt_copy*1e3, (double)dt_copy/pkt_cnt ));
+  FD_LOG_NOTICE(( "fd_quic_process_packet: %.3f Mpkt/s/core, %.1f ns each", pkt_cnt/(double)dt_one *1e3, (double)dt_one /pkt_cnt ));
+  FD_LOG_NOTICE(( "aio rx batches:         %.3f Mpkt/s/core, %.1f ns each", pkt_cnt/(double)dt_aio *1e3, (double)dt_aio /pkt_cnt ));
+  FD_LOG_NOTICE(( "crypto one by one:      %.3f Mpkt/s/core, %.1f ns each", pkt_cnt/(double)dt_crypto[0]*1e3, (double)dt_crypto[0]/pkt_cnt ));
+  FD_LOG_NOTICE(( "crypto batched:         %.3f Mpkt/s/core, %.1f ns each", pkt_cnt/(double)dt_crypto[1]*1e3, (double)dt_crypto[1]/pkt_cnt ));
+
+  fd_quic_sandbox_delete( sandbox );
+  free( sandbox_mem );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "../crypto/fd_quic_crypto_suites.h"
+#include "../crypto/fd_quic_crypto_batch.h"
 
 FD_IMPORT_BINARY( test_client_initial,   "src/waltz/quic/fixtures/rfc9001-client-initial-payload.bin"   );
 FD_IMPORT_BINARY( test_client_encrypted, "src/waltz/quic/fixtures/rfc9001-client-initial-encrypted.bin" );
@@ -140,6 +141,80 @@ test_quic_nonce( void ) {
   FD_TEST( 0==memcmp( nonce, expected_nonce, sizeof( expected_nonce ) ) );
 }
 
+/* tests that the batched APIs match the one packet at a time ones */
+static void
+test_quic_crypto_batch( fd_rng_t * rng ) {
+  fd_quic_crypto_keys_t keys[3];
+  for( ulong k=0UL; k<3UL; k++ ) {
+    for( ulong b=0UL; b<sizeof(fd_quic_crypto_keys_t); b++ ) ((uchar *)&keys[k])[b] = fd_rng_uchar( rng );
+  }
+
+  static uchar pkt   [ FD_QUIC_CRYPTO_BATCH_MAX ][ 1200 ]; /* protected */
+  static uchar expect[ FD_QUIC_CRYPTO_BATCH_MAX ][ 1200 ]; /* via fd_quic_crypto_decrypt{_hdr} */
+  static uchar actual[ FD_QUIC_CRYPTO_BATCH_MAX ][ 1200 ]; /* via batch APIs */
+
+  for( ulong iter=0UL; iter<256UL; iter++ ) {
+    ulong cnt = fd_rng_ulong_roll( rng, FD_QUIC_CRYPTO_BATCH_MAX+1UL );
+
+    fd_quic_crypto_keys_t const * pkt_keys[ FD_QUIC_CRYPTO_BATCH_MAX ];
+    uchar const *                 sample  [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    ulong                         pkt_sz  [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    ulong                         pkt_num [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    ulong                         hdr_sz  [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    int                           corrupt [ FD_QUIC_CRYPTO_BATCH_MAX ];
+    ulong const                   pn_off = 9UL;
+
+    for( ulong i=0UL; i<cnt; i++ ) {
+      uint  pn_sz = 1U + fd_rng_uint_roll( rng, 4U );
+      uchar hdr[ 13 ];
+      hdr[0] = (uchar)( 0x40 | fd_rng_uint_roll( rng, 2U )<<2 | (pn_sz-1U) ); /* 1-RTT, random key phase */
+      for( ulong b=1UL; b<13UL; b++ ) hdr[b] = fd_rng_uchar( rng );
+      uchar payload[ 1200 ];
+      ulong payload_sz = 4UL + fd_rng_ulong_roll( rng, 1200UL-13UL-FD_QUIC_CRYPTO_TAG_SZ-4UL );
+      for( ulong b=0UL; b<payload_sz; b++ ) payload[b] = fd_rng_uchar( rng );
+
+      pkt_keys[i] = &keys[ fd_rng_ulong_roll( rng, 3UL ) ];
+      pkt_num [i] = fd_rng_ulong( rng ) & 0x3fffffffffffffffUL;
+      hdr_sz  [i] = pn_off + pn_sz;
+      pkt_sz  [i] = 1200UL;
+      FD_TEST( fd_quic_crypto_encrypt( pkt[i], &pkt_sz[i], hdr, hdr_sz[i], payload, payload_sz, pkt_keys[i], pkt_keys[i], pkt_num[i] )==FD_QUIC_SUCCESS );
+      sample  [i] = pkt[i] + pn_off + 4UL;
+      corrupt [i] = fd_rng_uint_roll( rng, 4U )==0U;
+      if( corrupt[i] ) pkt[i][ hdr_sz[i]+fd_rng_ulong_roll( rng, pkt_sz[i]-hdr_sz[i] ) ]++;
+    }
+
+    uchar mask[ FD_QUIC_CRYPTO_BATCH_MAX ][ 16 ];
+    fd_quic_crypto_hp_mask_batch( mask, pkt_keys, sample, cnt );
+
+    fd_quic_crypto_dec_t dec[ FD_QUIC_CRYPTO_BATCH_MAX ];
+    for( ulong i=0UL; i<cnt; i++ ) {
+      fd_memcpy( expect[i], pkt[i], pkt_sz[i] );
+      fd_memcpy( actual[i], pkt[i], pkt_sz[i] );
+      FD_TEST( fd_quic_crypto_decrypt_hdr( expect[i], pkt_sz[i], pn_off, pkt_keys[i] )==FD_QUIC_SUCCESS );
+      FD_TEST( fd_quic_crypto_hp_unmask  ( actual[i], pkt_sz[i], pn_off, mask[i]     )==FD_QUIC_SUCCESS );
+      FD_TEST( fd_memeq( expect[i], actual[i], pkt_sz[i] ) );
+      int ok = fd_quic_crypto_decrypt( expect[i], pkt_sz[i], pn_off, pkt_num[i], pkt_keys[i] )==FD_QUIC_SUCCESS;
+      FD_TEST( ok==!corrupt[i] );
+      dec[i] = (fd_quic_crypto_dec_t) {
+        .keys       = pkt_keys[i],
+        .pkt_number = pkt_num[i],
+        .hdr        = actual[i],
+        .hdr_sz     = hdr_sz[i],
+        .ct         = actual[i] + hdr_sz[i],
+        .ct_sz      = pkt_sz[i] - hdr_sz[i] - FD_QUIC_CRYPTO_TAG_SZ,
+        .pt         = actual[i] + hdr_sz[i]
+      };
+    }
+
+    ulong ok = fd_quic_crypto_decrypt_batch( dec, cnt );
+    for( ulong i=0UL; i<cnt; i++ ) {
+      FD_TEST( fd_ulong_extract_bit( ok, (int)i )==!corrupt[i] );
+      if( !corrupt[i] ) FD_TEST( fd_memeq( expect[i], actual[i], pkt_sz[i] ) );
+    }
+    FD_TEST( !( ok>>cnt ) );
+  }
+}
+
 #if FD_HAS_AESNI || FD_HAS_GFNI
 #define BENCH_ITER 1000000UL
 #else
@@ -395,6 +470,7 @@ main( int     argc,
 
   test_quic_short_pn();
   test_quic_nonce();
+  test_quic_crypto_batch( rng );
   fd_rng_delete( fd_rng_leave( rng ) );
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();